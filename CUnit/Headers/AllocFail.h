@@ -0,0 +1,154 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for allocation failure sweeps.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Allocation failure sweeps.
+ *  A test selected with CU_set_alloc_failure_sweep() is run repeatedly
+ *  with one allocation made to fail: first the 1st allocation of the
+ *  test function, then the 2nd, and so on until a run makes fewer
+ *  allocations than the failure point, i.e. completes as a clean run.
+ *  Each run takes place in a child process forked after the suite
+ *  setup function, so every failure point starts from the same fixture
+ *  for the cost of one fork().
+ *  <br /><br />
+ *
+ *  A failure record is added to the test for each failure point at
+ *  which the test function crashed, hung, exited, or left more
+ *  allocations outstanding than in the clean run.  The record names
+ *  the call site of the allocation that was made to fail.  Assertion
+ *  failures inside the children are expected (the code under test sees
+ *  allocation errors) and are not reported.  After the sweep the test
+ *  function runs once more as usual in the test program itself.
+ *  <br /><br />
+ *
+ *  Allocations are intercepted by the libcunitwrap wrapper (see
+ *  AllocTrack.h), so the test program must be linked with it.  Sweeps
+ *  need fork() and are not available on Windows.  They do not apply to
+ *  load tests or soak tests.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_ALLOCFAIL_H_SEEN
+#define CUNIT_ALLOCFAIL_H_SEEN
+
+#include "CUnit.h"
+#include "TestDB.h"
+#include "AllocTrack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_ALLOC_FAIL_MAX_POINTS 100000UL
+/**< Largest number of failure points swept for one test. */
+
+#define CU_ALLOC_FAIL_TIMEOUT 10
+/**< Seconds a run may take before it is reported as hung. */
+
+#define CU_ALLOC_FAIL_MAX_REPORTS 16
+/**< Maximum number of problem failure points recorded per sweep. */
+
+/** Outcomes of a run with a failed allocation. */
+typedef enum CU_AllocFailOutcome
+{
+  CU_ALLOC_FAIL_OK = 0,   /**< Completed without problems. */
+  CU_ALLOC_FAIL_CRASH,    /**< Ended by a signal. */
+  CU_ALLOC_FAIL_HANG,     /**< Did not complete within CU_ALLOC_FAIL_TIMEOUT. */
+  CU_ALLOC_FAIL_EXIT,     /**< Called exit() from the test function. */
+  CU_ALLOC_FAIL_LEAK      /**< Left more allocations outstanding than the clean run. */
+} CU_AllocFailOutcome;
+
+/** A failure point at which the test function misbehaved. */
+typedef struct CU_AllocFailPoint
+{
+  unsigned long       ulPoint;        /**< Ordinal of the failed allocation (1-based; 0 for the clean run). */
+  CU_AllocFailOutcome outcome;        /**< What happened. */
+  int                 iStatus;        /**< Signal (CU_ALLOC_FAIL_CRASH) or exit status (CU_ALLOC_FAIL_EXIT). */
+  unsigned long       ulLeaked;       /**< Allocations outstanding beyond the clean run (CU_ALLOC_FAIL_LEAK). */
+  size_t              szLeakedBytes;  /**< Bytes outstanding beyond the clean run (CU_ALLOC_FAIL_LEAK). */
+  CU_AllocSite        site;           /**< Call site of the failed allocation. */
+} CU_AllocFailPoint;
+
+/** Results of an allocation failure sweep. */
+typedef struct CU_AllocFailResult
+{
+  unsigned long     ulPoints;         /**< Allocations made by the clean run (points swept). */
+  CU_BOOL           bTruncated;       /**< CU_TRUE if CU_ALLOC_FAIL_MAX_POINTS was reached. */
+  unsigned long     ulCrashes;        /**< Failure points with outcome CU_ALLOC_FAIL_CRASH. */
+  unsigned long     ulHangs;          /**< Failure points with outcome CU_ALLOC_FAIL_HANG. */
+  unsigned long     ulExits;          /**< Failure points with outcome CU_ALLOC_FAIL_EXIT. */
+  unsigned long     ulLeaks;          /**< Failure points with outcome CU_ALLOC_FAIL_LEAK. */
+  unsigned int      uiReports;        /**< Number of entries in aReports. */
+  CU_AllocFailPoint aReports[CU_ALLOC_FAIL_MAX_REPORTS]; /**< First problem failure points. */
+} CU_AllocFailResult;
+
+/** Allocation failure sweep parameters attached to a CU_Test. */
+typedef struct CU_AllocFailSweep
+{
+  CU_AllocFailResult result;          /**< Results of the last sweep. */
+} CU_AllocFailSweep;
+
+CU_EXPORT CU_ErrorCode CU_set_alloc_failure_sweep(CU_pTest pTest, CU_BOOL bSweep);
+/**<
+ *  Selects a registered test for allocation failure sweeps, or turns
+ *  them off again.
+ *
+ *  @param pTest  The test to select (non-NULL).
+ *  @param bSweep CU_TRUE to sweep the test when it runs.
+ *  @return CUE_NOTEST if pTest is NULL, CUE_ALLOC_FAIL_UNAVAILABLE if
+ *          sweeps are not supported on this platform, CUE_NOMEMORY on
+ *          allocation failure, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_BOOL CU_is_alloc_failure_sweep(CU_pTest pTest);
+/**< Checks whether pTest has been selected with CU_set_alloc_failure_sweep(). */
+
+CU_EXPORT const CU_AllocFailResult* CU_get_alloc_failure_result(CU_pTest pTest);
+/**<
+ *  Retrieves the results of the last sweep of a test.
+ *  @return The results, or NULL if pTest is not selected for sweeps.
+ */
+
+CU_EXPORT CU_ErrorCode CU_run_alloc_failure_sweep(CU_pTest pTest);
+/**<
+ *  Runs the sweep of a test (internal).
+ *  Called by the test run functions after the suite setup function.
+ *  Results are stored in the test; the caller records failures for the
+ *  entries of CU_AllocFailResult.aReports.
+ *  @return CUE_ALLOC_FAIL_UNAVAILABLE if the wrapper is not linked or
+ *          fork() is not available or failed, CUE_SUCCESS otherwise.
+ */
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_AllocFail(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_ALLOCFAIL_H_SEEN  */
+/** @} */
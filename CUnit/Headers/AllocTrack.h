@@ -0,0 +1,239 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for per-test heap allocation accounting.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *
+ *  18-Oct-2026   Added allocation failure injection hooks. (AGT)
+ */
+
+/** @file
+ *  Per-test heap allocation accounting.
+ *  When a test program is linked with the libcunitwrap library and the
+ *  GNU linker options
+ *  <pre>
+ *    -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free -lcunitwrap -lcunit
+ *  </pre>
+ *  calls to malloc(), calloc(), realloc() and free() made from the
+ *  linked objects are reported to CUnit, which attributes them to the
+ *  test currently running (CU_get_current_test()).  For each test the
+ *  number of calls, the bytes requested, the peak of live bytes and the
+ *  allocations still outstanding are counted, and allocations are
+ *  grouped by call site (the innermost CU_ALLOC_SITE_DEPTH stack frames,
+ *  where backtrace() is available).
+ *  <br /><br />
+ *
+ *  Only the test function is accounted - not the suite setup and
+ *  teardown functions, and not CUnit's own allocations (e.g. failure
+ *  records).  Allocations made inside the C library itself (strdup(),
+ *  fopen(), ...) do not pass through the wrapped symbols and are not
+ *  seen.
+ *  <br /><br />
+ *
+ *  The --wrap options only redirect calls in the objects and static
+ *  archives of the link that uses them.  Calls made from a shared
+ *  library are bound to the C library by the dynamic linker instead,
+ *  so code under test built as a shared library is not accounted;
+ *  link it from objects or a static archive.  The same holds for
+ *  libcunit: when a program uses the shared libcunit, CUnit's own
+ *  calls bypass the wrapper, which leaves the accounting unchanged
+ *  since they are not counted anyway.
+ *  <br /><br />
+ *
+ *  The assertions CU_ASSERT_MAX_ALLOCATIONS(), CU_ASSERT_NO_LEAKS() etc.
+ *  check the counts of the running test so far.  They fail if the
+ *  program was not linked with the wrapper.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_ALLOCTRACK_H_SEEN
+#define CUNIT_ALLOCTRACK_H_SEEN
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "CUnit.h"
+#include "TestDB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_ALLOC_SITE_DEPTH 4
+/**< Number of stack frames identifying an allocation call site. */
+
+#define CU_ALLOC_MAX_SITES 32
+/**< Maximum number of distinct call sites recorded per test. */
+
+/** Allocation functions reported by the wrapper library. */
+typedef enum CU_AllocCall
+{
+  CU_ALLOC_MALLOC = 0,  /**< malloc() */
+  CU_ALLOC_CALLOC,      /**< calloc() */
+  CU_ALLOC_REALLOC      /**< realloc() */
+} CU_AllocCall;
+
+/** An allocation call site and its totals. */
+typedef struct CU_AllocSite
+{
+  void*         apFrames[CU_ALLOC_SITE_DEPTH];  /**< Return addresses, innermost first. */
+  unsigned int  uiFrames;                       /**< Number of valid entries in apFrames. */
+  unsigned long ulCalls;                        /**< Allocations made from this site. */
+  size_t        szBytes;                        /**< Bytes requested from this site. */
+} CU_AllocSite;
+
+/** Allocation statistics of a test. */
+typedef struct CU_AllocStats
+{
+  unsigned long ulMallocs;        /**< Calls of malloc(). */
+  unsigned long ulCallocs;        /**< Calls of calloc(). */
+  unsigned long ulReallocs;       /**< Calls of realloc(). */
+  unsigned long ulFrees;          /**< Calls of free() with a non-NULL pointer. */
+  unsigned long ulAllocations;    /**< Calls that allocated memory (malloc, calloc, realloc). */
+  size_t        szBytes;          /**< Total bytes requested. */
+  size_t        szLiveBytes;      /**< Bytes allocated by the test and not yet freed. */
+  size_t        szPeakLiveBytes;  /**< Maximum of szLiveBytes. */
+  unsigned long ulOutstanding;    /**< Allocations by the test not yet freed. */
+  unsigned int  uiSites;          /**< Number of entries in aSites. */
+  unsigned long ulOtherSites;     /**< Allocations from sites beyond CU_ALLOC_MAX_SITES. */
+  CU_AllocSite  aSites[CU_ALLOC_MAX_SITES]; /**< Call sites in order of first use. */
+} CU_AllocStats;
+typedef CU_AllocStats* CU_pAllocStats;  /**< Pointer to allocation statistics. */
+
+CU_EXPORT CU_BOOL CU_is_alloc_tracking_available(void);
+/**<
+ *  Checks whether allocation calls are being reported, i.e. whether
+ *  the program was linked with libcunitwrap and the --wrap options.
+ */
+
+CU_EXPORT void CU_set_alloc_backtraces(CU_BOOL bBacktraces);
+/**<
+ *  Turns recording of call site backtraces on (default) or off.
+ *  Without backtraces all allocations are counted in one site; turning
+ *  them off makes accounting considerably cheaper.
+ */
+
+CU_EXPORT const CU_AllocStats* CU_get_current_alloc_stats(void);
+/**<
+ *  Retrieves the allocation statistics of the running test so far.
+ *  During the teardown function these are the final statistics of the
+ *  test.  @return The statistics, or NULL if no test has run yet.
+ */
+
+CU_EXPORT const CU_AllocStats* CU_get_alloc_stats(CU_pTest pTest);
+/**<
+ *  Retrieves the allocation statistics of the last run of a test.
+ *  @return The statistics, or NULL if pTest has not run with
+ *          allocation tracking available.
+ */
+
+CU_EXPORT void CU_print_alloc_sites(const CU_AllocStats* pStats, unsigned int uiMax, FILE* pFile);
+/**<
+ *  Prints the call sites with the most allocations, most first.
+ *  Frames are symbolized with backtrace_symbols() where available.
+ *  @param pStats Statistics to report (NULL prints nothing).
+ *  @param uiMax  Maximum number of sites to print.
+ *  @param pFile  Stream to print to (non-NULL).
+ */
+
+/** Called when an allocation is made to fail (see CU_alloc_set_fail_point()). */
+typedef void (*CU_AllocFailHandler)(const CU_AllocSite* pSite);
+
+CU_EXPORT void CU_format_alloc_site(const CU_AllocSite* pSite, char* szBuffer, size_t szLength);
+/**<
+ *  Describes the innermost frame of a call site in szBuffer (symbolized
+ *  with backtrace_symbols() where available), e.g. for failure messages.
+ *  The description is truncated to szLength - 1 characters.
+ */
+
+/*  Hooks called by the wrapper library (internal). */
+CU_EXPORT CU_BOOL CU_alloc_should_fail(size_t szBytes);
+/**<
+ *  Called before each allocation; CU_TRUE makes the wrapper fail it
+ *  (internal).  Counts the allocations of the running test and fails
+ *  the one selected with CU_alloc_set_fail_point().
+ */
+CU_EXPORT void CU_alloc_note_alloc(void* pMem, size_t szBytes, CU_AllocCall call);
+/**< Reports a successful allocation of szBytes at pMem (internal). */
+CU_EXPORT void CU_alloc_note_realloc(void* pOld, void* pNew, size_t szBytes);
+/**< Reports a successful realloc() of pOld to pNew (internal). */
+CU_EXPORT void CU_alloc_note_free(void* pMem);
+/**< Reports free(pMem); called before the memory is released (internal). */
+
+/*  Hooks called by the test run functions (internal). */
+CU_EXPORT void CU_alloc_set_fail_point(unsigned long ulPoint, CU_AllocFailHandler pHandler);
+/**<
+ *  Makes the ulPoint-th allocation (1-based) of the running test fail,
+ *  counting from this call (internal).  pHandler, if non-NULL, is called
+ *  with the call site when it does.  A ulPoint of 0 turns injection off.
+ */
+CU_EXPORT void CU_alloc_begin_test(void);
+/**< Starts accounting for a test function (internal). */
+CU_EXPORT void CU_alloc_end_test(CU_pTest pTest);
+/**< Stops accounting and stores the statistics in pTest (internal). */
+CU_EXPORT int  CU_alloc_set_suspended(int iDepth);
+/**<
+ *  Sets the suspension depth of the calling thread and returns the
+ *  previous one (internal).  Allocations are not accounted while the
+ *  depth is above 0; CUnit uses this to exclude its own allocations.
+ */
+
+/** Asserts that the running test has made at most n allocations so far.
+ *  Reports failure with no other action.
+ */
+#define CU_ASSERT_MAX_ALLOCATIONS(n) \
+  { CU_assertImplementation(((CU_FALSE != CU_is_alloc_tracking_available()) && (NULL != CU_get_current_alloc_stats()) && (CU_get_current_alloc_stats()->ulAllocations <= (unsigned long)(n))), __LINE__, ("CU_ASSERT_MAX_ALLOCATIONS(" #n ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the running test has made no allocations so far.
+ *  Reports failure with no other action.
+ */
+#define CU_ASSERT_NO_ALLOCATIONS() \
+  { CU_assertImplementation(((CU_FALSE != CU_is_alloc_tracking_available()) && (NULL != CU_get_current_alloc_stats()) && (0 == CU_get_current_alloc_stats()->ulAllocations)), __LINE__, ("CU_ASSERT_NO_ALLOCATIONS()"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the running test has requested at most n bytes so far.
+ *  Reports failure with no other action.
+ */
+#define CU_ASSERT_MAX_ALLOCATED_BYTES(n) \
+  { CU_assertImplementation(((CU_FALSE != CU_is_alloc_tracking_available()) && (NULL != CU_get_current_alloc_stats()) && (CU_get_current_alloc_stats()->szBytes <= (size_t)(n))), __LINE__, ("CU_ASSERT_MAX_ALLOCATED_BYTES(" #n ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the peak of live bytes allocated by the running test is
+ *  at most n.  Reports failure with no other action.
+ */
+#define CU_ASSERT_MAX_PEAK_BYTES(n) \
+  { CU_assertImplementation(((CU_FALSE != CU_is_alloc_tracking_available()) && (NULL != CU_get_current_alloc_stats()) && (CU_get_current_alloc_stats()->szPeakLiveBytes <= (size_t)(n))), __LINE__, ("CU_ASSERT_MAX_PEAK_BYTES(" #n ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that everything the running test has allocated so far has
+ *  been freed.  Reports failure with no other action.
+ */
+#define CU_ASSERT_NO_LEAKS() \
+  { CU_assertImplementation(((CU_FALSE != CU_is_alloc_tracking_available()) && (NULL != CU_get_current_alloc_stats()) && (0 == CU_get_current_alloc_stats()->ulOutstanding)), __LINE__, ("CU_ASSERT_NO_LEAKS()"), __FILE__, "", CU_FALSE); }
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_AllocTrack(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_ALLOCTRACK_H_SEEN  */
+/** @} */
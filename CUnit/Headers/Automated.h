@@ -29,6 +29,10 @@
  *  20-Jul-2004   New interface, doxygen comments. (JDS)
  *
  *  24-Jan-2019   Added common interface for different reports formats.  (PMi)
+ *
+ *  18-Oct-2026   Buffered report files, added pAbortReport.  (AGT)
+ *
+ *  18-Oct-2026   Several report formats per run.  (AGT)
  */
 
 /** @file
@@ -48,6 +52,16 @@
 extern "C" {
 #endif
 
+#define CU_AUTOMATED_BUFFER_SIZE 65536
+/**<
+ *  Size of the stdio buffer of the xml report files.  Reports are
+ *  flushed at the end of each suite; if the test program crashes or
+ *  exits during a run the report is completed by pAbortReport.
+ */
+
+#define CU_AUTOMATED_MAX_FORMATS 4
+/**< Maximum number of report formats attached with CU_automated_add_report_format(). */
+
 typedef void (*CU_report_set_output_filename_T)(const char*);
 typedef CU_ErrorCode (*CU_report_open_report_T)(void);
 typedef CU_ErrorCode(*CU_report_close_report_T)(void);
@@ -58,6 +72,7 @@ typedef void (*CU_report_suite_init_failure_msg_handler_T)(const CU_pSuite);
 typedef void (*CU_report_suite_cleanup_failure_msg_handler_T)(const CU_pSuite);
 typedef void (*CU_report_suite_complete_msg_handler_T)(const CU_pSuite, const CU_pFailureRecord);
 typedef CU_ErrorCode (*CU_report_list_all_tests_T)(CU_pTestRegistry);
+typedef void (*CU_report_abort_report_T)(void);
 /**<
  *  Types for each interface functions of report.
  */
@@ -74,39 +89,56 @@ typedef struct CU_reportFormat_Tag
   CU_report_suite_cleanup_failure_msg_handler_T pSuiteCleanupFailureMsgHandler;
   CU_report_suite_complete_msg_handler_T pSuiteCompleteMsgHandler;
   CU_report_list_all_tests_T pListAllTests;
+  CU_report_abort_report_T pAbortReport;
 } CU_reportFormat_T;
 typedef CU_reportFormat_T* CU_pReportFormat_T;
 /**<
  *  Type for structure with interface of report.
+ *  pAbortReport (may be NULL) is called instead of pCloseReport when the
+ *  test program receives a fatal signal or calls exit() while tests are
+ *  running.  It writes whatever is needed to leave a well-formed,
+ *  truncated report, and flushes and closes the file.
  */
 
 CU_EXPORT void CU_automated_run_tests(void);
 /**<
  *  Runs CUnit tests using the automated interface.
- *  This function sets appropriate callback functions, initializes the
- *  test output files, and calls the appropriate functions to list the
- *  tests and run them.  If an output file name root has not been
- *  specified using CU_set_output_filename(), a generic root will be
- *  applied.  It is an error to call this function before the CUnit
- *  test registry has been initialized (check by assertion).
+ *  This function opens the report of each attached format, registers
+ *  the handlers of each format as a listener (see CU_add_listener()),
+ *  runs the tests, and closes the reports.  Handlers set with the
+ *  CU_set_*_handler() functions are called as well.  A format whose
+ *  report cannot be opened is skipped.  If an output file name root
+ *  has not been specified using CU_set_output_filename(), a generic
+ *  root will be applied.  It is an error to call this function before
+ *  the CUnit test registry has been initialized or without a report
+ *  format (checked by assertion).
+ *  <br /><br />
+ *
+ *  While the tests run, handlers for SIGSEGV, SIGBUS, SIGFPE, SIGILL
+ *  and SIGABRT and an atexit() handler complete the report through
+ *  pAbortReport and flush stdout and stderr, so that a crashing test
+ *  still leaves a well-formed report.  The previous signal handlers
+ *  are restored after the run.
  */
 
 CU_EXPORT CU_ErrorCode CU_list_tests_to_file(void);
 /**<
  *  Generates an xml file containing a list of all tests in all suites
- *  in the active registry.  The output file will be named according to
- *  the most recent call to CU_set_output_filename(), or a default if
- *  not previously set.
+ *  in the active registry, for each attached format supporting it.  The
+ *  output file will be named according to the most recent call to
+ *  CU_set_output_filename(), or a default if not previously set.
  *
- *  @return An error code indicating the error status.
+ *  @return An error code indicating the first error encountered.
  */
 
 CU_EXPORT void CU_set_output_filename(const char* szFilenameRoot);
 /**<
- *  Sets the root file name for automated test output files.
- *  The strings "-Listing.xml" and "-Results.xml" are appended to the
- *  specified root to generate the filenames.  If szFilenameRoot is
- *  empty, the default root ("CUnitAutomated") is used.
+ *  Sets the root file name for automated test output files of all
+ *  attached formats.  The strings "-Listing.xml" and "-Results.xml" are
+ *  appended to the specified root to generate the filenames.  If
+ *  szFilenameRoot is empty, the default root ("CUnitAutomated") is used.
+ *  Formats attached together need different roots, which are set by
+ *  calling their pSetOutputFilename functions directly.
  *
  *  @param szFilenameRoot String containing root to use for file names.
  */
@@ -124,7 +156,18 @@ CU_EXPORT const char *CU_automated_package_name_get();
 
 CU_EXPORT void CU_automated_set_report_format(CU_pReportFormat_T pReportFormat);
 /**<
- *  Selects specific report formatter.
+ *  Selects specific report formatter, detaching any others.
+ */
+
+CU_EXPORT CU_ErrorCode CU_automated_add_report_format(CU_pReportFormat_T pReportFormat);
+/**<
+ *  Attaches a further report formatter, so that one run writes the
+ *  reports of all attached formats.  Attaching a format twice has no
+ *  effect.
+ *
+ *  @param pReportFormat The format to attach (non-NULL).
+ *  @return CUE_TOO_MANY_LISTENERS if CU_AUTOMATED_MAX_FORMATS formats
+ *          are attached, CUE_SUCCESS otherwise.
  */
 #ifdef __cplusplus
 }
@@ -0,0 +1,200 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Binary result stream format and reader.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Binary result streams written by the Binary report format
+ *  (see Report_Binary.h), and a reader for them.
+ *  <br /><br />
+ *
+ *  A stream starts with the 8 bytes of CU_BINARY_MAGIC (the last of
+ *  which is the format version).  Records follow, each consisting of
+ *  its length (the record type byte and the payload) and the record
+ *  type, then the payload.  Integers are unsigned LEB128 varints (7 bits
+ *  per byte, least significant first).  Durations are in nanoseconds.
+ *  <br /><br />
+ *
+ *  Names, file names and conditions are written once, in a
+ *  CU_BINARY_STRING record whose payload is the bytes of the string.
+ *  String records are numbered from 1 in the order written, and other
+ *  records refer to strings by that number (0 stands for NULL).  The
+ *  reader resolves the numbers, so its records hold plain strings.
+ *  <br /><br />
+ *
+ *  Records are only ever appended, and the writer flushes the stream
+ *  after each suite.  A reader which meets an incomplete record at the
+ *  end of the file reports CU_BINARY_END and can be called again later
+ *  to continue, so a stream can be followed while a run is writing it.
+ *  A complete stream ends with a CU_BINARY_RUN_END or CU_BINARY_ABORT
+ *  record.  Record types unknown to a reader are skipped.
+ */
+/** @addtogroup Automated
+ * @{
+ */
+
+#ifndef CUNIT_BINARYRESULTS_H_SEEN
+#define CUNIT_BINARYRESULTS_H_SEEN
+
+#include <time.h>
+
+#include "CUnit.h"
+#include "TestRun.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_BINARY_MAGIC "CUBR\0\0\0\1"
+/**< First bytes of a binary result stream (the last one is the version). */
+
+#define CU_BINARY_MAGIC_LENGTH 8
+/**< Length of CU_BINARY_MAGIC. */
+
+#define CU_BINARY_VERSION 1
+/**< Format version written and read by this library. */
+
+/** Record types of a binary result stream.
+ *  The payload of each record follows its description; "string" is a
+ *  string number, "duration" a number of nanoseconds and "failures" a
+ *  count followed by that many (type, line, file string, condition
+ *  string) tuples.
+ */
+typedef enum CU_BinaryRecordType
+{
+  CU_BINARY_STRING = 1,         /**< Bytes of the next string. */
+  CU_BINARY_RUN_START,          /**< Start time (time_t), package name string. */
+  CU_BINARY_TEST_START,         /**< Suite string, test string. */
+  CU_BINARY_TEST_END,           /**< Suite string, test string, duration, failures. */
+  CU_BINARY_SUITE_INIT_FAILURE, /**< Suite string. */
+  CU_BINARY_SUITE_CLEANUP_FAILURE, /**< Suite string. */
+  CU_BINARY_SUITE_END,          /**< Suite string, tests failed, failure records of the
+                                     suite run (including those of its tests), count and
+                                     (test string, duration) of each registered test of
+                                     the shard run (see Shard.h),
+                                     failures of the suite itself (inactive, init and
+                                     cleanup failures). */
+  CU_BINARY_RUN_END,            /**< End time, suites and tests registered, the counters
+                                     of CU_RunSummary in declaration order with the
+                                     elapsed time as a duration (nTestsCrashed, which
+                                     marks a tainted run, is missing in streams of older
+                                     writers and then read as 0). */
+  CU_BINARY_ABORT               /**< None: the run was aborted (see CU_reportFormat_T). */
+} CU_BinaryRecordType;
+
+/** A failure in a record read from a binary result stream. */
+typedef struct CU_BinaryFailure
+{
+  CU_FailureType type;          /**< Failure type. */
+  unsigned int   uiLineNumber;  /**< Line number of the failure. */
+  const char*    szFileName;    /**< File name (NULL if none). */
+  const char*    szCondition;   /**< Condition (NULL if none). */
+} CU_BinaryFailure;
+
+/** A test in the test list of a suite end record. */
+typedef struct CU_BinaryTest
+{
+  const char* szName;           /**< Test name. */
+  double      dDuration;        /**< Duration of the last run of the test in seconds. */
+} CU_BinaryTest;
+
+/** A record read from a binary result stream.
+ *  Only the members used by the record type are set; the others are 0
+ *  or NULL.  Strings remain valid until the reader is closed, the
+ *  arrays until the next call of CU_binary_reader_next().
+ */
+typedef struct CU_BinaryRecord
+{
+  CU_BinaryRecordType     type;          /**< Record type (never CU_BINARY_STRING). */
+  const char*             szSuite;       /**< Suite name (test and suite records). */
+  const char*             szTest;        /**< Test name (test records). */
+  const char*             szPackage;     /**< Package name (run start). */
+  time_t                  tTime;         /**< Start (run start) or end (run end) time. */
+  double                  dDuration;     /**< Test duration in seconds (test end). */
+  unsigned int            uiTestsFailed; /**< Failed tests of the suite (suite end). */
+  unsigned int            uiFailureRecords; /**< Failure records of the suite run, including
+                                                 those in test end records (suite end; 0 if
+                                                 the run did not pass them to reporters). */
+  unsigned int            nTests;        /**< Entries in pTests (suite end). */
+  const CU_BinaryTest*    pTests;        /**< Registered tests of the suite, in order (suite end). */
+  unsigned int            nFailures;     /**< Entries in pFailures (test end, suite end). */
+  const CU_BinaryFailure* pFailures;     /**< Failures in the order they were recorded. */
+  unsigned int            uiSuitesRegistered; /**< Suites in the registry (run end). */
+  unsigned int            uiTestsRegistered;  /**< Tests in the registry (run end). */
+  CU_RunSummary           summary;       /**< Summary of the run (run end). */
+} CU_BinaryRecord;
+
+/** Results of CU_binary_reader_next(). */
+typedef enum CU_BinaryStatus
+{
+  CU_BINARY_OK = 0,       /**< A record was read. */
+  CU_BINARY_END,          /**< No complete record follows (yet). */
+  CU_BINARY_ERROR         /**< The stream is malformed or could not be read. */
+} CU_BinaryStatus;
+
+typedef struct CU_BinaryReader CU_BinaryReader;  /**< Opaque reader state. */
+typedef CU_BinaryReader* CU_pBinaryReader;       /**< Pointer to a reader. */
+
+CU_EXPORT CU_pBinaryReader CU_binary_reader_open(const char* szFilename);
+/**<
+ *  Opens a binary result stream for reading.  A filename of "-" reads
+ *  from stdin.  The stream header is checked by the first call of
+ *  CU_binary_reader_next(), so that a file just being created can be
+ *  opened.
+ *
+ *  @param szFilename Name of the file (non-NULL).
+ *  @return A new reader, or NULL with the error code set to
+ *          CUE_FOPEN_FAILED or CUE_NOMEMORY.
+ */
+
+CU_EXPORT void CU_binary_reader_close(CU_pBinaryReader pReader);
+/**< Closes the file (unless stdin) and frees the reader (NULL is ignored). */
+
+CU_EXPORT CU_BinaryStatus CU_binary_reader_next(CU_pBinaryReader pReader, CU_BinaryRecord* pRecord);
+/**<
+ *  Reads the next record other than a string record.  After
+ *  CU_BINARY_END, further calls read records appended to the file in
+ *  the meantime.
+ *
+ *  @param pReader The reader (non-NULL).
+ *  @param pRecord Receives the record (non-NULL).
+ *  @return CU_BINARY_OK, CU_BINARY_END, or CU_BINARY_ERROR with the
+ *          error code set to CUE_BAD_FILE_FORMAT, CUE_READ_ERROR or
+ *          CUE_NOMEMORY.  Once CU_BINARY_ERROR has been returned, later
+ *          calls return it as well.
+ */
+
+CU_EXPORT CU_BOOL CU_binary_reader_is_complete(CU_pBinaryReader pReader);
+/**<
+ *  Checks whether the last record read ended the stream, i.e. was a
+ *  CU_BINARY_RUN_END or CU_BINARY_ABORT record.
+ */
+
+CU_EXPORT unsigned long CU_binary_reader_offset(CU_pBinaryReader pReader);
+/**< Offset in the stream of the end of the last record read. */
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_BINARYRESULTS_H_SEEN  */
+/** @} */
@@ -32,6 +32,20 @@
  *                error codes for file open errors, added error action selection. (JDS)
  *
  *  05-Sep-2004   Added internal test interface. (JDS)
+ *
+ *  18-Oct-2026   Added CUE_BAD_LOAD_PARAMS, CUE_BAD_SOAK_PARAMS. (AGT)
+ *
+ *  18-Oct-2026   Added CUE_BAD_ALLOCATOR. (AGT)
+ *
+ *  18-Oct-2026   Added CUE_ALLOC_FAIL_UNAVAILABLE. (AGT)
+ *
+ *  18-Oct-2026   Added listener error codes. (AGT)
+ *
+ *  18-Oct-2026   Added CUE_READ_ERROR, CUE_BAD_FILE_FORMAT. (AGT)
+ *
+ *  18-Oct-2026   Added CUE_ISOLATION_UNAVAILABLE, CUE_BAD_ISOLATION_PARAMS. (AGT)
+ *
+ *  18-Oct-2026   Added CUE_BAD_SHARD. (AGT)
  */
 
 /** @file
@@ -63,10 +77,11 @@ typedef enum {
   /* basic errors */
   CUE_SUCCESS           = 0,  /**< No error condition. */
   CUE_NOMEMORY          = 1,  /**< Memory allocation failed. */
+  CUE_BAD_ALLOCATOR     = 2,  /**< Incomplete allocator passed to CU_set_allocator(). */
 
   /* Test Registry Level Errors */
   CUE_NOREGISTRY        = 10,  /**< Test registry not initialized. */
-  CUE_REGISTRY_EXISTS   = 11,  /**< Attempt to CU_set_registry() without CU_cleanup_registry(). */
+  CUE_REGISTRY_EXISTS   = 11,  /**< Attempt to CU_set_registry() or CU_set_allocator() without CU_cleanup_registry(). */
 
   /* Test Suite Level Errors */
   CUE_NOSUITE           = 20,  /**< A required CU_pSuite pointer was NULL. */
@@ -82,12 +97,27 @@ typedef enum {
   CUE_DUP_TEST          = 32,  /**< Duplicate test case name not allowed. */
   CUE_TEST_NOT_IN_SUITE = 33,  /**< Test not registered in specified suite. */
   CUE_TEST_INACTIVE     = 34,  /**< Test run initiated for an inactive test. */
+  CUE_BAD_LOAD_PARAMS   = 35,  /**< Invalid rate, duration or worker count for a load test. */
+  CUE_BAD_SOAK_PARAMS   = 36,  /**< Invalid duration or metric for a soak test. */
+  CUE_ALLOC_FAIL_UNAVAILABLE = 37,  /**< Allocation failure sweeps not supported or wrapper not linked. */
+  CUE_ISOLATION_UNAVAILABLE = 38,   /**< Process isolation not supported, or a worker could not be started. */
+  CUE_BAD_ISOLATION_PARAMS = 39,    /**< Invalid isolation mode or batch size. */
 
   /* File handling errors */
   CUE_FOPEN_FAILED      = 40,  /**< An error occurred opening a file. */
   CUE_FCLOSE_FAILED     = 41,  /**< An error occurred closing a file. */
   CUE_BAD_FILENAME      = 42,  /**< A bad filename was requested (NULL, empty, nonexistent, etc.). */
-  CUE_WRITE_ERROR       = 43   /**< An error occurred during a write to a file. */
+  CUE_WRITE_ERROR       = 43,  /**< An error occurred during a write to a file. */
+  CUE_READ_ERROR        = 44,  /**< An error occurred during a read from a file. */
+  CUE_BAD_FILE_FORMAT   = 45,  /**< A file read is not in the expected format. */
+
+  /* Listener errors */
+  CUE_NOLISTENER        = 50,  /**< A required CU_Listener pointer was NULL, or the listener is not registered. */
+  CUE_TOO_MANY_LISTENERS = 51, /**< CU_MAX_LISTENERS listeners are already registered. */
+  CUE_LISTENER_BUSY     = 52,  /**< Listeners cannot be added or removed during a test run. */
+
+  /* Sharding errors */
+  CUE_BAD_SHARD         = 60   /**< Invalid shard index or count, or invalid shard environment variables. */
 } CU_ErrorCode;
 
 /*------------------------------------------------------------------------*/
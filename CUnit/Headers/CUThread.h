@@ -0,0 +1,110 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Minimal portable thread, mutex and sleep wrappers used internally
+ *  by CUnit (POSIX threads or Win32).
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Thread support functions (internal).
+ *  Threads and mutexes are opaque handles so that this header does
+ *  not pull platform headers into user code.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_CUTHREAD_H_SEEN
+#define CUNIT_CUTHREAD_H_SEEN
+
+#include "CUnit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER)
+#  define CU_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#  define CU_THREAD_LOCAL __thread
+#else
+#  define CU_THREAD_LOCAL _Thread_local
+#endif
+/**< Storage class for thread-local variables. */
+
+typedef struct CU_ThreadImpl* CU_pThread;   /**< Handle of a thread. */
+typedef struct CU_MutexImpl*  CU_pMutex;    /**< Handle of a mutex. */
+typedef struct CU_CondImpl*   CU_pCond;     /**< Handle of a condition variable. */
+
+typedef void (*CU_ThreadFunc)(void* pArg);  /**< Thread entry function. */
+
+CU_EXPORT CU_pThread CU_thread_create(CU_ThreadFunc pFunc, void* pArg);
+/**<
+ *  Starts a new thread running pFunc(pArg).
+ *  @return Thread handle, or NULL if the thread could not be started.
+ */
+
+CU_EXPORT void CU_thread_join(CU_pThread pThread);
+/**< Waits for a thread to finish and releases its handle. */
+
+CU_EXPORT CU_pMutex CU_mutex_create(void);
+/**< Creates a mutex.  @return Mutex handle, or NULL on failure. */
+
+CU_EXPORT void CU_mutex_destroy(CU_pMutex pMutex);
+/**< Destroys a mutex created with CU_mutex_create() (NULL is ignored). */
+
+CU_EXPORT void CU_mutex_lock(CU_pMutex pMutex);
+/**< Locks a mutex. */
+
+CU_EXPORT void CU_mutex_unlock(CU_pMutex pMutex);
+/**< Unlocks a mutex. */
+
+CU_EXPORT CU_pCond CU_cond_create(void);
+/**< Creates a condition variable.  @return Handle, or NULL on failure. */
+
+CU_EXPORT void CU_cond_destroy(CU_pCond pCond);
+/**< Destroys a condition variable (NULL is ignored). */
+
+CU_EXPORT CU_BOOL CU_cond_wait(CU_pCond pCond, CU_pMutex pMutex, double dTimeout);
+/**<
+ *  Waits on a condition variable with pMutex locked.
+ *  @param dTimeout Maximum wait in seconds, or a negative value to wait
+ *                  without limit.
+ *  @return CU_FALSE if the wait timed out, CU_TRUE otherwise.  Spurious
+ *          wakeups are possible, so callers must recheck their condition.
+ */
+
+CU_EXPORT void CU_cond_broadcast(CU_pCond pCond);
+/**< Wakes all threads waiting on a condition variable. */
+
+CU_EXPORT void CU_sleep(double dSeconds);
+/**< Suspends the calling thread for (at least) the given number of seconds. */
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_CUThread(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_CUTHREAD_H_SEEN  */
+/** @} */
@@ -36,6 +36,22 @@
  *
  *  07-May-2005   Added CU_ prefix to remaining CUnit defines (BOOL, TRUE, 
  *                FALSE, MAX_...).  Added CU_UNREFERENCED_PARAMETER() define. (JDS)
+ *
+ *  18-Oct-2026   Include LoadTest.h for load test registration and assertions. (AGT)
+ *
+ *  18-Oct-2026   Include SoakTest.h. (AGT)
+ *
+ *  18-Oct-2026   Include AllocTrack.h for allocation assertions. (AGT)
+ *
+ *  18-Oct-2026   Include MyMem.h for CU_set_allocator(). (AGT)
+ *
+ *  18-Oct-2026   Include AllocFail.h. (AGT)
+ *
+ *  18-Oct-2026   Include Isolation.h. (AGT)
+ *
+ *  18-Oct-2026   Include Timeout.h. (AGT)
+ *
+ *  18-Oct-2026   Include Shard.h. (AGT)
  */
 
 /** @file
@@ -111,6 +127,14 @@
 #include "CUError.h"
 #include "TestDB.h"   /* not needed here - included for user convenience */
 #include "TestRun.h"  /* not needed here - include (after BOOL define) for user convenience */
+#include "LoadTest.h" /* not needed here - included for user convenience */
+#include "SoakTest.h" /* not needed here - included for user convenience */
+#include "AllocTrack.h" /* not needed here - included for user convenience */
+#include "AllocFail.h" /* not needed here - included for user convenience */
+#include "Isolation.h" /* not needed here - included for user convenience */
+#include "Timeout.h"  /* not needed here - included for user convenience */
+#include "Shard.h"    /* not needed here - included for user convenience */
+#include "MyMem.h"    /* not needed here - included for user convenience */
 
 /** Record a pass condition without performing a logical test. */
 #define CU_PASS(msg) \
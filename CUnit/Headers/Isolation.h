@@ -0,0 +1,258 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for running tests in isolated worker processes.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *  18-Oct-2026   Added per-test resource limits. (AGT)
+ *  18-Oct-2026   Added per-suite fixture snapshots. (AGT)
+ */
+
+/** @file
+ *  Process isolation of tests.
+ *  With CU_set_isolation() the tests of a run are executed in worker
+ *  processes instead of the test program itself, so a test that
+ *  crashes, is killed by a signal or calls exit() only fails itself.
+ *  Workers are forked after the suite setup function, so every worker
+ *  starts from the fixture of its suite.  A worker runs the test setup
+ *  function, the test function and the test teardown function, and
+ *  streams its assertion counts and failure records back to the test
+ *  program over a pipe; listeners and reports see a normal run.
+ *  <br /><br />
+ *
+ *  In CU_ISOLATION_TEST mode each worker runs a single test.  In
+ *  CU_ISOLATION_BATCH mode a worker runs up to the batch size of tests
+ *  of its suite, trading isolation between those tests for fewer
+ *  forks.  A spare worker is forked while the current one runs its
+ *  last test, so the next test does not wait for fork().
+ *  <br /><br />
+ *
+ *  A worker that dies during a test adds a CUF_TestCrashed failure
+ *  record to the test naming the signal or exit status, and a test for
+ *  which no worker can be started a CUF_WorkerFailed one.  Assertions passed since the last
+ *  failure of a crashed test are not counted.  Load tests, soak tests
+ *  and allocation failure sweeps keep running in the test program, and
+ *  allocation statistics of isolated tests are not reported.
+ *  Isolation needs fork() and is not available on Windows.
+ *  <br /><br />
+ *
+ *  CU_set_suite_snapshot() isolates the tests of a single suite whatever
+ *  the isolation mode: its initialization function runs once, every
+ *  test (or batch of tests) starts from a copy-on-write snapshot of the
+ *  state it left, and its cleanup function runs once in the test
+ *  program at the end.  This suits suites with an expensive fixture
+ *  that their tests change.
+ *  <br /><br />
+ *
+ *  A test with resource limits (see CU_set_test_limits()) runs in a
+ *  worker of its own, also when isolation is not selected.  The worker
+ *  applies the limits with setrlimit() before the test setup function:
+ *  the processor time limit ends the worker with SIGXCPU, the open file
+ *  limit bounds the descriptors it may open, and its address space is
+ *  capped at CU_LIMITS_ADDRESS_SPACE_FACTOR times the memory limit
+ *  above what it uses at the start as a backstop.  On Linux the test
+ *  program samples the resident memory, threads and open files of the
+ *  worker every CU_LIMITS_SAMPLE_INTERVAL seconds and kills it as soon
+ *  as one exceeds its limit.  A test exceeding a limit fails with the
+ *  failure type of the limit and the observed peak.  The limits apply
+ *  to the whole worker, including what it inherits from the test
+ *  program.  Load tests, soak tests and allocation failure sweeps run
+ *  without their limits.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_ISOLATION_H_SEEN
+#define CUNIT_ISOLATION_H_SEEN
+
+#include "CUnit.h"
+#include "TestDB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_ISOLATION_MAX_STRING 1024
+/**< Longest condition or file name streamed back by a worker (longer ones are truncated). */
+
+/** Isolation modes. */
+typedef enum CU_IsolationMode
+{
+  CU_ISOLATION_NONE = 0,  /**< Tests run in the test program (default). */
+  CU_ISOLATION_TEST,      /**< Each test runs in a worker of its own. */
+  CU_ISOLATION_BATCH      /**< Each worker runs up to the batch size of tests. */
+} CU_IsolationMode;
+
+#define CU_LIMITS_SAMPLE_INTERVAL 0.005
+/**< Interval between samples of a worker running a test with limits (s). */
+
+#define CU_LIMITS_ADDRESS_SPACE_FACTOR 4
+/**< Address space growth allowed to a test as a multiple of its memory limit. */
+
+/** Resource limits of a test (see CU_set_test_limits()); 0 means no limit. */
+typedef struct CU_TestLimits
+{
+  size_t       szMaxRss;          /**< Resident memory of the worker (bytes). */
+  unsigned int uiMaxCpuSeconds;   /**< Processor time of the worker (s). */
+  unsigned int uiMaxOpenFiles;    /**< Open file descriptors of the worker. */
+  unsigned int uiMaxThreads;      /**< Threads of the worker. */
+} CU_TestLimits;
+
+/** Resource limits that a test can exceed. */
+typedef enum CU_TestLimit
+{
+  CU_LIMIT_NONE = 0,      /**< No limit exceeded. */
+  CU_LIMIT_MEMORY,        /**< CU_TestLimits.szMaxRss exceeded. */
+  CU_LIMIT_CPU,           /**< CU_TestLimits.uiMaxCpuSeconds exceeded. */
+  CU_LIMIT_OPEN_FILES,    /**< CU_TestLimits.uiMaxOpenFiles exceeded. */
+  CU_LIMIT_THREADS        /**< CU_TestLimits.uiMaxThreads exceeded. */
+} CU_TestLimit;
+
+/** Outcome of a test run by a worker. */
+typedef struct CU_IsolatedResult
+{
+  CU_BOOL      bCompleted;      /**< CU_TRUE if the worker finished the test. */
+  int          iSignal;         /**< Signal that ended the worker during the test, 0 if none. */
+  int          iExitStatus;     /**< Exit status if the worker exited during the test. */
+  unsigned int nAsserts;        /**< Assertions made by the test. */
+  unsigned int nAssertsFailed;  /**< Assertions failed by the test. */
+  double       dSetUp;          /**< Seconds in the test setup function. */
+  double       dRun;            /**< Seconds in the test function. */
+  double       dTearDown;       /**< Seconds in the test teardown function. */
+  double       dCpuTime;        /**< Processor seconds of the test function. */
+  CU_TestLimit exceeded;        /**< Limit exceeded by a test with limits, CU_LIMIT_NONE if none. */
+  double       dPeakRss;        /**< Peak resident memory of the worker (bytes, tests with limits on Linux). */
+  double       dPeakCpu;        /**< Processor seconds of the worker (tests with limits). */
+  unsigned int uiPeakOpenFiles; /**< Most open file descriptors sampled (tests with limits on Linux). */
+  unsigned int uiPeakThreads;   /**< Most threads sampled (tests with limits on Linux). */
+} CU_IsolatedResult;
+
+typedef void (*CU_IsolatedTestFunc)(CU_pTest pTest, CU_IsolatedResult* pResult);
+/**< Runs a test inside a worker and fills in the counts and timings of pResult. */
+
+typedef void (*CU_IsolatedFailureFunc)(CU_FailureType type, unsigned int uiLine,
+                                       const char* szCondition, const char* szFile);
+/**< Records a failure streamed back by a worker in the test program. */
+
+CU_EXPORT CU_ErrorCode CU_set_isolation(CU_IsolationMode mode, unsigned int uiBatchSize);
+/**<
+ *  Selects the isolation mode for subsequent test runs.
+ *
+ *  @param mode        The isolation mode.
+ *  @param uiBatchSize Tests run by each worker in CU_ISOLATION_BATCH
+ *                     mode (> 0); ignored in the other modes.
+ *  @return CUE_ISOLATION_UNAVAILABLE if isolation is not supported on
+ *          this platform, CUE_BAD_ISOLATION_PARAMS if the mode or batch
+ *          size is invalid, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_IsolationMode CU_get_isolation_mode(void);
+/**< Retrieves the isolation mode selected with CU_set_isolation(). */
+
+CU_EXPORT unsigned int CU_get_isolation_batch_size(void);
+/**< Retrieves the number of tests each worker runs (1 unless CU_ISOLATION_BATCH). */
+
+CU_EXPORT unsigned int CU_get_isolation_workers_started(void);
+/**< Retrieves the number of worker processes forked since the last CU_set_isolation(). */
+
+CU_EXPORT CU_ErrorCode CU_set_suite_snapshot(CU_pSuite pSuite, unsigned int uiBatchSize);
+/**<
+ *  Runs the tests of a suite in workers forked after its initialization
+ *  function, so they start from its fixture.
+ *
+ *  @param pSuite      The suite (non-NULL).
+ *  @param uiBatchSize Tests run by each worker (1 for a fresh fixture
+ *                     for every test), or 0 to follow the isolation mode.
+ *  @return CUE_NOSUITE if pSuite is NULL, CUE_ISOLATION_UNAVAILABLE if
+ *          isolation is not supported on this platform, CUE_SUCCESS
+ *          otherwise.
+ */
+
+CU_EXPORT unsigned int CU_get_suite_snapshot(CU_pSuite pSuite);
+/**< Retrieves the batch size set with CU_set_suite_snapshot() (0 if none). */
+
+CU_EXPORT const char* CU_get_signal_name(int iSignal);
+/**< Retrieves the name of a signal (e.g. "SIGSEGV"), or "unknown signal". */
+
+CU_EXPORT CU_ErrorCode CU_set_test_limits(CU_pTest pTest, const CU_TestLimits* pLimits);
+/**<
+ *  Sets the resource limits of a test.
+ *
+ *  @param pTest   The test (non-NULL).
+ *  @param pLimits The limits, or NULL (or all 0) to remove them.
+ *  @return CUE_NOTEST if pTest is NULL, CUE_ISOLATION_UNAVAILABLE if
+ *          limits are not supported on this platform, CUE_NOMEMORY on
+ *          allocation failure, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT const CU_TestLimits* CU_get_test_limits(CU_pTest pTest);
+/**< Retrieves the resource limits of a test, or NULL if it has none. */
+
+CU_EXPORT const char* CU_get_test_limit_name(CU_TestLimit limit);
+/**< Retrieves the name of a resource limit (e.g. "memory"). */
+
+CU_EXPORT CU_BOOL CU_is_isolation_worker(void);
+/**< Checks whether the calling process is a worker running isolated tests. */
+
+CU_EXPORT CU_ErrorCode CU_isolation_begin_suite(CU_IsolatedTestFunc pRunTest, unsigned int uiBatchSize);
+/**<
+ *  Starts the workers of a suite (internal).
+ *  Called by the test run functions after the suite setup function with
+ *  the tests each worker runs, or with a uiBatchSize of 0 around a test
+ *  with limits in a suite that is not isolated.
+ *  @return CUE_ISOLATION_UNAVAILABLE if no worker could be forked,
+ *          CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_ErrorCode CU_isolation_run_test(CU_pTest pTest, CU_IsolatedFailureFunc pFailure,
+                                             CU_IsolatedResult* pResult);
+/**<
+ *  Runs a test in a worker of the current suite (internal).
+ *  pFailure is called for each failure the worker reports, before the
+ *  function returns.  pResult->bCompleted is CU_FALSE if the worker
+ *  died during the test; pResult->iSignal or pResult->iExitStatus then
+ *  tell how.  A test with limits runs in a worker of its own;
+ *  pResult->exceeded tells which limit it exceeded, if any.
+ *  @return CUE_ISOLATION_UNAVAILABLE if no worker could be forked,
+ *          CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT void CU_isolation_end_suite(void);
+/**< Stops the workers of the current suite (internal). */
+
+CU_EXPORT void CU_isolation_report_failure(CU_FailureType type, unsigned int uiLine,
+                                           const char* szCondition, const char* szFile,
+                                           unsigned int nAsserts, unsigned int nAssertsFailed);
+/**<
+ *  Streams a failure of the running test back to the test program
+ *  (internal, called in workers).  nAsserts and nAssertsFailed are the
+ *  counts of the test so far.
+ */
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_Isolation(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_ISOLATION_H_SEEN  */
+/** @} */
@@ -0,0 +1,208 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for open-loop load tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Open-loop load tests.
+ *  A load test is a regular CU_Test whose test function is called
+ *  repeatedly at a fixed arrival rate for a given duration by a pool
+ *  of worker threads.  Call i is scheduled to start at
+ *  t0 + i / target_rate regardless of how long earlier calls took, and
+ *  its latency is measured from that intended start time.  A slow call
+ *  therefore shows up in the latency of the calls queued behind it
+ *  instead of silently lowering the request rate (coordinated omission).
+ *  <br /><br />
+ *
+ *  Assertions in the test function work as usual and are serialized
+ *  between workers.  A fatal assertion ends only the current call.
+ *  The latency assertions (CU_ASSERT_P99_BELOW() etc.) evaluate the most
+ *  recently completed load test, so they can be used in the suite
+ *  teardown function or in a regular test registered after the load test.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_LOADTEST_H_SEEN
+#define CUNIT_LOADTEST_H_SEEN
+
+#include "CUnit.h"
+#include "TestDB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_LOAD_HISTOGRAM_SUB_BUCKETS 16
+/**< Number of linear sub-buckets per power of 2 in the latency histogram. */
+
+#define CU_LOAD_HISTOGRAM_BUCKETS (CU_LOAD_HISTOGRAM_SUB_BUCKETS * 29)
+/**<
+ *  Number of buckets in the latency histogram.  Latencies are recorded
+ *  in microseconds with a relative precision of 1/16 up to about
+ *  4295 seconds; longer latencies are counted in the last bucket.
+ */
+
+#define CU_LOAD_DEFAULT_WORKERS 4
+/**< Default number of worker threads for a load test. */
+
+/** Results of a load test run. */
+typedef struct CU_LoadResult
+{
+  double        dTargetRate;    /**< Requested calls per second. */
+  double        dAchievedRate;  /**< Completed calls per second. */
+  double        dElapsedTime;   /**< Time from first scheduled start to last completion (s). */
+  unsigned int  uiWorkers;      /**< Number of worker threads used. */
+  unsigned long ulRequests;     /**< Number of calls completed. */
+  unsigned long ulAborted;      /**< Number of calls ended by a fatal assertion. */
+  double        dMinLatency;    /**< Smallest latency (s). */
+  double        dMaxLatency;    /**< Largest latency (s). */
+  double        dMeanLatency;   /**< Mean latency (s). */
+  unsigned long aulHistogram[CU_LOAD_HISTOGRAM_BUCKETS]; /**< Latency counts per bucket. */
+} CU_LoadResult;
+typedef CU_LoadResult* CU_pLoadResult;  /**< Pointer to load test results. */
+
+/** Load test parameters attached to a CU_Test. */
+typedef struct CU_LoadTest
+{
+  double        dTargetRate;    /**< Calls per second. */
+  double        dDuration;      /**< Length of the schedule (s). */
+  unsigned int  uiWorkers;      /**< Number of worker threads. */
+  CU_LoadResult result;         /**< Results of the last run. */
+} CU_LoadTest;
+
+CU_EXPORT CU_pTest CU_add_load_test(CU_pSuite pSuite,
+                                    const char* strName,
+                                    CU_TestFunc pTestFunc,
+                                    double dTargetRate,
+                                    double dDuration);
+/**<
+ *  Creates a new load test and registers it with the specified suite.
+ *  The test behaves like one added with CU_add_test(), except that when
+ *  it runs pTestFunc is called ceil(dTargetRate * dDuration) times at a
+ *  fixed arrival rate of dTargetRate calls per second, using
+ *  CU_LOAD_DEFAULT_WORKERS worker threads (see CU_set_load_test_workers()).
+ *  Suite setup and teardown functions run once around the whole load.
+ *  Error codes are as for CU_add_test(), plus CUE_BAD_LOAD_PARAMS if
+ *  dTargetRate or dDuration is not positive.
+ *
+ *  @param pSuite      Test suite to which to add new test (non-NULL).
+ *  @param strName     Name for the new test case (non-NULL).
+ *  @param pTestFunc   Function to call for each request (non-NULL).
+ *  @param dTargetRate Arrival rate in calls per second (> 0).
+ *  @param dDuration   Length of the schedule in seconds (> 0).
+ *  @return A pointer to the newly-created test (NULL if creation failed)
+ */
+
+CU_EXPORT CU_ErrorCode CU_set_load_test_workers(CU_pTest pTest, unsigned int uiWorkers);
+/**<
+ *  Sets the number of worker threads used by a load test.
+ *  If the workers are all busy when a call is due, the call starts late
+ *  and the delay counts toward its latency.
+ *  @return CUE_NOTEST if pTest is NULL or not a load test,
+ *          CUE_BAD_LOAD_PARAMS if uiWorkers is 0, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_BOOL CU_is_load_test(CU_pTest pTest);
+/**< Checks whether pTest was created by CU_add_load_test(). */
+
+CU_EXPORT const CU_LoadResult* CU_get_load_result(CU_pTest pTest);
+/**<
+ *  Retrieves the results of the last run of a load test.
+ *  @return The results, or NULL if pTest is not a load test.
+ */
+
+CU_EXPORT const CU_LoadResult* CU_get_last_load_result(void);
+/**<
+ *  Retrieves the results of the most recently completed load test.
+ *  The results are a copy and stay valid after the test registry
+ *  is cleaned up.
+ *  @return The results, or NULL if no load test has run yet.
+ */
+
+CU_EXPORT double CU_get_load_percentile(const CU_LoadResult* pResult, double dPercentile);
+/**<
+ *  Calculates a latency percentile from a load test histogram.
+ *  The upper bound of the histogram bucket holding the percentile is
+ *  returned, so the result errs on the high side by at most 1/16.
+ *  @param pResult     Load test results (may be NULL).
+ *  @param dPercentile Percentile in the range 0 - 100.
+ *  @return The latency in seconds, or HUGE_VAL if pResult is NULL or
+ *          holds no completed calls.
+ */
+
+CU_EXPORT double CU_get_load_bucket_limit(unsigned int uiBucket);
+/**<
+ *  Retrieves the upper bound of a latency histogram bucket in seconds.
+ *  Bucket i counts latencies up to CU_get_load_bucket_limit(i) and
+ *  above CU_get_load_bucket_limit(i-1).
+ */
+
+CU_EXPORT CU_ErrorCode CU_run_load(CU_pTest pTest);
+/**<
+ *  Runs the load schedule of a load test (internal).
+ *  Called by the test run functions in place of the test function.
+ *  Results are stored in the test and become the last load result.
+ *  If no worker thread can be started the schedule is run on the
+ *  calling thread.
+ */
+
+/** Asserts that the given latency percentile of the last load test
+ *  is below ms milliseconds.
+ *  Reports failure with no other action.
+ */
+#define CU_ASSERT_PERCENTILE_BELOW(percentile, ms) \
+  { CU_assertImplementation((CU_get_load_percentile(CU_get_last_load_result(), (percentile)) * 1000.0 < (double)(ms)), __LINE__, ("CU_ASSERT_PERCENTILE_BELOW(" #percentile "," #ms ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the median latency of the last load test is below ms milliseconds. */
+#define CU_ASSERT_P50_BELOW(ms) \
+  { CU_assertImplementation((CU_get_load_percentile(CU_get_last_load_result(), 50.0) * 1000.0 < (double)(ms)), __LINE__, ("CU_ASSERT_P50_BELOW(" #ms ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the 90th percentile latency of the last load test is below ms milliseconds. */
+#define CU_ASSERT_P90_BELOW(ms) \
+  { CU_assertImplementation((CU_get_load_percentile(CU_get_last_load_result(), 90.0) * 1000.0 < (double)(ms)), __LINE__, ("CU_ASSERT_P90_BELOW(" #ms ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the 99th percentile latency of the last load test is below ms milliseconds. */
+#define CU_ASSERT_P99_BELOW(ms) \
+  { CU_assertImplementation((CU_get_load_percentile(CU_get_last_load_result(), 99.0) * 1000.0 < (double)(ms)), __LINE__, ("CU_ASSERT_P99_BELOW(" #ms ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the 99.9th percentile latency of the last load test is below ms milliseconds. */
+#define CU_ASSERT_P999_BELOW(ms) \
+  { CU_assertImplementation((CU_get_load_percentile(CU_get_last_load_result(), 99.9) * 1000.0 < (double)(ms)), __LINE__, ("CU_ASSERT_P999_BELOW(" #ms ")"), __FILE__, "", CU_FALSE); }
+
+/** Asserts that the last load test achieved at least the given fraction
+ *  (0 - 1) of its target rate.
+ */
+#define CU_ASSERT_THROUGHPUT_ABOVE(fraction) \
+  { CU_assertImplementation(((NULL != CU_get_last_load_result()) && (CU_get_last_load_result()->dAchievedRate >= (double)(fraction) * CU_get_last_load_result()->dTargetRate)), __LINE__, ("CU_ASSERT_THROUGHPUT_ABOVE(" #fraction ")"), __FILE__, "", CU_FALSE); }
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_LoadTest(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_LOADTEST_H_SEEN  */
+/** @} */
@@ -27,6 +27,10 @@
  *  17-Jul-2004   New interface for global function names. (JDS)
  *
  *  05-Sep-2004   Added internal test interface. (JDS)
+ *
+ *  18-Oct-2026   Added pluggable allocator for CUnit's own allocations. (AGT)
+ *
+ *  18-Oct-2026   Added binary and summary memory dump formats. (AGT)
  */
 
 /** @file
@@ -34,8 +38,27 @@
  *  Two versions of memory allocation/deallocation are available.
  *  If compiled with MEMTRACE defined, CUnit keeps track of all
  *  system allocations & deallocations.  The memory record can
- *  then be reported using CU_CREATE_MEMORY_REPORT.  Otherwise,
+ *  then be reported using CU_CREATE_MEMORY_REPORT.  The tracker
+ *  may be used from several threads at once.  Otherwise,
  *  standard system memory allocation is used without tracing.
+ *  <br /><br />
+ *
+ *  The report is written in the format selected with
+ *  CU_SET_MEMORY_DUMP_FORMAT: the full xml listing (Memory-Dump.dtd),
+ *  a compact binary dump which the cunit-memdump tool converts to the
+ *  same xml, or a text summary of leaks and double frees per
+ *  allocation site.
+ *  <br /><br />
+ *
+ *  In both cases the memory itself is obtained from the allocator
+ *  installed with CU_set_allocator() - by default the C library's
+ *  malloc(), realloc() and free().  A test program that measures heap
+ *  usage can move CUnit's own data (registry, failure records, report
+ *  buffers) out of its way with
+ *  <pre>
+ *    CU_set_allocator(CU_get_arena_allocator());
+ *  </pre>
+ *  before CU_initialize_registry().
  */
 /** @addtogroup Framework
  * @{
@@ -44,16 +67,90 @@
 #ifndef CUNIT_MYMEM_H_SEEN
 #define CUNIT_MYMEM_H_SEEN
 
+#include <stddef.h>
+
+#include "CUnit.h"
+#include "CUError.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Allocates size bytes (size > 0) for CUnit; returns NULL on failure. */
+typedef void* (*CU_MallocFunc)(size_t size, void* pContext);
+/** Resizes a block of CUnit's (ptr non-NULL, size > 0); returns NULL on failure. */
+typedef void* (*CU_ReallocFunc)(void* ptr, size_t size, void* pContext);
+/** Releases a block of CUnit's (ptr non-NULL). */
+typedef void  (*CU_FreeFunc)(void* ptr, void* pContext);
+
+/** Allocator used for CUnit's internal allocations. */
+typedef struct CU_Allocator
+{
+  CU_MallocFunc  pMalloc;   /**< Allocation function. */
+  CU_ReallocFunc pRealloc;  /**< Reallocation function. */
+  CU_FreeFunc    pFree;     /**< Deallocation function. */
+  void*          pContext;  /**< Passed to each of the functions. */
+} CU_Allocator;
+
+CU_EXPORT CU_ErrorCode CU_set_allocator(const CU_Allocator* pAllocator);
+/**<
+ *  Sets the allocator for CUnit's internal allocations.
+ *  The allocator is copied.  Since memory must be returned to the
+ *  allocator it came from, the allocator can only be changed while no
+ *  test registry exists, i.e. before CU_initialize_registry() or after
+ *  CU_cleanup_registry().
+ *
+ *  @param pAllocator The allocator to use, or NULL for the default
+ *                    (the C library).
+ *  @return CUE_BAD_ALLOCATOR if a function of pAllocator is NULL,
+ *          CUE_REGISTRY_EXISTS if a test registry exists,
+ *          CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT const CU_Allocator* CU_get_allocator(void);
+/**< Retrieves the allocator for CUnit's internal allocations. */
+
+CU_EXPORT const CU_Allocator* CU_get_arena_allocator(void);
+/**<
+ *  Retrieves CUnit's dedicated arena allocator.
+ *  The arena takes memory directly from the operating system (mmap()
+ *  or VirtualAlloc()) rather than the C library heap, so CUnit's data
+ *  does not show in the heap statistics of the program under test or
+ *  change the state of its allocator.  Small blocks are recycled within
+ *  the arena and never returned to the system.  It is safe to use from
+ *  multiple threads.
+ */
+
+/** Formats of the memory report written by CU_dump_memory_usage(). */
+typedef enum CU_MemoryDumpFormat
+{
+  CU_MEMORY_DUMP_XML = 0,   /**< Every memory event, as xml (Memory-Dump.dtd). */
+  CU_MEMORY_DUMP_BINARY,    /**< Every memory event, in the compact binary format. */
+  CU_MEMORY_DUMP_SUMMARY    /**< Leaks and double frees per allocation site, as text. */
+} CU_MemoryDumpFormat;
+
+#define CU_MEMORY_DUMP_MAGIC "CUMEMDMP"
+/**< First 8 bytes of a binary memory dump. */
+#define CU_MEMORY_DUMP_VERSION 1
+/**< Version of the binary memory dump format. */
+
+CU_EXPORT void* CU_allocator_malloc(size_t size);
+/**< Allocates memory from the current allocator (internal). */
+CU_EXPORT void* CU_allocator_calloc(size_t nmemb, size_t size);
+/**< Allocates zeroed memory from the current allocator (internal). */
+CU_EXPORT void* CU_allocator_realloc(void* ptr, size_t size);
+/**< Resizes memory from the current allocator (internal). */
+CU_EXPORT void  CU_allocator_free(void* ptr);
+/**< Releases memory to the current allocator (internal). */
+
 #ifdef MEMTRACE
   void* CU_calloc(size_t nmemb, size_t size, unsigned int uiLine, const char* szFileName);
   void* CU_malloc(size_t size, unsigned int uiLine, const char* szFileName);
   void  CU_free(void *ptr, unsigned int uiLine, const char* szFileName);
   void* CU_realloc(void *ptr, size_t size, unsigned int uiLine, const char* szFileName);
   CU_EXPORT void CU_dump_memory_usage(const char*);
+  CU_EXPORT void CU_set_memory_dump_format(CU_MemoryDumpFormat format);
+  CU_EXPORT CU_MemoryDumpFormat CU_get_memory_dump_format(void);
 
   /** c-allocate with memory tracking. */
   #define CU_CALLOC(x, y)         CU_calloc((x), (y), __LINE__, __FILE__)
@@ -67,19 +164,23 @@ extern "C" {
   #define CU_CREATE_MEMORY_REPORT(x) CU_dump_memory_usage((x))
   /** Generate report on tracked memory (old macro). */
   #define CU_DUMP_MEMORY_USAGE(x) CU_dump_memory_usage((x))
+  /** Select the format of the memory report (a CU_MemoryDumpFormat). */
+  #define CU_SET_MEMORY_DUMP_FORMAT(x) CU_set_memory_dump_format((x))
 #else   /* MEMTRACE */
-  /** Standard calloc() if MEMTRACE not defined. */
-  #define CU_CALLOC(x, y)         calloc((x), (y))
-  /** Standard malloc() if MEMTRACE not defined. */
-  #define CU_MALLOC(x)            malloc((x))
-  /** Standard free() if MEMTRACE not defined. */
-  #define CU_FREE(x)              free((x))
-  /** Standard realloc() if MEMTRACE not defined. */
-  #define CU_REALLOC(x, y)        realloc((x), (y))
+  /** Allocator calloc() if MEMTRACE not defined. */
+  #define CU_CALLOC(x, y)         CU_allocator_calloc((x), (y))
+  /** Allocator malloc() if MEMTRACE not defined. */
+  #define CU_MALLOC(x)            CU_allocator_malloc((x))
+  /** Allocator free() if MEMTRACE not defined. */
+  #define CU_FREE(x)              CU_allocator_free((x))
+  /** Allocator realloc() if MEMTRACE not defined. */
+  #define CU_REALLOC(x, y)        CU_allocator_realloc((x), (y))
   /** No-op if MEMTRACE not defined. */
   #define CU_CREATE_MEMORY_REPORT(x)
   /** No-op if MEMTRACE not defined. */
   #define CU_DUMP_MEMORY_USAGE(x)
+  /** No-op if MEMTRACE not defined. */
+  #define CU_SET_MEMORY_DUMP_FORMAT(x)
 #endif  /* MEMTRACE */
 
 #ifdef CUNIT_BUILD_TESTS
@@ -0,0 +1,66 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+ /*
+  *  Binary Format interface (generates binary result streams).
+  *
+  *  18-Oct-2026   Initial implementation (AGT)
+  */
+
+  /** @file
+   * Automated testing interface with binary output (user interface).
+   * The results file ("<root>-Results.cubr") holds the events of the
+   * run as a binary result stream (see BinaryResults.h), from which the
+   * cunit-convert tool produces CUnit-Run xml, JUnit xml or JSON.
+   * Test listings are not supported.
+   */
+   /** @addtogroup Automated
+    * @{
+    */
+
+#ifndef CUNIT_REPORT_BINARY_H_SEEN
+#define CUNIT_REPORT_BINARY_H_SEEN
+
+#include "CUnit.h"
+#include "Automated.h"
+#include "BinaryResults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_REPORT_FORMAT_BINARY (&CU_reportFormat_Binary)
+
+extern CU_reportFormat_T CU_reportFormat_Binary;
+
+extern void CU_report_Binary_set_output_filename(const char* szFilename);
+extern CU_ErrorCode CU_report_Binary_open_report(void);
+extern CU_ErrorCode CU_report_Binary_close_report(void);
+extern void CU_report_Binary_test_start_msg_handler(const CU_pTest pTest, const CU_pSuite pSuite);
+extern void CU_report_Binary_test_complete_msg_handler(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+extern void CU_report_Binary_all_tests_complete_msg_handler(const CU_pFailureRecord pFailure);
+extern void CU_report_Binary_suite_init_failure_msg_handler(const CU_pSuite pSuite);
+extern void CU_report_Binary_suite_cleanup_failure_msg_handler(const CU_pSuite pSuite);
+extern void CU_report_Binary_suite_complete_msg_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+extern void CU_report_Binary_abort_report(void);
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_REPORT_BINARY_H_SEEN  */
+/** @} */
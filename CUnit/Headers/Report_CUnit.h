@@ -23,6 +23,8 @@
   *  CUnit Format interface (generates CUnit XML Report Files).
   *
   *  24-Jan-2019   Initial implementation (PMi)
+  *
+  *  18-Oct-2026   Added suite complete and abort handlers (AGT)
   */
 
   /** @file
@@ -54,6 +56,8 @@ extern void CU_report_CUnit_test_complete_msg_handler(const CU_pTest pTest, cons
 extern void CU_report_CUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFailure);
 extern void CU_report_CUnit_suite_init_failure_msg_handler(const CU_pSuite pSuite);
 extern void CU_report_CUnit_suite_cleanup_failure_msg_handler(const CU_pSuite pSuite);
+extern void CU_report_CUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+extern void CU_report_CUnit_abort_report(void);
 extern CU_ErrorCode CU_report_CUnit_list_all_tests(CU_pTestRegistry pRegistry);
 
 #ifdef __cplusplus
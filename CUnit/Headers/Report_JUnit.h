@@ -23,6 +23,8 @@
   *  JUnit Format interface (generates JUnit XML Report Files).
   *
   *  24-Jan-2019   Initial implementation (PMi)
+  *
+  *  18-Oct-2026   Added abort handler (AGT)
   */
 
   /** @file
@@ -51,6 +53,7 @@ extern CU_ErrorCode CU_report_JUnit_open_report(void);
 extern CU_ErrorCode CU_report_JUnit_close_report(void);
 extern void CU_report_JUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFailure);
 extern void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+extern void CU_report_JUnit_abort_report(void);
 #ifdef __cplusplus
 }
 #endif
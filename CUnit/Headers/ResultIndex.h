@@ -0,0 +1,188 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Offset index of xml result files.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Offset index appended to the xml result files of the CUnit and JUnit
+ *  report formats, and a reader seeking directly to the records of a
+ *  suite or test through it.
+ *  <br /><br />
+ *
+ *  While writing, the reports note the byte offset and length of each
+ *  suite record (a CUNIT_RUN_SUITE or testsuite element) and each test
+ *  record (the CUNIT_RUN_TEST_RECORD elements of a test, or a testcase
+ *  element).  When the report is closed, or completed after an abort,
+ *  the index follows the root element as an xml comment:
+ *  <pre>
+ *  <!-- CUNIT_INDEX 1
+ *  S offset length suite
+ *  T offset length suite test
+ *  -->
+ *  <!-- CUNIT_INDEX_OFFSET 00000000000000001234 -->
+ *  </pre>
+ *  Offsets and lengths are decimal.  Names are the registered names,
+ *  with '%', '-', spaces, control characters and DEL written as %XX.
+ *  The last line has a fixed length and holds the offset of the index
+ *  comment, so a reader finds the index from the end of the file.
+ *  xml parsers skip both comments.
+ *  <br /><br />
+ *
+ *  A suite whose initialization or cleanup failed has a suite record
+ *  for the failure in the CUnit format, so its name may appear in two
+ *  suite entries.  After an abort, records of the suite which was
+ *  running are missing from the index (in the CUnit format, its test
+ *  records are present).
+ */
+/** @addtogroup Automated
+ * @{
+ */
+
+#ifndef CUNIT_RESULTINDEX_H_SEEN
+#define CUNIT_RESULTINDEX_H_SEEN
+
+#include <stdio.h>
+
+#include "CUnit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_RESULT_INDEX_VERSION 1
+/**< Index format version written and read by this library. */
+
+/** Kinds of records in an index. */
+typedef enum CU_ResultIndexKind
+{
+  CU_RESULT_INDEX_SUITE = 'S',  /**< A suite record. */
+  CU_RESULT_INDEX_TEST = 'T'    /**< A test record. */
+} CU_ResultIndexKind;
+
+/** An entry of an index read by CU_result_index_open().
+ *  The strings remain valid until the index is closed.
+ */
+typedef struct CU_ResultIndexEntry
+{
+  CU_ResultIndexKind kind;      /**< Kind of record. */
+  const char*        szSuite;   /**< Suite name. */
+  const char*        szTest;    /**< Test name (NULL for suite records). */
+  unsigned long      ulOffset;  /**< Offset of the record in the file. */
+  unsigned long      ulLength;  /**< Length of the record in bytes. */
+} CU_ResultIndexEntry;
+
+typedef struct CU_ResultIndexWriter CU_ResultIndexWriter;  /**< Opaque index writer state. */
+typedef CU_ResultIndexWriter* CU_pResultIndexWriter;       /**< Pointer to an index writer. */
+
+typedef struct CU_ResultIndex CU_ResultIndex;  /**< Opaque index reader state. */
+typedef CU_ResultIndex* CU_pResultIndex;       /**< Pointer to an index read from a file. */
+
+CU_EXPORT CU_pResultIndexWriter CU_result_index_writer_create(void);
+/**<
+ *  Creates an empty index for a report being written (used by the
+ *  report formats).
+ *  @return The writer, or NULL if out of memory.
+ */
+
+CU_EXPORT void CU_result_index_writer_destroy(CU_pResultIndexWriter pWriter);
+/**< Frees an index writer (NULL is ignored). */
+
+CU_EXPORT void CU_result_index_add(CU_pResultIndexWriter pWriter, CU_ResultIndexKind kind,
+                                   const char* szSuite, const char* szTest,
+                                   unsigned long ulOffset, unsigned long ulLength);
+/**<
+ *  Adds an entry to an index.  If memory runs out, the index is
+ *  dropped and CU_result_index_write() writes nothing, since an
+ *  incomplete index would hide records.
+ *
+ *  @param pWriter  The writer (NULL is ignored).
+ *  @param kind     Kind of record.
+ *  @param szSuite  Suite name (non-NULL).
+ *  @param szTest   Test name for test records, NULL otherwise.
+ *  @param ulOffset Offset of the record in the file.
+ *  @param ulLength Length of the record in bytes.
+ */
+
+CU_EXPORT void CU_result_index_write(CU_pResultIndexWriter pWriter, FILE* pFile, unsigned long ulOffset);
+/**<
+ *  Appends the index to a report.  Allocates no memory, so it may be
+ *  used by pAbortReport.
+ *
+ *  @param pWriter  The writer (NULL is ignored).
+ *  @param pFile    The report, positioned at its end (non-NULL).
+ *  @param ulOffset Current length of the report.
+ */
+
+CU_EXPORT CU_pResultIndex CU_result_index_open(const char* szFilename);
+/**<
+ *  Reads the index of a result file.  The file stays open for
+ *  CU_result_index_read().
+ *
+ *  @param szFilename Name of the file (non-NULL).
+ *  @return The index, or NULL with the error code set to
+ *          CUE_FOPEN_FAILED, CUE_READ_ERROR, CUE_BAD_FILE_FORMAT (no
+ *          or a malformed index) or CUE_NOMEMORY.
+ */
+
+CU_EXPORT void CU_result_index_close(CU_pResultIndex pIndex);
+/**< Closes the file and frees an index (NULL is ignored). */
+
+CU_EXPORT unsigned int CU_result_index_count(CU_pResultIndex pIndex);
+/**< Retrieves the number of entries of an index. */
+
+CU_EXPORT const CU_ResultIndexEntry* CU_result_index_entry(CU_pResultIndex pIndex, unsigned int uiEntry);
+/**<
+ *  Retrieves an entry of an index, in the order the records were
+ *  written.
+ *  @return The entry, or NULL if uiEntry is not less than the count.
+ */
+
+CU_EXPORT const CU_ResultIndexEntry* CU_result_index_find(CU_pResultIndex pIndex,
+                                                          const char* szSuite, const char* szTest);
+/**<
+ *  Looks up the record of a suite or test in an index.  Lookups take
+ *  constant time on average; the first one builds a hash table.
+ *
+ *  @param pIndex  The index (non-NULL).
+ *  @param szSuite Suite name (non-NULL).
+ *  @param szTest  Test name, or NULL for the suite record.
+ *  @return The first matching entry, or NULL if none (or if out of
+ *          memory, with the error code set to CUE_NOMEMORY).
+ */
+
+CU_EXPORT char* CU_result_index_read(CU_pResultIndex pIndex, const CU_ResultIndexEntry* pEntry);
+/**<
+ *  Reads the record of an entry from the result file.
+ *
+ *  @param pIndex The index (non-NULL).
+ *  @param pEntry An entry of the index (non-NULL).
+ *  @return The text of the record, allocated with CU_MALLOC() (to be
+ *          released with CU_FREE()), or NULL with the error code set
+ *          to CUE_READ_ERROR or CUE_NOMEMORY.
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_RESULTINDEX_H_SEEN  */
+/** @} */
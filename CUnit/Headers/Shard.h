@@ -0,0 +1,188 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for sharding test runs across processes.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Sharding of test runs.
+ *  A test program started as one of several shards runs only its part
+ *  of the tests, so a long run can be spread across processes or
+ *  machines and the result files merged afterwards (see cunit-merge).
+ *  The shard is selected with CU_set_shard(), or else taken from the
+ *  TEST_SHARD_INDEX and TEST_TOTAL_SHARDS environment variables when
+ *  CU_run_all_tests() or CU_run_suite() starts; every run entry point
+ *  of the Basic, Automated and interactive interfaces goes through one
+ *  of these.  When the shard comes from the environment and
+ *  TEST_SHARD_STATUS_FILE is set, that file is created to tell the
+ *  test runner that sharding is supported.  CU_run_test() ignores
+ *  sharding.
+ *  <br /><br />
+ *
+ *  Every test belongs to exactly one shard, and the partition depends
+ *  only on the names of the suites and tests and, with a timing file,
+ *  its contents, so all shards of a run agree on it without talking to
+ *  each other.  By default a test goes to the shard given by a hash of
+ *  its suite and test names, which keeps tests in place when others
+ *  are added or removed.  With CU_set_shard_timing_file() the active
+ *  tests are packed into the shards by their durations instead,
+ *  longest first, each into the shard with the least work so far;
+ *  tests missing from the file count with the mean duration of those
+ *  found.  Inactive tests are hashed, and an inactive suite or a suite
+ *  without tests goes to the shard of its name, whole.
+ *  <br /><br />
+ *
+ *  A suite runs in every shard holding one of its tests, including its
+ *  initialization and cleanup functions; the other tests of the suite
+ *  are left out of the run and of the reports.  The registry totals in
+ *  the run summary stay those of the whole registry.
+ *  <br /><br />
+ *
+ *  The timing file is only read.  After a run, the durations of the
+ *  tests it ran are written to the timing output file set with
+ *  CU_set_shard_timing_output(), one test per line: the duration in
+ *  seconds, a tab, the suite name, a tab and the test name, with '%',
+ *  tabs and line ends in names written as %XX.  Each shard thus writes
+ *  the timings of its own tests, so every shard needs its own output
+ *  file (e.g. with the shard index appended to the name); the files of
+ *  all shards of a run, concatenated in the same order for every shard,
+ *  make the timing file of the next run (a test listed twice takes its
+ *  last duration).
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_SHARD_H_SEEN
+#define CUNIT_SHARD_H_SEEN
+
+#include "CUnit.h"
+#include "TestDB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_SHARD_INDEX_ENV        "TEST_SHARD_INDEX"
+/**< Environment variable holding the index of the shard to run (from 0). */
+
+#define CU_SHARD_TOTAL_ENV        "TEST_TOTAL_SHARDS"
+/**< Environment variable holding the number of shards. */
+
+#define CU_SHARD_STATUS_FILE_ENV  "TEST_SHARD_STATUS_FILE"
+/**< Environment variable naming a file to create when sharding is supported. */
+
+#define CU_SHARD_DEFAULT_COST 1.0
+/**< Duration (s) assumed for every test when the timing file lists none of them. */
+
+CU_EXPORT CU_ErrorCode CU_set_shard(unsigned int uiIndex, unsigned int uiTotal);
+/**<
+ *  Selects the shard run by the test program, overriding the
+ *  environment.
+ *
+ *  @param uiIndex Index of the shard (less than uiTotal).
+ *  @param uiTotal Number of shards; 1 runs all tests, 0 returns to
+ *                 the shard of the environment (the default).
+ *  @return CUE_BAD_SHARD if uiIndex is not less than a non-zero
+ *          uiTotal (the selection is left unchanged), CUE_SUCCESS
+ *          otherwise.
+ */
+
+CU_EXPORT unsigned int CU_get_shard_index(void);
+/**<
+ *  Retrieves the index of the shard selected with CU_set_shard() or,
+ *  if none, the environment (0 if not sharded or the environment is
+ *  invalid).
+ */
+
+CU_EXPORT unsigned int CU_get_shard_total(void);
+/**<
+ *  Retrieves the number of shards selected with CU_set_shard() or, if
+ *  none, the environment (1 if not sharded or the environment is
+ *  invalid).
+ */
+
+CU_EXPORT CU_ErrorCode CU_set_shard_timing_file(const char* szFilename);
+/**<
+ *  Selects the timing file which partitions the tests by duration (see
+ *  above).  The file is only read.  A missing file is not an error:
+ *  the tests are then packed as if of equal duration.  Malformed lines
+ *  are skipped.
+ *
+ *  @param szFilename Name of the file, or NULL for hash partitioning
+ *                    without timings (the default).
+ *  @return CUE_BAD_FILENAME if szFilename is empty or too long,
+ *          CUE_NOMEMORY if it cannot be copied, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT const char* CU_get_shard_timing_file(void);
+/**< Retrieves the timing file set with CU_set_shard_timing_file() (NULL if none). */
+
+CU_EXPORT CU_ErrorCode CU_set_shard_timing_output(const char* szFilename);
+/**<
+ *  Selects the file receiving the durations of the tests run by a
+ *  sharded run (see above).  The file is overwritten at the end of
+ *  each run, and must not be the timing file.
+ *
+ *  @param szFilename Name of the file, or NULL to write no timings
+ *                    (the default).
+ *  @return CUE_BAD_FILENAME if szFilename is empty or too long,
+ *          CUE_NOMEMORY if it cannot be copied, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT const char* CU_get_shard_timing_output(void);
+/**< Retrieves the file set with CU_set_shard_timing_output() (NULL if none). */
+
+CU_EXPORT CU_ErrorCode CU_shard_begin_run(CU_pTestRegistry pRegistry, CU_BOOL bSharded);
+/**<
+ *  Partitions the tests of a registry at the start of a run (internal,
+ *  called by the test run functions).  Sets the fInShard flags of all
+ *  suites and tests of the registry: to CU_TRUE if bSharded is
+ *  CU_FALSE, otherwise for those of the selected shard.
+ *
+ *  @return CUE_BAD_SHARD if the shard environment variables are set
+ *          but invalid, CUE_NOMEMORY if the tests cannot be packed
+ *          (all flags are then CU_FALSE), CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT void CU_shard_test_ran(CU_pSuite pSuite, CU_pTest pTest);
+/**< Notes a test run since CU_shard_begin_run(), for the timing output file (internal). */
+
+CU_EXPORT CU_ErrorCode CU_shard_end_run(void);
+/**<
+ *  Writes the durations of the tests run to the timing output file, if
+ *  one is set and the run was started with bSharded CU_TRUE (internal).
+ *
+ *  @return CUE_BAD_FILENAME if the output file is the timing file,
+ *          CUE_FOPEN_FAILED or CUE_WRITE_ERROR if it cannot be
+ *          written, CUE_SUCCESS otherwise.
+ */
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_Shard(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_SHARD_H_SEEN  */
+/** @} */
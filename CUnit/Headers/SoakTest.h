@@ -0,0 +1,169 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for soak tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Soak tests.
+ *  A soak test is a regular CU_Test whose test function is called in a
+ *  loop until a time budget runs out.  While it loops, a sampler thread
+ *  periodically records the resident set size, the heap in use, the
+ *  number of open file descriptors and the number of threads of the
+ *  process.  When the budget is spent, a least-squares line is fitted
+ *  to each series (ignoring the first 10% of samples as warm-up).  If a
+ *  series grows monotonically and the fitted growth over the run exceeds
+ *  the metric's threshold, a failure is recorded for the test.
+ *  <br /><br />
+ *
+ *  Suite initialization and cleanup run once around the suite as usual,
+ *  and the suite setup and teardown functions run once around the whole
+ *  soak.  A fatal assertion in the test function ends the soak.
+ *  <br /><br />
+ *
+ *  The metrics are read from /proc and the C library on Linux.  On other
+ *  platforms, unavailable metrics are left unchecked.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_SOAKTEST_H_SEEN
+#define CUNIT_SOAKTEST_H_SEEN
+
+#include "CUnit.h"
+#include "TestDB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Resource metrics sampled during a soak test. */
+typedef enum CU_SoakMetric
+{
+  CU_SOAK_RSS = 0,    /**< Resident set size (bytes). */
+  CU_SOAK_HEAP,       /**< Heap in use, as reported by mallinfo2() (bytes). */
+  CU_SOAK_FDS,        /**< Open file descriptors. */
+  CU_SOAK_THREADS,    /**< Threads in the process. */
+  CU_SOAK_METRICS     /**< Number of metrics (not a metric). */
+} CU_SoakMetric;
+
+#define CU_SOAK_SAMPLES 100
+/**< Number of samples aimed for over the duration of a soak test. */
+
+#define CU_SOAK_MIN_INTERVAL 0.01
+/**< Shortest interval between samples (s). */
+
+#define CU_SOAK_DEFAULT_RSS_THRESHOLD     (4.0 * 1024 * 1024)
+/**< Default allowed growth of CU_SOAK_RSS (bytes). */
+#define CU_SOAK_DEFAULT_HEAP_THRESHOLD    (1.0 * 1024 * 1024)
+/**< Default allowed growth of CU_SOAK_HEAP (bytes). */
+#define CU_SOAK_DEFAULT_FDS_THRESHOLD     4.0
+/**< Default allowed growth of CU_SOAK_FDS. */
+#define CU_SOAK_DEFAULT_THREADS_THRESHOLD 2.0
+/**< Default allowed growth of CU_SOAK_THREADS. */
+
+/** Results of a soak test run. */
+typedef struct CU_SoakResult
+{
+  unsigned long ulIterations;                 /**< Number of calls of the test function. */
+  unsigned int  uiSamples;                    /**< Number of samples taken. */
+  double        dElapsedTime;                 /**< Length of the soak (s). */
+  CU_BOOL       bAborted;                     /**< CU_TRUE if a fatal assertion ended the soak. */
+  CU_BOOL       abAvailable[CU_SOAK_METRICS]; /**< Whether each metric could be sampled. */
+  double        adFirst[CU_SOAK_METRICS];     /**< First sample after warm-up. */
+  double        adLast[CU_SOAK_METRICS];      /**< Last sample. */
+  double        adSlope[CU_SOAK_METRICS];     /**< Fitted growth per second. */
+  double        adGrowth[CU_SOAK_METRICS];    /**< Fitted growth over the analyzed samples. */
+  CU_BOOL       abMonotonic[CU_SOAK_METRICS]; /**< Whether the series grew monotonically. */
+  CU_BOOL       abLeak[CU_SOAK_METRICS];      /**< Whether the metric failed the test. */
+} CU_SoakResult;
+typedef CU_SoakResult* CU_pSoakResult;  /**< Pointer to soak test results. */
+
+/** Soak test parameters attached to a CU_Test. */
+typedef struct CU_SoakTest
+{
+  double        dDuration;                    /**< Time budget (s). */
+  double        adThreshold[CU_SOAK_METRICS]; /**< Allowed growth per metric. */
+  CU_SoakResult result;                       /**< Results of the last run. */
+} CU_SoakTest;
+
+CU_EXPORT CU_ErrorCode CU_set_soak_test(CU_pTest pTest, double dDuration);
+/**<
+ *  Selects a registered test for soak testing.
+ *  When the test runs, its function is called repeatedly for dDuration
+ *  seconds while resource usage is sampled.  Thresholds are reset to
+ *  their defaults.  A dDuration of 0 turns the test back into a regular
+ *  test.  Soak testing does not apply to load tests.
+ *
+ *  @param pTest     The test to select (non-NULL).
+ *  @param dDuration Time budget in seconds (>= 0).
+ *  @return CUE_NOTEST if pTest is NULL, CUE_BAD_SOAK_PARAMS if dDuration
+ *          is negative, CUE_NOMEMORY on allocation failure,
+ *          CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_ErrorCode CU_set_soak_threshold(CU_pTest pTest, CU_SoakMetric metric, double dThreshold);
+/**<
+ *  Sets the allowed growth of a metric over the run of a soak test.
+ *  A negative threshold disables the check for that metric.
+ *  @return CUE_NOTEST if pTest is NULL or not a soak test,
+ *          CUE_BAD_SOAK_PARAMS if metric is invalid, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_BOOL CU_is_soak_test(CU_pTest pTest);
+/**< Checks whether pTest has been selected with CU_set_soak_test(). */
+
+CU_EXPORT const CU_SoakResult* CU_get_soak_result(CU_pTest pTest);
+/**<
+ *  Retrieves the results of the last run of a soak test.
+ *  @return The results, or NULL if pTest is not a soak test.
+ */
+
+CU_EXPORT const char* CU_get_soak_metric_name(CU_SoakMetric metric);
+/**< Retrieves a short description of a metric (e.g. "heap in use"). */
+
+CU_EXPORT void CU_sample_soak_metrics(double adValues[CU_SOAK_METRICS],
+                                      CU_BOOL abAvailable[CU_SOAK_METRICS]);
+/**<
+ *  Samples the current value of each metric.
+ *  abAvailable[i] is set to CU_FALSE for metrics that cannot be read
+ *  on this platform, and adValues[i] to 0.
+ */
+
+CU_EXPORT CU_ErrorCode CU_run_soak(CU_pTest pTest);
+/**<
+ *  Runs the soak loop of a soak test (internal).
+ *  Called by the test run functions in place of the test function.
+ *  Results are stored in the test; the caller records failures for
+ *  metrics flagged in CU_SoakResult.abLeak.
+ */
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_SoakTest(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_SOAKTEST_H_SEEN  */
+/** @} */
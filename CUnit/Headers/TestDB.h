@@ -44,6 +44,24 @@
  *
  *  16-Avr-2007   Added setup and teardown functions. (CJN)
  *
+ *  18-Oct-2026   Added duration of last run to CU_Test. (AGT)
+ *
+ *  18-Oct-2026   Added load and soak test data to CU_Test. (AGT)
+ *
+ *  18-Oct-2026   Added allocation statistics to CU_Test. (AGT)
+ *
+ *  18-Oct-2026   Added allocation failure sweep data to CU_Test. (AGT)
+ *
+ *  18-Oct-2026   Added cached xml names to CU_Test and CU_Suite. (AGT)
+ *
+ *  18-Oct-2026   Added wall-clock timeout to CU_Test. (AGT)
+ *
+ *  18-Oct-2026   Added resource limits to CU_Test. (AGT)
+ *
+ *  18-Oct-2026   Added fixture snapshot batch size to CU_Suite. (AGT)
+ *
+ *  18-Oct-2026   Added shard membership to CU_Test and CU_Suite. (AGT)
+ *
  */
 
 /** @file
@@ -112,6 +130,15 @@ typedef struct CU_Test
   CU_BOOL         fActive;    /**< Flag for whether test is executed during a run. */
   CU_TestFunc     pTestFunc;  /**< Pointer to the test function. */
   jmp_buf*        pJumpBuf;   /**< Jump buffer for setjmp/longjmp test abort mechanism. */
+  double          dDuration;  /**< Duration of the last run of the test function in seconds. */
+  struct CU_LoadTest* pLoad;  /**< Load test parameters and results (NULL for regular tests). */
+  struct CU_SoakTest* pSoak;  /**< Soak test parameters and results (NULL for regular tests). */
+  struct CU_AllocStats* pAlloc; /**< Allocation statistics of the last run (NULL if not tracked). */
+  struct CU_AllocFailSweep* pAllocFail; /**< Allocation failure sweep results (NULL if not swept). */
+  char*           pXmlName;   /**< Name with xml special characters translated (NULL until requested, see CU_get_test_xml_name()). */
+  unsigned int    uiTimeout;  /**< Wall-clock timeout in milliseconds (0 for the default, see CU_set_test_timeout()). */
+  struct CU_TestLimits* pLimits; /**< Resource limits (NULL if none, see CU_set_test_limits()). */
+  CU_BOOL         fInShard;   /**< Flag for whether test belongs to the shard of the current run (see Shard.h). */
 
   struct CU_Test* pNext;      /**< Pointer to the next test in linked list. */
   struct CU_Test* pPrev;      /**< Pointer to the previous test in linked list. */
@@ -161,6 +188,9 @@ typedef struct CU_Suite
 
   unsigned int      uiNumberOfTestsFailed;  /**< Number of failed tests in the suite. */
   unsigned int      uiNumberOfTestsSuccess; /**< Number of success tests in the suite. */
+  char*             pXmlName;         /**< Name with xml special characters translated (NULL until requested, see CU_get_suite_xml_name()). */
+  unsigned int      uiSnapshotBatch;  /**< Tests run by each worker forked from the suite fixture (0 if none, see CU_set_suite_snapshot()). */
+  CU_BOOL           fInShard;         /**< Flag for whether suite belongs to the shard of the current run (see Shard.h). */
 } CU_Suite;
 typedef CU_Suite* CU_pSuite;          /**< Pointer to a CUnit suite. */
 
@@ -367,6 +397,20 @@ CU_ErrorCode CU_set_suite_name(CU_pSuite pSuite, const char *strNewName);
  *          strNewName is NULL, and CUE_SUCCESS if all is well.
  */
 
+CU_EXPORT
+const char* CU_get_suite_xml_name(CU_pSuite pSuite);
+/**<
+ *  Retrieves the name of a suite for use in xml output.
+ *  The name is translated with CU_translate_special_characters() the
+ *  first time it is requested and kept in pSuite->pXmlName until the
+ *  suite is renamed with CU_set_suite_name() or cleaned up.  Names
+ *  without special characters are not copied.  Reporters use this to
+ *  write names without allocating memory for each event.
+ *
+ *  @param pSuite Pointer to the suite (non-NULL).
+ *  @return The translated name, or "" if memory could not be allocated.
+ */
+
 CU_EXPORT
 CU_ErrorCode CU_set_suite_initfunc(CU_pSuite pSuite, CU_InitializeFunc pNewInit);
 /**<
@@ -549,6 +593,18 @@ CU_ErrorCode CU_set_test_name(CU_pTest pTest, const char *strNewName);
  *          strNewName is NULL, and CUE_SUCCESS if all is well.
  */
 
+CU_EXPORT
+const char* CU_get_test_xml_name(CU_pTest pTest);
+/**<
+ *  Retrieves the name of a test for use in xml output.
+ *  Works as CU_get_suite_xml_name(); the translated name is kept in
+ *  pTest->pXmlName until the test is renamed with CU_set_test_name()
+ *  or cleaned up.
+ *
+ *  @param pTest Pointer to the test (non-NULL).
+ *  @return The translated name, or "" if memory could not be allocated.
+ */
+
 CU_EXPORT
 CU_ErrorCode CU_set_test_func(CU_pTest pTest, CU_TestFunc pNewFunc);
 /**<
@@ -44,6 +44,24 @@
  *
  *  24-May-2006   Added callbacks for suite start and complete events.
  *                Added tracking/reported of elapsed time.  (JDS)
+ *
+ *  18-Oct-2026   Added CU_run_test_function_concurrently() for load tests. (AGT)
+ *
+ *  18-Oct-2026   Added listeners, timing and resource events. (AGT)
+ *
+ *  18-Oct-2026   Added the listener event queue. (AGT)
+ *
+ *  18-Oct-2026   Added capture of fatal signals in test functions. (AGT)
+ *
+ *  18-Oct-2026   Added CUF_TestTimeout failure type. (AGT)
+ *  18-Oct-2026   Added resource limit failure types. (AGT)
+ *
+ *  18-Oct-2026   Added CU_set_fail_fast(). (AGT)
+ *
+ *  18-Oct-2026   Added CU_stop_run(). (AGT)
+ *
+ *  18-Oct-2026   Deaths of isolated workers are CUF_TestCrashed failures,
+ *                added CUF_WorkerFailed. (AGT)
  */
 
 /** @file
@@ -58,7 +76,24 @@
  *  of each test, when all tests are complete, and when a suite
  *  initialialization function returns an error.  This allows clients to
  *  perform actions associated with these events such as output formatting
- *  and reporting.
+ *  and reporting.<br /><br />
+ *
+ *  Each event has one handler set by the CU_set_*_handler() functions.
+ *  Any number of further clients (up to CU_MAX_LISTENERS) can follow the
+ *  same events with a CU_Listener registered using CU_add_listener().
+ *  Listeners also receive timing and resource events after each test
+ *  and suite.  The handlers set by the CU_set_*_handler() functions act
+ *  as a default listener which is always called first; the registered
+ *  listeners follow in the order they were added.<br /><br />
+ *
+ *  By default all callbacks run on the test thread, so slow reporting
+ *  adds to the run time.  After CU_set_listener_queue_size(), events are
+ *  instead copied into a bounded queue and delivered to the listeners by
+ *  a writer thread, in order, while the tests go on.  When the queue is
+ *  full the test thread waits for room.  The run functions return after
+ *  the writer has delivered the all tests complete event.  The
+ *  CU_set_*_handler() handlers and listeners flagged
+ *  CU_LISTENER_SYNCHRONOUS are still called on the test thread.
  */
 /** @addtogroup Framework
  * @{
@@ -83,7 +118,15 @@ typedef enum CU_FailureTypes
   CUF_SuiteInitFailed,      /**< Suite initialization function failed. */
   CUF_SuiteCleanupFailed,   /**< Suite cleanup function failed. */
   CUF_TestInactive,         /**< Inactive test was run. */
-  CUF_AssertFailed          /**< CUnit assertion failed during test run. */
+  CUF_AssertFailed,         /**< CUnit assertion failed during test run. */
+  CUF_TestCrashed,          /**< Test function raised a fatal signal (see CU_set_crash_capture())
+                                 or its isolated worker died (see CU_set_isolation()). */
+  CUF_TestTimeout,          /**< Test did not complete within its timeout (see CU_set_test_timeout()). */
+  CUF_TestMemoryLimit,      /**< Test exceeded its memory limit (see CU_set_test_limits()). */
+  CUF_TestCpuLimit,         /**< Test exceeded its processor time limit. */
+  CUF_TestOpenFilesLimit,   /**< Test exceeded its open file limit. */
+  CUF_TestThreadsLimit,     /**< Test exceeded its thread limit. */
+  CUF_WorkerFailed          /**< No isolated worker could be started for the test. */
 } CU_FailureType;           /**< Failure type. */
 
 /* CU_FailureRecord type definition. */
@@ -118,6 +161,7 @@ typedef struct CU_RunSummary
   unsigned int nAssertsFailed;    /**< Number of failed assertions. */
   unsigned int nFailureRecords;   /**< Number of failure records generated. */
   double       ElapsedTime;       /**< Elapsed time for run in seconds. */
+  unsigned int nTestsCrashed;     /**< Number of tests whose crash was captured (the run is tainted if > 0). */
 } CU_RunSummary;
 typedef CU_RunSummary* CU_pRunSummary;  /**< Pointer to CU_RunSummary. */
 
@@ -202,6 +246,131 @@ CU_EXPORT CU_SuiteInitFailureMessageHandler    CU_get_suite_init_failure_handler
 CU_EXPORT CU_SuiteCleanupFailureMessageHandler CU_get_suite_cleanup_failure_handler(void);
 /**< Retrieves the message handler called when a suite cleanup error occurs. */
 
+/*--------------------------------------------------------------------
+ * Listeners.
+ *--------------------------------------------------------------------*/
+#define CU_MAX_LISTENERS 16
+/**< Maximum number of listeners registered with CU_add_listener(). */
+
+#define CU_LISTENER_SYNCHRONOUS 0x1
+/**<
+ *  CU_Listener flag: call the listener on the test thread even when the
+ *  event queue is used.  Required for listeners relying on the state of
+ *  the run at the time of the event (e.g. the current test, suite
+ *  counters, or failure records beyond those passed).
+ */
+
+struct CU_AllocStats;
+
+/** Durations of the phases of a test or suite in seconds (monotonic clock). */
+typedef struct CU_Timing
+{
+  double dSetUp;      /**< Suite setup function (test) or initialization function (suite). */
+  double dRun;        /**< Test function (test) or all tests of the suite (suite). */
+  double dTearDown;   /**< Suite teardown function (test) or cleanup function (suite). */
+} CU_Timing;
+
+/** Resources used by a test function. */
+typedef struct CU_TestResources
+{
+  double dCpuTime;                          /**< Processor time used while the test function ran, in seconds (clock()). */
+  const struct CU_AllocStats* pAllocStats;  /**< Heap allocations, NULL unless tracked (see AllocTrack.h). */
+} CU_TestResources;
+
+/** Set of callbacks following a test run.
+ *  Each callback receives the context pointer passed to CU_add_listener()
+ *  followed by the arguments of the corresponding message handler.  Any
+ *  callback may be NULL; events without a callback cost nothing.  For a
+ *  test which runs, pTestTiming and pTestResources are called after the
+ *  teardown function and before pTestComplete.  For a suite which runs,
+ *  pSuiteTiming is called before pSuiteComplete.
+ */
+typedef struct CU_Listener
+{
+  void (*pSuiteStart)(void* pContext, const CU_pSuite pSuite);
+  /**< Called at the start of a suite (see CU_SuiteStartMessageHandler). */
+  void (*pTestStart)(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite);
+  /**< Called at the start of a test (see CU_TestStartMessageHandler). */
+  void (*pTestComplete)(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite,
+                        const CU_pFailureRecord pFailure);
+  /**< Called at the completion of a test (see CU_TestCompleteMessageHandler). */
+  void (*pSuiteComplete)(void* pContext, const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+  /**< Called at the completion of a suite (see CU_SuiteCompleteMessageHandler). */
+  void (*pAllTestsComplete)(void* pContext, const CU_pFailureRecord pFailure);
+  /**< Called at the completion of a test run (see CU_AllTestsCompleteMessageHandler). */
+  void (*pSuiteInitFailure)(void* pContext, const CU_pSuite pSuite);
+  /**< Called when a suite initializer fails (see CU_SuiteInitFailureMessageHandler). */
+  void (*pSuiteCleanupFailure)(void* pContext, const CU_pSuite pSuite);
+  /**< Called when a suite cleanup function fails (see CU_SuiteCleanupFailureMessageHandler). */
+  void (*pTestTiming)(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite,
+                      const CU_Timing* pTiming);
+  /**< Called with the phase durations of a test which ran. */
+  void (*pSuiteTiming)(void* pContext, const CU_pSuite pSuite, const CU_Timing* pTiming);
+  /**< Called with the phase durations of a suite which ran (not for inactive suites). */
+  void (*pTestResources)(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite,
+                         const CU_TestResources* pResources);
+  /**< Called with the resources used by the function of a test which ran. */
+  unsigned int uiFlags;
+  /**< Zero or CU_LISTENER_SYNCHRONOUS. */
+} CU_Listener;
+
+CU_EXPORT CU_ErrorCode CU_add_listener(const CU_Listener* pListener, void* pContext);
+/**<
+ *  Registers a listener to be called after the default listener and all
+ *  listeners added before it.  pListener is not copied and must remain
+ *  valid until it is removed.  The same listener may be registered more
+ *  than once, e.g. with different contexts.
+ *
+ *  @param pListener The callbacks to call (non-NULL).
+ *  @param pContext  Pointer passed to each callback (may be NULL).
+ *  @return CUE_NOLISTENER if pListener is NULL, CUE_LISTENER_BUSY during
+ *          a test run, CUE_TOO_MANY_LISTENERS if CU_MAX_LISTENERS
+ *          listeners are registered, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_ErrorCode CU_remove_listener(const CU_Listener* pListener, void* pContext);
+/**<
+ *  Removes the earliest registration of pListener with pContext.
+ *
+ *  @return CUE_NOLISTENER if no such registration exists,
+ *          CUE_LISTENER_BUSY during a test run, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT unsigned int CU_get_number_of_listeners(void);
+/**< Retrieves the number of listeners registered with CU_add_listener(). */
+
+CU_EXPORT CU_ErrorCode CU_set_listener_queue_size(unsigned int uiRecords);
+/**<
+ *  Sets the number of events the event queue holds.  With a non-zero
+ *  size, runs with listeners not flagged CU_LISTENER_SYNCHRONOUS deliver
+ *  events to them from a writer thread.  Such listeners receive copies
+ *  of the failure records of test and suite complete events, valid only
+ *  during the callback, and the live test and suite.  If the queue or
+ *  the thread cannot be created, events are delivered on the test thread.
+ *
+ *  @param uiRecords Queue size in events, 0 (the default) for no queue.
+ *  @return CUE_LISTENER_BUSY during a test run, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT unsigned int CU_get_listener_queue_size(void);
+/**< Retrieves the event queue size set with CU_set_listener_queue_size(). */
+
+CU_EXPORT unsigned long CU_get_listener_queue_stalls(void);
+/**<
+ *  Retrieves the number of times the test thread waited for room in the
+ *  event queue during the current or last run.
+ */
+
+CU_EXPORT CU_BOOL CU_flush_listener_events(double dTimeout);
+/**<
+ *  Waits until the events queued so far have been delivered, e.g. before
+ *  completing reports when a test crashes.
+ *
+ *  @param dTimeout Maximum wait in seconds, negative to wait without limit.
+ *  @return CU_TRUE if no events are pending, CU_FALSE on timeout or if
+ *          called from a listener on the writer thread.
+ */
+
 /*--------------------------------------------------------------------
  * Functions for running registered tests and suites.
  *--------------------------------------------------------------------*/
@@ -308,6 +477,67 @@ CU_EXPORT CU_BOOL CU_get_fail_on_inactive(void);
  *  @see CU_set_fail_on_inactive()
  */
 
+CU_EXPORT void CU_set_fail_fast(unsigned int uiMaxFailures);
+/**<
+ *  Sets the number of failed tests after which a run stops (default 0,
+ *  for runs which never stop early).  Once that many tests have failed
+ *  during CU_run_all_tests() or CU_run_suite(), no further test is
+ *  started: the running suite completes with its cleanup function and
+ *  later suites are not run, so the reports of all interfaces are
+ *  complete for the tests run.  Tests which were not run do not appear
+ *  in the reports.  Suite initialization and cleanup failures do not
+ *  count, while inactive tests do when treated as failures (see
+ *  CU_set_fail_on_inactive()).
+ *
+ *  @param uiMaxFailures Number of failed tests stopping subsequent
+ *                       runs, or 0 to run all tests.
+ *  @see CU_get_fail_fast_test()
+ */
+
+CU_EXPORT unsigned int CU_get_fail_fast(void);
+/**< Retrieves the setting of CU_set_fail_fast(). */
+
+CU_EXPORT CU_pTest CU_get_fail_fast_test(void);
+/**<
+ *  Retrieves the test whose failure stopped the previous run under
+ *  CU_set_fail_fast(), the last test run (NULL if the run was not
+ *  stopped, reset each run).
+ */
+
+CU_EXPORT void CU_stop_run(void);
+/**<
+ *  Requests that the current run stop.  May be called from any thread
+ *  or from a message handler.  No further test is started: the running
+ *  test completes, its suite is cleaned up and later suites are not
+ *  run, as for CU_set_fail_fast().  The request is cleared when a run
+ *  completes, so one made while no run is in progress stops the next
+ *  run of CU_run_all_tests() or CU_run_suite() before its first test.
+ */
+
+#define CU_CRASH_MAX_FRAMES 16
+/**< Maximum number of frames in the backtrace of a captured crash. */
+
+CU_EXPORT void CU_set_crash_capture(CU_BOOL bCapture);
+/**<
+ *  Sets whether fatal signals raised by test functions are captured
+ *  (default CU_FALSE).  When set, SIGSEGV, SIGBUS, SIGFPE, SIGILL and
+ *  SIGABRT raised by a test function on the thread running the tests
+ *  are handled on an alternate signal stack: a CUF_TestCrashed failure
+ *  naming the signal, with a backtrace where available, is recorded
+ *  for the test, and the run continues with the teardown function and
+ *  the next test.  This is cheaper than process isolation (see
+ *  Isolation.h), but only best-effort: the crash may have left the
+ *  process in a broken state (e.g. a corrupted heap or a lock held),
+ *  so the run is reported as tainted.  Signals raised elsewhere, e.g.
+ *  in setup functions or load test workers, keep their previous
+ *  handling.  Not available on Windows, where the setting is ignored.
+ *
+ *  @param bCapture CU_TRUE to capture crashes in subsequent runs.
+ */
+
+CU_EXPORT CU_BOOL CU_get_crash_capture(void);
+/**< Retrieves the setting of CU_set_crash_capture(). */
+
 /*--------------------------------------------------------------------
  * Functions for getting information about the previous test run.
  *--------------------------------------------------------------------*/
@@ -323,6 +553,8 @@ CU_EXPORT unsigned int CU_get_number_of_tests_failed(void);
 /**< Retrieves the number of tests containing failed assertions during the previous run (reset each run). */
 CU_EXPORT unsigned int CU_get_number_of_tests_inactive(void);
 /**< Retrieves the number of inactive tests found during the previous run (reset each run). */
+CU_EXPORT unsigned int CU_get_number_of_tests_crashed(void);
+/**< Retrieves the number of tests whose crash was captured during the previous run (reset each run). */
 CU_EXPORT unsigned int CU_get_number_of_asserts(void);
 /**< Retrieves the number of assertions processed during the last run (reset each run). */
 CU_EXPORT unsigned int CU_get_number_of_successes(void);
@@ -429,6 +661,17 @@ CU_EXPORT CU_BOOL CU_assertImplementation(CU_BOOL bValue,
  *  @return As a convenience, returns the value of the assertion (i.e. bValue).
  */
 
+CU_EXPORT CU_BOOL CU_run_test_function_concurrently(CU_TestFunc pTestFunc);
+/**<
+ *  Calls the test function of the current test on the calling thread
+ *  (internal).  Used by load tests to call a test function from several
+ *  threads at once.  Assertions are serialized, and a fatal assertion
+ *  returns from this function instead of aborting the whole test.
+ *
+ *  @param pTestFunc The test function to call (non-NULL).
+ *  @return CU_FALSE if the call was ended by a fatal assertion, CU_TRUE otherwise.
+ */
+
 #ifdef USE_DEPRECATED_CUNIT_NAMES
 typedef CU_FailureRecord  _TestResult;  /**< @deprecated Use CU_FailureRecord. */
 typedef CU_pFailureRecord PTestResult;  /**< @deprecated Use CU_pFailureRecord. */
@@ -0,0 +1,166 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Interface for wall-clock timeouts of tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Wall-clock timeouts of tests and suite functions.
+ *  A test gets a timeout with CU_set_test_timeout(), or the default set
+ *  with CU_set_default_test_timeout(); the default also applies to the
+ *  suite initialization and cleanup functions.  The timeout covers the
+ *  test setup function, the test function and the test teardown
+ *  function.  A watchdog thread, started by the test run functions the
+ *  first time a timeout is armed, checks the deadlines.
+ *  <br /><br />
+ *
+ *  When a deadline passes, the watchdog records the stack traces of
+ *  the threads of the test program in the failure added for it.  With
+ *  CU_TIMEOUT_ABORT_TEST a test function that timed out is abandoned
+ *  like after a fatal assertion: a CUF_TestTimeout failure is recorded,
+ *  the teardown function runs and the run goes on.  A timeout in any
+ *  other function, or any timeout with CU_TIMEOUT_TERMINATE, records
+ *  the failure, completes the reports and ends the test program with
+ *  EXIT_FAILURE.  A function returning after its deadline has passed
+ *  is handled the same way.
+ *  <br /><br />
+ *
+ *  Abandoning a test function is best effort: locks it holds stay held
+ *  and memory it allocated leaks.  Stack traces of all threads need
+ *  Linux with glibc; elsewhere on POSIX systems only the thread running
+ *  the test is traced, and on Windows timeouts always terminate the
+ *  test program, without stack traces.
+ */
+/** @addtogroup Framework
+ * @{
+ */
+
+#ifndef CUNIT_TIMEOUT_H_SEEN
+#define CUNIT_TIMEOUT_H_SEEN
+
+#include "CUnit.h"
+#include "TestDB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CU_TIMEOUT_NONE 0xFFFFFFFFu
+/**< Test timeout disabling the default timeout for a test. */
+
+#define CU_TIMEOUT_MAX_FRAMES 32
+/**< Most stack frames recorded for each thread. */
+
+/** What happens when a test function times out. */
+typedef enum CU_TimeoutAction
+{
+  CU_TIMEOUT_ABORT_TEST = 0,  /**< Abandon the test function and go on with the run (default). */
+  CU_TIMEOUT_TERMINATE        /**< Complete the reports and end the test program. */
+} CU_TimeoutAction;
+
+typedef void (*CU_WatchdogExpiredFunc)(unsigned long ulDeadline, const char* szStacks);
+/**<
+ *  Called on the watchdog thread when an armed deadline passes, with
+ *  the id given to CU_watchdog_arm() and the stack traces of the
+ *  threads of the test program.
+ */
+
+typedef void (*CU_WatchdogInterruptFunc)(void);
+/**<
+ *  Called in a signal handler on the armed thread by
+ *  CU_watchdog_interrupt(); may leave with siglongjmp().
+ */
+
+CU_EXPORT CU_ErrorCode CU_set_test_timeout(CU_pTest pTest, unsigned int uiMilliseconds);
+/**<
+ *  Sets the wall-clock timeout of a test.
+ *
+ *  @param pTest          The test (non-NULL).
+ *  @param uiMilliseconds Timeout in milliseconds, 0 to use the default
+ *                        timeout, or CU_TIMEOUT_NONE for no timeout.
+ *  @return CUE_NOTEST if pTest is NULL, CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT unsigned int CU_get_test_timeout(CU_pTest pTest);
+/**< Retrieves the timeout in effect for a test in milliseconds (0 if none). */
+
+CU_EXPORT void CU_set_default_test_timeout(unsigned int uiMilliseconds);
+/**< Sets the timeout of tests without one of their own and of suite functions (0 for none, the default). */
+
+CU_EXPORT unsigned int CU_get_default_test_timeout(void);
+/**< Retrieves the default timeout in milliseconds (0 if none). */
+
+CU_EXPORT void CU_set_timeout_action(CU_TimeoutAction action);
+/**< Selects what happens when a test function times out. */
+
+CU_EXPORT CU_TimeoutAction CU_get_timeout_action(void);
+/**< Retrieves the action selected with CU_set_timeout_action(). */
+
+CU_EXPORT char* CU_get_thread_stacks(void);
+/**<
+ *  Captures the stack traces of the threads of the test program, as
+ *  far as supported (see above).  The calling thread is not included.
+ *  @return A string allocated with CU_MALLOC() (to be released with
+ *          CU_FREE()), or NULL if out of memory.
+ */
+
+CU_EXPORT CU_ErrorCode CU_watchdog_arm(unsigned int uiMilliseconds, unsigned long ulDeadline,
+                                       CU_WatchdogExpiredFunc pExpired,
+                                       CU_WatchdogInterruptFunc pInterrupt);
+/**<
+ *  Arms the watchdog for the calling thread (internal).
+ *  Starts the watchdog thread if needed and replaces any deadline
+ *  armed before.  pExpired is called once with ulDeadline if the
+ *  deadline passes before CU_watchdog_disarm(); it may still be
+ *  running when the deadline is disarmed or replaced.  Taking the
+ *  stack traces interrupts the armed thread, so a sleep it was
+ *  stuck in may end early.
+ *  @return CUE_NOMEMORY if the watchdog thread could not be started,
+ *          CUE_SUCCESS otherwise.
+ */
+
+CU_EXPORT CU_BOOL CU_watchdog_disarm(void);
+/**<
+ *  Cancels the deadline armed with CU_watchdog_arm() (internal).
+ *  @return CU_TRUE if the deadline had already passed.
+ */
+
+CU_EXPORT CU_BOOL CU_watchdog_interrupt(void);
+/**<
+ *  Interrupts the armed thread with its CU_WatchdogInterruptFunc
+ *  (internal, called from a CU_WatchdogExpiredFunc).
+ *  @return CU_FALSE if the watchdog is not armed or the platform
+ *          cannot interrupt threads, CU_TRUE otherwise.
+ */
+
+CU_EXPORT void CU_watchdog_stop(void);
+/**< Stops the watchdog thread at the end of a test run (internal). */
+
+#ifdef CUNIT_BUILD_TESTS
+void test_cunit_Timeout(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_TIMEOUT_H_SEEN  */
+/** @} */
@@ -36,6 +36,12 @@
  *                Fixed off-by-1 error in CU_translate_special_characters(),
  *                modifying implementation & results in some cases.  User can
  *                now tell if conversion failed. (JDS)
+ *
+ *  18-Oct-2026   Added CU_get_monotonic_time(). (AGT)
+ *
+ *  18-Oct-2026   Added CU_translate_to_buffer(), translation of quotes and
+ *                control characters documented.  CUNIT_MAX_ENTITY_LEN
+ *                raised to 8. (AGT)
  */
 
 /** @file
@@ -54,13 +60,15 @@
 extern "C" {
 #endif
 
-#define CUNIT_MAX_ENTITY_LEN 5
+#define CUNIT_MAX_ENTITY_LEN 8
 /**< Maximum number of characters in a translated xml entity. */
 
 CU_EXPORT size_t CU_translate_special_characters(const char *szSrc, char *szDest, size_t maxlen);
 /**<
  *  Converts special characters in szSrc to xml entity codes and stores
- *  result in szDest.  Currently conversion of '&', '<', and '>' is supported.
+ *  result in szDest.  '&', '<', '>', '"' and '\'' are converted to
+ *  entities.  Control characters other than tab, newline and carriage
+ *  return cannot appear in xml 1.0 and are replaced by "&#xFFFD;".
  *  Note that conversion to entities increases the length of the converted
  *  string.  The greatest conversion size increase would be a string
  *  consisting entirely of entity characters of converted length
@@ -95,6 +103,22 @@ CU_EXPORT size_t CU_translated_strlen(const char *szSrc);
  *  @return The number of characters szSrc will expand to when converted.
  */
 
+CU_EXPORT const char* CU_translate_to_buffer(const char *szSrc, char **pszBuffer, size_t *pLength);
+/**<
+ *  Converts special characters in szSrc to xml entity codes in a single
+ *  pass, as CU_translate_special_characters() does, into a buffer that
+ *  is grown as needed.  *pszBuffer and *pLength describe a buffer
+ *  allocated with CU_MALLOC() (initially NULL and 0) which the caller
+ *  reuses between calls and finally frees with CU_FREE().  No memory is
+ *  allocated once the buffer is large enough.
+ *
+ *  @param szSrc     Source string to convert (non-NULL).
+ *  @param pszBuffer Location of the buffer pointer (non-NULL).
+ *  @param pLength   Location of the buffer length (non-NULL).
+ *  @return The converted string (*pszBuffer), or NULL if the buffer
+ *          could not be grown.
+ */
+
 CU_EXPORT int CU_compare_strings(const char *szSrc, const char *szDest);
 /**<
  *  Case-insensitive string comparison.  Neither string pointer
@@ -129,6 +153,16 @@ CU_EXPORT size_t CU_number_width(int number);
  *  number in decimal.
  */
 
+CU_EXPORT double CU_get_monotonic_time(void);
+/**<
+ *  Retrieves the current value of a monotonic clock in seconds.
+ *  The origin is unspecified, so the value is only meaningful for
+ *  measuring intervals.  Falls back to clock() on platforms without
+ *  a monotonic clock.
+ *
+ *  @return Current monotonic time in seconds.
+ */
+
 #ifdef CUNIT_BUILD_TESTS
 void test_cunit_Util(void);
 #endif
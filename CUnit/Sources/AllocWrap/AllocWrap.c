@@ -0,0 +1,122 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Allocation function wrappers for per-test heap allocation accounting.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *
+ *  18-Oct-2026   Allocations can be made to fail for allocation failure
+ *                sweeps. (AGT)
+ */
+
+/** @file
+ *  Wrappers reporting malloc(), calloc(), realloc() and free() to CUnit.
+ *  Linked into a test program with the GNU linker options
+ *  <pre>
+ *    -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free -lcunitwrap -lcunit
+ *  </pre>
+ *  the linker resolves each call of e.g. malloc() in the objects and
+ *  static archives of the program (libcunit.a included) to
+ *  __wrap_malloc(), and __real_malloc() to the C library.  Calls from
+ *  shared libraries, including a shared libcunit, are not redirected.
+ *  See AllocTrack.h for the accounting itself, and AllocFail.h for
+ *  the allocation failure sweeps that make selected calls fail.
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#include <stdlib.h>
+#include <errno.h>
+
+#include "CUnit.h"
+#include "AllocTrack.h"
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t nmemb, size_t size);
+void* __wrap_realloc(void* ptr, size_t size);
+void  __wrap_free(void* ptr);
+
+/*------------------------------------------------------------------------*/
+void* __wrap_malloc(size_t size)
+{
+  void* pMem;
+
+  if (CU_FALSE != CU_alloc_should_fail(size)) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  pMem = __real_malloc(size);
+
+  CU_alloc_note_alloc(pMem, size, CU_ALLOC_MALLOC);
+  return pMem;
+}
+
+/*------------------------------------------------------------------------*/
+void* __wrap_calloc(size_t nmemb, size_t size)
+{
+  void* pMem;
+
+  if (CU_FALSE != CU_alloc_should_fail(nmemb * size)) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  pMem = __real_calloc(nmemb, size);
+
+  /* the product cannot overflow if calloc() succeeded */
+  CU_alloc_note_alloc(pMem, nmemb * size, CU_ALLOC_CALLOC);
+  return pMem;
+}
+
+/*------------------------------------------------------------------------*/
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  void* pMem;
+
+  /* realloc(ptr, 0) releases ptr and is not made to fail */
+  if (((NULL == ptr) || (0 != size)) && (CU_FALSE != CU_alloc_should_fail(size))) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  pMem = __real_realloc(ptr, size);
+
+  if (NULL != pMem) {
+    CU_alloc_note_realloc(ptr, pMem, size);
+  }
+  else if ((NULL != ptr) && (0 == size)) {
+    CU_alloc_note_free(ptr);      /* realloc(ptr, 0) may free ptr */
+  }
+  return pMem;
+}
+
+/*------------------------------------------------------------------------*/
+void __wrap_free(void* ptr)
+{
+  /* reported first, so the address cannot be reused before it is forgotten */
+  CU_alloc_note_free(ptr);
+  __real_free(ptr);
+}
+
+/** @} */
@@ -42,6 +42,13 @@
  *  07-May-2011   Added patch to fix broken xml tags dur to spacial characters in the test name.  (AK)
  *
  *  24-Jan-2019   Refactored and added common interface for different reports formats.  (PMi)
+ *
+ *  18-Oct-2026   Stopped unbuffering stdout and stderr; reports are completed
+ *                by fatal signal and atexit() handlers instead.  (AGT)
+ *
+ *  18-Oct-2026   Several report formats per run, attached as listeners.  (AGT)
+ *
+ *  18-Oct-2026   Aborted reports wait for queued listener events.  (AGT)
  */
 
 /** @file
@@ -51,6 +58,10 @@
  @{
 */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L   /* getpid(), SIGBUS under -std=c99 */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
@@ -58,6 +69,10 @@
 #include <string.h>
 #include <limits.h>
 #include <time.h>
+#include <signal.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "CUnit.h"
 #include "TestDB.h"
@@ -70,18 +85,47 @@
 /*=================================================================
  *  Global / Static data definitions
  *=================================================================*/
-static CU_pReportFormat_T pReport;                          /**< selected report formatter. */
+#define CU_AUTOMATED_ABORT_FLUSH_TIMEOUT 5.0
+/**< Seconds an aborted report waits for the listener event queue to drain. */
+
+static CU_pReportFormat_T f_apReports[CU_AUTOMATED_MAX_FORMATS];   /**< Attached report formatters. */
+static unsigned int       f_nReports = 0;                           /**< Number of entries in f_apReports. */
+static CU_BOOL            f_abReportOpen[CU_AUTOMATED_MAX_FORMATS]; /**< Flags for reports opened by the current run. */
+static CU_Listener        f_aReportListeners[CU_AUTOMATED_MAX_FORMATS]; /**< Listeners calling the handlers of each format. */
 
 
 static CU_BOOL   bJUnitXmlOutput = CU_FALSE;                /**< Flag for toggling the xml junit output or keeping the original. Off is the default */
 static char _gPackageName[50] = "";
 
+/** Signals after which the report is completed before the program ends. */
+static const int f_aiFatalSignals[] = {
+  SIGSEGV,
+  SIGFPE,
+  SIGILL,
+  SIGABRT,
+#ifdef SIGBUS
+  SIGBUS,
+#endif
+};
+#define N_FATAL_SIGNALS (sizeof(f_aiFatalSignals) / sizeof(f_aiFatalSignals[0]))
+
+static void (*f_apOldHandlers[N_FATAL_SIGNALS])(int);       /**< Handlers replaced during a run. */
+static volatile sig_atomic_t f_bReportOpen = 0;             /**< Flag for reports which pAbortReport must complete. */
+static CU_BOOL   f_bAtexitRegistered = CU_FALSE;            /**< Flag for registration of automated_at_exit(). */
+#ifndef _WIN32
+static pid_t     f_ReportPid = 0;                           /**< Process writing the report (not forked children). */
+#endif
+
 /*=================================================================
  *  Static function forward declarations
  *=================================================================*/
 static CU_ErrorCode automated_list_all_tests(CU_pTestRegistry pRegistry, const char* szFilename);
 
 static void automated_run_all_tests(CU_pTestRegistry pRegistry);
+static void automated_set_report_listener(CU_Listener* pListener, CU_pReportFormat_T pReportFormat);
+static void automated_abort_report(void);
+static void automated_at_exit(void);
+static void automated_fatal_signal(int iSignal);
 
 /*=================================================================
  *  Public Interface functions
@@ -90,36 +134,98 @@ static void automated_run_all_tests(CU_pTestRegistry pRegistry);
 void CU_automated_set_report_format(CU_pReportFormat_T pReportFormat)
 {
   assert(NULL != pReportFormat);
-  pReport = pReportFormat;
+  f_apReports[0] = pReportFormat;
+  f_nReports = 1;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_automated_add_report_format(CU_pReportFormat_T pReportFormat)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+  unsigned int i;
+
+  assert(NULL != pReportFormat);
+
+  for (i = 0 ; i < f_nReports ; ++i) {
+    if (pReportFormat == f_apReports[i]) {
+      break;
+    }
+  }
+
+  if (i == f_nReports) {
+    if (CU_AUTOMATED_MAX_FORMATS <= f_nReports) {
+      result = CUE_TOO_MANY_LISTENERS;
+    }
+    else {
+      f_apReports[f_nReports++] = pReportFormat;
+    }
+  }
+
+  CU_set_error(result);
+  return result;
 }
 
+/*------------------------------------------------------------------------*/
 void CU_automated_run_tests(void)
 {
+  unsigned int nOpen = 0;
+  unsigned int i;
+
   assert(NULL != CU_get_registry());
-  assert(NULL != pReport);
-  assert(NULL != pReport->pOpenReport);
-  assert(NULL != pReport->pCloseReport);
-
-  /* Ensure output makes it to screen at the moment of a SIGSEGV. */
-  setvbuf(stdout, NULL, _IONBF, 0);
-  setvbuf(stderr, NULL, _IONBF, 0);
-
- if (CUE_SUCCESS != pReport->pOpenReport()) {
-    fprintf(stderr, "\n%s", _("ERROR - Failed to create/initialize the result file."));
-  }
-  else {
-    /* set up the message handlers for writing xml output */
-    CU_set_test_start_handler(pReport->pTestStartMsgHandler);
-    CU_set_test_complete_handler(pReport->pTestCompleteMsgHandler);
-    CU_set_all_test_complete_handler(pReport->pAllTestsCompleteMsgHandler);
-    CU_set_suite_init_failure_handler(pReport->pSuiteInitFailureMsgHandler);
-    CU_set_suite_cleanup_failure_handler(pReport->pSuiteCleanupFailureMsgHandler);
-    CU_set_suite_complete_handler(pReport->pSuiteCompleteMsgHandler);
+  assert(0 < f_nReports);
+
+  for (i = 0 ; i < f_nReports ; ++i) {
+    assert(NULL != f_apReports[i]->pOpenReport);
+    assert(NULL != f_apReports[i]->pCloseReport);
+
+    f_abReportOpen[i] = CU_FALSE;
+    if (CUE_SUCCESS != f_apReports[i]->pOpenReport()) {
+      fprintf(stderr, "\n%s", _("ERROR - Failed to create/initialize the result file."));
+    }
+    else {
+      /* the handlers of the format write its xml output */
+      automated_set_report_listener(&f_aReportListeners[i], f_apReports[i]);
+      if (CUE_SUCCESS != CU_add_listener(&f_aReportListeners[i], f_apReports[i])) {
+        fprintf(stderr, "\n%s", _("ERROR - Failed to create/initialize the result file."));
+        f_apReports[i]->pCloseReport();
+      }
+      else {
+        f_abReportOpen[i] = CU_TRUE;
+        ++nOpen;
+      }
+    }
+  }
+
+  if (0 < nOpen) {
+    /* complete the reports and flush output if a test crashes or exits */
+#ifndef _WIN32
+    f_ReportPid = getpid();
+#endif
+    f_bReportOpen = 1;
+    if (CU_FALSE == f_bAtexitRegistered) {
+      f_bAtexitRegistered = (0 == atexit(automated_at_exit)) ? CU_TRUE : CU_FALSE;
+    }
+    for (i = 0 ; i < N_FATAL_SIGNALS ; ++i) {
+      f_apOldHandlers[i] = signal(f_aiFatalSignals[i], automated_fatal_signal);
+    }
 
     automated_run_all_tests(NULL);
 
-    if (CUE_SUCCESS != pReport->pCloseReport()) {
-      fprintf(stderr, "\n%s", _("ERROR - Failed to close/uninitialize the result files."));
+    for (i = 0 ; i < N_FATAL_SIGNALS ; ++i) {
+      if (SIG_ERR != f_apOldHandlers[i]) {
+        signal(f_aiFatalSignals[i], f_apOldHandlers[i]);
+      }
+    }
+    f_bReportOpen = 0;
+
+    for (i = 0 ; i < f_nReports ; ++i) {
+      if (CU_FALSE != f_abReportOpen[i]) {
+        f_abReportOpen[i] = CU_FALSE;
+        CU_remove_listener(&f_aReportListeners[i], f_apReports[i]);
+        if (CUE_SUCCESS != f_apReports[i]->pCloseReport()) {
+          fprintf(stderr, "\n%s", _("ERROR - Failed to close/uninitialize the result files."));
+        }
+      }
     }
   }
 }
@@ -127,24 +233,34 @@ void CU_automated_run_tests(void)
 /*------------------------------------------------------------------------*/
 void CU_set_output_filename(const char* szFilenameRoot)
 {
-  assert(NULL != pReport);
-  assert(NULL != pReport->pSetOutputFilename);
+  unsigned int i;
 
-  pReport->pSetOutputFilename(szFilenameRoot);
+  assert(0 < f_nReports);
+
+  for (i = 0 ; i < f_nReports ; ++i) {
+    assert(NULL != f_apReports[i]->pSetOutputFilename);
+    f_apReports[i]->pSetOutputFilename(szFilenameRoot);
+  }
 }
 
 /*------------------------------------------------------------------------*/
 CU_ErrorCode CU_list_tests_to_file()
 {
-  assert(pReport);
+  CU_ErrorCode result = CUE_SUCCESS;
+  CU_ErrorCode result2;
+  unsigned int i;
+
+  assert(0 < f_nReports);
 
-  if (pReport->pListAllTests != NULL)
-  {
-    return pReport->pListAllTests(CU_get_registry());
+  /* Silently skip formats which do not support the feature */
+  for (i = 0 ; i < f_nReports ; ++i) {
+    if (f_apReports[i]->pListAllTests != NULL) {
+      result2 = f_apReports[i]->pListAllTests(CU_get_registry());
+      result = (CUE_SUCCESS == result) ? result2 : result;
+    }
   }
 
-  /* Silently exit if Report Format does not support feature */
-  return 0;
+  return result;
 }
 
 /*=================================================================
@@ -172,6 +288,120 @@ static void automated_run_all_tests(CU_pTestRegistry pRegistry)
   }
 }
 
+/*------------------------------------------------------------------------*/
+/*  Listener callbacks calling the handlers of the report format passed
+ *  as context.
+ *------------------------------------------------------------------------*/
+static void automated_test_start(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite)
+{
+  ((CU_pReportFormat_T)pContext)->pTestStartMsgHandler(pTest, pSuite);
+}
+
+static void automated_test_complete(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite,
+                                    const CU_pFailureRecord pFailure)
+{
+  ((CU_pReportFormat_T)pContext)->pTestCompleteMsgHandler(pTest, pSuite, pFailure);
+}
+
+static void automated_all_tests_complete(void* pContext, const CU_pFailureRecord pFailure)
+{
+  ((CU_pReportFormat_T)pContext)->pAllTestsCompleteMsgHandler(pFailure);
+}
+
+static void automated_suite_init_failure(void* pContext, const CU_pSuite pSuite)
+{
+  ((CU_pReportFormat_T)pContext)->pSuiteInitFailureMsgHandler(pSuite);
+}
+
+static void automated_suite_cleanup_failure(void* pContext, const CU_pSuite pSuite)
+{
+  ((CU_pReportFormat_T)pContext)->pSuiteCleanupFailureMsgHandler(pSuite);
+}
+
+static void automated_suite_complete(void* pContext, const CU_pSuite pSuite,
+                                     const CU_pFailureRecord pFailure)
+{
+  ((CU_pReportFormat_T)pContext)->pSuiteCompleteMsgHandler(pSuite, pFailure);
+}
+
+/*------------------------------------------------------------------------*/
+/** Sets up a listener calling the non-NULL handlers of a report format.
+ *  @param pListener     The listener to set up (non-NULL).
+ *  @param pReportFormat The format, passed as the listener context (non-NULL).
+ */
+static void automated_set_report_listener(CU_Listener* pListener, CU_pReportFormat_T pReportFormat)
+{
+  memset(pListener, 0, sizeof(CU_Listener));
+  if (NULL != pReportFormat->pTestStartMsgHandler) {
+    pListener->pTestStart = automated_test_start;
+  }
+  if (NULL != pReportFormat->pTestCompleteMsgHandler) {
+    pListener->pTestComplete = automated_test_complete;
+  }
+  if (NULL != pReportFormat->pAllTestsCompleteMsgHandler) {
+    pListener->pAllTestsComplete = automated_all_tests_complete;
+  }
+  if (NULL != pReportFormat->pSuiteInitFailureMsgHandler) {
+    pListener->pSuiteInitFailure = automated_suite_init_failure;
+  }
+  if (NULL != pReportFormat->pSuiteCleanupFailureMsgHandler) {
+    pListener->pSuiteCleanupFailure = automated_suite_cleanup_failure;
+  }
+  if (NULL != pReportFormat->pSuiteCompleteMsgHandler) {
+    pListener->pSuiteComplete = automated_suite_complete;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Completes the open reports with pAbortReport and flushes stdout and
+ *  stderr, after waiting for queued listener events to be written.
+ *  Does nothing in a child process forked by a test (e.g. for
+ *  allocation failure sweeps), which shares the report file.
+ */
+static void automated_abort_report(void)
+{
+  unsigned int i;
+
+#ifndef _WIN32
+  if (getpid() != f_ReportPid) {
+    return;
+  }
+#endif
+  if (0 != f_bReportOpen) {
+    f_bReportOpen = 0;
+    /* let the event writer deliver the events queued before the abort */
+    CU_flush_listener_events(CU_AUTOMATED_ABORT_FLUSH_TIMEOUT);
+    for (i = 0 ; i < f_nReports ; ++i) {
+      if ((CU_FALSE != f_abReportOpen[i]) && (NULL != f_apReports[i]->pAbortReport)) {
+        f_apReports[i]->pAbortReport();
+      }
+    }
+  }
+  fflush(stdout);
+  fflush(stderr);
+}
+
+/*------------------------------------------------------------------------*/
+/** atexit() handler completing a report left open by exit() in a test. */
+static void automated_at_exit(void)
+{
+  if (0 != f_bReportOpen) {
+    automated_abort_report();
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler for fatal signals during a run.  Completes the report, then
+ *  restores the default action and raises the signal again.
+ *  @param iSignal The signal received.
+ */
+static void automated_fatal_signal(int iSignal)
+{
+  automated_abort_report();
+  signal(iSignal, SIG_DFL);
+  raise(iSignal);
+}
+
 /*------------------------------------------------------------------------*/
 /** Set tests suites package name
  */
@@ -0,0 +1,508 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Reader for binary result streams.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *
+ *  18-Oct-2026   Read the number of crashed tests from run end records. (AGT)
+ */
+
+/** @file
+ *  Reader for binary result streams (implementation).
+ */
+/** @addtogroup Automated
+ @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "BinaryResults.h"
+
+#define READ_CHUNK          8192        /**< Bytes read from the file at a time. */
+#define MAX_RECORD_LENGTH   0x10000000UL /**< Longer records are taken as corruption. */
+
+/** Reader state. */
+struct CU_BinaryReader
+{
+  FILE*             pFile;          /**< File being read. */
+  CU_BOOL           bStdin;         /**< Flag for pFile being stdin. */
+  unsigned char*    pBuffer;        /**< Bytes read but not yet consumed. */
+  size_t            szStart;        /**< Position of the first unconsumed byte in pBuffer. */
+  size_t            szEnd;          /**< Position after the last byte read into pBuffer. */
+  size_t            szCapacity;     /**< Allocated length of pBuffer. */
+  unsigned long     ulOffset;       /**< Bytes consumed from the stream. */
+  CU_BOOL           bHeaderRead;    /**< Flag for the stream header having been checked. */
+  CU_BOOL           bComplete;      /**< Flag for the last record ending the stream. */
+  CU_ErrorCode      error;          /**< Error which stopped reading, or CUE_SUCCESS. */
+  char**            pStrings;       /**< Strings read, pStrings[0] for string 1. */
+  unsigned long     nStrings;       /**< Number of strings read. */
+  unsigned long     nStringCapacity; /**< Allocated entries of pStrings. */
+  CU_BinaryTest*    pTests;         /**< Test list of the last record. */
+  unsigned int      nTestCapacity;  /**< Allocated entries of pTests. */
+  CU_BinaryFailure* pFailures;      /**< Failures of the last record. */
+  unsigned int      nFailureCapacity; /**< Allocated entries of pFailures. */
+};
+
+/** Position in the payload of a record being decoded. */
+typedef struct Cursor
+{
+  const unsigned char* pPos;        /**< Next byte. */
+  const unsigned char* pEnd;        /**< End of the record. */
+  CU_BOOL              bBad;        /**< Flag set on a decoding error. */
+} Cursor;
+
+/*=================================================================
+ *  Static function implementation
+ *=================================================================*/
+/** Makes szBytes unconsumed bytes available in the buffer if the file
+ *  holds them.
+ *  @return CU_TRUE if the bytes are available.
+ */
+static CU_BOOL fill(CU_pBinaryReader pReader, size_t szBytes)
+{
+  unsigned char* pNew;
+  size_t szNewCapacity;
+  size_t szRead;
+
+  while (pReader->szEnd - pReader->szStart < szBytes) {
+    if (pReader->szStart > 0) {
+      memmove(pReader->pBuffer, pReader->pBuffer + pReader->szStart, pReader->szEnd - pReader->szStart);
+      pReader->szEnd -= pReader->szStart;
+      pReader->szStart = 0;
+    }
+    if (pReader->szCapacity < szBytes + READ_CHUNK) {
+      szNewCapacity = szBytes + READ_CHUNK;
+      pNew = (unsigned char*)CU_REALLOC(pReader->pBuffer, szNewCapacity);
+      if (NULL == pNew) {
+        pReader->error = CUE_NOMEMORY;
+        return CU_FALSE;
+      }
+      pReader->pBuffer = pNew;
+      pReader->szCapacity = szNewCapacity;
+    }
+    szRead = fread(pReader->pBuffer + pReader->szEnd, 1, pReader->szCapacity - pReader->szEnd, pReader->pFile);
+    pReader->szEnd += szRead;
+    if (0 == szRead) {
+      if (0 != ferror(pReader->pFile)) {
+        pReader->error = CUE_READ_ERROR;
+      }
+      /* clear EOF so that data appended later can be read */
+      clearerr(pReader->pFile);
+      return CU_FALSE;
+    }
+  }
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes a varint from a cursor. */
+static unsigned long long get_varint(Cursor* pCursor)
+{
+  unsigned long long ullValue = 0;
+  unsigned int uiShift = 0;
+  unsigned char ucByte;
+
+  do {
+    if ((pCursor->pPos >= pCursor->pEnd) || (uiShift > 63)) {
+      pCursor->bBad = CU_TRUE;
+      return 0;
+    }
+    ucByte = *pCursor->pPos++;
+    ullValue |= (unsigned long long)(ucByte & 0x7F) << uiShift;
+    uiShift += 7;
+  } while (0 != (ucByte & 0x80));
+
+  return ullValue;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes a varint which must fit an unsigned int. */
+static unsigned int get_uint(Cursor* pCursor)
+{
+  unsigned long long ullValue = get_varint(pCursor);
+
+  if (ullValue > 0xFFFFFFFFULL) {
+    pCursor->bBad = CU_TRUE;
+  }
+  return (unsigned int)ullValue;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes a duration, returning seconds. */
+static double get_duration(Cursor* pCursor)
+{
+  return (double)get_varint(pCursor) / 1e9;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes a string number and resolves it. */
+static const char* get_string(CU_pBinaryReader pReader, Cursor* pCursor)
+{
+  unsigned long long ullId = get_varint(pCursor);
+
+  if (0 == ullId) {
+    return NULL;
+  }
+  if (ullId > pReader->nStrings) {
+    pCursor->bBad = CU_TRUE;
+    return NULL;
+  }
+  return pReader->pStrings[ullId - 1];
+}
+
+/*------------------------------------------------------------------------*/
+/** Stores the payload of a string record.
+ *  @return CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL add_string(CU_pBinaryReader pReader, const Cursor* pCursor)
+{
+  size_t szLength = (size_t)(pCursor->pEnd - pCursor->pPos);
+  char** pNew;
+  char* szString;
+
+  if (pReader->nStrings == pReader->nStringCapacity) {
+    pNew = (char**)CU_REALLOC(pReader->pStrings, 2 * (pReader->nStringCapacity + 64) * sizeof(char*));
+    if (NULL == pNew) {
+      return CU_FALSE;
+    }
+    pReader->pStrings = pNew;
+    pReader->nStringCapacity = 2 * (pReader->nStringCapacity + 64);
+  }
+  szString = (char*)CU_MALLOC(szLength + 1);
+  if (NULL == szString) {
+    return CU_FALSE;
+  }
+  memcpy(szString, pCursor->pPos, szLength);
+  szString[szLength] = '\0';
+  pReader->pStrings[pReader->nStrings++] = szString;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes a list of failures into the failure array of the reader.
+ *  @return CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL get_failures(CU_pBinaryReader pReader, Cursor* pCursor, CU_BinaryRecord* pRecord)
+{
+  unsigned int nFailures = get_uint(pCursor);
+  CU_BinaryFailure* pNew;
+  CU_BinaryFailure* pFailure;
+  unsigned int i;
+
+  /* each failure takes at least 4 bytes */
+  if ((CU_TRUE == pCursor->bBad) || (nFailures > (size_t)(pCursor->pEnd - pCursor->pPos) / 4)) {
+    pCursor->bBad = CU_TRUE;
+    return CU_TRUE;
+  }
+  if (nFailures > pReader->nFailureCapacity) {
+    pNew = (CU_BinaryFailure*)CU_REALLOC(pReader->pFailures, nFailures * sizeof(CU_BinaryFailure));
+    if (NULL == pNew) {
+      return CU_FALSE;
+    }
+    pReader->pFailures = pNew;
+    pReader->nFailureCapacity = nFailures;
+  }
+  for (i = 0 ; i < nFailures ; ++i) {
+    pFailure = &pReader->pFailures[i];
+    pFailure->type = (CU_FailureType)get_uint(pCursor);
+    pFailure->uiLineNumber = get_uint(pCursor);
+    pFailure->szFileName = get_string(pReader, pCursor);
+    pFailure->szCondition = get_string(pReader, pCursor);
+  }
+  pRecord->nFailures = nFailures;
+  pRecord->pFailures = pReader->pFailures;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes the test list of a suite end record.
+ *  @return CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL get_tests(CU_pBinaryReader pReader, Cursor* pCursor, CU_BinaryRecord* pRecord)
+{
+  unsigned int nTests = get_uint(pCursor);
+  CU_BinaryTest* pNew;
+  unsigned int i;
+
+  /* each test takes at least 2 bytes */
+  if ((CU_TRUE == pCursor->bBad) || (nTests > (size_t)(pCursor->pEnd - pCursor->pPos) / 2)) {
+    pCursor->bBad = CU_TRUE;
+    return CU_TRUE;
+  }
+  if (nTests > pReader->nTestCapacity) {
+    pNew = (CU_BinaryTest*)CU_REALLOC(pReader->pTests, nTests * sizeof(CU_BinaryTest));
+    if (NULL == pNew) {
+      return CU_FALSE;
+    }
+    pReader->pTests = pNew;
+    pReader->nTestCapacity = nTests;
+  }
+  for (i = 0 ; i < nTests ; ++i) {
+    pReader->pTests[i].szName = get_string(pReader, pCursor);
+    pReader->pTests[i].dDuration = get_duration(pCursor);
+  }
+  pRecord->nTests = nTests;
+  pRecord->pTests = pReader->pTests;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes the payload of a record other than a string record.
+ *  @return CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL decode_record(CU_pBinaryReader pReader, Cursor* pCursor, CU_BinaryRecord* pRecord)
+{
+  CU_RunSummary* pSummary = &pRecord->summary;
+
+  switch (pRecord->type) {
+    case CU_BINARY_RUN_START:
+      pRecord->tTime = (time_t)get_varint(pCursor);
+      pRecord->szPackage = get_string(pReader, pCursor);
+      break;
+
+    case CU_BINARY_TEST_START:
+      pRecord->szSuite = get_string(pReader, pCursor);
+      pRecord->szTest = get_string(pReader, pCursor);
+      break;
+
+    case CU_BINARY_TEST_END:
+      pRecord->szSuite = get_string(pReader, pCursor);
+      pRecord->szTest = get_string(pReader, pCursor);
+      pRecord->dDuration = get_duration(pCursor);
+      return get_failures(pReader, pCursor, pRecord);
+
+    case CU_BINARY_SUITE_INIT_FAILURE:
+    case CU_BINARY_SUITE_CLEANUP_FAILURE:
+      pRecord->szSuite = get_string(pReader, pCursor);
+      break;
+
+    case CU_BINARY_SUITE_END:
+      pRecord->szSuite = get_string(pReader, pCursor);
+      pRecord->uiTestsFailed = get_uint(pCursor);
+      pRecord->uiFailureRecords = get_uint(pCursor);
+      if (CU_FALSE == get_tests(pReader, pCursor, pRecord)) {
+        return CU_FALSE;
+      }
+      return get_failures(pReader, pCursor, pRecord);
+
+    case CU_BINARY_RUN_END:
+      pRecord->tTime = (time_t)get_varint(pCursor);
+      pRecord->uiSuitesRegistered = get_uint(pCursor);
+      pRecord->uiTestsRegistered = get_uint(pCursor);
+      pSummary->nSuitesRun = get_uint(pCursor);
+      pSummary->nSuitesFailed = get_uint(pCursor);
+      pSummary->nSuitesInactive = get_uint(pCursor);
+      pSummary->nTestsRun = get_uint(pCursor);
+      pSummary->nTestsFailed = get_uint(pCursor);
+      pSummary->nTestsInactive = get_uint(pCursor);
+      pSummary->nAsserts = get_uint(pCursor);
+      pSummary->nAssertsFailed = get_uint(pCursor);
+      pSummary->nFailureRecords = get_uint(pCursor);
+      pSummary->ElapsedTime = get_duration(pCursor);
+      /* missing in streams of older writers */
+      if (pCursor->pPos < pCursor->pEnd) {
+        pSummary->nTestsCrashed = get_uint(pCursor);
+      }
+      break;
+
+    case CU_BINARY_ABORT:
+    default:
+      break;
+  }
+  return CU_TRUE;
+}
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_pBinaryReader CU_binary_reader_open(const char* szFilename)
+{
+  CU_pBinaryReader pReader;
+
+  assert(NULL != szFilename);
+
+  pReader = (CU_pBinaryReader)CU_CALLOC(1, sizeof(CU_BinaryReader));
+  if (NULL == pReader) {
+    CU_set_error(CUE_NOMEMORY);
+    return NULL;
+  }
+
+  if (0 == strcmp(szFilename, "-")) {
+    pReader->pFile = stdin;
+    pReader->bStdin = CU_TRUE;
+  }
+  else if (NULL == (pReader->pFile = fopen(szFilename, "rb"))) {
+    CU_FREE(pReader);
+    CU_set_error(CUE_FOPEN_FAILED);
+    return NULL;
+  }
+
+  pReader->error = CUE_SUCCESS;
+  CU_set_error(CUE_SUCCESS);
+  return pReader;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_binary_reader_close(CU_pBinaryReader pReader)
+{
+  unsigned long i;
+
+  if (NULL == pReader) {
+    return;
+  }
+  if (CU_FALSE == pReader->bStdin) {
+    fclose(pReader->pFile);
+  }
+  for (i = 0 ; i < pReader->nStrings ; ++i) {
+    CU_FREE(pReader->pStrings[i]);
+  }
+  if (NULL != pReader->pStrings) {
+    CU_FREE(pReader->pStrings);
+  }
+  if (NULL != pReader->pTests) {
+    CU_FREE(pReader->pTests);
+  }
+  if (NULL != pReader->pFailures) {
+    CU_FREE(pReader->pFailures);
+  }
+  if (NULL != pReader->pBuffer) {
+    CU_FREE(pReader->pBuffer);
+  }
+  CU_FREE(pReader);
+}
+
+/*------------------------------------------------------------------------*/
+CU_BinaryStatus CU_binary_reader_next(CU_pBinaryReader pReader, CU_BinaryRecord* pRecord)
+{
+  unsigned long long ullLength;
+  size_t szPrefix;
+  Cursor cursor;
+
+  assert(NULL != pReader);
+  assert(NULL != pRecord);
+
+  for (;;) {
+    if (CUE_SUCCESS != pReader->error) {
+      CU_set_error(pReader->error);
+      return CU_BINARY_ERROR;
+    }
+
+    if (CU_FALSE == pReader->bHeaderRead) {
+      if (CU_FALSE == fill(pReader, CU_BINARY_MAGIC_LENGTH)) {
+        if (CUE_SUCCESS != pReader->error) {
+          continue;
+        }
+        return CU_BINARY_END;
+      }
+      if (0 != memcmp(pReader->pBuffer + pReader->szStart, CU_BINARY_MAGIC, CU_BINARY_MAGIC_LENGTH)) {
+        pReader->error = CUE_BAD_FILE_FORMAT;
+        continue;
+      }
+      pReader->szStart += CU_BINARY_MAGIC_LENGTH;
+      pReader->ulOffset += CU_BINARY_MAGIC_LENGTH;
+      pReader->bHeaderRead = CU_TRUE;
+    }
+
+    /* record length */
+    cursor.bBad = CU_FALSE;
+    cursor.pPos = pReader->pBuffer + pReader->szStart;
+    cursor.pEnd = pReader->pBuffer + pReader->szEnd;
+    ullLength = get_varint(&cursor);
+    if (CU_TRUE == cursor.bBad) {
+      /* overlong or incomplete length prefix */
+      if (pReader->szEnd - pReader->szStart >= 10) {
+        pReader->error = CUE_BAD_FILE_FORMAT;
+      }
+      else if ((CU_FALSE == fill(pReader, pReader->szEnd - pReader->szStart + 1)) &&
+               (CUE_SUCCESS == pReader->error)) {
+        return CU_BINARY_END;
+      }
+      continue;
+    }
+    if ((0 == ullLength) || (ullLength > MAX_RECORD_LENGTH)) {
+      pReader->error = CUE_BAD_FILE_FORMAT;
+      continue;
+    }
+    szPrefix = (size_t)(cursor.pPos - (pReader->pBuffer + pReader->szStart));
+
+    /* record body */
+    if (CU_FALSE == fill(pReader, szPrefix + (size_t)ullLength)) {
+      if (CUE_SUCCESS != pReader->error) {
+        continue;
+      }
+      return CU_BINARY_END;
+    }
+    cursor.pPos = pReader->pBuffer + pReader->szStart + szPrefix;
+    cursor.pEnd = cursor.pPos + (size_t)ullLength;
+
+    memset(pRecord, 0, sizeof(CU_BinaryRecord));
+    pRecord->type = (CU_BinaryRecordType)get_varint(&cursor);
+
+    if (CU_BINARY_STRING == pRecord->type) {
+      if (CU_FALSE == add_string(pReader, &cursor)) {
+        pReader->error = CUE_NOMEMORY;
+        continue;
+      }
+    }
+    else if ((pRecord->type > CU_BINARY_STRING) && (pRecord->type <= CU_BINARY_ABORT)) {
+      if (CU_FALSE == decode_record(pReader, &cursor, pRecord)) {
+        pReader->error = CUE_NOMEMORY;
+        continue;
+      }
+      if (CU_TRUE == cursor.bBad) {
+        pReader->error = CUE_BAD_FILE_FORMAT;
+        continue;
+      }
+    }
+
+    pReader->szStart += szPrefix + (size_t)ullLength;
+    pReader->ulOffset += (unsigned long)(szPrefix + (size_t)ullLength);
+
+    if ((pRecord->type > CU_BINARY_STRING) && (pRecord->type <= CU_BINARY_ABORT)) {
+      pReader->bComplete = ((CU_BINARY_RUN_END == pRecord->type) || (CU_BINARY_ABORT == pRecord->type))
+                         ? CU_TRUE : CU_FALSE;
+      CU_set_error(CUE_SUCCESS);
+      return CU_BINARY_OK;
+    }
+    /* string records and record types added by later versions are skipped */
+  }
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_binary_reader_is_complete(CU_pBinaryReader pReader)
+{
+  assert(NULL != pReader);
+  return pReader->bComplete;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned long CU_binary_reader_offset(CU_pBinaryReader pReader)
+{
+  assert(NULL != pReader);
+  return pReader->ulOffset;
+}
+
+/** @} */
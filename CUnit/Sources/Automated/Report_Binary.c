@@ -0,0 +1,562 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+ /*
+  *  Implementation of the Binary Report Format
+  *
+  *  18-Oct-2026      Initial implementation. (AGT)
+  *
+  *  18-Oct-2026      Tests of other shards left out of suite records. (AGT)
+  *
+  *  18-Oct-2026      Tests not run after a fail-fast stop left out of
+  *                   suite records. (AGT)
+  *
+  *  18-Oct-2026      Run end record carries the number of crashed tests. (AGT)
+  *
+  */
+
+  /** @file
+   * Automated test interface with binary result output (implementation).
+   */
+   /** @addtogroup Automated
+    @{
+   */
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "Util.h"
+#include "Report_Binary.h"
+
+#define MAX_FILENAME_LENGTH   1025
+
+#define MIN_STRING_SLOTS      256   /**< Initial size of the string table (power of 2). */
+
+/*=================================================================
+*  Global / Static data definitions
+*=================================================================*/
+
+CU_reportFormat_T CU_reportFormat_Binary =
+{
+  CU_report_Binary_set_output_filename,                 /* pSetOutputFilename */
+  CU_report_Binary_open_report,                         /* pOpenReport */
+  CU_report_Binary_close_report,                        /* pCloseReport */
+  CU_report_Binary_test_start_msg_handler,              /* pTestStartMsgHandler */
+  CU_report_Binary_test_complete_msg_handler,           /* pTestCompleteMsgHandler */
+  CU_report_Binary_all_tests_complete_msg_handler,      /* pAllTestsCompleteMsgHandler */
+  CU_report_Binary_suite_init_failure_msg_handler,      /* pSuiteInitFailureMsgHandler */
+  CU_report_Binary_suite_cleanup_failure_msg_handler,   /* pSuiteCleanupFailureMsgHandler */
+  CU_report_Binary_suite_complete_msg_handler,          /* pSuiteCompleteMsgHandler */
+  NULL,                                                 /* pListAllTests - not supported by binary format */
+  CU_report_Binary_abort_report                         /* pAbortReport */
+};
+
+/** Entry of the table of strings written to the stream. */
+typedef struct StringEntry
+{
+  unsigned long ulHash;     /**< Hash of the string. */
+  unsigned long ulId;       /**< Number of the string record (0 for a free slot). */
+  char*         szString;   /**< Copy of the string. */
+} StringEntry;
+
+static char           f_szDefaultFileRoot[] = "CUnitAutomated";  /**< Default filename root for automated output files. */
+static char           f_szTestResultFileName[MAX_FILENAME_LENGTH] = ""; /**< Current output file name for the test results file. */
+static FILE*          f_pTestResultFile = NULL;   /**< FILE pointer the test results file. */
+static CU_BOOL        f_bRunEnded = CU_FALSE;     /**< Flag set once the run end record is written. */
+
+static unsigned char* f_pRecord = NULL;           /**< Buffer of the record being encoded. */
+static size_t         f_szRecordLen = 0;          /**< Bytes used in f_pRecord. */
+static size_t         f_szRecordCap = 0;          /**< Allocated length of f_pRecord. */
+static CU_BOOL        f_bRecordFailed = CU_FALSE; /**< Flag set if f_pRecord could not be grown. */
+
+static StringEntry*   f_pStrings = NULL;          /**< Open addressing table of strings written. */
+static unsigned long  f_ulStringSlots = 0;        /**< Number of slots in f_pStrings. */
+static unsigned long  f_ulStrings = 0;            /**< Number of string records written. */
+
+/*=================================================================
+ *  Static function implementation
+ *=================================================================*/
+/** Makes room for szBytes more bytes in the record buffer.
+ *  @return CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL reserve_record(size_t szBytes)
+{
+  unsigned char* pNew;
+  size_t szNewCap;
+
+  if (f_szRecordLen + szBytes <= f_szRecordCap) {
+    return CU_TRUE;
+  }
+  szNewCap = (0 == f_szRecordCap) ? 1024 : f_szRecordCap;
+  while (szNewCap < f_szRecordLen + szBytes) {
+    szNewCap *= 2;
+  }
+  pNew = (unsigned char*)CU_REALLOC(f_pRecord, szNewCap);
+  if (NULL == pNew) {
+    f_bRecordFailed = CU_TRUE;
+    return CU_FALSE;
+  }
+  f_pRecord = pNew;
+  f_szRecordCap = szNewCap;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Appends an unsigned varint to the record buffer. */
+static void put_varint(unsigned long long ullValue)
+{
+  if (CU_FALSE == reserve_record(10)) {
+    return;
+  }
+  while (ullValue >= 0x80) {
+    f_pRecord[f_szRecordLen++] = (unsigned char)(ullValue | 0x80);
+    ullValue >>= 7;
+  }
+  f_pRecord[f_szRecordLen++] = (unsigned char)ullValue;
+}
+
+/*------------------------------------------------------------------------*/
+/** Appends a duration in seconds to the record buffer, in nanoseconds. */
+static void put_duration(double dSeconds)
+{
+  put_varint((dSeconds > 0.0) ? (unsigned long long)(dSeconds * 1e9 + 0.5) : 0);
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a varint directly to the results file. */
+static void write_varint(unsigned long long ullValue)
+{
+  while (ullValue >= 0x80) {
+    putc((int)((ullValue | 0x80) & 0xFF), f_pTestResultFile);
+    ullValue >>= 7;
+  }
+  putc((int)ullValue, f_pTestResultFile);
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a string record to the results file.
+ *  @return The number of the string.
+ */
+static unsigned long write_string(const char* szString, size_t szLength)
+{
+  write_varint(szLength + 1);
+  putc(CU_BINARY_STRING, f_pTestResultFile);
+  fwrite(szString, 1, szLength, f_pTestResultFile);
+  return ++f_ulStrings;
+}
+
+/*------------------------------------------------------------------------*/
+/** Doubles the size of the string table (or creates it).
+ *  @return CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL grow_strings(void)
+{
+  StringEntry* pNew;
+  unsigned long ulNewSlots = (0 == f_ulStringSlots) ? MIN_STRING_SLOTS : 2 * f_ulStringSlots;
+  unsigned long i;
+  unsigned long j;
+
+  pNew = (StringEntry*)CU_CALLOC(ulNewSlots, sizeof(StringEntry));
+  if (NULL == pNew) {
+    return CU_FALSE;
+  }
+  for (i = 0 ; i < f_ulStringSlots ; ++i) {
+    if (0 != f_pStrings[i].ulId) {
+      for (j = f_pStrings[i].ulHash & (ulNewSlots - 1) ; 0 != pNew[j].ulId ; j = (j + 1) & (ulNewSlots - 1)) {
+      }
+      pNew[j] = f_pStrings[i];
+    }
+  }
+  if (NULL != f_pStrings) {
+    CU_FREE(f_pStrings);
+  }
+  f_pStrings = pNew;
+  f_ulStringSlots = ulNewSlots;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Frees the string table. */
+static void free_strings(void)
+{
+  unsigned long i;
+
+  for (i = 0 ; i < f_ulStringSlots ; ++i) {
+    if (NULL != f_pStrings[i].szString) {
+      CU_FREE(f_pStrings[i].szString);
+    }
+  }
+  if (NULL != f_pStrings) {
+    CU_FREE(f_pStrings);
+  }
+  f_pStrings = NULL;
+  f_ulStringSlots = 0;
+  f_ulStrings = 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Retrieves the number of a string, writing a string record the first
+ *  time the string is seen.  If memory runs out, strings are written
+ *  again instead of being looked up.
+ *  @param szString The string (NULL gives 0).
+ *  @return The number of the string.
+ */
+static unsigned long intern_string(const char* szString)
+{
+  unsigned long ulHash = 2166136261UL;
+  size_t szLength;
+  unsigned long i;
+  char* szCopy;
+
+  if (NULL == szString) {
+    return 0;
+  }
+
+  /* FNV-1a */
+  for (szLength = 0 ; '\0' != szString[szLength] ; ++szLength) {
+    ulHash = ((ulHash ^ (unsigned char)szString[szLength]) * 16777619UL) & 0xFFFFFFFFUL;
+  }
+
+  if ((2 * (f_ulStrings + 1) > f_ulStringSlots) && (CU_FALSE == grow_strings())) {
+    return write_string(szString, szLength);
+  }
+
+  for (i = ulHash & (f_ulStringSlots - 1) ; 0 != f_pStrings[i].ulId ; i = (i + 1) & (f_ulStringSlots - 1)) {
+    if ((ulHash == f_pStrings[i].ulHash) && (0 == strcmp(szString, f_pStrings[i].szString))) {
+      return f_pStrings[i].ulId;
+    }
+  }
+
+  szCopy = (char*)CU_MALLOC(szLength + 1);
+  if (NULL == szCopy) {
+    return write_string(szString, szLength);
+  }
+  memcpy(szCopy, szString, szLength + 1);
+  f_pStrings[i].ulHash = ulHash;
+  f_pStrings[i].szString = szCopy;
+  f_pStrings[i].ulId = write_string(szString, szLength);
+  return f_pStrings[i].ulId;
+}
+
+/*------------------------------------------------------------------------*/
+/** Starts encoding a record of the given type. */
+static void begin_record(CU_BinaryRecordType type)
+{
+  f_szRecordLen = 0;
+  f_bRecordFailed = CU_FALSE;
+  put_varint((unsigned long long)type);
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes the encoded record to the results file.  A record which could
+ *  not be encoded completely is dropped.
+ */
+static void end_record(void)
+{
+  if (CU_FALSE == f_bRecordFailed) {
+    write_varint(f_szRecordLen);
+    fwrite(f_pRecord, 1, f_szRecordLen, f_pTestResultFile);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Appends a failure to the record buffer.
+ *  @param pFailure The failure (non-NULL).
+ */
+static void put_failure(const CU_FailureRecord* pFailure)
+{
+  put_varint((unsigned long long)pFailure->type);
+  put_varint(pFailure->uiLineNumber);
+  put_varint(intern_string(pFailure->strFileName));
+  put_varint(intern_string(pFailure->strCondition));
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a record holding only the name of a suite. */
+static void write_suite_record(CU_BinaryRecordType type, const CU_pSuite pSuite)
+{
+  begin_record(type);
+  put_varint(intern_string(pSuite->pName));
+  end_record();
+}
+
+/*=================================================================
+*  Public Interface functions
+*=================================================================*/
+
+void CU_report_Binary_set_output_filename(const char* szFilename)
+{
+  const char* szResultEnding = "-Results.cubr";
+
+  /* Construct the name for the result file */
+  if (NULL != szFilename) {
+    strncpy(f_szTestResultFileName, szFilename, MAX_FILENAME_LENGTH - strlen(szResultEnding) - 1);
+  }
+  else {
+    strncpy(f_szTestResultFileName, f_szDefaultFileRoot, MAX_FILENAME_LENGTH - strlen(szResultEnding) - 1);
+  }
+
+  f_szTestResultFileName[MAX_FILENAME_LENGTH - strlen(szResultEnding) - 1] = '\0';
+  strcat(f_szTestResultFileName, szResultEnding);
+}
+
+/*------------------------------------------------------------------------*/
+
+CU_ErrorCode CU_report_Binary_open_report(void)
+{
+  /* if a filename root hasn't been set, use the default one */
+  if (0 == strlen(f_szTestResultFileName)) {
+    CU_report_Binary_set_output_filename(f_szDefaultFileRoot);
+  }
+
+  f_bRunEnded = CU_FALSE;
+  free_strings();
+
+  CU_set_error(CUE_SUCCESS);
+
+  if (NULL == (f_pTestResultFile = fopen(f_szTestResultFileName, "wb"))) {
+    CU_set_error(CUE_FOPEN_FAILED);
+  }
+  else {
+    setvbuf(f_pTestResultFile, NULL, _IOFBF, CU_AUTOMATED_BUFFER_SIZE);
+
+    fwrite(CU_BINARY_MAGIC, 1, CU_BINARY_MAGIC_LENGTH, f_pTestResultFile);
+
+    begin_record(CU_BINARY_RUN_START);
+    put_varint((unsigned long long)time(NULL));
+    put_varint(intern_string(CU_automated_package_name_get()));
+    end_record();
+  }
+
+  return CU_get_error();
+}
+
+/*------------------------------------------------------------------------*/
+
+CU_ErrorCode CU_report_Binary_close_report(void)
+{
+  assert(NULL != f_pTestResultFile);
+
+  CU_set_error(CUE_SUCCESS);
+
+  if (0 != ferror(f_pTestResultFile)) {
+    CU_set_error(CUE_WRITE_ERROR);
+  }
+  if (0 != fclose(f_pTestResultFile)) {
+    CU_set_error(CUE_FCLOSE_FAILED);
+  }
+  f_pTestResultFile = NULL;
+
+  free_strings();
+  if (NULL != f_pRecord) {
+    CU_FREE(f_pRecord);
+    f_pRecord = NULL;
+    f_szRecordLen = 0;
+    f_szRecordCap = 0;
+  }
+
+  return CU_get_error();
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at start of each test.
+ *  @param pTest  The test being run (non-NULL).
+ *  @param pSuite The suite containing the test (non-NULL).
+ */
+void CU_report_Binary_test_start_msg_handler(const CU_pTest pTest, const CU_pSuite pSuite)
+{
+  assert(NULL != pTest);
+  assert(NULL != pSuite);
+  assert(NULL != f_pTestResultFile);
+
+  begin_record(CU_BINARY_TEST_START);
+  put_varint(intern_string(pSuite->pName));
+  put_varint(intern_string(pTest->pName));
+  end_record();
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of each test.
+ * @param pTest   The test being run (non-NULL).
+ * @param pSuite  The suite containing the test (non-NULL).
+ * @param pFailure Pointer to the 1st failure record for this test.
+ */
+void CU_report_Binary_test_complete_msg_handler(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_pFailureRecord pTempFailure;
+  unsigned int nFailures = 0;
+
+  assert(NULL != pTest);
+  assert(NULL != pSuite);
+  assert(NULL != f_pTestResultFile);
+
+  for (pTempFailure = pFailure ; NULL != pTempFailure ; pTempFailure = pTempFailure->pNext) {
+    ++nFailures;
+  }
+
+  begin_record(CU_BINARY_TEST_END);
+  put_varint(intern_string(pSuite->pName));
+  put_varint(intern_string(pTest->pName));
+  put_duration(pTest->dDuration);
+  put_varint(nFailures);
+  for (pTempFailure = pFailure ; NULL != pTempFailure ; pTempFailure = pTempFailure->pNext) {
+    put_failure(pTempFailure);
+  }
+  end_record();
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of all tests.
+ *  @param pFailure Pointer to the test failure record list.
+ */
+void CU_report_Binary_all_tests_complete_msg_handler(const CU_pFailureRecord pFailure)
+{
+  CU_pTestRegistry pRegistry = CU_get_registry();
+  CU_pRunSummary pRunSummary = CU_get_run_summary();
+
+  CU_UNREFERENCED_PARAMETER(pFailure);  /* not used */
+
+  assert(NULL != pRegistry);
+  assert(NULL != pRunSummary);
+  assert(NULL != f_pTestResultFile);
+
+  begin_record(CU_BINARY_RUN_END);
+  put_varint((unsigned long long)time(NULL));
+  put_varint(pRegistry->uiNumberOfSuites);
+  put_varint(pRegistry->uiNumberOfTests);
+  put_varint(pRunSummary->nSuitesRun);
+  put_varint(pRunSummary->nSuitesFailed);
+  put_varint(pRunSummary->nSuitesInactive);
+  put_varint(pRunSummary->nTestsRun);
+  put_varint(pRunSummary->nTestsFailed);
+  put_varint(pRunSummary->nTestsInactive);
+  put_varint(pRunSummary->nAsserts);
+  put_varint(pRunSummary->nAssertsFailed);
+  put_varint(pRunSummary->nFailureRecords);
+  put_duration(pRunSummary->ElapsedTime);
+  put_varint(pRunSummary->nTestsCrashed);
+  end_record();
+  f_bRunEnded = CU_TRUE;
+
+  fflush(f_pTestResultFile);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called when suite initialization fails.
+ *  @param pSuite The suite for which initialization failed.
+ */
+void CU_report_Binary_suite_init_failure_msg_handler(const CU_pSuite pSuite)
+{
+  assert(NULL != pSuite);
+  assert(NULL != f_pTestResultFile);
+
+  write_suite_record(CU_BINARY_SUITE_INIT_FAILURE, pSuite);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called when suite cleanup fails.
+ *  @param pSuite The suite for which cleanup failed.
+ */
+void CU_report_Binary_suite_cleanup_failure_msg_handler(const CU_pSuite pSuite)
+{
+  assert(NULL != pSuite);
+  assert(NULL != f_pTestResultFile);
+
+  write_suite_record(CU_BINARY_SUITE_CLEANUP_FAILURE, pSuite);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of each suite.
+ *  Writes the registered tests of the suite and the failures of the
+ *  suite itself (those of its tests were written with the tests), then
+ *  flushes the results file.
+ *  @param pSuite   The suite which has completed.
+ *  @param pFailure Pointer to the 1st failure record of the suite.
+ */
+void CU_report_Binary_suite_complete_msg_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_pFailureRecord pTempFailure;
+  CU_pTest pTest;
+  unsigned int nFailures = 0;
+  unsigned int nSuiteFailures = 0;
+  unsigned int nTests = 0;
+  /* tests after the one which stopped the run were not run (see CU_set_fail_fast()) */
+  CU_pTest pStopTest = CU_get_fail_fast_test();
+
+  assert(NULL != pSuite);
+  assert(NULL != f_pTestResultFile);
+
+  for (pTempFailure = pFailure ; NULL != pTempFailure ; pTempFailure = pTempFailure->pNext) {
+    ++nFailures;
+    if (NULL == pTempFailure->pTest) {
+      ++nSuiteFailures;
+    }
+  }
+  for (pTest = pSuite->pTest ; NULL != pTest ; pTest = (pTest == pStopTest) ? NULL : pTest->pNext) {
+    if (CU_FALSE != pTest->fInShard) {
+      ++nTests;
+    }
+  }
+
+  begin_record(CU_BINARY_SUITE_END);
+  put_varint(intern_string(pSuite->pName));
+  put_varint(pSuite->uiNumberOfTestsFailed);
+  put_varint(nFailures);
+  put_varint(nTests);
+  for (pTest = pSuite->pTest ; NULL != pTest ; pTest = (pTest == pStopTest) ? NULL : pTest->pNext) {
+    if (CU_FALSE != pTest->fInShard) {
+      put_varint(intern_string(pTest->pName));
+      put_duration(pTest->dDuration);
+    }
+  }
+  put_varint(nSuiteFailures);
+  for (pTempFailure = pFailure ; NULL != pTempFailure ; pTempFailure = pTempFailure->pNext) {
+    if (NULL == pTempFailure->pTest) {
+      put_failure(pTempFailure);
+    }
+  }
+  end_record();
+
+  fflush(f_pTestResultFile);
+}
+
+/*------------------------------------------------------------------------*/
+/** Completes and closes the test results file after a fatal signal
+ *  or exit() during a run.  The records written so far are kept and an
+ *  abort record marks the truncation.
+ */
+void CU_report_Binary_abort_report(void)
+{
+  if (NULL == f_pTestResultFile) {
+    return;
+  }
+
+  if (CU_FALSE == f_bRunEnded) {
+    write_varint(1);
+    putc(CU_BINARY_ABORT, f_pTestResultFile);
+  }
+
+  fclose(f_pTestResultFile);
+  f_pTestResultFile = NULL;
+}
+   /** @} */
@@ -22,7 +22,27 @@
  /*
   *  Implementation of the CUnit Report Format
   *
-  *  24-Jan-2019      Initial implementation. (PMi)
+  *  24-Jan-2019      Initial implementation. (AGT)
+  *
+  *  18-Oct-2026      Added per-test duration to test records. (AGT)
+  *
+  *  18-Oct-2026      Names and conditions translated into a reused
+  *                   buffer. (AGT)
+  *
+  *  18-Oct-2026      Suite and test names written from their cached xml
+  *                   form. (AGT)
+  *
+  *  18-Oct-2026      Fully buffered report files flushed after each suite,
+  *                   added CU_report_CUnit_abort_report(). (AGT)
+  *
+  *  18-Oct-2026      Default file names no longer set through the selected
+  *                   format, which may be another one. (AGT)
+  *
+  *  18-Oct-2026      Footer notes runs tainted by crashes captured in
+  *                   process. (AGT)
+  *
+  *  18-Oct-2026      Offset index of suite and test records appended to
+  *                   the results file. (AGT)
   *
   */
 
@@ -34,6 +54,7 @@
    */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <ctype.h>
 #include <assert.h>
 #include <string.h>
@@ -45,6 +66,7 @@
 #include "MyMem.h"
 #include "Util.h"
 #include "Report_CUnit.h"
+#include "ResultIndex.h"
 
 #define MAX_FILENAME_LENGTH   1025
 
@@ -62,8 +84,9 @@ CU_reportFormat_T CU_reportFormat_CUnit =
   CU_report_CUnit_all_tests_complete_msg_handler,       /* pAllTestsCompleteMsgHandler */
   CU_report_CUnit_suite_init_failure_msg_handler,       /* pSuiteInitFailureMsgHandler */
   CU_report_CUnit_suite_cleanup_failure_msg_handler,    /* pSuiteCleanupFailureMsgHandler */
-  NULL,                                                 /* pSuiteCompleteMsgHandler */
-  CU_report_CUnit_list_all_tests                        /* pListAllTests */
+  CU_report_CUnit_suite_complete_msg_handler,           /* pSuiteCompleteMsgHandler */
+  CU_report_CUnit_list_all_tests,                       /* pListAllTests */
+  CU_report_CUnit_abort_report                          /* pAbortReport */
 };
 
 /*=================================================================
@@ -76,6 +99,94 @@ static char      f_szTestResultFileName[MAX_FILENAME_LENGTH] = ""; /**< Current
 static FILE*     f_pTestResultFile = NULL;                  /**< FILE pointer the test results file. */
 
 static CU_BOOL f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;       /**< Flag for keeping track of when a closing xml tag is required. */
+static CU_BOOL f_bResultListingClosed = CU_FALSE;           /**< Flag set once CUNIT_RESULT_LISTING and the summary are written. */
+
+static char*     f_szXmlBuffer = NULL;                      /**< Buffer for translated conditions. */
+static size_t    f_szXmlBufferLen = 0;                      /**< Allocated length of f_szXmlBuffer. */
+
+static unsigned long f_ulResultOffset = 0;                  /**< Bytes written to the test results file. */
+static unsigned long f_ulSuiteOffset = 0;                   /**< Offset of the open CUNIT_RUN_SUITE element. */
+static CU_pResultIndexWriter f_pResultIndex = NULL;         /**< Offset index of the test results file (NULL if none). */
+
+/*------------------------------------------------------------------------*/
+/** Writes to the test results file, counting the bytes written for the
+ *  offset index (ftell() may cost a system call).
+ *  @param szFormat printf() format.
+ */
+static void print_result(const char* szFormat, ...)
+{
+  va_list args;
+  int iWritten;
+
+  va_start(args, szFormat);
+  iWritten = vfprintf(f_pTestResultFile, szFormat, args);
+  va_end(args);
+
+  if (0 < iWritten) {
+    f_ulResultOffset += (unsigned long)iWritten;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Closes the open CUNIT_RUN_SUITE element, if any, and indexes it.
+ *  @param bIndex CU_FALSE to leave the suite out of the index, which
+ *                must not grow when called from a signal handler.
+ */
+static void close_run_suite(CU_BOOL bIndex)
+{
+  if ((NULL != f_pRunningSuite) && (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE)) {
+    print_result(
+      "      </CUNIT_RUN_SUITE_SUCCESS> \n"
+      "    </CUNIT_RUN_SUITE> \n");
+    if (CU_FALSE != bIndex) {
+      CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_SUITE, f_pRunningSuite->pName, NULL,
+                          f_ulSuiteOffset, f_ulResultOffset - f_ulSuiteOffset);
+    }
+  }
+  f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a CUNIT_RUN_SUITE element for a failed suite function and
+ *  indexes it.
+ *  @param pSuite   The suite (non-NULL).
+ *  @param szReason Failure reason.
+ */
+static void print_suite_failure(const CU_pSuite pSuite, const char* szReason)
+{
+  unsigned long ulOffset;
+
+  close_run_suite(CU_TRUE);
+
+  ulOffset = f_ulResultOffset;
+  print_result(
+    "    <CUNIT_RUN_SUITE> \n"
+    "      <CUNIT_RUN_SUITE_FAILURE> \n"
+    "        <SUITE_NAME> %s </SUITE_NAME> \n"
+    "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
+    "      </CUNIT_RUN_SUITE_FAILURE> \n"
+    "    </CUNIT_RUN_SUITE>  \n",
+    CU_get_suite_xml_name(pSuite),
+    szReason);
+  CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_SUITE, pSuite->pName, NULL,
+                      ulOffset, f_ulResultOffset - ulOffset);
+}
+
+/*------------------------------------------------------------------------*/
+/** Translates xml special characters in a condition into f_szXmlBuffer.
+ *  @param szText Text to translate (NULL is translated to "").
+ *  @return The translated text, or "" if the buffer could not be grown.
+ */
+static const char* translate_xml(const char* szText)
+{
+  const char* szResult;
+
+  if (NULL == szText) {
+    return "";
+  }
+  szResult = CU_translate_to_buffer(szText, &f_szXmlBuffer, &f_szXmlBufferLen);
+  return (NULL != szResult) ? szResult : "";
+}
 
 /*=================================================================
 *  Public Interface functions
@@ -115,12 +226,14 @@ CU_ErrorCode CU_report_CUnit_open_report(void)
 {
   /* if a filename root hasn't been set, use the default one */
   if (0 == strlen(f_szTestResultFileName)) {
-    CU_set_output_filename(f_szDefaultFileRoot);
+    CU_report_CUnit_set_output_filename(f_szDefaultFileRoot);
   }
 
   f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
+  f_bResultListingClosed = CU_FALSE;
 
   f_pRunningSuite = NULL;
+  f_ulResultOffset = 0;
 
   CU_set_error(CUE_SUCCESS);
 
@@ -128,15 +241,19 @@ CU_ErrorCode CU_report_CUnit_open_report(void)
     CU_set_error(CUE_FOPEN_FAILED);
   }
   else {
-    setvbuf(f_pTestResultFile, NULL, _IONBF, 0);
+    setvbuf(f_pTestResultFile, NULL, _IOFBF, CU_AUTOMATED_BUFFER_SIZE);
 
-    fprintf(f_pTestResultFile,
+    /* a report without an index is still complete, so no index is no error */
+    CU_result_index_writer_destroy(f_pResultIndex);
+    f_pResultIndex = CU_result_index_writer_create();
+
+    print_result(
       "<?xml version=\"1.0\" ?> \n"
       "<?xml-stylesheet type=\"text/xsl\" href=\"CUnit-Run.xsl\" ?> \n"
       "<!DOCTYPE CUNIT_TEST_RUN_REPORT SYSTEM \"CUnit-Run.dtd\"> \n"
       "<CUNIT_TEST_RUN_REPORT> \n"
       "  <CUNIT_HEADER/> \n");
-    fprintf(f_pTestResultFile, "  <CUNIT_RESULT_LISTING> \n");
+    print_result("  <CUNIT_RESULT_LISTING> \n");
   }
 
   return CU_get_error();
@@ -155,15 +272,27 @@ CU_ErrorCode CU_report_CUnit_close_report(void)
 
   time(&tTime);
   szTime = ctime(&tTime);
-  fprintf(f_pTestResultFile,
-    "  <CUNIT_FOOTER> %s" CU_VERSION " - %s </CUNIT_FOOTER> \n"
+  print_result(
+    "  <CUNIT_FOOTER> %s%s" CU_VERSION " - %s </CUNIT_FOOTER> \n"
     "</CUNIT_TEST_RUN_REPORT>",
+    (0 < CU_get_number_of_tests_crashed()) ? _("Run tainted by tests crashed in process - ") : "",
     _("File Generated By CUnit v"),
     (NULL != szTime) ? szTime : "");
 
+  CU_result_index_write(f_pResultIndex, f_pTestResultFile, f_ulResultOffset);
+  CU_result_index_writer_destroy(f_pResultIndex);
+  f_pResultIndex = NULL;
+
   if (0 != fclose(f_pTestResultFile)) {
     CU_set_error(CUE_FCLOSE_FAILED);
   }
+  f_pTestResultFile = NULL;
+
+  if (NULL != f_szXmlBuffer) {
+    CU_FREE(f_szXmlBuffer);
+    f_szXmlBuffer = NULL;
+    f_szXmlBufferLen = 0;
+  }
 
   return CU_get_error();
 }
@@ -177,9 +306,6 @@ CU_ErrorCode CU_report_CUnit_close_report(void)
  */
 void CU_report_CUnit_test_start_msg_handler(const CU_pTest pTest, const CU_pSuite pSuite)
 {
-  char *szTempName = NULL;
-  size_t szTempName_len = 0;
-
   CU_UNREFERENCED_PARAMETER(pTest);   /* not currently used */
 
   assert(NULL != pTest);
@@ -189,29 +315,19 @@ void CU_report_CUnit_test_start_msg_handler(const CU_pTest pTest, const CU_pSuit
 
   /* write suite close/open tags if this is the 1st test for this szSuite */
   if ((NULL == f_pRunningSuite) || (f_pRunningSuite != pSuite)) {
-    if (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE) {
-      fprintf(f_pTestResultFile,
-        "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-        "    </CUNIT_RUN_SUITE> \n");
-    }
+    close_run_suite(CU_TRUE);
 
-    /* translate suite name that may contain XML control characters */
-    szTempName = (char *)CU_MALLOC((szTempName_len = CU_translated_strlen(pSuite->pName) + 1));
-    CU_translate_special_characters(pSuite->pName, szTempName, szTempName_len);
-
-    fprintf(f_pTestResultFile,
+    /* suite name translated once and cached in the suite */
+    f_ulSuiteOffset = f_ulResultOffset;
+    print_result(
       "    <CUNIT_RUN_SUITE> \n"
       "      <CUNIT_RUN_SUITE_SUCCESS> \n"
       "        <SUITE_NAME> %s </SUITE_NAME> \n",
-      (NULL != szTempName ? szTempName : ""));
+      CU_get_suite_xml_name(pSuite));
 
     f_bWriting_CUNIT_RUN_SUITE = CU_TRUE;
     f_pRunningSuite = pSuite;
   }
-
-  if (NULL != szTempName) {
-    CU_FREE(szTempName);
-  }
 }
 
 /*------------------------------------------------------------------------*/
@@ -222,12 +338,8 @@ void CU_report_CUnit_test_start_msg_handler(const CU_pTest pTest, const CU_pSuit
  */
 void CU_report_CUnit_test_complete_msg_handler(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
 {
-  char *szTemp = NULL;
-  size_t szTemp_len = 0;
-  size_t cur_len = 0;
   CU_pFailureRecord pTempFailure = pFailure;
-
-  CU_UNREFERENCED_PARAMETER(pSuite);  /* pSuite is not used except in assertion */
+  unsigned long ulOffset = f_ulResultOffset;
 
   assert(NULL != pTest);
   assert(NULL != pTest->pName);
@@ -242,59 +354,46 @@ void CU_report_CUnit_test_complete_msg_handler(const CU_pTest pTest, const CU_pS
       assert((NULL != pTempFailure->pSuite) && (pTempFailure->pSuite == pSuite));
       assert((NULL != pTempFailure->pTest) && (pTempFailure->pTest == pTest));
 
-      /* expand temporary char buffer if need more room */
-      if (NULL != pTempFailure->strCondition) {
-        cur_len = CU_translated_strlen(pTempFailure->strCondition) + 1;
-      }
-      else {
-        cur_len = 1;
-      }
-      if (cur_len > szTemp_len) {
-        szTemp_len = cur_len;
-        if (NULL != szTemp) {
-          CU_FREE(szTemp);
-        }
-        szTemp = (char *)CU_MALLOC(szTemp_len);
-      }
-
-      /* convert xml entities in strCondition (if present) */
-      if (NULL != pTempFailure->strCondition) {
-        CU_translate_special_characters(pTempFailure->strCondition, szTemp, szTemp_len);
-      }
-      else {
-        szTemp[0] = '\0';
-      }
-
-      fprintf(f_pTestResultFile,
+      print_result(
         "        <CUNIT_RUN_TEST_RECORD> \n"
         "          <CUNIT_RUN_TEST_FAILURE> \n"
-        "            <TEST_NAME> %s </TEST_NAME> \n"
+        "            <TEST_NAME> %s </TEST_NAME> \n",
+        CU_get_test_xml_name(pTest));
+
+      /* duration is reported once per test, with its 1st failure record */
+      if (pTempFailure == pFailure) {
+        print_result(
+          "            <TEST_DURATION> %.6f </TEST_DURATION> \n",
+          pTest->dDuration);
+      }
+
+      print_result(
         "            <FILE_NAME> %s </FILE_NAME> \n"
         "            <LINE_NUMBER> %u </LINE_NUMBER> \n"
         "            <CONDITION> %s </CONDITION> \n"
         "          </CUNIT_RUN_TEST_FAILURE> \n"
         "        </CUNIT_RUN_TEST_RECORD> \n",
-        pTest->pName,
         (NULL != pTempFailure->strFileName) ? pTempFailure->strFileName : "",
         pTempFailure->uiLineNumber,
-        szTemp);
+        translate_xml(pTempFailure->strCondition));
 
       pTempFailure = pTempFailure->pNext;
     } /* while */
   }
   else {
-    fprintf(f_pTestResultFile,
+    print_result(
       "        <CUNIT_RUN_TEST_RECORD> \n"
       "          <CUNIT_RUN_TEST_SUCCESS> \n"
       "            <TEST_NAME> %s </TEST_NAME> \n"
+      "            <TEST_DURATION> %.6f </TEST_DURATION> \n"
       "          </CUNIT_RUN_TEST_SUCCESS> \n"
       "        </CUNIT_RUN_TEST_RECORD> \n",
-      pTest->pName);
+      CU_get_test_xml_name(pTest),
+      pTest->dDuration);
   }
 
-  if (NULL != szTemp) {
-    CU_FREE(szTemp);
-  }
+  CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_TEST, pSuite->pName, pTest->pName,
+                      ulOffset, f_ulResultOffset - ulOffset);
 }
 
 /*------------------------------------------------------------------------*/
@@ -312,17 +411,14 @@ void CU_report_CUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFai
   assert(NULL != pRunSummary);
   assert(NULL != f_pTestResultFile);
 
-  if ((NULL != f_pRunningSuite) && (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE)) {
-    fprintf(f_pTestResultFile,
-      "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-      "    </CUNIT_RUN_SUITE> \n");
-  }
+  close_run_suite(CU_TRUE);
 
-  fprintf(f_pTestResultFile,
+  print_result(
     "  </CUNIT_RESULT_LISTING>\n"
     "  <CUNIT_RUN_SUMMARY> \n");
+  f_bResultListingClosed = CU_TRUE;
 
-  fprintf(f_pTestResultFile,
+  print_result(
     "    <CUNIT_RUN_SUMMARY_RECORD> \n"
     "      <TYPE> %s </TYPE> \n"
     "      <TOTAL> %u </TOTAL> \n"
@@ -337,7 +433,7 @@ void CU_report_CUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFai
     pRunSummary->nSuitesFailed,
     pRunSummary->nSuitesInactive);
 
-  fprintf(f_pTestResultFile,
+  print_result(
     "    <CUNIT_RUN_SUMMARY_RECORD> \n"
     "      <TYPE> %s </TYPE> \n"
     "      <TOTAL> %u </TOTAL> \n"
@@ -353,7 +449,7 @@ void CU_report_CUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFai
     pRunSummary->nTestsFailed,
     pRunSummary->nTestsInactive);
 
-  fprintf(f_pTestResultFile,
+  print_result(
     "    <CUNIT_RUN_SUMMARY_RECORD> \n"
     "      <TYPE> %s </TYPE> \n"
     "      <TOTAL> %u </TOTAL> \n"
@@ -381,22 +477,7 @@ void CU_report_CUnit_suite_init_failure_msg_handler(const CU_pSuite pSuite)
   assert(NULL != pSuite->pName);
   assert(NULL != f_pTestResultFile);
 
-  if (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE) {
-    fprintf(f_pTestResultFile,
-      "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-      "    </CUNIT_RUN_SUITE> \n");
-    f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
-  }
-
-  fprintf(f_pTestResultFile,
-    "    <CUNIT_RUN_SUITE> \n"
-    "      <CUNIT_RUN_SUITE_FAILURE> \n"
-    "        <SUITE_NAME> %s </SUITE_NAME> \n"
-    "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
-    "      </CUNIT_RUN_SUITE_FAILURE> \n"
-    "    </CUNIT_RUN_SUITE>  \n",
-    pSuite->pName,
-    _("Suite Initialization Failed"));
+  print_suite_failure(pSuite, _("Suite Initialization Failed"));
 }
 
 /*------------------------------------------------------------------------*/
@@ -409,22 +490,50 @@ void CU_report_CUnit_suite_cleanup_failure_msg_handler(const CU_pSuite pSuite)
   assert(NULL != pSuite->pName);
   assert(NULL != f_pTestResultFile);
 
-  if (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE) {
-    fprintf(f_pTestResultFile,
-      "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-      "    </CUNIT_RUN_SUITE> \n");
-    f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
+  print_suite_failure(pSuite, _("Suite Cleanup Failed"));
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of each suite.
+ *  Flushes the results of the suite to the test results file.
+ *  @param pSuite   The suite which has completed.
+ *  @param pFailure Pointer to the test failure record list.
+ */
+void CU_report_CUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_UNREFERENCED_PARAMETER(pSuite);    /* not used */
+  CU_UNREFERENCED_PARAMETER(pFailure);  /* not used */
+
+  assert(NULL != f_pTestResultFile);
+
+  fflush(f_pTestResultFile);
+}
+
+/*------------------------------------------------------------------------*/
+/** Completes and closes the test results file after a fatal signal
+ *  or exit() during a run.  The results written so far are kept, the
+ *  open elements are closed and the footer notes the truncation.
+ */
+void CU_report_CUnit_abort_report(void)
+{
+  if (NULL == f_pTestResultFile) {
+    return;
   }
 
-  fprintf(f_pTestResultFile,
-    "    <CUNIT_RUN_SUITE> \n"
-    "      <CUNIT_RUN_SUITE_FAILURE> \n"
-    "        <SUITE_NAME> %s </SUITE_NAME> \n"
-    "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
-    "      </CUNIT_RUN_SUITE_FAILURE> \n"
-    "    </CUNIT_RUN_SUITE>  \n",
-    pSuite->pName,
-    _("Suite Cleanup Failed"));
+  if (CU_FALSE == f_bResultListingClosed) {
+    close_run_suite(CU_FALSE);
+    print_result("  </CUNIT_RESULT_LISTING>\n"
+                 "  <CUNIT_RUN_SUMMARY> \n"
+                 "  </CUNIT_RUN_SUMMARY> \n");
+  }
+  print_result(
+    "  <CUNIT_FOOTER> %s </CUNIT_FOOTER> \n"
+    "</CUNIT_TEST_RUN_REPORT>",
+    _("Test run aborted - report truncated"));
+  CU_result_index_write(f_pResultIndex, f_pTestResultFile, f_ulResultOffset);
+
+  fclose(f_pTestResultFile);
+  f_pTestResultFile = NULL;
 }
 
 /*------------------------------------------------------------------------*/
@@ -451,7 +560,7 @@ CU_ErrorCode CU_report_CUnit_list_all_tests(CU_pTestRegistry pRegistry)
     CU_set_error(CUE_FOPEN_FAILED);
   }
   else {
-    setvbuf(pTestListFile, NULL, _IONBF, 0);
+    setvbuf(pTestListFile, NULL, _IOFBF, CU_AUTOMATED_BUFFER_SIZE);
 
     fprintf(pTestListFile,
       "<?xml version=\"1.0\" ?> \n"
@@ -495,7 +604,7 @@ CU_ErrorCode CU_report_CUnit_list_all_tests(CU_pTestRegistry pRegistry)
         "        <ACTIVE_VALUE> %s </ACTIVE_VALUE> \n"
         "        <TEST_COUNT_VALUE> %u </TEST_COUNT_VALUE> \n"
         "      </CUNIT_ALL_TEST_LISTING_SUITE_DEFINITION> \n",
-        pSuite->pName,
+        CU_get_suite_xml_name(pSuite),
         (NULL != pSuite->pInitializeFunc) ? _("Yes") : _("No"),
         (NULL != pSuite->pCleanupFunc) ? _("Yes") : _("No"),
         (CU_FALSE != pSuite->fActive) ? _("Yes") : _("No"),
@@ -510,7 +619,7 @@ CU_ErrorCode CU_report_CUnit_list_all_tests(CU_pTestRegistry pRegistry)
           "          <TEST_CASE_NAME> %s </TEST_CASE_NAME> \n"
           "          <TEST_ACTIVE_VALUE> %s </TEST_ACTIVE_VALUE> \n"
           "        </TEST_CASE_DEFINITION> \n",
-          pTest->pName,
+          CU_get_test_xml_name(pTest),
           (CU_FALSE != pSuite->fActive) ? _("Yes") : _("No"));
         pTest = pTest->pNext;
       }
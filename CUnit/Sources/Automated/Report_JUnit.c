@@ -24,6 +24,29 @@
   *
   *  24-Jan-2019      Initial implementation. (PMi)
   *
+  *  18-Oct-2026      Report measured test and suite durations. (AGT)
+  *
+  *  18-Oct-2026      Conditions translated into a reused buffer, suite
+  *                   and test names written from their cached xml
+  *                   form. (AGT)
+  *
+  *  18-Oct-2026      Fully buffered report file flushed after each suite,
+  *                   added CU_report_JUnit_abort_report(). (AGT)
+  *
+  *  18-Oct-2026      Default file names no longer set through the selected
+  *                   format, which may be another one. (AGT)
+  *
+  *  18-Oct-2026      Offset index of testsuite and testcase elements
+  *                   appended to the results file. (AGT)
+  *
+  *  18-Oct-2026      Tests of other shards left out of the report. (AGT)
+  *
+  *  18-Oct-2026      Tests not run after a fail-fast stop left out of
+  *                   the report. (AGT)
+  *
+  *  18-Oct-2026      Properties of the testsuites element mark runs
+  *                   tainted by crashes captured in process. (AGT)
+  *
   */
 
   /** @file
@@ -34,6 +57,7 @@
    */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <ctype.h>
 #include <assert.h>
 #include <string.h>
@@ -45,6 +69,7 @@
 #include "MyMem.h"
 #include "Util.h"
 #include "Report_JUnit.h"
+#include "ResultIndex.h"
 
 #define MAX_FILENAME_LENGTH   1025
 
@@ -63,7 +88,8 @@ CU_reportFormat_T CU_reportFormat_JUnit =
   NULL,                                                 /* pSuiteInitFailureMsgHandler */
   NULL,                                                 /* pSuiteCleanupFailureMsgHandler */
   CU_report_JUnit_suite_complete_msg_handler,           /* pSuiteCompleteMsgHandler */
-  NULL                                                  /* pListAllTests - not supported by JUnit format */
+  NULL,                                                 /* pListAllTests - not supported by JUnit format */
+  CU_report_JUnit_abort_report                          /* pAbortReport */
 };
 
 /*=================================================================
@@ -75,15 +101,22 @@ static char      f_szTestListFileName[MAX_FILENAME_LENGTH] = "";   /**< Current
 static char      f_szTestResultFileName[MAX_FILENAME_LENGTH] = ""; /**< Current output file name for the test results file. */
 static FILE*     f_pTestResultFile = NULL;                  /**< FILE pointer the test results file. */
 static CU_BOOL f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;       /**< Flag for keeping track of when a closing xml tag is required. */
+static CU_BOOL f_bTestsuitesClosed = CU_FALSE;              /**< Flag set once the testsuites element is closed. */
+static char*     f_szXmlBuffer = NULL;                      /**< Buffer for translated conditions. */
+static size_t    f_szXmlBufferLen = 0;                      /**< Allocated length of f_szXmlBuffer. */
+static unsigned long f_ulResultOffset = 0;                  /**< Bytes written to the test results file. */
+static CU_pResultIndexWriter f_pResultIndex = NULL;         /**< Offset index of the test results file (NULL if none). */
 
 static void CU_report_JUnit_print_single_test_success(const CU_pTest pTest);
 static void CU_report_JUnit_print_single_test_error(const CU_pTest pTest);
 static void CU_report_JUnit_print_single_test_skipped(const CU_pTest pTest);
 static CU_pFailureRecord CU_report_JUnit_print_single_test_failed(const CU_pTest pTest, const CU_pFailureRecord pFailure);
-static void CU_report_JUnit_print_testcase_tag(const CU_pTest pTest, const CU_BOOL hasSubTags);
+static void CU_report_JUnit_print_testcase_tag(const CU_pTest pTest, const CU_BOOL hasSubTags, double dTime);
 static void CU_report_JUnit_print_dummy_test(const char* sSuiteName, const CU_pFailureRecord pFailure);
 static void CU_report_JUnit_print_failure_details(CU_pFailureRecord pFailure);
-static void CU_report_JUnit_get_failure_msg(char* strCondition, char ** pOutputBuffer);
+static const char* CU_report_JUnit_get_failure_msg(const char* strCondition);
+static void print_taint(void);
+static void print_result(const char* szFormat, ...);
 
 /*=================================================================
 *  Public Interface functions
@@ -123,12 +156,14 @@ CU_ErrorCode CU_report_JUnit_open_report(void)
 {
   /* if a filename root hasn't been set, use the default one */
   if (0 == strlen(f_szTestResultFileName)) {
-    CU_set_output_filename(f_szDefaultFileRoot);
+    CU_report_JUnit_set_output_filename(f_szDefaultFileRoot);
   }
 
   f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
+  f_bTestsuitesClosed = CU_FALSE;
 
   f_pRunningSuite = NULL;
+  f_ulResultOffset = 0;
 
   CU_set_error(CUE_SUCCESS);
 
@@ -136,9 +171,13 @@ CU_ErrorCode CU_report_JUnit_open_report(void)
     CU_set_error(CUE_FOPEN_FAILED);
   }
   else {
-    setvbuf(f_pTestResultFile, NULL, _IONBF, 0);
+    setvbuf(f_pTestResultFile, NULL, _IOFBF, CU_AUTOMATED_BUFFER_SIZE);
 
-    fprintf(f_pTestResultFile,
+    /* a report without an index is still complete, so no index is no error */
+    CU_result_index_writer_destroy(f_pResultIndex);
+    f_pResultIndex = CU_result_index_writer_create();
+
+    print_result(
       "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
       "<testsuites> \n");
   }
@@ -154,9 +193,20 @@ CU_ErrorCode CU_report_JUnit_close_report(void)
 
   CU_set_error(CUE_SUCCESS);
 
+  CU_result_index_write(f_pResultIndex, f_pTestResultFile, f_ulResultOffset);
+  CU_result_index_writer_destroy(f_pResultIndex);
+  f_pResultIndex = NULL;
+
   if (0 != fclose(f_pTestResultFile)) {
     CU_set_error(CUE_FCLOSE_FAILED);
   }
+  f_pTestResultFile = NULL;
+
+  if (NULL != f_szXmlBuffer) {
+    CU_FREE(f_szXmlBuffer);
+    f_szXmlBuffer = NULL;
+    f_szXmlBufferLen = 0;
+  }
 
   return CU_get_error();
 }
@@ -176,7 +226,30 @@ void CU_report_JUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFai
   assert(NULL != pRunSummary);
   assert(NULL != f_pTestResultFile);
 
-  fprintf(f_pTestResultFile, "</testsuites>");
+  print_taint();
+  print_result("</testsuites>");
+  f_bTestsuitesClosed = CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Completes and closes the test results file after a fatal signal
+ *  or exit() during a run.  Suites completed so far are kept; the suite
+ *  which was running is not reported.
+ */
+void CU_report_JUnit_abort_report(void)
+{
+  if (NULL == f_pTestResultFile) {
+    return;
+  }
+
+  if (CU_FALSE == f_bTestsuitesClosed) {
+    print_taint();
+    print_result("</testsuites>");
+  }
+  CU_result_index_write(f_pResultIndex, f_pTestResultFile, f_ulResultOffset);
+
+  fclose(f_pTestResultFile);
+  f_pTestResultFile = NULL;
 }
 
 /*------------------------------------------------------------------------*/
@@ -186,10 +259,15 @@ void CU_report_JUnit_all_tests_complete_msg_handler(const CU_pFailureRecord pFai
  */
 void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
 {
-  char *szTempName = NULL;
-  size_t szTempName_len = 0;
+  const char *szTempName;
   CU_pTest pTest;
   CU_pFailureRecord pCurrFailure;
+  /* tests after the one which stopped the run were not run (see CU_set_fail_fast()) */
+  CU_pTest pStopTest = CU_get_fail_fast_test();
+  double dSuiteTime = 0.0;
+  unsigned int nTests = 0;
+  unsigned long ulSuiteOffset = f_ulResultOffset;
+  unsigned long ulOffset;
 
   const char *pPackageName;
 
@@ -199,18 +277,28 @@ void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU
 
   pPackageName = CU_automated_package_name_get();
 
-  /* translate suite name that may contain XML control characters */
-  szTempName = (char *)CU_MALLOC((szTempName_len = CU_translated_strlen(pSuite->pName) + 1));
-  CU_translate_special_characters(pSuite->pName, szTempName, szTempName_len);
+  /* suite name translated once and cached in the suite */
+  szTempName = CU_get_suite_xml_name(pSuite);
+
+  /* suite time is the sum of its test times (tests are not run if init failed) */
+  for (pTest = pSuite->pTest ; NULL != pTest ; pTest = (pTest == pStopTest) ? NULL : pTest->pNext) {
+    if (CU_FALSE != pTest->fInShard) {
+      ++nTests;
+      if ((NULL == pFailure) || (CUF_SuiteInitFailed != pFailure->type)) {
+        dSuiteTime += pTest->dDuration;
+      }
+    }
+  }
 
   /* Print suite open tag */
-  fprintf(f_pTestResultFile,
+  print_result(
     /*"  <testsuite errors=\"%d\" failures=\"%d\" tests=\"%d\" name=\"%s\"> \n",*/
-    "  <testsuite tests=\"%d\" failures=\"%d\" errors=\"0\" time=\"0\" name=\"%s\" package=\"%s\" hostname=\"localhost\" timestamp=\"0\"> \n",
+    "  <testsuite tests=\"%d\" failures=\"%d\" errors=\"0\" time=\"%.6f\" name=\"%s\" package=\"%s\" hostname=\"localhost\" timestamp=\"0\"> \n",
     //0, /* Errors */
-    pSuite->uiNumberOfTests, /* Tests */
+    nTests, /* Tests (of the shard run) */
     pSuite->uiNumberOfTestsFailed, /* Failures */
-    (NULL != szTempName) ? szTempName : "", /* Name */
+    dSuiteTime, /* Time */
+    szTempName, /* Name */
     pPackageName); /* Package */
 
   if (pFailure != NULL)
@@ -229,8 +317,14 @@ void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU
       pTest = pSuite->pTest;
       while (pTest != NULL)
       {
-        CU_report_JUnit_print_single_test_error(pTest);
-        pTest = pTest->pNext;
+        if (CU_FALSE != pTest->fInShard)
+        {
+          ulOffset = f_ulResultOffset;
+          CU_report_JUnit_print_single_test_error(pTest);
+          CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_TEST, pSuite->pName, pTest->pName,
+                              ulOffset, f_ulResultOffset - ulOffset);
+        }
+        pTest = (pTest == pStopTest) ? NULL : pTest->pNext;
       }
     }
     else /**/
@@ -238,6 +332,12 @@ void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU
       pTest = pSuite->pTest;
       while (pTest != NULL)
       {
+        if (CU_FALSE == pTest->fInShard)
+        {
+          pTest = (pTest == pStopTest) ? NULL : pTest->pNext;
+          continue;
+        }
+        ulOffset = f_ulResultOffset;
         /* Check if there are any failure records for given test. */
         if ((pCurrFailure != NULL) && (pCurrFailure->pTest == pTest))
         {
@@ -255,7 +355,9 @@ void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU
         {
           CU_report_JUnit_print_single_test_success(pTest);
         }
-        pTest = pTest->pNext;
+        CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_TEST, pSuite->pName, pTest->pName,
+                            ulOffset, f_ulResultOffset - ulOffset);
+        pTest = (pTest == pStopTest) ? NULL : pTest->pNext;
       }
 
       if ((pCurrFailure != NULL) && (CUF_SuiteCleanupFailed == pCurrFailure->type))
@@ -270,18 +372,24 @@ void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU
     pTest = pSuite->pTest;
     while (pTest != NULL)
     {
-      CU_report_JUnit_print_single_test_success(pTest);
-      pTest = pTest->pNext;
+      if (CU_FALSE != pTest->fInShard)
+      {
+        ulOffset = f_ulResultOffset;
+        CU_report_JUnit_print_single_test_success(pTest);
+        CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_TEST, pSuite->pName, pTest->pName,
+                            ulOffset, f_ulResultOffset - ulOffset);
+      }
+      pTest = (pTest == pStopTest) ? NULL : pTest->pNext;
     }
   }
 
   /* Print suite close tag. */
-  fprintf(f_pTestResultFile,
+  print_result(
     "  </testsuite>\n");
+  CU_result_index_add(f_pResultIndex, CU_RESULT_INDEX_SUITE, pSuite->pName, NULL,
+                      ulSuiteOffset, f_ulResultOffset - ulSuiteOffset);
 
-  if (NULL != szTempName) {
-    CU_FREE(szTempName);
-  }
+  fflush(f_pTestResultFile);
 }
 
 /*------------------------------------------------------------------------*/
@@ -290,7 +398,7 @@ void CU_report_JUnit_suite_complete_msg_handler(const CU_pSuite pSuite, const CU
  */
 static void CU_report_JUnit_print_single_test_success(const CU_pTest pTest)
 {
-  CU_report_JUnit_print_testcase_tag(pTest, CU_FALSE);
+  CU_report_JUnit_print_testcase_tag(pTest, CU_FALSE, pTest->dDuration);
 }
 
 /*------------------------------------------------------------------------*/
@@ -299,11 +407,11 @@ static void CU_report_JUnit_print_single_test_success(const CU_pTest pTest)
  */
 static void CU_report_JUnit_print_single_test_error(const CU_pTest pTest)
 {
-  CU_report_JUnit_print_testcase_tag(pTest, CU_TRUE);
+  CU_report_JUnit_print_testcase_tag(pTest, CU_TRUE, 0.0);
 
-  fprintf(f_pTestResultFile, "      <error message=\"Suite initialization failed\"/>\n");
+  print_result("      <error message=\"Suite initialization failed\"/>\n");
 
-  fprintf(f_pTestResultFile, "    </testcase>\n");
+  print_result("    </testcase>\n");
 }
 
 /*------------------------------------------------------------------------*/
@@ -312,11 +420,11 @@ static void CU_report_JUnit_print_single_test_error(const CU_pTest pTest)
  */
 static void CU_report_JUnit_print_single_test_skipped(const CU_pTest pTest)
 {
-  CU_report_JUnit_print_testcase_tag(pTest, CU_TRUE);
+  CU_report_JUnit_print_testcase_tag(pTest, CU_TRUE, 0.0);
 
-  fprintf(f_pTestResultFile, "      <skipped/>\n");
+  print_result("      <skipped/>\n");
 
-  fprintf(f_pTestResultFile, "    </testcase>\n");
+  print_result("    </testcase>\n");
 }
 
 /*------------------------------------------------------------------------*/
@@ -327,18 +435,12 @@ static void CU_report_JUnit_print_single_test_skipped(const CU_pTest pTest)
  */
 static CU_pFailureRecord CU_report_JUnit_print_single_test_failed(const CU_pTest pTest, const CU_pFailureRecord pFailure)
 {
-  char * szTemp = NULL;
-
   CU_pFailureRecord pTempFailure = pFailure;
 
-  CU_report_JUnit_print_testcase_tag(pTest, CU_TRUE);
+  CU_report_JUnit_print_testcase_tag(pTest, CU_TRUE, pTest->dDuration);
 
-  CU_report_JUnit_get_failure_msg(pFailure->strCondition, &szTemp);
-  fprintf(f_pTestResultFile, "      <failure message=\"%s\" type=\"Failure\">\n", szTemp);
-  if (NULL != szTemp)
-  {
-    CU_FREE(szTemp);
-  }
+  print_result("      <failure message=\"%s\" type=\"Failure\">\n",
+    CU_report_JUnit_get_failure_msg(pFailure->strCondition));
 
   while (NULL != pTempFailure && (pTempFailure->pTest == pTest))
   {
@@ -347,9 +449,9 @@ static CU_pFailureRecord CU_report_JUnit_print_single_test_failed(const CU_pTest
     pTempFailure = pTempFailure->pNext;
   } /* while */
 
-  fprintf(f_pTestResultFile, "      </failure>\n");
+  print_result("      </failure>\n");
 
-  fprintf(f_pTestResultFile, "    </testcase>\n");
+  print_result("    </testcase>\n");
 
   return pTempFailure;
 }
@@ -358,15 +460,17 @@ static CU_pFailureRecord CU_report_JUnit_print_single_test_failed(const CU_pTest
 /** Function prints single test tag
  *  @param pTest Test to print
  *  @param hasSubTags Flag to indicate if test case tag will contain sub-tags (like <error> or <failure>)
+ *  @param dTime Test duration in seconds
  */
-static void CU_report_JUnit_print_testcase_tag(const CU_pTest pTest, const CU_BOOL hasSubTags)
+static void CU_report_JUnit_print_testcase_tag(const CU_pTest pTest, const CU_BOOL hasSubTags, double dTime)
 {
   const char *pPackageName = CU_automated_package_name_get();
 
   /* Test tag */
-  fprintf(f_pTestResultFile, "    <testcase classname=\"%s\" name=\"%s\" time=\"0\"%s>\n",
+  print_result("    <testcase classname=\"%s\" name=\"%s\" time=\"%.6f\"%s>\n",
     pPackageName,
-    (NULL != pTest->pName) ? pTest->pName : "",
+    (NULL != pTest->pName) ? CU_get_test_xml_name(pTest) : "",
+    dTime,
     (CU_TRUE == hasSubTags) ? "" : "/");
   }
 
@@ -384,7 +488,7 @@ static void CU_report_JUnit_print_dummy_test(const char* sSuiteName, const CU_pF
 
   if (CUF_SuiteInitFailed == pFailure->type)
   {
-    fprintf(f_pTestResultFile, "    <testcase classname=\"%s.%s\" name=\"%s - Initialization\" time=\"0\">\n"
+    print_result("    <testcase classname=\"%s.%s\" name=\"%s - Initialization\" time=\"0\">\n"
         "      <failure message=\"Suite Initialization failed\" type=\"Failure\">\n",
       pPackageName,
       "",
@@ -392,7 +496,7 @@ static void CU_report_JUnit_print_dummy_test(const char* sSuiteName, const CU_pF
   }
   else
   {
-    fprintf(f_pTestResultFile, "    <testcase classname=\"%s.%s\" name=\"%s - Cleanup\" time=\"0\">\n"
+    print_result("    <testcase classname=\"%s.%s\" name=\"%s - Cleanup\" time=\"0\">\n"
         "      <failure message=\"Suite Cleanup failed\" type=\"Failure\">\n",
       pPackageName,
       "",
@@ -401,7 +505,7 @@ static void CU_report_JUnit_print_dummy_test(const char* sSuiteName, const CU_pF
 
   CU_report_JUnit_print_failure_details(pFailure);
 
-  fprintf(f_pTestResultFile, "      </failure>\n"
+  print_result("      </failure>\n"
     "    </testcase>\n");
 }
 
@@ -411,44 +515,62 @@ static void CU_report_JUnit_print_dummy_test(const char* sSuiteName, const CU_pF
  */
 static void CU_report_JUnit_print_failure_details(CU_pFailureRecord pFailure)
 {
-  char * szTemp = NULL;
-
-  CU_report_JUnit_get_failure_msg(pFailure->strCondition, &szTemp);
-
-  fprintf(f_pTestResultFile, "        Condition: %s\n", szTemp);
-  fprintf(f_pTestResultFile, "        File     : %s\n", (NULL != pFailure->strFileName) ? pFailure->strFileName : "");
-  fprintf(f_pTestResultFile, "        Line     : %d\n", pFailure->uiLineNumber);
-
-  if (NULL != szTemp)
-  {
-    CU_FREE(szTemp);
-  }
+  print_result("        Condition: %s\n", CU_report_JUnit_get_failure_msg(pFailure->strCondition));
+  print_result("        File     : %s\n", (NULL != pFailure->strFileName) ? pFailure->strFileName : "");
+  print_result("        Line     : %d\n", pFailure->uiLineNumber);
 }
 
-static void CU_report_JUnit_get_failure_msg(char* strCondition, char ** pOutputBuffer)
+/*------------------------------------------------------------------------*/
+/** Function translates xml entities in a failure condition
+ *  @param strCondition Condition to translate (may be NULL)
+ *  @returns The translated condition, valid until the next call
+ */
+static const char* CU_report_JUnit_get_failure_msg(const char* strCondition)
 {
-  size_t cur_len;
+  const char* szResult = NULL;
 
-  /* expand temporary char buffer if need more room */
+  /* convert xml entities in strCondition (if present) */
   if (NULL != strCondition) {
-    cur_len = CU_translated_strlen(strCondition) + 1;
-  }
-  else {
-    cur_len = 1;
+    szResult = CU_translate_to_buffer(strCondition, &f_szXmlBuffer, &f_szXmlBufferLen);
   }
+  return (NULL != szResult) ? szResult : "";
+}
 
-  if (NULL != *pOutputBuffer)
-  {
-    CU_FREE(*pOutputBuffer);
+/*------------------------------------------------------------------------*/
+/** Writes the properties of the testsuites element which mark a run
+ *  tainted by captured crashes (see CU_set_crash_capture()), if any.
+ *  They come last since the report is streamed.
+ */
+static void print_taint(void)
+{
+  unsigned int nCrashed = CU_get_number_of_tests_crashed();
+
+  if (0 < nCrashed) {
+    print_result(
+      "  <properties> \n"
+      "    <property name=\"tainted\" value=\"true\"/> \n"
+      "    <property name=\"tests_crashed\" value=\"%u\"/> \n"
+      "  </properties> \n",
+      nCrashed);
   }
-  *pOutputBuffer = (char *)CU_MALLOC(cur_len);
+}
 
-  /* convert xml entities in strCondition (if present) */
-  if (NULL != strCondition) {
-    CU_translate_special_characters(strCondition, *pOutputBuffer, cur_len);
-  }
-  else {
-    (*pOutputBuffer)[0] = '\0';
+/*------------------------------------------------------------------------*/
+/** Writes to the test results file, counting the bytes written for the
+ *  offset index (ftell() may cost a system call).
+ *  @param szFormat printf() format.
+ */
+static void print_result(const char* szFormat, ...)
+{
+  va_list args;
+  int iWritten;
+
+  va_start(args, szFormat);
+  iWritten = vfprintf(f_pTestResultFile, szFormat, args);
+  va_end(args);
+
+  if (0 < iWritten) {
+    f_ulResultOffset += (unsigned long)iWritten;
   }
 }
    /** @} */
@@ -0,0 +1,565 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Offset index of xml result files.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Offset index of xml result files (implementation).
+ */
+/** @addtogroup Automated
+ @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "ResultIndex.h"
+
+#define INDEX_HEADER        "<!-- CUNIT_INDEX "          /**< Start of the index comment. */
+#define INDEX_END           "-->\n"                      /**< End of the index comment. */
+#define TRAILER_PREFIX      "<!-- CUNIT_INDEX_OFFSET "   /**< Start of the last line. */
+#define TRAILER_SUFFIX      " -->\n"                     /**< End of the last line. */
+#define TRAILER_DIGITS      20                           /**< Digits of the offset in the last line. */
+#define TRAILER_LENGTH      (sizeof(TRAILER_PREFIX) - 1 + TRAILER_DIGITS + sizeof(TRAILER_SUFFIX) - 1)
+/**< Length of the last line. */
+
+#define MAX_NUMBER_LENGTH   24      /**< Room for an offset or length and its separator. */
+
+/** Index writer state. */
+struct CU_ResultIndexWriter
+{
+  char*    pText;       /**< Entry lines written so far. */
+  size_t   szLength;    /**< Length of the text in pText. */
+  size_t   szCapacity;  /**< Allocated length of pText. */
+  CU_BOOL  bFailed;     /**< Flag for an entry lost for lack of memory. */
+};
+
+/** Index reader state. */
+struct CU_ResultIndex
+{
+  FILE*                 pFile;      /**< Result file. */
+  char*                 pText;      /**< Index comment, names decoded in place. */
+  CU_ResultIndexEntry*  pEntries;   /**< Entries in file order. */
+  unsigned int          nEntries;   /**< Number of entries. */
+  unsigned int*         pSlots;     /**< Hash table of entry numbers + 1 (0 for free slots). */
+  unsigned int          nSlots;     /**< Number of slots (a power of 2), 0 until the first lookup. */
+};
+
+/*=================================================================
+ *  Static function implementation
+ *=================================================================*/
+/** Checks whether a byte of a name is written as %XX. */
+static CU_BOOL needs_escape(unsigned char c)
+{
+  return ((c <= ' ') || (0x7F == c) || ('%' == c) || ('-' == c)) ? CU_TRUE : CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Appends a name to the text of an index writer, escaping bytes for
+ *  which needs_escape() holds.  The room must have been reserved.
+ */
+static void append_name(CU_pResultIndexWriter pWriter, const char* szName)
+{
+  static const char szHex[] = "0123456789ABCDEF";
+  const unsigned char* pPos;
+  char* pOut = pWriter->pText + pWriter->szLength;
+
+  for (pPos = (const unsigned char*)szName ; '\0' != *pPos ; ++pPos) {
+    if (CU_FALSE != needs_escape(*pPos)) {
+      *pOut++ = '%';
+      *pOut++ = szHex[*pPos >> 4];
+      *pOut++ = szHex[*pPos & 0x0F];
+    }
+    else {
+      *pOut++ = (char)*pPos;
+    }
+  }
+  pWriter->szLength = (size_t)(pOut - pWriter->pText);
+}
+
+/*------------------------------------------------------------------------*/
+/** Converts a hexadecimal digit.
+ *  @return The value, or -1 if c is not a hexadecimal digit.
+ */
+static int hex_value(char c)
+{
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  }
+  if ((c >= 'A') && (c <= 'F')) {
+    return c - 'A' + 10;
+  }
+  if ((c >= 'a') && (c <= 'f')) {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes the %XX escapes of a name in place.
+ *  @return CU_FALSE if the name holds a malformed escape.
+ */
+static CU_BOOL decode_name(char* szName)
+{
+  char* pIn = szName;
+  char* pOut = szName;
+  int iHigh;
+  int iLow;
+
+  while ('\0' != *pIn) {
+    if ('%' == *pIn) {
+      if ((0 > (iHigh = hex_value(pIn[1]))) || (0 > (iLow = hex_value(pIn[2])))) {
+        return CU_FALSE;
+      }
+      *pOut++ = (char)((iHigh << 4) | iLow);
+      pIn += 3;
+    }
+    else {
+      *pOut++ = *pIn++;
+    }
+  }
+  *pOut = '\0';
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads a decimal number ended by a space.
+ *  @param ppPos   Position of the number, moved past the space.
+ *  @param pulValue Receives the number.
+ *  @return CU_FALSE if no number ended by a space is found.
+ */
+static CU_BOOL parse_number(char** ppPos, unsigned long* pulValue)
+{
+  char* pPos = *ppPos;
+  unsigned long ulValue = 0;
+
+  if ((*pPos < '0') || (*pPos > '9')) {
+    return CU_FALSE;
+  }
+  while ((*pPos >= '0') && (*pPos <= '9')) {
+    if (ulValue > (~0UL - 9) / 10) {
+      return CU_FALSE;
+    }
+    ulValue = ulValue * 10 + (unsigned long)(*pPos++ - '0');
+  }
+  if (' ' != *pPos) {
+    return CU_FALSE;
+  }
+  *ppPos = pPos + 1;
+  *pulValue = ulValue;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Parses the entry lines of an index comment read into pIndex->pText.
+ *  @param pLines   First entry line.
+ *  @param pEnd     End of the entry lines.
+ *  @param ulLimit  Offset of the index comment, which records end before.
+ *  @return A CU_ErrorCode.
+ */
+static CU_ErrorCode parse_entries(CU_pResultIndex pIndex, char* pLines, char* pEnd, unsigned long ulLimit)
+{
+  char* pPos;
+  char* pLineEnd;
+  char* pSpace;
+  unsigned int nLines = 0;
+  CU_ResultIndexEntry* pEntry;
+
+  for (pPos = pLines ; pPos < pEnd ; ++pPos) {
+    if ('\n' == *pPos) {
+      ++nLines;
+    }
+  }
+  if (0 < nLines) {
+    pIndex->pEntries = (CU_ResultIndexEntry*)CU_MALLOC(nLines * sizeof(CU_ResultIndexEntry));
+    if (NULL == pIndex->pEntries) {
+      return CUE_NOMEMORY;
+    }
+  }
+
+  for (pPos = pLines ; pPos < pEnd ; pPos = pLineEnd + 1) {
+    pLineEnd = (char*)memchr(pPos, '\n', (size_t)(pEnd - pPos));
+    if (NULL == pLineEnd) {
+      return CUE_BAD_FILE_FORMAT;
+    }
+    *pLineEnd = '\0';
+
+    pEntry = &pIndex->pEntries[pIndex->nEntries];
+    if (((CU_RESULT_INDEX_SUITE != *pPos) && (CU_RESULT_INDEX_TEST != *pPos)) || (' ' != pPos[1])) {
+      return CUE_BAD_FILE_FORMAT;
+    }
+    pEntry->kind = (CU_ResultIndexKind)*pPos;
+    pPos += 2;
+    if ((CU_FALSE == parse_number(&pPos, &pEntry->ulOffset)) ||
+        (CU_FALSE == parse_number(&pPos, &pEntry->ulLength)) ||
+        (pEntry->ulOffset > ulLimit) || (pEntry->ulLength > ulLimit - pEntry->ulOffset)) {
+      return CUE_BAD_FILE_FORMAT;
+    }
+
+    pEntry->szSuite = pPos;
+    pEntry->szTest = NULL;
+    pSpace = strchr(pPos, ' ');
+    if (NULL != pSpace) {
+      *pSpace = '\0';
+      pEntry->szTest = pSpace + 1;
+    }
+    if (((CU_RESULT_INDEX_TEST == pEntry->kind) != (NULL != pEntry->szTest)) ||
+        (CU_FALSE == decode_name((char*)pEntry->szSuite)) ||
+        ((NULL != pEntry->szTest) && (CU_FALSE == decode_name((char*)pEntry->szTest)))) {
+      return CUE_BAD_FILE_FORMAT;
+    }
+    ++pIndex->nEntries;
+  }
+
+  return CUE_SUCCESS;
+}
+
+/*------------------------------------------------------------------------*/
+/** Hashes the names of a suite or test record (FNV-1a). */
+static unsigned int hash_names(const char* szSuite, const char* szTest)
+{
+  unsigned int uiHash = 2166136261u;
+  const unsigned char* pPos;
+
+  for (pPos = (const unsigned char*)szSuite ; '\0' != *pPos ; ++pPos) {
+    uiHash = (uiHash ^ *pPos) * 16777619u;
+  }
+  if (NULL != szTest) {
+    uiHash = (uiHash ^ 0xFFu) * 16777619u;
+    for (pPos = (const unsigned char*)szTest ; '\0' != *pPos ; ++pPos) {
+      uiHash = (uiHash ^ *pPos) * 16777619u;
+    }
+  }
+  return uiHash;
+}
+
+/*------------------------------------------------------------------------*/
+/** Checks whether an entry is the record of a suite or test. */
+static CU_BOOL entry_matches(const CU_ResultIndexEntry* pEntry, const char* szSuite, const char* szTest)
+{
+  if (0 != strcmp(pEntry->szSuite, szSuite)) {
+    return CU_FALSE;
+  }
+  if (NULL == szTest) {
+    return (NULL == pEntry->szTest) ? CU_TRUE : CU_FALSE;
+  }
+  return ((NULL != pEntry->szTest) && (0 == strcmp(pEntry->szTest, szTest))) ? CU_TRUE : CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Builds the hash table of an index, holding the first entry of each
+ *  suite or test.
+ *  @return CU_FALSE if out of memory.
+ */
+static CU_BOOL build_hash(CU_pResultIndex pIndex)
+{
+  unsigned int nSlots = 16;
+  unsigned int uiEntry;
+  unsigned int uiSlot;
+  const CU_ResultIndexEntry* pEntry;
+
+  while (nSlots < 2 * pIndex->nEntries) {
+    nSlots *= 2;
+  }
+  pIndex->pSlots = (unsigned int*)CU_CALLOC(nSlots, sizeof(unsigned int));
+  if (NULL == pIndex->pSlots) {
+    return CU_FALSE;
+  }
+  pIndex->nSlots = nSlots;
+
+  for (uiEntry = 0 ; uiEntry < pIndex->nEntries ; ++uiEntry) {
+    pEntry = &pIndex->pEntries[uiEntry];
+    uiSlot = hash_names(pEntry->szSuite, pEntry->szTest) & (nSlots - 1);
+    while ((0 != pIndex->pSlots[uiSlot]) &&
+           (CU_FALSE == entry_matches(&pIndex->pEntries[pIndex->pSlots[uiSlot] - 1],
+                                      pEntry->szSuite, pEntry->szTest))) {
+      uiSlot = (uiSlot + 1) & (nSlots - 1);
+    }
+    if (0 == pIndex->pSlots[uiSlot]) {
+      pIndex->pSlots[uiSlot] = uiEntry + 1;
+    }
+  }
+  return CU_TRUE;
+}
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_pResultIndexWriter CU_result_index_writer_create(void)
+{
+  CU_pResultIndexWriter pWriter = (CU_pResultIndexWriter)CU_MALLOC(sizeof(CU_ResultIndexWriter));
+
+  if (NULL != pWriter) {
+    pWriter->pText = NULL;
+    pWriter->szLength = 0;
+    pWriter->szCapacity = 0;
+    pWriter->bFailed = CU_FALSE;
+  }
+  return pWriter;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_result_index_writer_destroy(CU_pResultIndexWriter pWriter)
+{
+  if (NULL != pWriter) {
+    if (NULL != pWriter->pText) {
+      CU_FREE(pWriter->pText);
+    }
+    CU_FREE(pWriter);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+void CU_result_index_add(CU_pResultIndexWriter pWriter, CU_ResultIndexKind kind,
+                         const char* szSuite, const char* szTest,
+                         unsigned long ulOffset, unsigned long ulLength)
+{
+  size_t szNeeded;
+  size_t szCapacity;
+  char* pText;
+
+  assert(NULL != szSuite);
+
+  if ((NULL == pWriter) || (CU_FALSE != pWriter->bFailed)) {
+    return;
+  }
+
+  /* kind, two numbers, names escaped at worst as %XX, separators, newline and NUL */
+  szNeeded = pWriter->szLength + 2 + 2 * MAX_NUMBER_LENGTH + 3 * strlen(szSuite) + 2;
+  if (NULL != szTest) {
+    szNeeded += 1 + 3 * strlen(szTest);
+  }
+  if (szNeeded > pWriter->szCapacity) {
+    szCapacity = (0 != pWriter->szCapacity) ? pWriter->szCapacity : 4096;
+    while (szCapacity < szNeeded) {
+      szCapacity *= 2;
+    }
+    pText = (char*)CU_REALLOC(pWriter->pText, szCapacity);
+    if (NULL == pText) {
+      pWriter->bFailed = CU_TRUE;
+      return;
+    }
+    pWriter->pText = pText;
+    pWriter->szCapacity = szCapacity;
+  }
+
+  pWriter->szLength += (size_t)sprintf(pWriter->pText + pWriter->szLength,
+                                       "%c %lu %lu ", (char)kind, ulOffset, ulLength);
+  append_name(pWriter, szSuite);
+  if (NULL != szTest) {
+    pWriter->pText[pWriter->szLength++] = ' ';
+    append_name(pWriter, szTest);
+  }
+  pWriter->pText[pWriter->szLength++] = '\n';
+}
+
+/*------------------------------------------------------------------------*/
+void CU_result_index_write(CU_pResultIndexWriter pWriter, FILE* pFile, unsigned long ulOffset)
+{
+  assert(NULL != pFile);
+
+  if ((NULL == pWriter) || (CU_FALSE != pWriter->bFailed)) {
+    return;
+  }
+
+  /* the index comment starts after the newline ending the report */
+  fprintf(pFile, "\n" INDEX_HEADER "%d\n", CU_RESULT_INDEX_VERSION);
+  if (0 < pWriter->szLength) {
+    fwrite(pWriter->pText, 1, pWriter->szLength, pFile);
+  }
+  fprintf(pFile, INDEX_END TRAILER_PREFIX "%020lu" TRAILER_SUFFIX, ulOffset + 1);
+}
+
+/*------------------------------------------------------------------------*/
+CU_pResultIndex CU_result_index_open(const char* szFilename)
+{
+  CU_pResultIndex pIndex;
+  char szTrailer[TRAILER_LENGTH + 1];
+  char* pPos;
+  char* pEnd;
+  long lTrailer;
+  unsigned long ulOffset;
+  size_t szLength;
+  CU_ErrorCode error = CUE_SUCCESS;
+
+  assert(NULL != szFilename);
+
+  pIndex = (CU_pResultIndex)CU_MALLOC(sizeof(CU_ResultIndex));
+  if (NULL == pIndex) {
+    CU_set_error(CUE_NOMEMORY);
+    return NULL;
+  }
+  pIndex->pText = NULL;
+  pIndex->pEntries = NULL;
+  pIndex->nEntries = 0;
+  pIndex->pSlots = NULL;
+  pIndex->nSlots = 0;
+
+  if (NULL == (pIndex->pFile = fopen(szFilename, "rb"))) {
+    CU_FREE(pIndex);
+    CU_set_error(CUE_FOPEN_FAILED);
+    return NULL;
+  }
+
+  /* the last line locates the index comment */
+  if ((0 != fseek(pIndex->pFile, -(long)TRAILER_LENGTH, SEEK_END)) ||
+      (0 > (lTrailer = ftell(pIndex->pFile)))) {
+    error = CUE_BAD_FILE_FORMAT;
+  }
+  else if (TRAILER_LENGTH != fread(szTrailer, 1, TRAILER_LENGTH, pIndex->pFile)) {
+    error = CUE_READ_ERROR;
+  }
+  else {
+    szTrailer[TRAILER_LENGTH] = '\0';
+    pPos = szTrailer + sizeof(TRAILER_PREFIX) - 1;
+    if ((0 != strncmp(szTrailer, TRAILER_PREFIX, sizeof(TRAILER_PREFIX) - 1)) ||
+        (0 != strcmp(pPos + TRAILER_DIGITS, TRAILER_SUFFIX))) {
+      error = CUE_BAD_FILE_FORMAT;
+    }
+    else {
+      pPos[TRAILER_DIGITS] = ' ';
+      if ((CU_FALSE == parse_number(&pPos, &ulOffset)) || (ulOffset >= (unsigned long)lTrailer)) {
+        error = CUE_BAD_FILE_FORMAT;
+      }
+    }
+  }
+
+  /* read the index comment */
+  if (CUE_SUCCESS == error) {
+    szLength = (size_t)((unsigned long)lTrailer - ulOffset);
+    if (NULL == (pIndex->pText = (char*)CU_MALLOC(szLength + 1))) {
+      error = CUE_NOMEMORY;
+    }
+    else if ((0 != fseek(pIndex->pFile, (long)ulOffset, SEEK_SET)) ||
+             (szLength != fread(pIndex->pText, 1, szLength, pIndex->pFile))) {
+      error = CUE_READ_ERROR;
+    }
+    else {
+      pIndex->pText[szLength] = '\0';
+      pPos = pIndex->pText + sizeof(INDEX_HEADER) - 1;
+      pEnd = pIndex->pText + szLength - (sizeof(INDEX_END) - 1);
+      if ((szLength < sizeof(INDEX_HEADER) - 1 + sizeof(INDEX_END) - 1) ||
+          (0 != strncmp(pIndex->pText, INDEX_HEADER, sizeof(INDEX_HEADER) - 1)) ||
+          (CU_RESULT_INDEX_VERSION != strtol(pPos, &pPos, 10)) || ('\n' != *pPos) ||
+          (pPos >= pEnd) || (0 != strcmp(pEnd, INDEX_END))) {
+        error = CUE_BAD_FILE_FORMAT;
+      }
+      else {
+        error = parse_entries(pIndex, pPos + 1, pEnd, ulOffset);
+      }
+    }
+  }
+
+  if (CUE_SUCCESS != error) {
+    CU_result_index_close(pIndex);
+    pIndex = NULL;
+  }
+  CU_set_error(error);
+  return pIndex;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_result_index_close(CU_pResultIndex pIndex)
+{
+  if (NULL != pIndex) {
+    fclose(pIndex->pFile);
+    if (NULL != pIndex->pText) {
+      CU_FREE(pIndex->pText);
+    }
+    if (NULL != pIndex->pEntries) {
+      CU_FREE(pIndex->pEntries);
+    }
+    if (NULL != pIndex->pSlots) {
+      CU_FREE(pIndex->pSlots);
+    }
+    CU_FREE(pIndex);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_result_index_count(CU_pResultIndex pIndex)
+{
+  assert(NULL != pIndex);
+  return pIndex->nEntries;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_ResultIndexEntry* CU_result_index_entry(CU_pResultIndex pIndex, unsigned int uiEntry)
+{
+  assert(NULL != pIndex);
+  return (uiEntry < pIndex->nEntries) ? &pIndex->pEntries[uiEntry] : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_ResultIndexEntry* CU_result_index_find(CU_pResultIndex pIndex,
+                                                const char* szSuite, const char* szTest)
+{
+  unsigned int uiSlot;
+  const CU_ResultIndexEntry* pEntry;
+
+  assert(NULL != pIndex);
+  assert(NULL != szSuite);
+
+  if ((0 == pIndex->nSlots) && (CU_FALSE == build_hash(pIndex))) {
+    CU_set_error(CUE_NOMEMORY);
+    return NULL;
+  }
+
+  uiSlot = hash_names(szSuite, szTest) & (pIndex->nSlots - 1);
+  while (0 != pIndex->pSlots[uiSlot]) {
+    pEntry = &pIndex->pEntries[pIndex->pSlots[uiSlot] - 1];
+    if (CU_FALSE != entry_matches(pEntry, szSuite, szTest)) {
+      return pEntry;
+    }
+    uiSlot = (uiSlot + 1) & (pIndex->nSlots - 1);
+  }
+  return NULL;
+}
+
+/*------------------------------------------------------------------------*/
+char* CU_result_index_read(CU_pResultIndex pIndex, const CU_ResultIndexEntry* pEntry)
+{
+  char* szRecord;
+
+  assert(NULL != pIndex);
+  assert(NULL != pEntry);
+
+  if (NULL == (szRecord = (char*)CU_MALLOC(pEntry->ulLength + 1))) {
+    CU_set_error(CUE_NOMEMORY);
+    return NULL;
+  }
+  if ((0 != fseek(pIndex->pFile, (long)pEntry->ulOffset, SEEK_SET)) ||
+      (pEntry->ulLength != fread(szRecord, 1, pEntry->ulLength, pIndex->pFile))) {
+    CU_FREE(szRecord);
+    CU_set_error(CUE_READ_ERROR);
+    return NULL;
+  }
+  szRecord[pEntry->ulLength] = '\0';
+  CU_set_error(CUE_SUCCESS);
+  return szRecord;
+}
+/** @} */
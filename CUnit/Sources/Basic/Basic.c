@@ -27,6 +27,12 @@
  *  30-Apr-2005   Added notification of suite cleanup failure.  (JDS)
  *
  *  02-May-2006   Added internationalization hooks.  (JDS)
+ *
+ *  18-Oct-2026   Added load test summary to verbose output.  (AGT)
+ *
+ *  18-Oct-2026   Added soak test summary to verbose output.  (AGT)
+ *
+ *  18-Oct-2026   Added shard of sharded runs to output.  (AGT)
  */
 
 /** @file
@@ -47,6 +53,7 @@
 #include "Util.h"
 #include "TestRun.h"
 #include "Basic.h"
+#include "Shard.h"
 #include "CUnit_intl.h"
 
 /*=================================================================
@@ -70,6 +77,9 @@ static void basic_test_complete_message_handler(const CU_pTest pTest, const CU_p
 static void basic_all_tests_complete_message_handler(const CU_pFailureRecord pFailure);
 static void basic_suite_init_failure_message_handler(const CU_pSuite pSuite);
 static void basic_suite_cleanup_failure_message_handler(const CU_pSuite pSuite);
+static void basic_print_load_summary(const CU_pTest pTest);
+static void basic_print_soak_summary(const CU_pTest pTest);
+static void basic_print_shard(void);
 
 /*=================================================================
  *  Public Interface functions
@@ -192,6 +202,7 @@ static CU_ErrorCode basic_run_all_tests(CU_pTestRegistry pRegistry)
 
   if (NULL != pRegistry)
     pOldRegistry = CU_set_registry(pRegistry);
+  basic_print_shard();
   result = CU_run_all_tests();
   if (NULL != pRegistry)
     CU_set_registry(pOldRegistry);
@@ -207,9 +218,20 @@ static CU_ErrorCode basic_run_all_tests(CU_pTestRegistry pRegistry)
 static CU_ErrorCode basic_run_suite(CU_pSuite pSuite)
 {
   f_pRunningSuite = NULL;
+  basic_print_shard();
   return CU_run_suite(pSuite);
 }
 
+/*------------------------------------------------------------------------*/
+/** Prints the shard to be run, if the run is sharded (see Shard.h). */
+static void basic_print_shard(void)
+{
+  unsigned int uiTotal = CU_get_shard_total();
+
+  if ((CU_BRM_SILENT != f_run_mode) && (1 < uiTotal))
+    fprintf(stdout, _("\nRunning shard %u of %u."), CU_get_shard_index() + 1, uiTotal);
+}
+
 /*------------------------------------------------------------------------*/
 /** Runs a single test for the specified suite within
  *  the console interface.
@@ -267,12 +289,16 @@ static void basic_test_complete_message_handler(const CU_pTest pTest,
   if (NULL == pFailure) {
     if (CU_BRM_VERBOSE == f_run_mode) {
       fprintf(stdout, _("passed"));
+      basic_print_load_summary(pTest);
+      basic_print_soak_summary(pTest);
     }
   }
   else {
     switch (f_run_mode) {
       case CU_BRM_VERBOSE:
         fprintf(stdout, _("FAILED"));
+        basic_print_load_summary(pTest);
+        basic_print_soak_summary(pTest);
         break;
       case CU_BRM_NORMAL:
         assert(NULL != pSuite->pName);
@@ -293,6 +319,43 @@ static void basic_test_complete_message_handler(const CU_pTest pTest,
   }
 }
 
+/*------------------------------------------------------------------------*/
+/** Prints the rate and latency summary of a load test (verbose mode).
+ *  Does nothing for regular tests.
+ *  @param pTest The test that completed (non-NULL).
+ */
+static void basic_print_load_summary(const CU_pTest pTest)
+{
+  const CU_LoadResult* pResult = CU_get_load_result(pTest);
+
+  if ((NULL != pResult) && (0 != pResult->ulRequests)) {
+    fprintf(stdout, _(" (%.1f/%.1f req/s, p50 %.3f ms, p99 %.3f ms, max %.3f ms)"),
+            pResult->dAchievedRate, pResult->dTargetRate,
+            CU_get_load_percentile(pResult, 50.0) * 1000.0,
+            CU_get_load_percentile(pResult, 99.0) * 1000.0,
+            pResult->dMaxLatency * 1000.0);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Prints the iteration count and resource growth of a soak test
+ *  (verbose mode).  Does nothing for regular tests.
+ *  @param pTest The test that completed (non-NULL).
+ */
+static void basic_print_soak_summary(const CU_pTest pTest)
+{
+  const CU_SoakResult* pResult = CU_get_soak_result(pTest);
+
+  if ((NULL != pResult) && (0 != pResult->ulIterations)) {
+    fprintf(stdout, _(" (%lu iterations in %.1f s, rss %+.0f KiB, heap %+.0f KiB, fds %+.0f, threads %+.0f)"),
+            pResult->ulIterations, pResult->dElapsedTime,
+            (pResult->adLast[CU_SOAK_RSS] - pResult->adFirst[CU_SOAK_RSS]) / 1024.0,
+            (pResult->adLast[CU_SOAK_HEAP] - pResult->adFirst[CU_SOAK_HEAP]) / 1024.0,
+            pResult->adLast[CU_SOAK_FDS] - pResult->adFirst[CU_SOAK_FDS],
+            pResult->adLast[CU_SOAK_THREADS] - pResult->adFirst[CU_SOAK_THREADS]);
+  }
+}
+
 /*------------------------------------------------------------------------*/
 /** Handler function called at completion of all tests in a suite.
  *  @param pFailure Pointer to the test failure record list.
@@ -41,6 +41,8 @@
  *                without needing to <ENTER>, like curses.  (JDS)
  *
  *  02-May-2006   Added internationalization hooks.  (JDS)
+ *
+ *  18-Oct-2026   Added fail-fast option.  (AGT)
  */
 
 /** @file
@@ -312,12 +314,16 @@ static CU_STATUS console_set_options_run(void)
   int chChoice;
   CU_STATUS eStatus = CU_STATUS_CONTINUE;
   char szTemp[256];
+  long lValue;
 
   while (CU_STATUS_CONTINUE == eStatus) {
     fprintf(stdout, "\n%s\n",
                     _("***************** CUNIT CONSOLE - OPTIONS **************************"));
     fprintf(stdout, _("   1 - Inactive suites/tests treated as runtime failures     %s"),
                     (CU_FALSE != CU_get_fail_on_inactive()) ? _("Yes") : _("No"));
+    fprintf(stdout, "\n");
+    fprintf(stdout, _("   2 - Failed tests stopping a run (0 = run all tests)      %u"),
+                    CU_get_fail_fast());
     fprintf(stdout, "\n********************************************************************\n");
     fprintf(stdout, "%s",
                     _("Enter number of option to change : "));
@@ -329,6 +335,13 @@ static CU_STATUS console_set_options_run(void)
         CU_set_fail_on_inactive((CU_FALSE == CU_get_fail_on_inactive()) ? CU_TRUE : CU_FALSE);
         break;
 
+      case '2':
+        fprintf(stdout, "%s", _("Enter number of failed tests stopping a run : "));
+        fgets(szTemp, 256, stdin);
+        lValue = atol(szTemp);
+        CU_set_fail_fast((0 < lValue) ? (unsigned int)lValue : 0);
+        break;
+
       default:
         eStatus = CU_STATUS_MOVE_UP;
         break;
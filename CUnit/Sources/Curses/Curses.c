@@ -37,6 +37,11 @@
  *                Option menu added.  (JDS)
  *
  *  02-May-2006   Added internationalization hooks.  (JDS)
+ *
+ *  18-Oct-2026   Run-time window updates are coalesced and drawn at a capped
+ *                frame rate.  Long lists use a virtual details pad. (AGT)
+ *
+ *  18-Oct-2026   Added fail-fast option and run summary line. (AGT)
  */
 
 /** @file
@@ -101,6 +106,9 @@ typedef struct
   WINDOW* pOptionsWin;        /**< Options window. */
 } APPWINDOWS;
 
+/** Function producing line uiLine of a virtual pad into szLine. */
+typedef void (*PAD_LINE_FUNC)(unsigned int uiLine, char* szLine, size_t nLength);
+
 /** Window elements. */
 typedef struct
 {
@@ -113,13 +121,35 @@ typedef struct
   unsigned int uiWinTop;      /**< Top position of containing window. */
   unsigned int uiWinRows;     /**< Number of rows in containing window. */
   unsigned int uiWinColumns;  /**< Number of columns in containing window. */
+  unsigned int uiPadRows;     /**< Number of rows allocated for the pad. */
+  PAD_LINE_FUNC pLineFunc;    /**< Line source of a virtual pad (NULL if the pad holds all rows). */
 } APPPAD;
 
+/** Windows to be redrawn at the next frame. */
+typedef enum
+{
+  DIRTY_PROGRESS    = 0x01,   /**< Progress bar window. */
+  DIRTY_SUMMARY     = 0x02,   /**< Summary window. */
+  DIRTY_RUN_SUMMARY = 0x04,   /**< Run Summary window. */
+  DIRTY_DETAILS     = 0x08    /**< Details window. */
+} DIRTY_FLAGS;
+
+/** Position of the last list element visited by a virtual pad line source. */
+typedef struct
+{
+  CU_pSuite         pSuite;   /**< Current suite (suite list). */
+  CU_pTest          pTest;    /**< Current test (test list). */
+  CU_pFailureRecord pFailure; /**< Current failure record (failure list). */
+  unsigned int      uiIndex;  /**< Index of the current element. */
+} LIST_CURSOR;
+
 /*
  * Constants definitions
  */
 /** Standard string length. */
 #define STRING_LENGTH 128
+/** Minimum interval in seconds between redraws during a test run (30 Hz). */
+#define FRAME_INTERVAL (1.0 / 30)
 /** String holding main menu run options. */
 static const char* MAIN_OPTIONS =
     N_("(R)un  (S)elect  (L)ist  (A)ctivate  (F)ailures  (O)ptions  (H)elp  (Q)uit");
@@ -165,7 +195,16 @@ static size_t f_no_width = 0;
 /** Pointers to curses interface windows. */
 static APPWINDOWS application_windows = {NULL, NULL, NULL, NULL, NULL, NULL, NULL};
 /** Details window definition. */
-static APPPAD  details_pad = {NULL, 0, 0, 0, 0, 0, 0, 0, 0};
+static APPPAD  details_pad = {NULL, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
+
+static unsigned int f_uiDirty = 0;              /**< Windows awaiting redraw (DIRTY_FLAGS). */
+static double       f_dLastFrame = 0.0;         /**< Time of the last redraw during a run. */
+
+static CU_pTestRegistry f_pListRegistry = NULL; /**< Registry shown by the suite list. */
+static CU_pSuite        f_pListSuite = NULL;    /**< Suite shown by the test list. */
+static LIST_CURSOR      f_listCursor = {NULL, NULL, NULL, 0}; /**< Cursor of the shown list. */
+static int              f_suiteWidth[6];        /**< Column widths of the suite list. */
+static int              f_testWidth[3];         /**< Column widths of the test list. */
 
 /*=================================================================
  *  Static function forward declarations
@@ -182,7 +221,16 @@ static void refresh_details_window(void);
 static void refresh_options_window(void);
 static void show_detail_window_message(const char* msg);
 
+static void draw_progress_window(void);
+static void draw_summary_window(void);
+static void draw_run_summary_window(void);
+static void draw_details_window(void);
+static void update_windows(unsigned int uiDirty, bool bForce);
+
 static bool create_pad(APPPAD* pPad, WINDOW* pParent, unsigned int uiRows, unsigned int uiCols);
+static bool create_virtual_pad(APPPAD* pPad, WINDOW* pParent, unsigned int uiRows,
+                               unsigned int uiCols, PAD_LINE_FUNC pLineFunc);
+static void fill_virtual_pad(APPPAD* pPad);
 static void scroll_window(int nCommand, APPPAD* pPad, void (*parent_refresh)(void));
 
 static bool test_initialize(void);
@@ -208,6 +256,9 @@ static void curses_suite_init_failure_message_handler(const CU_pSuite pSuite);
 static void list_suites(CU_pTestRegistry pRegistry);
 static void list_tests(CU_pSuite pSuite);
 static void show_failures(void);
+static void suite_list_line(unsigned int uiLine, char* szLine, size_t nLength);
+static void test_list_line(unsigned int uiLine, char* szLine, size_t nLength);
+static void failure_list_line(unsigned int uiLine, char* szLine, size_t nLength);
 static void show_registry_level_help(void);
 static void show_suite_level_help(CU_pSuite pSuite);
 
@@ -402,16 +453,32 @@ static void refresh_title_window(void)
 /*------------------------------------------------------------------------*/
 /** Refresh the progress bar window. */
 static void refresh_progress_window(void)
+{
+  draw_progress_window();
+  doupdate();
+}
+
+/*------------------------------------------------------------------------*/
+/** Draw the progress bar window without updating the screen. */
+static void draw_progress_window(void)
 {
   wattrset(application_windows.pProgressWin, A_BOLD);
   mvwprintw(application_windows.pProgressWin, 0, 1, (char *)_(f_szProgress));
   show_progress_bar();
-  wrefresh(application_windows.pProgressWin);
+  wnoutrefresh(application_windows.pProgressWin);
 }
 
 /*------------------------------------------------------------------------*/
 /** Refresh the summary window. */
 static void refresh_summary_window(void)
+{
+  draw_summary_window();
+  doupdate();
+}
+
+/*------------------------------------------------------------------------*/
+/** Draw the summary window without updating the screen. */
+static void draw_summary_window(void)
 {
   char szTemp[STRING_LENGTH];
 
@@ -421,7 +488,7 @@ static void refresh_summary_window(void)
                                   f_uiTestsRun - f_uiTestsRunSuccessful);
   werase(application_windows.pSummaryWin);
   mvwprintw(application_windows.pSummaryWin, 0, 1, "%s", szTemp);
-  wrefresh(application_windows.pSummaryWin);
+  wnoutrefresh(application_windows.pSummaryWin);
 }
 
 /*------------------------------------------------------------------------*/
@@ -443,6 +510,14 @@ static void show_detail_window_message(const char *msg)
 /*------------------------------------------------------------------------*/
 /** Refresh the run summary window. */
 static void refresh_run_summary_window(void)
+{
+  draw_run_summary_window();
+  doupdate();
+}
+
+/*------------------------------------------------------------------------*/
+/** Draw the run summary window without updating the screen. */
+static void draw_run_summary_window(void)
 {
   const char* szRunSummary = N_("Running test  \'%s\' of Suite \'%s\'");
   char szTemp[STRING_LENGTH];
@@ -458,12 +533,23 @@ static void refresh_run_summary_window(void)
   }
   werase(application_windows.pRunSummaryWin);
   mvwprintw(application_windows.pRunSummaryWin, 0, 1, "%s", szTemp);
-  wrefresh(application_windows.pRunSummaryWin);
+  wnoutrefresh(application_windows.pRunSummaryWin);
 }
 
 /*------------------------------------------------------------------------*/
 /** Refresh the details window. */
 static void refresh_details_window(void)
+{
+  draw_details_window();
+  doupdate();
+}
+
+/*------------------------------------------------------------------------*/
+/** Draw the details window and its pad without updating the screen.
+ * A virtual pad only holds the visible rows, which are regenerated
+ * from its line source for the current scroll position.
+ */
+static void draw_details_window(void)
 {
   const char* szDetailsTitle = N_(" Details Window ");
 
@@ -471,14 +557,60 @@ static void refresh_details_window(void)
   mvwprintw(application_windows.pDetailsWin, 0,
             f_nLeft + (f_nWidth - strlen(_(szDetailsTitle)))/2, "%s", _(szDetailsTitle));
   scrollok(application_windows.pDetailsWin, CU_TRUE);
-  wrefresh(application_windows.pDetailsWin);
+  wnoutrefresh(application_windows.pDetailsWin);
 
   if (details_pad.pPad) {
-    prefresh(details_pad.pPad, details_pad.uiPadRow, details_pad.uiPadCol,
-             details_pad.uiWinTop, details_pad.uiWinLeft,
-             details_pad.uiWinTop + details_pad.uiWinRows,
-             details_pad.uiWinLeft + details_pad.uiWinColumns);
+    if (NULL != details_pad.pLineFunc) {
+      fill_virtual_pad(&details_pad);
+    }
+    pnoutrefresh(details_pad.pPad,
+                 (NULL != details_pad.pLineFunc) ? 0 : details_pad.uiPadRow,
+                 details_pad.uiPadCol,
+                 details_pad.uiWinTop, details_pad.uiWinLeft,
+                 details_pad.uiWinTop + details_pad.uiWinRows,
+                 details_pad.uiWinLeft + details_pad.uiWinColumns);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Redraw windows changed during a test run.
+ * The windows in uiDirty are added to the pending set, which is drawn
+ * with a single screen update at most once per FRAME_INTERVAL so that
+ * runs of many short tests are not bound by terminal output.
+ * @param uiDirty Windows that have changed (DIRTY_FLAGS).
+ * @param bForce  If true, draw the pending windows now regardless
+ *                of the frame rate (used at the end of a run).
+ */
+static void update_windows(unsigned int uiDirty, bool bForce)
+{
+  double dNow;
+
+  f_uiDirty |= uiDirty;
+  if (0 == f_uiDirty) {
+    return;
+  }
+
+  dNow = CU_get_monotonic_time();
+  if (!bForce && ((dNow - f_dLastFrame) < FRAME_INTERVAL)) {
+    return;
+  }
+
+  if (0 != (f_uiDirty & DIRTY_PROGRESS)) {
+    draw_progress_window();
+  }
+  if (0 != (f_uiDirty & DIRTY_SUMMARY)) {
+    draw_summary_window();
+  }
+  if (0 != (f_uiDirty & DIRTY_RUN_SUMMARY)) {
+    draw_run_summary_window();
   }
+  if (0 != (f_uiDirty & DIRTY_DETAILS)) {
+    draw_details_window();
+  }
+  doupdate();
+
+  f_uiDirty = 0;
+  f_dLastFrame = dNow;
 }
 
 /*------------------------------------------------------------------------*/
@@ -911,6 +1043,13 @@ static bool create_pad(APPPAD* pPad, WINDOW* pParent, unsigned int uiRows,
   pPad->uiWinTop = application_windows.pDetailsWin->_begy + 1;
   pPad->uiWinColumns = application_windows.pDetailsWin->_maxx - 2;
   pPad->uiWinRows = application_windows.pDetailsWin->_maxy - 2;
+  pPad->uiPadRows = uiRows;
+  pPad->pLineFunc = NULL;
+
+  f_listCursor.pSuite = NULL;
+  f_listCursor.pTest = NULL;
+  f_listCursor.pFailure = NULL;
+  f_listCursor.uiIndex = 0;
 
   bStatus = true;
 
@@ -918,6 +1057,54 @@ newpad_fail:
   return bStatus;
 }
 
+/*------------------------------------------------------------------------*/
+/** Create a virtual pad having specified parent and dimensions.
+ * Only the rows visible in the parent window are allocated.  The
+ * content is produced by pLineFunc each time the pad is drawn, so
+ * the cost of a list does not depend on its length.
+ * @param pPad      Pointer to the new window.
+ * @param pParent   Parent window.
+ * @param uiRows    Number of rows in the content.
+ * @param uiCols    Number of columns for new window.
+ * @param pLineFunc Function producing the content rows (non-NULL).
+ */
+static bool create_virtual_pad(APPPAD* pPad, WINDOW* pParent, unsigned int uiRows,
+    unsigned int uiCols, PAD_LINE_FUNC pLineFunc)
+{
+  unsigned int uiVisibleRows;
+
+  assert(pParent);
+  assert(pLineFunc);
+
+  uiVisibleRows = (pParent->_maxy > 2) ? (unsigned int)(pParent->_maxy - 1) : 1;
+  if (!create_pad(pPad, pParent, CU_MIN(uiRows, uiVisibleRows), uiCols)) {
+    return false;
+  }
+
+  pPad->uiRows = uiRows;
+  pPad->pLineFunc = pLineFunc;
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+/** Write the rows of a virtual pad visible at its scroll position.
+ * @param pPad The virtual pad to fill (non-NULL).
+ */
+static void fill_virtual_pad(APPPAD* pPad)
+{
+  char szLine[STRING_LENGTH];
+  unsigned int i;
+
+  assert(NULL != pPad->pLineFunc);
+
+  werase(pPad->pPad);
+  for (i = 0 ; (i < pPad->uiPadRows) && (pPad->uiPadRow + i < pPad->uiRows) ; i++) {
+    szLine[0] = '\0';
+    (*pPad->pLineFunc)(pPad->uiPadRow + i, szLine, sizeof(szLine));
+    mvwprintw(pPad->pPad, i, 0, "%s", szLine);
+  }
+}
+
 /*------------------------------------------------------------------------*/
 /** Prints help text for registry level to detail window. */
 static void show_registry_level_help(void)
@@ -972,12 +1159,6 @@ static void show_suite_level_help(CU_pSuite pSuite)
  */
 static void list_suites(CU_pTestRegistry pRegistry)
 {
-
-  CU_pSuite pCurSuite = NULL;
-  int i;
-  char szTemp[STRING_LENGTH];
-  static size_t width[6];
-
   if (NULL == pRegistry) {
     pRegistry = CU_get_registry();
   }
@@ -991,66 +1172,90 @@ static void list_suites(CU_pTestRegistry pRegistry)
 
   assert(pRegistry->pSuite);
 
-  if (!create_pad(&details_pad, application_windows.pDetailsWin, pRegistry->uiNumberOfSuites + 4, 256)) {
+  if (!create_virtual_pad(&details_pad, application_windows.pDetailsWin,
+                          pRegistry->uiNumberOfSuites + 4, 256, suite_list_line)) {
     return;
   }
+  f_pListRegistry = pRegistry;
 
   /* only need to calculate formatting widths once */
-  if (0 == width[0]) {
-    width[0] = CU_number_width(pRegistry->uiNumberOfSuites) + 1;
-    width[1] = 34;
-    width[2] = CU_MAX(strlen(_("Init?")), CU_MAX(f_yes_width, f_no_width)) + 1;
-    width[3] = CU_MAX(strlen(_("Cleanup?")), CU_MAX(f_yes_width, f_no_width)) + 1;
-    width[4] = CU_MAX(strlen(_("#Tests")), CU_number_width(pRegistry->uiNumberOfTests) + 1) + 1;
-    width[5] = CU_MAX(strlen(_("Active?")), CU_MAX(f_yes_width, f_no_width)) + 1;
-  }
-
-  snprintf(szTemp, STRING_LENGTH, "%*s  %-*s%*s%*s%*s%*s",
-                                  width[0], _("#"),
-                                  width[1], _("Suite Name"),
-                                  width[2], _("Init?"),
-                                  width[3], _("Cleanup?"),
-                                  width[4], _("#Tests"),
-                                  width[5], _("Active?"));
-  mvwprintw(details_pad.pPad, 0, 0, "%s", szTemp);
-
-  for (i = 0, pCurSuite = pRegistry->pSuite; pCurSuite; pCurSuite = pCurSuite->pNext, i++) {
-    assert(NULL != pCurSuite->pName);
-    snprintf(szTemp, STRING_LENGTH, "%*d. %-*.*s%*s%*s%*u%*s",
-             width[0], i+1,
-             width[1], width[1] - 1, pCurSuite->pName,
-             width[2]-1, (NULL != pCurSuite->pInitializeFunc) ? _("Yes") : _("No"),
-             width[3],   (NULL != pCurSuite->pCleanupFunc) ? _("Yes") : _("No"),
-             width[4],   pCurSuite->uiNumberOfTests,
-             width[5],   (CU_FALSE != pCurSuite->fActive) ? _("Yes") : _("No"));
-    mvwprintw(details_pad.pPad, i + 2, 0, "%s", szTemp);
-  }
-
-  mvwprintw(details_pad.pPad, i + 2, 0, "%s",
-            "---------------------------------------------------------------------------");
-  mvwprintw(details_pad.pPad, i + 3, 0,
-            _("Total Number of Suites : %-u"), pRegistry->uiNumberOfSuites);
+  if (0 == f_suiteWidth[0]) {
+    f_suiteWidth[0] = CU_number_width(pRegistry->uiNumberOfSuites) + 1;
+    f_suiteWidth[1] = 34;
+    f_suiteWidth[2] = CU_MAX(strlen(_("Init?")), CU_MAX(f_yes_width, f_no_width)) + 1;
+    f_suiteWidth[3] = CU_MAX(strlen(_("Cleanup?")), CU_MAX(f_yes_width, f_no_width)) + 1;
+    f_suiteWidth[4] = CU_MAX(strlen(_("#Tests")), CU_number_width(pRegistry->uiNumberOfTests) + 1) + 1;
+    f_suiteWidth[5] = CU_MAX(strlen(_("Active?")), CU_MAX(f_yes_width, f_no_width)) + 1;
+  }
+
   refresh_details_window();
 }
 
+/*------------------------------------------------------------------------*/
+/** Produce a line of the suite list shown by list_suites().
+ *  @param uiLine  Index of the line to produce.
+ *  @param szLine  Buffer to receive the line.
+ *  @param nLength Size of szLine.
+ */
+static void suite_list_line(unsigned int uiLine, char* szLine, size_t nLength)
+{
+  unsigned int uiSuites = f_pListRegistry->uiNumberOfSuites;
+  CU_pSuite pCurSuite;
+
+  if (0 == uiLine) {
+    snprintf(szLine, nLength, "%*s  %-*s%*s%*s%*s%*s",
+                              f_suiteWidth[0], _("#"),
+                              f_suiteWidth[1], _("Suite Name"),
+                              f_suiteWidth[2], _("Init?"),
+                              f_suiteWidth[3], _("Cleanup?"),
+                              f_suiteWidth[4], _("#Tests"),
+                              f_suiteWidth[5], _("Active?"));
+  }
+  else if ((uiLine >= 2) && (uiLine < uiSuites + 2)) {
+    /* step the cursor from the last visited suite - rows are drawn in order */
+    if (NULL == f_listCursor.pSuite) {
+      f_listCursor.pSuite = f_pListRegistry->pSuite;
+      f_listCursor.uiIndex = 0;
+    }
+    while ((f_listCursor.uiIndex < uiLine - 2) && (NULL != f_listCursor.pSuite->pNext)) {
+      f_listCursor.pSuite = f_listCursor.pSuite->pNext;
+      ++f_listCursor.uiIndex;
+    }
+    while ((f_listCursor.uiIndex > uiLine - 2) && (NULL != f_listCursor.pSuite->pPrev)) {
+      f_listCursor.pSuite = f_listCursor.pSuite->pPrev;
+      --f_listCursor.uiIndex;
+    }
+    pCurSuite = f_listCursor.pSuite;
+
+    assert(NULL != pCurSuite->pName);
+    snprintf(szLine, nLength, "%*u. %-*.*s%*s%*s%*u%*s",
+             f_suiteWidth[0], uiLine - 1,
+             f_suiteWidth[1], f_suiteWidth[1] - 1, pCurSuite->pName,
+             f_suiteWidth[2]-1, (NULL != pCurSuite->pInitializeFunc) ? _("Yes") : _("No"),
+             f_suiteWidth[3],   (NULL != pCurSuite->pCleanupFunc) ? _("Yes") : _("No"),
+             f_suiteWidth[4],   pCurSuite->uiNumberOfTests,
+             f_suiteWidth[5],   (CU_FALSE != pCurSuite->fActive) ? _("Yes") : _("No"));
+  }
+  else if (uiLine == uiSuites + 2) {
+    snprintf(szLine, nLength, "%s",
+             "---------------------------------------------------------------------------");
+  }
+  else if (uiLine == uiSuites + 3) {
+    snprintf(szLine, nLength, _("Total Number of Suites : %-u"), uiSuites);
+  }
+}
+
 /*------------------------------------------------------------------------*/
 /** Print a list of tests contained in a specified suite to the detail window.
  *  @param pSuite  The suite to query (non-NULL).
  */
 static void list_tests(CU_pSuite pSuite)
 {
-  CU_pTest pCurTest = NULL;
-  unsigned int i;
   char szTemp[STRING_LENGTH];
-  static size_t width[3];
 
   assert(NULL != pSuite);
   assert(NULL != pSuite->pName);
 
-  if (!create_pad(&details_pad, application_windows.pDetailsWin, pSuite->uiNumberOfTests + 5, 256)) {
-    return;
-  }
-
   if (0 == pSuite->uiNumberOfTests) {
     snprintf(szTemp, STRING_LENGTH,
              _("Suite %s contains no tests."), pSuite->pName);
@@ -1060,48 +1265,78 @@ static void list_tests(CU_pSuite pSuite)
 
   assert(pSuite->pTest);
 
+  if (!create_virtual_pad(&details_pad, application_windows.pDetailsWin,
+                          pSuite->uiNumberOfTests + 5, 256, test_list_line)) {
+    return;
+  }
+  f_pListSuite = pSuite;
+
   /* only number of tests can change between calls */
-  width[0] = CU_number_width(pSuite->uiNumberOfTests) + 1;
-  if (0 == width[1]) {
-    width[1] = 34;
-    width[2] = CU_MAX(strlen(_("Active?")), CU_MAX(f_yes_width, f_no_width)) + 1;
+  f_testWidth[0] = CU_number_width(pSuite->uiNumberOfTests) + 1;
+  if (0 == f_testWidth[1]) {
+    f_testWidth[1] = 34;
+    f_testWidth[2] = CU_MAX(strlen(_("Active?")), CU_MAX(f_yes_width, f_no_width)) + 1;
   }
 
-  snprintf(szTemp, STRING_LENGTH, "%s: %s", _("Suite"), pSuite->pName);
-  mvwprintw(details_pad.pPad, 0, 0, szTemp);
+  refresh_details_window();
+}
+
+/*------------------------------------------------------------------------*/
+/** Produce a line of the test list shown by list_tests().
+ *  @param uiLine  Index of the line to produce.
+ *  @param szLine  Buffer to receive the line.
+ *  @param nLength Size of szLine.
+ */
+static void test_list_line(unsigned int uiLine, char* szLine, size_t nLength)
+{
+  unsigned int uiTests = f_pListSuite->uiNumberOfTests;
+  CU_pTest pCurTest;
 
-  snprintf(szTemp, STRING_LENGTH,
-           "%*s  %-*s%*s",
-           width[0], _("#"),
-           width[1], _("Test Name"),
-           width[2], _("Active?"));
-  mvwprintw(details_pad.pPad, 1, 0, szTemp);
+  if (0 == uiLine) {
+    snprintf(szLine, nLength, "%s: %s", _("Suite"), f_pListSuite->pName);
+  }
+  else if (1 == uiLine) {
+    snprintf(szLine, nLength,
+             "%*s  %-*s%*s",
+             f_testWidth[0], _("#"),
+             f_testWidth[1], _("Test Name"),
+             f_testWidth[2], _("Active?"));
+  }
+  else if ((uiLine >= 3) && (uiLine < uiTests + 3)) {
+    if (NULL == f_listCursor.pTest) {
+      f_listCursor.pTest = f_pListSuite->pTest;
+      f_listCursor.uiIndex = 0;
+    }
+    while ((f_listCursor.uiIndex < uiLine - 3) && (NULL != f_listCursor.pTest->pNext)) {
+      f_listCursor.pTest = f_listCursor.pTest->pNext;
+      ++f_listCursor.uiIndex;
+    }
+    while ((f_listCursor.uiIndex > uiLine - 3) && (NULL != f_listCursor.pTest->pPrev)) {
+      f_listCursor.pTest = f_listCursor.pTest->pPrev;
+      --f_listCursor.uiIndex;
+    }
+    pCurTest = f_listCursor.pTest;
 
-  for (i = 0, pCurTest = pSuite->pTest ;
-       NULL != pCurTest ;
-       pCurTest = pCurTest->pNext, i++) {
     assert(NULL != pCurTest->pName);
-    snprintf(szTemp, STRING_LENGTH,
+    snprintf(szLine, nLength,
              "%*u. %-*.*s%*s",
-             width[0], i + 1,
-             width[1], width[1]-1, pCurTest->pName,
-             width[2]-1, (CU_FALSE != pCurTest->fActive) ? _("Yes") : _("No"));
-    mvwprintw(details_pad.pPad, i + 3, 0, "%s", szTemp);
+             f_testWidth[0], uiLine - 2,
+             f_testWidth[1], f_testWidth[1]-1, pCurTest->pName,
+             f_testWidth[2]-1, (CU_FALSE != pCurTest->fActive) ? _("Yes") : _("No"));
+  }
+  else if (uiLine == uiTests + 3) {
+    snprintf(szLine, nLength, "%s",
+             "---------------------------------------------");
+  }
+  else if (uiLine == uiTests + 4) {
+    snprintf(szLine, nLength, _("Total Number of Tests : %-u"), uiTests);
   }
-
-  mvwprintw(details_pad.pPad, i + 3, 0, "%s",
-            "---------------------------------------------");
-  mvwprintw(details_pad.pPad, i + 4, 0,
-            _("Total Number of Tests : %-u"), pSuite->uiNumberOfTests);
-  refresh_details_window();
 }
 
 /*------------------------------------------------------------------------*/
 /** Display the record of test failures in the detail window. */
 static void show_failures(void)
 {
-  int i;
-  CU_pFailureRecord pFailure = CU_get_failure_list();
   unsigned int nFailures = CU_get_number_of_failure_records();
 
   if (0 == nFailures) {
@@ -1109,18 +1344,48 @@ static void show_failures(void)
     return;
   }
 
-  assert(pFailure);
+  assert(CU_get_failure_list());
 
-  if (!create_pad(&details_pad, application_windows.pDetailsWin, nFailures + 5, 256)) {
+  if (!create_virtual_pad(&details_pad, application_windows.pDetailsWin,
+                          nFailures + 5, 256, failure_list_line)) {
     return;
   }
 
-  mvwprintw(details_pad.pPad, 1, 0, "%s", _("   src_file:line# : (suite:test) : failure_condition"));
+  refresh_details_window();
+}
+
+/*------------------------------------------------------------------------*/
+/** Produce a line of the failure list shown by show_failures().
+ *  The list is read from the framework each time, so a list replaced
+ *  by a later test run is never walked through a stale pointer.
+ *  @param uiLine  Index of the line to produce.
+ *  @param szLine  Buffer to receive the line.
+ *  @param nLength Size of szLine.
+ */
+static void failure_list_line(unsigned int uiLine, char* szLine, size_t nLength)
+{
+  unsigned int nFailures = CU_get_number_of_failure_records();
+  CU_pFailureRecord pFailure;
 
-  for (i = 0 ; pFailure ; pFailure = pFailure->pNext, i++) {
-    char szTemp[STRING_LENGTH];
+  if (1 == uiLine) {
+    snprintf(szLine, nLength, "%s", _("   src_file:line# : (suite:test) : failure_condition"));
+  }
+  else if ((uiLine >= 3) && (uiLine < nFailures + 3)) {
+    if (NULL == f_listCursor.pFailure) {
+      f_listCursor.pFailure = CU_get_failure_list();
+      f_listCursor.uiIndex = 0;
+    }
+    while ((f_listCursor.uiIndex < uiLine - 3) && (NULL != f_listCursor.pFailure->pNext)) {
+      f_listCursor.pFailure = f_listCursor.pFailure->pNext;
+      ++f_listCursor.uiIndex;
+    }
+    while ((f_listCursor.uiIndex > uiLine - 3) && (NULL != f_listCursor.pFailure->pPrev)) {
+      f_listCursor.pFailure = f_listCursor.pFailure->pPrev;
+      --f_listCursor.uiIndex;
+    }
+    pFailure = f_listCursor.pFailure;
 
-    snprintf(szTemp, STRING_LENGTH, "%d. %s:%d : (%s : %s) : %s", i + 1,
+    snprintf(szLine, nLength, "%u. %s:%d : (%s : %s) : %s", uiLine - 2,
         ((NULL != pFailure->strFileName) ? pFailure->strFileName : ""),
         pFailure->uiLineNumber,
         (((NULL != pFailure->pSuite) && (NULL != pFailure->pSuite->pName))
@@ -1128,13 +1393,13 @@ static void show_failures(void)
         (((NULL != pFailure->pTest)  && (NULL != pFailure->pTest->pName))
             ? pFailure->pTest->pName : ""),
         ((NULL != pFailure->strCondition) ? pFailure->strCondition : ""));
-
-    mvwprintw(details_pad.pPad, i + 3, 0, "%s", szTemp);
   }
-
-  mvwprintw(details_pad.pPad, i + 3, 0, "%s", "=============================================");
-  mvwprintw(details_pad.pPad, i + 4, 0, _("Total Number of Failures : %-u"), nFailures);
-  refresh_details_window();
+  else if (uiLine == nFailures + 3) {
+    snprintf(szLine, nLength, "%s", "=============================================");
+  }
+  else if (uiLine == nFailures + 4) {
+    snprintf(szLine, nLength, _("Total Number of Failures : %-u"), nFailures);
+  }
 }
 
 /*------------------------------------------------------------------------*/
@@ -1148,7 +1413,7 @@ static STATUS curses_set_options_run(void)
   STATUS eStatus = CONTINUE;
   long option_num;
 
-  if (!create_pad(&details_pad, application_windows.pDetailsWin, 3, 256)) {
+  if (!create_pad(&details_pad, application_windows.pDetailsWin, 4, 256)) {
     return eStatus;
   }
 
@@ -1159,6 +1424,9 @@ static STATUS curses_set_options_run(void)
     snprintf(szTemp, STRING_LENGTH,   _("   1 - Inactive suites/tests treated as runtime failures     %s"),
                                       (CU_FALSE != CU_get_fail_on_inactive()) ? _("Yes") : _("No "));
     mvwprintw(details_pad.pPad, 2, 0, szTemp);
+    snprintf(szTemp, STRING_LENGTH,   _("   2 - Failed tests stopping a run (0 = run all tests)      %-8u"),
+                                      CU_get_fail_fast());
+    mvwprintw(details_pad.pPad, 3, 0, szTemp);
     refresh_details_window();
     read_input_string(_("Enter number of option to change : "), szTemp, STRING_LENGTH);
     option_num = atol(szTemp);
@@ -1168,6 +1436,12 @@ static STATUS curses_set_options_run(void)
         CU_set_fail_on_inactive((CU_FALSE == CU_get_fail_on_inactive()) ? CU_TRUE : CU_FALSE);
         break;
 
+      case 2:
+        read_input_string(_("Enter number of failed tests stopping a run : "), szTemp, STRING_LENGTH);
+        option_num = atol(szTemp);
+        CU_set_fail_fast((0 < option_num) ? (unsigned int)option_num : 0);
+        break;
+
       default:
         eStatus = MOVE_UP;
         break;
@@ -1245,9 +1519,9 @@ static void reset_run_parameters(void)
   f_pCurrentSuite = NULL;
   f_uiTestsRunSuccessful = f_uiTestsRun = f_uiTotalTests = f_uiTestsFailed = f_uiTestsSkipped = 0;
   f_uiTotalSuites = f_uiSuitesSkipped = 0;
-  refresh_progress_window();
-  refresh_summary_window();
-  refresh_run_summary_window();
+  /* the failure list is about to be replaced */
+  f_listCursor.pFailure = NULL;
+  update_windows(DIRTY_PROGRESS | DIRTY_SUMMARY | DIRTY_RUN_SUMMARY, true);
 }
 
 /*------------------------------------------------------------------------*/
@@ -1259,7 +1533,7 @@ static void curses_test_start_message_handler(const CU_pTest pTest, const CU_pSu
 {
   f_pCurrentTest = (CU_pTest)pTest;
   f_pCurrentSuite = (CU_pSuite)pSuite;
-  refresh_run_summary_window();
+  update_windows(DIRTY_RUN_SUMMARY, false);
 }
 
 /*------------------------------------------------------------------------*/
@@ -1285,8 +1559,7 @@ static void curses_test_complete_message_handler(const CU_pTest pTest,
     f_uiTestsRunSuccessful++;
   }
 
-  refresh_summary_window();
-  refresh_progress_window();
+  update_windows(DIRTY_SUMMARY | DIRTY_PROGRESS, false);
 }
 
 /*------------------------------------------------------------------------*/
@@ -1301,7 +1574,8 @@ static void curses_all_tests_complete_message_handler(const CU_pFailureRecord pF
   f_pCurrentTest = NULL;
   f_pCurrentSuite = NULL;
 
-  if (!create_pad(&details_pad, application_windows.pDetailsWin, 21, 256)) {
+  if (!create_pad(&details_pad, application_windows.pDetailsWin, 23, 256)) {
+    update_windows(DIRTY_PROGRESS | DIRTY_SUMMARY | DIRTY_RUN_SUMMARY, true);
     return;
   }
 
@@ -1328,8 +1602,12 @@ static void curses_all_tests_complete_message_handler(const CU_pFailureRecord pF
   mvwprintw(details_pad.pPad, 19, 0, "%s", _("======  Failure Summary  ======"));
   mvwprintw(details_pad.pPad, 20, 0, _("  TOTAL FAILURES: %4u"), CU_get_number_of_failure_records());
 
-  refresh_details_window();
-  refresh_run_summary_window();
+  if (NULL != CU_get_fail_fast_test()) {
+    mvwprintw(details_pad.pPad, 22, 0, _("Run stopped after %u failed test(s)."), CU_get_number_of_tests_failed());
+  }
+
+  /* final synchronous redraw of everything held back by the frame rate */
+  update_windows(DIRTY_PROGRESS | DIRTY_SUMMARY | DIRTY_RUN_SUMMARY | DIRTY_DETAILS, true);
 }
 
 /*------------------------------------------------------------------------*/
@@ -1342,8 +1620,7 @@ static void curses_suite_init_failure_message_handler(const CU_pSuite pSuite)
   f_uiTestsSkipped += pSuite->uiNumberOfTests;
   f_uiSuitesSkipped++;
 
-  refresh_summary_window();
-  refresh_progress_window();
+  update_windows(DIRTY_SUMMARY | DIRTY_PROGRESS, false);
 }
 
 /** @} */
@@ -0,0 +1,615 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of allocation failure sweeps.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Allocation failure sweeps (implementation).
+ *  Each child reports to the test program over a pipe: a SWEEP_INJECTED
+ *  message as soon as the selected allocation is failed (so the site is
+ *  known even if the child then crashes), and a SWEEP_FINISHED message
+ *  with its outstanding allocations when the test function returns.
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L   /* fork(), pipe(), waitpid() under -std=c99 */
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "TestRun.h"
+#include "AllocTrack.h"
+#include "AllocFail.h"
+#include "CUnit_intl.h"
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+#ifndef _WIN32
+
+/** Types of messages sent by a sweep child. */
+typedef enum SweepMessageType
+{
+  SWEEP_INJECTED = 1,   /**< The selected allocation was failed. */
+  SWEEP_FINISHED        /**< The test function returned. */
+} SweepMessageType;
+
+/** Message sent by a sweep child (smaller than PIPE_BUF, so written atomically). */
+typedef struct SweepMessage
+{
+  SweepMessageType type;          /**< Type of message. */
+  unsigned long    ulOutstanding; /**< Allocations outstanding (SWEEP_FINISHED). */
+  size_t           szLiveBytes;   /**< Bytes outstanding (SWEEP_FINISHED). */
+  CU_AllocSite     site;          /**< Site of the failed allocation (SWEEP_INJECTED). */
+} SweepMessage;
+
+/** Outcome of one child run, as seen by the test program. */
+typedef struct SweepRun
+{
+  CU_BOOL       bInjected;        /**< Whether the allocation was failed. */
+  CU_BOOL       bFinished;        /**< Whether the test function returned. */
+  int           iStatus;          /**< Status from waitpid(). */
+  unsigned long ulOutstanding;    /**< Allocations outstanding at the end. */
+  size_t        szLiveBytes;      /**< Bytes outstanding at the end. */
+  CU_AllocSite  site;             /**< Site of the failed allocation. */
+} SweepRun;
+
+static int f_iSweepPipe = -1;     /**< Write end of the pipe in a sweep child. */
+
+/*=================================================================
+ *  Private functions
+ *=================================================================*/
+/** Writes a complete message to the pipe of a sweep child. */
+static void send_message(const SweepMessage* pMessage)
+{
+  ssize_t iWritten;
+
+  do {
+    iWritten = write(f_iSweepPipe, pMessage, sizeof(SweepMessage));
+  } while ((iWritten < 0) && (EINTR == errno));
+}
+
+/*------------------------------------------------------------------------*/
+/** Reports the site of the failed allocation (CU_AllocFailHandler). */
+static void report_injection(const CU_AllocSite* pSite)
+{
+  SweepMessage message;
+
+  memset(&message, 0, sizeof(message));
+  message.type = SWEEP_INJECTED;
+  message.site = *pSite;
+  send_message(&message);
+}
+
+/*------------------------------------------------------------------------*/
+/** Body of a sweep child: runs the test function with allocation ulPoint failing. */
+static void run_child(CU_pTest pTest, unsigned long ulPoint)
+{
+  const CU_AllocStats* pStats;
+  SweepMessage message;
+
+  alarm(CU_ALLOC_FAIL_TIMEOUT);
+
+  CU_alloc_begin_test();
+  CU_alloc_set_fail_point(ulPoint, report_injection);
+  CU_run_test_function_concurrently(pTest->pTestFunc);
+  CU_alloc_set_fail_point(0, NULL);
+
+  memset(&message, 0, sizeof(message));
+  message.type = SWEEP_FINISHED;
+  if (NULL != (pStats = CU_get_current_alloc_stats())) {
+    message.ulOutstanding = pStats->ulOutstanding;
+    message.szLiveBytes = pStats->szLiveBytes;
+  }
+  send_message(&message);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Forks a child running the test with allocation ulPoint failing and
+ *  collects its messages and exit status.
+ *  @return CU_FALSE if the child could not be started.
+ */
+static CU_BOOL run_point(CU_pTest pTest, unsigned long ulPoint, SweepRun* pRun)
+{
+  SweepMessage message;
+  int aiPipe[2];
+  pid_t pid;
+  ssize_t iRead;
+
+  memset(pRun, 0, sizeof(SweepRun));
+
+  if (0 != pipe(aiPipe)) {
+    return CU_FALSE;
+  }
+
+  fflush(NULL);     /* output buffered so far must not be written twice */
+  pid = fork();
+  if (pid < 0) {
+    close(aiPipe[0]);
+    close(aiPipe[1]);
+    return CU_FALSE;
+  }
+  if (0 == pid) {
+    close(aiPipe[0]);
+    f_iSweepPipe = aiPipe[1];
+    run_child(pTest, ulPoint);
+    _exit(0);
+  }
+
+  close(aiPipe[1]);
+  for (;;) {
+    iRead = read(aiPipe[0], &message, sizeof(message));
+    if ((iRead < 0) && (EINTR == errno)) {
+      continue;
+    }
+    if (sizeof(message) != (size_t)iRead) {
+      break;
+    }
+    if (SWEEP_INJECTED == message.type) {
+      pRun->bInjected = CU_TRUE;
+      pRun->site = message.site;
+    }
+    else if (SWEEP_FINISHED == message.type) {
+      pRun->bFinished = CU_TRUE;
+      pRun->ulOutstanding = message.ulOutstanding;
+      pRun->szLiveBytes = message.szLiveBytes;
+    }
+  }
+  close(aiPipe[0]);
+
+  while ((waitpid(pid, &pRun->iStatus, 0) < 0) && (EINTR == errno))
+    ;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Counts a problem failure point and keeps it if there is room. */
+static void add_report(CU_AllocFailResult* pResult, const CU_AllocFailPoint* pPoint)
+{
+  switch (pPoint->outcome) {
+    case CU_ALLOC_FAIL_CRASH: ++pResult->ulCrashes; break;
+    case CU_ALLOC_FAIL_HANG:  ++pResult->ulHangs;   break;
+    case CU_ALLOC_FAIL_EXIT:  ++pResult->ulExits;   break;
+    case CU_ALLOC_FAIL_LEAK:  ++pResult->ulLeaks;   break;
+    default:                                        break;
+  }
+  if (pResult->uiReports < CU_ALLOC_FAIL_MAX_REPORTS) {
+    pResult->aReports[pResult->uiReports++] = *pPoint;
+  }
+}
+
+#endif  /* _WIN32 */
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_ErrorCode CU_set_alloc_failure_sweep(CU_pTest pTest, CU_BOOL bSweep)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+  CU_AllocFailSweep* pSweep;
+
+  if (NULL == pTest) {
+    result = CUE_NOTEST;
+  }
+  else if (CU_FALSE == bSweep) {
+    if (NULL != pTest->pAllocFail) {
+      CU_FREE(pTest->pAllocFail);
+      pTest->pAllocFail = NULL;
+    }
+  }
+  else {
+#ifdef _WIN32
+    result = CUE_ALLOC_FAIL_UNAVAILABLE;
+#else
+    pSweep = pTest->pAllocFail;
+    if ((NULL == pSweep) && (NULL == (pSweep = (CU_AllocFailSweep*)CU_MALLOC(sizeof(CU_AllocFailSweep))))) {
+      result = CUE_NOMEMORY;
+    }
+    else {
+      memset(pSweep, 0, sizeof(CU_AllocFailSweep));
+      pTest->pAllocFail = pSweep;
+    }
+#endif
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_is_alloc_failure_sweep(CU_pTest pTest)
+{
+  return ((NULL != pTest) && (NULL != pTest->pAllocFail)) ? CU_TRUE : CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_AllocFailResult* CU_get_alloc_failure_result(CU_pTest pTest)
+{
+  return (CU_FALSE != CU_is_alloc_failure_sweep(pTest)) ? &pTest->pAllocFail->result : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_run_alloc_failure_sweep(CU_pTest pTest)
+{
+#ifdef _WIN32
+  CU_UNREFERENCED_PARAMETER(pTest);
+  return CUE_ALLOC_FAIL_UNAVAILABLE;
+#else
+  CU_AllocFailResult* pResult;
+  CU_AllocFailPoint* pLeaks = NULL;
+  CU_AllocFailPoint* pTemp;
+  CU_AllocFailPoint point;
+  unsigned long nLeaks = 0;
+  unsigned long nLeaksCap = 0;
+  unsigned long ulPoint;
+  unsigned long i;
+  SweepRun run;
+
+  assert(NULL != pTest);
+  assert(NULL != pTest->pAllocFail);
+  assert(NULL != pTest->pTestFunc);
+
+  pResult = &pTest->pAllocFail->result;
+  memset(pResult, 0, sizeof(CU_AllocFailResult));
+
+  if (CU_FALSE == CU_is_alloc_tracking_available()) {
+    return CUE_ALLOC_FAIL_UNAVAILABLE;
+  }
+
+  for (ulPoint = 1 ; ulPoint <= CU_ALLOC_FAIL_MAX_POINTS ; ++ulPoint) {
+    if (CU_FALSE == run_point(pTest, ulPoint, &run)) {
+      if (NULL != pLeaks) {
+        CU_FREE(pLeaks);
+      }
+      return CUE_ALLOC_FAIL_UNAVAILABLE;
+    }
+
+    memset(&point, 0, sizeof(point));
+    point.ulPoint = ulPoint;
+    point.site = run.site;
+
+    if (WIFSIGNALED(run.iStatus)) {
+      point.iStatus = WTERMSIG(run.iStatus);
+      point.outcome = (SIGALRM == point.iStatus) ? CU_ALLOC_FAIL_HANG : CU_ALLOC_FAIL_CRASH;
+    }
+    else if (CU_FALSE == run.bFinished) {
+      point.iStatus = WIFEXITED(run.iStatus) ? WEXITSTATUS(run.iStatus) : 0;
+      point.outcome = CU_ALLOC_FAIL_EXIT;
+    }
+
+    /* the clean run - allocation ulPoint was never reached */
+    if (CU_FALSE == run.bInjected) {
+      pResult->ulPoints = ulPoint - 1;
+      if (CU_ALLOC_FAIL_OK != point.outcome) {
+        point.ulPoint = 0;
+        add_report(pResult, &point);
+      }
+      break;
+    }
+
+    if (CU_ALLOC_FAIL_OK != point.outcome) {
+      add_report(pResult, &point);
+    }
+    else if (run.ulOutstanding > 0) {
+      /* a leak if more is outstanding than in the clean run, known at the end */
+      if (nLeaks == nLeaksCap) {
+        nLeaksCap = (0 == nLeaksCap) ? 16 : 2 * nLeaksCap;
+        pTemp = (NULL == pLeaks)
+              ? (CU_AllocFailPoint*)CU_MALLOC(nLeaksCap * sizeof(CU_AllocFailPoint))
+              : (CU_AllocFailPoint*)CU_REALLOC(pLeaks, nLeaksCap * sizeof(CU_AllocFailPoint));
+        if (NULL == pTemp) {
+          if (NULL != pLeaks) {
+            CU_FREE(pLeaks);
+          }
+          return CUE_NOMEMORY;
+        }
+        pLeaks = pTemp;
+      }
+      point.ulLeaked = run.ulOutstanding;
+      point.szLeakedBytes = run.szLiveBytes;
+      pLeaks[nLeaks++] = point;
+    }
+  }
+
+  if (ulPoint > CU_ALLOC_FAIL_MAX_POINTS) {
+    pResult->ulPoints = CU_ALLOC_FAIL_MAX_POINTS;
+    pResult->bTruncated = CU_TRUE;
+    run.ulOutstanding = 0;          /* no clean run - report anything outstanding */
+    run.szLiveBytes = 0;
+  }
+
+  for (i = 0 ; i < nLeaks ; ++i) {
+    if (pLeaks[i].ulLeaked > run.ulOutstanding) {
+      pLeaks[i].outcome = CU_ALLOC_FAIL_LEAK;
+      pLeaks[i].ulLeaked -= run.ulOutstanding;
+      pLeaks[i].szLeakedBytes = (pLeaks[i].szLeakedBytes > run.szLiveBytes)
+                              ? pLeaks[i].szLeakedBytes - run.szLiveBytes : 0;
+      add_report(pResult, &pLeaks[i]);
+    }
+  }
+  if (NULL != pLeaks) {
+    CU_FREE(pLeaks);
+  }
+
+  return CUE_SUCCESS;
+#endif
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+#ifndef _WIN32
+/*  The test program is not linked with the wrapper, so the test
+ *  functions below allocate through sweep_malloc(), which calls the
+ *  hooks the way the wrapper does.
+ */
+static void* sweep_malloc(size_t size)
+{
+  void* pMem;
+
+  if (CU_FALSE != CU_alloc_should_fail(size)) {
+    return NULL;
+  }
+  pMem = malloc(size);
+  CU_alloc_note_alloc(pMem, size, CU_ALLOC_MALLOC);
+  return pMem;
+}
+
+static void sweep_free(void* pMem)
+{
+  CU_alloc_note_free(pMem);
+  free(pMem);
+}
+
+static void* f_pKept = NULL;    /**< Block kept by sweep_keeps_one(). */
+
+/** Handles every failure. */
+static void sweep_clean(void)
+{
+  void* p1 = sweep_malloc(10);
+  void* p2 = sweep_malloc(20);
+  void* p3 = sweep_malloc(30);
+
+  CU_ASSERT_PTR_NOT_NULL(p1);   /* fails in the children - not reported */
+  if (NULL != p3) sweep_free(p3);
+  if (NULL != p2) sweep_free(p2);
+  if (NULL != p1) sweep_free(p1);
+}
+
+/** Leaks p1 if the second allocation fails, and crashes if the third does. */
+static void sweep_buggy(void)
+{
+  char* p1 = (char*)sweep_malloc(10);
+  char* p2;
+  char* p3;
+
+  if (NULL == p1) {
+    return;
+  }
+  if (NULL == (p2 = (char*)sweep_malloc(20))) {
+    return;
+  }
+  p3 = (char*)sweep_malloc(30);
+  if (NULL == p3) {
+    raise(SIGSEGV);
+  }
+  sweep_free(p3);
+  sweep_free(p2);
+  sweep_free(p1);
+}
+
+/** Keeps one block in the clean run, which is not a leak. */
+static void sweep_keeps_one(void)
+{
+  void* p1 = sweep_malloc(10);
+  void* p2 = sweep_malloc(20);
+
+  if (NULL != p2) {
+    sweep_free(p2);
+  }
+  f_pKept = p1;
+}
+
+/** Exits if its allocation fails. */
+static void sweep_exits(void)
+{
+  void* p1 = sweep_malloc(10);
+
+  if (NULL == p1) {
+    _exit(3);
+  }
+  sweep_free(p1);
+}
+
+static void test_CU_set_alloc_failure_sweep(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  pTest = CU_add_test(pSuite, "test1", sweep_clean);
+  TEST_FATAL(NULL != pTest);
+
+  TEST(CU_FALSE == CU_is_alloc_failure_sweep(pTest));
+  TEST(NULL == CU_get_alloc_failure_result(pTest));
+
+  TEST(CUE_NOTEST == CU_set_alloc_failure_sweep(NULL, CU_TRUE));
+  TEST(CUE_NOTEST == CU_get_error());
+
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pTest, CU_TRUE));
+  TEST(CU_FALSE != CU_is_alloc_failure_sweep(pTest));
+  TEST(NULL != CU_get_alloc_failure_result(pTest));
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pTest, CU_TRUE));
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pTest, CU_FALSE));
+  TEST(CU_FALSE == CU_is_alloc_failure_sweep(pTest));
+  TEST(NULL == pTest->pAllocFail);
+
+  /* freed with the registry */
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pTest, CU_TRUE));
+  CU_cleanup_registry();
+}
+
+static void test_fail_point(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+  void* p1;
+  void* p2;
+  int iSuspended;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  pTest = CU_add_test(pSuite, "test1", sweep_clean);
+  TEST_FATAL(NULL != pTest);
+
+  CU_alloc_note_free(NULL);     /* make tracking available */
+
+  CU_alloc_begin_test();
+  CU_alloc_set_fail_point(2, NULL);
+  p1 = sweep_malloc(8);
+  p2 = sweep_malloc(8);
+  TEST(NULL != p1);
+  TEST(NULL == p2);
+  p2 = sweep_malloc(8);
+  TEST(NULL != p2);             /* only the selected allocation fails */
+  CU_alloc_set_fail_point(0, NULL);
+  sweep_free(p1);
+  sweep_free(p2);
+
+  /* not while suspended */
+  CU_alloc_set_fail_point(1, NULL);
+  iSuspended = CU_alloc_set_suspended(1);
+  p1 = sweep_malloc(8);
+  CU_alloc_set_suspended(iSuspended);
+  TEST(NULL != p1);
+  free(p1);
+  CU_alloc_set_fail_point(0, NULL);
+  CU_alloc_end_test(pTest);
+
+  CU_cleanup_registry();
+}
+
+static void test_CU_run_alloc_failure_sweep(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pClean;
+  CU_pTest pBuggy;
+  CU_pTest pKeeps;
+  CU_pTest pExits;
+  const CU_AllocFailResult* pResult;
+  CU_BOOL bLeakAt2 = CU_FALSE;
+  CU_BOOL bCrashAt3 = CU_FALSE;
+  unsigned int i;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  pClean = CU_add_test(pSuite, "clean", sweep_clean);
+  pBuggy = CU_add_test(pSuite, "buggy", sweep_buggy);
+  pKeeps = CU_add_test(pSuite, "keeps", sweep_keeps_one);
+  pExits = CU_add_test(pSuite, "exits", sweep_exits);
+  TEST_FATAL((NULL != pClean) && (NULL != pBuggy) && (NULL != pKeeps) && (NULL != pExits));
+
+  CU_alloc_note_free(NULL);     /* make tracking available */
+
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pClean, CU_TRUE));
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pBuggy, CU_TRUE));
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pKeeps, CU_TRUE));
+  TEST(CUE_SUCCESS == CU_set_alloc_failure_sweep(pExits, CU_TRUE));
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+
+  pResult = CU_get_alloc_failure_result(pClean);
+  TEST_FATAL(NULL != pResult);
+  TEST(3 == pResult->ulPoints);
+  TEST(0 == pResult->uiReports);
+
+  pResult = CU_get_alloc_failure_result(pBuggy);
+  TEST_FATAL(NULL != pResult);
+  TEST(3 == pResult->ulPoints);
+  TEST(1 == pResult->ulCrashes);
+  TEST(1 == pResult->ulLeaks);
+  TEST(2 == pResult->uiReports);
+  for (i = 0 ; i < pResult->uiReports ; ++i) {
+    if ((2 == pResult->aReports[i].ulPoint) && (CU_ALLOC_FAIL_LEAK == pResult->aReports[i].outcome)) {
+      bLeakAt2 = (1 == pResult->aReports[i].ulLeaked) && (10 == pResult->aReports[i].szLeakedBytes);
+    }
+    if ((3 == pResult->aReports[i].ulPoint) && (CU_ALLOC_FAIL_CRASH == pResult->aReports[i].outcome)) {
+      bCrashAt3 = (SIGSEGV == pResult->aReports[i].iStatus) && (30 == pResult->aReports[i].site.szBytes);
+    }
+  }
+  TEST(CU_FALSE != bLeakAt2);
+  TEST(CU_FALSE != bCrashAt3);
+
+  pResult = CU_get_alloc_failure_result(pKeeps);
+  TEST_FATAL(NULL != pResult);
+  TEST(2 == pResult->ulPoints);
+  TEST(0 == pResult->ulLeaks);  /* the clean run keeps as much */
+  sweep_free(f_pKept);
+
+  pResult = CU_get_alloc_failure_result(pExits);
+  TEST_FATAL(NULL != pResult);
+  TEST(1 == pResult->ulExits);
+  TEST((1 == pResult->uiReports) && (3 == pResult->aReports[0].iStatus));
+
+  /* problems are failures of the test, the clean runs in the parent pass */
+  TEST(2 == CU_get_number_of_tests_failed());
+  TEST(3 == CU_get_number_of_failure_records());
+
+  CU_cleanup_registry();
+}
+#endif  /* _WIN32 */
+
+void test_cunit_AllocFail(void)
+{
+  test_cunit_start_tests("AllocFail.c");
+
+#ifndef _WIN32
+  test_CU_set_alloc_failure_sweep();
+  test_fail_point();
+  test_CU_run_alloc_failure_sweep();
+#endif
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
@@ -0,0 +1,819 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of per-test heap allocation accounting.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *
+ *  18-Oct-2026   Added allocation failure injection. (AGT)
+ */
+
+/** @file
+ *  Per-test heap allocation accounting (implementation).
+ *  The functions here are called from the wrapped allocation functions,
+ *  so they must not allocate while accounting is enabled on the calling
+ *  thread.  Each hook raises the thread's suspension depth for its
+ *  duration, which makes allocations done by the tracker itself (or by
+ *  backtrace()) invisible to it.
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "TestRun.h"
+#include "Util.h"
+#include "CUThread.h"
+#include "AllocTrack.h"
+#include "CUnit_intl.h"
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+#define ALLOC_SKIP_FRAMES 2
+/**< Frames of the hook and the wrapper function above the call site. */
+
+#define ALLOC_TABLE_MIN 1024
+/**< Initial capacity of the live block table (a power of 2). */
+
+/** A live block allocated by the running test. */
+typedef struct AllocBlock
+{
+  void*  pMem;      /**< Address of the block (NULL for an empty slot). */
+  size_t szBytes;   /**< Size requested for the block. */
+} AllocBlock;
+
+static volatile CU_BOOL f_bAvailable = CU_FALSE;  /**< Set by the first wrapped call. */
+static volatile CU_BOOL f_bActive = CU_FALSE;     /**< Whether a test function is being accounted. */
+static CU_BOOL          f_bStarted = CU_FALSE;    /**< Whether f_stats holds any test's statistics. */
+static CU_BOOL          f_bBacktraces = CU_TRUE;  /**< Whether call sites are recorded. */
+
+/** Suspension depth of this thread; accounting is off while above 0. */
+static CU_THREAD_LOCAL int f_iSuspended = 0;
+
+/** Protects the statistics and the block table.  Created with the first
+ *  test and kept for the life of the process, since other threads may
+ *  still be in a hook when a test ends. */
+static CU_pMutex f_pMutex = NULL;
+
+static CU_AllocStats f_stats;                     /**< Statistics of the current/last test. */
+static AllocBlock*   f_pBlocks = NULL;            /**< Open addressing table of live blocks. */
+static size_t        f_szCapacity = 0;            /**< Number of slots in f_pBlocks. */
+static size_t        f_szUsed = 0;                /**< Number of occupied slots. */
+
+static unsigned long       f_ulFailPoint = 0;     /**< Allocation to fail (0 for none). */
+static unsigned long       f_ulAttempts = 0;      /**< Allocations attempted since the fail point was set. */
+static CU_AllocFailHandler f_pFailHandler = NULL; /**< Called when the allocation is failed. */
+
+/** Records that the wrapper is linked in (written once, as hooks race). */
+#define NOTE_AVAILABLE() \
+  do { if (CU_FALSE == f_bAvailable) { f_bAvailable = CU_TRUE; } } while (0)
+
+/*=================================================================
+ *  Private functions
+ *=================================================================*/
+/** Maps a block address to its home slot. */
+static size_t block_slot(const void* pMem, size_t szCapacity)
+{
+  uintptr_t uHash = (uintptr_t)pMem >> 4;
+
+  uHash ^= uHash >> 16;
+  uHash *= (uintptr_t)0x45d9f3bU;
+  uHash ^= uHash >> 16;
+  return (size_t)uHash & (szCapacity - 1);
+}
+
+/*------------------------------------------------------------------------*/
+/** Finds the slot holding pMem, or returns f_szCapacity if not present. */
+static size_t find_block(const void* pMem)
+{
+  size_t szSlot;
+
+  if (0 == f_szCapacity) {
+    return 0;
+  }
+  for (szSlot = block_slot(pMem, f_szCapacity) ;
+       NULL != f_pBlocks[szSlot].pMem ;
+       szSlot = (szSlot + 1) & (f_szCapacity - 1)) {
+    if (pMem == f_pBlocks[szSlot].pMem) {
+      return szSlot;
+    }
+  }
+  return f_szCapacity;
+}
+
+/*------------------------------------------------------------------------*/
+/** Stores a block in a table known to have a free slot and not to hold it. */
+static void store_block(AllocBlock* pBlocks, size_t szCapacity, void* pMem, size_t szBytes)
+{
+  size_t szSlot;
+
+  for (szSlot = block_slot(pMem, szCapacity) ;
+       NULL != pBlocks[szSlot].pMem ;
+       szSlot = (szSlot + 1) & (szCapacity - 1))
+    ;
+  pBlocks[szSlot].pMem = pMem;
+  pBlocks[szSlot].szBytes = szBytes;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Adds a live block, growing the table when it is half full.
+ *  @return CU_FALSE if the table could not be grown (block not tracked).
+ */
+static CU_BOOL insert_block(void* pMem, size_t szBytes)
+{
+  AllocBlock* pNew;
+  size_t szNewCapacity;
+  size_t i;
+
+  if (2 * (f_szUsed + 1) > f_szCapacity) {
+    szNewCapacity = (0 == f_szCapacity) ? ALLOC_TABLE_MIN : 2 * f_szCapacity;
+    if (NULL == (pNew = (AllocBlock*)CU_CALLOC(szNewCapacity, sizeof(AllocBlock)))) {
+      return CU_FALSE;
+    }
+    for (i = 0 ; i < f_szCapacity ; ++i) {
+      if (NULL != f_pBlocks[i].pMem) {
+        store_block(pNew, szNewCapacity, f_pBlocks[i].pMem, f_pBlocks[i].szBytes);
+      }
+    }
+    if (NULL != f_pBlocks) {
+      CU_FREE(f_pBlocks);
+    }
+    f_pBlocks = pNew;
+    f_szCapacity = szNewCapacity;
+  }
+  store_block(f_pBlocks, f_szCapacity, pMem, szBytes);
+  ++f_szUsed;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Empties a slot, shifting back later entries of its probe sequence. */
+static void remove_slot(size_t szSlot)
+{
+  size_t szNext;
+  size_t szHome;
+
+  for (;;) {
+    f_pBlocks[szSlot].pMem = NULL;
+    szNext = szSlot;
+    for (;;) {
+      szNext = (szNext + 1) & (f_szCapacity - 1);
+      if (NULL == f_pBlocks[szNext].pMem) {
+        --f_szUsed;
+        return;
+      }
+      szHome = block_slot(f_pBlocks[szNext].pMem, f_szCapacity);
+      /* the entry may move back unless its home lies cyclically in (szSlot, szNext] */
+      if ((szSlot <= szNext) ? ((szHome <= szSlot) || (szHome > szNext))
+                             : ((szHome <= szSlot) && (szHome > szNext))) {
+        break;
+      }
+    }
+    f_pBlocks[szSlot] = f_pBlocks[szNext];
+    szSlot = szNext;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Releases the live block table. */
+static void clear_blocks(void)
+{
+  if (NULL != f_pBlocks) {
+    CU_FREE(f_pBlocks);
+  }
+  f_pBlocks = NULL;
+  f_szCapacity = 0;
+  f_szUsed = 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Counts an allocation at a call site. */
+static void record_site(void* const* apFrames, unsigned int uiFrames, size_t szBytes)
+{
+  CU_AllocSite* pSite;
+  unsigned int i;
+
+  for (i = 0 ; i < f_stats.uiSites ; ++i) {
+    pSite = &f_stats.aSites[i];
+    if ((pSite->uiFrames == uiFrames) &&
+        (0 == memcmp(pSite->apFrames, apFrames, uiFrames * sizeof(void*)))) {
+      ++pSite->ulCalls;
+      pSite->szBytes += szBytes;
+      return;
+    }
+  }
+  if (f_stats.uiSites < CU_ALLOC_MAX_SITES) {
+    pSite = &f_stats.aSites[f_stats.uiSites++];
+    memset(pSite, 0, sizeof(CU_AllocSite));
+    memcpy(pSite->apFrames, apFrames, uiFrames * sizeof(void*));
+    pSite->uiFrames = uiFrames;
+    pSite->ulCalls = 1;
+    pSite->szBytes = szBytes;
+  }
+  else {
+    ++f_stats.ulOtherSites;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Adds a new live block of the test to the statistics. */
+static void add_live(void* pMem, size_t szBytes)
+{
+  if (CU_FALSE != insert_block(pMem, szBytes)) {
+    ++f_stats.ulOutstanding;
+    f_stats.szLiveBytes += szBytes;
+    if (f_stats.szLiveBytes > f_stats.szPeakLiveBytes) {
+      f_stats.szPeakLiveBytes = f_stats.szLiveBytes;
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Removes a block from the live blocks of the test.
+ *  @return CU_TRUE if pMem was allocated by the test.
+ */
+static CU_BOOL remove_live(void* pMem)
+{
+  size_t szSlot = find_block(pMem);
+
+  if (szSlot >= f_szCapacity) {
+    return CU_FALSE;
+  }
+  --f_stats.ulOutstanding;
+  f_stats.szLiveBytes -= f_pBlocks[szSlot].szBytes;
+  remove_slot(szSlot);
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Stores up to iMax return addresses of the calling thread (a macro, so
+ *  that it adds no frame of its own). */
+#ifdef __GLIBC__
+#define capture_frames(apFrames, iMax) backtrace((apFrames), (iMax))
+#else
+#define capture_frames(apFrames, iMax) 0
+#endif
+
+/**
+ *  Captures the call site of the allocation being reported.
+ *  Must be called directly from a hook so that the frames of the hook
+ *  and the wrapper can be skipped.
+ */
+#define CAPTURE_SITE(apFrames, uiFrames) \
+  do { \
+    void* apAll_[CU_ALLOC_SITE_DEPTH + ALLOC_SKIP_FRAMES]; \
+    int iAll_ = 0; \
+    (uiFrames) = 0; \
+    if (CU_FALSE != f_bBacktraces) { \
+      iAll_ = capture_frames(apAll_, CU_ALLOC_SITE_DEPTH + ALLOC_SKIP_FRAMES); \
+    } \
+    if (iAll_ > ALLOC_SKIP_FRAMES) { \
+      (uiFrames) = (unsigned int)(iAll_ - ALLOC_SKIP_FRAMES); \
+      memcpy((apFrames), apAll_ + ALLOC_SKIP_FRAMES, (uiFrames) * sizeof(void*)); \
+    } \
+  } while (0)
+
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_BOOL CU_is_alloc_tracking_available(void)
+{
+  return f_bAvailable;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_set_alloc_backtraces(CU_BOOL bBacktraces)
+{
+  f_bBacktraces = bBacktraces;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_AllocStats* CU_get_current_alloc_stats(void)
+{
+  return (CU_FALSE != f_bStarted) ? &f_stats : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_AllocStats* CU_get_alloc_stats(CU_pTest pTest)
+{
+  return (NULL != pTest) ? pTest->pAlloc : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_print_alloc_sites(const CU_AllocStats* pStats, unsigned int uiMax, FILE* pFile)
+{
+  unsigned int auiOrder[CU_ALLOC_MAX_SITES];
+  const CU_AllocSite* pSite;
+  unsigned int uiCount;
+  unsigned int uiTemp;
+  unsigned int i;
+  unsigned int j;
+  int iSuspended;
+#ifdef __GLIBC__
+  char** ppSymbols;
+#endif
+
+  assert(NULL != pFile);
+
+  if (NULL == pStats) {
+    return;
+  }
+
+  iSuspended = CU_alloc_set_suspended(f_iSuspended + 1);
+
+  /* order by number of calls, most first (stable) */
+  for (i = 0 ; i < pStats->uiSites ; ++i) {
+    auiOrder[i] = i;
+    for (j = i ; (j > 0) && (pStats->aSites[auiOrder[j - 1]].ulCalls < pStats->aSites[auiOrder[j]].ulCalls) ; --j) {
+      uiTemp = auiOrder[j];
+      auiOrder[j] = auiOrder[j - 1];
+      auiOrder[j - 1] = uiTemp;
+    }
+  }
+
+  uiCount = (uiMax < pStats->uiSites) ? uiMax : pStats->uiSites;
+  for (i = 0 ; i < uiCount ; ++i) {
+    pSite = &pStats->aSites[auiOrder[i]];
+    fprintf(pFile, _("  %lu allocation(s), %lu byte(s) from:\n"),
+            pSite->ulCalls, (unsigned long)pSite->szBytes);
+    if (0 == pSite->uiFrames) {
+      fprintf(pFile, "      %s\n", _("(call site unknown)"));
+      continue;
+    }
+#ifdef __GLIBC__
+    ppSymbols = backtrace_symbols(pSite->apFrames, (int)pSite->uiFrames);
+#endif
+    for (j = 0 ; j < pSite->uiFrames ; ++j) {
+#ifdef __GLIBC__
+      if (NULL != ppSymbols) {
+        fprintf(pFile, "      %s\n", ppSymbols[j]);
+        continue;
+      }
+#endif
+      fprintf(pFile, "      %p\n", pSite->apFrames[j]);
+    }
+#ifdef __GLIBC__
+    free(ppSymbols);
+#endif
+  }
+  if (pStats->uiSites > uiCount) {
+    fprintf(pFile, _("  ... %u more call site(s)\n"), pStats->uiSites - uiCount);
+  }
+  if (0 != pStats->ulOtherSites) {
+    fprintf(pFile, _("  ... %lu allocation(s) from call sites not recorded\n"), pStats->ulOtherSites);
+  }
+
+  CU_alloc_set_suspended(iSuspended);
+}
+
+/*------------------------------------------------------------------------*/
+void CU_format_alloc_site(const CU_AllocSite* pSite, char* szBuffer, size_t szLength)
+{
+  int iSuspended;
+#ifdef __GLIBC__
+  char** ppSymbols;
+#endif
+
+  assert(NULL != pSite);
+  assert((NULL != szBuffer) && (szLength > 0));
+
+  if (0 == pSite->uiFrames) {
+    snprintf(szBuffer, szLength, "%s", _("(call site unknown)"));
+    return;
+  }
+
+  iSuspended = CU_alloc_set_suspended(f_iSuspended + 1);
+  snprintf(szBuffer, szLength, "%p", pSite->apFrames[0]);
+#ifdef __GLIBC__
+  ppSymbols = backtrace_symbols(pSite->apFrames, 1);
+  if (NULL != ppSymbols) {
+    snprintf(szBuffer, szLength, "%s", ppSymbols[0]);
+    free(ppSymbols);
+  }
+#endif
+  CU_alloc_set_suspended(iSuspended);
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_alloc_should_fail(size_t szBytes)
+{
+  CU_AllocSite site;
+  CU_BOOL bFail;
+
+  if ((0 == f_ulFailPoint) || (0 != f_iSuspended) || (CU_FALSE == f_bActive)) {
+    return CU_FALSE;
+  }
+
+  ++f_iSuspended;
+  CU_mutex_lock(f_pMutex);
+  bFail = ((0 != f_ulFailPoint) && (++f_ulAttempts == f_ulFailPoint)) ? CU_TRUE : CU_FALSE;
+  CU_mutex_unlock(f_pMutex);
+
+  if ((CU_FALSE != bFail) && (NULL != f_pFailHandler)) {
+    memset(&site, 0, sizeof(site));
+    CAPTURE_SITE(site.apFrames, site.uiFrames);
+    site.ulCalls = 1;
+    site.szBytes = szBytes;
+    (*f_pFailHandler)(&site);
+  }
+  --f_iSuspended;
+  return bFail;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_alloc_note_alloc(void* pMem, size_t szBytes, CU_AllocCall call)
+{
+  void* apFrames[CU_ALLOC_SITE_DEPTH];
+  unsigned int uiFrames;
+
+  NOTE_AVAILABLE();
+  if ((0 != f_iSuspended) || (CU_FALSE == f_bActive) || (NULL == pMem)) {
+    return;
+  }
+
+  ++f_iSuspended;
+  CAPTURE_SITE(apFrames, uiFrames);
+  CU_mutex_lock(f_pMutex);
+  if (CU_FALSE != f_bActive) {
+    switch (call) {
+      case CU_ALLOC_CALLOC:  ++f_stats.ulCallocs;  break;
+      case CU_ALLOC_REALLOC: ++f_stats.ulReallocs; break;
+      default:               ++f_stats.ulMallocs;  break;
+    }
+    ++f_stats.ulAllocations;
+    f_stats.szBytes += szBytes;
+    record_site(apFrames, uiFrames, szBytes);
+    remove_live(pMem);    /* stale entry if the block was freed behind our back */
+    add_live(pMem, szBytes);
+  }
+  CU_mutex_unlock(f_pMutex);
+  --f_iSuspended;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_alloc_note_realloc(void* pOld, void* pNew, size_t szBytes)
+{
+  void* apFrames[CU_ALLOC_SITE_DEPTH];
+  unsigned int uiFrames;
+  CU_BOOL bOwned;
+
+  NOTE_AVAILABLE();
+  if ((0 != f_iSuspended) || (CU_FALSE == f_bActive) || (NULL == pNew)) {
+    return;
+  }
+
+  ++f_iSuspended;
+  CAPTURE_SITE(apFrames, uiFrames);
+  CU_mutex_lock(f_pMutex);
+  if (CU_FALSE != f_bActive) {
+    ++f_stats.ulReallocs;
+    ++f_stats.ulAllocations;
+    f_stats.szBytes += szBytes;
+    record_site(apFrames, uiFrames, szBytes);
+    /* a block allocated before the test stays the caller's when resized */
+    bOwned = (NULL == pOld) || remove_live(pOld);
+    if (pNew != pOld) {
+      remove_live(pNew);
+    }
+    if (CU_FALSE != bOwned) {
+      add_live(pNew, szBytes);
+    }
+  }
+  CU_mutex_unlock(f_pMutex);
+  --f_iSuspended;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_alloc_note_free(void* pMem)
+{
+  NOTE_AVAILABLE();
+  if ((0 != f_iSuspended) || (CU_FALSE == f_bActive) || (NULL == pMem)) {
+    return;
+  }
+
+  ++f_iSuspended;
+  CU_mutex_lock(f_pMutex);
+  if (CU_FALSE != f_bActive) {
+    ++f_stats.ulFrees;
+    remove_live(pMem);
+  }
+  CU_mutex_unlock(f_pMutex);
+  --f_iSuspended;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_alloc_begin_test(void)
+{
+  ++f_iSuspended;
+  if (NULL == f_pMutex) {
+    f_pMutex = CU_mutex_create();
+  }
+  if (NULL != f_pMutex) {
+    CU_mutex_lock(f_pMutex);
+    memset(&f_stats, 0, sizeof(f_stats));
+    clear_blocks();
+    f_bStarted = CU_TRUE;
+    f_bActive = f_bAvailable;
+    CU_mutex_unlock(f_pMutex);
+  }
+  --f_iSuspended;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_alloc_end_test(CU_pTest pTest)
+{
+  CU_BOOL bWasActive;
+
+  assert(NULL != pTest);
+
+  if (NULL == f_pMutex) {
+    return;
+  }
+
+  ++f_iSuspended;
+  CU_mutex_lock(f_pMutex);
+  bWasActive = f_bActive;
+  f_bActive = CU_FALSE;
+  clear_blocks();
+  CU_mutex_unlock(f_pMutex);
+
+  if (CU_FALSE != bWasActive) {
+    if ((NULL != pTest->pAlloc) ||
+        (NULL != (pTest->pAlloc = (CU_AllocStats*)CU_MALLOC(sizeof(CU_AllocStats))))) {
+      *pTest->pAlloc = f_stats;
+    }
+  }
+  --f_iSuspended;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_alloc_set_fail_point(unsigned long ulPoint, CU_AllocFailHandler pHandler)
+{
+  ++f_iSuspended;
+  if (NULL == f_pMutex) {
+    f_pMutex = CU_mutex_create();
+  }
+  if (NULL != f_pMutex) {
+    CU_mutex_lock(f_pMutex);
+    f_ulFailPoint = ulPoint;
+    f_ulAttempts = 0;
+    f_pFailHandler = pHandler;
+    CU_mutex_unlock(f_pMutex);
+  }
+  --f_iSuspended;
+}
+
+/*------------------------------------------------------------------------*/
+int CU_alloc_set_suspended(int iDepth)
+{
+  int iPrevious = f_iSuspended;
+
+  f_iSuspended = iDepth;
+  return iPrevious;
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+static void test_block_table(void)
+{
+  static char acMem[4 * ALLOC_TABLE_MIN];
+  CU_pTest pTest;
+  unsigned int i;
+
+  TEST_FATAL(NULL != (pTest = (CU_pTest)CU_CALLOC(1, sizeof(CU_Test))));
+  f_bAvailable = CU_TRUE;
+  CU_alloc_begin_test();
+  TEST_FATAL(CU_FALSE != f_bActive);
+
+  /* more blocks than the initial capacity, to force growth */
+  for (i = 0 ; i < 3 * ALLOC_TABLE_MIN / 4 ; ++i) {
+    CU_alloc_note_alloc(&acMem[4 * i], 4, CU_ALLOC_MALLOC);
+  }
+  TEST(3 * ALLOC_TABLE_MIN / 4 == f_stats.ulOutstanding);
+  TEST(3 * ALLOC_TABLE_MIN == f_stats.szLiveBytes);
+  TEST(f_szCapacity >= 2 * ALLOC_TABLE_MIN);
+
+  /* free every other block, then check the rest can still be found */
+  for (i = 0 ; i < 3 * ALLOC_TABLE_MIN / 4 ; i += 2) {
+    CU_alloc_note_free(&acMem[4 * i]);
+  }
+  TEST(3 * ALLOC_TABLE_MIN / 8 == f_stats.ulOutstanding);
+  for (i = 0 ; i < 3 * ALLOC_TABLE_MIN / 4 ; ++i) {
+    if (((0 == i % 2) && (find_block(&acMem[4 * i]) != f_szCapacity)) ||
+        ((1 == i % 2) && (find_block(&acMem[4 * i]) == f_szCapacity))) {
+      break;
+    }
+  }
+  TEST(3 * ALLOC_TABLE_MIN / 4 == i);
+  for (i = 1 ; i < 3 * ALLOC_TABLE_MIN / 4 ; i += 2) {
+    CU_alloc_note_free(&acMem[4 * i]);
+  }
+  TEST(0 == f_stats.ulOutstanding);
+  TEST(0 == f_stats.szLiveBytes);
+  TEST(0 == f_szUsed);
+  TEST(3 * ALLOC_TABLE_MIN == f_stats.szPeakLiveBytes);
+
+  CU_alloc_end_test(pTest);
+  TEST(CU_FALSE == f_bActive);
+  TEST(NULL == f_pBlocks);
+  CU_FREE(pTest->pAlloc);
+  CU_FREE(pTest);
+}
+
+static void test_accounting(void)
+{
+  static char acMem[64];
+  CU_pTest pTest;
+  const CU_AllocStats* pStats;
+  int iSuspended;
+
+  TEST_FATAL(NULL != (pTest = (CU_pTest)CU_CALLOC(1, sizeof(CU_Test))));
+  TEST(NULL == CU_get_alloc_stats(pTest));
+  TEST(NULL == CU_get_alloc_stats(NULL));
+
+  /* nothing is accounted between tests */
+  f_bAvailable = CU_TRUE;
+  CU_alloc_note_alloc(&acMem[0], 10, CU_ALLOC_MALLOC);
+
+  CU_alloc_begin_test();
+  pStats = CU_get_current_alloc_stats();
+  TEST_FATAL(NULL != pStats);
+  TEST(0 == pStats->ulAllocations);
+
+  CU_alloc_note_free(&acMem[0]);                            /* allocated before the test */
+  CU_alloc_note_alloc(&acMem[8], 10, CU_ALLOC_MALLOC);
+  CU_alloc_note_alloc(&acMem[16], 20, CU_ALLOC_CALLOC);
+  CU_alloc_note_alloc(NULL, 20, CU_ALLOC_MALLOC);           /* failed allocation */
+  CU_alloc_note_realloc(&acMem[8], &acMem[24], 30);         /* moved */
+  CU_alloc_note_realloc(&acMem[32], &acMem[40], 50);        /* not the test's block */
+  CU_alloc_note_realloc(NULL, &acMem[48], 5);
+  CU_alloc_note_free(NULL);
+
+  TEST(1 == pStats->ulMallocs);
+  TEST(1 == pStats->ulCallocs);
+  TEST(3 == pStats->ulReallocs);
+  TEST(1 == pStats->ulFrees);
+  TEST(5 == pStats->ulAllocations);
+  TEST(115 == pStats->szBytes);
+  TEST(3 == pStats->ulOutstanding);                         /* 16, 24 and 48 */
+  TEST(55 == pStats->szLiveBytes);
+  TEST(55 == pStats->szPeakLiveBytes);
+  TEST(pStats->uiSites >= 1);
+
+  /* suspended allocations are not accounted */
+  iSuspended = CU_alloc_set_suspended(1);
+  TEST(0 == iSuspended);
+  CU_alloc_note_alloc(&acMem[56], 1000, CU_ALLOC_MALLOC);
+  CU_alloc_note_free(&acMem[16]);
+  TEST(1 == CU_alloc_set_suspended(iSuspended));
+  TEST(5 == pStats->ulAllocations);
+  TEST(3 == pStats->ulOutstanding);
+
+  CU_alloc_note_free(&acMem[16]);
+  CU_alloc_note_free(&acMem[24]);
+  TEST(1 == pStats->ulOutstanding);
+  TEST(5 == pStats->szLiveBytes);
+  TEST(55 == pStats->szPeakLiveBytes);
+
+  CU_alloc_end_test(pTest);
+  CU_alloc_note_free(&acMem[48]);                           /* after the test */
+
+  TEST(pStats == CU_get_current_alloc_stats());             /* still valid for teardown */
+  TEST(1 == pStats->ulOutstanding);
+  TEST_FATAL(NULL != CU_get_alloc_stats(pTest));
+  TEST(5 == CU_get_alloc_stats(pTest)->ulAllocations);
+  TEST(1 == CU_get_alloc_stats(pTest)->ulOutstanding);
+  TEST(55 == CU_get_alloc_stats(pTest)->szPeakLiveBytes);
+
+  /* a test run without the wrapper keeps no statistics */
+  f_bAvailable = CU_FALSE;
+  CU_FREE(pTest->pAlloc);
+  pTest->pAlloc = NULL;
+  CU_alloc_begin_test();
+  TEST(CU_FALSE == f_bActive);
+  CU_alloc_end_test(pTest);
+  TEST(NULL == CU_get_alloc_stats(pTest));
+
+  CU_FREE(pTest);
+}
+
+static void test_call_sites(void)
+{
+  static char acMem[CU_ALLOC_MAX_SITES + 8];
+  CU_pTest pTest;
+  const CU_AllocStats* pStats;
+  FILE* pFile;
+  void* apFrame[1];
+  unsigned int i;
+
+  TEST_FATAL(NULL != (pTest = (CU_pTest)CU_CALLOC(1, sizeof(CU_Test))));
+  f_bAvailable = CU_TRUE;
+
+  /* without backtraces all allocations share one site */
+  CU_set_alloc_backtraces(CU_FALSE);
+  CU_alloc_begin_test();
+  pStats = CU_get_current_alloc_stats();
+  TEST_FATAL(NULL != pStats);
+  CU_alloc_note_alloc(&acMem[0], 1, CU_ALLOC_MALLOC);
+  CU_alloc_note_alloc(&acMem[1], 2, CU_ALLOC_MALLOC);
+  TEST(1 == pStats->uiSites);
+  TEST(2 == pStats->aSites[0].ulCalls);
+  TEST(3 == pStats->aSites[0].szBytes);
+  TEST(0 == pStats->aSites[0].uiFrames);
+  CU_alloc_end_test(pTest);
+  CU_set_alloc_backtraces(CU_TRUE);
+
+  /* sites beyond the table are counted together */
+  CU_alloc_begin_test();
+  for (i = 0 ; i < CU_ALLOC_MAX_SITES + 3 ; ++i) {
+    apFrame[0] = &acMem[i];
+    record_site(apFrame, 1, i + 1);
+  }
+  apFrame[0] = &acMem[0];
+  record_site(apFrame, 1, 100);                             /* known site */
+  TEST(CU_ALLOC_MAX_SITES == pStats->uiSites);
+  TEST(3 == pStats->ulOtherSites);
+  TEST(2 == pStats->aSites[0].ulCalls);
+  TEST(101 == pStats->aSites[0].szBytes);
+  CU_alloc_end_test(pTest);
+
+  /* printing is ordered by calls and limited to uiMax sites */
+  CU_alloc_begin_test();
+  f_stats.uiSites = 3;
+  memset(f_stats.aSites, 0, 3 * sizeof(CU_AllocSite));
+  f_stats.aSites[0].ulCalls = 1;
+  f_stats.aSites[1].ulCalls = 7;
+  f_stats.aSites[2].ulCalls = 3;
+  f_stats.aSites[1].apFrames[0] = &acMem[0];
+  f_stats.aSites[1].uiFrames = 1;
+  if (NULL != (pFile = tmpfile())) {
+    char szBuffer[256];
+    CU_print_alloc_sites(pStats, 2, pFile);
+    rewind(pFile);
+    TEST(NULL != fgets(szBuffer, sizeof(szBuffer), pFile));
+    TEST(NULL != strstr(szBuffer, "7 allocation(s)"));
+    TEST(NULL != fgets(szBuffer, sizeof(szBuffer), pFile));  /* frame of site 1 */
+    TEST(NULL != fgets(szBuffer, sizeof(szBuffer), pFile));
+    TEST(NULL != strstr(szBuffer, "3 allocation(s)"));
+    TEST(NULL != fgets(szBuffer, sizeof(szBuffer), pFile));
+    TEST(NULL != strstr(szBuffer, "unknown"));
+    TEST(NULL != fgets(szBuffer, sizeof(szBuffer), pFile));
+    TEST(NULL != strstr(szBuffer, "1 more"));
+    fclose(pFile);
+  }
+  CU_print_alloc_sites(NULL, 2, stdout);                    /* prints nothing */
+  CU_alloc_end_test(pTest);
+
+  CU_FREE(pTest->pAlloc);
+  CU_FREE(pTest);
+  f_bAvailable = CU_FALSE;
+}
+
+void test_cunit_AllocTrack(void)
+{
+  test_cunit_start_tests("AllocTrack.c");
+
+  test_block_table();
+  test_accounting();
+  test_call_sites();
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
@@ -25,6 +25,20 @@
  *                functions, messages for new error codes. (JDS)
  *
  *  02-May-2006   Added internationalization hooks.  (JDS)
+ *
+ *  18-Oct-2026   Added messages for CUE_BAD_LOAD_PARAMS, CUE_BAD_SOAK_PARAMS. (AGT)
+ *
+ *  18-Oct-2026   Added message for CUE_BAD_ALLOCATOR. (AGT)
+ *
+ *  18-Oct-2026   Added message for CUE_ALLOC_FAIL_UNAVAILABLE. (AGT)
+ *
+ *  18-Oct-2026   Added messages for listener errors. (AGT)
+ *
+ *  18-Oct-2026   Added messages for CUE_READ_ERROR, CUE_BAD_FILE_FORMAT. (AGT)
+ *
+ *  18-Oct-2026   Added messages for CUE_ISOLATION_UNAVAILABLE, CUE_BAD_ISOLATION_PARAMS. (AGT)
+ *
+ *  18-Oct-2026   Added message for CUE_BAD_SHARD. (AGT)
  */
 
 /** @file
@@ -119,7 +133,7 @@ static const char* get_error_desc(CU_ErrorCode iError)
   static const char* ErrorDescription[] = {
     N_("No Error."),                             /* CUE_SUCCESS - 0 */
     N_("Memory allocation failed."),            /* CUE_NOMEMORY - 1 */
-    "",
+    N_("Incomplete allocator."),                /* CUE_BAD_ALLOCATOR - 2 */
     "",
     "",
     "",
@@ -152,15 +166,32 @@ static const char* get_error_desc(CU_ErrorCode iError)
     N_("Test having this name already in suite."),/* CUE_DUP_TEST - 32 */
     N_("Test not registered in specified suite."),/* CUE_TEST_NOT_IN_SUITE - 33 */
     N_("Requested test is not active"),           /* CUE_TEST_INACTIVE - 34 */
+    N_("Invalid load test parameters."),          /* CUE_BAD_LOAD_PARAMS - 35 */
+    N_("Invalid soak test parameters."),          /* CUE_BAD_SOAK_PARAMS - 36 */
+    N_("Allocation failure sweeps are not available."), /* CUE_ALLOC_FAIL_UNAVAILABLE - 37 */
+    N_("Process isolation is not available."),    /* CUE_ISOLATION_UNAVAILABLE - 38 */
+    N_("Invalid isolation parameters."),          /* CUE_BAD_ISOLATION_PARAMS - 39 */
+    N_("Error opening file."),                    /* CUE_FOPEN_FAILED - 40 */
+    N_("Error closing file."),                    /* CUE_FCLOSE_FAILED - 41 */
+    N_("Bad file name."),                         /* CUE_BAD_FILENAME - 42 */
+    N_("Error during write to file."),            /* CUE_WRITE_ERROR - 43 */
+    N_("Error during read from file."),           /* CUE_READ_ERROR - 44 */
+    N_("File is not in the expected format."),    /* CUE_BAD_FILE_FORMAT - 45 */
     "",
     "",
     "",
     "",
+    N_("NULL or unregistered listener."),         /* CUE_NOLISTENER - 50 */
+    N_("Too many listeners registered."),         /* CUE_TOO_MANY_LISTENERS - 51 */
+    N_("Listeners cannot change during a test run."), /* CUE_LISTENER_BUSY - 52 */
     "",
-    N_("Error opening file."),                    /* CUE_FOPEN_FAILED - 40 */
-    N_("Error closing file."),                    /* CUE_FCLOSE_FAILED - 41 */
-    N_("Bad file name."),                         /* CUE_BAD_FILENAME - 42 */
-    N_("Error during write to file."),            /* CUE_WRITE_ERROR - 43 */
+    "",
+    "",
+    "",
+    "",
+    "",
+    "",
+    N_("Invalid shard selection."),              /* CUE_BAD_SHARD - 60 */
     N_("Undefined Error")
   };
 
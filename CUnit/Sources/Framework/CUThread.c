@@ -0,0 +1,469 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Portable thread, mutex and sleep wrappers (internal).
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Thread support functions (implementation).
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L   /* pthreads, nanosleep() under -std=c99 */
+#endif
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "CUThread.h"
+
+/** Thread handle data. */
+struct CU_ThreadImpl
+{
+#ifdef _WIN32
+  HANDLE        hThread;
+#else
+  pthread_t     thread;
+#endif
+  CU_ThreadFunc pFunc;    /**< Thread entry function. */
+  void*         pArg;     /**< Argument for pFunc. */
+};
+
+/** Mutex handle data. */
+struct CU_MutexImpl
+{
+#ifdef _WIN32
+  CRITICAL_SECTION cs;
+#else
+  pthread_mutex_t  mutex;
+#endif
+};
+
+/** Condition variable handle data. */
+struct CU_CondImpl
+{
+#ifdef _WIN32
+  CONDITION_VARIABLE cv;
+#else
+  pthread_cond_t     cond;
+#endif
+};
+
+/*------------------------------------------------------------------------*/
+#ifdef _WIN32
+static unsigned __stdcall thread_start(void* pArg)
+#else
+static void* thread_start(void* pArg)
+#endif
+{
+  struct CU_ThreadImpl* pThread = (struct CU_ThreadImpl*)pArg;
+
+  (*pThread->pFunc)(pThread->pArg);
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+CU_pThread CU_thread_create(CU_ThreadFunc pFunc, void* pArg)
+{
+  struct CU_ThreadImpl* pThread;
+
+  assert(NULL != pFunc);
+
+  if (NULL == (pThread = (struct CU_ThreadImpl*)CU_MALLOC(sizeof(struct CU_ThreadImpl)))) {
+    return NULL;
+  }
+  pThread->pFunc = pFunc;
+  pThread->pArg = pArg;
+
+#ifdef _WIN32
+  pThread->hThread = (HANDLE)_beginthreadex(NULL, 0, thread_start, pThread, 0, NULL);
+  if (0 == pThread->hThread) {
+    CU_FREE(pThread);
+    return NULL;
+  }
+#else
+  if (0 != pthread_create(&pThread->thread, NULL, thread_start, pThread)) {
+    CU_FREE(pThread);
+    return NULL;
+  }
+#endif
+  return pThread;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_thread_join(CU_pThread pThread)
+{
+  assert(NULL != pThread);
+
+#ifdef _WIN32
+  WaitForSingleObject(pThread->hThread, INFINITE);
+  CloseHandle(pThread->hThread);
+#else
+  pthread_join(pThread->thread, NULL);
+#endif
+  CU_FREE(pThread);
+}
+
+/*------------------------------------------------------------------------*/
+CU_pMutex CU_mutex_create(void)
+{
+  struct CU_MutexImpl* pMutex;
+
+  if (NULL == (pMutex = (struct CU_MutexImpl*)CU_MALLOC(sizeof(struct CU_MutexImpl)))) {
+    return NULL;
+  }
+#ifdef _WIN32
+  InitializeCriticalSection(&pMutex->cs);
+#else
+  if (0 != pthread_mutex_init(&pMutex->mutex, NULL)) {
+    CU_FREE(pMutex);
+    return NULL;
+  }
+#endif
+  return pMutex;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_mutex_destroy(CU_pMutex pMutex)
+{
+  if (NULL != pMutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(&pMutex->cs);
+#else
+    pthread_mutex_destroy(&pMutex->mutex);
+#endif
+    CU_FREE(pMutex);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+void CU_mutex_lock(CU_pMutex pMutex)
+{
+  assert(NULL != pMutex);
+#ifdef _WIN32
+  EnterCriticalSection(&pMutex->cs);
+#else
+  pthread_mutex_lock(&pMutex->mutex);
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+void CU_mutex_unlock(CU_pMutex pMutex)
+{
+  assert(NULL != pMutex);
+#ifdef _WIN32
+  LeaveCriticalSection(&pMutex->cs);
+#else
+  pthread_mutex_unlock(&pMutex->mutex);
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+CU_pCond CU_cond_create(void)
+{
+  struct CU_CondImpl* pCond;
+
+  if (NULL == (pCond = (struct CU_CondImpl*)CU_MALLOC(sizeof(struct CU_CondImpl)))) {
+    return NULL;
+  }
+#ifdef _WIN32
+  InitializeConditionVariable(&pCond->cv);
+#else
+  if (0 != pthread_cond_init(&pCond->cond, NULL)) {
+    CU_FREE(pCond);
+    return NULL;
+  }
+#endif
+  return pCond;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_cond_destroy(CU_pCond pCond)
+{
+  if (NULL != pCond) {
+#ifndef _WIN32
+    pthread_cond_destroy(&pCond->cond);
+#endif
+    CU_FREE(pCond);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_cond_wait(CU_pCond pCond, CU_pMutex pMutex, double dTimeout)
+{
+#ifndef _WIN32
+  struct timespec until;
+  double dWhole;
+#endif
+
+  assert(NULL != pCond);
+  assert(NULL != pMutex);
+
+#ifdef _WIN32
+  if (dTimeout < 0.0) {
+    SleepConditionVariableCS(&pCond->cv, &pMutex->cs, INFINITE);
+    return CU_TRUE;
+  }
+  return SleepConditionVariableCS(&pCond->cv, &pMutex->cs, (DWORD)(dTimeout * 1000.0))
+         ? CU_TRUE : ((ERROR_TIMEOUT == GetLastError()) ? CU_FALSE : CU_TRUE);
+#else
+  if (dTimeout < 0.0) {
+    pthread_cond_wait(&pCond->cond, &pMutex->mutex);
+    return CU_TRUE;
+  }
+  /* pthread condition variables time out against the realtime clock */
+  clock_gettime(CLOCK_REALTIME, &until);
+  dTimeout += (double)until.tv_nsec / 1.0e9;
+  dTimeout = modf(dTimeout, &dWhole);
+  until.tv_sec += (time_t)dWhole;
+  until.tv_nsec = (long)(dTimeout * 1.0e9);
+  if (until.tv_nsec >= 1000000000L) {
+    until.tv_nsec = 999999999L;
+  }
+  return (ETIMEDOUT == pthread_cond_timedwait(&pCond->cond, &pMutex->mutex, &until)) ? CU_FALSE : CU_TRUE;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+void CU_cond_broadcast(CU_pCond pCond)
+{
+  assert(NULL != pCond);
+#ifdef _WIN32
+  WakeAllConditionVariable(&pCond->cv);
+#else
+  pthread_cond_broadcast(&pCond->cond);
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+void CU_sleep(double dSeconds)
+{
+#ifdef _WIN32
+  if (dSeconds > 0.0) {
+    Sleep((DWORD)(dSeconds * 1000.0 + 0.5));
+  }
+#else
+  struct timespec ts;
+  double dWhole;
+
+  if (dSeconds > 0.0) {
+    ts.tv_nsec = (long)(modf(dSeconds, &dWhole) * 1.0e9);
+    ts.tv_sec = (time_t)dWhole;
+    while ((0 != nanosleep(&ts, &ts)) && (EINTR == errno))
+      ;
+  }
+#endif
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+#define THREAD_COUNT       4
+#define THREAD_INCREMENTS  10000
+
+/** State shared by the test threads. */
+typedef struct
+{
+  CU_pMutex     pMutex;
+  CU_pCond      pCond;
+  unsigned long ulCount;    /**< Incremented under pMutex. */
+  CU_BOOL       bGo;        /**< Set under pMutex to release waiters. */
+  unsigned int  uiWaiting;  /**< Threads waiting for bGo. */
+} ThreadTestState;
+
+static void count_func(void* pArg)
+{
+  ThreadTestState* pState = (ThreadTestState*)pArg;
+  unsigned int i;
+
+  for (i = 0 ; i < THREAD_INCREMENTS ; ++i) {
+    CU_mutex_lock(pState->pMutex);
+    ++pState->ulCount;
+    CU_mutex_unlock(pState->pMutex);
+  }
+}
+
+static void wait_func(void* pArg)
+{
+  ThreadTestState* pState = (ThreadTestState*)pArg;
+
+  CU_mutex_lock(pState->pMutex);
+  ++pState->uiWaiting;
+  while (CU_FALSE == pState->bGo) {
+    CU_cond_wait(pState->pCond, pState->pMutex, -1.0);
+  }
+  ++pState->ulCount;
+  CU_mutex_unlock(pState->pMutex);
+}
+
+static double now_seconds(void)
+{
+#ifdef _WIN32
+  return (double)GetTickCount() / 1000.0;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1.0e9;
+#endif
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_thread_create()
+ *      CU_thread_join()
+ *      CU_mutex_create()
+ *      CU_mutex_lock()
+ *      CU_mutex_unlock()
+ *      CU_mutex_destroy()
+ */
+static void test_threads_and_mutexes(void)
+{
+  ThreadTestState state;
+  CU_pThread threads[THREAD_COUNT];
+  unsigned int i;
+
+  CU_mutex_destroy(NULL);                       /* NULL is ignored */
+
+  state.pMutex = CU_mutex_create();
+  TEST_FATAL(NULL != state.pMutex);
+  state.ulCount = 0;
+
+  for (i = 0 ; i < THREAD_COUNT ; ++i) {
+    threads[i] = CU_thread_create(count_func, &state);
+    TEST_FATAL(NULL != threads[i]);
+  }
+  for (i = 0 ; i < THREAD_COUNT ; ++i) {
+    CU_thread_join(threads[i]);
+  }
+  TEST(THREAD_COUNT * THREAD_INCREMENTS == state.ulCount);
+
+  CU_mutex_destroy(state.pMutex);
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_cond_create()
+ *      CU_cond_wait()
+ *      CU_cond_broadcast()
+ *      CU_cond_destroy()
+ */
+static void test_condition_variables(void)
+{
+  ThreadTestState state;
+  CU_pThread threads[THREAD_COUNT];
+  unsigned int i;
+  double dStart;
+  double dElapsed;
+
+  CU_cond_destroy(NULL);                        /* NULL is ignored */
+
+  state.pMutex = CU_mutex_create();
+  state.pCond = CU_cond_create();
+  TEST_FATAL(NULL != state.pMutex);
+  TEST_FATAL(NULL != state.pCond);
+  state.ulCount = 0;
+  state.bGo = CU_FALSE;
+  state.uiWaiting = 0;
+
+  /* a timed wait nobody signals times out after (about) the timeout */
+  CU_mutex_lock(state.pMutex);
+  dStart = now_seconds();
+  while (CU_TRUE == CU_cond_wait(state.pCond, state.pMutex, 0.05))
+    ;                                           /* spurious wakeups */
+  dElapsed = now_seconds() - dStart;
+  CU_mutex_unlock(state.pMutex);
+  TEST(dElapsed >= 0.04);
+  TEST(dElapsed < 5.0);
+
+  /* a broadcast releases every waiter */
+  for (i = 0 ; i < THREAD_COUNT ; ++i) {
+    threads[i] = CU_thread_create(wait_func, &state);
+    TEST_FATAL(NULL != threads[i]);
+  }
+  CU_mutex_lock(state.pMutex);
+  while (THREAD_COUNT != state.uiWaiting) {
+    CU_mutex_unlock(state.pMutex);
+    CU_sleep(0.001);
+    CU_mutex_lock(state.pMutex);
+  }
+  TEST(0 == state.ulCount);                     /* all still waiting */
+  state.bGo = CU_TRUE;
+  CU_cond_broadcast(state.pCond);
+  CU_mutex_unlock(state.pMutex);
+
+  for (i = 0 ; i < THREAD_COUNT ; ++i) {
+    CU_thread_join(threads[i]);
+  }
+  TEST(THREAD_COUNT == state.ulCount);
+
+  CU_cond_destroy(state.pCond);
+  CU_mutex_destroy(state.pMutex);
+}
+
+/*-------------------------------------------------*/
+static void test_CU_sleep(void)
+{
+  double dStart;
+  double dElapsed;
+
+  dStart = now_seconds();
+  CU_sleep(0.0);                                /* no-ops */
+  CU_sleep(-1.0);
+  TEST(now_seconds() - dStart < 1.0);
+
+  dStart = now_seconds();
+  CU_sleep(0.05);
+  dElapsed = now_seconds() - dStart;
+  TEST(dElapsed >= 0.04);
+  TEST(dElapsed < 5.0);
+}
+
+void test_cunit_CUThread(void)
+{
+  test_cunit_start_tests("CUThread.c");
+
+  test_threads_and_mutexes();
+  test_condition_variables();
+  test_CU_sleep();
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
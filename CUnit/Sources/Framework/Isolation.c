@@ -0,0 +1,1395 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of process isolation of tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *  18-Oct-2026   Added per-test resource limits. (AGT)
+ *  18-Oct-2026   Added per-suite fixture snapshots. (AGT)
+ */
+
+/** @file
+ *  Process isolation of tests (implementation).
+ *  The test program sends a worker the address of each test to run
+ *  over a command pipe (valid in the worker, which is a fork() of the
+ *  test program).  The worker answers over a result pipe with an
+ *  ISOLATION_FAILURE message for each failure as it happens, so the
+ *  failures of a test that then crashes are not lost, and an
+ *  ISOLATION_DONE message with the counts and timings of the test.
+ *  A worker exits when its command pipe is closed, or after a test with
+ *  limits, which it applies to itself before running the test.  The
+ *  test program watches a worker running a test with limits through
+ *  /proc while it waits for its messages.
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L   /* fork(), pipe(), waitpid(), sigaction(), dirfd() under -std=c99 */
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <signal.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <dirent.h>
+#endif
+#endif
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "TestRun.h"
+#include "Util.h"
+#include "Isolation.h"
+#include "CUnit_intl.h"
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+static CU_IsolationMode f_mode = CU_ISOLATION_NONE;  /**< Selected isolation mode. */
+static unsigned int f_uiBatchSize = 1;               /**< Tests run by each worker. */
+static unsigned int f_uiWorkersStarted = 0;          /**< Workers forked since CU_set_isolation(). */
+
+/** Names of the signals a worker is likely to die of. */
+static const struct
+{
+  int         iSignal;
+  const char* szName;
+} f_aSignalNames[] = {
+  {SIGABRT, "SIGABRT"},
+  {SIGFPE,  "SIGFPE"},
+  {SIGILL,  "SIGILL"},
+  {SIGINT,  "SIGINT"},
+  {SIGSEGV, "SIGSEGV"},
+  {SIGTERM, "SIGTERM"},
+#ifdef SIGALRM
+  {SIGALRM, "SIGALRM"},
+#endif
+#ifdef SIGBUS
+  {SIGBUS,  "SIGBUS"},
+#endif
+#ifdef SIGHUP
+  {SIGHUP,  "SIGHUP"},
+#endif
+#ifdef SIGKILL
+  {SIGKILL, "SIGKILL"},
+#endif
+#ifdef SIGPIPE
+  {SIGPIPE, "SIGPIPE"},
+#endif
+#ifdef SIGQUIT
+  {SIGQUIT, "SIGQUIT"},
+#endif
+#ifdef SIGSYS
+  {SIGSYS,  "SIGSYS"},
+#endif
+#ifdef SIGTRAP
+  {SIGTRAP, "SIGTRAP"},
+#endif
+#ifdef SIGUSR1
+  {SIGUSR1, "SIGUSR1"},
+#endif
+#ifdef SIGUSR2
+  {SIGUSR2, "SIGUSR2"},
+#endif
+#ifdef SIGXCPU
+  {SIGXCPU, "SIGXCPU"},
+#endif
+#ifdef SIGXFSZ
+  {SIGXFSZ, "SIGXFSZ"},
+#endif
+};
+
+#ifndef _WIN32
+
+/** Types of messages sent by a worker. */
+typedef enum IsolationMessageType
+{
+  ISOLATION_FAILURE = 1,  /**< A failure, followed by its condition and file name. */
+  ISOLATION_DONE          /**< The test is complete. */
+} IsolationMessageType;
+
+/** Message sent by a worker. */
+typedef struct IsolationMessage
+{
+  IsolationMessageType type;        /**< Type of message. */
+  CU_FailureType failureType;       /**< Type of failure (ISOLATION_FAILURE). */
+  unsigned int   uiLine;            /**< Line of the failure (ISOLATION_FAILURE). */
+  unsigned int   uiConditionSize;   /**< Length + 1 of the condition following the message, 0 if NULL (ISOLATION_FAILURE). */
+  unsigned int   uiFileSize;        /**< Length + 1 of the file name following the condition, 0 if NULL (ISOLATION_FAILURE). */
+  unsigned int   nAsserts;          /**< Assertions of the test so far. */
+  unsigned int   nAssertsFailed;    /**< Failed assertions of the test so far. */
+  double         dSetUp;            /**< Timings of the test (ISOLATION_DONE). */
+  double         dRun;
+  double         dTearDown;
+  double         dCpuTime;
+  double         dPeakRss;          /**< Peak resident memory of the worker (ISOLATION_DONE, tests with limits). */
+} IsolationMessage;
+
+/** Command sent to a worker. */
+typedef struct IsolationCommand
+{
+  CU_pTest pTest;                   /**< Test to run. */
+} IsolationCommand;
+
+/** A worker as seen by the test program. */
+typedef struct IsolationWorker
+{
+  pid_t        pid;                 /**< Process id, 0 if there is no worker. */
+  int          iCommand;            /**< Write end of the command pipe. */
+  int          iResult;             /**< Read end of the result pipe. */
+  unsigned int uiTests;             /**< Tests sent to the worker. */
+} IsolationWorker;
+
+static IsolationWorker f_active = {0, -1, -1, 0};   /**< Worker running the tests of the suite. */
+static IsolationWorker f_spare = {0, -1, -1, 0};    /**< Worker forked ahead of need. */
+static CU_IsolatedTestFunc f_pRunTest = NULL;       /**< Runs a test inside a worker. */
+static unsigned int f_uiSuiteBatch = 0;             /**< Tests run by each worker of the current suite (0: tests with limits only). */
+static struct sigaction f_oldSigpipe;               /**< SIGPIPE action outside isolated suites. */
+static int f_iResultPipe = -1;                      /**< Write end of the result pipe in a worker. */
+
+/*=================================================================
+ *  Private functions
+ *=================================================================*/
+/** Writes a buffer completely. @return CU_FALSE on error. */
+static CU_BOOL write_all(int iFile, const void* pBuffer, size_t szBytes)
+{
+  const char* pNext = (const char*)pBuffer;
+  ssize_t iWritten;
+
+  while (szBytes > 0) {
+    iWritten = write(iFile, pNext, szBytes);
+    if (iWritten < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return CU_FALSE;
+    }
+    pNext += iWritten;
+    szBytes -= (size_t)iWritten;
+  }
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads a buffer completely. @return CU_FALSE on error or end of file. */
+static CU_BOOL read_all(int iFile, void* pBuffer, size_t szBytes)
+{
+  char* pNext = (char*)pBuffer;
+  ssize_t iRead;
+
+  while (szBytes > 0) {
+    iRead = read(iFile, pNext, szBytes);
+    if (iRead < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return CU_FALSE;
+    }
+    if (0 == iRead) {
+      return CU_FALSE;
+    }
+    pNext += iRead;
+    szBytes -= (size_t)iRead;
+  }
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Closes the pipes of a worker and waits for it to exit. @return Its status from waitpid(). */
+static int stop_worker(IsolationWorker* pWorker)
+{
+  int iStatus = 0;
+
+  if (0 != pWorker->pid) {
+    close(pWorker->iCommand);
+    close(pWorker->iResult);
+    while ((waitpid(pWorker->pid, &iStatus, 0) < 0) && (EINTR == errno))
+      ;
+  }
+  pWorker->pid = 0;
+  pWorker->iCommand = -1;
+  pWorker->iResult = -1;
+  pWorker->uiTests = 0;
+  return iStatus;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Reads a value in kB or a count from /proc/<pid>/status (Linux).
+ *  @param pid   The process, 0 for the calling process.
+ *  @param szKey The field, e.g. "VmRSS".
+ *  @return CU_FALSE if the value could not be read.
+ */
+static CU_BOOL read_proc_status(pid_t pid, const char* szKey, double* pdValue)
+{
+  CU_BOOL bFound = CU_FALSE;
+#ifdef __linux__
+  char szPath[64];
+  char szLine[128];
+  size_t szKeyLength = strlen(szKey);
+  FILE* pFile;
+
+  if (0 == pid) {
+    strcpy(szPath, "/proc/self/status");
+  }
+  else {
+    snprintf(szPath, sizeof(szPath), "/proc/%ld/status", (long)pid);
+  }
+  if (NULL != (pFile = fopen(szPath, "r"))) {
+    while ((CU_FALSE == bFound) && (NULL != fgets(szLine, sizeof(szLine), pFile))) {
+      if ((0 == strncmp(szLine, szKey, szKeyLength)) && (':' == szLine[szKeyLength])) {
+        *pdValue = atof(szLine + szKeyLength + 1);
+        bFound = CU_TRUE;
+      }
+    }
+    fclose(pFile);
+  }
+#else
+  CU_UNREFERENCED_PARAMETER(pid);
+  CU_UNREFERENCED_PARAMETER(szKey);
+  CU_UNREFERENCED_PARAMETER(pdValue);
+#endif
+  return bFound;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Counts the open file descriptors of a process (Linux).
+ *  @param pid The process, 0 for the calling process.
+ *  @return The count, or -1 if it could not be read.
+ */
+static int count_open_files(pid_t pid)
+{
+  int iCount = -1;
+#ifdef __linux__
+  char szPath[64];
+  DIR* pDir;
+  struct dirent* pEntry;
+
+  if (0 == pid) {
+    strcpy(szPath, "/proc/self/fd");
+  }
+  else {
+    snprintf(szPath, sizeof(szPath), "/proc/%ld/fd", (long)pid);
+  }
+  if (NULL != (pDir = opendir(szPath))) {
+    iCount = 0;
+    while (NULL != (pEntry = readdir(pDir))) {
+      if ('.' != pEntry->d_name[0]) {
+        ++iCount;
+      }
+    }
+    closedir(pDir);
+    if (0 == pid) {
+      --iCount;                   /* not the one opendir() holds */
+    }
+  }
+#else
+  CU_UNREFERENCED_PARAMETER(pid);
+#endif
+  return iCount;
+}
+
+/*------------------------------------------------------------------------*/
+/** Finds the highest open file descriptor of the calling process. @return It, or -1 if none. */
+static int highest_open_file(void)
+{
+  int iHighest = -1;
+#ifdef __linux__
+  DIR* pDir;
+  struct dirent* pEntry;
+  int iFile;
+  int iSelf;
+
+  if (NULL != (pDir = opendir("/proc/self/fd"))) {
+    iSelf = dirfd(pDir);
+    while (NULL != (pEntry = readdir(pDir))) {
+      iFile = atoi(pEntry->d_name);
+      if (('.' != pEntry->d_name[0]) && (iFile != iSelf) && (iFile > iHighest)) {
+        iHighest = iFile;
+      }
+    }
+    closedir(pDir);
+    return iHighest;
+  }
+#endif
+  for (iHighest = 1023 ; iHighest >= 0 ; --iHighest) {
+    if ((fcntl(iHighest, F_GETFD) >= 0) || (EBADF != errno)) {
+      break;
+    }
+  }
+  return iHighest;
+}
+
+/*------------------------------------------------------------------------*/
+/** Lowers the soft limit of a resource to dValue, within its hard limit. */
+static void set_soft_limit(int iResource, double dValue)
+{
+  struct rlimit limit;
+
+  if (0 == getrlimit(iResource, &limit)) {
+    if ((RLIM_INFINITY == limit.rlim_max) || (dValue < (double)limit.rlim_max)) {
+      limit.rlim_cur = (rlim_t)dValue;
+    }
+    else {
+      limit.rlim_cur = limit.rlim_max;
+    }
+    setrlimit(iResource, &limit);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Applies the limits of a test to the worker about to run it.  The
+ *  processor time and address space limits are relative to what the
+ *  worker has used so far; the test program enforces the absolute
+ *  limits by sampling the worker.
+ */
+static void apply_limits(const CU_TestLimits* pLimits)
+{
+  struct rusage usage;
+  struct rlimit limit;
+  double dValue;
+  int iHighest;
+
+  if ((0 != pLimits->uiMaxCpuSeconds) && (0 == getrusage(RUSAGE_SELF, &usage))) {
+    /* SIGXCPU at the soft limit, SIGKILL one second later */
+    dValue = (double)usage.ru_utime.tv_sec + (double)usage.ru_stime.tv_sec + pLimits->uiMaxCpuSeconds;
+    if (0 == getrlimit(RLIMIT_CPU, &limit)) {
+      if ((RLIM_INFINITY == limit.rlim_max) || (dValue + 1.0 < (double)limit.rlim_max)) {
+        limit.rlim_max = (rlim_t)(dValue + 1.0);
+      }
+      limit.rlim_cur = ((double)limit.rlim_max < dValue) ? limit.rlim_max : (rlim_t)dValue;
+      setrlimit(RLIMIT_CPU, &limit);
+    }
+  }
+
+  if (0 != pLimits->uiMaxOpenFiles) {
+    /* descriptors are numbered from 0, so leave room above the highest open one */
+    iHighest = highest_open_file();
+    set_soft_limit(RLIMIT_NOFILE, (double)iHighest + 1.0 + pLimits->uiMaxOpenFiles);
+  }
+
+#ifdef RLIMIT_AS
+  if (0 != pLimits->szMaxRss) {
+    if (CU_FALSE != read_proc_status(0, "VmSize", &dValue)) {
+      set_soft_limit(RLIMIT_AS, dValue * 1024.0 +
+                                (double)CU_LIMITS_ADDRESS_SPACE_FACTOR * (double)pLimits->szMaxRss);
+    }
+  }
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+/** Body of a worker: runs the tests it is sent until its command pipe is closed. */
+static void run_worker(int iCommand)
+{
+  IsolationCommand command;
+  IsolationMessage message;
+  CU_IsolatedResult result;
+  const CU_TestLimits* pLimits;
+  double dPeakRss = 0.0;
+
+  while (CU_FALSE != read_all(iCommand, &command, sizeof(command))) {
+    pLimits = command.pTest->pLimits;
+    if (NULL != pLimits) {
+      apply_limits(pLimits);
+    }
+
+    memset(&result, 0, sizeof(result));
+    (*f_pRunTest)(command.pTest, &result);
+
+    /* output of the test goes before the test program reports it */
+    fflush(NULL);
+
+    memset(&message, 0, sizeof(message));
+    message.type = ISOLATION_DONE;
+    message.nAsserts = result.nAsserts;
+    message.nAssertsFailed = result.nAssertsFailed;
+    message.dSetUp = result.dSetUp;
+    message.dRun = result.dRun;
+    message.dTearDown = result.dTearDown;
+    message.dCpuTime = result.dCpuTime;
+    if ((NULL != pLimits) && (CU_FALSE != read_proc_status(0, "VmHWM", &dPeakRss))) {
+      message.dPeakRss = dPeakRss * 1024.0;
+    }
+    if ((CU_FALSE == write_all(f_iResultPipe, &message, sizeof(message))) ||
+        (NULL != pLimits)) {      /* the limits stay with the worker */
+      break;
+    }
+  }
+  fflush(NULL);
+  _exit(0);
+}
+
+/*------------------------------------------------------------------------*/
+/** Forks a worker from the current state of the test program. @return CU_FALSE on failure. */
+static CU_BOOL start_worker(IsolationWorker* pWorker)
+{
+  int aiCommand[2];
+  int aiResult[2];
+  pid_t pid;
+
+  assert(0 == pWorker->pid);
+
+  if (0 != pipe(aiCommand)) {
+    return CU_FALSE;
+  }
+  if (0 != pipe(aiResult)) {
+    close(aiCommand[0]);
+    close(aiCommand[1]);
+    return CU_FALSE;
+  }
+
+  /* leave the event writer idle and output unbuffered across fork() */
+  CU_flush_listener_events(-1.0);
+  fflush(NULL);
+
+  pid = fork();
+  if (pid < 0) {
+    close(aiCommand[0]);
+    close(aiCommand[1]);
+    close(aiResult[0]);
+    close(aiResult[1]);
+    return CU_FALSE;
+  }
+  if (0 == pid) {
+    close(aiCommand[1]);
+    close(aiResult[0]);
+    /* other workers must see the end of their command pipes */
+    if (0 != f_active.pid) {
+      close(f_active.iCommand);
+      close(f_active.iResult);
+    }
+    if (0 != f_spare.pid) {
+      close(f_spare.iCommand);
+      close(f_spare.iResult);
+    }
+    sigaction(SIGPIPE, &f_oldSigpipe, NULL);
+    f_iResultPipe = aiResult[1];
+    run_worker(aiCommand[0]);
+  }
+
+  close(aiCommand[0]);
+  close(aiResult[1]);
+  pWorker->pid = pid;
+  pWorker->iCommand = aiCommand[1];
+  pWorker->iResult = aiResult[0];
+  pWorker->uiTests = 0;
+  ++f_uiWorkersStarted;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Samples a worker running a test with limits (Linux) and records the
+ *  peaks in pResult.
+ *  @return The limit the worker exceeds, CU_LIMIT_NONE if none.
+ */
+static CU_TestLimit sample_worker(pid_t pid, const CU_TestLimits* pLimits, CU_IsolatedResult* pResult)
+{
+  double dValue;
+  int iCount;
+
+  if (CU_FALSE != read_proc_status(pid, "VmRSS", &dValue)) {
+    dValue *= 1024.0;
+    if (dValue > pResult->dPeakRss) {
+      pResult->dPeakRss = dValue;
+    }
+    if ((0 != pLimits->szMaxRss) && (dValue > (double)pLimits->szMaxRss)) {
+      return CU_LIMIT_MEMORY;
+    }
+  }
+  if (CU_FALSE != read_proc_status(pid, "Threads", &dValue)) {
+    if ((unsigned int)dValue > pResult->uiPeakThreads) {
+      pResult->uiPeakThreads = (unsigned int)dValue;
+    }
+    if ((0 != pLimits->uiMaxThreads) && ((unsigned int)dValue > pLimits->uiMaxThreads)) {
+      return CU_LIMIT_THREADS;
+    }
+  }
+  if ((iCount = count_open_files(pid)) >= 0) {
+    if ((unsigned int)iCount > pResult->uiPeakOpenFiles) {
+      pResult->uiPeakOpenFiles = (unsigned int)iCount;
+    }
+    if ((0 != pLimits->uiMaxOpenFiles) && ((unsigned int)iCount > pLimits->uiMaxOpenFiles)) {
+      return CU_LIMIT_OPEN_FILES;
+    }
+  }
+  return CU_LIMIT_NONE;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Reads the next message of the active worker.  For a test with limits
+ *  the worker is sampled while the test program waits, and killed when
+ *  it exceeds a limit.
+ *  @return CU_FALSE if the worker died or was killed.
+ */
+static CU_BOOL read_message(const CU_TestLimits* pLimits, IsolationMessage* pMessage,
+                            CU_IsolatedResult* pResult)
+{
+  struct pollfd result;
+  int iReady;
+
+  if (NULL != pLimits) {
+    result.fd = f_active.iResult;
+    result.events = POLLIN;
+    for (;;) {
+      result.revents = 0;
+      iReady = poll(&result, 1, (int)(CU_LIMITS_SAMPLE_INTERVAL * 1000.0 + 0.5));
+      if (iReady > 0) {
+        break;
+      }
+      if ((iReady < 0) && (EINTR != errno)) {
+        break;
+      }
+      if (CU_LIMIT_NONE != (pResult->exceeded = sample_worker(f_active.pid, pLimits, pResult))) {
+        kill(f_active.pid, SIGKILL);
+        return CU_FALSE;
+      }
+    }
+  }
+  return read_all(f_active.iResult, pMessage, sizeof(IsolationMessage));
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Completes the peaks of a test with limits after its worker exited
+ *  and checks the limits the samples could not.
+ *  @param pBefore Resource usage of the reaped children before the test.
+ *  @param iStatus Status of the worker from waitpid().
+ */
+static void check_limits(const CU_TestLimits* pLimits, const struct rusage* pBefore,
+                         int iStatus, CU_IsolatedResult* pResult)
+{
+  struct rusage after;
+
+  if (0 == getrusage(RUSAGE_CHILDREN, &after)) {
+    pResult->dPeakCpu =
+        (double)(after.ru_utime.tv_sec - pBefore->ru_utime.tv_sec) +
+        (double)(after.ru_stime.tv_sec - pBefore->ru_stime.tv_sec) +
+        (double)(after.ru_utime.tv_usec - pBefore->ru_utime.tv_usec) / 1.0e6 +
+        (double)(after.ru_stime.tv_usec - pBefore->ru_stime.tv_usec) / 1.0e6;
+  }
+
+  if (CU_LIMIT_NONE != pResult->exceeded) {
+    return;
+  }
+  if ((0 != pLimits->uiMaxCpuSeconds) &&
+      ((WIFSIGNALED(iStatus) && (SIGXCPU == WTERMSIG(iStatus))) ||
+       (pResult->dPeakCpu > (double)pLimits->uiMaxCpuSeconds))) {
+    pResult->exceeded = CU_LIMIT_CPU;
+  }
+  else if ((0 != pLimits->szMaxRss) && (pResult->dPeakRss > (double)pLimits->szMaxRss)) {
+    pResult->exceeded = CU_LIMIT_MEMORY;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Reads a string following a failure message into szBuffer (of
+ *  CU_ISOLATION_MAX_STRING + 1 bytes).  uiSize is the length + 1 sent
+ *  by the worker, 0 for NULL.
+ *  @return CU_FALSE if the worker died.
+ */
+static CU_BOOL read_string(int iFile, unsigned int uiSize, char* szBuffer)
+{
+  if (uiSize > CU_ISOLATION_MAX_STRING + 1) {
+    return CU_FALSE;
+  }
+  szBuffer[(0 != uiSize) ? uiSize - 1 : 0] = '\0';
+  return (uiSize <= 1) ? CU_TRUE : read_all(iFile, szBuffer, uiSize - 1);
+}
+
+#endif  /* _WIN32 */
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_ErrorCode CU_set_isolation(CU_IsolationMode mode, unsigned int uiBatchSize)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if ((CU_ISOLATION_NONE != mode) && (CU_ISOLATION_TEST != mode) && (CU_ISOLATION_BATCH != mode)) {
+    result = CUE_BAD_ISOLATION_PARAMS;
+  }
+  else if ((CU_ISOLATION_BATCH == mode) && (0 == uiBatchSize)) {
+    result = CUE_BAD_ISOLATION_PARAMS;
+  }
+  else {
+#ifdef _WIN32
+    if (CU_ISOLATION_NONE != mode) {
+      result = CUE_ISOLATION_UNAVAILABLE;
+    }
+#endif
+    if (CUE_SUCCESS == result) {
+      f_mode = mode;
+      f_uiBatchSize = (CU_ISOLATION_BATCH == mode) ? uiBatchSize : 1;
+      f_uiWorkersStarted = 0;
+    }
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+CU_IsolationMode CU_get_isolation_mode(void)
+{
+  return f_mode;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_isolation_batch_size(void)
+{
+  return f_uiBatchSize;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_isolation_workers_started(void)
+{
+  return f_uiWorkersStarted;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_suite_snapshot(CU_pSuite pSuite, unsigned int uiBatchSize)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if (NULL == pSuite) {
+    result = CUE_NOSUITE;
+  }
+  else {
+#ifdef _WIN32
+    if (0 != uiBatchSize) {
+      result = CUE_ISOLATION_UNAVAILABLE;
+    }
+#endif
+    if (CUE_SUCCESS == result) {
+      pSuite->uiSnapshotBatch = uiBatchSize;
+    }
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_suite_snapshot(CU_pSuite pSuite)
+{
+  return (NULL != pSuite) ? pSuite->uiSnapshotBatch : 0;
+}
+
+/*------------------------------------------------------------------------*/
+const char* CU_get_signal_name(int iSignal)
+{
+  size_t i;
+
+  for (i = 0 ; i < sizeof(f_aSignalNames)/sizeof(f_aSignalNames[0]) ; ++i) {
+    if (iSignal == f_aSignalNames[i].iSignal) {
+      return f_aSignalNames[i].szName;
+    }
+  }
+  return _("unknown signal");
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_test_limits(CU_pTest pTest, const CU_TestLimits* pLimits)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if (NULL == pTest) {
+    result = CUE_NOTEST;
+  }
+  else if ((NULL == pLimits) ||
+           ((0 == pLimits->szMaxRss) && (0 == pLimits->uiMaxCpuSeconds) &&
+            (0 == pLimits->uiMaxOpenFiles) && (0 == pLimits->uiMaxThreads))) {
+    if (NULL != pTest->pLimits) {
+      CU_FREE(pTest->pLimits);
+      pTest->pLimits = NULL;
+    }
+  }
+  else {
+#ifdef _WIN32
+    result = CUE_ISOLATION_UNAVAILABLE;
+#else
+    if ((NULL == pTest->pLimits) &&
+        (NULL == (pTest->pLimits = (CU_TestLimits*)CU_MALLOC(sizeof(CU_TestLimits))))) {
+      result = CUE_NOMEMORY;
+    }
+    else {
+      *pTest->pLimits = *pLimits;
+    }
+#endif
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_TestLimits* CU_get_test_limits(CU_pTest pTest)
+{
+  return (NULL != pTest) ? pTest->pLimits : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+const char* CU_get_test_limit_name(CU_TestLimit limit)
+{
+  switch (limit) {
+    case CU_LIMIT_MEMORY:
+      return _("memory");
+    case CU_LIMIT_CPU:
+      return _("processor time");
+    case CU_LIMIT_OPEN_FILES:
+      return _("open file");
+    case CU_LIMIT_THREADS:
+      return _("thread");
+    default:
+      return _("unknown");
+  }
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_is_isolation_worker(void)
+{
+#ifdef _WIN32
+  return CU_FALSE;
+#else
+  return (f_iResultPipe >= 0) ? CU_TRUE : CU_FALSE;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_isolation_begin_suite(CU_IsolatedTestFunc pRunTest, unsigned int uiBatchSize)
+{
+#ifdef _WIN32
+  CU_UNREFERENCED_PARAMETER(pRunTest);
+  CU_UNREFERENCED_PARAMETER(uiBatchSize);
+  return CUE_ISOLATION_UNAVAILABLE;
+#else
+  struct sigaction ignore;
+
+  assert(NULL != pRunTest);
+  assert(NULL == f_pRunTest);
+
+  f_pRunTest = pRunTest;
+  f_uiSuiteBatch = uiBatchSize;
+
+  /* a worker dying before it reads its command must not kill the test program */
+  memset(&ignore, 0, sizeof(ignore));
+  ignore.sa_handler = SIG_IGN;
+  sigemptyset(&ignore.sa_mask);
+  sigaction(SIGPIPE, &ignore, &f_oldSigpipe);
+
+  return (CU_FALSE != start_worker(&f_spare)) ? CUE_SUCCESS : CUE_ISOLATION_UNAVAILABLE;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_isolation_run_test(CU_pTest pTest, CU_IsolatedFailureFunc pFailure,
+                                   CU_IsolatedResult* pResult)
+{
+#ifdef _WIN32
+  CU_UNREFERENCED_PARAMETER(pTest);
+  CU_UNREFERENCED_PARAMETER(pFailure);
+  memset(pResult, 0, sizeof(CU_IsolatedResult));
+  return CUE_ISOLATION_UNAVAILABLE;
+#else
+  IsolationCommand command;
+  IsolationMessage message;
+  char szCondition[CU_ISOLATION_MAX_STRING + 1];
+  char szFile[CU_ISOLATION_MAX_STRING + 1];
+  const CU_TestLimits* pLimits;
+  struct rusage before;
+  double dStartTime;
+  int iStatus = 0;
+
+  assert(NULL != pTest);
+  assert(NULL != pFailure);
+  assert(NULL != pResult);
+  assert(NULL != f_pRunTest);
+
+  memset(pResult, 0, sizeof(CU_IsolatedResult));
+
+  /* a test with limits gets a worker of its own */
+  pLimits = pTest->pLimits;
+  if ((NULL != pLimits) && (0 != f_active.pid) && (0 != f_active.uiTests)) {
+    stop_worker(&f_active);
+  }
+
+  if (0 == f_active.pid) {
+    if (0 != f_spare.pid) {
+      f_active = f_spare;
+      f_spare.pid = 0;
+      f_spare.iCommand = -1;
+      f_spare.iResult = -1;
+    }
+    else if (CU_FALSE == start_worker(&f_active)) {
+      return CUE_ISOLATION_UNAVAILABLE;
+    }
+  }
+
+  if ((NULL != pLimits) && (0 != getrusage(RUSAGE_CHILDREN, &before))) {
+    memset(&before, 0, sizeof(before));
+  }
+
+  dStartTime = CU_get_monotonic_time();
+  command.pTest = pTest;
+  if (CU_FALSE != write_all(f_active.iCommand, &command, sizeof(command))) {
+    /* prefork the successor of a worker running its last test */
+    ++f_active.uiTests;
+    if (((NULL != pLimits) || (f_active.uiTests >= f_uiSuiteBatch)) &&
+        (0 != f_uiSuiteBatch) && (0 == f_spare.pid)) {
+      start_worker(&f_spare);
+    }
+
+    while (CU_FALSE != read_message(pLimits, &message, pResult)) {
+      pResult->nAsserts = message.nAsserts;
+      pResult->nAssertsFailed = message.nAssertsFailed;
+      if (ISOLATION_DONE == message.type) {
+        pResult->bCompleted = CU_TRUE;
+        pResult->dSetUp = message.dSetUp;
+        pResult->dRun = message.dRun;
+        pResult->dTearDown = message.dTearDown;
+        pResult->dCpuTime = message.dCpuTime;
+        if (message.dPeakRss > pResult->dPeakRss) {
+          pResult->dPeakRss = message.dPeakRss;
+        }
+        break;
+      }
+      if ((CU_FALSE == read_string(f_active.iResult, message.uiConditionSize, szCondition)) ||
+          (CU_FALSE == read_string(f_active.iResult, message.uiFileSize, szFile))) {
+        break;
+      }
+      (*pFailure)(message.failureType, message.uiLine,
+                  (0 != message.uiConditionSize) ? szCondition : NULL,
+                  (0 != message.uiFileSize) ? szFile : NULL);
+    }
+  }
+
+  if (CU_FALSE == pResult->bCompleted) {
+    pResult->dRun = CU_get_monotonic_time() - dStartTime;
+    iStatus = stop_worker(&f_active);
+    if (WIFSIGNALED(iStatus)) {
+      pResult->iSignal = WTERMSIG(iStatus);
+    }
+    else if (WIFEXITED(iStatus)) {
+      pResult->iExitStatus = WEXITSTATUS(iStatus);
+    }
+  }
+  else if ((NULL != pLimits) || (f_active.uiTests >= f_uiSuiteBatch)) {
+    iStatus = stop_worker(&f_active);
+  }
+
+  if (NULL != pLimits) {
+    check_limits(pLimits, &before, iStatus, pResult);
+  }
+
+  return CUE_SUCCESS;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+void CU_isolation_end_suite(void)
+{
+#ifndef _WIN32
+  if (NULL != f_pRunTest) {
+    stop_worker(&f_active);
+    stop_worker(&f_spare);
+    sigaction(SIGPIPE, &f_oldSigpipe, NULL);
+    f_pRunTest = NULL;
+  }
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+void CU_isolation_report_failure(CU_FailureType type, unsigned int uiLine,
+                                 const char* szCondition, const char* szFile,
+                                 unsigned int nAsserts, unsigned int nAssertsFailed)
+{
+#ifdef _WIN32
+  CU_UNREFERENCED_PARAMETER(type);
+  CU_UNREFERENCED_PARAMETER(uiLine);
+  CU_UNREFERENCED_PARAMETER(szCondition);
+  CU_UNREFERENCED_PARAMETER(szFile);
+  CU_UNREFERENCED_PARAMETER(nAsserts);
+  CU_UNREFERENCED_PARAMETER(nAssertsFailed);
+#else
+  char buffer[sizeof(IsolationMessage) + 2 * CU_ISOLATION_MAX_STRING];
+  IsolationMessage message;
+  size_t szConditionBytes = (NULL != szCondition) ? strlen(szCondition) : 0;
+  size_t szFileBytes = (NULL != szFile) ? strlen(szFile) : 0;
+
+  if (f_iResultPipe < 0) {
+    return;
+  }
+
+  szConditionBytes = (szConditionBytes > CU_ISOLATION_MAX_STRING) ? CU_ISOLATION_MAX_STRING : szConditionBytes;
+  szFileBytes = (szFileBytes > CU_ISOLATION_MAX_STRING) ? CU_ISOLATION_MAX_STRING : szFileBytes;
+
+  memset(&message, 0, sizeof(message));
+  message.type = ISOLATION_FAILURE;
+  message.failureType = type;
+  message.uiLine = uiLine;
+  message.uiConditionSize = (NULL != szCondition) ? (unsigned int)szConditionBytes + 1 : 0;
+  message.uiFileSize = (NULL != szFile) ? (unsigned int)szFileBytes + 1 : 0;
+  message.nAsserts = nAsserts;
+  message.nAssertsFailed = nAssertsFailed;
+
+  memcpy(buffer, &message, sizeof(message));
+  if (0 != szConditionBytes) {
+    memcpy(buffer + sizeof(message), szCondition, szConditionBytes);
+  }
+  if (0 != szFileBytes) {
+    memcpy(buffer + sizeof(message) + szConditionBytes, szFile, szFileBytes);
+  }
+  write_all(f_iResultPipe, buffer, sizeof(message) + szConditionBytes + szFileBytes);
+#endif
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+#include "CUThread.h"
+
+#ifndef _WIN32
+static int f_iFixture = 0;      /**< Set by the suite setup function in the test program. */
+static int f_iShared = 0;       /**< Changed by the tests in the workers only. */
+
+static int iso_init(void)  { f_iFixture = 42; return 0; }
+static int iso_clean(void) { f_iFixture = 0;  return 0; }
+
+static void iso_pass(void)
+{
+  CU_ASSERT_EQUAL(f_iFixture, 42);
+  ++f_iShared;
+  CU_ASSERT(CU_TRUE);
+}
+
+static void iso_fail(void)
+{
+  CU_ASSERT(CU_TRUE);
+  CU_ASSERT_EQUAL(f_iShared, 99);
+}
+
+static void iso_crash(void)
+{
+  CU_ASSERT(CU_FALSE);            /* streamed before the crash */
+  raise(SIGSEGV);
+}
+
+static void iso_exits(void)
+{
+  exit(3);
+}
+
+static void iso_first(void)  { CU_ASSERT_EQUAL(++f_iShared, 1); }
+static void iso_second(void) { CU_ASSERT_EQUAL(++f_iShared, 2); }
+
+static int f_iInits = 0;        /**< Calls of the snapshot suite initialization function. */
+static int f_iCleanups = 0;     /**< Calls of the snapshot suite cleanup function. */
+
+static int snap_init(void)  { ++f_iInits; f_iFixture = 42; return 0; }
+static int snap_clean(void) { ++f_iCleanups; f_iFixture = 0; return 0; }
+
+static void snap_mutate(void)
+{
+  CU_ASSERT_EQUAL(f_iFixture, 42);   /* pristine fixture */
+  f_iFixture = 7;
+}
+
+#ifdef __linux__
+#define LIMITS_TEST_MEMORY (64 * 1024 * 1024)
+
+static void iso_memory(void)
+{
+  /* written through a volatile pointer so the optimizer cannot drop the
+   * pages as dead stores (or the allocation with them) */
+  volatile unsigned char* pMemory = (volatile unsigned char*)malloc(LIMITS_TEST_MEMORY);
+  size_t i;
+
+  if (NULL != pMemory) {
+    for (i = 0 ; i < LIMITS_TEST_MEMORY ; i += 4096) {
+      pMemory[i] = 1;
+    }
+    CU_sleep(0.1);
+    free((void*)pMemory);
+  }
+}
+
+static void iso_sleeper(void* pArg)
+{
+  CU_UNREFERENCED_PARAMETER(pArg);
+  CU_sleep(0.2);
+}
+
+static void iso_threads(void)
+{
+  CU_pThread apThreads[3];
+  int i;
+
+  for (i = 0 ; i < 3 ; ++i) {
+    apThreads[i] = CU_thread_create(iso_sleeper, NULL);
+  }
+  for (i = 0 ; i < 3 ; ++i) {
+    if (NULL != apThreads[i]) {
+      CU_thread_join(apThreads[i]);
+    }
+  }
+}
+
+static void iso_files(void)
+{
+  int i;
+
+  for (i = 0 ; i < 32 ; ++i) {
+    dup(STDERR_FILENO);           /* closed when the worker exits */
+  }
+  CU_sleep(0.1);
+}
+
+static void iso_cpu(void)
+{
+  double dEnd = CU_get_monotonic_time() + 5.0;
+  volatile unsigned long ulSpins = 0;
+
+  while (CU_get_monotonic_time() < dEnd) {
+    ++ulSpins;
+  }
+}
+#endif  /* __linux__ */
+
+static void test_CU_set_isolation(void)
+{
+  TEST(CU_ISOLATION_NONE == CU_get_isolation_mode());
+  TEST(1 == CU_get_isolation_batch_size());
+
+  TEST(CUE_BAD_ISOLATION_PARAMS == CU_set_isolation((CU_IsolationMode)99, 1));
+  TEST(CUE_BAD_ISOLATION_PARAMS == CU_get_error());
+  TEST(CUE_BAD_ISOLATION_PARAMS == CU_set_isolation(CU_ISOLATION_BATCH, 0));
+  TEST(CU_ISOLATION_NONE == CU_get_isolation_mode());
+
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_BATCH, 8));
+  TEST(CU_ISOLATION_BATCH == CU_get_isolation_mode());
+  TEST(8 == CU_get_isolation_batch_size());
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_TEST, 8));
+  TEST(CU_ISOLATION_TEST == CU_get_isolation_mode());
+  TEST(1 == CU_get_isolation_batch_size());
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_NONE, 0));
+  TEST(CU_ISOLATION_NONE == CU_get_isolation_mode());
+
+  TEST(0 == strcmp("SIGSEGV", CU_get_signal_name(SIGSEGV)));
+  TEST(0 == strcmp("SIGKILL", CU_get_signal_name(SIGKILL)));
+  TEST(0 != strcmp("SIGSEGV", CU_get_signal_name(0)));
+}
+
+static void test_isolated_run(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pFail;
+  CU_pTest pCrash;
+  CU_pTest pExits;
+  CU_pFailureRecord pFailure;
+  CU_BOOL bFailSeen = CU_FALSE;
+  CU_BOOL bCrashSeen = CU_FALSE;
+  CU_BOOL bExitSeen = CU_FALSE;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", iso_init, iso_clean);
+  CU_add_test(pSuite, "pass1", iso_pass);
+  pFail = CU_add_test(pSuite, "fail", iso_fail);
+  pCrash = CU_add_test(pSuite, "crash", iso_crash);
+  pExits = CU_add_test(pSuite, "exits", iso_exits);
+  CU_add_test(pSuite, "pass2", iso_pass);
+  TEST_FATAL((NULL != pFail) && (NULL != pCrash) && (NULL != pExits));
+
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_TEST, 0));
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+
+  /* the tests changed their workers only, the run goes on after the crash */
+  TEST(0 == f_iShared);
+  TEST(0 == f_iFixture);
+  TEST(6 == CU_get_isolation_workers_started());   /* one per test and a spare */
+  TEST(5 == CU_get_number_of_tests_run());
+  TEST(3 == CU_get_number_of_tests_failed());
+  TEST(7 == CU_get_number_of_asserts());
+  TEST(2 == CU_get_number_of_failures());
+  TEST(4 == CU_get_number_of_failure_records());
+
+  for (pFailure = CU_get_failure_list() ; NULL != pFailure ; pFailure = pFailure->pNext) {
+    if (pFail == pFailure->pTest) {
+      bFailSeen = (0 != pFailure->uiLineNumber) && (NULL != strstr(pFailure->strFileName, "Isolation.c")) &&
+                  (NULL != strstr(pFailure->strCondition, "99"));
+    }
+    else if ((pCrash == pFailure->pTest) && (0 == pFailure->uiLineNumber)) {
+      bCrashSeen = (CUF_TestCrashed == pFailure->type) &&
+                   (NULL != strstr(pFailure->strCondition, "SIGSEGV"));
+    }
+    else if (pExits == pFailure->pTest) {
+      bExitSeen = (CUF_TestCrashed == pFailure->type) &&
+                  (NULL != strstr(pFailure->strCondition, "status 3"));
+    }
+  }
+  TEST(CU_FALSE != bFailSeen);
+  TEST(CU_FALSE != bCrashSeen);
+  TEST(CU_FALSE != bExitSeen);
+
+  /* a single test */
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_TEST, 0));
+  TEST(CUE_SUCCESS == CU_run_test(pSuite, pCrash));
+  TEST(1 == CU_get_number_of_tests_failed());
+  TEST(2 == CU_get_number_of_failure_records());
+  TEST(2 == CU_get_isolation_workers_started());
+
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+  CU_cleanup_registry();
+}
+
+static void test_isolated_batches(void)
+{
+  CU_pSuite pSuite;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  CU_add_test(pSuite, "first", iso_first);
+  CU_add_test(pSuite, "second", iso_second);   /* same worker as first */
+  CU_add_test(pSuite, "third", iso_first);     /* next worker */
+
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_BATCH, 2));
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+
+  TEST(0 == f_iShared);
+  TEST(2 == CU_get_isolation_workers_started());
+  TEST(3 == CU_get_number_of_tests_run());
+  TEST(3 == CU_get_number_of_asserts());
+  TEST(0 == CU_get_number_of_failure_records());
+
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+  CU_cleanup_registry();
+}
+
+static void test_suite_snapshot(void)
+{
+  CU_pSuite pSuite;
+  CU_pSuite pPlain;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("snapshot", snap_init, snap_clean);
+  CU_add_test(pSuite, "mutate1", snap_mutate);
+  CU_add_test(pSuite, "mutate2", snap_mutate);
+  CU_add_test(pSuite, "mutate3", snap_mutate);
+  pPlain = CU_add_suite("plain", NULL, NULL);
+  CU_add_test(pPlain, "pass", iso_first);
+  TEST_FATAL((NULL != pSuite) && (NULL != pPlain));
+
+  TEST(0 == CU_get_suite_snapshot(pSuite));
+  TEST(0 == CU_get_suite_snapshot(NULL));
+  TEST(CUE_NOSUITE == CU_set_suite_snapshot(NULL, 1));
+  TEST(CUE_NOSUITE == CU_get_error());
+  TEST(CUE_SUCCESS == CU_set_suite_snapshot(pSuite, 1));
+  TEST(1 == CU_get_suite_snapshot(pSuite));
+
+  /* every test starts from the fixture, other suites run in the test program */
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+  f_iInits = f_iCleanups = 0;
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  TEST(1 == f_iInits);
+  TEST(1 == f_iCleanups);
+  TEST(0 == f_iFixture);
+  TEST(1 == f_iShared);
+  TEST(4 == CU_get_isolation_workers_started());   /* one per test and a spare */
+  TEST(4 == CU_get_number_of_tests_run());
+  TEST(0 == CU_get_number_of_failure_records());
+  f_iShared = 0;
+
+  /* tests of a batch share their worker */
+  TEST(CUE_SUCCESS == CU_set_suite_snapshot(pSuite, 2));
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+  f_iInits = f_iCleanups = 0;
+  TEST(CUE_SUCCESS == CU_run_suite(pSuite));
+  TEST(1 == f_iInits);
+  TEST(1 == f_iCleanups);
+  TEST(2 == CU_get_isolation_workers_started());
+  TEST(1 == CU_get_number_of_tests_failed());     /* mutate2 sees mutate1's change */
+  TEST(1 == CU_get_number_of_failure_records());
+
+  /* the snapshot batch size wins over the isolation mode */
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_BATCH, 3));
+  TEST(CUE_SUCCESS == CU_run_suite(pSuite));
+  TEST(1 == CU_get_number_of_tests_failed());
+
+  TEST(CUE_SUCCESS == CU_set_suite_snapshot(pSuite, 0));
+  TEST(CUE_SUCCESS == CU_run_suite(pSuite));
+  TEST(2 == CU_get_number_of_tests_failed());     /* one worker for all three */
+
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+  CU_cleanup_registry();
+}
+
+static void test_CU_set_test_limits(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+  CU_TestLimits limits = {0, 0, 0, 0};
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  pTest = CU_add_test(pSuite, "test1", iso_pass);
+  TEST_FATAL(NULL != pTest);
+
+  TEST(NULL == CU_get_test_limits(pTest));
+  TEST(NULL == CU_get_test_limits(NULL));
+  TEST(CUE_NOTEST == CU_set_test_limits(NULL, &limits));
+  TEST(CUE_NOTEST == CU_get_error());
+
+  TEST(CUE_SUCCESS == CU_set_test_limits(pTest, &limits));  /* all 0: no limits */
+  TEST(NULL == CU_get_test_limits(pTest));
+
+  limits.szMaxRss = 1024 * 1024;
+  limits.uiMaxThreads = 4;
+  TEST(CUE_SUCCESS == CU_set_test_limits(pTest, &limits));
+  TEST_FATAL(NULL != CU_get_test_limits(pTest));
+  TEST(1024 * 1024 == CU_get_test_limits(pTest)->szMaxRss);
+  TEST(0 == CU_get_test_limits(pTest)->uiMaxCpuSeconds);
+  TEST(4 == CU_get_test_limits(pTest)->uiMaxThreads);
+
+  limits.uiMaxThreads = 8;
+  TEST(CUE_SUCCESS == CU_set_test_limits(pTest, &limits));
+  TEST(8 == CU_get_test_limits(pTest)->uiMaxThreads);
+
+  TEST(CUE_SUCCESS == CU_set_test_limits(pTest, NULL));
+  TEST(NULL == CU_get_test_limits(pTest));
+
+  /* released with the test */
+  TEST(CUE_SUCCESS == CU_set_test_limits(pTest, &limits));
+
+  TEST(0 == strcmp("memory", CU_get_test_limit_name(CU_LIMIT_MEMORY)));
+  TEST(0 == strcmp("thread", CU_get_test_limit_name(CU_LIMIT_THREADS)));
+
+  CU_cleanup_registry();
+}
+
+#ifdef __linux__
+static void test_limited_run(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest apTests[5];
+  CU_TestLimits limits = {0, 0, 0, 0};
+  CU_FailureType aTypes[5];
+  CU_pFailureRecord pFailure;
+  double dRss = 0.0;
+  int iFiles = count_open_files(0);
+  int i;
+
+  TEST_FATAL(CU_FALSE != read_proc_status(0, "VmRSS", &dRss));
+  TEST_FATAL(iFiles > 0);
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", iso_init, iso_clean);
+  apTests[0] = CU_add_test(pSuite, "memory", iso_memory);
+  apTests[1] = CU_add_test(pSuite, "threads", iso_threads);
+  apTests[2] = CU_add_test(pSuite, "files", iso_files);
+  apTests[3] = CU_add_test(pSuite, "cpu", iso_cpu);
+  apTests[4] = CU_add_test(pSuite, "within", iso_pass);   /* runs with the fixture */
+
+  limits.szMaxRss = (size_t)(dRss * 1024.0) + LIMITS_TEST_MEMORY / 4;
+  TEST(CUE_SUCCESS == CU_set_test_limits(apTests[0], &limits));
+  limits.szMaxRss = 0;
+  limits.uiMaxThreads = 2;
+  TEST(CUE_SUCCESS == CU_set_test_limits(apTests[1], &limits));
+  limits.uiMaxThreads = 0;
+  limits.uiMaxOpenFiles = (unsigned int)iFiles + 8;
+  TEST(CUE_SUCCESS == CU_set_test_limits(apTests[2], &limits));
+  limits.uiMaxOpenFiles = 0;
+  limits.uiMaxCpuSeconds = 1;
+  TEST(CUE_SUCCESS == CU_set_test_limits(apTests[3], &limits));
+  limits.szMaxRss = (size_t)(dRss * 1024.0) + LIMITS_TEST_MEMORY;
+  limits.uiMaxThreads = 8;
+  limits.uiMaxOpenFiles = (unsigned int)iFiles + 8;
+  TEST(CUE_SUCCESS == CU_set_test_limits(apTests[4], &limits));
+
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+
+  /* each test ran in a worker of its own, the suite was not isolated */
+  TEST(5 == CU_get_isolation_workers_started());
+  TEST(5 == CU_get_number_of_tests_run());
+  TEST(4 == CU_get_number_of_tests_failed());
+  TEST(4 == CU_get_number_of_failure_records());
+  TEST(0 == f_iShared);
+
+  for (i = 0 ; i < 5 ; ++i) {
+    aTypes[i] = CUF_AssertFailed;
+  }
+  for (pFailure = CU_get_failure_list() ; NULL != pFailure ; pFailure = pFailure->pNext) {
+    for (i = 0 ; i < 5 ; ++i) {
+      if (apTests[i] == pFailure->pTest) {
+        aTypes[i] = pFailure->type;
+      }
+    }
+  }
+  TEST(CUF_TestMemoryLimit == aTypes[0]);
+  TEST(CUF_TestThreadsLimit == aTypes[1]);
+  TEST(CUF_TestOpenFilesLimit == aTypes[2]);
+  TEST(CUF_TestCpuLimit == aTypes[3]);
+  TEST(CUF_AssertFailed == aTypes[4]);
+
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+  CU_cleanup_registry();
+}
+#endif  /* __linux__ */
+#endif  /* _WIN32 */
+
+void test_cunit_Isolation(void)
+{
+  test_cunit_start_tests("Isolation.c");
+
+#ifndef _WIN32
+  test_CU_set_isolation();
+  test_isolated_run();
+  test_isolated_batches();
+  test_suite_snapshot();
+  test_CU_set_test_limits();
+#ifdef __linux__
+  test_limited_run();
+#endif
+#endif
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
@@ -0,0 +1,499 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of open-loop load tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Open-loop load tests (implementation).
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "TestRun.h"
+#include "Util.h"
+#include "CUThread.h"
+#include "LoadTest.h"
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+/** Copy of the results of the most recently completed load test. */
+static CU_LoadResult f_last_result;
+
+/** Flag for whether f_last_result holds valid data. */
+static CU_BOOL f_bHaveLastResult = CU_FALSE;
+
+/** Schedule shared by the workers of a load test run. */
+typedef struct LoadSchedule
+{
+  CU_TestFunc   pTestFunc;      /**< Function to call for each request. */
+  CU_pMutex     pMutex;         /**< Protects ulNext. */
+  unsigned long ulNext;         /**< Index of the next request to be issued. */
+  unsigned long ulTotal;        /**< Number of requests in the schedule. */
+  double        dStartTime;     /**< Intended start time of request 0. */
+  double        dRate;          /**< Requests per second. */
+} LoadSchedule;
+
+/** Per-worker state; results are merged after the workers finish. */
+typedef struct LoadWorker
+{
+  LoadSchedule* pSchedule;      /**< Shared schedule. */
+  CU_pThread    pThread;        /**< Worker thread (NULL if run inline). */
+  double        dLatencySum;    /**< Sum of recorded latencies. */
+  double        dLastEnd;       /**< Completion time of the last request. */
+  CU_LoadResult result;         /**< Counts and histogram of this worker. */
+} LoadWorker;
+
+/*=================================================================
+ *  Private functions
+ *=================================================================*/
+/** Maps a latency in seconds to its histogram bucket. */
+static unsigned int latency_bucket(double dLatency)
+{
+  double dMicros = dLatency * 1.0e6;
+  unsigned long ulMicros;
+  unsigned int uiExp;
+
+  if (dMicros < 1.0) {
+    return 0;
+  }
+  if (dMicros >= 4294967295.0) {
+    return CU_LOAD_HISTOGRAM_BUCKETS - 1;
+  }
+  ulMicros = (unsigned long)dMicros;
+  if (ulMicros < CU_LOAD_HISTOGRAM_SUB_BUCKETS) {
+    return (unsigned int)ulMicros;
+  }
+  for (uiExp = 0 ; (ulMicros >> uiExp) >= 2 * CU_LOAD_HISTOGRAM_SUB_BUCKETS ; ++uiExp)
+    ;
+  /* ulMicros >> uiExp is now in 16..31, i.e. 16 + sub-bucket */
+  return (unsigned int)(uiExp * CU_LOAD_HISTOGRAM_SUB_BUCKETS + (ulMicros >> uiExp));
+}
+
+/*------------------------------------------------------------------------*/
+/** Issues requests from the schedule until it is exhausted. */
+static void load_worker(void* pArg)
+{
+  LoadWorker* pWorker = (LoadWorker*)pArg;
+  LoadSchedule* pSchedule = pWorker->pSchedule;
+  unsigned long ulIndex;
+  double dIntended;
+  double dNow;
+  double dLatency;
+  CU_BOOL bCompleted;
+
+  for (;;) {
+    CU_mutex_lock(pSchedule->pMutex);
+    ulIndex = pSchedule->ulNext++;
+    CU_mutex_unlock(pSchedule->pMutex);
+    if (ulIndex >= pSchedule->ulTotal) {
+      break;
+    }
+
+    dIntended = pSchedule->dStartTime + (double)ulIndex / pSchedule->dRate;
+    dNow = CU_get_monotonic_time();
+    if (dNow < dIntended) {
+      CU_sleep(dIntended - dNow);
+    }
+
+    bCompleted = CU_run_test_function_concurrently(pSchedule->pTestFunc);
+
+    /* latency counts from the intended start, not the actual one */
+    dNow = CU_get_monotonic_time();
+    dLatency = (dNow > dIntended) ? (dNow - dIntended) : 0.0;
+
+    ++pWorker->result.ulRequests;
+    if (CU_FALSE == bCompleted) {
+      ++pWorker->result.ulAborted;
+    }
+    ++pWorker->result.aulHistogram[latency_bucket(dLatency)];
+    pWorker->dLatencySum += dLatency;
+    if (dLatency < pWorker->result.dMinLatency) {
+      pWorker->result.dMinLatency = dLatency;
+    }
+    if (dLatency > pWorker->result.dMaxLatency) {
+      pWorker->result.dMaxLatency = dLatency;
+    }
+    pWorker->dLastEnd = dNow;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Initializes a result structure for accumulation. */
+static void clear_result(CU_LoadResult* pResult)
+{
+  memset(pResult, 0, sizeof(CU_LoadResult));
+  pResult->dMinLatency = HUGE_VAL;
+}
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_pTest CU_add_load_test(CU_pSuite pSuite,
+                          const char* strName,
+                          CU_TestFunc pTestFunc,
+                          double dTargetRate,
+                          double dDuration)
+{
+  CU_pTest pTest;
+  CU_LoadTest* pLoad;
+
+  if ((NULL != pSuite) && (NULL != strName) && (NULL != pTestFunc) &&
+      (!(dTargetRate > 0.0) || !(dDuration > 0.0))) {
+    CU_set_error(CUE_BAD_LOAD_PARAMS);
+    return NULL;
+  }
+
+  if (NULL == (pLoad = (CU_LoadTest*)CU_MALLOC(sizeof(CU_LoadTest)))) {
+    CU_set_error(CUE_NOMEMORY);
+    return NULL;
+  }
+
+  if (NULL == (pTest = CU_add_test(pSuite, strName, pTestFunc))) {
+    CU_FREE(pLoad);
+    return NULL;
+  }
+
+  pLoad->dTargetRate = dTargetRate;
+  pLoad->dDuration = dDuration;
+  pLoad->uiWorkers = CU_LOAD_DEFAULT_WORKERS;
+  clear_result(&pLoad->result);
+  pLoad->result.dMinLatency = 0.0;
+  pTest->pLoad = pLoad;
+
+  return pTest;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_load_test_workers(CU_pTest pTest, unsigned int uiWorkers)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if ((NULL == pTest) || (NULL == pTest->pLoad)) {
+    result = CUE_NOTEST;
+  }
+  else if (0 == uiWorkers) {
+    result = CUE_BAD_LOAD_PARAMS;
+  }
+  else {
+    pTest->pLoad->uiWorkers = uiWorkers;
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_is_load_test(CU_pTest pTest)
+{
+  return ((NULL != pTest) && (NULL != pTest->pLoad)) ? CU_TRUE : CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_LoadResult* CU_get_load_result(CU_pTest pTest)
+{
+  return (CU_FALSE != CU_is_load_test(pTest)) ? &pTest->pLoad->result : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_LoadResult* CU_get_last_load_result(void)
+{
+  return (CU_FALSE != f_bHaveLastResult) ? &f_last_result : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+double CU_get_load_bucket_limit(unsigned int uiBucket)
+{
+  unsigned int uiExp;
+
+  if (uiBucket >= CU_LOAD_HISTOGRAM_BUCKETS) {
+    uiBucket = CU_LOAD_HISTOGRAM_BUCKETS - 1;
+  }
+  if (uiBucket < CU_LOAD_HISTOGRAM_SUB_BUCKETS) {
+    return (double)(uiBucket + 1) / 1.0e6;
+  }
+  uiExp = uiBucket / CU_LOAD_HISTOGRAM_SUB_BUCKETS - 1;
+  return ldexp((double)(uiBucket % CU_LOAD_HISTOGRAM_SUB_BUCKETS + CU_LOAD_HISTOGRAM_SUB_BUCKETS + 1),
+               (int)uiExp) / 1.0e6;
+}
+
+/*------------------------------------------------------------------------*/
+double CU_get_load_percentile(const CU_LoadResult* pResult, double dPercentile)
+{
+  unsigned long ulRank;
+  unsigned long ulCount = 0;
+  unsigned int i;
+
+  if ((NULL == pResult) || (0 == pResult->ulRequests)) {
+    return HUGE_VAL;
+  }
+
+  if (dPercentile < 0.0) {
+    dPercentile = 0.0;
+  }
+  else if (dPercentile > 100.0) {
+    dPercentile = 100.0;
+  }
+  ulRank = (unsigned long)ceil(dPercentile / 100.0 * (double)pResult->ulRequests);
+  if (0 == ulRank) {
+    ulRank = 1;
+  }
+
+  for (i = 0 ; i < CU_LOAD_HISTOGRAM_BUCKETS ; ++i) {
+    ulCount += pResult->aulHistogram[i];
+    if (ulCount >= ulRank) {
+      break;
+    }
+  }
+  return CU_get_load_bucket_limit(i);
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_run_load(CU_pTest pTest)
+{
+  LoadSchedule schedule;
+  LoadWorker* pWorkers;
+  CU_LoadTest* pLoad;
+  CU_LoadResult* pResult;
+  double dLatencySum = 0.0;
+  double dLastEnd;
+  unsigned int uiWorkers;
+  unsigned int uiStarted;
+  unsigned int i, j;
+
+  assert(NULL != pTest);
+  assert(NULL != pTest->pLoad);
+  assert(NULL != pTest->pTestFunc);
+
+  pLoad = pTest->pLoad;
+  pResult = &pLoad->result;
+
+  schedule.pTestFunc = pTest->pTestFunc;
+  schedule.ulNext = 0;
+  schedule.ulTotal = (unsigned long)ceil(pLoad->dTargetRate * pLoad->dDuration);
+  schedule.dRate = pLoad->dTargetRate;
+  if (NULL == (schedule.pMutex = CU_mutex_create())) {
+    CU_set_error(CUE_NOMEMORY);
+    return CUE_NOMEMORY;
+  }
+
+  /* no point in more workers than requests */
+  uiWorkers = pLoad->uiWorkers;
+  if ((unsigned long)uiWorkers > schedule.ulTotal) {
+    uiWorkers = (0 == schedule.ulTotal) ? 1 : (unsigned int)schedule.ulTotal;
+  }
+  if (NULL == (pWorkers = (LoadWorker*)CU_MALLOC(uiWorkers * sizeof(LoadWorker)))) {
+    CU_mutex_destroy(schedule.pMutex);
+    CU_set_error(CUE_NOMEMORY);
+    return CUE_NOMEMORY;
+  }
+
+  schedule.dStartTime = CU_get_monotonic_time();
+  for (uiStarted = 0 ; uiStarted < uiWorkers ; ++uiStarted) {
+    pWorkers[uiStarted].pSchedule = &schedule;
+    pWorkers[uiStarted].dLatencySum = 0.0;
+    pWorkers[uiStarted].dLastEnd = schedule.dStartTime;
+    clear_result(&pWorkers[uiStarted].result);
+    pWorkers[uiStarted].pThread = CU_thread_create(load_worker, &pWorkers[uiStarted]);
+    if (NULL == pWorkers[uiStarted].pThread) {
+      break;
+    }
+  }
+
+  /* if no thread could be started, run the schedule here */
+  if (0 == uiStarted) {
+    load_worker(&pWorkers[0]);
+    uiStarted = 1;
+  }
+  else {
+    for (i = 0 ; i < uiStarted ; ++i) {
+      CU_thread_join(pWorkers[i].pThread);
+    }
+  }
+
+  clear_result(pResult);
+  pResult->dTargetRate = pLoad->dTargetRate;
+  pResult->uiWorkers = uiStarted;
+  dLastEnd = schedule.dStartTime;
+  for (i = 0 ; i < uiStarted ; ++i) {
+    pResult->ulRequests += pWorkers[i].result.ulRequests;
+    pResult->ulAborted += pWorkers[i].result.ulAborted;
+    for (j = 0 ; j < CU_LOAD_HISTOGRAM_BUCKETS ; ++j) {
+      pResult->aulHistogram[j] += pWorkers[i].result.aulHistogram[j];
+    }
+    if (pWorkers[i].result.dMinLatency < pResult->dMinLatency) {
+      pResult->dMinLatency = pWorkers[i].result.dMinLatency;
+    }
+    if (pWorkers[i].result.dMaxLatency > pResult->dMaxLatency) {
+      pResult->dMaxLatency = pWorkers[i].result.dMaxLatency;
+    }
+    if (pWorkers[i].dLastEnd > dLastEnd) {
+      dLastEnd = pWorkers[i].dLastEnd;
+    }
+    dLatencySum += pWorkers[i].dLatencySum;
+  }
+
+  pResult->dElapsedTime = dLastEnd - schedule.dStartTime;
+  if (0 == pResult->ulRequests) {
+    pResult->dMinLatency = 0.0;
+  }
+  else {
+    pResult->dMeanLatency = dLatencySum / (double)pResult->ulRequests;
+  }
+  if (pResult->dElapsedTime > 0.0) {
+    pResult->dAchievedRate = (double)pResult->ulRequests / pResult->dElapsedTime;
+  }
+
+  memcpy(&f_last_result, pResult, sizeof(CU_LoadResult));
+  f_bHaveLastResult = CU_TRUE;
+
+  CU_FREE(pWorkers);
+  CU_mutex_destroy(schedule.pMutex);
+  CU_set_error(CUE_SUCCESS);
+  return CUE_SUCCESS;
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+static void test_latency_buckets(void)
+{
+  unsigned int i;
+  double dPrev = 0.0;
+
+  TEST(0 == latency_bucket(0.0));
+  TEST(0 == latency_bucket(-1.0));
+  TEST(5 == latency_bucket(5.5e-6));
+  TEST(15 == latency_bucket(15.0e-6));
+  TEST(16 == latency_bucket(16.0e-6));
+  TEST(31 == latency_bucket(31.0e-6));
+  TEST(32 == latency_bucket(32.0e-6));
+  TEST(32 == latency_bucket(33.0e-6));
+  TEST(33 == latency_bucket(34.0e-6));
+  TEST(CU_LOAD_HISTOGRAM_BUCKETS - 1 == latency_bucket(1.0e4));
+
+  /* limits increase and every latency lies below its bucket's limit */
+  for (i = 0 ; i < CU_LOAD_HISTOGRAM_BUCKETS ; ++i) {
+    TEST(CU_get_load_bucket_limit(i) > dPrev);
+    dPrev = CU_get_load_bucket_limit(i);
+  }
+  for (i = 1 ; i < CU_LOAD_HISTOGRAM_BUCKETS - 1 ; ++i) {
+    TEST(latency_bucket(CU_get_load_bucket_limit(i - 1) * 1.000001) == i);
+    TEST(latency_bucket(CU_get_load_bucket_limit(i) * 0.999999) == i);
+  }
+  TEST(CU_get_load_bucket_limit(16) == 17.0e-6);
+  TEST(CU_get_load_bucket_limit(32) == 34.0e-6);
+  TEST(CU_get_load_bucket_limit(CU_LOAD_HISTOGRAM_BUCKETS) ==
+       CU_get_load_bucket_limit(CU_LOAD_HISTOGRAM_BUCKETS - 1));
+}
+
+static void test_CU_get_load_percentile(void)
+{
+  CU_LoadResult result;
+
+  clear_result(&result);
+  TEST(HUGE_VAL == CU_get_load_percentile(NULL, 50.0));
+  TEST(HUGE_VAL == CU_get_load_percentile(&result, 50.0));
+
+  /* 90 calls at ~1 us, 9 at ~100 us, 1 at ~10 ms */
+  result.ulRequests = 100;
+  result.aulHistogram[latency_bucket(1.0e-6)] = 90;
+  result.aulHistogram[latency_bucket(100.0e-6)] = 9;
+  result.aulHistogram[latency_bucket(10.0e-3)] = 1;
+
+  TEST(CU_get_load_percentile(&result, 0.0) == 2.0e-6);
+  TEST(CU_get_load_percentile(&result, 50.0) == 2.0e-6);
+  TEST(CU_get_load_percentile(&result, 90.0) == 2.0e-6);
+  TEST(CU_get_load_percentile(&result, 91.0) > 100.0e-6);
+  TEST(CU_get_load_percentile(&result, 99.0) < 110.0e-6);
+  TEST(CU_get_load_percentile(&result, 99.5) > 10.0e-3);
+  TEST(CU_get_load_percentile(&result, 100.0) < 11.0e-3);
+  TEST(CU_get_load_percentile(&result, 150.0) == CU_get_load_percentile(&result, 100.0));
+  TEST(CU_get_load_percentile(&result, -5.0) == CU_get_load_percentile(&result, 0.0));
+}
+
+static void load_test_func(void) { }
+
+static void test_CU_add_load_test(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+
+  TEST(NULL == CU_add_load_test(NULL, "load", load_test_func, 10.0, 1.0));
+  TEST(CUE_NOSUITE == CU_get_error());
+  TEST(NULL == CU_add_load_test(pSuite, "load", NULL, 10.0, 1.0));
+  TEST(CUE_NOTEST == CU_get_error());
+  TEST(NULL == CU_add_load_test(pSuite, "load", load_test_func, 0.0, 1.0));
+  TEST(CUE_BAD_LOAD_PARAMS == CU_get_error());
+  TEST(NULL == CU_add_load_test(pSuite, "load", load_test_func, 10.0, -1.0));
+  TEST(CUE_BAD_LOAD_PARAMS == CU_get_error());
+  TEST(0 == pSuite->uiNumberOfTests);
+
+  pTest = CU_add_load_test(pSuite, "load", load_test_func, 10.0, 1.0);
+  TEST_FATAL(NULL != pTest);
+  TEST(CUE_SUCCESS == CU_get_error());
+  TEST(CU_FALSE != CU_is_load_test(pTest));
+  TEST(CU_FALSE == CU_is_load_test(NULL));
+  TEST(CU_LOAD_DEFAULT_WORKERS == pTest->pLoad->uiWorkers);
+  TEST(NULL != CU_get_load_result(pTest));
+  TEST(0 == CU_get_load_result(pTest)->ulRequests);
+
+  TEST(CUE_BAD_LOAD_PARAMS == CU_set_load_test_workers(pTest, 0));
+  TEST(CUE_NOTEST == CU_set_load_test_workers(NULL, 2));
+  TEST(CUE_SUCCESS == CU_set_load_test_workers(pTest, 2));
+  TEST(2 == pTest->pLoad->uiWorkers);
+
+  pTest = CU_add_test(pSuite, "plain", load_test_func);
+  TEST(CU_FALSE == CU_is_load_test(pTest));
+  TEST(NULL == CU_get_load_result(pTest));
+  TEST(CUE_NOTEST == CU_set_load_test_workers(pTest, 2));
+
+  CU_cleanup_registry();
+}
+
+void test_cunit_LoadTest(void)
+{
+  test_cunit_start_tests("LoadTest.c");
+
+  test_latency_buckets();
+  test_CU_get_load_percentile();
+  test_CU_add_load_test();
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
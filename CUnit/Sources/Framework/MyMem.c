@@ -35,6 +35,16 @@
  *                signed-unsigned mismatch. (JDS)
  *
  *  02-May-2006   Added internationalization hooks.  (JDS)
+ *
+ *  18-Oct-2026   Added pluggable allocator and dedicated arena allocator for
+ *                CUnit's own allocations. (AGT)
+ *
+ *  18-Oct-2026   Indexed memory tracker nodes by pointer, appended events in
+ *                constant time, interned file names and made the tracker
+ *                thread safe. (AGT)
+ *
+ *  18-Oct-2026   Buffered the memory report and added binary and summary
+ *                report formats. (AGT)
  */
 
 /** @file
@@ -44,6 +54,13 @@
  @{
 */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L   /* mmap(), pthreads under -std=c99 */
+#endif
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE           /* MAP_ANONYMOUS with glibc */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
@@ -52,10 +69,311 @@
 #include <string.h>
 #include <time.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
 #include "CUnit.h"
 #include "MyMem.h"
+#include "TestDB.h"
 #include "CUnit_intl.h"
 
+/*=================================================================
+ *  Allocator
+ *=================================================================*/
+/** Default allocation function (C library). */
+static void* default_malloc(size_t size, void* pContext)
+{
+  CU_UNREFERENCED_PARAMETER(pContext);
+  return malloc(size);
+}
+
+/** Default reallocation function (C library). */
+static void* default_realloc(void* ptr, size_t size, void* pContext)
+{
+  CU_UNREFERENCED_PARAMETER(pContext);
+  return realloc(ptr, size);
+}
+
+/** Default deallocation function (C library). */
+static void default_free(void* ptr, void* pContext)
+{
+  CU_UNREFERENCED_PARAMETER(pContext);
+  free(ptr);
+}
+
+/** The C library allocator. */
+static const CU_Allocator f_default_allocator = {
+  default_malloc, default_realloc, default_free, NULL
+};
+
+/** The allocator for CUnit's internal allocations. */
+static CU_Allocator f_allocator = {
+  default_malloc, default_realloc, default_free, NULL
+};
+
+/*------------------------------------------------------------------------*/
+/*  Dedicated arena.
+ *  Blocks of up to ARENA_MAX_SMALL bytes are rounded up to a power of 2
+ *  and carved from ARENA_CHUNK_SIZE chunks; freed blocks go to a free
+ *  list per size class.  Larger blocks are mapped individually.  Each
+ *  block is preceded by a header recording its size class.
+ */
+#define ARENA_MIN_SHIFT  4                  /**< Smallest class: 16 bytes. */
+#define ARENA_CLASSES    8                  /**< Classes of 16 to 2048 bytes. */
+#define ARENA_MAX_SMALL  ((size_t)1 << (ARENA_MIN_SHIFT + ARENA_CLASSES - 1))
+#define ARENA_LARGE      ARENA_CLASSES      /**< Class of individually mapped blocks. */
+#define ARENA_CHUNK_SIZE ((size_t)256 * 1024)
+
+/** Header preceding each arena block (sized to keep payloads aligned). */
+typedef union ArenaHeader
+{
+  struct {
+    size_t szClass;     /**< Size class, or ARENA_LARGE. */
+    size_t szMapped;    /**< Bytes mapped for an ARENA_LARGE block. */
+  } info;
+  long double ldAlign;  /**< Alignment only. */
+  void*       pAlign;   /**< Alignment only. */
+} ArenaHeader;
+
+/** A free block in a size class list. */
+typedef struct ArenaFree
+{
+  struct ArenaFree* pNext;
+} ArenaFree;
+
+static ArenaFree* f_apArenaFree[ARENA_CLASSES];   /**< Free blocks per class. */
+static char*      f_pArenaNext = NULL;            /**< Next unused byte of the current chunk. */
+static char*      f_pArenaEnd = NULL;             /**< End of the current chunk. */
+
+#ifdef _WIN32
+static SRWLOCK f_arena_lock = SRWLOCK_INIT;       /**< Protects the arena. */
+#define ARENA_LOCK()   AcquireSRWLockExclusive(&f_arena_lock)
+#define ARENA_UNLOCK() ReleaseSRWLockExclusive(&f_arena_lock)
+#else
+static pthread_mutex_t f_arena_lock = PTHREAD_MUTEX_INITIALIZER;  /**< Protects the arena. */
+#define ARENA_LOCK()   pthread_mutex_lock(&f_arena_lock)
+#define ARENA_UNLOCK() pthread_mutex_unlock(&f_arena_lock)
+#endif
+
+/** Maps size bytes of zeroed memory from the operating system. */
+static void* arena_map(size_t size)
+{
+#if defined(_WIN32)
+  return VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#elif defined(MAP_ANONYMOUS)
+  void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return (MAP_FAILED == p) ? NULL : p;
+#else
+  return calloc(1, size);   /* no anonymous mappings - share the heap */
+#endif
+}
+
+/** Returns memory obtained with arena_map() to the operating system. */
+static void arena_unmap(void* p, size_t size)
+{
+#if defined(_WIN32)
+  CU_UNREFERENCED_PARAMETER(size);
+  VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(MAP_ANONYMOUS)
+  munmap(p, size);
+#else
+  CU_UNREFERENCED_PARAMETER(size);
+  free(p);
+#endif
+}
+
+/** Determines the size class for a request of size bytes (<= ARENA_MAX_SMALL). */
+static size_t arena_class(size_t size)
+{
+  size_t szClass = 0;
+
+  while (((size_t)1 << (ARENA_MIN_SHIFT + szClass)) < size) {
+    ++szClass;
+  }
+  return szClass;
+}
+
+/** Usable bytes of an arena block. */
+static size_t arena_block_size(const ArenaHeader* pHeader)
+{
+  return (ARENA_LARGE == pHeader->info.szClass)
+           ? pHeader->info.szMapped - sizeof(ArenaHeader)
+           : (size_t)1 << (ARENA_MIN_SHIFT + pHeader->info.szClass);
+}
+
+static void* arena_malloc(size_t size, void* pContext)
+{
+  ArenaHeader* pHeader = NULL;
+  size_t szClass;
+  size_t szBlock;
+
+  CU_UNREFERENCED_PARAMETER(pContext);
+
+  if (size > ARENA_MAX_SMALL) {
+    if (size > (size_t)-1 - sizeof(ArenaHeader)) {
+      return NULL;
+    }
+    if (NULL == (pHeader = (ArenaHeader*)arena_map(size + sizeof(ArenaHeader)))) {
+      return NULL;
+    }
+    pHeader->info.szClass = ARENA_LARGE;
+    pHeader->info.szMapped = size + sizeof(ArenaHeader);
+    return pHeader + 1;
+  }
+
+  szClass = arena_class(size);
+  szBlock = sizeof(ArenaHeader) + ((size_t)1 << (ARENA_MIN_SHIFT + szClass));
+
+  ARENA_LOCK();
+  if (NULL != f_apArenaFree[szClass]) {
+    pHeader = (ArenaHeader*)f_apArenaFree[szClass] - 1;
+    f_apArenaFree[szClass] = f_apArenaFree[szClass]->pNext;
+  }
+  else {
+    if ((size_t)(f_pArenaEnd - f_pArenaNext) < szBlock) {
+      /* the rest of the old chunk is abandoned */
+      if (NULL != (f_pArenaNext = (char*)arena_map(ARENA_CHUNK_SIZE))) {
+        f_pArenaEnd = f_pArenaNext + ARENA_CHUNK_SIZE;
+      }
+      else {
+        f_pArenaEnd = NULL;
+      }
+    }
+    if (NULL != f_pArenaNext) {
+      pHeader = (ArenaHeader*)f_pArenaNext;
+      f_pArenaNext += szBlock;
+    }
+  }
+  ARENA_UNLOCK();
+
+  if (NULL == pHeader) {
+    return NULL;
+  }
+  pHeader->info.szClass = szClass;
+  return pHeader + 1;
+}
+
+static void arena_free(void* ptr, void* pContext)
+{
+  ArenaHeader* pHeader = (ArenaHeader*)ptr - 1;
+  ArenaFree* pFree = (ArenaFree*)ptr;
+  size_t szClass = pHeader->info.szClass;
+
+  CU_UNREFERENCED_PARAMETER(pContext);
+
+  if (ARENA_LARGE == szClass) {
+    arena_unmap(pHeader, pHeader->info.szMapped);
+    return;
+  }
+  assert(szClass < ARENA_CLASSES);
+
+  ARENA_LOCK();
+  pFree->pNext = f_apArenaFree[szClass];
+  f_apArenaFree[szClass] = pFree;
+  ARENA_UNLOCK();
+}
+
+static void* arena_realloc(void* ptr, size_t size, void* pContext)
+{
+  size_t szOld = arena_block_size((ArenaHeader*)ptr - 1);
+  void* pNew;
+
+  if ((size <= szOld) && ((size > szOld / 2) || (szOld <= ((size_t)1 << ARENA_MIN_SHIFT)))) {
+    return ptr;     /* already the right class */
+  }
+  if (NULL == (pNew = arena_malloc(size, pContext))) {
+    return NULL;
+  }
+  memcpy(pNew, ptr, (size < szOld) ? size : szOld);
+  arena_free(ptr, pContext);
+  return pNew;
+}
+
+/** The dedicated arena allocator. */
+static const CU_Allocator f_arena_allocator = {
+  arena_malloc, arena_realloc, arena_free, NULL
+};
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_allocator(const CU_Allocator* pAllocator)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if ((NULL != pAllocator) &&
+      ((NULL == pAllocator->pMalloc) || (NULL == pAllocator->pRealloc) || (NULL == pAllocator->pFree))) {
+    result = CUE_BAD_ALLOCATOR;
+  }
+  else if (NULL != CU_get_registry()) {
+    result = CUE_REGISTRY_EXISTS;
+  }
+  else {
+    f_allocator = (NULL != pAllocator) ? *pAllocator : f_default_allocator;
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_Allocator* CU_get_allocator(void)
+{
+  return &f_allocator;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_Allocator* CU_get_arena_allocator(void)
+{
+  return &f_arena_allocator;
+}
+
+/*------------------------------------------------------------------------*/
+void* CU_allocator_malloc(size_t size)
+{
+  return (*f_allocator.pMalloc)((0 == size) ? 1 : size, f_allocator.pContext);
+}
+
+/*------------------------------------------------------------------------*/
+void* CU_allocator_calloc(size_t nmemb, size_t size)
+{
+  void* pVoid;
+
+  if ((0 != size) && (nmemb > (size_t)-1 / size)) {
+    return NULL;
+  }
+  if (NULL != (pVoid = CU_allocator_malloc(nmemb * size))) {
+    memset(pVoid, 0, nmemb * size);
+  }
+  return pVoid;
+}
+
+/*------------------------------------------------------------------------*/
+void* CU_allocator_realloc(void* ptr, size_t size)
+{
+  if (NULL == ptr) {
+    return CU_allocator_malloc(size);
+  }
+  if (0 == size) {
+    CU_allocator_free(ptr);
+    return NULL;
+  }
+  return (*f_allocator.pRealloc)(ptr, size, f_allocator.pContext);
+}
+
+/*------------------------------------------------------------------------*/
+void CU_allocator_free(void* ptr)
+{
+  if (NULL != ptr) {
+    (*f_allocator.pFree)(ptr, f_allocator.pContext);
+  }
+}
+
 #ifdef MEMTRACE
 
 #define MAX_FILE_NAME_LENGTH  256
@@ -63,6 +381,14 @@
 /** Default name for memory dump file. */
 static const char* f_szDefaultDumpFileName = "CUnit-Memory-Dump.xml";
 /**< Default name for memory dump file. */
+static const char* f_szDefaultBinaryDumpFileName = "CUnit-Memory-Dump.bin";
+/**< Default name for binary memory dump file. */
+static const char* f_szDefaultSummaryFileName = "CUnit-Memory-Summary.txt";
+/**< Default name for memory summary file. */
+
+static CU_MemoryDumpFormat f_MemoryDumpFormat = CU_MEMORY_DUMP_XML;  /**< Format of the memory report. */
+
+#define MEMORY_DUMP_BUFSIZE 65536   /**< Output buffer size for memory reports. */
 
 #ifdef CUNIT_BUILD_TESTS
 /** For testing use (only) to simulate memory exhaustion -
@@ -71,13 +397,15 @@ static const char* f_szDefaultDumpFileName = "CUnit-Memory-Dump.xml";
 static CU_BOOL f_bTestCunitMallocActive = CU_TRUE;
 #endif
 
-/** Structure holding the details of a memory allocation/deallocation event. */
+/** Structure holding the details of a memory allocation/deallocation event.
+ *  File names are interned (see intern_file_name()) and never freed.
+ */
 typedef struct mem_event {
   size_t            Size;
   unsigned int      AllocLine;
-  char              AllocFilename[MAX_FILE_NAME_LENGTH];
+  const char*       AllocFilename;
   unsigned int      DeallocLine;
-  char              DeallocFilename[MAX_FILE_NAME_LENGTH];
+  const char*       DeallocFilename;
   struct mem_event* pNext;
 } MEMORY_EVENT;
 typedef MEMORY_EVENT* PMEMORY_EVENT;
@@ -90,31 +418,185 @@ typedef struct mem_node {
   void*             pLocation;
   unsigned int      EventCount;
   PMEMORY_EVENT     pFirstEvent;
+  PMEMORY_EVENT     pLastEvent;
   struct mem_node*  pNext;
 } MEMORY_NODE;
 typedef MEMORY_NODE* PMEMORY_NODE;
 
-static PMEMORY_NODE f_pMemoryTrackerHead = NULL;  /**< Head of double-linked list of memory nodes. */
+static PMEMORY_NODE f_pMemoryTrackerHead = NULL;  /**< Head of linked list of memory nodes (in order of creation). */
+static PMEMORY_NODE f_pMemoryTrackerTail = NULL;  /**< Tail of linked list of memory nodes. */
 static unsigned int f_nMemoryNodes = 0;           /**< Counter for memory nodes created. */
+
+/** Open-addressing index of the memory nodes by location.
+ *  Nodes are never removed, so linear probing needs no tombstones.
+ */
+static PMEMORY_NODE* f_apNodeIndex = NULL;
+static size_t        f_szNodeIndexSize = 0;       /**< Slots in f_apNodeIndex (a power of 2). */
+
+/** Open-addressing set of interned file names. */
+static char**        f_apFileNames = NULL;
+static size_t        f_szFileNamesSize = 0;       /**< Slots in f_apFileNames (a power of 2). */
+static size_t        f_nFileNames = 0;            /**< Interned file names. */
+
+#define MEMTRACE_INITIAL_SLOTS 1024   /**< Initial slots of the node index. */
+
+#ifdef _WIN32
+static SRWLOCK f_memtrace_lock = SRWLOCK_INIT;    /**< Protects the memory tracker. */
+#define MEMTRACE_LOCK()   AcquireSRWLockExclusive(&f_memtrace_lock)
+#define MEMTRACE_UNLOCK() ReleaseSRWLockExclusive(&f_memtrace_lock)
+#else
+static pthread_mutex_t f_memtrace_lock = PTHREAD_MUTEX_INITIALIZER;  /**< Protects the memory tracker. */
+#define MEMTRACE_LOCK()   pthread_mutex_lock(&f_memtrace_lock)
+#define MEMTRACE_UNLOCK() pthread_mutex_unlock(&f_memtrace_lock)
+#endif
+
+/*------------------------------------------------------------------------*/
+/** Hash a pointer to a slot index (mask is the table size - 1). */
+static size_t hash_location(const void* pLocation, size_t mask)
+{
+  size_t h = (size_t)pLocation;
+  h ^= h >> 17;
+  h *= (size_t)0x9E3779B1UL;
+  h ^= h >> 13;
+  return h & mask;
+}
 /*------------------------------------------------------------------------*/
-/** Locate the memory node for the specified memory location (returns NULL if none). */
+/** Locate the memory node for the specified memory location (returns NULL if none).
+ *  The caller must hold the tracker lock.
+ */
 static PMEMORY_NODE find_memory_node(void* pLocation)
 {
-  PMEMORY_NODE pMemoryNode = f_pMemoryTrackerHead;
-  while (NULL != pMemoryNode) {
-    if (pLocation == pMemoryNode->pLocation) {
-      break;
+  size_t mask;
+  size_t i;
+
+  if (NULL == f_apNodeIndex) {
+    return NULL;
+  }
+
+  mask = f_szNodeIndexSize - 1;
+  for (i = hash_location(pLocation, mask) ; NULL != f_apNodeIndex[i] ; i = (i + 1) & mask) {
+    if (pLocation == f_apNodeIndex[i]->pLocation) {
+      return f_apNodeIndex[i];
+    }
+  }
+  return NULL;
+}
+/*------------------------------------------------------------------------*/
+/** Insert a node in the location index, growing it to stay at most half full. */
+static void index_memory_node(PMEMORY_NODE pMemoryNode)
+{
+  PMEMORY_NODE pTempNode;
+  size_t mask;
+  size_t i;
+
+  if ((f_nMemoryNodes + 1) * 2 > f_szNodeIndexSize) {
+    free(f_apNodeIndex);
+    f_szNodeIndexSize = (0 == f_szNodeIndexSize) ? MEMTRACE_INITIAL_SLOTS : 2 * f_szNodeIndexSize;
+    f_apNodeIndex = (PMEMORY_NODE*)calloc(f_szNodeIndexSize, sizeof(PMEMORY_NODE));
+    assert(NULL != f_apNodeIndex);
+
+    /* rehash from the node list, which holds every node */
+    mask = f_szNodeIndexSize - 1;
+    for (pTempNode = f_pMemoryTrackerHead ; NULL != pTempNode ; pTempNode = pTempNode->pNext) {
+      for (i = hash_location(pTempNode->pLocation, mask) ; NULL != f_apNodeIndex[i] ; i = (i + 1) & mask)
+        ;
+      f_apNodeIndex[i] = pTempNode;
     }
-    pMemoryNode = pMemoryNode->pNext;
   }
 
-  return pMemoryNode;
+  mask = f_szNodeIndexSize - 1;
+  for (i = hash_location(pMemoryNode->pLocation, mask) ; NULL != f_apNodeIndex[i] ; i = (i + 1) & mask)
+    ;
+  f_apNodeIndex[i] = pMemoryNode;
+}
+/*------------------------------------------------------------------------*/
+/** Hash the first szLength characters of a file name (FNV-1a). */
+static size_t hash_file_name(const char* szFileName, size_t szLength)
+{
+  size_t h = 2166136261UL;
+  size_t i;
+
+  for (i = 0 ; i < szLength ; ++i) {
+    h = (h ^ (unsigned char)szFileName[i]) * 16777619UL;
+  }
+  return h;
+}
+/*------------------------------------------------------------------------*/
+/** Insert an interned file name in f_apFileNames, which must have a free slot. */
+static void insert_file_name(char* szFileName, size_t h)
+{
+  size_t mask = f_szFileNamesSize - 1;
+  size_t i;
+
+  for (i = h & mask ; NULL != f_apFileNames[i] ; i = (i + 1) & mask)
+    ;
+  f_apFileNames[i] = szFileName;
+}
+/*------------------------------------------------------------------------*/
+/** Return the single stored copy of a file name.
+ *  Names are truncated to MAX_FILE_NAME_LENGTH-1 characters, as when they
+ *  were copied into each event.  The caller must hold the tracker lock.
+ */
+static const char* intern_file_name(const char* szFileName)
+{
+  size_t szLength = 0;
+  size_t h;
+  size_t mask;
+  size_t i;
+  char** apOld;
+  size_t szOldSize;
+  char* szCopy;
+
+  if ((NULL == szFileName) || ('\0' == *szFileName)) {
+    return "";
+  }
+
+  while ((szLength < MAX_FILE_NAME_LENGTH-1) && ('\0' != szFileName[szLength])) {
+    ++szLength;
+  }
+  h = hash_file_name(szFileName, szLength);
+
+  if (NULL != f_apFileNames) {
+    mask = f_szFileNamesSize - 1;
+    for (i = h & mask ; NULL != f_apFileNames[i] ; i = (i + 1) & mask) {
+      if ((0 == strncmp(f_apFileNames[i], szFileName, szLength)) && ('\0' == f_apFileNames[i][szLength])) {
+        return f_apFileNames[i];
+      }
+    }
+  }
+
+  /* keep the table at most half full */
+  if ((f_nFileNames + 1) * 2 > f_szFileNamesSize) {
+    apOld = f_apFileNames;
+    szOldSize = f_szFileNamesSize;
+    f_szFileNamesSize = (0 == szOldSize) ? 64 : 2 * szOldSize;
+    f_apFileNames = (char**)calloc(f_szFileNamesSize, sizeof(char*));
+    assert(NULL != f_apFileNames);
+
+    for (i = 0 ; i < szOldSize ; ++i) {
+      if (NULL != apOld[i]) {
+        insert_file_name(apOld[i], hash_file_name(apOld[i], strlen(apOld[i])));
+      }
+    }
+    free(apOld);
+  }
+
+  szCopy = (char*)malloc(szLength + 1);
+  assert(NULL != szCopy);
+  memcpy(szCopy, szFileName, szLength);
+  szCopy[szLength] = '\0';
+
+  insert_file_name(szCopy, h);
+  ++f_nFileNames;
+
+  return szCopy;
 }
 /*------------------------------------------------------------------------*/
-/** Create a new memory node for the specified memory location. */
+/** Create a new memory node for the specified memory location.
+ *  The caller must hold the tracker lock.
+ */
 static PMEMORY_NODE create_memory_node(void* pLocation)
 {
-  PMEMORY_NODE pTempNode = NULL;
   PMEMORY_NODE pMemoryNode = find_memory_node(pLocation);
 
   /* a memory node for pLocation should not exist yet */
@@ -126,33 +608,34 @@ static PMEMORY_NODE create_memory_node(void* pLocation)
     pMemoryNode->pLocation = pLocation;
     pMemoryNode->EventCount = 0;
     pMemoryNode->pFirstEvent = NULL;
+    pMemoryNode->pLastEvent = NULL;
     pMemoryNode->pNext = NULL;
 
-    /* add new node to linked list */
-    pTempNode = f_pMemoryTrackerHead;
-    if (NULL == pTempNode) {
+    index_memory_node(pMemoryNode);
+
+    /* add new node to the end of the linked list */
+    if (NULL == f_pMemoryTrackerTail) {
       f_pMemoryTrackerHead = pMemoryNode;
     }
     else {
-      while (NULL != pTempNode->pNext) {
-        pTempNode = pTempNode->pNext;
-      }
-      pTempNode->pNext = pMemoryNode;
+      f_pMemoryTrackerTail->pNext = pMemoryNode;
     }
+    f_pMemoryTrackerTail = pMemoryNode;
 
     ++f_nMemoryNodes;
   }
   return pMemoryNode;
 }
 /*------------------------------------------------------------------------*/
-/** Add a new memory event having the specified parameters. */
+/** Add a new memory event having the specified parameters.
+ *  The caller must hold the tracker lock.
+ */
 static PMEMORY_EVENT add_memory_event(PMEMORY_NODE pMemoryNode,
                                       size_t size,
                                       unsigned int alloc_line,
                                       const char* alloc_filename)
 {
   PMEMORY_EVENT pMemoryEvent = NULL;
-  PMEMORY_EVENT pTempEvent = NULL;
 
   assert (NULL != pMemoryNode);
 
@@ -162,23 +645,19 @@ static PMEMORY_EVENT add_memory_event(PMEMORY_NODE pMemoryNode,
 
   pMemoryEvent->Size = size;
   pMemoryEvent->AllocLine = alloc_line;
-  strncpy(pMemoryEvent->AllocFilename, alloc_filename, (size_t) MAX_FILE_NAME_LENGTH-1);
-  pMemoryEvent->AllocFilename[MAX_FILE_NAME_LENGTH-1] = (char)0;
+  pMemoryEvent->AllocFilename = intern_file_name(alloc_filename);
   pMemoryEvent->DeallocLine = NOT_DELETED;
-  pMemoryEvent->DeallocFilename[0] = (char)0;
+  pMemoryEvent->DeallocFilename = "";
   pMemoryEvent->pNext = NULL;
 
   /* add the new event to the end of the linked list */
-  pTempEvent = pMemoryNode->pFirstEvent;
-  if (NULL == pTempEvent) {
+  if (NULL == pMemoryNode->pLastEvent) {
     pMemoryNode->pFirstEvent = pMemoryEvent;
   }
   else {
-    while (NULL != pTempEvent->pNext) {
-      pTempEvent = pTempEvent->pNext;
-    }
-    pTempEvent->pNext = pMemoryEvent;
+    pMemoryNode->pLastEvent->pNext = pMemoryEvent;
   }
+  pMemoryNode->pLastEvent = pMemoryEvent;
 
   ++pMemoryNode->EventCount;
 
@@ -193,6 +672,8 @@ static PMEMORY_NODE allocate_memory(size_t nSize,
 {
   PMEMORY_NODE pMemoryNode = NULL;
 
+  MEMTRACE_LOCK();
+
   /* attempt to locate an existing record for this pLocation */
   pMemoryNode = find_memory_node(pLocation);
 
@@ -204,6 +685,7 @@ static PMEMORY_NODE allocate_memory(size_t nSize,
   /* add the new event record */
   add_memory_event(pMemoryNode, nSize, uiAllocationLine, szAllocationFile);
 
+  MEMTRACE_UNLOCK();
   return pMemoryNode;
 }
 
@@ -217,6 +699,8 @@ static void deallocate_memory(void* pLocation, unsigned int uiDeletionLine, cons
   assert(0 != uiDeletionLine);
   assert(NULL != szDeletionFileName);
 
+  MEMTRACE_LOCK();
+
   /* attempt to locate an existing record for this pLocation */
   pMemoryNode = find_memory_node(pLocation);
 
@@ -227,13 +711,8 @@ static void deallocate_memory(void* pLocation, unsigned int uiDeletionLine, cons
   }
   else {
     /* there should always be at least 1 event for an existing memory node */
-    assert(NULL != pMemoryNode->pFirstEvent);
-
-    /* locate last memory event for this pLocation */
-    pTempEvent = pMemoryNode->pFirstEvent;
-    while (NULL != pTempEvent->pNext) {
-      pTempEvent = pTempEvent->pNext;
-    }
+    assert(NULL != pMemoryNode->pLastEvent);
+    pTempEvent = pMemoryNode->pLastEvent;
 
     /* if pointer has already been freed, create a new event for double deletion */
     if (NOT_DELETED != pTempEvent->DeallocLine) {
@@ -242,8 +721,9 @@ static void deallocate_memory(void* pLocation, unsigned int uiDeletionLine, cons
   }
 
   pTempEvent->DeallocLine = uiDeletionLine;
-  strncpy(pTempEvent->DeallocFilename, szDeletionFileName, MAX_FILE_NAME_LENGTH-1);
-  pTempEvent->DeallocFilename[MAX_FILE_NAME_LENGTH-1] = (char)0;
+  pTempEvent->DeallocFilename = intern_file_name(szDeletionFileName);
+
+  MEMTRACE_UNLOCK();
 }
 
 /*------------------------------------------------------------------------*/
@@ -258,7 +738,7 @@ void* CU_calloc(size_t nmemb, size_t size, unsigned int uiLine, const char* szFi
   }
 #endif
 
-  pVoid = calloc(nmemb, size);
+  pVoid = CU_allocator_calloc(nmemb, size);
   if (NULL != pVoid) {
     allocate_memory(nmemb * size, pVoid, uiLine, szFileName);
   }
@@ -278,7 +758,7 @@ void* CU_malloc(size_t size, unsigned int uiLine, const char* szFileName)
   }
 #endif
 
-  pVoid = malloc(size);
+  pVoid = CU_allocator_malloc(size);
   if (NULL != pVoid) {
     allocate_memory(size, pVoid, uiLine, szFileName);
   }
@@ -291,7 +771,7 @@ void* CU_malloc(size_t size, unsigned int uiLine, const char* szFileName)
 void CU_free(void *ptr, unsigned int uiLine, const char* szFileName)
 {
   deallocate_memory(ptr, uiLine, szFileName);
-  free(ptr);
+  CU_allocator_free(ptr);
 }
 
 /*------------------------------------------------------------------------*/
@@ -304,12 +784,12 @@ void* CU_realloc(void *ptr, size_t size, unsigned int uiLine, const char* szFile
 
 #ifdef CUNIT_BUILD_TESTS
   if (CU_FALSE == f_bTestCunitMallocActive) {
-    free(ptr);
+    CU_allocator_free(ptr);
     return NULL;
   }
 #endif
 
-  pVoid = realloc(ptr, size);
+  pVoid = CU_allocator_realloc(ptr, size);
 
   if (NULL != pVoid) {
     allocate_memory(size, pVoid, uiLine, szFileName);
@@ -319,79 +799,388 @@ void* CU_realloc(void *ptr, size_t size, unsigned int uiLine, const char* szFile
 }
 
 /*------------------------------------------------------------------------*/
-/** Print a report of memory events to file. */
-void CU_dump_memory_usage(const char* szFilename)
+/** Write the xml listing of all memory events (Memory-Dump.dtd).
+ *  The caller must hold the tracker lock.
+ */
+static void dump_memory_xml(FILE* pFile)
 {
-  char* szDumpFileName = (char*)f_szDefaultDumpFileName;
-  unsigned int nValid;
-  unsigned int nInvalid;
+  unsigned int nValid = 0;
+  unsigned int nInvalid = 0;
   PMEMORY_NODE pTempNode = NULL;
   PMEMORY_EVENT pTempEvent = NULL;
-  FILE* pFile = NULL;
   time_t tTime = 0;
 
-  /* use the specified file name, if supplied) */
-  if ((NULL != szFilename) && strlen(szFilename) > 0) {
-    szDumpFileName = (char*)szFilename;
+  fprintf(pFile, "<\?xml version=\"1.0\" \?>"
+                 "\n<\?xml-stylesheet type=\"text/xsl\" href=\"Memory-Dump.xsl\" \?>"
+                 "\n<!DOCTYPE MEMORY_DUMP_REPORT SYSTEM \"Memory-Dump.dtd\">"
+                 "\n<MEMORY_DUMP_REPORT>"
+                 "\n  <MD_HEADER/>"
+                 "\n  <MD_RUN_LISTING>");
+
+  for (pTempNode = f_pMemoryTrackerHead ; NULL != pTempNode ; pTempNode = pTempNode->pNext) {
+    fprintf(pFile, "\n    <MD_RUN_RECORD>"
+                   "\n      <MD_POINTER> %p </MD_POINTER>"
+                   "\n      <MD_EVENT_COUNT> %u </MD_EVENT_COUNT>",
+            pTempNode->pLocation, pTempNode->EventCount);
+
+    for (pTempEvent = pTempNode->pFirstEvent ; NULL != pTempEvent ; pTempEvent = pTempEvent->pNext) {
+      fprintf(pFile, "\n      <MD_EVENT_RECORD>"
+                     "\n        <MD_SIZE> %u </MD_SIZE>"
+                     "\n        <MD_ALLOC_FILE> %s </MD_ALLOC_FILE>"
+                     "\n        <MD_ALLOC_LINE> %u </MD_ALLOC_LINE>"
+                     "\n        <MD_DEALLOC_FILE> %s </MD_DEALLOC_FILE>"
+                     "\n        <MD_DEALLOC_LINE> %u </MD_DEALLOC_LINE>"
+                     "\n      </MD_EVENT_RECORD>",
+              (unsigned int)pTempEvent->Size,
+              pTempEvent->AllocFilename, pTempEvent->AllocLine,
+              pTempEvent->DeallocFilename, pTempEvent->DeallocLine);
+
+      if ((0 != pTempEvent->AllocLine) && (0 != pTempEvent->DeallocLine)) {
+        ++nValid;
+      }
+      else {
+        ++nInvalid;
+      }
+    }
+
+    fprintf(pFile, "\n    </MD_RUN_RECORD>");
   }
 
-  if (NULL == (pFile = fopen(szDumpFileName, "w"))) {
-    fprintf(stderr, _("Failed to open file \"%s\" : %s"), szDumpFileName, strerror(errno));
-    return;
+  time(&tTime);
+  fprintf(pFile, "\n  </MD_RUN_LISTING>"
+                 "\n  <MD_SUMMARY>"
+                 "\n    <MD_SUMMARY_VALID_RECORDS> %u </MD_SUMMARY_VALID_RECORDS>"
+                 "\n    <MD_SUMMARY_INVALID_RECORDS> %u </MD_SUMMARY_INVALID_RECORDS>"
+                 "\n    <MD_SUMMARY_TOTAL_RECORDS> %u </MD_SUMMARY_TOTAL_RECORDS>"
+                 "\n  </MD_SUMMARY>"
+                 "\n  <MD_FOOTER> Memory Trace for CUnit Run at %s </MD_FOOTER>"
+                 "</MEMORY_DUMP_REPORT>",
+          nValid, nInvalid, nValid + nInvalid, ctime(&tTime));
+}
+
+/*------------------------------------------------------------------------*/
+/** Write an unsigned integer of nBytes bytes, least significant first. */
+static void write_binary_uint(FILE* pFile, unsigned long long ullValue, unsigned int nBytes)
+{
+  unsigned char abBytes[8];
+  unsigned int i;
+
+  assert(nBytes <= sizeof(abBytes));
+  for (i = 0 ; i < nBytes ; ++i) {
+    abBytes[i] = (unsigned char)(ullValue & 0xFF);
+    ullValue >>= 8;
   }
+  fwrite(abBytes, 1, nBytes, pFile);
+}
 
-  setvbuf(pFile, NULL, _IONBF, 0);
-
-  fprintf(pFile, "<\?xml version=\"1.0\" \?>");
-  fprintf(pFile, "\n<\?xml-stylesheet type=\"text/xsl\" href=\"Memory-Dump.xsl\" \?>");
-  fprintf(pFile, "\n<!DOCTYPE MEMORY_DUMP_REPORT SYSTEM \"Memory-Dump.dtd\">");
-  fprintf(pFile, "\n<MEMORY_DUMP_REPORT>");
-  fprintf(pFile, "\n  <MD_HEADER/>");
-  fprintf(pFile, "\n  <MD_RUN_LISTING>");
-
-  nValid = 0;
-  nInvalid = 0;
-  pTempNode = f_pMemoryTrackerHead;
-  while (NULL != pTempNode) {
-    fprintf(pFile, "\n    <MD_RUN_RECORD>");
-    fprintf(pFile, "\n      <MD_POINTER> %p </MD_POINTER>", pTempNode->pLocation);
-    fprintf(pFile, "\n      <MD_EVENT_COUNT> %u </MD_EVENT_COUNT>", pTempNode->EventCount);
-
-    pTempEvent = pTempNode->pFirstEvent;
-    while (NULL != pTempEvent) {
-      fprintf(pFile, "\n      <MD_EVENT_RECORD>");
-      fprintf(pFile, "\n        <MD_SIZE> %u </MD_SIZE>", pTempEvent->Size);
-      fprintf(pFile, "\n        <MD_ALLOC_FILE> %s </MD_ALLOC_FILE>", pTempEvent->AllocFilename);
-      fprintf(pFile, "\n        <MD_ALLOC_LINE> %u </MD_ALLOC_LINE>", pTempEvent->AllocLine);
-      fprintf(pFile, "\n        <MD_DEALLOC_FILE> %s </MD_DEALLOC_FILE>", pTempEvent->DeallocFilename);
-      fprintf(pFile, "\n        <MD_DEALLOC_LINE> %u </MD_DEALLOC_LINE>", pTempEvent->DeallocLine);
-      fprintf(pFile, "\n      </MD_EVENT_RECORD>");
+/** Map of interned file names to their ids in a binary dump. */
+typedef struct NameIds
+{
+  const char**   apNames;   /**< Open-addressing table of names. */
+  unsigned long* aulIds;    /**< Id of the name in the same slot. */
+  size_t         szSize;    /**< Slots (a power of 2). */
+} NameIds;
 
-      if ((0 != pTempEvent->AllocLine) && (0 != pTempEvent->DeallocLine)) {
-        ++nValid;
+/** Look up the slot of an interned file name in a NameIds map. */
+static size_t name_id_slot(const NameIds* pIds, const char* szName)
+{
+  size_t mask = pIds->szSize - 1;
+  size_t i;
+
+  for (i = hash_location(szName, mask) ; (NULL != pIds->apNames[i]) && (szName != pIds->apNames[i]) ; i = (i + 1) & mask)
+    ;
+  return i;
+}
+
+/** Look up the id of an interned file name (0 for the empty name). */
+static unsigned long name_id(const NameIds* pIds, const char* szName)
+{
+  if ('\0' == *szName) {
+    return 0;
+  }
+  return pIds->aulIds[name_id_slot(pIds, szName)];
+}
+
+/*------------------------------------------------------------------------*/
+/** Write all memory events in the binary dump format.
+ *  All integers are unsigned and stored least significant byte first:
+ *  <pre>
+ *    magic          8 bytes  CU_MEMORY_DUMP_MAGIC
+ *    version        4        CU_MEMORY_DUMP_VERSION
+ *    name count     4        followed by the file names, with ids 1, 2, ...
+ *      length       4
+ *      characters   length   (not terminated)
+ *    node count     4        followed by the memory nodes in order of creation
+ *      location     8
+ *      event count  4        followed by the events of the node
+ *        size       8
+ *        alloc line 4
+ *        alloc file 4        name id, 0 for none
+ *        free line  4
+ *        free file  4        name id, 0 for none
+ *    time           8        time of the dump (seconds since the epoch)
+ *  </pre>
+ *  The caller must hold the tracker lock.
+ */
+static void dump_memory_binary(FILE* pFile)
+{
+  NameIds ids;
+  PMEMORY_NODE pTempNode = NULL;
+  PMEMORY_EVENT pTempEvent = NULL;
+  unsigned long ulId = 0;
+  size_t szLength;
+  size_t i;
+  size_t j;
+
+  ids.szSize = (f_szFileNamesSize > 0) ? 2 * f_szFileNamesSize : 1;
+  ids.apNames = (const char**)calloc(ids.szSize, sizeof(const char*));
+  ids.aulIds = (unsigned long*)calloc(ids.szSize, sizeof(unsigned long));
+  assert((NULL != ids.apNames) && (NULL != ids.aulIds));
+
+  fwrite(CU_MEMORY_DUMP_MAGIC, 1, 8, pFile);
+  write_binary_uint(pFile, CU_MEMORY_DUMP_VERSION, 4);
+
+  write_binary_uint(pFile, f_nFileNames, 4);
+  for (i = 0 ; i < f_szFileNamesSize ; ++i) {
+    if (NULL != f_apFileNames[i]) {
+      j = name_id_slot(&ids, f_apFileNames[i]);
+      ids.apNames[j] = f_apFileNames[i];
+      ids.aulIds[j] = ++ulId;
+
+      szLength = strlen(f_apFileNames[i]);
+      write_binary_uint(pFile, szLength, 4);
+      fwrite(f_apFileNames[i], 1, szLength, pFile);
+    }
+  }
+
+  write_binary_uint(pFile, f_nMemoryNodes, 4);
+  for (pTempNode = f_pMemoryTrackerHead ; NULL != pTempNode ; pTempNode = pTempNode->pNext) {
+    write_binary_uint(pFile, (size_t)pTempNode->pLocation, 8);
+    write_binary_uint(pFile, pTempNode->EventCount, 4);
+
+    for (pTempEvent = pTempNode->pFirstEvent ; NULL != pTempEvent ; pTempEvent = pTempEvent->pNext) {
+      write_binary_uint(pFile, pTempEvent->Size, 8);
+      write_binary_uint(pFile, pTempEvent->AllocLine, 4);
+      write_binary_uint(pFile, name_id(&ids, pTempEvent->AllocFilename), 4);
+      write_binary_uint(pFile, pTempEvent->DeallocLine, 4);
+      write_binary_uint(pFile, name_id(&ids, pTempEvent->DeallocFilename), 4);
+    }
+  }
+
+  write_binary_uint(pFile, (unsigned long long)time(NULL), 8);
+
+  free(ids.apNames);
+  free(ids.aulIds);
+}
+
+/*------------------------------------------------------------------------*/
+/** Leak and double free counts of a source location. */
+typedef struct SiteCounts
+{
+  const char*   szFile;         /**< Interned file name. */
+  unsigned int  uiLine;         /**< Line number. */
+  unsigned long ulLeaks;        /**< Blocks allocated here and never freed. */
+  size_t        szLeakedBytes;  /**< Bytes in those blocks. */
+  unsigned long ulDoubleFrees;  /**< Blocks allocated here and freed more than once. */
+  unsigned long ulBadFrees;     /**< Frees here of pointers never allocated. */
+} SiteCounts;
+
+/** Open-addressing table of SiteCounts. */
+typedef struct SiteTable
+{
+  SiteCounts* aSites;
+  size_t      szSize;           /**< Slots (a power of 2). */
+  size_t      nSites;           /**< Used slots. */
+} SiteTable;
+
+/** Find or add the counts of a source location, growing the table as needed. */
+static SiteCounts* site_counts(SiteTable* pTable, const char* szFile, unsigned int uiLine)
+{
+  SiteCounts* aOld;
+  size_t szOldSize;
+  size_t mask;
+  size_t i;
+  size_t j;
+
+  if ((pTable->nSites + 1) * 2 > pTable->szSize) {
+    aOld = pTable->aSites;
+    szOldSize = pTable->szSize;
+    pTable->szSize = (0 == szOldSize) ? 256 : 2 * szOldSize;
+    pTable->aSites = (SiteCounts*)calloc(pTable->szSize, sizeof(SiteCounts));
+    assert(NULL != pTable->aSites);
+
+    mask = pTable->szSize - 1;
+    for (i = 0 ; i < szOldSize ; ++i) {
+      if (NULL != aOld[i].szFile) {
+        for (j = (hash_location(aOld[i].szFile, mask) + aOld[i].uiLine) & mask ; NULL != pTable->aSites[j].szFile ; j = (j + 1) & mask)
+          ;
+        pTable->aSites[j] = aOld[i];
+      }
+    }
+    free(aOld);
+  }
+
+  mask = pTable->szSize - 1;
+  for (i = (hash_location(szFile, mask) + uiLine) & mask ; NULL != pTable->aSites[i].szFile ; i = (i + 1) & mask) {
+    if ((szFile == pTable->aSites[i].szFile) && (uiLine == pTable->aSites[i].uiLine)) {
+      return &pTable->aSites[i];
+    }
+  }
+  pTable->aSites[i].szFile = szFile;
+  pTable->aSites[i].uiLine = uiLine;
+  ++pTable->nSites;
+  return &pTable->aSites[i];
+}
+
+/** Orders sites by number of problems (most first), then by location. */
+static int compare_site_counts(const void* pA, const void* pB)
+{
+  const SiteCounts* pSiteA = (const SiteCounts*)pA;
+  const SiteCounts* pSiteB = (const SiteCounts*)pB;
+  unsigned long ulA = pSiteA->ulLeaks + pSiteA->ulDoubleFrees + pSiteA->ulBadFrees;
+  unsigned long ulB = pSiteB->ulLeaks + pSiteB->ulDoubleFrees + pSiteB->ulBadFrees;
+  int iResult;
+
+  if (ulA != ulB) {
+    return (ulA > ulB) ? -1 : 1;
+  }
+  if (0 != (iResult = strcmp(pSiteA->szFile, pSiteB->szFile))) {
+    return iResult;
+  }
+  return (pSiteA->uiLine < pSiteB->uiLine) ? -1 : (pSiteA->uiLine > pSiteB->uiLine);
+}
+
+/*------------------------------------------------------------------------*/
+/** Write a text summary of leaks and double frees per allocation site.
+ *  A free of a pointer with no recorded allocation is counted at the
+ *  site of the free.  The caller must hold the tracker lock.
+ */
+static void dump_memory_summary(FILE* pFile)
+{
+  SiteTable table = {NULL, 0, 0};
+  SiteCounts* pSite;
+  PMEMORY_NODE pTempNode = NULL;
+  PMEMORY_EVENT pTempEvent = NULL;
+  PMEMORY_EVENT pAllocEvent = NULL;
+  unsigned long ulAllocations = 0;
+  unsigned long ulLeaks = 0;
+  unsigned long ulDoubleFrees = 0;
+  unsigned long ulBadFrees = 0;
+  size_t szLeakedBytes = 0;
+  size_t i;
+  size_t n;
+
+  for (pTempNode = f_pMemoryTrackerHead ; NULL != pTempNode ; pTempNode = pTempNode->pNext) {
+    pAllocEvent = NULL;
+    for (pTempEvent = pTempNode->pFirstEvent ; NULL != pTempEvent ; pTempEvent = pTempEvent->pNext) {
+      if (NOT_ALLOCATED != pTempEvent->AllocLine) {
+        ++ulAllocations;
+        pAllocEvent = pTempEvent;
+        if (NOT_DELETED == pTempEvent->DeallocLine) {
+          pSite = site_counts(&table, pTempEvent->AllocFilename, pTempEvent->AllocLine);
+          ++pSite->ulLeaks;
+          pSite->szLeakedBytes += pTempEvent->Size;
+          ++ulLeaks;
+          szLeakedBytes += pTempEvent->Size;
+        }
+      }
+      else if (NULL != pAllocEvent) {
+        ++site_counts(&table, pAllocEvent->AllocFilename, pAllocEvent->AllocLine)->ulDoubleFrees;
+        ++ulDoubleFrees;
       }
       else {
-        ++nInvalid;
+        ++site_counts(&table, pTempEvent->DeallocFilename, pTempEvent->DeallocLine)->ulBadFrees;
+        ++ulBadFrees;
       }
+    }
+  }
 
-      pTempEvent = pTempEvent->pNext;
+  /* compact the used slots for sorting */
+  for (i = 0, n = 0 ; i < table.szSize ; ++i) {
+    if (NULL != table.aSites[i].szFile) {
+      table.aSites[n++] = table.aSites[i];
     }
+  }
+  if (n > 0) {
+    qsort(table.aSites, n, sizeof(SiteCounts), compare_site_counts);
+  }
 
-    fprintf(pFile, "\n    </MD_RUN_RECORD>");
-    pTempNode = pTempNode->pNext;
+  fprintf(pFile, "%s\n\n", _("CUnit Memory Summary"));
+  fprintf(pFile, "  %-22s %10lu\n", _("Allocations:"), ulAllocations);
+  fprintf(pFile, "  %-22s %10lu  (%lu bytes)\n", _("Leaks:"), ulLeaks, (unsigned long)szLeakedBytes);
+  fprintf(pFile, "  %-22s %10lu\n", _("Double frees:"), ulDoubleFrees);
+  fprintf(pFile, "  %-22s %10lu\n", _("Unallocated frees:"), ulBadFrees);
+
+  if (n > 0) {
+    fprintf(pFile, "\n  %10s %12s %12s %12s  %s\n",
+            _("Leaks"), _("Bytes"), _("Double"), _("Unalloc"), _("Site"));
+    for (i = 0 ; i < n ; ++i) {
+      fprintf(pFile, "  %10lu %12lu %12lu %12lu  %s:%u\n",
+              table.aSites[i].ulLeaks, (unsigned long)table.aSites[i].szLeakedBytes,
+              table.aSites[i].ulDoubleFrees, table.aSites[i].ulBadFrees,
+              table.aSites[i].szFile, table.aSites[i].uiLine);
+    }
   }
 
-  fprintf(pFile, "\n  </MD_RUN_LISTING>");
+  free(table.aSites);
+}
 
-  fprintf(pFile, "\n  <MD_SUMMARY>");
-  fprintf(pFile, "\n    <MD_SUMMARY_VALID_RECORDS> %u </MD_SUMMARY_VALID_RECORDS>", nValid);
-  fprintf(pFile, "\n    <MD_SUMMARY_INVALID_RECORDS> %u </MD_SUMMARY_INVALID_RECORDS>", nInvalid);
-  fprintf(pFile, "\n    <MD_SUMMARY_TOTAL_RECORDS> %u </MD_SUMMARY_TOTAL_RECORDS>", nValid + nInvalid);
-  fprintf(pFile, "\n  </MD_SUMMARY>");
+/*------------------------------------------------------------------------*/
+/** Select the format of the memory report. */
+void CU_set_memory_dump_format(CU_MemoryDumpFormat format)
+{
+  f_MemoryDumpFormat = format;
+}
 
-  time(&tTime);
-  fprintf(pFile, "\n  <MD_FOOTER> Memory Trace for CUnit Run at %s </MD_FOOTER>", ctime(&tTime));
-  fprintf(pFile, "</MEMORY_DUMP_REPORT>");
+/*------------------------------------------------------------------------*/
+/** Retrieve the format of the memory report. */
+CU_MemoryDumpFormat CU_get_memory_dump_format(void)
+{
+  return f_MemoryDumpFormat;
+}
+
+/*------------------------------------------------------------------------*/
+/** Print a report of memory events to file. */
+void CU_dump_memory_usage(const char* szFilename)
+{
+  const char* szDumpFileName;
+  FILE* pFile = NULL;
+  CU_MemoryDumpFormat format = f_MemoryDumpFormat;
+
+  /* use the specified file name, if supplied) */
+  if ((NULL != szFilename) && strlen(szFilename) > 0) {
+    szDumpFileName = szFilename;
+  }
+  else if (CU_MEMORY_DUMP_BINARY == format) {
+    szDumpFileName = f_szDefaultBinaryDumpFileName;
+  }
+  else if (CU_MEMORY_DUMP_SUMMARY == format) {
+    szDumpFileName = f_szDefaultSummaryFileName;
+  }
+  else {
+    szDumpFileName = f_szDefaultDumpFileName;
+  }
+
+  if (NULL == (pFile = fopen(szDumpFileName, (CU_MEMORY_DUMP_BINARY == format) ? "wb" : "w"))) {
+    fprintf(stderr, _("Failed to open file \"%s\" : %s"), szDumpFileName, strerror(errno));
+    return;
+  }
+
+  setvbuf(pFile, NULL, _IOFBF, MEMORY_DUMP_BUFSIZE);
+
+  MEMTRACE_LOCK();
+  switch (format) {
+    case CU_MEMORY_DUMP_BINARY:
+      dump_memory_binary(pFile);
+      break;
+    case CU_MEMORY_DUMP_SUMMARY:
+      dump_memory_summary(pFile);
+      break;
+    default:
+      dump_memory_xml(pFile);
+      break;
+  }
+  MEMTRACE_UNLOCK();
 
   fclose(pFile);
 }
@@ -425,17 +1214,25 @@ void test_cunit_activate_malloc(void)
 /** Retrieve the number of memory events recorded for a given pointer. */
 unsigned int test_cunit_get_n_memevents(void* pLocation)
 {
-  PMEMORY_NODE pNode = find_memory_node(pLocation);
-  return (pNode) ? pNode->EventCount : 0;
+  PMEMORY_NODE pNode;
+  unsigned int result;
+
+  MEMTRACE_LOCK();
+  pNode = find_memory_node(pLocation);
+  result = (pNode) ? pNode->EventCount : 0;
+  MEMTRACE_UNLOCK();
+  return result;
 }
 
 /** Retrieve the number of memory allocations recorded for a given pointer. */
 unsigned int test_cunit_get_n_allocations(void* pLocation)
 {
-  PMEMORY_NODE pNode = find_memory_node(pLocation);
+  PMEMORY_NODE pNode;
   PMEMORY_EVENT pEvent = NULL;
   int result = 0;
 
+  MEMTRACE_LOCK();
+  pNode = find_memory_node(pLocation);
   if (NULL != pNode) {
     pEvent = pNode->pFirstEvent;
     while (NULL != pEvent) {
@@ -444,6 +1241,7 @@ unsigned int test_cunit_get_n_allocations(void* pLocation)
       pEvent = pEvent->pNext;
     }
   }
+  MEMTRACE_UNLOCK();
 
   return result;
 }
@@ -451,10 +1249,12 @@ unsigned int test_cunit_get_n_allocations(void* pLocation)
 /** Retrieve the number of memory deallocations recorded for a given pointer. */
 unsigned int test_cunit_get_n_deallocations(void* pLocation)
 {
-  PMEMORY_NODE pNode = find_memory_node(pLocation);
+  PMEMORY_NODE pNode;
   PMEMORY_EVENT pEvent = NULL;
   int result = 0;
 
+  MEMTRACE_LOCK();
+  pNode = find_memory_node(pLocation);
   if (NULL != pNode) {
     pEvent = pNode->pFirstEvent;
     while (NULL != pEvent) {
@@ -463,6 +1263,7 @@ unsigned int test_cunit_get_n_deallocations(void* pLocation)
       pEvent = pEvent->pNext;
     }
   }
+  MEMTRACE_UNLOCK();
 
   return result;
 }
@@ -569,6 +1370,309 @@ void test_CU_realloc(void)
   free(ptr2);
 }
 
+#ifndef _WIN32
+/** Allocates and frees tracked blocks from a thread of test_memory_tracker(). */
+static void* memory_tracker_thread(void* pArg)
+{
+  void* apBlocks[100];
+  unsigned int i;
+  unsigned int j;
+
+  for (j = 0 ; j < 20 ; ++j) {
+    for (i = 0 ; i < 100 ; ++i) {
+      apBlocks[i] = CU_MALLOC(8 + i);
+    }
+    for (i = 0 ; i < 100 ; ++i) {
+      CU_FREE(apBlocks[i]);
+    }
+  }
+  return pArg;
+}
+#endif
+
+void test_memory_tracker(void)
+{
+  void* apBlocks[3000];
+  unsigned int i;
+  CU_BOOL bRecorded = CU_TRUE;
+  PMEMORY_NODE pNode;
+#ifndef _WIN32
+  pthread_t aThreads[4];
+  unsigned int nThreads = 0;
+#endif
+
+  /* enough distinct locations to grow the node index several times */
+  for (i = 0 ; i < 3000 ; ++i) {
+    apBlocks[i] = CU_MALLOC(1);
+    if (NULL == apBlocks[i]) {
+      bRecorded = CU_FALSE;
+    }
+  }
+  TEST_FATAL(CU_FALSE != bRecorded);
+  for (i = 0 ; i < 3000 ; ++i) {
+    if (test_cunit_get_n_allocations(apBlocks[i]) != 1 + test_cunit_get_n_deallocations(apBlocks[i])) {
+      bRecorded = CU_FALSE;
+    }
+    CU_FREE(apBlocks[i]);
+    if (test_cunit_get_n_allocations(apBlocks[i]) != test_cunit_get_n_deallocations(apBlocks[i])) {
+      bRecorded = CU_FALSE;
+    }
+  }
+  TEST(CU_FALSE != bRecorded);
+  TEST(f_szNodeIndexSize >= 2 * f_nMemoryNodes);
+
+  /* file names are stored once */
+  apBlocks[0] = CU_MALLOC(1);
+  apBlocks[1] = CU_MALLOC(1);
+  TEST_FATAL((NULL != apBlocks[0]) && (NULL != apBlocks[1]));
+  MEMTRACE_LOCK();
+  pNode = find_memory_node(apBlocks[0]);
+  TEST(NULL != pNode);
+  if (NULL != pNode) {
+    TEST(pNode->pLastEvent->AllocFilename == intern_file_name(__FILE__));
+    TEST(0 == strcmp(pNode->pLastEvent->AllocFilename, __FILE__));
+  }
+  MEMTRACE_UNLOCK();
+  CU_FREE(apBlocks[0]);
+  CU_FREE(apBlocks[1]);
+
+  /* double deletion is recorded as a new event */
+  apBlocks[0] = CU_MALLOC(1);
+  TEST_FATAL(NULL != apBlocks[0]);
+  i = test_cunit_get_n_memevents(apBlocks[0]);
+  deallocate_memory(apBlocks[0], __LINE__, __FILE__);
+  deallocate_memory(apBlocks[0], __LINE__, __FILE__);
+  TEST(i + 1 == test_cunit_get_n_memevents(apBlocks[0]));
+  TEST(test_cunit_get_n_allocations(apBlocks[0]) + 1 == test_cunit_get_n_deallocations(apBlocks[0]));
+  CU_allocator_free(apBlocks[0]);
+
+#ifndef _WIN32
+  /* concurrent tracking */
+  for (i = 0 ; i < 4 ; ++i) {
+    if (0 == pthread_create(&aThreads[nThreads], NULL, memory_tracker_thread, NULL)) {
+      ++nThreads;
+    }
+  }
+  for (i = 0 ; i < nThreads ; ++i) {
+    pthread_join(aThreads[i], NULL);
+  }
+  TEST(0 < nThreads);
+#endif
+}
+
+/** Read a whole (small) file into a new buffer; *pszLength receives its length. */
+static char* read_test_file(const char* szFileName, size_t* pszLength)
+{
+  FILE* pFile = fopen(szFileName, "rb");
+  char* pBuffer = NULL;
+  long lLength;
+
+  if (NULL != pFile) {
+    if ((0 == fseek(pFile, 0, SEEK_END)) && (0 <= (lLength = ftell(pFile))) && (0 == fseek(pFile, 0, SEEK_SET))) {
+      pBuffer = (char*)malloc((size_t)lLength + 1);
+      if (NULL != pBuffer) {
+        *pszLength = fread(pBuffer, 1, (size_t)lLength, pFile);
+        pBuffer[*pszLength] = '\0';
+      }
+    }
+    fclose(pFile);
+  }
+  return pBuffer;
+}
+
+void test_memory_dump_formats(void)
+{
+  static const char* szTestFile = "test_cunit_memdump.tmp";
+  char szSite[MAX_FILE_NAME_LENGTH + 32];
+  char* pContent;
+  size_t szLength = 0;
+  void* pLeak;
+  unsigned int uiLeakLine;
+
+  TEST(CU_MEMORY_DUMP_XML == CU_get_memory_dump_format());
+
+  pLeak = CU_MALLOC(12345); uiLeakLine = __LINE__;
+  TEST_FATAL(NULL != pLeak);
+
+  /* xml listing */
+  CU_dump_memory_usage(szTestFile);
+  pContent = read_test_file(szTestFile, &szLength);
+  TEST_FATAL(NULL != pContent);
+  TEST(NULL != strstr(pContent, "<MD_SIZE> 12345 </MD_SIZE>"));
+  TEST(NULL != strstr(pContent, "</MEMORY_DUMP_REPORT>"));
+  free(pContent);
+
+  /* binary dump */
+  CU_SET_MEMORY_DUMP_FORMAT(CU_MEMORY_DUMP_BINARY);
+  TEST(CU_MEMORY_DUMP_BINARY == CU_get_memory_dump_format());
+  CU_dump_memory_usage(szTestFile);
+  pContent = read_test_file(szTestFile, &szLength);
+  TEST_FATAL(NULL != pContent);
+  TEST(szLength > 36);
+  TEST(0 == memcmp(pContent, CU_MEMORY_DUMP_MAGIC, 8));
+  TEST(CU_MEMORY_DUMP_VERSION == (unsigned char)pContent[8]);
+  TEST(0 == pContent[9] && 0 == pContent[10] && 0 == pContent[11]);
+  free(pContent);
+
+  /* summary lists the leak at its allocation site */
+  CU_SET_MEMORY_DUMP_FORMAT(CU_MEMORY_DUMP_SUMMARY);
+  CU_dump_memory_usage(szTestFile);
+  pContent = read_test_file(szTestFile, &szLength);
+  TEST_FATAL(NULL != pContent);
+  snprintf(szSite, sizeof(szSite), "  %s:%u\n", intern_file_name(__FILE__), uiLeakLine);
+  TEST(NULL != strstr(pContent, szSite));
+  TEST(NULL != strstr(pContent, "12345"));
+  free(pContent);
+
+  CU_FREE(pLeak);
+  CU_dump_memory_usage(szTestFile);
+  pContent = read_test_file(szTestFile, &szLength);
+  TEST_FATAL(NULL != pContent);
+  TEST(NULL == strstr(pContent, szSite));
+  free(pContent);
+
+  CU_SET_MEMORY_DUMP_FORMAT(CU_MEMORY_DUMP_XML);
+  remove(szTestFile);
+}
+
+/** Allocation counts of counting_allocator. */
+typedef struct AllocCounts
+{
+  unsigned int nMallocs;
+  unsigned int nReallocs;
+  unsigned int nFrees;
+} AllocCounts;
+
+static void* counting_malloc(size_t size, void* pContext)
+{
+  ++((AllocCounts*)pContext)->nMallocs;
+  return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size, void* pContext)
+{
+  ++((AllocCounts*)pContext)->nReallocs;
+  return realloc(ptr, size);
+}
+
+static void counting_free(void* ptr, void* pContext)
+{
+  ++((AllocCounts*)pContext)->nFrees;
+  free(ptr);
+}
+
+void test_CU_set_allocator(void)
+{
+  AllocCounts counts = {0, 0, 0};
+  CU_Allocator allocator = {counting_malloc, counting_realloc, counting_free, NULL};
+  const CU_Allocator* pDefault = CU_get_allocator();
+  CU_MallocFunc pDefaultMalloc = pDefault->pMalloc;
+  char* ptr1;
+
+  allocator.pContext = &counts;
+  CU_cleanup_registry();
+
+  /* incomplete allocators are rejected */
+  allocator.pFree = NULL;
+  TEST(CUE_BAD_ALLOCATOR == CU_set_allocator(&allocator));
+  TEST(CUE_BAD_ALLOCATOR == CU_get_error());
+  TEST(pDefaultMalloc == CU_get_allocator()->pMalloc);
+  allocator.pFree = counting_free;
+
+  TEST(CUE_SUCCESS == CU_set_allocator(&allocator));
+  allocator.pContext = NULL;                      /* the allocator was copied */
+  TEST(&counts == CU_get_allocator()->pContext);
+
+  ptr1 = (char*)CU_MALLOC(10);
+  TEST_FATAL(NULL != ptr1);
+  TEST(1 == counts.nMallocs);
+  ptr1 = (char*)CU_REALLOC(ptr1, 20);
+  TEST_FATAL(NULL != ptr1);
+  TEST(1 == counts.nReallocs);
+  CU_FREE(ptr1);
+  TEST(1 == counts.nFrees);
+  ptr1 = (char*)CU_CALLOC(4, 8);
+  TEST_FATAL(NULL != ptr1);
+  TEST(2 == counts.nMallocs);
+  TEST((0 == ptr1[0]) && (0 == ptr1[31]));
+  CU_FREE(ptr1);
+  TEST(NULL == CU_CALLOC((size_t)-1, 16));         /* overflow */
+  TEST(2 == counts.nMallocs);
+
+  /* the registry is allocated through the allocator, and pins it */
+  TEST(CUE_SUCCESS == CU_initialize_registry());
+  TEST(counts.nMallocs > 2);
+  TEST(CUE_REGISTRY_EXISTS == CU_set_allocator(NULL));
+  TEST(&counts == CU_get_allocator()->pContext);
+  CU_cleanup_registry();
+  TEST(counts.nMallocs == counts.nFrees);
+
+  TEST(CUE_SUCCESS == CU_set_allocator(NULL));
+  TEST(pDefaultMalloc == CU_get_allocator()->pMalloc);
+  TEST(NULL == CU_get_allocator()->pContext);
+}
+
+void test_arena_allocator(void)
+{
+  static const size_t aSizes[] = {1, 16, 17, 100, 2048, 2049, 5000, 300000};
+  void* apBlocks[sizeof(aSizes) / sizeof(aSizes[0])];
+  unsigned char* ptr1;
+  void* ptr2;
+  unsigned int i;
+  size_t j;
+  CU_BOOL bIntact = CU_TRUE;
+
+  CU_cleanup_registry();
+  TEST(CUE_SUCCESS == CU_set_allocator(CU_get_arena_allocator()));
+  TEST(arena_malloc == CU_get_allocator()->pMalloc);
+
+  for (i = 0 ; i < sizeof(aSizes) / sizeof(aSizes[0]) ; ++i) {
+    apBlocks[i] = CU_MALLOC(aSizes[i]);
+    TEST_FATAL(NULL != apBlocks[i]);
+    TEST(0 == (size_t)apBlocks[i] % sizeof(void*));
+    memset(apBlocks[i], (int)i + 1, aSizes[i]);
+  }
+  for (i = 0 ; i < sizeof(aSizes) / sizeof(aSizes[0]) ; ++i) {
+    for (j = 0 ; j < aSizes[i] ; ++j) {
+      if ((int)i + 1 != ((unsigned char*)apBlocks[i])[j]) {
+        bIntact = CU_FALSE;
+      }
+    }
+    CU_FREE(apBlocks[i]);
+  }
+  TEST(CU_FALSE != bIntact);
+
+  /* freed blocks are reused within their class */
+  ptr1 = (unsigned char*)CU_MALLOC(100);
+  CU_FREE(ptr1);
+  ptr2 = CU_MALLOC(120);
+  TEST(ptr2 == (void*)ptr1);
+  CU_FREE(ptr2);
+
+  /* realloc keeps the block within its class, and the contents when moving */
+  ptr1 = (unsigned char*)CU_MALLOC(40);
+  TEST_FATAL(NULL != ptr1);
+  for (j = 0 ; j < 40 ; ++j) {
+    ptr1[j] = (unsigned char)j;
+  }
+  TEST(ptr1 == CU_REALLOC(ptr1, 60));
+  ptr1 = (unsigned char*)CU_REALLOC(ptr1, 10000);
+  TEST_FATAL(NULL != ptr1);
+  TEST((0 == ptr1[0]) && (39 == ptr1[39]));
+  ptr1 = (unsigned char*)CU_REALLOC(ptr1, 20);
+  TEST_FATAL(NULL != ptr1);
+  TEST((0 == ptr1[0]) && (19 == ptr1[19]));
+  CU_FREE(ptr1);
+
+  /* a full run with the registry in the arena */
+  TEST(CUE_SUCCESS == CU_initialize_registry());
+  TEST(NULL != CU_add_test(CU_add_suite("suite1", NULL, NULL), "test1", test_CU_free));
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  CU_cleanup_registry();
+
+  TEST(CUE_SUCCESS == CU_set_allocator(NULL));
+}
+
 /** The main internal testing function for MyMem.c. */
 void test_cunit_MyMem(void)
 {
@@ -578,6 +1682,10 @@ void test_cunit_MyMem(void)
   test_CU_malloc();
   test_CU_free();
   test_CU_realloc();
+  test_memory_tracker();
+  test_memory_dump_formats();
+  test_CU_set_allocator();
+  test_arena_allocator();
 
   test_cunit_end_tests();
 }
@@ -0,0 +1,1125 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of sharding of test runs.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Sharding of test runs (implementation).
+ *  The timing file is read whole at the start of a run into a hash
+ *  table, which is dropped once the tests are packed.  Packing keeps
+ *  the shards in a binary heap ordered by their work and index, so
+ *  that every shard computes the same partition.
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L   /* setenv(), unsetenv() in the tests under -std=c99 */
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "Shard.h"
+
+#define MAX_TIMING_FILENAME 1024    /**< Longest timing file name accepted. */
+#define READ_CHUNK          65536   /**< Bytes read from the timing file at a time. */
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+/** A test and its duration in the timing file. */
+typedef struct TimingEntry
+{
+  const char* szSuite;        /**< Suite name. */
+  const char* szTest;         /**< Test name. */
+  double      dDuration;      /**< Duration in seconds. */
+} TimingEntry;
+
+/** Contents of the timing file. */
+typedef struct TimingTable
+{
+  char*         pText;        /**< File contents, names decoded in place. */
+  TimingEntry*  pEntries;     /**< Entries, one per test. */
+  unsigned int  nEntries;     /**< Number of entries. */
+  unsigned int* pSlots;       /**< Hash table of entry numbers + 1 (0 for free slots). */
+  unsigned int  nSlots;       /**< Number of slots (a power of 2). */
+} TimingTable;
+
+/** An active test to be packed into a shard. */
+typedef struct ShardItem
+{
+  CU_pTest      pTest;        /**< The test. */
+  double        dCost;        /**< Its expected duration. */
+  unsigned int  uiOrder;      /**< Its position in the registry, for ties. */
+} ShardItem;
+
+/** A test run, for the timing file. */
+typedef struct ShardRun
+{
+  CU_pSuite     pSuite;       /**< Suite of the test. */
+  CU_pTest      pTest;        /**< The test. */
+} ShardRun;
+
+static unsigned int f_uiShardIndex = 0;     /**< Shard set with CU_set_shard(). */
+static unsigned int f_uiShardTotal = 0;     /**< Shards set with CU_set_shard() (0 for the environment). */
+static char*        f_szTimingFile = NULL;  /**< Timing file (NULL if none). */
+static char*        f_szTimingOutput = NULL; /**< Timing output file (NULL if none). */
+
+static CU_BOOL      f_bRecording = CU_FALSE; /**< Flag for a sharded run noting its tests. */
+static ShardRun*    f_pRan = NULL;          /**< Tests run since CU_shard_begin_run(). */
+static size_t       f_nRan = 0;             /**< Number of entries of f_pRan. */
+static size_t       f_nRanCapacity = 0;     /**< Allocated entries of f_pRan. */
+
+/*=================================================================
+ *  Static function implementation
+ *=================================================================*/
+/** Hashes the names of a test, or of a suite if szTest is NULL (FNV-1a). */
+static unsigned int hash_names(const char* szSuite, const char* szTest)
+{
+  unsigned int uiHash = 2166136261u;
+  const unsigned char* pPos;
+
+  for (pPos = (const unsigned char*)szSuite ; '\0' != *pPos ; ++pPos) {
+    uiHash = (uiHash ^ *pPos) * 16777619u;
+  }
+  if (NULL != szTest) {
+    uiHash = (uiHash ^ 0xFFu) * 16777619u;
+    for (pPos = (const unsigned char*)szTest ; '\0' != *pPos ; ++pPos) {
+      uiHash = (uiHash ^ *pPos) * 16777619u;
+    }
+  }
+  return uiHash;
+}
+
+/*------------------------------------------------------------------------*/
+/** Parses a shard count or index from the environment.
+ *  @return CU_FALSE if szValue is not a decimal number.
+ */
+static CU_BOOL parse_count(const char* szValue, unsigned int* puiValue)
+{
+  char* pEnd;
+  unsigned long ulValue;
+
+  if ((NULL == szValue) || (szValue[0] < '0') || (szValue[0] > '9')) {
+    return CU_FALSE;
+  }
+  ulValue = strtoul(szValue, &pEnd, 10);
+  if (('\0' != *pEnd) || (ulValue > UINT_MAX)) {
+    return CU_FALSE;
+  }
+  *puiValue = (unsigned int)ulValue;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Determines the shard to run.
+ *  @param puiIndex   Receives the index of the shard.
+ *  @param puiTotal   Receives the number of shards.
+ *  @param pbFromEnv  Receives CU_TRUE if sharding is set by the environment.
+ *  @return CU_FALSE if the environment variables are set but invalid
+ *          (the shard is then 0 of 1).
+ */
+static CU_BOOL resolve_shard(unsigned int* puiIndex, unsigned int* puiTotal, CU_BOOL* pbFromEnv)
+{
+  const char* szTotal;
+  unsigned int uiIndex;
+  unsigned int uiTotal;
+
+  *pbFromEnv = CU_FALSE;
+  if (0 != f_uiShardTotal) {
+    *puiIndex = f_uiShardIndex;
+    *puiTotal = f_uiShardTotal;
+    return CU_TRUE;
+  }
+
+  *puiIndex = 0;
+  *puiTotal = 1;
+  szTotal = getenv(CU_SHARD_TOTAL_ENV);
+  if ((NULL == szTotal) || ('\0' == szTotal[0])) {
+    return CU_TRUE;
+  }
+
+  *pbFromEnv = CU_TRUE;
+  if ((CU_FALSE == parse_count(szTotal, &uiTotal)) || (0 == uiTotal) ||
+      (CU_FALSE == parse_count(getenv(CU_SHARD_INDEX_ENV), &uiIndex)) || (uiIndex >= uiTotal)) {
+    return CU_FALSE;
+  }
+  *puiIndex = uiIndex;
+  *puiTotal = uiTotal;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Creates the file named by TEST_SHARD_STATUS_FILE, if set.  A file
+ *  which cannot be created only means the runner will not learn that
+ *  sharding is supported, so errors are ignored.
+ */
+static void touch_status_file(void)
+{
+  const char* szStatusFile = getenv(CU_SHARD_STATUS_FILE_ENV);
+  FILE* pFile;
+
+  if ((NULL != szStatusFile) && ('\0' != szStatusFile[0]) &&
+      (NULL != (pFile = fopen(szStatusFile, "a")))) {
+    fclose(pFile);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Sets the fInShard flags of all suites and tests of a registry. */
+static void mark_all(CU_pTestRegistry pRegistry, CU_BOOL bInShard)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  for (pSuite = pRegistry->pSuite ; NULL != pSuite ; pSuite = pSuite->pNext) {
+    pSuite->fInShard = bInShard;
+    for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+      pTest->fInShard = bInShard;
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a name to the timing file, escaping '%', tabs and line ends. */
+static void write_name(FILE* pFile, const char* szName)
+{
+  const unsigned char* pPos;
+
+  for (pPos = (const unsigned char*)szName ; '\0' != *pPos ; ++pPos) {
+    if (('%' == *pPos) || ('\t' == *pPos) || ('\n' == *pPos) || ('\r' == *pPos)) {
+      fprintf(pFile, "%%%02X", (unsigned int)*pPos);
+    }
+    else {
+      fputc(*pPos, pFile);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Converts a hexadecimal digit.
+ *  @return The value, or -1 if c is not a hexadecimal digit.
+ */
+static int hex_value(char c)
+{
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  }
+  if ((c >= 'A') && (c <= 'F')) {
+    return c - 'A' + 10;
+  }
+  if ((c >= 'a') && (c <= 'f')) {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes the %XX escapes of a name in place.
+ *  @return CU_FALSE if the name holds a malformed escape.
+ */
+static CU_BOOL decode_name(char* szName)
+{
+  char* pIn = szName;
+  char* pOut = szName;
+  int iHigh;
+  int iLow;
+
+  while ('\0' != *pIn) {
+    if ('%' == *pIn) {
+      if ((0 > (iHigh = hex_value(pIn[1]))) || (0 > (iLow = hex_value(pIn[2])))) {
+        return CU_FALSE;
+      }
+      *pOut++ = (char)((iHigh << 4) | iLow);
+      pIn += 3;
+    }
+    else {
+      *pOut++ = *pIn++;
+    }
+  }
+  *pOut = '\0';
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Looks up the slot of a test in a timing table: the slot holding it,
+ *  or the free slot where it belongs.
+ */
+static unsigned int find_slot(const TimingTable* pTable, const char* szSuite, const char* szTest)
+{
+  unsigned int uiSlot = hash_names(szSuite, szTest) & (pTable->nSlots - 1);
+  const TimingEntry* pEntry;
+
+  while (0 != pTable->pSlots[uiSlot]) {
+    pEntry = &pTable->pEntries[pTable->pSlots[uiSlot] - 1];
+    if ((0 == strcmp(pEntry->szSuite, szSuite)) && (0 == strcmp(pEntry->szTest, szTest))) {
+      break;
+    }
+    uiSlot = (uiSlot + 1) & (pTable->nSlots - 1);
+  }
+  return uiSlot;
+}
+
+/*------------------------------------------------------------------------*/
+/** Frees the contents of a timing table. */
+static void free_timings(TimingTable* pTable)
+{
+  if (NULL != pTable->pText) {
+    CU_FREE(pTable->pText);
+  }
+  if (NULL != pTable->pEntries) {
+    CU_FREE(pTable->pEntries);
+  }
+  if (NULL != pTable->pSlots) {
+    CU_FREE(pTable->pSlots);
+  }
+  pTable->pText = NULL;
+  pTable->pEntries = NULL;
+  pTable->pSlots = NULL;
+  pTable->nEntries = 0;
+  pTable->nSlots = 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads the timing file into a table.  A missing file leaves the
+ *  table empty, and malformed lines are skipped.
+ *  @return CU_FALSE if out of memory.
+ */
+static CU_BOOL read_timings(TimingTable* pTable)
+{
+  FILE* pFile;
+  size_t szLength = 0;
+  size_t szCapacity = 0;
+  size_t szRead;
+  unsigned int nLines = 0;
+  unsigned int uiSlot;
+  char* pText;
+  char* pPos;
+  char* pLineEnd;
+  char* pSuite;
+  char* pTest;
+  char* pEnd;
+  double dDuration;
+  TimingEntry* pEntry;
+
+  pTable->pText = NULL;
+  pTable->pEntries = NULL;
+  pTable->nEntries = 0;
+  pTable->pSlots = NULL;
+  pTable->nSlots = 0;
+
+  if ((NULL == f_szTimingFile) || (NULL == (pFile = fopen(f_szTimingFile, "r")))) {
+    return CU_TRUE;
+  }
+  do {
+    if (szCapacity - szLength < READ_CHUNK + 1) {
+      szCapacity = (0 != szCapacity) ? 2 * szCapacity : 2 * READ_CHUNK;
+      pText = (NULL != pTable->pText) ? (char*)CU_REALLOC(pTable->pText, szCapacity)
+                                      : (char*)CU_MALLOC(szCapacity);
+      if (NULL == pText) {
+        fclose(pFile);
+        free_timings(pTable);
+        return CU_FALSE;
+      }
+      pTable->pText = pText;
+    }
+    szRead = fread(pTable->pText + szLength, 1, READ_CHUNK, pFile);
+    szLength += szRead;
+  } while (READ_CHUNK == szRead);
+  fclose(pFile);
+  pTable->pText[szLength] = '\0';
+
+  for (pPos = pTable->pText ; '\0' != *pPos ; ++pPos) {
+    if ('\n' == *pPos) {
+      ++nLines;
+    }
+  }
+  ++nLines;   /* last line without line end */
+  pTable->nSlots = 16;
+  while (pTable->nSlots < 2 * nLines) {
+    pTable->nSlots *= 2;
+  }
+  pTable->pEntries = (TimingEntry*)CU_MALLOC(nLines * sizeof(TimingEntry));
+  pTable->pSlots = (unsigned int*)CU_CALLOC(pTable->nSlots, sizeof(unsigned int));
+  if ((NULL == pTable->pEntries) || (NULL == pTable->pSlots)) {
+    free_timings(pTable);
+    return CU_FALSE;
+  }
+
+  for (pPos = pTable->pText ; '\0' != *pPos ; pPos = pLineEnd) {
+    pLineEnd = pPos + strcspn(pPos, "\n");
+    if ('\0' != *pLineEnd) {
+      *pLineEnd++ = '\0';
+    }
+    if ((NULL == (pSuite = strchr(pPos, '\t'))) || (NULL == (pTest = strchr(pSuite + 1, '\t')))) {
+      continue;
+    }
+    *pSuite++ = '\0';
+    *pTest++ = '\0';
+    dDuration = strtod(pPos, &pEnd);
+    if ((pEnd == pPos) || ('\0' != *pEnd) || !(dDuration >= 0.0) ||
+        (CU_FALSE == decode_name(pSuite)) || (CU_FALSE == decode_name(pTest))) {
+      continue;
+    }
+
+    /* a test listed twice takes its last duration */
+    uiSlot = find_slot(pTable, pSuite, pTest);
+    if (0 != pTable->pSlots[uiSlot]) {
+      pTable->pEntries[pTable->pSlots[uiSlot] - 1].dDuration = dDuration;
+    }
+    else {
+      pEntry = &pTable->pEntries[pTable->nEntries];
+      pEntry->szSuite = pSuite;
+      pEntry->szTest = pTest;
+      pEntry->dDuration = dDuration;
+      pTable->pSlots[uiSlot] = ++pTable->nEntries;
+    }
+  }
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Orders shard items by decreasing cost, then by registry position. */
+static int compare_items(const void* pLeft, const void* pRight)
+{
+  const ShardItem* pA = (const ShardItem*)pLeft;
+  const ShardItem* pB = (const ShardItem*)pRight;
+
+  if (pA->dCost != pB->dCost) {
+    return (pA->dCost > pB->dCost) ? -1 : 1;
+  }
+  return (pA->uiOrder < pB->uiOrder) ? -1 : ((pA->uiOrder > pB->uiOrder) ? 1 : 0);
+}
+
+/*------------------------------------------------------------------------*/
+/** Checks whether shard uiA has less work than shard uiB, or as much
+ *  and a lower index.
+ */
+static CU_BOOL shard_before(const double* pLoads, unsigned int uiA, unsigned int uiB)
+{
+  if (pLoads[uiA] != pLoads[uiB]) {
+    return (pLoads[uiA] < pLoads[uiB]) ? CU_TRUE : CU_FALSE;
+  }
+  return (uiA < uiB) ? CU_TRUE : CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Packs the active tests of the active suites of a registry into the
+ *  shards by their durations in the timing file, and sets their
+ *  fInShard flags.
+ *  @return CU_FALSE if out of memory.
+ */
+static CU_BOOL pack_tests(CU_pTestRegistry pRegistry, unsigned int uiIndex, unsigned int uiTotal)
+{
+  TimingTable timings;
+  ShardItem* pItems = NULL;
+  double* pLoads = NULL;
+  unsigned int* pHeap = NULL;
+  unsigned int nItems = 0;
+  unsigned int nFound = 0;
+  unsigned int uiItem;
+  unsigned int uiSlot;
+  unsigned int uiPos;
+  unsigned int uiChild;
+  unsigned int uiShard;
+  double dKnown = 0.0;
+  double dDefault;
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+  CU_BOOL bResult = CU_FALSE;
+
+  for (pSuite = pRegistry->pSuite ; NULL != pSuite ; pSuite = pSuite->pNext) {
+    if (CU_FALSE != pSuite->fActive) {
+      for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+        if (CU_FALSE != pTest->fActive) {
+          ++nItems;
+        }
+      }
+    }
+  }
+  if (0 == nItems) {
+    return CU_TRUE;
+  }
+
+  if (CU_FALSE == read_timings(&timings)) {
+    return CU_FALSE;
+  }
+  pItems = (ShardItem*)CU_MALLOC(nItems * sizeof(ShardItem));
+  pLoads = (double*)CU_MALLOC(uiTotal * sizeof(double));
+  pHeap = (unsigned int*)CU_MALLOC(uiTotal * sizeof(unsigned int));
+  if ((NULL == pItems) || (NULL == pLoads) || (NULL == pHeap)) {
+    goto cleanup;
+  }
+
+  /* costs from the timing file, the mean of those found for the others */
+  nItems = 0;
+  for (pSuite = pRegistry->pSuite ; NULL != pSuite ; pSuite = pSuite->pNext) {
+    if (CU_FALSE != pSuite->fActive) {
+      for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+        if (CU_FALSE != pTest->fActive) {
+          pItems[nItems].pTest = pTest;
+          pItems[nItems].uiOrder = nItems;
+          pItems[nItems].dCost = -1.0;
+          if (0 < timings.nEntries) {
+            uiSlot = find_slot(&timings, pSuite->pName, pTest->pName);
+            if (0 != timings.pSlots[uiSlot]) {
+              pItems[nItems].dCost = timings.pEntries[timings.pSlots[uiSlot] - 1].dDuration;
+              dKnown += pItems[nItems].dCost;
+              ++nFound;
+            }
+          }
+          ++nItems;
+        }
+      }
+    }
+  }
+  dDefault = (0 < nFound) ? dKnown / nFound : CU_SHARD_DEFAULT_COST;
+  for (uiItem = 0 ; uiItem < nItems ; ++uiItem) {
+    if (0.0 > pItems[uiItem].dCost) {
+      pItems[uiItem].dCost = dDefault;
+    }
+  }
+  qsort(pItems, nItems, sizeof(ShardItem), compare_items);
+
+  /* longest first, each into the shard with the least work */
+  for (uiShard = 0 ; uiShard < uiTotal ; ++uiShard) {
+    pLoads[uiShard] = 0.0;
+    pHeap[uiShard] = uiShard;   /* all loads equal: ordered by index */
+  }
+  for (uiItem = 0 ; uiItem < nItems ; ++uiItem) {
+    uiShard = pHeap[0];
+    pItems[uiItem].pTest->fInShard = (uiShard == uiIndex) ? CU_TRUE : CU_FALSE;
+    pLoads[uiShard] += pItems[uiItem].dCost;
+
+    for (uiPos = 0 ; (uiChild = 2 * uiPos + 1) < uiTotal ; uiPos = uiChild) {
+      if ((uiChild + 1 < uiTotal) &&
+          (CU_FALSE != shard_before(pLoads, pHeap[uiChild + 1], pHeap[uiChild]))) {
+        ++uiChild;
+      }
+      if (CU_FALSE != shard_before(pLoads, uiShard, pHeap[uiChild])) {
+        break;
+      }
+      pHeap[uiPos] = pHeap[uiChild];
+    }
+    pHeap[uiPos] = uiShard;
+  }
+  bResult = CU_TRUE;
+
+cleanup:
+  free_timings(&timings);
+  if (NULL != pItems) {
+    CU_FREE(pItems);
+  }
+  if (NULL != pLoads) {
+    CU_FREE(pLoads);
+  }
+  if (NULL != pHeap) {
+    CU_FREE(pHeap);
+  }
+  return bResult;
+}
+
+/*------------------------------------------------------------------------*/
+/** Frees the list of tests run. */
+static void clear_tests_run(void)
+{
+  if (NULL != f_pRan) {
+    CU_FREE(f_pRan);
+  }
+  f_pRan = NULL;
+  f_nRan = 0;
+  f_nRanCapacity = 0;
+}
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_ErrorCode CU_set_shard(unsigned int uiIndex, unsigned int uiTotal)
+{
+  CU_ErrorCode error = CUE_SUCCESS;
+
+  if ((0 != uiTotal) && (uiIndex >= uiTotal)) {
+    error = CUE_BAD_SHARD;
+  }
+  else {
+    f_uiShardIndex = (0 != uiTotal) ? uiIndex : 0;
+    f_uiShardTotal = uiTotal;
+  }
+
+  CU_set_error(error);
+  return error;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_shard_index(void)
+{
+  unsigned int uiIndex;
+  unsigned int uiTotal;
+  CU_BOOL bFromEnv;
+
+  resolve_shard(&uiIndex, &uiTotal, &bFromEnv);
+  return uiIndex;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_shard_total(void)
+{
+  unsigned int uiIndex;
+  unsigned int uiTotal;
+  CU_BOOL bFromEnv;
+
+  resolve_shard(&uiIndex, &uiTotal, &bFromEnv);
+  return uiTotal;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Replaces the file name held in *pszTarget by a copy of szFilename
+ *  (NULL for none), and sets the error code.
+ */
+static CU_ErrorCode set_filename(char** pszTarget, const char* szFilename)
+{
+  CU_ErrorCode error = CUE_SUCCESS;
+  char* szCopy = NULL;
+
+  if (NULL != szFilename) {
+    if (('\0' == szFilename[0]) || (MAX_TIMING_FILENAME < strlen(szFilename))) {
+      error = CUE_BAD_FILENAME;
+    }
+    else if (NULL == (szCopy = (char*)CU_MALLOC(strlen(szFilename) + 1))) {
+      error = CUE_NOMEMORY;
+    }
+    else {
+      strcpy(szCopy, szFilename);
+    }
+  }
+
+  if (CUE_SUCCESS == error) {
+    if (NULL != *pszTarget) {
+      CU_FREE(*pszTarget);
+    }
+    *pszTarget = szCopy;
+  }
+
+  CU_set_error(error);
+  return error;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_shard_timing_file(const char* szFilename)
+{
+  return set_filename(&f_szTimingFile, szFilename);
+}
+
+/*------------------------------------------------------------------------*/
+const char* CU_get_shard_timing_file(void)
+{
+  return f_szTimingFile;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_shard_timing_output(const char* szFilename)
+{
+  return set_filename(&f_szTimingOutput, szFilename);
+}
+
+/*------------------------------------------------------------------------*/
+const char* CU_get_shard_timing_output(void)
+{
+  return f_szTimingOutput;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_shard_begin_run(CU_pTestRegistry pRegistry, CU_BOOL bSharded)
+{
+  unsigned int uiIndex;
+  unsigned int uiTotal;
+  CU_BOOL bFromEnv;
+  CU_BOOL bInShard;
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  clear_tests_run();
+  f_bRecording = CU_FALSE;
+
+  if (NULL == pRegistry) {
+    return CUE_SUCCESS;
+  }
+  if (CU_FALSE == bSharded) {
+    mark_all(pRegistry, CU_TRUE);
+    return CUE_SUCCESS;
+  }
+
+  if (CU_FALSE == resolve_shard(&uiIndex, &uiTotal, &bFromEnv)) {
+    touch_status_file();
+    mark_all(pRegistry, CU_FALSE);
+    return CUE_BAD_SHARD;
+  }
+  if (CU_FALSE != bFromEnv) {
+    touch_status_file();
+  }
+  f_bRecording = CU_TRUE;
+
+  if (1 == uiTotal) {
+    mark_all(pRegistry, CU_TRUE);
+    return CUE_SUCCESS;
+  }
+
+  /* hashed: inactive and empty suites whole, inactive tests, and all tests without timings */
+  for (pSuite = pRegistry->pSuite ; NULL != pSuite ; pSuite = pSuite->pNext) {
+    if ((CU_FALSE == pSuite->fActive) || (NULL == pSuite->pTest)) {
+      bInShard = (uiIndex == hash_names(pSuite->pName, NULL) % uiTotal) ? CU_TRUE : CU_FALSE;
+      pSuite->fInShard = bInShard;
+      for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+        pTest->fInShard = bInShard;
+      }
+    }
+    else {
+      for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+        if ((CU_FALSE == pTest->fActive) || (NULL == f_szTimingFile)) {
+          pTest->fInShard = (uiIndex == hash_names(pSuite->pName, pTest->pName) % uiTotal) ? CU_TRUE : CU_FALSE;
+        }
+      }
+    }
+  }
+
+  /* packed by duration: active tests of active suites */
+  if ((NULL != f_szTimingFile) && (CU_FALSE == pack_tests(pRegistry, uiIndex, uiTotal))) {
+    mark_all(pRegistry, CU_FALSE);
+    f_bRecording = CU_FALSE;
+    return CUE_NOMEMORY;
+  }
+
+  /* an active suite runs where its tests run */
+  for (pSuite = pRegistry->pSuite ; NULL != pSuite ; pSuite = pSuite->pNext) {
+    if ((CU_FALSE != pSuite->fActive) && (NULL != pSuite->pTest)) {
+      pSuite->fInShard = CU_FALSE;
+      for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+        if (CU_FALSE != pTest->fInShard) {
+          pSuite->fInShard = CU_TRUE;
+          break;
+        }
+      }
+    }
+  }
+  return CUE_SUCCESS;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_shard_test_ran(CU_pSuite pSuite, CU_pTest pTest)
+{
+  ShardRun* pRan;
+  size_t nCapacity;
+
+  assert(NULL != pSuite);
+  assert(NULL != pTest);
+
+  if ((CU_FALSE == f_bRecording) || (NULL == f_szTimingOutput)) {
+    return;
+  }
+  if (f_nRan == f_nRanCapacity) {
+    nCapacity = (0 != f_nRanCapacity) ? 2 * f_nRanCapacity : 64;
+    /* a test missing from the timing file only counts with the mean duration */
+    pRan = (NULL != f_pRan) ? (ShardRun*)CU_REALLOC(f_pRan, nCapacity * sizeof(ShardRun))
+                            : (ShardRun*)CU_MALLOC(nCapacity * sizeof(ShardRun));
+    if (NULL == pRan) {
+      return;
+    }
+    f_pRan = pRan;
+    f_nRanCapacity = nCapacity;
+  }
+  f_pRan[f_nRan].pSuite = pSuite;
+  f_pRan[f_nRan].pTest = pTest;
+  ++f_nRan;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_shard_end_run(void)
+{
+  CU_ErrorCode error = CUE_SUCCESS;
+  FILE* pFile;
+  size_t uiRan;
+
+  if ((CU_FALSE != f_bRecording) && (NULL != f_szTimingOutput)) {
+    /* the timing file is only read, the next run may need it unchanged */
+    if ((NULL != f_szTimingFile) && (0 == strcmp(f_szTimingFile, f_szTimingOutput))) {
+      error = CUE_BAD_FILENAME;
+    }
+    else if (NULL == (pFile = fopen(f_szTimingOutput, "w"))) {
+      error = CUE_FOPEN_FAILED;
+    }
+    else {
+      for (uiRan = 0 ; uiRan < f_nRan ; ++uiRan) {
+        fprintf(pFile, "%.6f\t", f_pRan[uiRan].pTest->dDuration);
+        write_name(pFile, f_pRan[uiRan].pSuite->pName);
+        fputc('\t', pFile);
+        write_name(pFile, f_pRan[uiRan].pTest->pName);
+        fputc('\n', pFile);
+      }
+      if (0 != ferror(pFile)) {
+        error = CUE_WRITE_ERROR;
+      }
+      if ((0 != fclose(pFile)) && (CUE_SUCCESS == error)) {
+        error = CUE_WRITE_ERROR;
+      }
+    }
+  }
+
+  f_bRecording = CU_FALSE;
+  clear_tests_run();
+  return error;
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+static int f_iShardRuns = 0;    /**< Test function calls. */
+static CU_BOOL f_bFailOnInactive = CU_TRUE; /**< Setting restored by cleanup_shard_tests(). */
+
+static void shard_test(void)
+{
+  ++f_iShardRuns;
+}
+
+/** Registers 3 suites of 10 tests named s<i>/t<j>, the last suite inactive. */
+static void register_shard_tests(void)
+{
+  char szName[16];
+  CU_pSuite pSuite;
+  int i;
+  int j;
+
+  CU_initialize_registry();
+  for (i = 0 ; i < 3 ; ++i) {
+    sprintf(szName, "s%d", i);
+    pSuite = CU_add_suite(szName, NULL, NULL);
+    for (j = 0 ; j < 10 ; ++j) {
+      sprintf(szName, "t%d", j);
+      CU_add_test(pSuite, szName, shard_test);
+    }
+  }
+  CU_set_suite_active(CU_get_suite("s2"), CU_FALSE);
+
+  /* runs succeed whether or not the shard holds the inactive suite */
+  f_bFailOnInactive = CU_get_fail_on_inactive();
+  CU_set_fail_on_inactive(CU_FALSE);
+}
+
+/** Releases the registry of register_shard_tests(). */
+static void cleanup_shard_tests(void)
+{
+  CU_set_fail_on_inactive(f_bFailOnInactive);
+  CU_cleanup_registry();
+}
+
+/** Counts the tests and suites of the registry in the current shard. */
+static void count_in_shard(unsigned int* pnTests, unsigned int* pnSuites)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  *pnTests = 0;
+  *pnSuites = 0;
+  for (pSuite = CU_get_registry()->pSuite ; NULL != pSuite ; pSuite = pSuite->pNext) {
+    if (CU_FALSE != pSuite->fInShard) {
+      ++*pnSuites;
+    }
+    for (pTest = pSuite->pTest ; NULL != pTest ; pTest = pTest->pNext) {
+      if (CU_FALSE != pTest->fInShard) {
+        ++*pnTests;
+        TEST(CU_FALSE != pSuite->fInShard);
+      }
+    }
+  }
+}
+
+static void test_CU_set_shard(void)
+{
+  TEST(CUE_SUCCESS == CU_set_shard(0, 0));
+  TEST(1 == CU_get_shard_total());
+  TEST(0 == CU_get_shard_index());
+
+  TEST(CUE_SUCCESS == CU_set_shard(3, 4));
+  TEST(4 == CU_get_shard_total());
+  TEST(3 == CU_get_shard_index());
+
+  TEST(CUE_BAD_SHARD == CU_set_shard(4, 4));
+  TEST(CUE_BAD_SHARD == CU_get_error());
+  TEST(4 == CU_get_shard_total());
+  TEST(3 == CU_get_shard_index());
+
+  TEST(CUE_SUCCESS == CU_set_shard(7, 0));
+  TEST(1 == CU_get_shard_total());
+  TEST(0 == CU_get_shard_index());
+
+  TEST(NULL == CU_get_shard_timing_file());
+  TEST(CUE_BAD_FILENAME == CU_set_shard_timing_file(""));
+  TEST(CUE_SUCCESS == CU_set_shard_timing_file("timings.txt"));
+  TEST(0 == strcmp("timings.txt", CU_get_shard_timing_file()));
+  TEST(CUE_SUCCESS == CU_set_shard_timing_file(NULL));
+  TEST(NULL == CU_get_shard_timing_file());
+
+  TEST(NULL == CU_get_shard_timing_output());
+  TEST(CUE_BAD_FILENAME == CU_set_shard_timing_output(""));
+  TEST(CUE_SUCCESS == CU_set_shard_timing_output("timings.out"));
+  TEST(0 == strcmp("timings.out", CU_get_shard_timing_output()));
+  TEST(CUE_SUCCESS == CU_set_shard_timing_output(NULL));
+  TEST(NULL == CU_get_shard_timing_output());
+}
+
+static void test_hashed_shards(void)
+{
+  unsigned int uiShard;
+  unsigned int nTests;
+  unsigned int nSuites;
+  unsigned int nAllTests = 0;
+  unsigned int nAllSuites = 0;
+  unsigned int nRun = 0;
+  unsigned int nInactive = 0;
+  CU_BOOL bFirst[3];
+
+  register_shard_tests();
+
+  /* every test in exactly one shard, every shard run on its own */
+  for (uiShard = 0 ; uiShard < 3 ; ++uiShard) {
+    TEST(CUE_SUCCESS == CU_set_shard(uiShard, 3));
+    f_iShardRuns = 0;
+    TEST(CUE_SUCCESS == CU_run_all_tests());
+    count_in_shard(&nTests, &nSuites);
+    nAllTests += nTests;
+    nAllSuites += nSuites;
+    nRun += CU_get_number_of_tests_run();
+    nInactive += CU_get_run_summary()->nSuitesInactive;
+    TEST(f_iShardRuns == (int)CU_get_number_of_tests_run());
+    TEST(30 == CU_get_registry()->uiNumberOfTests);
+    bFirst[uiShard] = CU_get_registry()->pSuite->pTest->fInShard;
+  }
+  TEST(30 == nAllTests);
+  TEST(20 == nRun);
+  TEST(1 == nInactive);                   /* inactive suite reported by one shard */
+  TEST(nAllSuites >= 3);
+  TEST(1 == bFirst[0] + bFirst[1] + bFirst[2]);
+
+  /* the partition does not depend on the other tests */
+  TEST(CUE_SUCCESS == CU_set_shard(0, 3));
+  TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_TRUE));
+  bFirst[0] = CU_get_registry()->pSuite->pTest->fInShard;
+  CU_add_test(CU_get_suite("s0"), "t10", shard_test);
+  CU_add_suite("s3", NULL, NULL);
+  TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_TRUE));
+  TEST(bFirst[0] == CU_get_registry()->pSuite->pTest->fInShard);
+  TEST(CUE_SUCCESS == CU_shard_end_run());
+
+  /* CU_run_test() ignores sharding */
+  TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_FALSE));
+  count_in_shard(&nTests, &nSuites);
+  TEST(31 == nTests);
+  TEST(4 == nSuites);
+
+  CU_set_shard(0, 0);
+  cleanup_shard_tests();
+}
+
+static void test_packed_shards(void)
+{
+  static const char szTimingFile[] = "test_cunit_shard_timings.txt";
+  static const char szTimingOutput[] = "test_cunit_shard_timings.out";
+  FILE* pFile;
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+  unsigned int uiShard;
+  unsigned int nTests;
+  unsigned int nSuites;
+  unsigned int nAllTests = 0;
+  char szLine[64];
+  int nLines = 0;
+  int i;
+
+  register_shard_tests();
+
+  /* s0/t0 alone takes as long as all other active tests together */
+  pFile = fopen(szTimingFile, "w");
+  TEST_FATAL(NULL != pFile);
+  fputs("garbage line\n"
+        "-1\ts0\tt0\n"
+        "0.5\ts0\tt%ZZ\n"
+        "1\ts0\tt0\n", pFile);
+  for (i = 1 ; i < 20 ; ++i) {
+    fprintf(pFile, "0.5\ts%d\tt%d\n", i / 10, i % 10);
+  }
+  fputs("9.5\ts0\tt0", pFile);      /* last duration counts, no line end */
+  fclose(pFile);
+  TEST(CUE_SUCCESS == CU_set_shard_timing_file(szTimingFile));
+
+  TEST(CUE_SUCCESS == CU_set_shard(0, 2));
+  TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_TRUE));
+  count_in_shard(&nTests, &nSuites);
+  pSuite = CU_get_suite("s0");
+  TEST(CU_FALSE != pSuite->pTest->fInShard);
+  for (nAllTests = 0, pTest = pSuite->pTest->pNext ; NULL != pTest ; pTest = pTest->pNext) {
+    nAllTests += (CU_FALSE != pTest->fInShard) ? 1 : 0;
+  }
+  TEST(0 == nAllTests);                   /* the other active tests go to shard 1 */
+
+  /* shards together run all tests once, and write their timings */
+  nAllTests = 0;
+  for (uiShard = 0 ; uiShard < 2 ; ++uiShard) {
+    TEST(CUE_SUCCESS == CU_set_shard(uiShard, 2));
+    TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_TRUE));
+    count_in_shard(&nTests, &nSuites);
+    nAllTests += nTests;
+  }
+  TEST(30 == nAllTests);
+
+  TEST(CUE_SUCCESS == CU_set_shard_timing_output(szTimingOutput));
+  TEST(CUE_SUCCESS == CU_set_shard(1, 2));
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  TEST(19 == CU_get_number_of_tests_run());
+  pFile = fopen(szTimingOutput, "r");
+  TEST_FATAL(NULL != pFile);
+  while (NULL != fgets(szLine, sizeof(szLine), pFile)) {
+    ++nLines;
+    TEST(NULL == strstr(szLine, "\ts0\tt0\n"));
+  }
+  fclose(pFile);
+  TEST(19 == nLines);
+
+  /* the timing file itself is left alone */
+  pFile = fopen(szTimingFile, "r");
+  TEST_FATAL(NULL != pFile);
+  TEST(NULL != fgets(szLine, sizeof(szLine), pFile));
+  TEST(0 == strcmp("garbage line\n", szLine));
+  for (nLines = 1 ; NULL != fgets(szLine, sizeof(szLine), pFile) ; ++nLines)
+    ;
+  fclose(pFile);
+  TEST(24 == nLines);
+  TEST(0 == strcmp("9.5\ts0\tt0", szLine));
+
+  /* and is never written over */
+  TEST(CUE_SUCCESS == CU_set_shard_timing_output(szTimingFile));
+  TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_TRUE));
+  TEST(CUE_BAD_FILENAME == CU_shard_end_run());
+  pFile = fopen(szTimingFile, "r");
+  TEST_FATAL(NULL != pFile);
+  TEST(NULL != fgets(szLine, sizeof(szLine), pFile));
+  TEST(0 == strcmp("garbage line\n", szLine));
+  fclose(pFile);
+  TEST(CUE_SUCCESS == CU_set_shard_timing_output(szTimingOutput));
+
+  /* a missing file packs tests as if of equal duration */
+  remove(szTimingFile);
+  TEST(CUE_SUCCESS == CU_set_shard(0, 2));
+  TEST(CUE_SUCCESS == CU_shard_begin_run(CU_get_registry(), CU_TRUE));
+  count_in_shard(&nTests, &nSuites);
+  TEST(10 == nTests - (CU_FALSE != CU_get_suite("s2")->fInShard ? 10 : 0));
+  CU_shard_end_run();
+  remove(szTimingOutput);
+
+  CU_set_shard_timing_file(NULL);
+  CU_set_shard_timing_output(NULL);
+  CU_set_shard(0, 0);
+  cleanup_shard_tests();
+}
+
+#ifndef _WIN32
+static void test_shard_environment(void)
+{
+  static const char szStatusFile[] = "test_cunit_shard_status";
+  unsigned int nTests;
+  unsigned int nSuites;
+  FILE* pFile;
+
+  register_shard_tests();
+  remove(szStatusFile);
+
+  setenv(CU_SHARD_TOTAL_ENV, "3", 1);
+  setenv(CU_SHARD_INDEX_ENV, "2", 1);
+  setenv(CU_SHARD_STATUS_FILE_ENV, szStatusFile, 1);
+  TEST(3 == CU_get_shard_total());
+  TEST(2 == CU_get_shard_index());
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  pFile = fopen(szStatusFile, "r");
+  TEST(NULL != pFile);
+  if (NULL != pFile) {
+    fclose(pFile);
+  }
+  remove(szStatusFile);
+
+  /* CU_set_shard() wins over the environment */
+  TEST(CUE_SUCCESS == CU_set_shard(0, 1));
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  TEST(20 == CU_get_number_of_tests_run());
+  pFile = fopen(szStatusFile, "r");
+  TEST(NULL == pFile);
+  if (NULL != pFile) {
+    fclose(pFile);
+  }
+  CU_set_shard(0, 0);
+
+  /* invalid settings run nothing */
+  setenv(CU_SHARD_INDEX_ENV, "3", 1);
+  TEST(1 == CU_get_shard_total());
+  TEST(CUE_BAD_SHARD == CU_run_all_tests());
+  TEST(0 == CU_get_number_of_tests_run());
+  count_in_shard(&nTests, &nSuites);
+  TEST(0 == nTests);
+  setenv(CU_SHARD_INDEX_ENV, "x", 1);
+  TEST(CUE_BAD_SHARD == CU_run_all_tests());
+  unsetenv(CU_SHARD_INDEX_ENV);
+  TEST(CUE_BAD_SHARD == CU_run_all_tests());
+  remove(szStatusFile);
+
+  unsetenv(CU_SHARD_TOTAL_ENV);
+  unsetenv(CU_SHARD_STATUS_FILE_ENV);
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  TEST(20 == CU_get_number_of_tests_run());
+
+  cleanup_shard_tests();
+}
+#endif
+
+void test_cunit_Shard(void)
+{
+  test_cunit_start_tests("Shard.c");
+
+  test_CU_set_shard();
+  test_hashed_shards();
+  test_packed_shards();
+#ifndef _WIN32
+  test_shard_environment();
+#endif
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
@@ -0,0 +1,571 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of soak tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Soak tests (implementation).
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L   /* sysconf(), opendir() under -std=c99 */
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __linux__
+#include <malloc.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "TestRun.h"
+#include "Util.h"
+#include "CUThread.h"
+#include "SoakTest.h"
+#include "CUnit_intl.h"
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+/** Samples collected during a soak test run. */
+typedef struct SoakSamples
+{
+  CU_pMutex     pMutex;         /**< Protects bStop. */
+  CU_pCond      pCond;          /**< Signalled when bStop is set. */
+  CU_BOOL       bStop;          /**< Set when the soak loop has finished. */
+  double        dInterval;      /**< Current interval between samples (s). */
+  double        dNext;          /**< Time the next sample is due. */
+  unsigned int  uiCount;        /**< Number of samples stored. */
+  double        adTime[2 * CU_SOAK_SAMPLES];                    /**< Sample times. */
+  double        aadValue[2 * CU_SOAK_SAMPLES][CU_SOAK_METRICS]; /**< Sample values. */
+  CU_BOOL       abAvailable[CU_SOAK_METRICS];                   /**< Metric availability. */
+} SoakSamples;
+
+/*=================================================================
+ *  Private functions
+ *=================================================================*/
+/** Reads a "Key: value" line from a /proc status file. */
+#ifdef __linux__
+static CU_BOOL read_proc_status(const char* szKey, double* pdValue)
+{
+  FILE* pFile;
+  char szLine[256];
+  size_t len = strlen(szKey);
+  CU_BOOL bFound = CU_FALSE;
+
+  if (NULL == (pFile = fopen("/proc/self/status", "r"))) {
+    return CU_FALSE;
+  }
+  while ((CU_FALSE == bFound) && (NULL != fgets(szLine, sizeof(szLine), pFile))) {
+    if ((0 == strncmp(szLine, szKey, len)) && (':' == szLine[len])) {
+      *pdValue = strtod(szLine + len + 1, NULL);
+      bFound = CU_TRUE;
+    }
+  }
+  fclose(pFile);
+  return bFound;
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+/** Appends a sample, halving the sample rate when the buffer is full. */
+static void record_sample(SoakSamples* pSamples, double dNow)
+{
+  unsigned int i;
+
+  if (pSamples->uiCount >= 2 * CU_SOAK_SAMPLES) {
+    for (i = 0 ; i < CU_SOAK_SAMPLES ; ++i) {
+      pSamples->adTime[i] = pSamples->adTime[2 * i];
+      memcpy(pSamples->aadValue[i], pSamples->aadValue[2 * i], sizeof(pSamples->aadValue[i]));
+    }
+    pSamples->uiCount = CU_SOAK_SAMPLES;
+    pSamples->dInterval *= 2.0;
+  }
+  pSamples->adTime[pSamples->uiCount] = dNow;
+  CU_sample_soak_metrics(pSamples->aadValue[pSamples->uiCount], pSamples->abAvailable);
+  ++pSamples->uiCount;
+  pSamples->dNext = dNow + pSamples->dInterval;
+}
+
+/*------------------------------------------------------------------------*/
+/** Sampler thread - samples at the current interval until stopped.
+ *  The final sample is also taken here so that the thread count is
+ *  consistent across the run.
+ */
+static void soak_sampler(void* pArg)
+{
+  SoakSamples* pSamples = (SoakSamples*)pArg;
+  double dWait;
+
+  CU_mutex_lock(pSamples->pMutex);
+  while (CU_FALSE == pSamples->bStop) {
+    dWait = pSamples->dNext - CU_get_monotonic_time();
+    if (dWait > 0.0) {
+      CU_cond_wait(pSamples->pCond, pSamples->pMutex, dWait);
+    }
+    else {
+      CU_mutex_unlock(pSamples->pMutex);
+      record_sample(pSamples, CU_get_monotonic_time());
+      CU_mutex_lock(pSamples->pMutex);
+    }
+  }
+  CU_mutex_unlock(pSamples->pMutex);
+  record_sample(pSamples, CU_get_monotonic_time());
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Fits a growth slope to one metric and decides whether it leaks.
+ *  The first 10% of samples are skipped as warm-up.  The series counts
+ *  as monotonic if it ends higher than it starts and at most 1 step in
+ *  10 goes down.
+ */
+static void analyze_metric(const double* pdTime,
+                           const double (*paadValue)[CU_SOAK_METRICS],
+                           unsigned int uiCount,
+                           CU_SoakMetric metric,
+                           double dThreshold,
+                           CU_SoakResult* pResult)
+{
+  unsigned int uiFirst = uiCount / 10;
+  unsigned int uiDown = 0;
+  unsigned int n = uiCount - uiFirst;
+  unsigned int i;
+  double dMeanT = 0.0;
+  double dMeanV = 0.0;
+  double dSxy = 0.0;
+  double dSxx = 0.0;
+
+  pResult->adSlope[metric] = 0.0;
+  pResult->adGrowth[metric] = 0.0;
+  pResult->abMonotonic[metric] = CU_FALSE;
+  pResult->abLeak[metric] = CU_FALSE;
+  if (0 == uiCount) {
+    pResult->adFirst[metric] = pResult->adLast[metric] = 0.0;
+    return;
+  }
+  pResult->adFirst[metric] = paadValue[uiFirst][metric];
+  pResult->adLast[metric] = paadValue[uiCount - 1][metric];
+  if (n < 3) {
+    return;
+  }
+
+  for (i = uiFirst ; i < uiCount ; ++i) {
+    dMeanT += pdTime[i];
+    dMeanV += paadValue[i][metric];
+    if ((i > uiFirst) && (paadValue[i][metric] < paadValue[i - 1][metric])) {
+      ++uiDown;
+    }
+  }
+  dMeanT /= (double)n;
+  dMeanV /= (double)n;
+  for (i = uiFirst ; i < uiCount ; ++i) {
+    dSxy += (pdTime[i] - dMeanT) * (paadValue[i][metric] - dMeanV);
+    dSxx += (pdTime[i] - dMeanT) * (pdTime[i] - dMeanT);
+  }
+  if (dSxx > 0.0) {
+    pResult->adSlope[metric] = dSxy / dSxx;
+    pResult->adGrowth[metric] = pResult->adSlope[metric] * (pdTime[uiCount - 1] - pdTime[uiFirst]);
+  }
+
+  pResult->abMonotonic[metric] =
+      ((pResult->adLast[metric] > pResult->adFirst[metric]) && (10 * uiDown <= n - 1)) ? CU_TRUE : CU_FALSE;
+  pResult->abLeak[metric] =
+      ((CU_FALSE != pResult->abMonotonic[metric]) && (dThreshold >= 0.0) &&
+       (pResult->adGrowth[metric] > dThreshold)) ? CU_TRUE : CU_FALSE;
+}
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_ErrorCode CU_set_soak_test(CU_pTest pTest, double dDuration)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+  CU_SoakTest* pSoak;
+
+  if (NULL == pTest) {
+    result = CUE_NOTEST;
+  }
+  else if (!(dDuration >= 0.0)) {
+    result = CUE_BAD_SOAK_PARAMS;
+  }
+  else if (0.0 == dDuration) {
+    if (NULL != pTest->pSoak) {
+      CU_FREE(pTest->pSoak);
+      pTest->pSoak = NULL;
+    }
+  }
+  else {
+    pSoak = pTest->pSoak;
+    if ((NULL == pSoak) && (NULL == (pSoak = (CU_SoakTest*)CU_MALLOC(sizeof(CU_SoakTest))))) {
+      result = CUE_NOMEMORY;
+    }
+    else {
+      memset(pSoak, 0, sizeof(CU_SoakTest));
+      pSoak->dDuration = dDuration;
+      pSoak->adThreshold[CU_SOAK_RSS] = CU_SOAK_DEFAULT_RSS_THRESHOLD;
+      pSoak->adThreshold[CU_SOAK_HEAP] = CU_SOAK_DEFAULT_HEAP_THRESHOLD;
+      pSoak->adThreshold[CU_SOAK_FDS] = CU_SOAK_DEFAULT_FDS_THRESHOLD;
+      pSoak->adThreshold[CU_SOAK_THREADS] = CU_SOAK_DEFAULT_THREADS_THRESHOLD;
+      pTest->pSoak = pSoak;
+    }
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_soak_threshold(CU_pTest pTest, CU_SoakMetric metric, double dThreshold)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if ((NULL == pTest) || (NULL == pTest->pSoak)) {
+    result = CUE_NOTEST;
+  }
+  else if (((int)metric < 0) || (metric >= CU_SOAK_METRICS)) {
+    result = CUE_BAD_SOAK_PARAMS;
+  }
+  else {
+    pTest->pSoak->adThreshold[metric] = dThreshold;
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_is_soak_test(CU_pTest pTest)
+{
+  return ((NULL != pTest) && (NULL != pTest->pSoak)) ? CU_TRUE : CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+const CU_SoakResult* CU_get_soak_result(CU_pTest pTest)
+{
+  return (CU_FALSE != CU_is_soak_test(pTest)) ? &pTest->pSoak->result : NULL;
+}
+
+/*------------------------------------------------------------------------*/
+const char* CU_get_soak_metric_name(CU_SoakMetric metric)
+{
+  switch (metric) {
+    case CU_SOAK_RSS:
+      return _("resident set size");
+    case CU_SOAK_HEAP:
+      return _("heap in use");
+    case CU_SOAK_FDS:
+      return _("open file descriptors");
+    case CU_SOAK_THREADS:
+      return _("threads");
+    default:
+      return _("unknown metric");
+  }
+}
+
+/*------------------------------------------------------------------------*/
+void CU_sample_soak_metrics(double adValues[CU_SOAK_METRICS],
+                            CU_BOOL abAvailable[CU_SOAK_METRICS])
+{
+#ifdef __linux__
+  FILE* pFile;
+  DIR* pDir;
+  struct dirent* pEntry;
+  unsigned long ulPages;
+  double dCount;
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+  struct mallinfo2 info;
+#elif defined(__GLIBC__)
+  struct mallinfo info;
+#endif
+#endif
+  int i;
+
+  for (i = 0 ; i < CU_SOAK_METRICS ; ++i) {
+    adValues[i] = 0.0;
+    abAvailable[i] = CU_FALSE;
+  }
+
+#ifdef __linux__
+  /* statm: size resident shared ... (in pages) */
+  if (NULL != (pFile = fopen("/proc/self/statm", "r"))) {
+    if (2 == fscanf(pFile, "%lu %lu", &ulPages, &ulPages)) {
+      adValues[CU_SOAK_RSS] = (double)ulPages * (double)sysconf(_SC_PAGESIZE);
+      abAvailable[CU_SOAK_RSS] = CU_TRUE;
+    }
+    fclose(pFile);
+  }
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+  info = mallinfo2();
+  adValues[CU_SOAK_HEAP] = (double)info.uordblks + (double)info.hblkhd;
+  abAvailable[CU_SOAK_HEAP] = CU_TRUE;
+#elif defined(__GLIBC__)
+  info = mallinfo();
+  adValues[CU_SOAK_HEAP] = (double)(unsigned int)info.uordblks + (double)(unsigned int)info.hblkhd;
+  abAvailable[CU_SOAK_HEAP] = CU_TRUE;
+#endif
+
+  if (NULL != (pDir = opendir("/proc/self/fd"))) {
+    dCount = 0.0;
+    while (NULL != (pEntry = readdir(pDir))) {
+      if ('.' != pEntry->d_name[0]) {
+        dCount += 1.0;
+      }
+    }
+    closedir(pDir);
+    adValues[CU_SOAK_FDS] = dCount - 1.0;   /* not the one opendir() holds */
+    abAvailable[CU_SOAK_FDS] = CU_TRUE;
+  }
+
+  if (CU_FALSE != read_proc_status("Threads", &dCount)) {
+    adValues[CU_SOAK_THREADS] = dCount;
+    abAvailable[CU_SOAK_THREADS] = CU_TRUE;
+  }
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_run_soak(CU_pTest pTest)
+{
+  SoakSamples* pSamples;
+  CU_pThread pThread = NULL;
+  CU_SoakTest* pSoak;
+  CU_SoakResult* pResult;
+  double dStart;
+  double dEnd;
+  double dNow;
+  int i;
+
+  assert(NULL != pTest);
+  assert(NULL != pTest->pSoak);
+  assert(NULL != pTest->pTestFunc);
+
+  pSoak = pTest->pSoak;
+  pResult = &pSoak->result;
+  memset(pResult, 0, sizeof(CU_SoakResult));
+
+  if (NULL == (pSamples = (SoakSamples*)CU_MALLOC(sizeof(SoakSamples)))) {
+    CU_set_error(CUE_NOMEMORY);
+    return CUE_NOMEMORY;
+  }
+  memset(pSamples, 0, sizeof(SoakSamples));
+  pSamples->dInterval = pSoak->dDuration / CU_SOAK_SAMPLES;
+  if (pSamples->dInterval < CU_SOAK_MIN_INTERVAL) {
+    pSamples->dInterval = CU_SOAK_MIN_INTERVAL;
+  }
+
+  dStart = CU_get_monotonic_time();
+  dEnd = dStart + pSoak->dDuration;
+  record_sample(pSamples, dStart);
+
+  /* without a sampler thread, sample between iterations */
+  pSamples->pMutex = CU_mutex_create();
+  pSamples->pCond = CU_cond_create();
+  if ((NULL != pSamples->pMutex) && (NULL != pSamples->pCond)) {
+    pThread = CU_thread_create(soak_sampler, pSamples);
+  }
+
+  do {
+    if (CU_FALSE == CU_run_test_function_concurrently(pTest->pTestFunc)) {
+      pResult->bAborted = CU_TRUE;
+    }
+    ++pResult->ulIterations;
+    dNow = CU_get_monotonic_time();
+    if ((NULL == pThread) && (dNow >= pSamples->dNext)) {
+      record_sample(pSamples, dNow);
+    }
+  } while ((CU_FALSE == pResult->bAborted) && (dNow < dEnd));
+
+  if (NULL != pThread) {
+    CU_mutex_lock(pSamples->pMutex);
+    pSamples->bStop = CU_TRUE;
+    CU_cond_broadcast(pSamples->pCond);
+    CU_mutex_unlock(pSamples->pMutex);
+    CU_thread_join(pThread);
+  }
+  else {
+    record_sample(pSamples, CU_get_monotonic_time());
+  }
+
+  pResult->dElapsedTime = pSamples->adTime[pSamples->uiCount - 1] - dStart;
+  pResult->uiSamples = pSamples->uiCount;
+  for (i = 0 ; i < CU_SOAK_METRICS ; ++i) {
+    pResult->abAvailable[i] = pSamples->abAvailable[i];
+    if (CU_FALSE != pSamples->abAvailable[i]) {
+      analyze_metric(pSamples->adTime, (const double (*)[CU_SOAK_METRICS])pSamples->aadValue,
+                     pSamples->uiCount, (CU_SoakMetric)i, pSoak->adThreshold[i], pResult);
+    }
+  }
+
+  CU_cond_destroy(pSamples->pCond);
+  CU_mutex_destroy(pSamples->pMutex);
+  CU_FREE(pSamples);
+  CU_set_error(CUE_SUCCESS);
+  return CUE_SUCCESS;
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+static void test_analyze_metric(void)
+{
+  double adTime[50];
+  double aadValue[50][CU_SOAK_METRICS];
+  CU_SoakResult result;
+  unsigned int i;
+
+  for (i = 0 ; i < 50 ; ++i) {
+    adTime[i] = 0.1 * i;
+    aadValue[i][CU_SOAK_RSS] = 1000.0 + 100.0 * i;                  /* steady leak: 1000/s */
+    aadValue[i][CU_SOAK_HEAP] = 1000.0 + ((0 == i % 2) ? 500.0 : 0.0); /* noise, no trend */
+    aadValue[i][CU_SOAK_FDS] = (i < 5) ? (double)i : 5.0;           /* growth in warm-up only */
+    aadValue[i][CU_SOAK_THREADS] = 1000.0 + 100.0 * i - ((0 == i % 3) ? 150.0 : 0.0); /* sawtooth */
+  }
+
+  memset(&result, 0, sizeof(result));
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 50, CU_SOAK_RSS, 1000.0, &result);
+  TEST(fabs(result.adSlope[CU_SOAK_RSS] - 1000.0) < 1.0e-6);
+  TEST(fabs(result.adGrowth[CU_SOAK_RSS] - 4400.0) < 1.0e-6);
+  TEST(1500.0 == result.adFirst[CU_SOAK_RSS]);
+  TEST(5900.0 == result.adLast[CU_SOAK_RSS]);
+  TEST(CU_FALSE != result.abMonotonic[CU_SOAK_RSS]);
+  TEST(CU_FALSE != result.abLeak[CU_SOAK_RSS]);
+
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 50, CU_SOAK_RSS, 5000.0, &result);
+  TEST(CU_FALSE != result.abMonotonic[CU_SOAK_RSS]);
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_RSS]);      /* below threshold */
+
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 50, CU_SOAK_RSS, -1.0, &result);
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_RSS]);      /* check disabled */
+
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 50, CU_SOAK_HEAP, 0.0, &result);
+  TEST(fabs(result.adSlope[CU_SOAK_HEAP]) < 100.0);
+  TEST(CU_FALSE == result.abMonotonic[CU_SOAK_HEAP]);
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_HEAP]);
+
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 50, CU_SOAK_FDS, 0.0, &result);
+  TEST(0.0 == result.adSlope[CU_SOAK_FDS]);
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_FDS]);
+
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 50, CU_SOAK_THREADS, 0.0, &result);
+  TEST(result.adSlope[CU_SOAK_THREADS] > 0.0);
+  TEST(CU_FALSE == result.abMonotonic[CU_SOAK_THREADS]);  /* every third step goes down */
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_THREADS]);
+
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 2, CU_SOAK_RSS, 0.0, &result);
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_RSS]);      /* too few samples */
+  analyze_metric(adTime, (const double (*)[CU_SOAK_METRICS])aadValue, 0, CU_SOAK_RSS, 0.0, &result);
+  TEST(CU_FALSE == result.abLeak[CU_SOAK_RSS]);
+}
+
+static void test_CU_sample_soak_metrics(void)
+{
+  double adValues[CU_SOAK_METRICS];
+  CU_BOOL abAvailable[CU_SOAK_METRICS];
+
+  CU_sample_soak_metrics(adValues, abAvailable);
+#ifdef __linux__
+  TEST(CU_FALSE != abAvailable[CU_SOAK_RSS]);
+  TEST(adValues[CU_SOAK_RSS] > 0.0);
+  TEST(CU_FALSE != abAvailable[CU_SOAK_FDS]);
+  TEST(adValues[CU_SOAK_FDS] >= 3.0);                  /* stdin, stdout, stderr */
+  TEST(CU_FALSE != abAvailable[CU_SOAK_THREADS]);
+  TEST(adValues[CU_SOAK_THREADS] >= 1.0);
+#ifdef __GLIBC__
+  TEST(CU_FALSE != abAvailable[CU_SOAK_HEAP]);
+#endif
+#endif
+  TEST(0 != strcmp(CU_get_soak_metric_name(CU_SOAK_HEAP), CU_get_soak_metric_name(CU_SOAK_RSS)));
+  TEST(0 == strcmp(CU_get_soak_metric_name(CU_SOAK_METRICS), "unknown metric"));
+}
+
+static void soak_test_func(void) { }
+
+static void test_CU_set_soak_test(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  pTest = CU_add_test(pSuite, "test1", soak_test_func);
+  TEST_FATAL(NULL != pTest);
+
+  TEST(CU_FALSE == CU_is_soak_test(pTest));
+  TEST(NULL == CU_get_soak_result(pTest));
+  TEST(CUE_NOTEST == CU_set_soak_threshold(pTest, CU_SOAK_HEAP, 1.0));
+
+  TEST(CUE_NOTEST == CU_set_soak_test(NULL, 1.0));
+  TEST(CUE_NOTEST == CU_get_error());
+  TEST(CUE_BAD_SOAK_PARAMS == CU_set_soak_test(pTest, -1.0));
+  TEST(CUE_BAD_SOAK_PARAMS == CU_get_error());
+  TEST(CU_FALSE == CU_is_soak_test(pTest));
+
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest, 2.0));
+  TEST(CU_FALSE != CU_is_soak_test(pTest));
+  TEST(NULL != CU_get_soak_result(pTest));
+  TEST(2.0 == pTest->pSoak->dDuration);
+  TEST(CU_SOAK_DEFAULT_HEAP_THRESHOLD == pTest->pSoak->adThreshold[CU_SOAK_HEAP]);
+
+  TEST(CUE_SUCCESS == CU_set_soak_threshold(pTest, CU_SOAK_HEAP, 10.0));
+  TEST(10.0 == pTest->pSoak->adThreshold[CU_SOAK_HEAP]);
+  TEST(CUE_BAD_SOAK_PARAMS == CU_set_soak_threshold(pTest, CU_SOAK_METRICS, 10.0));
+
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest, 3.0));  /* reselecting resets thresholds */
+  TEST(3.0 == pTest->pSoak->dDuration);
+  TEST(CU_SOAK_DEFAULT_HEAP_THRESHOLD == pTest->pSoak->adThreshold[CU_SOAK_HEAP]);
+
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest, 0.0));
+  TEST(CU_FALSE == CU_is_soak_test(pTest));
+  TEST(NULL == pTest->pSoak);
+
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest, 1.0));  /* freed by CU_cleanup_registry() */
+  CU_cleanup_registry();
+}
+
+void test_cunit_SoakTest(void)
+{
+  test_cunit_start_tests("SoakTest.c");
+
+  test_analyze_metric();
+  test_CU_sample_soak_metrics();
+  test_CU_set_soak_test();
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
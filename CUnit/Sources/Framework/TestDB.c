@@ -47,6 +47,16 @@
  *
  *  16-Avr-2007   Added setup and teardown functions. (CJN)
  *
+ *  18-Oct-2026   Added cached xml names of suites and tests. (AGT)
+ *
+ *  18-Oct-2026   Initialized timeout of new tests. (AGT)
+ *
+ *  18-Oct-2026   Added resource limits of tests. (AGT)
+ *
+ *  18-Oct-2026   Initialized fixture snapshots of new suites. (AGT)
+ *
+ *  18-Oct-2026   Initialized shard membership of new suites and tests. (AGT)
+ *
 */
 
 /** @file
@@ -87,6 +97,8 @@ static void      insert_test(CU_pSuite pSuite, CU_pTest pTest);
 
 static CU_BOOL   suite_exists(CU_pTestRegistry pRegistry, const char* szSuiteName);
 static CU_BOOL   test_exists(CU_pSuite pSuite, const char* szTestName);
+static const char* get_xml_name(const char* szName, char** ppXmlName);
+static void      free_xml_name(const char* szName, char** ppXmlName);
 
 /*=================================================================
  *  Public Interface functions
@@ -211,6 +223,7 @@ CU_ErrorCode CU_set_suite_name(CU_pSuite pSuite, const char *strNewName)
     result = CUE_NO_SUITENAME;
   }
   else {
+    free_xml_name(pSuite->pName, &pSuite->pXmlName);
     CU_FREE(pSuite->pName);
     pSuite->pName = (char *)CU_MALLOC(strlen(strNewName)+1);
     strcpy(pSuite->pName, strNewName);
@@ -220,6 +233,15 @@ CU_ErrorCode CU_set_suite_name(CU_pSuite pSuite, const char *strNewName)
   return result;
 }
 
+/*------------------------------------------------------------------------*/
+const char* CU_get_suite_xml_name(CU_pSuite pSuite)
+{
+  assert(NULL != pSuite);
+  assert(NULL != pSuite->pName);
+
+  return get_xml_name(pSuite->pName, &pSuite->pXmlName);
+}
+
 /*------------------------------------------------------------------------*/
 CU_ErrorCode CU_set_suite_initfunc(CU_pSuite pSuite, CU_InitializeFunc pNewInit)
 {
@@ -413,6 +435,7 @@ CU_ErrorCode CU_set_test_name(CU_pTest pTest, const char *strNewName)
     result = CUE_NO_TESTNAME;
   }
   else {
+    free_xml_name(pTest->pName, &pTest->pXmlName);
     CU_FREE(pTest->pName);
     pTest->pName = (char *)CU_MALLOC(strlen(strNewName)+1);
     strcpy(pTest->pName, strNewName);
@@ -422,6 +445,15 @@ CU_ErrorCode CU_set_test_name(CU_pTest pTest, const char *strNewName)
   return result;
 }
 
+/*------------------------------------------------------------------------*/
+const char* CU_get_test_xml_name(CU_pTest pTest)
+{
+  assert(NULL != pTest);
+  assert(NULL != pTest->pName);
+
+  return get_xml_name(pTest->pName, &pTest->pXmlName);
+}
+
 /*------------------------------------------------------------------------*/
 CU_ErrorCode CU_set_test_func(CU_pTest pTest, CU_TestFunc pNewFunc)
 {
@@ -679,6 +711,9 @@ static CU_pSuite create_suite(const char* strName, CU_InitializeFunc pInit, CU_C
       pRetValue->pNext = NULL;
       pRetValue->pPrev = NULL;
       pRetValue->uiNumberOfTests = 0;
+      pRetValue->pXmlName = NULL;
+      pRetValue->uiSnapshotBatch = 0;
+      pRetValue->fInShard = CU_TRUE;
     }
     else {
       CU_FREE(pRetValue);
@@ -716,6 +751,7 @@ static void cleanup_suite(CU_pSuite pSuite)
     CU_FREE(pCurTest);
     pCurTest = pNextTest;
   }
+  free_xml_name(pSuite->pName, &pSuite->pXmlName);
   if (NULL != pSuite->pName) {
     CU_FREE(pSuite->pName);
   }
@@ -795,6 +831,15 @@ static CU_pTest create_test(const char* strName, CU_TestFunc pTestFunc)
       pRetValue->fActive = CU_TRUE;
       pRetValue->pTestFunc = pTestFunc;
       pRetValue->pJumpBuf = NULL;
+      pRetValue->dDuration = 0.0;
+      pRetValue->pLoad = NULL;
+      pRetValue->pSoak = NULL;
+      pRetValue->pAlloc = NULL;
+      pRetValue->pAllocFail = NULL;
+      pRetValue->pXmlName = NULL;
+      pRetValue->uiTimeout = 0;
+      pRetValue->pLimits = NULL;
+      pRetValue->fInShard = CU_TRUE;
       pRetValue->pNext = NULL;
       pRetValue->pPrev = NULL;
     }
@@ -821,11 +866,32 @@ static void cleanup_test(CU_pTest pTest)
 {
   assert(NULL != pTest);
 
+  free_xml_name(pTest->pName, &pTest->pXmlName);
   if (NULL != pTest->pName) {
     CU_FREE(pTest->pName);
   }
+  if (NULL != pTest->pLoad) {
+    CU_FREE(pTest->pLoad);
+  }
+  if (NULL != pTest->pSoak) {
+    CU_FREE(pTest->pSoak);
+  }
+  if (NULL != pTest->pAlloc) {
+    CU_FREE(pTest->pAlloc);
+  }
+  if (NULL != pTest->pAllocFail) {
+    CU_FREE(pTest->pAllocFail);
+  }
+  if (NULL != pTest->pLimits) {
+    CU_FREE(pTest->pLimits);
+  }
 
   pTest->pName = NULL;
+  pTest->pLoad = NULL;
+  pTest->pSoak = NULL;
+  pTest->pAlloc = NULL;
+  pTest->pAllocFail = NULL;
+  pTest->pLimits = NULL;
 }
 
 /*------------------------------------------------------------------------*/
@@ -926,6 +992,57 @@ static CU_BOOL test_exists(CU_pSuite pSuite, const char* szTestName)
   return CU_FALSE;
 }
 
+/*------------------------------------------------------------------------*/
+/**
+ *  Internal function to retrieve the cached xml form of a suite or test
+ *  name, translating it on first use.  A name without special characters
+ *  is cached as szName itself rather than as a copy.
+ *
+ *  @param szName    The name (non-NULL).
+ *  @param ppXmlName Location of the cached translation (non-NULL).
+ *  @return The translated name, or "" if memory could not be allocated.
+ */
+static const char* get_xml_name(const char* szName, char** ppXmlName)
+{
+  size_t szLength;
+  char* szXmlName;
+
+  assert(NULL != szName);
+  assert(NULL != ppXmlName);
+
+  if (NULL == *ppXmlName) {
+    szLength = CU_translated_strlen(szName);
+    if (szLength == strlen(szName)) {
+      *ppXmlName = (char *)szName;
+    }
+    else if (NULL != (szXmlName = (char *)CU_MALLOC(szLength + 1))) {
+      CU_translate_special_characters(szName, szXmlName, szLength + 1);
+      *ppXmlName = szXmlName;
+    }
+    else {
+      return "";
+    }
+  }
+  return *ppXmlName;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Internal function to discard the cached xml form of a name.
+ *
+ *  @param szName    The name the translation was made from.
+ *  @param ppXmlName Location of the cached translation (non-NULL).
+ */
+static void free_xml_name(const char* szName, char** ppXmlName)
+{
+  assert(NULL != ppXmlName);
+
+  if ((NULL != *ppXmlName) && (*ppXmlName != szName)) {
+    CU_FREE(*ppXmlName);
+  }
+  *ppXmlName = NULL;
+}
+
 /*=================================================================
  *  Public but primarily internal function definitions
  *=================================================================*/
@@ -2753,6 +2870,56 @@ static void test_register_suite(void)
   TEST(8 == pReg->uiNumberOfTests);
 }
 
+/*--------------------------------------------------*/
+static void test_xml_names(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+  const char* szXmlName;
+  char* szCached;
+
+  CU_initialize_registry();
+
+  pSuite = CU_add_suite("plain suite", NULL, NULL);
+  TEST_FATAL(NULL != pSuite);
+  pTest = CU_add_test(pSuite, "a<b & \"c\"", test1);
+  TEST_FATAL(NULL != pTest);
+  TEST(NULL == pSuite->pXmlName);
+  TEST(NULL == pTest->pXmlName);
+
+  /* names without special characters are not copied */
+  szXmlName = CU_get_suite_xml_name(pSuite);
+  TEST(!strcmp("plain suite", szXmlName));
+  TEST(szXmlName == pSuite->pName);
+  TEST(szXmlName == CU_get_suite_xml_name(pSuite));
+
+  /* translated once and reused */
+  szXmlName = CU_get_test_xml_name(pTest);
+  TEST(!strcmp("a&lt;b &amp; &quot;c&quot;", szXmlName));
+  TEST(szXmlName == pTest->pXmlName);
+  TEST(szXmlName == CU_get_test_xml_name(pTest));
+  TEST(0 != test_cunit_get_n_memevents(pTest->pXmlName));
+
+  /* renaming invalidates the cache */
+  szCached = pTest->pXmlName;
+  TEST(CUE_SUCCESS == CU_set_test_name(pTest, "t>1"));
+  TEST(NULL == pTest->pXmlName);
+  TEST(test_cunit_get_n_allocations(szCached) == test_cunit_get_n_deallocations(szCached));
+  TEST(!strcmp("t&gt;1", CU_get_test_xml_name(pTest)));
+
+  TEST(CUE_SUCCESS == CU_set_suite_name(pSuite, "s&1"));
+  TEST(NULL == pSuite->pXmlName);
+  TEST(!strcmp("s&amp;1", CU_get_suite_xml_name(pSuite)));
+  TEST(CUE_SUCCESS == CU_set_suite_name(pSuite, "s2"));
+  TEST(!strcmp("s2", CU_get_suite_xml_name(pSuite)));
+
+  /* freed with the registry */
+  TEST(CUE_SUCCESS == CU_set_suite_name(pSuite, "s&2"));
+  szCached = (char *)CU_get_suite_xml_name(pSuite);
+  CU_cleanup_registry();
+  TEST(test_cunit_get_n_allocations(szCached) == test_cunit_get_n_deallocations(szCached));
+}
+
 /*--------------------------------------------------*/
 void test_cunit_TestDB(void)
 {
@@ -2776,6 +2943,7 @@ void test_cunit_TestDB(void)
   test_cleanup_test();
   test_insert_test();
   test_register_suite();
+  test_xml_names();
 
   test_cunit_end_tests();
 }
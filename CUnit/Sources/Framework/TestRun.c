@@ -62,6 +62,39 @@
  *
  *  16-Avr-2007   Added setup and teardown functions. (CJN)
  *
+ *  18-Oct-2026   Added measurement of per-test duration. (AGT)
+ *
+ *  18-Oct-2026   Added support for multi-threaded load tests. (AGT)
+ *
+ *  18-Oct-2026   Added support for soak tests. (AGT)
+ *
+ *  18-Oct-2026   Added per-test heap allocation accounting. (AGT)
+ *
+ *  18-Oct-2026   Added allocation failure sweeps. (AGT)
+ *
+ *  18-Oct-2026   Added listeners, timing and resource events. (AGT)
+ *
+ *  18-Oct-2026   Added the listener event queue and writer thread. (AGT)
+ *
+ *  18-Oct-2026   Added process isolation of tests. (AGT)
+ *
+ *  18-Oct-2026   Added capture of fatal signals in test functions. (AGT)
+ *
+ *  18-Oct-2026   Added wall-clock timeouts of tests and suite functions. (AGT)
+ *
+ *  18-Oct-2026   Added per-test resource limits. (AGT)
+ *
+ *  18-Oct-2026   Added per-suite fixture snapshots. (AGT)
+ *
+ *  18-Oct-2026   Added sharding of test runs. (AGT)
+ *
+ *  18-Oct-2026   Added stopping runs after a number of failed tests. (AGT)
+ *
+ *  18-Oct-2026   Added CU_stop_run() for stopping a run from another thread. (AGT)
+ *
+ *  18-Oct-2026   Recorded deaths of isolated workers as CUF_TestCrashed and
+ *                workers which could not be started as CUF_WorkerFailed. (AGT)
+ *
  */
 
 /** @file
@@ -71,18 +104,38 @@
  @{
 */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L   /* sigaction(), sigsetjmp() under -std=c99 */
+#endif
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 700         /* sigaltstack(), SA_ONSTACK */
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <stdio.h>
 #include <setjmp.h>
 #include <time.h>
+#include <signal.h>
+
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
 
 #include "CUnit.h"
 #include "MyMem.h"
 #include "TestDB.h"
 #include "TestRun.h"
 #include "Util.h"
+#include "CUThread.h"
+#include "LoadTest.h"
+#include "SoakTest.h"
+#include "AllocTrack.h"
+#include "AllocFail.h"
+#include "Isolation.h"
+#include "Timeout.h"
+#include "Shard.h"
 #include "CUnit_intl.h"
 
 /*=================================================================
@@ -93,7 +146,7 @@ static CU_pSuite f_pCurSuite = NULL;          /**< Pointer to the suite currentl
 static CU_pTest  f_pCurTest  = NULL;          /**< Pointer to the test currently being run. */
 
 /** CU_RunSummary to hold results of each test run. */
-static CU_RunSummary f_run_summary = {"", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+static CU_RunSummary f_run_summary = {"", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
 /** CU_pFailureRecord to hold head of failure record list of each test run. */
 static CU_pFailureRecord f_failure_list = NULL;
@@ -104,9 +157,73 @@ static CU_pFailureRecord f_last_failure = NULL;
 /** Flag for whether inactive suites/tests are treated as failures. */
 static CU_BOOL f_failure_on_inactive = CU_TRUE;
 
+/** Number of failed tests stopping a run (0 for none, see CU_set_fail_fast()). */
+static unsigned int f_uiFailFast = 0;
+
+/** Test whose failure stopped the current or previous run (NULL if none). */
+static CU_pTest f_pFailFastTest = NULL;
+
+/** Flag for whether CU_stop_run() was called (set from any thread). */
+static volatile sig_atomic_t f_iStopRequested = 0;
+
 /** Variable for storage of start time for test run. */
 static clock_t f_start_time;
 
+/** Mutex serializing assertions while a load test runs (NULL otherwise). */
+static CU_pMutex f_pAssertMutex = NULL;
+
+/** Jump buffer of the load test call in progress on this thread. */
+static CU_THREAD_LOCAL jmp_buf* f_pThreadJumpBuf = NULL;
+
+/** Whether the tests of the current suite run in isolated workers. */
+static CU_BOOL f_bIsolatedSuite = CU_FALSE;
+
+/** Whether fatal signals in test functions are captured. */
+static CU_BOOL f_bCaptureCrashes = CU_FALSE;
+
+#ifndef _WIN32
+#define N_CRASH_SIGNALS 5
+/** Signals handled by crash capture. */
+static const int f_aiCrashSignals[N_CRASH_SIGNALS] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+/** Actions of the crash signals before crash capture was installed. */
+static struct sigaction f_aOldCrashActions[N_CRASH_SIGNALS];
+
+/** Whether the crash handlers are installed for the current run. */
+static CU_BOOL f_bCrashHandlersInstalled = CU_FALSE;
+
+/** Alternate signal stack of the thread running the tests, and the one it replaced. */
+static void* f_pCrashStack = NULL;
+static stack_t f_oldCrashStack;
+
+/** Jump buffer of the test function running on this thread with crash capture armed. */
+static CU_THREAD_LOCAL sigjmp_buf* f_pCrashJumpBuf = NULL;
+
+/** Signal and backtrace of the last captured crash, set by the signal handler. */
+static volatile sig_atomic_t f_iCrashSignal = 0;
+static void* f_apCrashFrames[CU_CRASH_MAX_FRAMES + 2];
+static int f_iCrashFrames = 0;
+#endif
+
+/** Functions covered by a timeout. */
+typedef enum TimeoutPhase
+{
+  TIMEOUT_TEST,             /**< Test setup, test and teardown functions. */
+  TIMEOUT_SUITE_INIT,       /**< Suite initialization function. */
+  TIMEOUT_SUITE_CLEANUP     /**< Suite cleanup function. */
+} TimeoutPhase;
+
+static unsigned int f_uiArmedTimeout = 0;                 /**< Timeout armed by the runner (ms), 0 if none. */
+static TimeoutPhase f_timeoutPhase = TIMEOUT_TEST;        /**< Functions covered by the armed timeout. */
+static CU_pFailureRecord f_pTimeoutLastFailure = NULL;    /**< Last failure before the test with the armed timeout. */
+static volatile CU_BOOL f_bTimeoutAbortable = CU_FALSE;   /**< Set while a test function may be abandoned. */
+static CU_pMutex f_pTimeoutMutex = NULL;                  /**< Protects the timeout state below. */
+static unsigned long f_ulTimeoutDeadline = 0;             /**< Id of the last deadline armed. */
+static CU_BOOL f_bTimeoutClaimed = CU_FALSE;              /**< Whether a thread handles the expired deadline. */
+static char* f_szTimeoutStacks = NULL;                    /**< Stack traces taken when the deadline expired. */
+
+#define TIMEOUT_GRACE_TIME 1.0    /**< Seconds the watchdog waits for the tests to get back after a timeout. */
+
 
 /** Pointer to the function to be called before running a suite. */
 static CU_SuiteStartMessageHandler          f_pSuiteStartMessageHandler = NULL;
@@ -129,6 +246,97 @@ static CU_SuiteInitFailureMessageHandler    f_pSuiteInitFailureMessageHandler =
 /** Pointer to the function to be called if a suite cleanup function returns an error. */
 static CU_SuiteCleanupFailureMessageHandler f_pSuiteCleanupFailureMessageHandler = NULL;
 
+/** A listener registered with CU_add_listener(). */
+typedef struct CU_ListenerEntry
+{
+  const CU_Listener* pListener;   /**< Callbacks of the listener. */
+  void*              pContext;    /**< Context passed to the callbacks. */
+} CU_ListenerEntry;
+
+/** Listener events (first index of f_aapEventListeners). */
+typedef enum CU_ListenerEvent
+{
+  EVENT_SUITE_START = 0,
+  EVENT_TEST_START,
+  EVENT_TEST_COMPLETE,
+  EVENT_SUITE_COMPLETE,
+  EVENT_ALL_TESTS_COMPLETE,
+  EVENT_SUITE_INIT_FAILURE,
+  EVENT_SUITE_CLEANUP_FAILURE,
+  EVENT_TEST_TIMING,
+  EVENT_SUITE_TIMING,
+  EVENT_TEST_RESOURCES,
+  N_LISTENER_EVENTS
+} CU_ListenerEvent;
+
+/** Listeners in registration order. */
+static CU_ListenerEntry f_aListeners[CU_MAX_LISTENERS];
+
+/** Number of entries in f_aListeners. */
+static unsigned int f_nListeners = 0;
+
+/** For each event, the listeners having a callback for it, in registration order. */
+static const CU_ListenerEntry* f_aapEventListeners[N_LISTENER_EVENTS][CU_MAX_LISTENERS];
+
+/** Number of entries of each row of f_aapEventListeners. */
+static unsigned int f_anEventListeners[N_LISTENER_EVENTS];
+
+/** For each event, the listeners flagged CU_LISTENER_SYNCHRONOUS having a callback for it. */
+static const CU_ListenerEntry* f_aapSyncEventListeners[N_LISTENER_EVENTS][CU_MAX_LISTENERS];
+
+/** Number of entries of each row of f_aapSyncEventListeners. */
+static unsigned int f_anSyncEventListeners[N_LISTENER_EVENTS];
+
+/** For each event, the other listeners having a callback for it. */
+static const CU_ListenerEntry* f_aapAsyncEventListeners[N_LISTENER_EVENTS][CU_MAX_LISTENERS];
+
+/** Number of entries of each row of f_aapAsyncEventListeners. */
+static unsigned int f_anAsyncEventListeners[N_LISTENER_EVENTS];
+
+/** An event queued for the event writer thread. */
+typedef struct CU_EventRecord
+{
+  CU_ListenerEvent  event;      /**< The event. */
+  CU_pSuite         pSuite;     /**< Suite of the event (NULL for all tests complete). */
+  CU_pTest          pTest;      /**< Test of the event (NULL for suite events). */
+  CU_pFailureRecord pFailure;   /**< Failures of the event; copies for queued test and suite complete events. */
+  CU_Timing         timing;     /**< Timing of test and suite timing events. */
+  CU_TestResources  resources;  /**< Resources of test resources events. */
+} CU_EventRecord;
+
+/** Number of records in the event queue set with CU_set_listener_queue_size() (0 = no queue). */
+static unsigned int f_uiQueueSize = 0;
+
+/** Ring buffer of queued events while the event writer runs (NULL otherwise). */
+static CU_EventRecord* f_aEventQueue = NULL;
+
+/** Number of events queued during the run (the next record written is at f_ulQueueHead % f_uiQueueSize). */
+static unsigned long f_ulQueueHead = 0;
+
+/** Number of events delivered by the event writer during the run. */
+static unsigned long f_ulQueueTail = 0;
+
+/** Number of times the test thread waited for room in the queue during the last run. */
+static unsigned long f_ulQueueStalls = 0;
+
+/** Set at the end of the run to make the event writer exit once the queue is empty. */
+static CU_BOOL f_bQueueStop = CU_FALSE;
+
+/** Mutex protecting the queue indexes and f_bQueueStop. */
+static CU_pMutex f_pQueueMutex = NULL;
+
+/** Signalled when an event is queued or f_bQueueStop is set. */
+static CU_pCond f_pQueueNotEmpty = NULL;
+
+/** Signalled when the event writer has delivered an event. */
+static CU_pCond f_pQueueNotFull = NULL;
+
+/** The event writer thread (NULL when not running). */
+static CU_pThread f_pEventWriter = NULL;
+
+/** CU_TRUE on the event writer thread. */
+static CU_THREAD_LOCAL CU_BOOL f_bIsEventWriter = CU_FALSE;
+
 /*=================================================================
  * Private function forward declarations
  *=================================================================*/
@@ -136,6 +344,42 @@ static void         clear_previous_results(CU_pRunSummary pRunSummary, CU_pFailu
 static void         cleanup_failure_list(CU_pFailureRecord* ppFailure);
 static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummary);
 static CU_ErrorCode run_single_test(CU_pTest pTest, CU_pRunSummary pRunSummary);
+static void         run_test_body(CU_pTest pTest, CU_Timing* pTiming, CU_TestResources* pResources);
+static void         run_isolated_test(CU_pTest pTest, CU_Timing* pTiming, CU_TestResources* pResources);
+static void         add_limit_failure(const CU_TestLimits* pLimits, const CU_IsolatedResult* pResult);
+static void         run_test_in_worker(CU_pTest pTest, CU_IsolatedResult* pResult);
+static void         add_isolated_failure(CU_FailureType type, unsigned int uiLine,
+                                         const char* szCondition, const char* szFile);
+static void         begin_isolated_suite(CU_pSuite pSuite);
+static void         end_isolated_suite(void);
+static void         install_crash_handlers(void);
+static void         remove_crash_handlers(void);
+static void         add_crash_failure(void);
+static void         arm_timeout(TimeoutPhase phase, unsigned int uiMilliseconds);
+static void         disarm_timeout(void);
+static CU_BOOL      take_timeout(void);
+static void         add_timeout_failure(void);
+static void         stop_timeouts(void);
+static int          run_suite_function(CU_InitializeFunc pFunc, TimeoutPhase phase);
+static void         run_soak_test(CU_pTest pTest);
+static void         run_alloc_failure_sweep(CU_pTest pTest);
+static void         rebuild_listener_tables(void);
+static void         start_event_queue(void);
+static void         stop_event_queue(void);
+static CU_BOOL      flush_event_queue(double dTimeout);
+static void         notify_suite_start(const CU_pSuite pSuite);
+static void         notify_test_start(const CU_pTest pTest, const CU_pSuite pSuite);
+static void         notify_test_complete(const CU_pTest pTest, const CU_pSuite pSuite,
+                                         const CU_pFailureRecord pFailure);
+static void         notify_suite_complete(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+static void         notify_all_tests_complete(const CU_pFailureRecord pFailure);
+static void         notify_suite_init_failure(const CU_pSuite pSuite);
+static void         notify_suite_cleanup_failure(const CU_pSuite pSuite);
+static void         notify_test_timing(const CU_pTest pTest, const CU_pSuite pSuite,
+                                       const CU_Timing* pTiming);
+static void         notify_suite_timing(const CU_pSuite pSuite, const CU_Timing* pTiming);
+static void         notify_test_resources(const CU_pTest pTest, const CU_pSuite pSuite,
+                                          const CU_TestResources* pResources);
 static void         add_failure(CU_pFailureRecord* ppFailure,
                                 CU_pRunSummary pRunSummary,
                                 CU_FailureType type,
@@ -155,6 +399,9 @@ CU_BOOL CU_assertImplementation(CU_BOOL bValue,
                                 const char *strFunction,
                                 CU_BOOL bFatal)
 {
+  /* failure records are not allocations of the test */
+  int iSuspended = CU_alloc_set_suspended(1);
+
   /* not used in current implementation - stop compiler warning */
   CU_UNREFERENCED_PARAMETER(strFunction);
 
@@ -162,13 +409,31 @@ CU_BOOL CU_assertImplementation(CU_BOOL bValue,
   assert(NULL != f_pCurSuite);
   assert(NULL != f_pCurTest);
 
+  if (NULL != f_pAssertMutex) {
+    CU_mutex_lock(f_pAssertMutex);
+  }
   ++f_run_summary.nAsserts;
   if (CU_FALSE == bValue) {
     ++f_run_summary.nAssertsFailed;
-    add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
-                uiLine, strCondition, strFile, f_pCurSuite, f_pCurTest);
+    if (CU_FALSE != CU_is_isolation_worker()) {
+      CU_isolation_report_failure(CUF_AssertFailed, uiLine, strCondition, strFile,
+                                  f_run_summary.nAsserts, f_run_summary.nAssertsFailed);
+    }
+    else {
+      add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                  uiLine, strCondition, strFile, f_pCurSuite, f_pCurTest);
+    }
+  }
+  if (NULL != f_pAssertMutex) {
+    CU_mutex_unlock(f_pAssertMutex);
+  }
+  CU_alloc_set_suspended(iSuspended);
 
-    if ((CU_TRUE == bFatal) && (NULL != f_pCurTest->pJumpBuf)) {
+  if ((CU_FALSE == bValue) && (CU_TRUE == bFatal)) {
+    if (NULL != f_pThreadJumpBuf) {
+      longjmp(*f_pThreadJumpBuf, 1);
+    }
+    else if (NULL != f_pCurTest->pJumpBuf) {
       longjmp(*(f_pCurTest->pJumpBuf), 1);
     }
   }
@@ -176,6 +441,29 @@ CU_BOOL CU_assertImplementation(CU_BOOL bValue,
   return bValue;
 }
 
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_run_test_function_concurrently(CU_TestFunc pTestFunc)
+{
+  jmp_buf buf;
+  volatile CU_BOOL bCompleted = CU_FALSE;
+  int iSuspended;
+
+  assert(NULL != pTestFunc);
+  assert(NULL != f_pCurTest);
+
+  /* the load and soak loops are suspended, but the test function is not */
+  iSuspended = CU_alloc_set_suspended(0);
+  f_pThreadJumpBuf = &buf;
+  if (0 == setjmp(buf)) {
+    (*pTestFunc)();
+    bCompleted = CU_TRUE;
+  }
+  f_pThreadJumpBuf = NULL;
+  CU_alloc_set_suspended(iSuspended);
+
+  return bCompleted;
+}
+
 /*------------------------------------------------------------------------*/
 void CU_set_suite_start_handler(CU_SuiteStartMessageHandler pSuiteStartHandler)
 {
@@ -260,6 +548,96 @@ CU_SuiteCleanupFailureMessageHandler CU_get_suite_cleanup_failure_handler(void)
   return f_pSuiteCleanupFailureMessageHandler;
 }
 
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_add_listener(const CU_Listener* pListener, void* pContext)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if (NULL == pListener) {
+    result = CUE_NOLISTENER;
+  }
+  else if ((CU_FALSE != f_bTestIsRunning) || (NULL != f_aEventQueue)) {
+    result = CUE_LISTENER_BUSY;
+  }
+  else if (CU_MAX_LISTENERS <= f_nListeners) {
+    result = CUE_TOO_MANY_LISTENERS;
+  }
+  else {
+    f_aListeners[f_nListeners].pListener = pListener;
+    f_aListeners[f_nListeners].pContext = pContext;
+    ++f_nListeners;
+    rebuild_listener_tables();
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_remove_listener(const CU_Listener* pListener, void* pContext)
+{
+  CU_ErrorCode result = CUE_NOLISTENER;
+  unsigned int i;
+
+  if ((CU_FALSE != f_bTestIsRunning) || (NULL != f_aEventQueue)) {
+    result = CUE_LISTENER_BUSY;
+  }
+  else {
+    for (i = 0 ; i < f_nListeners ; ++i) {
+      if ((pListener == f_aListeners[i].pListener) && (pContext == f_aListeners[i].pContext)) {
+        --f_nListeners;
+        memmove(&f_aListeners[i], &f_aListeners[i + 1], (f_nListeners - i) * sizeof(CU_ListenerEntry));
+        rebuild_listener_tables();
+        result = CUE_SUCCESS;
+        break;
+      }
+    }
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_number_of_listeners(void)
+{
+  return f_nListeners;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_set_listener_queue_size(unsigned int uiRecords)
+{
+  CU_ErrorCode result = CUE_SUCCESS;
+
+  if ((CU_FALSE != f_bTestIsRunning) || (NULL != f_aEventQueue)) {
+    result = CUE_LISTENER_BUSY;
+  }
+  else {
+    f_uiQueueSize = uiRecords;
+  }
+
+  CU_set_error(result);
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_listener_queue_size(void)
+{
+  return f_uiQueueSize;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned long CU_get_listener_queue_stalls(void)
+{
+  return f_ulQueueStalls;
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_flush_listener_events(double dTimeout)
+{
+  return flush_event_queue(dTimeout);
+}
+
 /*------------------------------------------------------------------------*/
 unsigned int CU_get_number_of_suites_run(void)
 {
@@ -320,6 +698,12 @@ unsigned int CU_get_number_of_failure_records(void)
   return f_run_summary.nFailureRecords;
 }
 
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_number_of_tests_crashed(void)
+{
+  return f_run_summary.nTestsCrashed;
+}
+
 /*------------------------------------------------------------------------*/
 double CU_get_elapsed_time(void)
 {
@@ -357,25 +741,38 @@ CU_ErrorCode CU_run_all_tests(void)
   if (NULL == pRegistry) {
     result = CUE_NOREGISTRY;
   }
+  else if (CUE_SUCCESS != (result = CU_shard_begin_run(pRegistry, CU_TRUE))) {
+    /* invalid shard selection - nothing is run */
+  }
   else {
     /* test run is starting - set flag */
     f_bTestIsRunning = CU_TRUE;
     f_start_time = clock();
+    start_event_queue();
+    install_crash_handlers();
 
     pSuite = pRegistry->pSuite;
-    while ((NULL != pSuite) && ((CUE_SUCCESS == result) || (CU_get_error_action() == CUEA_IGNORE))) {
-      result2 = run_single_suite(pSuite, &f_run_summary);
-      result = (CUE_SUCCESS == result) ? result2 : result;  /* result = 1st error encountered */
+    while ((NULL != pSuite) && (NULL == f_pFailFastTest) && (0 == f_iStopRequested) &&
+           ((CUE_SUCCESS == result) || (CU_get_error_action() == CUEA_IGNORE))) {
+      /* suites of other shards are left out, as if not registered */
+      if (CU_FALSE != pSuite->fInShard) {
+        result2 = run_single_suite(pSuite, &f_run_summary);
+        result = (CUE_SUCCESS == result) ? result2 : result;  /* result = 1st error encountered */
+      }
       pSuite = pSuite->pNext;
     }
+    result2 = CU_shard_end_run();
+    result = (CUE_SUCCESS == result) ? result2 : result;
 
-    /* test run is complete - clear flag */
+    /* test run is complete - clear flags */
     f_bTestIsRunning = CU_FALSE;
+    f_iStopRequested = 0;
     f_run_summary.ElapsedTime = ((double)clock() - (double)f_start_time)/(double)CLOCKS_PER_SEC;
 
-    if (NULL != f_pAllTestsCompleteMessageHandler) {
-     (*f_pAllTestsCompleteMessageHandler)(f_failure_list);
-    }
+    remove_crash_handlers();
+    stop_timeouts();
+    notify_all_tests_complete(f_failure_list);
+    stop_event_queue();
   }
 
   CU_set_error(result);
@@ -386,6 +783,7 @@ CU_ErrorCode CU_run_all_tests(void)
 CU_ErrorCode CU_run_suite(CU_pSuite pSuite)
 {
   CU_ErrorCode result = CUE_SUCCESS;
+  CU_ErrorCode result2;
 
   /* Clear results from the previous run */
   clear_previous_results(&f_run_summary, &f_failure_list);
@@ -393,21 +791,32 @@ CU_ErrorCode CU_run_suite(CU_pSuite pSuite)
   if (NULL == pSuite) {
     result = CUE_NOSUITE;
   }
+  else if (CUE_SUCCESS != (result = CU_shard_begin_run(CU_get_registry(), CU_TRUE))) {
+    /* invalid shard selection - nothing is run */
+  }
   else {
     /* test run is starting - set flag */
     f_bTestIsRunning = CU_TRUE;
     f_start_time = clock();
+    start_event_queue();
+    install_crash_handlers();
 
-    result = run_single_suite(pSuite, &f_run_summary);
+    if (CU_FALSE != pSuite->fInShard) {
+      result = run_single_suite(pSuite, &f_run_summary);
+    }
+    result2 = CU_shard_end_run();
+    result = (CUE_SUCCESS == result) ? result2 : result;
 
-    /* test run is complete - clear flag */
+    /* test run is complete - clear flags */
     f_bTestIsRunning = CU_FALSE;
+    f_iStopRequested = 0;
     f_run_summary.ElapsedTime = ((double)clock() - (double)f_start_time)/(double)CLOCKS_PER_SEC;
 
     /* run handler for overall completion, if any */
-    if (NULL != f_pAllTestsCompleteMessageHandler) {
-      (*f_pAllTestsCompleteMessageHandler)(f_failure_list);
-    }
+    remove_crash_handlers();
+    stop_timeouts();
+    notify_all_tests_complete(f_failure_list);
+    stop_event_queue();
   }
 
   CU_set_error(result);
@@ -419,6 +828,9 @@ CU_ErrorCode CU_run_test(CU_pSuite pSuite, CU_pTest pTest)
 {
   CU_ErrorCode result = CUE_SUCCESS;
   CU_ErrorCode result2;
+  CU_Timing timing = {0.0, 0.0, 0.0};
+  double dPhaseStart;
+  int iStatus;
 
   /* Clear results from the previous run */
   clear_previous_results(&f_run_summary, &f_failure_list);
@@ -444,24 +856,26 @@ CU_ErrorCode CU_run_test(CU_pSuite pSuite, CU_pTest pTest)
     /* test run is starting - set flag */
     f_bTestIsRunning = CU_TRUE;
     f_start_time = clock();
+    start_event_queue();
+    install_crash_handlers();
 
     f_pCurTest = NULL;
     f_pCurSuite = pSuite;
+    CU_shard_begin_run(CU_get_registry(), CU_FALSE);
 
     pSuite->uiNumberOfTestsFailed = 0;
     pSuite->uiNumberOfTestsSuccess = 0;
 
     /* run handler for suite start, if any */
-    if (NULL != f_pSuiteStartMessageHandler) {
-      (*f_pSuiteStartMessageHandler)(pSuite);
-    }
+    notify_suite_start(pSuite);
 
     /* run the suite initialization function, if any */
-    if ((NULL != pSuite->pInitializeFunc) && (0 != (*pSuite->pInitializeFunc)())) {
+    dPhaseStart = CU_get_monotonic_time();
+    iStatus = run_suite_function(pSuite->pInitializeFunc, TIMEOUT_SUITE_INIT);
+    timing.dSetUp = CU_get_monotonic_time() - dPhaseStart;
+    if (0 != iStatus) {
       /* init function had an error - call handler, if any */
-      if (NULL != f_pSuiteInitFailureMessageHandler) {
-        (*f_pSuiteInitFailureMessageHandler)(pSuite);
-      }
+      notify_suite_init_failure(pSuite);
       f_run_summary.nSuitesFailed++;
       add_failure(&f_failure_list, &f_run_summary, CUF_SuiteInitFailed, 0,
                   _("Suite Initialization failed - Suite Skipped"),
@@ -470,15 +884,20 @@ CU_ErrorCode CU_run_test(CU_pSuite pSuite, CU_pTest pTest)
     }
     /* reach here if no suite initialization, or if it succeeded */
     else {
+      dPhaseStart = CU_get_monotonic_time();
+      begin_isolated_suite(pSuite);
       result2 = run_single_test(pTest, &f_run_summary);
       result = (CUE_SUCCESS == result) ? result2 : result;
+      end_isolated_suite();
+      timing.dRun = CU_get_monotonic_time() - dPhaseStart;
 
       /* run the suite cleanup function, if any */
-      if ((NULL != pSuite->pCleanupFunc) && (0 != (*pSuite->pCleanupFunc)())) {
+      dPhaseStart = CU_get_monotonic_time();
+      iStatus = run_suite_function(pSuite->pCleanupFunc, TIMEOUT_SUITE_CLEANUP);
+      timing.dTearDown = CU_get_monotonic_time() - dPhaseStart;
+      if (0 != iStatus) {
         /* cleanup function had an error - call handler, if any */
-        if (NULL != f_pSuiteCleanupFailureMessageHandler) {
-          (*f_pSuiteCleanupFailureMessageHandler)(pSuite);
-        }
+        notify_suite_cleanup_failure(pSuite);
         f_run_summary.nSuitesFailed++;
         add_failure(&f_failure_list, &f_run_summary, CUF_SuiteCleanupFailed,
                     0, _("Suite cleanup failed."), _("CUnit System"), pSuite, NULL);
@@ -486,19 +905,21 @@ CU_ErrorCode CU_run_test(CU_pSuite pSuite, CU_pTest pTest)
       }
     }
 
+    notify_suite_timing(pSuite, &timing);
+
     /* run handler for suite completion, if any */
-    if (NULL != f_pSuiteCompleteMessageHandler) {
-      (*f_pSuiteCompleteMessageHandler)(pSuite, NULL);
-    }
+    notify_suite_complete(pSuite, NULL);
 
-    /* test run is complete - clear flag */
+    /* test run is complete - clear flags */
     f_bTestIsRunning = CU_FALSE;
+    f_iStopRequested = 0;
     f_run_summary.ElapsedTime = ((double)clock() - (double)f_start_time)/(double)CLOCKS_PER_SEC;
 
     /* run handler for overall completion, if any */
-    if (NULL != f_pAllTestsCompleteMessageHandler) {
-      (*f_pAllTestsCompleteMessageHandler)(f_failure_list);
-    }
+    remove_crash_handlers();
+    stop_timeouts();
+    notify_all_tests_complete(f_failure_list);
+    stop_event_queue();
 
     f_pCurSuite = NULL;
   }
@@ -543,6 +964,46 @@ CU_EXPORT CU_BOOL CU_get_fail_on_inactive(void)
   return f_failure_on_inactive;
 }
 
+/*------------------------------------------------------------------------*/
+CU_EXPORT void CU_set_fail_fast(unsigned int uiMaxFailures)
+{
+  f_uiFailFast = uiMaxFailures;
+}
+
+/*------------------------------------------------------------------------*/
+CU_EXPORT unsigned int CU_get_fail_fast(void)
+{
+  return f_uiFailFast;
+}
+
+/*------------------------------------------------------------------------*/
+CU_EXPORT CU_pTest CU_get_fail_fast_test(void)
+{
+  return f_pFailFastTest;
+}
+
+/*------------------------------------------------------------------------*/
+CU_EXPORT void CU_stop_run(void)
+{
+  f_iStopRequested = 1;
+}
+
+/*------------------------------------------------------------------------*/
+CU_EXPORT void CU_set_crash_capture(CU_BOOL bCapture)
+{
+  f_bCaptureCrashes = bCapture;
+}
+
+/*------------------------------------------------------------------------*/
+CU_EXPORT CU_BOOL CU_get_crash_capture(void)
+{
+#ifdef _WIN32
+  return CU_FALSE;
+#else
+  return f_bCaptureCrashes;
+#endif
+}
+
 /*------------------------------------------------------------------------*/
 CU_EXPORT void CU_print_run_results(FILE *file)
 {
@@ -568,10 +1029,26 @@ CU_EXPORT char * CU_get_run_results_string(void)
   size_t width[9];
   size_t len;
   char *result;
+  char szTaint[128] = "";
+  char szStopped[128] = "";
 
   assert(NULL != pRunSummary);
   assert(NULL != pRegistry);
 
+  if (NULL != f_pFailFastTest) {
+    snprintf(szStopped, sizeof(szStopped),
+             _("\n\nRun stopped after %u failed test(s); later tests were not run."),
+             pRunSummary->nTestsFailed);
+    szStopped[sizeof(szStopped) - 1] = '\0';
+  }
+
+  if (0 < pRunSummary->nTestsCrashed) {
+    snprintf(szTaint, sizeof(szTaint),
+             _("\n\nRun tainted: %u test(s) crashed in process; later results may be unreliable."),
+             pRunSummary->nTestsCrashed);
+    szTaint[sizeof(szTaint) - 1] = '\0';
+  }
+
   width[0] = strlen(_("Run Summary:"));
   width[1] = CU_MAX(6,
                     CU_MAX(strlen(_("Type")),
@@ -607,7 +1084,7 @@ CU_EXPORT char * CU_get_run_results_string(void)
   width[7] = strlen(_("Elapsed time = "));
   width[8] = strlen(_(" seconds"));
 
-  len = 13 + 4*(width[0] + width[1] + width[2] + width[3] + width[4] + width[5] + width[6]) + width[7] + width[8] + 1;
+  len = 13 + 4*(width[0] + width[1] + width[2] + width[3] + width[4] + width[5] + width[6]) + width[7] + width[8] + strlen(szTaint) + strlen(szStopped) + 1;
   result = (char *)CU_MALLOC(len);
 
   if (NULL != result) {
@@ -647,7 +1124,9 @@ CU_EXPORT char * CU_get_run_results_string(void)
             width[7], _("Elapsed time = "), CU_get_elapsed_time(),  /* makes sure time is updated */
             width[8], _(" seconds")
             );
-     result[len-1] = '\0';
+     result[len-1 - strlen(szTaint) - strlen(szStopped)] = '\0';
+     strcat(result, szTaint);
+     strcat(result, szStopped);
   }
   return result;
 }
@@ -773,6 +1252,8 @@ static void clear_previous_results(CU_pRunSummary pRunSummary, CU_pFailureRecord
   pRunSummary->nAssertsFailed = 0;
   pRunSummary->nFailureRecords = 0;
   pRunSummary->ElapsedTime = 0.0;
+  pRunSummary->nTestsCrashed = 0;
+  f_pFailFastTest = NULL;
 
   if (NULL != *ppFailure) {
     cleanup_failure_list(ppFailure);
@@ -838,6 +1319,9 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
   CU_pFailureRecord pLastFailure = f_last_failure;
   CU_ErrorCode result = CUE_SUCCESS;
   CU_ErrorCode result2;
+  CU_Timing timing = {0.0, 0.0, 0.0};
+  double dPhaseStart;
+  int iStatus;
 
   assert(NULL != pSuite);
   assert(NULL != pRunSummary);
@@ -850,19 +1334,18 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
   pSuite->uiNumberOfTestsSuccess = 0;
 
   /* run handler for suite start, if any */
-  if (NULL != f_pSuiteStartMessageHandler) {
-    (*f_pSuiteStartMessageHandler)(pSuite);
-  }
+  notify_suite_start(pSuite);
 
   /* run suite if it's active */
   if (CU_FALSE != pSuite->fActive) {
 
     /* run the suite initialization function, if any */
-    if ((NULL != pSuite->pInitializeFunc) && (0 != (*pSuite->pInitializeFunc)())) {
+    dPhaseStart = CU_get_monotonic_time();
+    iStatus = run_suite_function(pSuite->pInitializeFunc, TIMEOUT_SUITE_INIT);
+    timing.dSetUp = CU_get_monotonic_time() - dPhaseStart;
+    if (0 != iStatus) {
       /* init function had an error - call handler, if any */
-      if (NULL != f_pSuiteInitFailureMessageHandler) {
-        (*f_pSuiteInitFailureMessageHandler)(pSuite);
-      }
+      notify_suite_init_failure(pSuite);
       pRunSummary->nSuitesFailed++;
       add_failure(&f_failure_list, &f_run_summary, CUF_SuiteInitFailed, 0,
                   _("Suite Initialization failed - Suite Skipped"),
@@ -875,13 +1358,26 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
 
     /* reach here if no suite initialization, or if it succeeded */
     else {
+      dPhaseStart = CU_get_monotonic_time();
+      begin_isolated_suite(pSuite);
       pTest = pSuite->pTest;
-      while ((NULL != pTest) && ((CUE_SUCCESS == result) || (CU_get_error_action() == CUEA_IGNORE)))
+      while ((NULL != pTest) && (NULL == f_pFailFastTest) && (0 == f_iStopRequested) &&
+             ((CUE_SUCCESS == result) || (CU_get_error_action() == CUEA_IGNORE)))
       {
         unsigned int numberOfFailureBeforeTest = pRunSummary->nFailureRecords;
+
+        /* tests of other shards are left out, as if not registered */
+        if (CU_FALSE == pTest->fInShard) {
+          pTest = pTest->pNext;
+          continue;
+        }
         result2 = run_single_test(pTest, pRunSummary);
         result = (CUE_SUCCESS == result) ? result2 : result;
 
+        /* enough tests failed - no further tests are started, the suite is cleaned up */
+        if ((0 != f_uiFailFast) && (pRunSummary->nTestsFailed >= f_uiFailFast)) {
+          f_pFailFastTest = pTest;
+        }
         pTest = pTest->pNext;
 
         if (CUE_SUCCESS == result) {
@@ -898,13 +1394,16 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
             pSuite->uiNumberOfTestsFailed++;
         }
       }
+      end_isolated_suite();
       pRunSummary->nSuitesRun++;
+      timing.dRun = CU_get_monotonic_time() - dPhaseStart;
 
       /* call the suite cleanup function, if any */
-      if ((NULL != pSuite->pCleanupFunc) && (0 != (*pSuite->pCleanupFunc)())) {
-        if (NULL != f_pSuiteCleanupFailureMessageHandler) {
-          (*f_pSuiteCleanupFailureMessageHandler)(pSuite);
-        }
+      dPhaseStart = CU_get_monotonic_time();
+      iStatus = run_suite_function(pSuite->pCleanupFunc, TIMEOUT_SUITE_CLEANUP);
+      timing.dTearDown = CU_get_monotonic_time() - dPhaseStart;
+      if (0 != iStatus) {
+        notify_suite_cleanup_failure(pSuite);
         pRunSummary->nSuitesFailed++;
         add_failure(&f_failure_list, &f_run_summary, CUF_SuiteCleanupFailed,
                     0, _("Suite cleanup failed."), _("CUnit System"), pSuite, NULL);
@@ -914,6 +1413,8 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
         result = (CUE_SUCCESS == result) ? CUE_SCLEAN_FAILED : result;
       }
     }
+
+    notify_suite_timing(pSuite, &timing);
   }
 
   /* otherwise record inactive suite and failure if appropriate */
@@ -940,9 +1441,7 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
   }
 
   /* run handler for suite completion, if any */
-  if (NULL != f_pSuiteCompleteMessageHandler) {
-    (*f_pSuiteCompleteMessageHandler)(pSuite, pLastFailure);
-  }
+  notify_suite_complete(pSuite, pLastFailure);
 
   f_pCurSuite = NULL;
   return result;
@@ -966,10 +1465,11 @@ static CU_ErrorCode run_single_suite(CU_pSuite pSuite, CU_pRunSummary pRunSummar
  */
 static CU_ErrorCode run_single_test(CU_pTest pTest, CU_pRunSummary pRunSummary)
 {
-  volatile unsigned int nStartFailures;
+  unsigned int nStartFailures;
   /* keep track of the last failure BEFORE running the test */
-  volatile CU_pFailureRecord pLastFailure = f_last_failure;
-  jmp_buf buf;
+  CU_pFailureRecord pLastFailure = f_last_failure;
+  CU_Timing timing = {0.0, 0.0, 0.0};
+  CU_TestResources resources;
   CU_ErrorCode result = CUE_SUCCESS;
 
   assert(NULL != f_pCurSuite);
@@ -980,34 +1480,32 @@ static CU_ErrorCode run_single_test(CU_pTest pTest, CU_pRunSummary pRunSummary)
   nStartFailures = pRunSummary->nFailureRecords;
 
   f_pCurTest = pTest;
+  pTest->dDuration = 0.0;
 
-  if (NULL != f_pTestStartMessageHandler) {
-    (*f_pTestStartMessageHandler)(f_pCurTest, f_pCurSuite);
-  }
+  notify_test_start(f_pCurTest, f_pCurSuite);
 
   /* run test if it is active */
   if (CU_FALSE != pTest->fActive) {
 
-    if (NULL != f_pCurSuite->pSetUpFunc) {
-      (*f_pCurSuite->pSetUpFunc)();
-    }
+    f_pTimeoutLastFailure = pLastFailure;
+    arm_timeout(TIMEOUT_TEST, CU_get_test_timeout(pTest));
 
-    /* set jmp_buf and run test */
-    pTest->pJumpBuf = &buf;
-    if (0 == setjmp(buf)) {
-      if (NULL != pTest->pTestFunc) {
-        (*pTest->pTestFunc)();
-      }
+    /* load, soak and sweep tests supervise themselves in the test program */
+    if (((CU_FALSE != f_bIsolatedSuite) || (NULL != pTest->pLimits)) && (NULL == pTest->pLoad) &&
+        (NULL == pTest->pSoak) && (NULL == pTest->pAllocFail)) {
+      run_isolated_test(pTest, &timing, &resources);
     }
-
-    /* clear jmp_buf to not jump back to indless-loop for asserts failed during tear-down */
-    pTest->pJumpBuf = NULL;
-
-    if (NULL != f_pCurSuite->pTearDownFunc) {
-       (*f_pCurSuite->pTearDownFunc)();
+    else {
+      run_test_body(pTest, &timing, &resources);
     }
 
+    disarm_timeout();
+
     pRunSummary->nTestsRun++;
+    CU_shard_test_ran(f_pCurSuite, pTest);
+
+    notify_test_timing(f_pCurTest, f_pCurSuite, &timing);
+    notify_test_resources(f_pCurTest, f_pCurSuite, &resources);
   }
   else {
     f_run_summary.nTestsInactive++;
@@ -1032,9 +1530,7 @@ static CU_ErrorCode run_single_test(CU_pTest pTest, CU_pRunSummary pRunSummary)
     pLastFailure = NULL;                   /* no additional failure - set to NULL */
   }
 
-  if (NULL != f_pTestCompleteMessageHandler) {
-    (*f_pTestCompleteMessageHandler)(f_pCurTest, f_pCurSuite, pLastFailure);
-  }
+  notify_test_complete(f_pCurTest, f_pCurSuite, pLastFailure);
 
   pTest->pJumpBuf = NULL;
   f_pCurTest = NULL;
@@ -1042,47 +1538,1391 @@ static CU_ErrorCode run_single_test(CU_pTest pTest, CU_pRunSummary pRunSummary)
   return result;
 }
 
-/** @} */
+/*------------------------------------------------------------------------*/
+/**
+ *  Runs the setup function, the test function and the teardown function
+ *  of a test in the calling process.
+ *  Called by run_single_test(), and by run_test_in_worker() in workers.
+ *
+ *  @param pTest      The test to run (non-NULL).
+ *  @param pTiming    Receives the timings of the test (non-NULL).
+ *  @param pResources Receives the resources used by the test (non-NULL).
+ */
+static void run_test_body(CU_pTest pTest, CU_Timing* pTiming, CU_TestResources* pResources)
+{
+  volatile double dStartTime;
+  volatile CU_BOOL bCrashed = CU_FALSE;
+  volatile CU_BOOL bTimedOut = CU_FALSE;
+  double dPhaseStart;
+  clock_t cpuStart;
+  jmp_buf buf;
+#ifndef _WIN32
+  sigjmp_buf crashBuf;
+#endif
+  int iSuspended;
 
-#ifdef CUNIT_BUILD_TESTS
-#include "test_cunit.h"
+  assert(NULL != pTest);
+  assert(NULL != pTiming);
+  assert(NULL != pResources);
 
-/** Types of framework events tracked by test system. */
-typedef enum TET {
-  SUITE_START = 1,
-  TEST_START,
-  TEST_COMPLETE,
-  SUITE_COMPLETE,
-  ALL_TESTS_COMPLETE,
-  SUITE_INIT_FAILED,
-  SUITE_CLEANUP_FAILED
-} TestEventType;
+  dPhaseStart = CU_get_monotonic_time();
+  if (NULL != f_pCurSuite->pSetUpFunc) {
+    (*f_pCurSuite->pSetUpFunc)();
+  }
+  pTiming->dSetUp = CU_get_monotonic_time() - dPhaseStart;
 
-/** Test event structure for recording details of a framework event. */
-typedef struct TE {
-  TestEventType     type;
-  CU_pSuite         pSuite;
-  CU_pTest          pTest;
-  CU_pFailureRecord pFailure;
-  struct TE *       pNext;
-} TestEvent, * pTestEvent;
+  /* sweep from the state after setup, before the regular run */
+  if ((NULL != pTest->pAllocFail) && (NULL == pTest->pLoad) &&
+      (NULL == pTest->pSoak) && (NULL != pTest->pTestFunc)) {
+    run_alloc_failure_sweep(pTest);
+  }
 
-static int f_nTestEvents = 0;
-static pTestEvent f_pFirstEvent = NULL;
+  /* set jmp_buf and run test - duration excludes setup and teardown */
+  pTest->pJumpBuf = &buf;
+  CU_alloc_begin_test();
+  cpuStart = clock();
+  dStartTime = CU_get_monotonic_time();
+  if (0 == setjmp(buf)) {
+    if ((NULL != pTest->pLoad) && (NULL != pTest->pTestFunc)) {
+      iSuspended = CU_alloc_set_suspended(1);
+      f_pAssertMutex = CU_mutex_create();
+      if ((NULL == f_pAssertMutex) || (CUE_SUCCESS != CU_run_load(pTest))) {
+        add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                    0, _("Load test could not be started"), _("CUnit System"), f_pCurSuite, f_pCurTest);
+      }
+      CU_mutex_destroy(f_pAssertMutex);
+      f_pAssertMutex = NULL;
+      CU_alloc_set_suspended(iSuspended);
+    }
+    else if ((NULL != pTest->pSoak) && (NULL != pTest->pTestFunc)) {
+      iSuspended = CU_alloc_set_suspended(1);
+      run_soak_test(pTest);
+      CU_alloc_set_suspended(iSuspended);
+    }
+#ifndef _WIN32
+    else if ((NULL != pTest->pTestFunc) && (CU_FALSE == CU_is_isolation_worker())
+             && ((CU_FALSE != f_bCrashHandlersInstalled) || (0 != f_uiArmedTimeout))) {
+      /* the crash handler and timeout_interrupt() jump back here */
+      switch (sigsetjmp(crashBuf, 1)) {
+        case 0:
+          f_pCrashJumpBuf = &crashBuf;
+          f_bTimeoutAbortable = CU_TRUE;
+          (*pTest->pTestFunc)();
+          break;
+        case 1:
+          bCrashed = CU_TRUE;
+          break;
+        default:
+          bTimedOut = CU_TRUE;
+          break;
+      }
+      f_bTimeoutAbortable = CU_FALSE;
+    }
+#endif
+    else if (NULL != pTest->pTestFunc) {
+      (*pTest->pTestFunc)();
+    }
+  }
+#ifndef _WIN32
+  f_pCrashJumpBuf = NULL;
+#endif
+  pTest->dDuration = CU_get_monotonic_time() - dStartTime;
+  pResources->dCpuTime = ((double)clock() - (double)cpuStart)/(double)CLOCKS_PER_SEC;
+  CU_alloc_end_test(pTest);
+
+  if (CU_FALSE != bCrashed) {
+    add_crash_failure();
+  }
+  if ((CU_FALSE != bTimedOut) && (CU_FALSE != take_timeout())) {
+    add_timeout_failure();
+    CU_watchdog_disarm();
+    arm_timeout(TIMEOUT_TEST, f_uiArmedTimeout);    /* the teardown function gets a timeout of its own */
+  }
 
-/** Creates & stores a test event record having the specified details. */
-static void add_test_event(TestEventType type, CU_pSuite psuite,
-                           CU_pTest ptest, CU_pFailureRecord pfailure)
-{
-  pTestEvent pNewEvent = (pTestEvent)malloc(sizeof(TestEvent));
-  pTestEvent pNextEvent = f_pFirstEvent;
+  /* clear jmp_buf to not jump back to indless-loop for asserts failed during tear-down */
+  pTest->pJumpBuf = NULL;
 
-  if (NULL == pNewEvent) {
-    fprintf(stderr, "Memory allocation failed in add_test_event().");
-    exit(1);
+  dPhaseStart = CU_get_monotonic_time();
+  if (NULL != f_pCurSuite->pTearDownFunc) {
+     (*f_pCurSuite->pTearDownFunc)();
   }
+  pTiming->dTearDown = CU_get_monotonic_time() - dPhaseStart;
 
-  pNewEvent->type = type;
+  pTiming->dRun = pTest->dDuration;
+  pResources->pAllocStats = CU_get_alloc_stats(pTest);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Runs a test in an isolated worker and records its results as if it
+ *  had run in the test program, with a failure if the worker died or
+ *  the test exceeded one of its limits.  Called by run_single_test()
+ *  for the tests of isolated suites and the tests with limits.
+ *
+ *  @param pTest      The test to run (non-NULL).
+ *  @param pTiming    Receives the timings of the test (non-NULL).
+ *  @param pResources Receives the resources used by the test (non-NULL).
+ */
+static void run_isolated_test(CU_pTest pTest, CU_Timing* pTiming, CU_TestResources* pResources)
+{
+  CU_IsolatedResult result;
+  CU_ErrorCode error;
+  char szMessage[128];
+
+  assert(NULL != pTest);
+  assert(NULL != pTiming);
+  assert(NULL != pResources);
+
+  /* a test with limits in a suite that is not isolated */
+  if (CU_FALSE == f_bIsolatedSuite) {
+    CU_isolation_begin_suite(run_test_in_worker, 0);
+    error = CU_isolation_run_test(pTest, add_isolated_failure, &result);
+    CU_isolation_end_suite();
+  }
+  else {
+    error = CU_isolation_run_test(pTest, add_isolated_failure, &result);
+  }
+
+  if (CUE_SUCCESS != error) {
+    add_failure(&f_failure_list, &f_run_summary, CUF_WorkerFailed,
+                0, _("Isolated worker could not be started"), _("CUnit System"), f_pCurSuite, f_pCurTest);
+  }
+  else if (CU_LIMIT_NONE != result.exceeded) {
+    add_limit_failure(pTest->pLimits, &result);
+  }
+  else if (CU_FALSE == result.bCompleted) {
+    if (0 != result.iSignal) {
+      snprintf(szMessage, sizeof(szMessage), _("Test crashed in isolated worker: signal %d (%s)"),
+               result.iSignal, CU_get_signal_name(result.iSignal));
+    }
+    else {
+      snprintf(szMessage, sizeof(szMessage), _("Test exited in isolated worker with status %d"),
+               result.iExitStatus);
+    }
+    /* only the worker died, so unlike in-process crashes the run is not tainted */
+    szMessage[sizeof(szMessage) - 1] = '\0';
+    add_failure(&f_failure_list, &f_run_summary, CUF_TestCrashed,
+                0, szMessage, _("CUnit System"), f_pCurSuite, f_pCurTest);
+  }
+
+  f_run_summary.nAsserts += result.nAsserts;
+  f_run_summary.nAssertsFailed += result.nAssertsFailed;
+
+  pTest->dDuration = result.dRun;
+  pTiming->dSetUp = result.dSetUp;
+  pTiming->dRun = result.dRun;
+  pTiming->dTearDown = result.dTearDown;
+  pResources->dCpuTime = result.dCpuTime;
+  pResources->pAllocStats = NULL;     /* kept by the worker */
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Records the failure of a test that exceeded one of its limits, with
+ *  the failure type of the limit and the observed peak.
+ */
+static void add_limit_failure(const CU_TestLimits* pLimits, const CU_IsolatedResult* pResult)
+{
+  CU_FailureType type;
+  char szMessage[160];
+
+  switch (pResult->exceeded) {
+    case CU_LIMIT_MEMORY:
+      type = CUF_TestMemoryLimit;
+      snprintf(szMessage, sizeof(szMessage), _("Test exceeded its memory limit of %.0f bytes (peak %.0f bytes)"),
+               (double)pLimits->szMaxRss, pResult->dPeakRss);
+      break;
+    case CU_LIMIT_CPU:
+      type = CUF_TestCpuLimit;
+      snprintf(szMessage, sizeof(szMessage), _("Test exceeded its processor time limit of %u s (used %.2f s)"),
+               pLimits->uiMaxCpuSeconds, pResult->dPeakCpu);
+      break;
+    case CU_LIMIT_OPEN_FILES:
+      type = CUF_TestOpenFilesLimit;
+      snprintf(szMessage, sizeof(szMessage), _("Test exceeded its open file limit of %u (peak %u)"),
+               pLimits->uiMaxOpenFiles, pResult->uiPeakOpenFiles);
+      break;
+    default:
+      type = CUF_TestThreadsLimit;
+      snprintf(szMessage, sizeof(szMessage), _("Test exceeded its thread limit of %u (peak %u)"),
+               pLimits->uiMaxThreads, pResult->uiPeakThreads);
+      break;
+  }
+  szMessage[sizeof(szMessage) - 1] = '\0';
+  add_failure(&f_failure_list, &f_run_summary, type,
+              0, szMessage, _("CUnit System"), f_pCurSuite, f_pCurTest);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Runs a test inside an isolated worker (CU_IsolatedTestFunc).
+ *  The worker's copy of the run summary counts the assertions of this
+ *  test only.
+ *
+ *  @param pTest   The test to run (non-NULL).
+ *  @param pResult Receives the counts and timings of the test (non-NULL).
+ */
+static void run_test_in_worker(CU_pTest pTest, CU_IsolatedResult* pResult)
+{
+  CU_Timing timing = {0.0, 0.0, 0.0};
+  CU_TestResources resources;
+
+  f_pCurTest = pTest;
+  f_run_summary.nAsserts = 0;
+  f_run_summary.nAssertsFailed = 0;
+
+  run_test_body(pTest, &timing, &resources);
+
+  pResult->nAsserts = f_run_summary.nAsserts;
+  pResult->nAssertsFailed = f_run_summary.nAssertsFailed;
+  pResult->dSetUp = timing.dSetUp;
+  pResult->dRun = timing.dRun;
+  pResult->dTearDown = timing.dTearDown;
+  pResult->dCpuTime = resources.dCpuTime;
+  f_pCurTest = NULL;
+}
+
+/*------------------------------------------------------------------------*/
+/** Records a failure streamed back by an isolated worker (CU_IsolatedFailureFunc). */
+static void add_isolated_failure(CU_FailureType type, unsigned int uiLine,
+                                 const char* szCondition, const char* szFile)
+{
+  add_failure(&f_failure_list, &f_run_summary, type,
+              uiLine, szCondition, szFile, f_pCurSuite, f_pCurTest);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Starts the isolated workers of a suite, if isolation is selected or
+ *  the suite is snapshotted (see CU_set_suite_snapshot()).  Called after
+ *  the suite setup function, so workers start from the suite fixture.
+ */
+static void begin_isolated_suite(CU_pSuite pSuite)
+{
+  unsigned int uiBatchSize = pSuite->uiSnapshotBatch;
+
+  if ((0 == uiBatchSize) && (CU_ISOLATION_NONE != CU_get_isolation_mode())) {
+    uiBatchSize = CU_get_isolation_batch_size();
+  }
+  if ((0 != uiBatchSize) && (CU_FALSE == CU_is_isolation_worker())) {
+    /* a failed start is recorded against each test */
+    CU_isolation_begin_suite(run_test_in_worker, uiBatchSize);
+    f_bIsolatedSuite = CU_TRUE;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Stops the isolated workers of the current suite, if any. */
+static void end_isolated_suite(void)
+{
+  if (CU_FALSE != f_bIsolatedSuite) {
+    CU_isolation_end_suite();
+    f_bIsolatedSuite = CU_FALSE;
+  }
+}
+
+#ifndef _WIN32
+/*------------------------------------------------------------------------*/
+/**
+ *  Handler of the crash signals.  Jumps back into run_test_body() if a
+ *  test function with crash capture armed is running on this thread;
+ *  otherwise restores the previous action and raises the signal again,
+ *  so crashes outside test functions behave as without crash capture.
+ */
+static void crash_signal_handler(int iSignal)
+{
+  sigjmp_buf* pJump = f_pCrashJumpBuf;
+  int i;
+
+  if (NULL != pJump) {
+    f_pCrashJumpBuf = NULL;
+    f_iCrashSignal = iSignal;
+#ifdef __GLIBC__
+    f_iCrashFrames = backtrace(f_apCrashFrames, CU_CRASH_MAX_FRAMES + 2);
+#else
+    f_iCrashFrames = 0;
+#endif
+    siglongjmp(*pJump, 1);
+  }
+
+  for (i = 0 ; i < N_CRASH_SIGNALS ; ++i) {
+    if (f_aiCrashSignals[i] == iSignal) {
+      sigaction(iSignal, &f_aOldCrashActions[i], NULL);
+      break;
+    }
+  }
+  raise(iSignal);
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Installs the crash signal handlers on an alternate signal stack, if
+ *  crash capture is enabled.  Called at the start of each test run.
+ */
+static void install_crash_handlers(void)
+{
+#ifndef _WIN32
+  struct sigaction action;
+  stack_t stack;
+  size_t szStack = (SIGSTKSZ > 65536) ? (size_t)SIGSTKSZ : (size_t)65536;
+  int i;
+
+  if ((CU_FALSE == f_bCaptureCrashes) || (CU_FALSE != f_bCrashHandlersInstalled)) {
+    return;
+  }
+
+  f_pCrashStack = CU_MALLOC(szStack);
+  if (NULL == f_pCrashStack) {
+    return;
+  }
+  stack.ss_sp = f_pCrashStack;
+  stack.ss_size = szStack;
+  stack.ss_flags = 0;
+  if (0 != sigaltstack(&stack, &f_oldCrashStack)) {
+    CU_FREE(f_pCrashStack);
+    f_pCrashStack = NULL;
+    return;
+  }
+
+#ifdef __GLIBC__
+  /* the first call loads libgcc, which is not safe in a signal handler */
+  f_iCrashFrames = backtrace(f_apCrashFrames, 1);
+#endif
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = crash_signal_handler;
+  action.sa_flags = SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+  for (i = 0 ; i < N_CRASH_SIGNALS ; ++i) {
+    sigaction(f_aiCrashSignals[i], &action, &f_aOldCrashActions[i]);
+  }
+  f_bCrashHandlersInstalled = CU_TRUE;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+/** Restores the signal actions replaced by install_crash_handlers(). */
+static void remove_crash_handlers(void)
+{
+#ifndef _WIN32
+  int i;
+
+  if (CU_FALSE == f_bCrashHandlersInstalled) {
+    return;
+  }
+
+  for (i = 0 ; i < N_CRASH_SIGNALS ; ++i) {
+    sigaction(f_aiCrashSignals[i], &f_aOldCrashActions[i], NULL);
+  }
+  sigaltstack(&f_oldCrashStack, NULL);
+  CU_FREE(f_pCrashStack);
+  f_pCrashStack = NULL;
+  f_bCrashHandlersInstalled = CU_FALSE;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Records a CUF_TestCrashed failure for the current test with the
+ *  signal and backtrace left by crash_signal_handler().
+ */
+static void add_crash_failure(void)
+{
+#ifndef _WIN32
+  char szMessage[4096];
+  int iSignal = (int)f_iCrashSignal;
+#ifdef __GLIBC__
+  size_t szLength;
+  char** ppSymbols;
+  int i;
+#endif
+
+  snprintf(szMessage, sizeof(szMessage), _("Test crashed: signal %d (%s)"),
+           iSignal, CU_get_signal_name(iSignal));
+  szMessage[sizeof(szMessage) - 1] = '\0';
+
+#ifdef __GLIBC__
+  /* skip the signal handler and the signal trampoline */
+  if (f_iCrashFrames > 2) {
+    ppSymbols = backtrace_symbols(f_apCrashFrames + 2, f_iCrashFrames - 2);
+    if (NULL != ppSymbols) {
+      for (i = 0 ; i < f_iCrashFrames - 2 ; ++i) {
+        szLength = strlen(szMessage);
+        snprintf(szMessage + szLength, sizeof(szMessage) - szLength, "\n  %s", ppSymbols[i]);
+      }
+      free(ppSymbols);
+    }
+  }
+#endif
+
+  add_failure(&f_failure_list, &f_run_summary, CUF_TestCrashed,
+              0, szMessage, _("CUnit System"), f_pCurSuite, f_pCurTest);
+  ++f_run_summary.nTestsCrashed;
+  f_iCrashSignal = 0;
+  f_iCrashFrames = 0;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Interrupts a test function that timed out (CU_WatchdogInterruptFunc).
+ *  Runs in a signal handler on the thread running the tests and jumps
+ *  back into run_test_body() if the test function is still running.
+ */
+static void timeout_interrupt(void)
+{
+#ifndef _WIN32
+  sigjmp_buf* pJump = f_pCrashJumpBuf;
+
+  if ((NULL != pJump) && (CU_FALSE != f_bTimeoutAbortable)) {
+    f_pCrashJumpBuf = NULL;
+    siglongjmp(*pJump, 2);
+  }
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Claims the handling of an expired timeout.  The thread running the
+ *  tests claims it when it gets back from the function that timed out,
+ *  the watchdog thread when it does not within TIMEOUT_GRACE_TIME.
+ *  @return CU_TRUE if the calling thread is to handle the timeout.
+ */
+static CU_BOOL claim_timeout(unsigned long ulDeadline)
+{
+  CU_BOOL bClaimed = CU_FALSE;
+
+  CU_mutex_lock(f_pTimeoutMutex);
+  if ((ulDeadline == f_ulTimeoutDeadline) && (CU_FALSE == f_bTimeoutClaimed)) {
+    f_bTimeoutClaimed = CU_TRUE;
+    bClaimed = CU_TRUE;
+  }
+  CU_mutex_unlock(f_pTimeoutMutex);
+  return bClaimed;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Builds the condition of a timeout failure.
+ *  @return A string allocated with CU_MALLOC(), or NULL if out of memory.
+ */
+static char* timeout_message(const char* szStacks)
+{
+  size_t szLength = strlen(szStacks) + 128;
+  char* szMessage = (char*)CU_MALLOC(szLength);
+
+  if (NULL != szMessage) {
+    snprintf(szMessage, szLength, "%s %u ms\n%s",
+             (TIMEOUT_SUITE_INIT == f_timeoutPhase) ? _("Suite initialization timed out after") :
+             (TIMEOUT_SUITE_CLEANUP == f_timeoutPhase) ? _("Suite cleanup timed out after") :
+             _("Test timed out after"),
+             f_uiArmedTimeout, szStacks);
+    szMessage[szLength - 1] = '\0';
+    szLength = strlen(szMessage);
+    if ((0 < szLength) && ('\n' == szMessage[szLength - 1])) {
+      szMessage[szLength - 1] = '\0';
+    }
+  }
+  return szMessage;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Records the failure of a timeout that is not handled by abandoning
+ *  a test function, completes the reports and ends the test program.
+ *  Runs on the thread running the tests, or on the watchdog thread if
+ *  that thread is stuck.
+ */
+static void terminate_on_timeout(void)
+{
+  char* szMessage = timeout_message((NULL != f_szTimeoutStacks) ? f_szTimeoutStacks : "");
+  const char* szCondition = (NULL != szMessage) ? szMessage : _("Timed out");
+  CU_pFailureRecord pFirstFailure;
+
+  fprintf(stderr, "\n%s\n%s\n", szCondition, _("Terminating the test run."));
+
+  switch (f_timeoutPhase) {
+    case TIMEOUT_SUITE_INIT:
+      add_failure(&f_failure_list, &f_run_summary, CUF_SuiteInitFailed,
+                  0, szCondition, _("CUnit System"), f_pCurSuite, NULL);
+      f_run_summary.nSuitesFailed++;
+      notify_suite_init_failure(f_pCurSuite);
+      break;
+
+    case TIMEOUT_SUITE_CLEANUP:
+      add_failure(&f_failure_list, &f_run_summary, CUF_SuiteCleanupFailed,
+                  0, szCondition, _("CUnit System"), f_pCurSuite, NULL);
+      f_run_summary.nSuitesFailed++;
+      notify_suite_cleanup_failure(f_pCurSuite);
+      break;
+
+    default:
+      add_failure(&f_failure_list, &f_run_summary, CUF_TestTimeout,
+                  0, szCondition, _("CUnit System"), f_pCurSuite, f_pCurTest);
+      f_run_summary.nTestsRun++;
+      f_run_summary.nTestsFailed++;
+      pFirstFailure = (NULL != f_pTimeoutLastFailure) ? f_pTimeoutLastFailure->pNext : f_failure_list;
+      notify_test_complete(f_pCurTest, f_pCurSuite, pFirstFailure);
+      break;
+  }
+
+  f_run_summary.ElapsedTime = ((double)clock() - (double)f_start_time)/(double)CLOCKS_PER_SEC;
+  notify_all_tests_complete(f_failure_list);
+  flush_event_queue(5.0);
+  exit(EXIT_FAILURE);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Handles an expired timeout claimed by the thread running the tests:
+ *  records the failure of a test function if the timeout action allows
+ *  the run to go on, or ends the test program.
+ */
+static void handle_timeout(void)
+{
+  double dEnd = CU_get_monotonic_time() + TIMEOUT_GRACE_TIME;
+  CU_BOOL bReady = CU_FALSE;
+
+  /* the watchdog may still be taking the stack traces */
+  while ((CU_FALSE == bReady) && (CU_get_monotonic_time() < dEnd)) {
+    CU_mutex_lock(f_pTimeoutMutex);
+    bReady = (NULL != f_szTimeoutStacks) ? CU_TRUE : CU_FALSE;
+    CU_mutex_unlock(f_pTimeoutMutex);
+    if (CU_FALSE == bReady) {
+      CU_sleep(0.001);
+    }
+  }
+
+  if ((TIMEOUT_TEST == f_timeoutPhase) && (CU_TIMEOUT_ABORT_TEST == CU_get_timeout_action())) {
+    add_timeout_failure();
+  }
+  else {
+    terminate_on_timeout();
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Handles a timeout reported by the watchdog (CU_WatchdogExpiredFunc).
+ *  Keeps the stack traces for the failure, interrupts a test function
+ *  that may be abandoned and ends the test program if the thread
+ *  running the tests does not get back within TIMEOUT_GRACE_TIME.
+ */
+static void timeout_expired(unsigned long ulDeadline, const char* szStacks)
+{
+  char* szCopy = (char*)CU_MALLOC(strlen(szStacks) + 1);
+  CU_BOOL bCurrent;
+  CU_BOOL bHandled = CU_FALSE;
+  double dEnd;
+
+  if (NULL != szCopy) {
+    strcpy(szCopy, szStacks);
+  }
+
+  CU_mutex_lock(f_pTimeoutMutex);
+  bCurrent = ((ulDeadline == f_ulTimeoutDeadline) && (CU_FALSE == f_bTimeoutClaimed)) ? CU_TRUE : CU_FALSE;
+  if ((CU_FALSE != bCurrent) && (NULL == f_szTimeoutStacks)) {
+    f_szTimeoutStacks = szCopy;
+    szCopy = NULL;
+  }
+  CU_mutex_unlock(f_pTimeoutMutex);
+  if (NULL != szCopy) {
+    CU_FREE(szCopy);
+  }
+  if (CU_FALSE == bCurrent) {
+    return;
+  }
+
+  if ((TIMEOUT_TEST == f_timeoutPhase) && (CU_TIMEOUT_ABORT_TEST == CU_get_timeout_action()) &&
+      (CU_FALSE != f_bTimeoutAbortable)) {
+    CU_watchdog_interrupt();
+  }
+
+  dEnd = CU_get_monotonic_time() + TIMEOUT_GRACE_TIME;
+  while ((CU_FALSE == bHandled) && (CU_get_monotonic_time() < dEnd)) {
+    CU_sleep(0.005);
+    CU_mutex_lock(f_pTimeoutMutex);
+    bHandled = ((ulDeadline != f_ulTimeoutDeadline) || (CU_FALSE != f_bTimeoutClaimed)) ? CU_TRUE : CU_FALSE;
+    CU_mutex_unlock(f_pTimeoutMutex);
+  }
+
+  if ((CU_FALSE == bHandled) && (CU_FALSE != claim_timeout(ulDeadline))) {
+    terminate_on_timeout();
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Arms the watchdog for the functions of a phase, if a timeout applies.
+ *  Not armed in isolated workers, which are watched by the test program.
+ */
+static void arm_timeout(TimeoutPhase phase, unsigned int uiMilliseconds)
+{
+  if ((0 == uiMilliseconds) || (CU_FALSE != CU_is_isolation_worker())) {
+    return;
+  }
+  if ((NULL == f_pTimeoutMutex) && (NULL == (f_pTimeoutMutex = CU_mutex_create()))) {
+    return;                       /* run without a timeout */
+  }
+
+  CU_mutex_lock(f_pTimeoutMutex);
+  ++f_ulTimeoutDeadline;
+  f_bTimeoutClaimed = CU_FALSE;
+  if (NULL != f_szTimeoutStacks) {
+    CU_FREE(f_szTimeoutStacks);
+    f_szTimeoutStacks = NULL;
+  }
+  CU_mutex_unlock(f_pTimeoutMutex);
+
+  f_timeoutPhase = phase;
+  f_uiArmedTimeout = uiMilliseconds;
+  if (CUE_SUCCESS != CU_watchdog_arm(uiMilliseconds, f_ulTimeoutDeadline, timeout_expired, timeout_interrupt)) {
+    f_uiArmedTimeout = 0;         /* run without a timeout */
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Claims an expired timeout on the thread running the tests, or waits
+ *  for the watchdog thread to end the test program if it claimed it.
+ *  @return CU_TRUE if the timeout is to be handled by the caller.
+ */
+static CU_BOOL take_timeout(void)
+{
+  if (CU_FALSE != claim_timeout(f_ulTimeoutDeadline)) {
+    return CU_TRUE;
+  }
+  for (;;) {
+    CU_sleep(1.0);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Disarms the watchdog armed by arm_timeout(), if any, and handles
+ *  the timeout if it expired while the function was running.
+ */
+static void disarm_timeout(void)
+{
+  if (0 == f_uiArmedTimeout) {
+    return;
+  }
+
+  if ((CU_FALSE != CU_watchdog_disarm()) && (CU_FALSE != take_timeout())) {
+    handle_timeout();
+  }
+  f_uiArmedTimeout = 0;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Records a CUF_TestTimeout failure for the current test with the
+ *  stack traces taken by the watchdog.
+ */
+static void add_timeout_failure(void)
+{
+  char* szMessage = timeout_message((NULL != f_szTimeoutStacks) ? f_szTimeoutStacks : "");
+
+  add_failure(&f_failure_list, &f_run_summary, CUF_TestTimeout,
+              0, (NULL != szMessage) ? szMessage : _("Test timed out"),
+              _("CUnit System"), f_pCurSuite, f_pCurTest);
+  if (NULL != szMessage) {
+    CU_FREE(szMessage);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Stops the watchdog at the end of a test run. */
+static void stop_timeouts(void)
+{
+  CU_watchdog_stop();
+  if (NULL != f_pTimeoutMutex) {
+    if (NULL != f_szTimeoutStacks) {
+      CU_FREE(f_szTimeoutStacks);
+      f_szTimeoutStacks = NULL;
+    }
+    CU_mutex_destroy(f_pTimeoutMutex);
+    f_pTimeoutMutex = NULL;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Calls a suite initialization or cleanup function under the default
+ *  timeout.
+ *  @return The return value of pFunc, 0 if pFunc is NULL.
+ */
+static int run_suite_function(CU_InitializeFunc pFunc, TimeoutPhase phase)
+{
+  int iStatus;
+
+  if (NULL == pFunc) {
+    return 0;
+  }
+
+  arm_timeout(phase, CU_get_default_test_timeout());
+  iStatus = (*pFunc)();
+  disarm_timeout();
+  return iStatus;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Runs the soak loop of a soak test and records a failure for each
+ *  metric that grew monotonically beyond its threshold.
+ *  Called by run_single_test() in place of the test function.
+ *
+ *  @param pTest The soak test to run (non-NULL).
+ */
+static void run_soak_test(CU_pTest pTest)
+{
+  const CU_SoakResult* pResult;
+  char szMessage[256];
+  int i;
+
+  assert(NULL != pTest);
+  assert(NULL != pTest->pSoak);
+
+  if (CUE_SUCCESS != CU_run_soak(pTest)) {
+    add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                0, _("Soak test could not be started"), _("CUnit System"), f_pCurSuite, f_pCurTest);
+    return;
+  }
+
+  pResult = CU_get_soak_result(pTest);
+  for (i = 0 ; i < CU_SOAK_METRICS ; ++i) {
+    if (CU_FALSE != pResult->abLeak[i]) {
+      snprintf(szMessage, sizeof(szMessage),
+               _("Soak test: %s grew monotonically by %.0f (%.1f/s) over %.1f s, limit %.0f"),
+               CU_get_soak_metric_name((CU_SoakMetric)i), pResult->adGrowth[i],
+               pResult->adSlope[i], pResult->dElapsedTime, pTest->pSoak->adThreshold[i]);
+      szMessage[sizeof(szMessage) - 1] = '\0';
+      add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                  0, szMessage, _("CUnit System"), f_pCurSuite, f_pCurTest);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Runs the allocation failure sweep of a test and records a failure
+ *  for each failure point at which the test misbehaved.
+ *  Called by run_single_test() after the suite setup function.
+ *
+ *  @param pTest The test to sweep (non-NULL).
+ */
+static void run_alloc_failure_sweep(CU_pTest pTest)
+{
+  const CU_AllocFailResult* pResult;
+  const CU_AllocFailPoint* pPoint;
+  unsigned long ulProblems;
+  char szSite[256];
+  char szOutcome[128];
+  char szMessage[512];
+  unsigned int i;
+
+  assert(NULL != pTest);
+  assert(NULL != pTest->pAllocFail);
+
+  /* leave the event writer idle while the sweep forks */
+  flush_event_queue(-1.0);
+
+  if (CUE_SUCCESS != CU_run_alloc_failure_sweep(pTest)) {
+    add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                0, _("Allocation failure sweep could not be started"), _("CUnit System"), f_pCurSuite, f_pCurTest);
+    return;
+  }
+
+  pResult = CU_get_alloc_failure_result(pTest);
+  for (i = 0 ; i < pResult->uiReports ; ++i) {
+    pPoint = &pResult->aReports[i];
+    switch (pPoint->outcome) {
+      case CU_ALLOC_FAIL_CRASH:
+        snprintf(szOutcome, sizeof(szOutcome), _("crashed (signal %d)"), pPoint->iStatus);
+        break;
+      case CU_ALLOC_FAIL_HANG:
+        snprintf(szOutcome, sizeof(szOutcome), _("did not complete within %d s"), CU_ALLOC_FAIL_TIMEOUT);
+        break;
+      case CU_ALLOC_FAIL_EXIT:
+        snprintf(szOutcome, sizeof(szOutcome), _("exited (status %d)"), pPoint->iStatus);
+        break;
+      default:
+        snprintf(szOutcome, sizeof(szOutcome), _("leaked %lu allocation(s) (%lu bytes)"),
+                 pPoint->ulLeaked, (unsigned long)pPoint->szLeakedBytes);
+        break;
+    }
+
+    if (0 == pPoint->ulPoint) {
+      snprintf(szMessage, sizeof(szMessage),
+               _("Allocation failure sweep: test %s without a failed allocation"), szOutcome);
+    }
+    else {
+      CU_format_alloc_site(&pPoint->site, szSite, sizeof(szSite));
+      snprintf(szMessage, sizeof(szMessage),
+               _("Allocation failure sweep: test %s when allocation %lu of %lu (%lu bytes) failed at %s"),
+               szOutcome, pPoint->ulPoint, pResult->ulPoints, (unsigned long)pPoint->site.szBytes, szSite);
+    }
+    add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                0, szMessage, _("CUnit System"), f_pCurSuite, f_pCurTest);
+  }
+
+  ulProblems = pResult->ulCrashes + pResult->ulHangs + pResult->ulExits + pResult->ulLeaks;
+  if (ulProblems > pResult->uiReports) {
+    snprintf(szMessage, sizeof(szMessage),
+             _("Allocation failure sweep: %lu more failure point(s) not reported"),
+             ulProblems - pResult->uiReports);
+    add_failure(&f_failure_list, &f_run_summary, CUF_AssertFailed,
+                0, szMessage, _("CUnit System"), f_pCurSuite, f_pCurTest);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Appends a listener to the rows of the listener tables for an event.
+ *
+ *  @param event     The event.
+ *  @param bHandles  CU_TRUE if the listener has a callback for event.
+ *  @param pEntry    The registered listener (non-NULL).
+ */
+static void add_event_listener(CU_ListenerEvent event, CU_BOOL bHandles, const CU_ListenerEntry* pEntry)
+{
+  if (CU_FALSE != bHandles) {
+    f_aapEventListeners[event][f_anEventListeners[event]++] = pEntry;
+    if (0 != (pEntry->pListener->uiFlags & CU_LISTENER_SYNCHRONOUS)) {
+      f_aapSyncEventListeners[event][f_anSyncEventListeners[event]++] = pEntry;
+    }
+    else {
+      f_aapAsyncEventListeners[event][f_anAsyncEventListeners[event]++] = pEntry;
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Rebuilds the per-event listener lists after a listener is added or
+ *  removed, so that dispatching an event only visits the listeners
+ *  having a callback for it.
+ */
+static void rebuild_listener_tables(void)
+{
+  const CU_ListenerEntry* pEntry;
+  const CU_Listener* pListener;
+  unsigned int i;
+
+  memset(f_anEventListeners, 0, sizeof(f_anEventListeners));
+  memset(f_anSyncEventListeners, 0, sizeof(f_anSyncEventListeners));
+  memset(f_anAsyncEventListeners, 0, sizeof(f_anAsyncEventListeners));
+  for (i = 0 ; i < f_nListeners ; ++i) {
+    pEntry = &f_aListeners[i];
+    pListener = pEntry->pListener;
+    add_event_listener(EVENT_SUITE_START, (NULL != pListener->pSuiteStart) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_TEST_START, (NULL != pListener->pTestStart) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_TEST_COMPLETE, (NULL != pListener->pTestComplete) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_SUITE_COMPLETE, (NULL != pListener->pSuiteComplete) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_ALL_TESTS_COMPLETE, (NULL != pListener->pAllTestsComplete) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_SUITE_INIT_FAILURE, (NULL != pListener->pSuiteInitFailure) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_SUITE_CLEANUP_FAILURE, (NULL != pListener->pSuiteCleanupFailure) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_TEST_TIMING, (NULL != pListener->pTestTiming) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_SUITE_TIMING, (NULL != pListener->pSuiteTiming) ? CU_TRUE : CU_FALSE, pEntry);
+    add_event_listener(EVENT_TEST_RESOURCES, (NULL != pListener->pTestResources) ? CU_TRUE : CU_FALSE, pEntry);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Calls the callbacks of a list of listeners for an event.
+ *
+ *  @param pRecord   The event (non-NULL).
+ *  @param ppEntries Listeners having a callback for the event.
+ *  @param nEntries  Number of entries in ppEntries.
+ */
+static void dispatch_event(const CU_EventRecord* pRecord,
+                           const CU_ListenerEntry* const* ppEntries,
+                           unsigned int nEntries)
+{
+  const CU_Listener* pListener;
+  void* pContext;
+  unsigned int i;
+
+  for (i = 0 ; i < nEntries ; ++i) {
+    pListener = ppEntries[i]->pListener;
+    pContext = ppEntries[i]->pContext;
+    switch (pRecord->event) {
+      case EVENT_SUITE_START:
+        (*pListener->pSuiteStart)(pContext, pRecord->pSuite);
+        break;
+      case EVENT_TEST_START:
+        (*pListener->pTestStart)(pContext, pRecord->pTest, pRecord->pSuite);
+        break;
+      case EVENT_TEST_COMPLETE:
+        (*pListener->pTestComplete)(pContext, pRecord->pTest, pRecord->pSuite, pRecord->pFailure);
+        break;
+      case EVENT_SUITE_COMPLETE:
+        (*pListener->pSuiteComplete)(pContext, pRecord->pSuite, pRecord->pFailure);
+        break;
+      case EVENT_ALL_TESTS_COMPLETE:
+        (*pListener->pAllTestsComplete)(pContext, pRecord->pFailure);
+        break;
+      case EVENT_SUITE_INIT_FAILURE:
+        (*pListener->pSuiteInitFailure)(pContext, pRecord->pSuite);
+        break;
+      case EVENT_SUITE_CLEANUP_FAILURE:
+        (*pListener->pSuiteCleanupFailure)(pContext, pRecord->pSuite);
+        break;
+      case EVENT_TEST_TIMING:
+        (*pListener->pTestTiming)(pContext, pRecord->pTest, pRecord->pSuite, &pRecord->timing);
+        break;
+      case EVENT_SUITE_TIMING:
+        (*pListener->pSuiteTiming)(pContext, pRecord->pSuite, &pRecord->timing);
+        break;
+      case EVENT_TEST_RESOURCES:
+        (*pListener->pTestResources)(pContext, pRecord->pTest, pRecord->pSuite, &pRecord->resources);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Copies a failure list from pFailure to its end, relinking the copies.
+ *  The strings are shared with the originals, which live until the
+ *  results of the run are cleared.
+ *
+ *  @param pFailure The first failure to copy (non-NULL).
+ *  @return The first copy (free the block with CU_FREE()), or NULL if
+ *          memory could not be allocated.
+ */
+static CU_pFailureRecord copy_failures(const CU_FailureRecord* pFailure)
+{
+  const CU_FailureRecord* pTemp;
+  CU_pFailureRecord pCopies;
+  size_t nFailures = 0;
+  size_t i;
+
+  for (pTemp = pFailure ; NULL != pTemp ; pTemp = pTemp->pNext) {
+    ++nFailures;
+  }
+
+  pCopies = (CU_pFailureRecord)CU_MALLOC(nFailures * sizeof(CU_FailureRecord));
+  if (NULL != pCopies) {
+    for (i = 0, pTemp = pFailure ; i < nFailures ; ++i, pTemp = pTemp->pNext) {
+      pCopies[i] = *pTemp;
+      pCopies[i].pPrev = (0 < i) ? &pCopies[i - 1] : NULL;
+      pCopies[i].pNext = (i + 1 < nFailures) ? &pCopies[i + 1] : NULL;
+    }
+  }
+  return pCopies;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Queues an event for the event writer, waiting while the queue is
+ *  full.  The failures of test and suite complete events are copied,
+ *  since the test thread goes on adding to the list.  If the copies
+ *  cannot be allocated, the event is delivered on the test thread once
+ *  the queue is empty.
+ *
+ *  @param pRecord The event (non-NULL).
+ */
+static void enqueue_event(const CU_EventRecord* pRecord)
+{
+  CU_EventRecord record = *pRecord;
+
+  if (((EVENT_TEST_COMPLETE == record.event) || (EVENT_SUITE_COMPLETE == record.event)) &&
+      (NULL != record.pFailure)) {
+    record.pFailure = copy_failures(pRecord->pFailure);
+    if (NULL == record.pFailure) {
+      flush_event_queue(-1.0);
+      dispatch_event(pRecord, f_aapAsyncEventListeners[record.event], f_anAsyncEventListeners[record.event]);
+      return;
+    }
+  }
+
+  CU_mutex_lock(f_pQueueMutex);
+  if (f_ulQueueHead - f_ulQueueTail >= f_uiQueueSize) {
+    ++f_ulQueueStalls;
+    while (f_ulQueueHead - f_ulQueueTail >= f_uiQueueSize) {
+      CU_cond_wait(f_pQueueNotFull, f_pQueueMutex, -1.0);
+    }
+  }
+  f_aEventQueue[f_ulQueueHead % f_uiQueueSize] = record;
+  ++f_ulQueueHead;
+  CU_cond_broadcast(f_pQueueNotEmpty);
+  CU_mutex_unlock(f_pQueueMutex);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Entry function of the event writer thread.  Delivers the queued
+ *  events in order to the listeners not flagged CU_LISTENER_SYNCHRONOUS
+ *  until stop_event_queue() is called and the queue is empty.
+ *  Allocations of the listeners are not accounted to the running test.
+ *
+ *  @param pArg Not used.
+ */
+static void event_writer(void* pArg)
+{
+  CU_EventRecord record;
+
+  CU_UNREFERENCED_PARAMETER(pArg);
+
+  f_bIsEventWriter = CU_TRUE;
+  CU_alloc_set_suspended(1);
+
+  CU_mutex_lock(f_pQueueMutex);
+  for (;;) {
+    while ((f_ulQueueTail == f_ulQueueHead) && (CU_FALSE == f_bQueueStop)) {
+      CU_cond_wait(f_pQueueNotEmpty, f_pQueueMutex, -1.0);
+    }
+    if (f_ulQueueTail == f_ulQueueHead) {
+      break;
+    }
+    record = f_aEventQueue[f_ulQueueTail % f_uiQueueSize];
+    CU_mutex_unlock(f_pQueueMutex);
+
+    dispatch_event(&record, f_aapAsyncEventListeners[record.event], f_anAsyncEventListeners[record.event]);
+    if (((EVENT_TEST_COMPLETE == record.event) || (EVENT_SUITE_COMPLETE == record.event)) &&
+        (NULL != record.pFailure)) {
+      CU_FREE(record.pFailure);
+    }
+
+    CU_mutex_lock(f_pQueueMutex);
+    ++f_ulQueueTail;
+    CU_cond_broadcast(f_pQueueNotFull);
+  }
+  CU_mutex_unlock(f_pQueueMutex);
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Starts the event writer at the start of a run if a queue size is set
+ *  and any listener is not flagged CU_LISTENER_SYNCHRONOUS.  If the
+ *  queue or the thread cannot be set up, listeners run on the test
+ *  thread as without a queue.
+ */
+static void start_event_queue(void)
+{
+  unsigned int nAsync = 0;
+  unsigned int i;
+
+  for (i = 0 ; i < N_LISTENER_EVENTS ; ++i) {
+    nAsync += f_anAsyncEventListeners[i];
+  }
+  if ((0 == f_uiQueueSize) || (0 == nAsync)) {
+    return;
+  }
+
+  f_ulQueueHead = 0;
+  f_ulQueueTail = 0;
+  f_ulQueueStalls = 0;
+  f_bQueueStop = CU_FALSE;
+  f_pQueueMutex = CU_mutex_create();
+  f_pQueueNotEmpty = CU_cond_create();
+  f_pQueueNotFull = CU_cond_create();
+  f_aEventQueue = (CU_EventRecord*)CU_MALLOC(f_uiQueueSize * sizeof(CU_EventRecord));
+  if ((NULL != f_pQueueMutex) && (NULL != f_pQueueNotEmpty) &&
+      (NULL != f_pQueueNotFull) && (NULL != f_aEventQueue)) {
+    f_pEventWriter = CU_thread_create(event_writer, NULL);
+  }
+
+  if (NULL == f_pEventWriter) {
+    if (NULL != f_aEventQueue) {
+      CU_FREE(f_aEventQueue);
+      f_aEventQueue = NULL;
+    }
+    CU_cond_destroy(f_pQueueNotFull);
+    CU_cond_destroy(f_pQueueNotEmpty);
+    CU_mutex_destroy(f_pQueueMutex);
+    f_pQueueNotFull = NULL;
+    f_pQueueNotEmpty = NULL;
+    f_pQueueMutex = NULL;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Ends the event writer at the end of a run, after it has delivered
+ *  all queued events (including the all tests complete event).
+ */
+static void stop_event_queue(void)
+{
+  if (NULL == f_aEventQueue) {
+    return;
+  }
+
+  CU_mutex_lock(f_pQueueMutex);
+  f_bQueueStop = CU_TRUE;
+  CU_cond_broadcast(f_pQueueNotEmpty);
+  CU_mutex_unlock(f_pQueueMutex);
+  CU_thread_join(f_pEventWriter);
+  f_pEventWriter = NULL;
+
+  CU_FREE(f_aEventQueue);
+  f_aEventQueue = NULL;
+  CU_cond_destroy(f_pQueueNotFull);
+  CU_cond_destroy(f_pQueueNotEmpty);
+  CU_mutex_destroy(f_pQueueMutex);
+  f_pQueueNotFull = NULL;
+  f_pQueueNotEmpty = NULL;
+  f_pQueueMutex = NULL;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Waits until the event writer has delivered all queued events.
+ *
+ *  @param dTimeout Maximum wait in seconds, negative to wait without limit.
+ *  @return CU_TRUE if the queue is empty, CU_FALSE on timeout or when
+ *          called on the event writer thread.
+ */
+static CU_BOOL flush_event_queue(double dTimeout)
+{
+  CU_BOOL bEmpty;
+  double dEnd = CU_get_monotonic_time() + dTimeout;
+  double dWait = dTimeout;
+
+  if (NULL == f_aEventQueue) {
+    return CU_TRUE;
+  }
+  if (CU_FALSE != f_bIsEventWriter) {
+    return CU_FALSE;
+  }
+
+  CU_mutex_lock(f_pQueueMutex);
+  while ((f_ulQueueTail != f_ulQueueHead) && ((dTimeout < 0.0) || (dWait > 0.0))) {
+    CU_cond_wait(f_pQueueNotFull, f_pQueueMutex, dWait);
+    if (dTimeout >= 0.0) {
+      dWait = dEnd - CU_get_monotonic_time();
+    }
+  }
+  bEmpty = (f_ulQueueTail == f_ulQueueHead) ? CU_TRUE : CU_FALSE;
+  CU_mutex_unlock(f_pQueueMutex);
+
+  return bEmpty;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Delivers an event to the registered listeners.  Without an event
+ *  writer all listeners are called in registration order.  Otherwise
+ *  the listeners flagged CU_LISTENER_SYNCHRONOUS are called now and the
+ *  event is queued for the others.
+ *
+ *  @param pRecord The event (non-NULL).
+ */
+static void post_event(const CU_EventRecord* pRecord)
+{
+  CU_ListenerEvent event = pRecord->event;
+
+  if (NULL == f_aEventQueue) {
+    dispatch_event(pRecord, f_aapEventListeners[event], f_anEventListeners[event]);
+  }
+  else {
+    dispatch_event(pRecord, f_aapSyncEventListeners[event], f_anSyncEventListeners[event]);
+    if (0 < f_anAsyncEventListeners[event]) {
+      enqueue_event(pRecord);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Fills in an event record for the notify_*() functions.
+ */
+static void init_event(CU_EventRecord* pRecord, CU_ListenerEvent event,
+                       CU_pSuite pSuite, CU_pTest pTest, CU_pFailureRecord pFailure)
+{
+  memset(pRecord, 0, sizeof(CU_EventRecord));
+  pRecord->event = event;
+  pRecord->pSuite = pSuite;
+  pRecord->pTest = pTest;
+  pRecord->pFailure = pFailure;
+}
+
+/*------------------------------------------------------------------------*/
+/*  Event notification: the handler set by the CU_set_*_handler() function
+ *  (the default listener) first, then the registered listeners.
+ *------------------------------------------------------------------------*/
+static void notify_suite_start(const CU_pSuite pSuite)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pSuiteStartMessageHandler) {
+    (*f_pSuiteStartMessageHandler)(pSuite);
+  }
+  if (0 < f_anEventListeners[EVENT_SUITE_START]) {
+    init_event(&record, EVENT_SUITE_START, pSuite, NULL, NULL);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_test_start(const CU_pTest pTest, const CU_pSuite pSuite)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pTestStartMessageHandler) {
+    (*f_pTestStartMessageHandler)(pTest, pSuite);
+  }
+  if (0 < f_anEventListeners[EVENT_TEST_START]) {
+    init_event(&record, EVENT_TEST_START, pSuite, pTest, NULL);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_test_complete(const CU_pTest pTest, const CU_pSuite pSuite,
+                                 const CU_pFailureRecord pFailure)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pTestCompleteMessageHandler) {
+    (*f_pTestCompleteMessageHandler)(pTest, pSuite, pFailure);
+  }
+  if (0 < f_anEventListeners[EVENT_TEST_COMPLETE]) {
+    init_event(&record, EVENT_TEST_COMPLETE, pSuite, pTest, pFailure);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_suite_complete(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pSuiteCompleteMessageHandler) {
+    (*f_pSuiteCompleteMessageHandler)(pSuite, pFailure);
+  }
+  if (0 < f_anEventListeners[EVENT_SUITE_COMPLETE]) {
+    init_event(&record, EVENT_SUITE_COMPLETE, pSuite, NULL, pFailure);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_all_tests_complete(const CU_pFailureRecord pFailure)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pAllTestsCompleteMessageHandler) {
+    (*f_pAllTestsCompleteMessageHandler)(pFailure);
+  }
+  if (0 < f_anEventListeners[EVENT_ALL_TESTS_COMPLETE]) {
+    init_event(&record, EVENT_ALL_TESTS_COMPLETE, NULL, NULL, pFailure);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_suite_init_failure(const CU_pSuite pSuite)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pSuiteInitFailureMessageHandler) {
+    (*f_pSuiteInitFailureMessageHandler)(pSuite);
+  }
+  if (0 < f_anEventListeners[EVENT_SUITE_INIT_FAILURE]) {
+    init_event(&record, EVENT_SUITE_INIT_FAILURE, pSuite, NULL, NULL);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_suite_cleanup_failure(const CU_pSuite pSuite)
+{
+  CU_EventRecord record;
+
+  if (NULL != f_pSuiteCleanupFailureMessageHandler) {
+    (*f_pSuiteCleanupFailureMessageHandler)(pSuite);
+  }
+  if (0 < f_anEventListeners[EVENT_SUITE_CLEANUP_FAILURE]) {
+    init_event(&record, EVENT_SUITE_CLEANUP_FAILURE, pSuite, NULL, NULL);
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_test_timing(const CU_pTest pTest, const CU_pSuite pSuite,
+                               const CU_Timing* pTiming)
+{
+  CU_EventRecord record;
+
+  if (0 < f_anEventListeners[EVENT_TEST_TIMING]) {
+    init_event(&record, EVENT_TEST_TIMING, pSuite, pTest, NULL);
+    record.timing = *pTiming;
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_suite_timing(const CU_pSuite pSuite, const CU_Timing* pTiming)
+{
+  CU_EventRecord record;
+
+  if (0 < f_anEventListeners[EVENT_SUITE_TIMING]) {
+    init_event(&record, EVENT_SUITE_TIMING, pSuite, NULL, NULL);
+    record.timing = *pTiming;
+    post_event(&record);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void notify_test_resources(const CU_pTest pTest, const CU_pSuite pSuite,
+                                  const CU_TestResources* pResources)
+{
+  CU_EventRecord record;
+
+  if (0 < f_anEventListeners[EVENT_TEST_RESOURCES]) {
+    init_event(&record, EVENT_TEST_RESOURCES, pSuite, pTest, NULL);
+    record.resources = *pResources;
+    post_event(&record);
+  }
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+/** Types of framework events tracked by test system. */
+typedef enum TET {
+  SUITE_START = 1,
+  TEST_START,
+  TEST_COMPLETE,
+  SUITE_COMPLETE,
+  ALL_TESTS_COMPLETE,
+  SUITE_INIT_FAILED,
+  SUITE_CLEANUP_FAILED
+} TestEventType;
+
+/** Test event structure for recording details of a framework event. */
+typedef struct TE {
+  TestEventType     type;
+  CU_pSuite         pSuite;
+  CU_pTest          pTest;
+  CU_pFailureRecord pFailure;
+  struct TE *       pNext;
+} TestEvent, * pTestEvent;
+
+static int f_nTestEvents = 0;
+static pTestEvent f_pFirstEvent = NULL;
+
+/** Creates & stores a test event record having the specified details. */
+static void add_test_event(TestEventType type, CU_pSuite psuite,
+                           CU_pTest ptest, CU_pFailureRecord pfailure)
+{
+  pTestEvent pNewEvent = (pTestEvent)malloc(sizeof(TestEvent));
+  pTestEvent pNextEvent = f_pFirstEvent;
+
+  if (NULL == pNewEvent) {
+    fprintf(stderr, "Memory allocation failed in add_test_event().");
+    exit(1);
+  }
+
+  pNewEvent->type = type;
   pNewEvent->pSuite = psuite;
   pNewEvent->pTest = ptest;
   pNewEvent->pFailure = pfailure;
@@ -1383,6 +3223,69 @@ static void test_fail_if_not_setup(void) { CU_TEST(SetUp_Passed); }
 static void suite_setup(void) { SetUp_Passed = CU_TRUE; }
 static void suite_teardown(void) { SetUp_Passed = CU_FALSE; }
 
+static void busy_wait(double dSeconds)
+{
+  double dEnd = CU_get_monotonic_time() + dSeconds;
+  while (CU_get_monotonic_time() < dEnd)
+    ;
+}
+
+static void test_busy_10ms(void) { busy_wait(0.01); CU_TEST(CU_TRUE); }
+static void test_busy_10ms_fail(void) { busy_wait(0.01); CU_TEST_FATAL(CU_FALSE); busy_wait(1.0); }
+static void suite_setup_busy(void) { busy_wait(0.5); }
+static void test_load_succeed(void) { CU_TEST(CU_TRUE); }
+static void test_load_fatal(void) { CU_TEST_FATAL(CU_FALSE); CU_TEST(CU_FALSE); }
+#define SOAK_LEAK_BLOCKS 2000
+static void* f_apSoakLeak[SOAK_LEAK_BLOCKS];
+static unsigned int f_nSoakLeak = 0;
+static void test_soak_leak(void)
+{
+  if (f_nSoakLeak < SOAK_LEAK_BLOCKS) {
+    f_apSoakLeak[f_nSoakLeak] = malloc(16384);
+    memset(f_apSoakLeak[f_nSoakLeak++], 1, 16384);
+  }
+  busy_wait(0.001);
+  CU_TEST(CU_TRUE);
+}
+static char f_acAllocMem[32];
+static void test_alloc_leak(void)
+{
+  /* what the wrapped malloc(), calloc() and free() would report */
+  CU_alloc_note_alloc(&f_acAllocMem[0], 10, CU_ALLOC_MALLOC);
+  CU_alloc_note_alloc(&f_acAllocMem[16], 20, CU_ALLOC_CALLOC);
+  CU_alloc_note_free(&f_acAllocMem[0]);
+  CU_ASSERT_MAX_ALLOCATIONS(2);
+  CU_ASSERT_MAX_ALLOCATIONS(1);
+  CU_ASSERT_MAX_ALLOCATED_BYTES(30);
+  CU_ASSERT_MAX_PEAK_BYTES(29);
+  CU_ASSERT_NO_LEAKS();
+}
+static void test_alloc_none(void)
+{
+  CU_ASSERT_NO_ALLOCATIONS();
+  CU_ASSERT_NO_LEAKS();
+}
+static void suite_teardown_alloc(void)
+{
+  /* the final statistics are visible to teardown */
+  CU_ASSERT(NULL != CU_get_current_alloc_stats());
+  CU_alloc_note_free(&f_acAllocMem[16]);
+}
+static void test_soak_no_leak(void)
+{
+  void* pBlock = malloc(16384);
+  memset(pBlock, 1, 16384);
+  free(pBlock);
+  busy_wait(0.001);
+}
+static void test_soak_fatal(void) { CU_TEST_FATAL(CU_FALSE); }
+static void test_load_limits(void)
+{
+  CU_ASSERT_P99_BELOW(1000);
+  CU_ASSERT_THROUGHPUT_ABOVE(0.5);
+  CU_ASSERT_P50_BELOW(0);
+}
+
 
 /*-------------------------------------------------*/
 /* tests:
@@ -1698,29 +3601,142 @@ static void test_CU_fail_on_inactive(void)
   CU_set_test_active(pTest3, CU_TRUE);
   CU_set_test_active(pTest4, CU_TRUE);
 
-  CU_set_test_active(pTest2, CU_FALSE);
-  CU_set_test_active(pTest4, CU_FALSE);
-  CU_set_fail_on_inactive(CU_TRUE);
-  TEST(CUE_TEST_INACTIVE == CU_run_all_tests());    /* some tests inactive */
-  test_results(1,1,0,1,0,1,1,1,0,2);
-  CU_set_fail_on_inactive(CU_FALSE);
-  TEST(CUE_SINIT_FAILED == CU_run_all_tests());
-  test_results(1,1,0,1,0,1,1,1,0,1);
-  CU_set_test_active(pTest2, CU_TRUE);
-  CU_set_test_active(pTest4, CU_TRUE);
+  CU_set_test_active(pTest2, CU_FALSE);
+  CU_set_test_active(pTest4, CU_FALSE);
+  CU_set_fail_on_inactive(CU_TRUE);
+  TEST(CUE_TEST_INACTIVE == CU_run_all_tests());    /* some tests inactive */
+  test_results(1,1,0,1,0,1,1,1,0,2);
+  CU_set_fail_on_inactive(CU_FALSE);
+  TEST(CUE_SINIT_FAILED == CU_run_all_tests());
+  test_results(1,1,0,1,0,1,1,1,0,1);
+  CU_set_test_active(pTest2, CU_TRUE);
+  CU_set_test_active(pTest4, CU_TRUE);
+
+  CU_set_suite_active(pSuite2, CU_FALSE);
+  CU_set_test_active(pTest1, CU_FALSE);
+  CU_set_fail_on_inactive(CU_TRUE);
+  TEST(CUE_TEST_INACTIVE == CU_run_all_tests());    /* some suites & tests inactive */
+  test_results(1,0,1,1,1,1,1,0,1,3);
+  CU_set_fail_on_inactive(CU_FALSE);
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  test_results(1,0,1,1,1,1,1,0,1,1);
+  CU_set_suite_active(pSuite2, CU_TRUE);
+  CU_set_test_active(pTest1, CU_TRUE);
+
+  /* clean up */
+  CU_cleanup_registry();
+}
+
+/*-------------------------------------------------*/
+static int f_nFailFastCleanups = 0;
+static int suite_count_cleanup(void) { ++f_nFailFastCleanups; return 0; }
+
+static void test_CU_set_fail_fast(void)
+{
+  CU_pSuite pSuite1 = NULL;
+  CU_pSuite pSuite2 = NULL;
+  CU_pTest pTest3 = NULL;
+  char* szResults;
+
+  CU_set_error_action(CUEA_IGNORE);
+  CU_initialize_registry();
+
+  pSuite1 = CU_add_suite("suite1", NULL, suite_count_cleanup);
+  CU_add_test(pSuite1, "test1", test_succeed);
+  CU_add_test(pSuite1, "test2", test_fail);
+  pTest3 = CU_add_test(pSuite1, "test3", test_fail);
+  CU_add_test(pSuite1, "test4", test_succeed);
+  pSuite2 = CU_add_suite("suite2", NULL, suite_count_cleanup);
+  CU_add_test(pSuite2, "test5", test_fail);
+  CU_add_test(pSuite2, "test6", test_succeed);
+
+  TEST(0 == CU_get_fail_fast());
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  test_results(2,0,0,6,3,0,6,3,3,3);
+  TEST(NULL == CU_get_fail_fast_test());
+
+  /* stops after test3, cleaning up suite1 */
+  CU_set_fail_fast(2);
+  TEST(2 == CU_get_fail_fast());
+  f_nFailFastCleanups = 0;
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  test_results(1,0,0,3,2,0,3,1,2,2);
+  TEST(pTest3 == CU_get_fail_fast_test());
+  TEST(1 == f_nFailFastCleanups);
+  szResults = CU_get_run_results_string();
+  TEST(NULL != szResults);
+  if (NULL != szResults) {
+    TEST(NULL != strstr(szResults, "Run stopped after 2 failed test(s)"));
+    CU_FREE(szResults);
+  }
+
+  /* not enough failures */
+  CU_set_fail_fast(4);
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  test_results(2,0,0,6,3,0,6,3,3,3);
+  TEST(NULL == CU_get_fail_fast_test());
+  szResults = CU_get_run_results_string();
+  TEST(NULL != szResults);
+  if (NULL != szResults) {
+    TEST(NULL == strstr(szResults, "Run stopped"));
+    CU_FREE(szResults);
+  }
+
+  /* single suites stop too, single tests run regardless */
+  CU_set_fail_fast(1);
+  TEST(CUE_SUCCESS == CU_run_suite(pSuite2));
+  test_results(1,0,0,1,1,0,1,0,1,1);
+  TEST(pSuite2->pTest == CU_get_fail_fast_test());
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest3));
+  test_results(0,0,0,1,1,0,1,0,1,1);
+  TEST(NULL == CU_get_fail_fast_test());
+
+  CU_set_fail_fast(0);
+  CU_cleanup_registry();
+}
+
+/*-------------------------------------------------*/
+static void test_stop_run_start(const CU_pTest pTest, const CU_pSuite pSuite)
+{
+  CU_UNREFERENCED_PARAMETER(pSuite);
+  if (0 == strcmp(pTest->pName, "test2")) {
+    CU_stop_run();
+  }
+}
+
+static void test_CU_stop_run(void)
+{
+  CU_pSuite pSuite1 = NULL;
 
-  CU_set_suite_active(pSuite2, CU_FALSE);
-  CU_set_test_active(pTest1, CU_FALSE);
-  CU_set_fail_on_inactive(CU_TRUE);
-  TEST(CUE_TEST_INACTIVE == CU_run_all_tests());    /* some suites & tests inactive */
-  test_results(1,0,1,1,1,1,1,0,1,3);
-  CU_set_fail_on_inactive(CU_FALSE);
+  CU_set_error_action(CUEA_IGNORE);
+  CU_initialize_registry();
+
+  pSuite1 = CU_add_suite("suite1", NULL, suite_count_cleanup);
+  CU_add_test(pSuite1, "test1", test_succeed);
+  CU_add_test(pSuite1, "test2", test_fail);
+  CU_add_test(pSuite1, "test3", test_succeed);
+  CU_add_test(CU_add_suite("suite2", NULL, NULL), "test4", test_succeed);
+
+  /* the running test completes, suite1 is cleaned up, suite2 is not run */
+  CU_set_test_start_handler(test_stop_run_start);
+  f_nFailFastCleanups = 0;
   TEST(CUE_SUCCESS == CU_run_all_tests());
-  test_results(1,0,1,1,1,1,1,0,1,1);
-  CU_set_suite_active(pSuite2, CU_TRUE);
-  CU_set_test_active(pTest1, CU_TRUE);
+  test_results(1,0,0,2,1,0,2,1,1,1);
+  TEST(1 == f_nFailFastCleanups);
+  TEST(NULL == CU_get_fail_fast_test());
+  CU_set_test_start_handler(NULL);
+
+  /* the request is cleared by the stopped run */
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  test_results(2,0,0,4,1,0,4,3,1,1);
+
+  /* a request between runs stops the next run before its first test */
+  CU_stop_run();
+  TEST(CUE_SUCCESS == CU_run_suite(pSuite1));
+  test_results(1,0,0,0,0,0,0,0,0,0);
+  TEST(CUE_SUCCESS == CU_run_suite(pSuite1));
+  test_results(1,0,0,3,1,0,3,2,1,1);
 
-  /* clean up */
   CU_cleanup_registry();
 }
 
@@ -2853,7 +4869,7 @@ static void test_add_failure(void)
   CU_pFailureRecord pFailure2 = NULL;
   CU_pFailureRecord pFailure3 = NULL;
   CU_pFailureRecord pFailure4 = NULL;
-  CU_RunSummary run_summary = {"", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  CU_RunSummary run_summary = {"", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
   /* test under memory exhaustion */
   test_cunit_deactivate_malloc();
@@ -2918,17 +4934,755 @@ static void test_add_failure(void)
 }
 
 /*-------------------------------------------------*/
+/* tests:
+ *      CU_Test.dDuration measured by run_single_test()
+ */
+static void test_test_duration(void)
+{
+  CU_pSuite pSuite1 = NULL;
+  CU_pTest pTest1 = NULL;
+  CU_pTest pTest2 = NULL;
+  CU_pTest pTest3 = NULL;
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite_with_setup_and_teardown("suite1", NULL, NULL, suite_setup_busy, NULL);
+  pTest1 = CU_add_test(pSuite1, "test1", test_busy_10ms);
+  pTest2 = CU_add_test(pSuite1, "test2", test_busy_10ms_fail);
+  pTest3 = CU_add_test(pSuite1, "test3", test_busy_10ms);
+  TEST_FATAL(NULL != pTest3);
+
+  TEST(0.0 == pTest1->dDuration);                 /* not run yet */
+  TEST(0.0 == pTest2->dDuration);
+
+  CU_set_test_active(pTest3, CU_FALSE);
+  CU_run_suite(pSuite1);                          /* inactive test3 reported as error */
+  TEST(pTest1->dDuration >= 0.01);                /* test function time is counted... */
+  TEST(pTest1->dDuration < 0.5);                  /* ...but setup time is not */
+  TEST(pTest2->dDuration >= 0.01);                /* fatal assertion stops the clock */
+  TEST(pTest2->dDuration < 1.0);
+  TEST(0.0 == pTest3->dDuration);                 /* inactive test has no duration */
+
+  CU_cleanup_registry();
+}
+
+#ifndef _WIN32
+static unsigned int f_nCrashTearDowns;
+static CU_BOOL f_bCrashTestRan;
+
+static void crash_teardown(void) { ++f_nCrashTearDowns; }
+static void test_crash_segv(void) { CU_TEST(CU_TRUE); raise(SIGSEGV); CU_TEST(CU_FALSE); }
+static void test_crash_fpe(void) { raise(SIGFPE); }
+static void test_after_crash(void) { f_bCrashTestRan = CU_TRUE; CU_TEST(CU_TRUE); }
+#endif
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_set_crash_capture()
+ *      CU_get_crash_capture()
+ *      CU_get_number_of_tests_crashed()
+ *      crashes captured by run_test_body()
+ */
+static void test_crash_capture(void)
+{
+#ifndef _WIN32
+  CU_pSuite pSuite1 = NULL;
+  CU_pTest pTest1 = NULL;
+  CU_pFailureRecord pFailure = NULL;
+  struct sigaction action;
+  char* szResults;
+
+  TEST(CU_FALSE == CU_get_crash_capture());
+  CU_set_crash_capture(CU_TRUE);
+  TEST(CU_TRUE == CU_get_crash_capture());
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite_with_setup_and_teardown("suite1", NULL, NULL, NULL, crash_teardown);
+  pTest1 = CU_add_test(pSuite1, "test1", test_crash_segv);
+  CU_add_test(pSuite1, "test2", test_crash_fpe);
+  CU_add_test(pSuite1, "test3", test_after_crash);
+
+  f_nCrashTearDowns = 0;
+  f_bCrashTestRan = CU_FALSE;
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  test_results(1,0,0,3,2,0,2,2,0,2);
+  TEST(2 == CU_get_number_of_tests_crashed());
+  TEST(3 == f_nCrashTearDowns);                   /* teardown runs after a crash */
+  TEST(CU_TRUE == f_bCrashTestRan);               /* and the run goes on */
+
+  pFailure = CU_get_failure_list();
+  TEST_FATAL(NULL != pFailure);
+  TEST(CUF_TestCrashed == pFailure->type);
+  TEST(0 == strcmp("test1", pFailure->pTest->pName));
+  TEST(NULL != strstr(pFailure->strCondition, "SIGSEGV"));
+  pFailure = pFailure->pNext;
+  TEST_FATAL(NULL != pFailure);
+  TEST(CUF_TestCrashed == pFailure->type);
+  TEST(NULL != strstr(pFailure->strCondition, "SIGFPE"));
+
+  szResults = CU_get_run_results_string();
+  TEST_FATAL(NULL != szResults);
+  TEST(NULL != strstr(szResults, "tainted"));
+  CU_FREE(szResults);
+
+  sigaction(SIGSEGV, NULL, &action);
+  TEST(crash_signal_handler != action.sa_handler);  /* removed after the run */
+
+  CU_set_crash_capture(CU_FALSE);
+  TEST(CU_FALSE == CU_get_crash_capture());
+
+  /* a crash in an isolated worker has the same type, but does not taint the run */
+  TEST(CUE_SUCCESS == CU_set_isolation(CU_ISOLATION_TEST, 0));
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest1));
+  TEST(1 == CU_get_number_of_tests_failed());
+  TEST(0 == CU_get_number_of_tests_crashed());
+  pFailure = CU_get_failure_list();
+  TEST_FATAL(NULL != pFailure);
+  TEST(CUF_TestCrashed == pFailure->type);
+  TEST(NULL != strstr(pFailure->strCondition, "SIGSEGV"));
+  TEST(NULL == pFailure->pNext);
+  CU_set_isolation(CU_ISOLATION_NONE, 0);
+
+  CU_cleanup_registry();
+#endif
+}
+
+#ifndef _WIN32
+static unsigned int f_nTimeoutTearDowns;
+
+static void timeout_teardown(void) { ++f_nTimeoutTearDowns; }
+static void test_hangs(void) { CU_TEST(CU_TRUE); CU_sleep(10.0); CU_TEST(CU_FALSE); }
+static void test_busy_hangs(void) { busy_wait(10.0); }
+#endif
+
+/*-------------------------------------------------*/
+/* tests:
+ *      test timeouts armed by run_single_test()
+ *      CUF_TestTimeout
+ */
+static void test_timeouts(void)
+{
+#ifndef _WIN32
+  CU_pSuite pSuite1 = NULL;
+  CU_pTest pTest1 = NULL;
+  CU_pTest pTest2 = NULL;
+  CU_pFailureRecord pFailure = NULL;
+  double dStart;
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite_with_setup_and_teardown("suite1", suite_succeed, suite_succeed, NULL, timeout_teardown);
+  pTest1 = CU_add_test(pSuite1, "test1", test_hangs);
+  pTest2 = CU_add_test(pSuite1, "test2", test_busy_hangs);
+  CU_add_test(pSuite1, "test3", test_succeed);
+  TEST_FATAL(NULL != pTest2);
+
+  TEST(CUE_SUCCESS == CU_set_test_timeout(pTest1, 50));
+  CU_set_default_test_timeout(100);               /* test2 and the suite functions */
+  f_nTimeoutTearDowns = 0;
+  dStart = CU_get_monotonic_time();
+  TEST(CUE_SUCCESS == CU_run_all_tests());
+  TEST(CU_get_monotonic_time() - dStart < 5.0);   /* both hanging tests abandoned */
+  test_results(1,0,0,3,2,0,2,2,0,2);
+  TEST(3 == f_nTimeoutTearDowns);                 /* teardown runs after a timeout */
+
+  pFailure = CU_get_failure_list();
+  TEST_FATAL(NULL != pFailure);
+  TEST(CUF_TestTimeout == pFailure->type);
+  TEST(pTest1 == pFailure->pTest);
+  TEST(0 == strncmp("Test timed out after 50 ms", pFailure->strCondition, 26));
+#if defined(__linux__) && defined(__GLIBC__)
+  TEST(NULL != strstr(pFailure->strCondition, "(test)"));  /* stack of the hung thread */
+#endif
+  pFailure = pFailure->pNext;
+  TEST_FATAL(NULL != pFailure);
+  TEST(CUF_TestTimeout == pFailure->type);
+  TEST(pTest2 == pFailure->pTest);
+  TEST(0 == strncmp("Test timed out after 100 ms", pFailure->strCondition, 27));
+
+  /* tests within their timeout are not affected */
+  TEST(CUE_SUCCESS == CU_set_test_timeout(pTest1, CU_TIMEOUT_NONE));
+  CU_set_test_active(pTest1, CU_FALSE);
+  CU_set_test_active(pTest2, CU_FALSE);
+  CU_set_fail_on_inactive(CU_FALSE);
+  TEST(CUE_TEST_INACTIVE == CU_run_all_tests());
+  test_results(1,0,0,1,0,2,1,1,0,0);
+  CU_set_fail_on_inactive(CU_TRUE);
+
+  CU_set_default_test_timeout(0);
+  CU_cleanup_registry();
+#endif
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_add_load_test() tests run by run_single_test()
+ *      CU_ASSERT_P50_BELOW()
+ *      CU_ASSERT_P99_BELOW()
+ *      CU_ASSERT_THROUGHPUT_ABOVE()
+ */
+static void test_load_tests(void)
+{
+  CU_pSuite pSuite1 = NULL;
+  CU_pTest pTest1 = NULL;
+  CU_pTest pTest2 = NULL;
+  CU_pTest pTest3 = NULL;
+  const CU_LoadResult* pResult;
+  unsigned long ulCount = 0;
+  unsigned int i;
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite("suite1", NULL, NULL);
+  pTest1 = CU_add_load_test(pSuite1, "test1", test_load_succeed, 200.0, 0.1);
+  pTest2 = CU_add_load_test(pSuite1, "test2", test_load_fatal, 100.0, 0.05);
+  pTest3 = CU_add_test(pSuite1, "test3", test_load_limits);
+  TEST_FATAL(NULL != pTest3);
+  TEST(CUE_SUCCESS == CU_set_load_test_workers(pTest2, 2));
+
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest1));
+  test_results(0,0,0,1,0,0,20,20,0,0);
+  pResult = CU_get_load_result(pTest1);
+  TEST_FATAL(NULL != pResult);
+  TEST(pResult == CU_get_load_result(pTest1));
+  TEST(20 == pResult->ulRequests);
+  TEST(0 == pResult->ulAborted);
+  TEST(CU_LOAD_DEFAULT_WORKERS == pResult->uiWorkers);
+  TEST(200.0 == pResult->dTargetRate);
+  TEST(pResult->dElapsedTime >= 0.095);            /* last call is due at 0.095 s */
+  TEST(pResult->dMinLatency <= pResult->dMeanLatency);
+  TEST(pResult->dMeanLatency <= pResult->dMaxLatency);
+  for (i = 0 ; i < CU_LOAD_HISTOGRAM_BUCKETS ; ++i) {
+    ulCount += pResult->aulHistogram[i];
+  }
+  TEST(20 == ulCount);
+  TEST(CU_get_load_percentile(pResult, 50.0) <= CU_get_load_percentile(pResult, 99.0));
+  TEST(CU_get_load_percentile(pResult, 100.0) >= pResult->dMaxLatency);
+  TEST(0 == memcmp(pResult, CU_get_last_load_result(), sizeof(CU_LoadResult)));
+
+  /* a fatal assertion ends only the current call */
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest2));
+  test_results(0,0,0,1,1,0,5,0,5,5);
+  TEST(5 == CU_get_load_result(pTest2)->ulRequests);
+  TEST(5 == CU_get_load_result(pTest2)->ulAborted);
+  TEST(2 == CU_get_load_result(pTest2)->uiWorkers);
+
+  /* limits apply to the last load test run (test2) */
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest3));
+  test_results(0,0,0,1,1,0,3,2,1,1);
+
+  CU_cleanup_registry();
+  TEST(NULL != CU_get_last_load_result());        /* copy outlives the registry */
+  TEST(5 == CU_get_last_load_result()->ulRequests);
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_set_soak_test() tests run by run_single_test()
+ */
+static void test_soak_tests(void)
+{
+  CU_pSuite pSuite1 = NULL;
+  CU_pTest pTest1 = NULL;
+  CU_pTest pTest2 = NULL;
+  CU_pTest pTest3 = NULL;
+  const CU_SoakResult* pResult;
+#if defined(__linux__) && defined(__GLIBC__)
+  CU_pFailureRecord pFailure;
+#endif
+  unsigned int i;
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite("suite1", NULL, NULL);
+  pTest1 = CU_add_test(pSuite1, "test1", test_soak_no_leak);
+  pTest2 = CU_add_test(pSuite1, "test2", test_soak_leak);
+  pTest3 = CU_add_test(pSuite1, "test3", test_soak_fatal);
+  TEST_FATAL(NULL != pTest3);
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest1, 0.3));
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest2, 0.3));
+  TEST(CUE_SUCCESS == CU_set_soak_test(pTest3, 10.0));
+
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest1));
+  test_results(0,0,0,1,0,0,0,0,0,0);
+  pResult = CU_get_soak_result(pTest1);
+  TEST_FATAL(NULL != pResult);
+  TEST(pResult->ulIterations > 10);
+  TEST(pResult->uiSamples >= 10);
+  TEST(pResult->dElapsedTime >= 0.3);
+  TEST(CU_FALSE == pResult->bAborted);
+  for (i = 0 ; i < CU_SOAK_METRICS ; ++i) {
+    TEST(CU_FALSE == pResult->abLeak[i]);
+  }
+
+  /* about 16 KiB per ms - well over the 1 MiB heap threshold */
+  f_nSoakLeak = 0;
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest2));
+  pResult = CU_get_soak_result(pTest2);
+  TEST(pResult->ulIterations == (unsigned long)CU_get_number_of_asserts());
+#if defined(__linux__) && defined(__GLIBC__)
+  TEST(CU_FALSE != pResult->abAvailable[CU_SOAK_HEAP]);
+  TEST(CU_FALSE != pResult->abMonotonic[CU_SOAK_HEAP]);
+  TEST(CU_FALSE != pResult->abLeak[CU_SOAK_HEAP]);
+  TEST(pResult->adGrowth[CU_SOAK_HEAP] > 1024.0 * 1024.0);
+  TEST(1 == CU_get_number_of_tests_failed());
+  TEST(CU_get_number_of_failure_records() >= 1);
+  for (pFailure = CU_get_failure_list() ; NULL != pFailure ; pFailure = pFailure->pNext) {
+    if (NULL != strstr(pFailure->strCondition, "heap in use")) {
+      break;
+    }
+  }
+  TEST(NULL != pFailure);
+#endif
+  TEST(CUE_SUCCESS == CU_set_soak_threshold(pTest2, CU_SOAK_RSS, -1.0));
+  TEST(CUE_SUCCESS == CU_set_soak_threshold(pTest2, CU_SOAK_HEAP, -1.0));
+  for (i = 0 ; i < f_nSoakLeak ; ++i) {
+    free(f_apSoakLeak[i]);
+  }
+  f_nSoakLeak = 0;
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest2));
+  test_results(0,0,0,1,0,0,CU_get_soak_result(pTest2)->ulIterations,CU_get_soak_result(pTest2)->ulIterations,0,0);
+  for (i = 0 ; i < f_nSoakLeak ; ++i) {
+    free(f_apSoakLeak[i]);
+  }
+  f_nSoakLeak = 0;
+
+  /* a fatal assertion ends the soak */
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest3));
+  test_results(0,0,0,1,1,0,1,0,1,1);
+  TEST(1 == CU_get_soak_result(pTest3)->ulIterations);
+  TEST(CU_FALSE != CU_get_soak_result(pTest3)->bAborted);
+  TEST(CU_get_soak_result(pTest3)->dElapsedTime < 5.0);
+
+  CU_cleanup_registry();
+}
+
+/*-------------------------------------------------*/
+/*  Tests of allocation accounting by run_single_test(),
+ *  reporting allocations through the wrapper hooks.
+ */
+static void test_alloc_tracking(void)
+{
+  CU_pSuite pSuite1 = NULL;
+  CU_pTest pTest1 = NULL;
+  CU_pTest pTest2 = NULL;
+  const CU_AllocStats* pStats;
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite_with_setup_and_teardown("suite1", NULL, NULL, NULL, suite_teardown_alloc);
+  pTest1 = CU_add_test(pSuite1, "test1", test_alloc_leak);
+  pTest2 = CU_add_test(pSuite1, "test2", test_alloc_none);
+  TEST_FATAL(NULL != pTest2);
+
+  /* without the wrapper library the assertions fail */
+  if (CU_FALSE == CU_is_alloc_tracking_available()) {
+    TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest2));
+    test_results(0,0,0,1,1,0,3,1,2,2);
+    TEST(NULL == CU_get_alloc_stats(pTest2));
+  }
+
+  CU_alloc_note_free(NULL);                     /* as the wrapper does on first use */
+  TEST(CU_FALSE != CU_is_alloc_tracking_available());
+
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest1));
+  test_results(0,0,0,1,1,0,6,3,3,3);
+  pStats = CU_get_alloc_stats(pTest1);
+  TEST_FATAL(NULL != pStats);
+  TEST(1 == pStats->ulMallocs);
+  TEST(1 == pStats->ulCallocs);
+  TEST(1 == pStats->ulFrees);
+  TEST(2 == pStats->ulAllocations);
+  TEST(30 == pStats->szBytes);
+  TEST(30 == pStats->szPeakLiveBytes);
+  TEST(1 == pStats->ulOutstanding);             /* teardown is not accounted */
+  TEST(20 == pStats->szLiveBytes);
+
+  TEST(CUE_SUCCESS == CU_run_test(pSuite1, pTest2));
+  test_results(0,0,0,1,0,0,3,3,0,0);
+  TEST_FATAL(NULL != CU_get_alloc_stats(pTest2));
+  TEST(0 == CU_get_alloc_stats(pTest2)->ulAllocations);
+  TEST(1 == CU_get_alloc_stats(pTest1)->ulOutstanding);  /* per test */
+
+  CU_cleanup_registry();
+}
+
+/*-------------------------------------------------*/
+/*-------------------------------------------------*/
+/** Events received by a listener, one letter each. */
+typedef struct ListenerLog
+{
+  char         szEvents[64];
+  unsigned int nEvents;
+  double       dSetUpTime;      /* sum of test setup durations */
+  double       dSuiteRunTime;   /* sum of suite run durations */
+  unsigned int nAllocStatsOk;   /* resource events with pAllocStats of the test */
+} ListenerLog;
+
+static char f_szListenerOrder[64];
+static unsigned int f_nListenerOrder = 0;
+static CU_ErrorCode f_ListenerRunError = CUE_SUCCESS;
+static const CU_Listener* f_pBusyListener = NULL;
+
+static void log_listener_event(void* pContext, char cEvent)
+{
+  ListenerLog* pLog = (ListenerLog*)pContext;
+  if (pLog->nEvents < sizeof(pLog->szEvents) - 1) {
+    pLog->szEvents[pLog->nEvents++] = cEvent;
+    pLog->szEvents[pLog->nEvents] = '\0';
+  }
+}
+
+static void log_listener_order(char cListener)
+{
+  if (f_nListenerOrder < sizeof(f_szListenerOrder) - 1) {
+    f_szListenerOrder[f_nListenerOrder++] = cListener;
+    f_szListenerOrder[f_nListenerOrder] = '\0';
+  }
+}
+
+static void listener_suite_start(void* pContext, const CU_pSuite pSuite)
+{ CU_UNREFERENCED_PARAMETER(pSuite); log_listener_event(pContext, 'S'); }
+static void listener_test_start(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite)
+{ CU_UNREFERENCED_PARAMETER(pTest); CU_UNREFERENCED_PARAMETER(pSuite); log_listener_event(pContext, 't'); log_listener_order('1'); }
+static void listener_test_start2(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite)
+{ CU_UNREFERENCED_PARAMETER(pTest); CU_UNREFERENCED_PARAMETER(pSuite); log_listener_event(pContext, 't'); log_listener_order('2'); }
+static void listener_test_complete(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{ CU_UNREFERENCED_PARAMETER(pTest); CU_UNREFERENCED_PARAMETER(pSuite); CU_UNREFERENCED_PARAMETER(pFailure); log_listener_event(pContext, 'c'); }
+static void listener_suite_complete(void* pContext, const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{ CU_UNREFERENCED_PARAMETER(pSuite); CU_UNREFERENCED_PARAMETER(pFailure); log_listener_event(pContext, 'C'); }
+static void listener_all_complete(void* pContext, const CU_pFailureRecord pFailure)
+{ CU_UNREFERENCED_PARAMETER(pFailure); log_listener_event(pContext, 'A'); }
+static void listener_init_failure(void* pContext, const CU_pSuite pSuite)
+{ CU_UNREFERENCED_PARAMETER(pSuite); log_listener_event(pContext, 'I'); }
+static void listener_cleanup_failure(void* pContext, const CU_pSuite pSuite)
+{ CU_UNREFERENCED_PARAMETER(pSuite); log_listener_event(pContext, 'X'); }
+static void listener_test_timing(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite, const CU_Timing* pTiming)
+{
+  CU_UNREFERENCED_PARAMETER(pSuite);
+  log_listener_event(pContext, 'T');
+  ((ListenerLog*)pContext)->dSetUpTime += pTiming->dSetUp;
+  if (pTiming->dRun != pTest->dDuration) {
+    log_listener_event(pContext, '!');
+  }
+}
+static void listener_suite_timing(void* pContext, const CU_pSuite pSuite, const CU_Timing* pTiming)
+{ CU_UNREFERENCED_PARAMETER(pSuite); log_listener_event(pContext, 'U'); ((ListenerLog*)pContext)->dSuiteRunTime += pTiming->dRun; }
+static void listener_test_resources(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite, const CU_TestResources* pResources)
+{
+  CU_UNREFERENCED_PARAMETER(pSuite);
+  log_listener_event(pContext, 'R');
+  if ((pResources->dCpuTime >= 0.0) && (CU_get_alloc_stats(pTest) == pResources->pAllocStats)) {
+    ((ListenerLog*)pContext)->nAllocStatsOk++;
+  }
+}
+static void default_test_start_handler(const CU_pTest pTest, const CU_pSuite pSuite)
+{ CU_UNREFERENCED_PARAMETER(pTest); CU_UNREFERENCED_PARAMETER(pSuite); log_listener_order('0'); }
+
+static void test_add_listener_in_run(void)
+{
+  f_ListenerRunError = CU_add_listener(f_pBusyListener, NULL);
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_add_listener()
+ *      CU_remove_listener()
+ *      CU_get_number_of_listeners()
+ *      event order and timing/resource events
+ */
+static void test_listeners(void)
+{
+  const CU_Listener full = {
+    listener_suite_start, listener_test_start, listener_test_complete,
+    listener_suite_complete, listener_all_complete, listener_init_failure,
+    listener_cleanup_failure, listener_test_timing, listener_suite_timing,
+    listener_test_resources, 0
+  };
+  const CU_Listener partial = {
+    NULL, listener_test_start2, NULL, NULL, listener_all_complete,
+    NULL, NULL, NULL, NULL, NULL, 0
+  };
+  ListenerLog log1;
+  ListenerLog log2;
+  CU_pSuite pSuite1 = NULL;
+  CU_pSuite pSuite2 = NULL;
+  CU_pSuite pSuite3 = NULL;
+  CU_pTest  pTest1 = NULL;
+  unsigned int i;
+
+  memset(&log1, 0, sizeof(log1));
+  memset(&log2, 0, sizeof(log2));
+  f_nListenerOrder = 0;
+  f_szListenerOrder[0] = '\0';
+
+  TEST(0 == CU_get_number_of_listeners());
+
+  /* error conditions */
+  TEST(CUE_NOLISTENER == CU_add_listener(NULL, NULL));
+  TEST(CUE_NOLISTENER == CU_get_error());
+  TEST(CUE_NOLISTENER == CU_remove_listener(&full, &log1));
+  TEST(0 == CU_get_number_of_listeners());
+
+  for (i = 0 ; i < CU_MAX_LISTENERS ; ++i) {
+    TEST(CUE_SUCCESS == CU_add_listener(&partial, NULL));
+  }
+  TEST(CU_MAX_LISTENERS == CU_get_number_of_listeners());
+  TEST(CUE_TOO_MANY_LISTENERS == CU_add_listener(&full, &log1));
+  for (i = 0 ; i < CU_MAX_LISTENERS ; ++i) {
+    TEST(CUE_SUCCESS == CU_remove_listener(&partial, NULL));
+  }
+  TEST(0 == CU_get_number_of_listeners());
+
+  /* register some suites and tests */
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite_with_setup_and_teardown("suite1", NULL, NULL, suite_setup, suite_teardown);
+  pTest1 = CU_add_test(pSuite1, "test1", test_busy_10ms);
+  CU_add_test(pSuite1, "test2", test_fail);
+  pSuite2 = CU_add_suite("suite2", suite_fail, NULL);
+  CU_add_test(pSuite2, "test3", test_succeed);
+  pSuite3 = CU_add_suite("suite3", suite_succeed, suite_fail);
+  CU_add_test(pSuite3, "test4", test_succeed);
+  TEST_FATAL(CUE_SUCCESS == CU_get_error());
+
+  /* default listener first, then listeners in registration order */
+  CU_set_test_start_handler(default_test_start_handler);
+  TEST(CUE_SUCCESS == CU_add_listener(&full, &log1));
+  TEST(CUE_SUCCESS == CU_add_listener(&partial, &log2));
+  TEST(2 == CU_get_number_of_listeners());
+
+  CU_run_all_tests();
+  TEST(!strcmp("StTRctTRcUCSIUCStTRcXUCA", log1.szEvents));
+  TEST(!strcmp("tttA", log2.szEvents));
+  TEST(!strcmp("012012012", f_szListenerOrder));
+  TEST(3 == log1.nAllocStatsOk);
+  TEST(log1.dSetUpTime >= 0.0);
+  TEST(log1.dSuiteRunTime >= 0.01);                /* suite1 runs test_busy_10ms */
+  TEST(pTest1->dDuration >= 0.01);
+  test_results(2,2,0,3,1,0,3,2,1,3);
+
+  /* single suite and single test runs */
+  log1.nEvents = 0;
+  CU_run_suite(pSuite3);
+  TEST(!strcmp("StTRcXUCA", log1.szEvents));
+
+  log1.nEvents = 0;
+  CU_run_test(pSuite1, pTest1);
+  TEST(!strcmp("StTRcUCA", log1.szEvents));
+
+  /* inactive suite gets no timing event */
+  log1.nEvents = 0;
+  CU_set_fail_on_inactive(CU_FALSE);
+  CU_set_suite_active(pSuite2, CU_FALSE);
+  CU_run_suite(pSuite2);
+  TEST(!strcmp("SCA", log1.szEvents));
+  CU_set_suite_active(pSuite2, CU_TRUE);
+  CU_set_fail_on_inactive(CU_TRUE);
+
+  /* listeners cannot change during a run */
+  f_pBusyListener = &partial;
+  f_ListenerRunError = CUE_SUCCESS;
+  CU_add_test(pSuite1, "test5", test_add_listener_in_run);
+  log1.nEvents = 0;
+  CU_run_suite(pSuite1);
+  TEST(CUE_LISTENER_BUSY == f_ListenerRunError);
+  TEST(2 == CU_get_number_of_listeners());
+
+  /* removed listeners are no longer called */
+  TEST(CUE_SUCCESS == CU_remove_listener(&full, &log1));
+  TEST(CUE_NOLISTENER == CU_remove_listener(&full, &log1));
+  TEST(CUE_NOLISTENER == CU_remove_listener(&partial, &log1));
+  TEST(1 == CU_get_number_of_listeners());
+  log1.nEvents = 0;
+  log2.nEvents = 0;
+  log1.szEvents[0] = '\0';
+  CU_run_suite(pSuite3);
+  TEST(0 == log1.nEvents);
+  TEST(!strcmp("tA", log2.szEvents));
+
+  TEST(CUE_SUCCESS == CU_remove_listener(&partial, &log2));
+  TEST(0 == CU_get_number_of_listeners());
+  CU_set_test_start_handler(NULL);
+
+  CU_cleanup_registry();
+}
+
+/** Events received from the event writer, with checks of the thread and failure copies. */
+static unsigned int f_nQueuedOnWriter = 0;
+static unsigned int f_nQueuedOnTestThread = 0;
+static unsigned int f_nQueuedFailures = 0;
+static CU_BOOL f_bQueuedFlushFailed = CU_FALSE;
+static CU_ErrorCode f_QueueSizeRunError = CUE_SUCCESS;
+
+static void queue_note_thread(void)
+{
+  if (CU_FALSE != f_bIsEventWriter) {
+    ++f_nQueuedOnWriter;
+  }
+  else {
+    ++f_nQueuedOnTestThread;
+  }
+}
+
+static void queue_test_start(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite)
+{
+  queue_note_thread();
+  listener_test_start(pContext, pTest, pSuite);
+}
+
+static void queue_test_complete(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_pFailureRecord pTemp;
+
+  queue_note_thread();
+  /* a slow reporter: the test thread runs ahead and adds failures to the live list */
+  CU_sleep(0.005);
+  for (pTemp = pFailure ; NULL != pTemp ; pTemp = pTemp->pNext) {
+    if (pTemp->pTest == pTest) {
+      ++f_nQueuedFailures;
+    }
+    else {
+      log_listener_event(pContext, '!');
+    }
+  }
+  if (CU_FALSE != CU_flush_listener_events(0.0)) {
+    f_bQueuedFlushFailed = CU_TRUE;
+  }
+  listener_test_complete(pContext, pTest, pSuite, pFailure);
+}
+
+static void queue_test_start_sync(void* pContext, const CU_pTest pTest, const CU_pSuite pSuite)
+{
+  queue_note_thread();
+  listener_test_start2(pContext, pTest, pSuite);
+}
+
+static void test_set_queue_size_in_run(void)
+{
+  f_QueueSizeRunError = CU_set_listener_queue_size(8);
+  CU_ASSERT_TRUE(CU_flush_listener_events(-1.0));
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_set_listener_queue_size()
+ *      CU_get_listener_queue_size()
+ *      CU_get_listener_queue_stalls()
+ *      CU_flush_listener_events()
+ *      delivery of events by the event writer
+ */
+static void test_listener_queue(void)
+{
+  const CU_Listener queued = {
+    listener_suite_start, queue_test_start, queue_test_complete,
+    listener_suite_complete, listener_all_complete, listener_init_failure,
+    listener_cleanup_failure, listener_test_timing, listener_suite_timing,
+    listener_test_resources, 0
+  };
+  const CU_Listener sync = {
+    NULL, queue_test_start_sync, NULL, NULL, listener_all_complete,
+    NULL, NULL, NULL, NULL, NULL, CU_LISTENER_SYNCHRONOUS
+  };
+  ListenerLog log1;
+  ListenerLog log2;
+  CU_pSuite pSuite1 = NULL;
+  CU_pSuite pSuite2 = NULL;
+  CU_pSuite pSuite3 = NULL;
+
+  memset(&log1, 0, sizeof(log1));
+  memset(&log2, 0, sizeof(log2));
+  f_nListenerOrder = 0;
+  f_szListenerOrder[0] = '\0';
+
+  TEST(0 == CU_get_listener_queue_size());
+  TEST(CU_FALSE != CU_flush_listener_events(0.0));    /* no queue, nothing pending */
+
+  CU_initialize_registry();
+  pSuite1 = CU_add_suite_with_setup_and_teardown("suite1", NULL, NULL, suite_setup, suite_teardown);
+  CU_add_test(pSuite1, "test1", test_busy_10ms);
+  CU_add_test(pSuite1, "test2", test_fail);
+  pSuite2 = CU_add_suite("suite2", suite_fail, NULL);
+  CU_add_test(pSuite2, "test3", test_succeed);
+  pSuite3 = CU_add_suite("suite3", suite_succeed, suite_fail);
+  CU_add_test(pSuite3, "test4", test_succeed);
+  TEST_FATAL(CUE_SUCCESS == CU_get_error());
+
+  TEST(CUE_SUCCESS == CU_add_listener(&queued, &log1));
+  TEST(CUE_SUCCESS == CU_add_listener(&sync, &log2));
+
+  /* without a queue every listener runs on the test thread */
+  f_nQueuedOnWriter = 0;
+  f_nQueuedOnTestThread = 0;
+  f_nQueuedFailures = 0;
+  CU_run_all_tests();
+  TEST(!strcmp("StTRctTRcUCSIUCStTRcXUCA", log1.szEvents));
+  TEST(0 == f_nQueuedOnWriter);
+  TEST(9 == f_nQueuedOnTestThread);
+  TEST(1 == f_nQueuedFailures);
+
+  /* with a queue, same events in the same order from the writer thread */
+  TEST(CUE_SUCCESS == CU_set_listener_queue_size(1));
+  TEST(1 == CU_get_listener_queue_size());
+  memset(&log1, 0, sizeof(log1));
+  memset(&log2, 0, sizeof(log2));
+  f_nListenerOrder = 0;
+  f_nQueuedOnWriter = 0;
+  f_nQueuedOnTestThread = 0;
+  f_nQueuedFailures = 0;
+  f_bQueuedFlushFailed = CU_FALSE;
+  CU_run_all_tests();
+  TEST(!strcmp("StTRctTRcUCSIUCStTRcXUCA", log1.szEvents));
+  TEST(!strcmp("tttA", log2.szEvents));
+  TEST(6 == f_nQueuedOnWriter);                      /* 3 test starts, 3 test completes */
+  TEST(3 == f_nQueuedOnTestThread);                  /* synchronous listener */
+  TEST(1 == f_nQueuedFailures);                      /* copies end at the failures of the test */
+  TEST(CU_FALSE == f_bQueuedFlushFailed);            /* no flush from the writer thread */
+  TEST(0 < CU_get_listener_queue_stalls());          /* slow listener, queue of one event */
+  TEST(3 == log1.nAllocStatsOk);
+  test_results(2,2,0,3,1,0,3,2,1,3);
+
+  /* the queue size cannot change during a run; flushing on the test thread works */
+  TEST(CUE_SUCCESS == CU_set_listener_queue_size(64));
+  f_QueueSizeRunError = CUE_SUCCESS;
+  CU_add_test(pSuite3, "test5", test_set_queue_size_in_run);
+  memset(&log1, 0, sizeof(log1));
+  CU_run_suite(pSuite3);
+  TEST(CUE_LISTENER_BUSY == f_QueueSizeRunError);
+  TEST(64 == CU_get_listener_queue_size());
+  TEST(!strcmp("StTRctTRcXUCA", log1.szEvents));
+  TEST(0 == CU_get_listener_queue_stalls());
+
+  /* only synchronous listeners: no writer thread is started */
+  TEST(CUE_SUCCESS == CU_remove_listener(&queued, &log1));
+  memset(&log2, 0, sizeof(log2));
+  f_nQueuedOnWriter = 0;
+  CU_run_suite(pSuite1);
+  TEST(!strcmp("ttA", log2.szEvents));
+  TEST(0 == f_nQueuedOnWriter);
+
+  TEST(CUE_SUCCESS == CU_remove_listener(&sync, &log2));
+  TEST(CUE_SUCCESS == CU_set_listener_queue_size(0));
+  CU_UNREFERENCED_PARAMETER(pSuite2);
+
+  CU_cleanup_registry();
+}
+
 void test_cunit_TestRun(void)
 {
   test_cunit_start_tests("TestRun.c");
 
   test_message_handlers();
   test_CU_fail_on_inactive();
+  test_CU_set_fail_fast();
+  test_CU_stop_run();
   test_CU_run_all_tests();
   test_CU_run_suite();
   test_CU_run_test();
   test_CU_assertImplementation();
   test_add_failure();
+  test_test_duration();
+  test_crash_capture();
+  test_timeouts();
+  test_load_tests();
+  test_soak_tests();
+  test_alloc_tracking();
+  test_listeners();
+  test_listener_queue();
 
   test_cunit_end_tests();
 }
@@ -0,0 +1,657 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Implementation of wall-clock timeouts of tests.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Wall-clock timeouts of tests (implementation).
+ *  The watchdog thread sleeps on a condition variable until the armed
+ *  deadline.  Stack traces are taken by sending CU_WATCHDOG_SIGNAL to
+ *  each thread in turn; its handler records the return addresses of
+ *  the interrupted thread with backtrace(), and the watchdog thread
+ *  turns them into symbols once the handler has returned.  The same
+ *  signal, sent to the armed thread with an interrupt request pending,
+ *  runs the interrupt function of the test run.
+ */
+/** @addtogroup Framework
+ @{
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L   /* sigaction(), pthread_kill() under -std=c99 */
+#endif
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE           /* syscall(), SIGURG with glibc */
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <signal.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/syscall.h>
+#endif
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+#include "CUnit.h"
+#include "MyMem.h"
+#include "TestDB.h"
+#include "Util.h"
+#include "CUThread.h"
+#include "Timeout.h"
+#include "CUnit_intl.h"
+
+#ifndef CU_WATCHDOG_SIGNAL
+#define CU_WATCHDOG_SIGNAL SIGURG  /**< Signal used to trace and interrupt threads (ignored by default). */
+#endif
+
+#define STACKS_BUFFER_SIZE 32768   /**< Capacity of the string returned by CU_get_thread_stacks(). */
+#define DUMP_WAIT_TIME     0.2     /**< Seconds to wait for a thread to record its stack. */
+
+/*=================================================================
+ *  Global/Static Definitions
+ *=================================================================*/
+static unsigned int f_uiDefaultTimeout = 0;                 /**< Default timeout (ms), 0 for none. */
+static CU_TimeoutAction f_action = CU_TIMEOUT_ABORT_TEST;   /**< Action on a test function timeout. */
+
+static CU_pThread f_pWatchdog = NULL;       /**< The watchdog thread, NULL if not started. */
+static CU_pMutex  f_pMutex = NULL;          /**< Protects the watchdog state below. */
+static CU_pCond   f_pCond = NULL;           /**< Signalled when the watchdog state changes. */
+static CU_BOOL    f_bStop = CU_FALSE;       /**< Set to stop the watchdog thread. */
+static CU_BOOL    f_bArmed = CU_FALSE;      /**< Whether a deadline is armed. */
+static CU_BOOL    f_bExpired = CU_FALSE;    /**< Whether the armed deadline has passed. */
+static double     f_dDeadline = 0.0;        /**< Armed deadline (monotonic time). */
+static unsigned long f_ulDeadline = 0;      /**< Id of the armed deadline. */
+static CU_WatchdogExpiredFunc f_pExpired = NULL;            /**< Called when the deadline passes. */
+static CU_WatchdogInterruptFunc volatile f_pInterrupt = NULL; /**< Called on the armed thread by CU_watchdog_interrupt(). */
+
+/** Whether the deadline armed is that of the calling thread. */
+static CU_THREAD_LOCAL CU_BOOL f_bIsArmedThread = CU_FALSE;
+
+#ifndef _WIN32
+static pthread_t f_armedThread;             /**< Thread that armed the deadline. */
+#ifdef __linux__
+static long f_lArmedTid = 0;                /**< Kernel id of the thread that armed the deadline. */
+#endif
+static CU_BOOL f_bHandlerInstalled = CU_FALSE;  /**< Whether the signal handler is installed. */
+static struct sigaction f_oldAction;            /**< Action of CU_WATCHDOG_SIGNAL before. */
+
+static volatile sig_atomic_t f_iDumpRequest = 0;      /**< Set while a thread is asked for its stack. */
+static volatile sig_atomic_t f_iDumpDone = 0;         /**< Set by the handler when the stack is recorded. */
+static volatile sig_atomic_t f_iInterruptRequest = 0; /**< Set while the armed thread is to be interrupted. */
+static void* f_apDumpFrames[CU_TIMEOUT_MAX_FRAMES];   /**< Stack recorded by the handler. */
+static volatile sig_atomic_t f_nDumpFrames = 0;       /**< Frames in f_apDumpFrames. */
+#endif
+
+/*=================================================================
+ *  Private function forward declarations
+ *=================================================================*/
+static void watchdog_thread(void* pArg);
+static CU_BOOL install_handler(void);
+static void remove_handler(void);
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+CU_ErrorCode CU_set_test_timeout(CU_pTest pTest, unsigned int uiMilliseconds)
+{
+  CU_ErrorCode error = CUE_SUCCESS;
+
+  if (NULL == pTest) {
+    error = CUE_NOTEST;
+  }
+  else {
+    pTest->uiTimeout = uiMilliseconds;
+  }
+
+  CU_set_error(error);
+  return error;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_test_timeout(CU_pTest pTest)
+{
+  if ((NULL == pTest) || (CU_TIMEOUT_NONE == pTest->uiTimeout)) {
+    return 0;
+  }
+  return (0 != pTest->uiTimeout) ? pTest->uiTimeout : f_uiDefaultTimeout;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_set_default_test_timeout(unsigned int uiMilliseconds)
+{
+  f_uiDefaultTimeout = (CU_TIMEOUT_NONE != uiMilliseconds) ? uiMilliseconds : 0;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned int CU_get_default_test_timeout(void)
+{
+  return f_uiDefaultTimeout;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_set_timeout_action(CU_TimeoutAction action)
+{
+  f_action = action;
+}
+
+/*------------------------------------------------------------------------*/
+CU_TimeoutAction CU_get_timeout_action(void)
+{
+#ifdef _WIN32
+  return CU_TIMEOUT_TERMINATE;
+#else
+  return f_action;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+#ifndef _WIN32
+/**
+ *  Asks a thread for its stack and appends it to szStacks.
+ *  Called by CU_get_thread_stacks() on the thread collecting the stacks.
+ *
+ *  @param szStacks  Buffer of STACKS_BUFFER_SIZE characters (non-NULL).
+ *  @param szHeader  Line naming the thread (non-NULL).
+ *  @param pSend     Sends CU_WATCHDOG_SIGNAL to the thread, returns 0 on success.
+ *  @param pTarget   Argument of pSend.
+ */
+static void append_thread_stack(char* szStacks, const char* szHeader,
+                                int (*pSend)(const void*), const void* pTarget)
+{
+  size_t szLength = strlen(szStacks);
+  double dEnd;
+#ifdef __GLIBC__
+  char** ppSymbols;
+  int i;
+#endif
+
+  snprintf(szStacks + szLength, STACKS_BUFFER_SIZE - szLength, "%s\n", szHeader);
+
+  f_iDumpDone = 0;
+  f_nDumpFrames = 0;
+  f_iDumpRequest = 1;
+  if (0 == (*pSend)(pTarget)) {
+    dEnd = CU_get_monotonic_time() + DUMP_WAIT_TIME;
+    while ((0 == f_iDumpDone) && (CU_get_monotonic_time() < dEnd)) {
+      CU_sleep(0.001);
+    }
+  }
+  f_iDumpRequest = 0;
+
+  szLength = strlen(szStacks);
+  if (0 == f_iDumpDone) {
+    snprintf(szStacks + szLength, STACKS_BUFFER_SIZE - szLength, "  %s\n", _("(no response)"));
+    return;
+  }
+#ifdef __GLIBC__
+  ppSymbols = backtrace_symbols(f_apDumpFrames, (int)f_nDumpFrames);
+  if (NULL != ppSymbols) {
+    /* skip the signal handler */
+    for (i = 1 ; i < (int)f_nDumpFrames ; ++i) {
+      szLength = strlen(szStacks);
+      snprintf(szStacks + szLength, STACKS_BUFFER_SIZE - szLength, "  %s\n", ppSymbols[i]);
+    }
+    free(ppSymbols);
+    return;
+  }
+#endif
+  snprintf(szStacks + szLength, STACKS_BUFFER_SIZE - szLength, "  %s\n", _("(no stack trace available)"));
+}
+
+#ifdef __linux__
+/** Sends CU_WATCHDOG_SIGNAL to the thread with the kernel id pointed to by pTid. */
+static int send_to_tid(const void* pTid)
+{
+  return (int)syscall(SYS_tgkill, (long)getpid(), *(const long*)pTid, CU_WATCHDOG_SIGNAL);
+}
+#else
+/** Sends CU_WATCHDOG_SIGNAL to the thread pointed to by pThread. */
+static int send_to_thread(const void* pThread)
+{
+  return pthread_kill(*(const pthread_t*)pThread, CU_WATCHDOG_SIGNAL);
+}
+#endif
+#endif  /* !_WIN32 */
+
+/*------------------------------------------------------------------------*/
+char* CU_get_thread_stacks(void)
+{
+  char* szStacks = (char*)CU_MALLOC(STACKS_BUFFER_SIZE);
+#ifndef _WIN32
+  CU_BOOL bInstalled;
+  char szHeader[64];
+#ifdef __linux__
+  DIR* pDir;
+  struct dirent* pEntry;
+  long lSelf;
+  long lTid;
+#endif
+#endif
+
+  if (NULL == szStacks) {
+    return NULL;
+  }
+  szStacks[0] = '\0';
+
+#ifdef _WIN32
+  snprintf(szStacks, STACKS_BUFFER_SIZE, "%s\n", _("Stack traces are not available on this platform."));
+#else
+  bInstalled = install_handler();
+
+#ifdef __linux__
+  lSelf = (long)syscall(SYS_gettid);
+  pDir = opendir("/proc/self/task");
+  if (NULL != pDir) {
+    while (NULL != (pEntry = readdir(pDir))) {
+      lTid = atol(pEntry->d_name);
+      if ((0 >= lTid) || (lSelf == lTid)) {
+        continue;
+      }
+      snprintf(szHeader, sizeof(szHeader), "%s %ld%s:", _("Thread"), lTid,
+               ((CU_FALSE != f_bArmed) && (f_lArmedTid == lTid)) ? _(" (test)") : "");
+      append_thread_stack(szStacks, szHeader, send_to_tid, &lTid);
+    }
+    closedir(pDir);
+  }
+#else
+  if ((CU_FALSE != f_bArmed) && (CU_FALSE == f_bIsArmedThread)) {
+    snprintf(szHeader, sizeof(szHeader), "%s:", _("Thread (test)"));
+    append_thread_stack(szStacks, szHeader, send_to_thread, &f_armedThread);
+  }
+#endif
+
+  if (CU_FALSE != bInstalled) {
+    remove_handler();
+  }
+#endif  /* _WIN32 */
+
+  szStacks[STACKS_BUFFER_SIZE - 1] = '\0';
+  return szStacks;
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode CU_watchdog_arm(unsigned int uiMilliseconds, unsigned long ulDeadline,
+                             CU_WatchdogExpiredFunc pExpired,
+                             CU_WatchdogInterruptFunc pInterrupt)
+{
+  assert(NULL != pExpired);
+
+  if (NULL == f_pWatchdog) {
+    f_pMutex = CU_mutex_create();
+    f_pCond = CU_cond_create();
+    f_bStop = CU_FALSE;
+    f_bArmed = CU_FALSE;
+    if ((NULL == f_pMutex) || (NULL == f_pCond) ||
+        (NULL == (f_pWatchdog = CU_thread_create(watchdog_thread, NULL)))) {
+      CU_cond_destroy(f_pCond);
+      CU_mutex_destroy(f_pMutex);
+      f_pCond = NULL;
+      f_pMutex = NULL;
+      return CUE_NOMEMORY;
+    }
+    install_handler();
+  }
+
+  CU_mutex_lock(f_pMutex);
+  f_dDeadline = CU_get_monotonic_time() + (double)uiMilliseconds / 1000.0;
+  f_ulDeadline = ulDeadline;
+  f_pExpired = pExpired;
+  f_pInterrupt = pInterrupt;
+  f_bExpired = CU_FALSE;
+  f_bArmed = CU_TRUE;
+#ifndef _WIN32
+  f_iInterruptRequest = 0;
+  f_armedThread = pthread_self();
+#ifdef __linux__
+  f_lArmedTid = (long)syscall(SYS_gettid);
+#endif
+#endif
+  f_bIsArmedThread = CU_TRUE;
+  CU_cond_broadcast(f_pCond);
+  CU_mutex_unlock(f_pMutex);
+
+  return CUE_SUCCESS;
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_watchdog_disarm(void)
+{
+  CU_BOOL bExpired;
+
+  if (NULL == f_pWatchdog) {
+    return CU_FALSE;
+  }
+
+  CU_mutex_lock(f_pMutex);
+  bExpired = ((CU_FALSE != f_bArmed) && (CU_FALSE != f_bExpired)) ? CU_TRUE : CU_FALSE;
+  f_bArmed = CU_FALSE;
+#ifndef _WIN32
+  f_iInterruptRequest = 0;
+#endif
+  f_bIsArmedThread = CU_FALSE;
+  CU_mutex_unlock(f_pMutex);
+
+  return bExpired;
+}
+
+/*------------------------------------------------------------------------*/
+CU_BOOL CU_watchdog_interrupt(void)
+{
+  CU_BOOL bSent = CU_FALSE;
+
+#ifndef _WIN32
+  if (NULL == f_pWatchdog) {
+    return CU_FALSE;
+  }
+
+  CU_mutex_lock(f_pMutex);
+  if ((CU_FALSE != f_bArmed) && (NULL != f_pInterrupt)) {
+    f_iInterruptRequest = 1;
+    bSent = (0 == pthread_kill(f_armedThread, CU_WATCHDOG_SIGNAL)) ? CU_TRUE : CU_FALSE;
+  }
+  CU_mutex_unlock(f_pMutex);
+#endif
+
+  return bSent;
+}
+
+/*------------------------------------------------------------------------*/
+void CU_watchdog_stop(void)
+{
+  if (NULL == f_pWatchdog) {
+    return;
+  }
+
+  CU_mutex_lock(f_pMutex);
+  f_bStop = CU_TRUE;
+  f_bArmed = CU_FALSE;
+  CU_cond_broadcast(f_pCond);
+  CU_mutex_unlock(f_pMutex);
+
+  CU_thread_join(f_pWatchdog);
+  f_pWatchdog = NULL;
+  CU_cond_destroy(f_pCond);
+  CU_mutex_destroy(f_pMutex);
+  f_pCond = NULL;
+  f_pMutex = NULL;
+  remove_handler();
+}
+
+/*=================================================================
+ *  Private functions
+ *=================================================================*/
+/**
+ *  Watchdog thread.  Waits for the armed deadline and calls the
+ *  expiry function once per armed deadline, with the lock released.
+ */
+static void watchdog_thread(void* pArg)
+{
+  CU_WatchdogExpiredFunc pExpired;
+  unsigned long ulDeadline;
+  char* szStacks;
+  double dRemaining;
+
+  CU_UNREFERENCED_PARAMETER(pArg);
+
+  CU_mutex_lock(f_pMutex);
+  while (CU_FALSE == f_bStop) {
+    if ((CU_FALSE == f_bArmed) || (CU_FALSE != f_bExpired)) {
+      CU_cond_wait(f_pCond, f_pMutex, -1.0);
+      continue;
+    }
+    dRemaining = f_dDeadline - CU_get_monotonic_time();
+    if (0.0 < dRemaining) {
+      CU_cond_wait(f_pCond, f_pMutex, dRemaining);
+      continue;
+    }
+
+    f_bExpired = CU_TRUE;
+    pExpired = f_pExpired;
+    ulDeadline = f_ulDeadline;
+    CU_mutex_unlock(f_pMutex);
+
+    szStacks = CU_get_thread_stacks();
+    (*pExpired)(ulDeadline, (NULL != szStacks) ? szStacks : "");
+    if (NULL != szStacks) {
+      CU_FREE(szStacks);
+    }
+
+    CU_mutex_lock(f_pMutex);
+  }
+  CU_mutex_unlock(f_pMutex);
+}
+
+#ifndef _WIN32
+/*------------------------------------------------------------------------*/
+/** Handler of CU_WATCHDOG_SIGNAL, see the file description. */
+static void watchdog_signal_handler(int iSignal)
+{
+  int iErrno = errno;
+  CU_WatchdogInterruptFunc pInterrupt;
+
+  CU_UNREFERENCED_PARAMETER(iSignal);
+
+  if (0 != f_iDumpRequest) {
+    f_iDumpRequest = 0;
+#ifdef __GLIBC__
+    f_nDumpFrames = backtrace(f_apDumpFrames, CU_TIMEOUT_MAX_FRAMES);
+#endif
+    f_iDumpDone = 1;
+  }
+
+  pInterrupt = f_pInterrupt;
+  if ((0 != f_iInterruptRequest) && (CU_FALSE != f_bIsArmedThread) && (NULL != pInterrupt)) {
+    f_iInterruptRequest = 0;
+    errno = iErrno;
+    (*pInterrupt)();
+  }
+  errno = iErrno;
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Installs the handler of CU_WATCHDOG_SIGNAL if it is not installed.
+ *  @return CU_TRUE if the handler was installed by this call.
+ */
+static CU_BOOL install_handler(void)
+{
+#ifndef _WIN32
+  struct sigaction action;
+#ifdef __GLIBC__
+  void* pFrame;
+#endif
+
+  if (CU_FALSE != f_bHandlerInstalled) {
+    return CU_FALSE;
+  }
+
+#ifdef __GLIBC__
+  /* the first call loads libgcc, which is not safe in a signal handler */
+  backtrace(&pFrame, 1);
+#endif
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = watchdog_signal_handler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (0 == sigaction(CU_WATCHDOG_SIGNAL, &action, &f_oldAction)) {
+    f_bHandlerInstalled = CU_TRUE;
+    return CU_TRUE;
+  }
+#endif
+  return CU_FALSE;
+}
+
+/*------------------------------------------------------------------------*/
+/** Restores the action of CU_WATCHDOG_SIGNAL replaced by install_handler(). */
+static void remove_handler(void)
+{
+#ifndef _WIN32
+  if (CU_FALSE != f_bHandlerInstalled) {
+    sigaction(CU_WATCHDOG_SIGNAL, &f_oldAction, NULL);
+    f_bHandlerInstalled = CU_FALSE;
+  }
+#endif
+}
+
+/** @} */
+
+#ifdef CUNIT_BUILD_TESTS
+#include "test_cunit.h"
+
+static void timeout_dummy(void) {}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_set_test_timeout()
+ *      CU_get_test_timeout()
+ *      CU_set_default_test_timeout()
+ *      CU_get_default_test_timeout()
+ *      CU_set_timeout_action()
+ */
+static void test_timeout_settings(void)
+{
+  CU_pSuite pSuite;
+  CU_pTest pTest;
+
+  CU_initialize_registry();
+  pSuite = CU_add_suite("suite1", NULL, NULL);
+  pTest = CU_add_test(pSuite, "test1", timeout_dummy);
+  TEST_FATAL(NULL != pTest);
+
+  TEST(0 == CU_get_default_test_timeout());
+  TEST(0 == CU_get_test_timeout(pTest));
+  TEST(0 == CU_get_test_timeout(NULL));
+
+  TEST(CUE_NOTEST == CU_set_test_timeout(NULL, 10));
+  TEST(CUE_NOTEST == CU_get_error());
+
+  CU_set_default_test_timeout(500);
+  TEST(500 == CU_get_default_test_timeout());
+  TEST(500 == CU_get_test_timeout(pTest));      /* default applies */
+
+  TEST(CUE_SUCCESS == CU_set_test_timeout(pTest, 20));
+  TEST(20 == CU_get_test_timeout(pTest));       /* own timeout wins */
+
+  TEST(CUE_SUCCESS == CU_set_test_timeout(pTest, CU_TIMEOUT_NONE));
+  TEST(0 == CU_get_test_timeout(pTest));        /* opted out of the default */
+
+  TEST(CUE_SUCCESS == CU_set_test_timeout(pTest, 0));
+  TEST(500 == CU_get_test_timeout(pTest));
+
+  CU_set_default_test_timeout(0);
+  TEST(0 == CU_get_test_timeout(pTest));
+
+#ifndef _WIN32
+  TEST(CU_TIMEOUT_ABORT_TEST == CU_get_timeout_action());
+  CU_set_timeout_action(CU_TIMEOUT_TERMINATE);
+  TEST(CU_TIMEOUT_TERMINATE == CU_get_timeout_action());
+  CU_set_timeout_action(CU_TIMEOUT_ABORT_TEST);
+#endif
+
+  CU_cleanup_registry();
+}
+
+static volatile int f_nExpired = 0;
+static unsigned long f_ulExpired = 0;
+static char f_szExpiredStacks[STACKS_BUFFER_SIZE];
+
+static void count_expired(unsigned long ulDeadline, const char* szStacks)
+{
+  strncpy(f_szExpiredStacks, szStacks, sizeof(f_szExpiredStacks) - 1);
+  f_ulExpired = ulDeadline;
+  ++f_nExpired;
+}
+
+/*-------------------------------------------------*/
+/* tests:
+ *      CU_watchdog_arm()
+ *      CU_watchdog_disarm()
+ *      CU_watchdog_stop()
+ *      CU_get_thread_stacks()
+ */
+static void test_watchdog(void)
+{
+  char* szStacks;
+  double dEnd;
+
+  szStacks = CU_get_thread_stacks();
+  TEST_FATAL(NULL != szStacks);
+  CU_FREE(szStacks);
+
+  /* a disarmed deadline never expires */
+  f_nExpired = 0;
+  TEST(CUE_SUCCESS == CU_watchdog_arm(20, 1, count_expired, NULL));
+  TEST(CU_FALSE == CU_watchdog_disarm());
+  CU_sleep(0.05);
+  TEST(0 == f_nExpired);
+
+  /* an armed one expires once */
+  TEST(CUE_SUCCESS == CU_watchdog_arm(20, 2, count_expired, NULL));
+  dEnd = CU_get_monotonic_time() + 2.0;
+  while ((0 == f_nExpired) && (CU_get_monotonic_time() < dEnd)) {
+    CU_sleep(0.005);
+  }
+  CU_sleep(0.05);
+  TEST(1 == f_nExpired);
+  TEST(2 == f_ulExpired);
+#if defined(__linux__) && defined(__GLIBC__)
+  TEST(NULL != strstr(f_szExpiredStacks, "(test)"));   /* the armed thread is traced */
+#endif
+
+  /* rearming starts a new deadline */
+  TEST(CUE_SUCCESS == CU_watchdog_arm(10, 3, count_expired, NULL));
+  dEnd = CU_get_monotonic_time() + 2.0;
+  while ((1 == f_nExpired) && (CU_get_monotonic_time() < dEnd)) {
+    CU_sleep(0.005);
+  }
+  TEST(2 == f_nExpired);
+  TEST(3 == f_ulExpired);
+  TEST(CU_TRUE == CU_watchdog_disarm());        /* reports the expiry */
+  CU_watchdog_stop();
+  CU_watchdog_stop();                           /* stopping twice is harmless */
+}
+
+void test_cunit_Timeout(void)
+{
+  test_cunit_start_tests("Timeout.c");
+
+  test_timeout_settings();
+  test_watchdog();
+
+  test_cunit_end_tests();
+}
+
+#endif    /* CUNIT_BUILD_TESTS */
@@ -34,6 +34,12 @@
  *                Fixed off-by-1 error in CU_translate_special_characters(),
  *                modifying implementation & results in some cases.  User can
  *                now tell if conversion failed. (JDS)
+ *
+ *  18-Oct-2026   Added CU_get_monotonic_time(). (AGT)
+ *
+ *  18-Oct-2026   Table driven translation with SSE2 scan of plain text,
+ *                replacement of control characters, added
+ *                CU_translate_to_buffer(). (AGT)
  */
 
 /** @file
@@ -43,11 +49,25 @@
  @{
 */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime() under -std=c99 */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <assert.h>
 #include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CUNIT_UTIL_SSE2   /* vectorised scan in plain_run() */
+#endif
 
 #include "CUnit.h"
 #include "TestDB.h"
@@ -57,76 +77,109 @@
 /*------------------------------------------------------------------------*/
 /**
  *  Structure containing mappings of special characters to xml entity codes.
- *  special_char's in the CU_bindings array will be translated during calls
- *  to CU_translate_special_characters().  Add additional chars/replacements
- *  or modify existing ones to change the behavior upon translation.
+ *  Characters are mapped to entries of the CU_bindings array by
+ *  f_aucBindingIndex and translated during calls to
+ *  CU_translate_special_characters() and CU_translate_to_buffer().
+ *  Add additional replacements here and index them in f_aucBindingIndex.
  */
 static const struct bindings {
-	const char special_char;    /**< Special character. */
 	const char *replacement;    /**< Entity code for special character. */
+	const size_t length;        /**< Length of replacement. */
 } CU_bindings [] = {
-    {'&', "&amp;"},
-    {'>', "&gt;"},
-    {'<', "&lt;"},
-    {'"', "&quot;"},
-    {'\'', "&apos;"}
+    {"", 0},                    /* index 0 - not translated */
+    {"&amp;", 5},
+    {"&gt;", 4},
+    {"&lt;", 4},
+    {"&quot;", 6},
+    {"&apos;", 6},
+    {"&#xFFFD;", 8}             /* control characters are not allowed in xml 1.0 */
+};
+
+/**
+ *  Index into CU_bindings for each character value (0 if the character
+ *  is copied unchanged).  Control characters other than tab, newline
+ *  and carriage return are replaced by U+FFFD.
+ */
+static const unsigned char f_aucBindingIndex[256] = {
+  0, 6, 6, 6, 6, 6, 6, 6, 6, 0, 0, 6, 6, 0, 6, 6,   /* 0x00 - 0x0F */
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,   /* 0x10 - 0x1F */
+  0, 0, 4, 0, 0, 0, 1, 5, 0, 0, 0, 0, 0, 0, 0, 0,   /* 0x20 - 0x2F  " & ' */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 2, 0,   /* 0x30 - 0x3F  < > */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   /* 0x80 - 0xFF  copied */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
 /*------------------------------------------------------------------------*/
 /**
- *  Checks whether a character is a special xml character.
- *  This function performs a lookup of the specified character in
- *  the CU_bindings structure.  If it is a special character, its
- *  index into the CU_bindings array is returned.  If not, -1 is returned.
+ *  Counts the characters at the start of [pStart, pEnd) which are copied
+ *  unchanged by translation.  Where SSE2 is available, 16 characters are
+ *  checked at a time for '&', '<', '>', '"', '\'' and control characters;
+ *  blocks holding one of these (including tab and newline) are finished
+ *  with the table.
  *
- *  @param ch The character to check
- *  @return Index into CU_bindings if a special character, -1 otherwise.
+ *  @param pStart Start of the characters to check.
+ *  @param pEnd   End of the characters to check.
+ *  @return Number of characters before the first one to translate.
  */
-static int get_index(const char ch)
+static size_t plain_run(const unsigned char* pStart, const unsigned char* pEnd)
 {
-	int length = sizeof(CU_bindings)/sizeof(CU_bindings[0]);
-	int counter;
-
-	for (counter = 0; counter < length && CU_bindings[counter].special_char != ch; ++counter) {
-		;
-	}
-
-	return (counter < length ? counter : -1);
+  const unsigned char* p = pStart;
+  const unsigned char* pStop;
+#ifdef CUNIT_UTIL_SSE2
+  const __m128i vControl = _mm_set1_epi8(0x1F);
+  const __m128i vAmp = _mm_set1_epi8('&');
+  const __m128i vLt = _mm_set1_epi8('<');
+  const __m128i vGt = _mm_set1_epi8('>');
+  const __m128i vQuot = _mm_set1_epi8('"');
+  const __m128i vApos = _mm_set1_epi8('\'');
+  __m128i v;
+  __m128i vHit;
+#endif
+
+  for (;;) {
+#ifdef CUNIT_UTIL_SSE2
+    while ((pEnd - p) >= 16) {
+      v = _mm_loadu_si128((const __m128i*)p);
+      vHit = _mm_cmpeq_epi8(_mm_max_epu8(v, vControl), vControl);   /* v <= 0x1F */
+      vHit = _mm_or_si128(vHit, _mm_cmpeq_epi8(v, vAmp));
+      vHit = _mm_or_si128(vHit, _mm_cmpeq_epi8(v, vLt));
+      vHit = _mm_or_si128(vHit, _mm_cmpeq_epi8(v, vGt));
+      vHit = _mm_or_si128(vHit, _mm_cmpeq_epi8(v, vQuot));
+      vHit = _mm_or_si128(vHit, _mm_cmpeq_epi8(v, vApos));
+      if (0 != _mm_movemask_epi8(vHit)) {
+        break;
+      }
+      p += 16;
+    }
+#endif
+    pStop = ((pEnd - p) > 16) ? p + 16 : pEnd;
+    while ((p < pStop) && (0 == f_aucBindingIndex[*p])) {
+      ++p;
+    }
+    if ((p < pStop) || (p == pEnd)) {
+      return (size_t)(p - pStart);
+    }
+  }
 }
 
+/*------------------------------------------------------------------------*/
 size_t CU_translate_special_characters(const char *szSrc, char *szDest, size_t maxlen)
 {
-/* old implementation
   size_t count = 0;
-	size_t src = 0;
-	size_t dest = 0;
-	size_t length = 0;
-	int conv_index;
-
-  assert(NULL != szSrc);
-  assert(NULL != szDest);
-
-	length = strlen(szSrc);
-	memset(szDest, 0, maxlen);
-	while ((dest < maxlen) && (src < length)) {
-
-		if ((-1 != (conv_index = get_index(szSrc[src]))) &&
-        ((dest + strlen(CU_bindings[conv_index].replacement)) < maxlen)) {
-			strcat(szDest, CU_bindings[conv_index].replacement);
-			dest += strlen(CU_bindings[conv_index].replacement);
-			++count;
-		} else {
-			szDest[dest++] = szSrc[src];
-		}
-
-		++src;
-	}
-
-	return count;
-*/
-  size_t count = 0;
-  size_t repl_len;
-  int conv_index;
+  size_t run;
+  const struct bindings* pBinding;
+  const unsigned char* pSrc = (const unsigned char*)szSrc;
+  const unsigned char* pEnd;
   char *dest_start = szDest;
 
   assert(NULL != szSrc);
@@ -134,25 +187,32 @@ size_t CU_translate_special_characters(const char *szSrc, char *szDest, size_t m
 
   /* only process if destination buffer not 0-length */
   if (maxlen > 0) {
-
-    while ((maxlen > 0) && (*szSrc != '\0')) {
-      conv_index = get_index(*szSrc);
-      if (-1 != conv_index) {
-        if (maxlen > (repl_len = strlen(CU_bindings[conv_index].replacement))) {
-			    memcpy(szDest, CU_bindings[conv_index].replacement, repl_len);
-			    szDest += repl_len;
-          maxlen -= repl_len;
-			    ++count;
-        } else {
+    pEnd = pSrc + strlen(szSrc);
+
+    while (pSrc < pEnd) {
+      run = plain_run(pSrc, pEnd);
+      if (run >= maxlen) {
+        maxlen = 0;     /* ran out of room - abort conversion */
+        break;
+      }
+      memcpy(szDest, pSrc, run);
+      szDest += run;
+      maxlen -= run;
+      pSrc += run;
+
+      if (pSrc < pEnd) {
+        pBinding = &CU_bindings[f_aucBindingIndex[*pSrc]];
+        if (pBinding->length >= maxlen) {
           maxlen = 0;   /* ran out of room - abort conversion */
           break;
         }
-		  } else {
-			  *szDest++ = *szSrc;
-        --maxlen;
-		  }
-		  ++szSrc;
-	  }
+        memcpy(szDest, pBinding->replacement, pBinding->length);
+        szDest += pBinding->length;
+        maxlen -= pBinding->length;
+        ++count;
+        ++pSrc;
+      }
+    }
 
     if (0 == maxlen) {
       *dest_start = '\0';   /* ran out of room - return empty string in szDest */
@@ -167,20 +227,87 @@ size_t CU_translate_special_characters(const char *szSrc, char *szDest, size_t m
 /*------------------------------------------------------------------------*/
 size_t CU_translated_strlen(const char* szSrc)
 {
-	size_t count = 0;
-  int conv_index;
+  const unsigned char* pSrc = (const unsigned char*)szSrc;
+  const unsigned char* pEnd;
+  size_t count;
 
   assert(NULL != szSrc);
 
-	while (*szSrc != '\0') {
-    if (-1 != (conv_index = get_index(*szSrc))) {
-      count += strlen(CU_bindings[conv_index].replacement);
-    } else {
-      ++count;
+  pEnd = pSrc + strlen(szSrc);
+  count = (size_t)(pEnd - pSrc);
+  while (pSrc < pEnd) {
+    pSrc += plain_run(pSrc, pEnd);
+    if (pSrc < pEnd) {
+      count += CU_bindings[f_aucBindingIndex[*pSrc]].length - 1;
+      ++pSrc;
     }
-    ++szSrc;
   }
-	return count;
+  return count;
+}
+
+/*------------------------------------------------------------------------*/
+/**
+ *  Makes sure a buffer from CU_translate_to_buffer() holds at least
+ *  szNeeded characters.
+ *  @return CU_TRUE on success, CU_FALSE if memory could not be allocated.
+ */
+static CU_BOOL reserve_buffer(char **pszBuffer, size_t *pLength, size_t szNeeded)
+{
+  char *szNew;
+  size_t szNewLength;
+
+  if (szNeeded <= *pLength) {
+    return CU_TRUE;
+  }
+  szNewLength = (szNeeded > 2 * *pLength) ? szNeeded : 2 * *pLength;
+  szNew = (NULL == *pszBuffer) ? (char *)CU_MALLOC(szNewLength)
+                               : (char *)CU_REALLOC(*pszBuffer, szNewLength);
+  if (NULL == szNew) {
+    return CU_FALSE;
+  }
+  *pszBuffer = szNew;
+  *pLength = szNewLength;
+  return CU_TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+const char* CU_translate_to_buffer(const char *szSrc, char **pszBuffer, size_t *pLength)
+{
+  const unsigned char* pSrc = (const unsigned char*)szSrc;
+  const unsigned char* pEnd;
+  const struct bindings* pBinding;
+  size_t run;
+  size_t dest = 0;
+
+  assert(NULL != szSrc);
+  assert(NULL != pszBuffer);
+  assert(NULL != pLength);
+
+  /* room for an untranslated copy; grown as replacements are written */
+  pEnd = pSrc + strlen(szSrc);
+  if (CU_FALSE == reserve_buffer(pszBuffer, pLength, (size_t)(pEnd - pSrc) + 1)) {
+    return NULL;
+  }
+
+  while (pSrc < pEnd) {
+    run = plain_run(pSrc, pEnd);
+    memcpy(*pszBuffer + dest, pSrc, run);
+    dest += run;
+    pSrc += run;
+
+    if (pSrc < pEnd) {
+      pBinding = &CU_bindings[f_aucBindingIndex[*pSrc]];
+      ++pSrc;
+      if (CU_FALSE == reserve_buffer(pszBuffer, pLength, dest + pBinding->length + (size_t)(pEnd - pSrc) + 1)) {
+        return NULL;
+      }
+      memcpy(*pszBuffer + dest, pBinding->replacement, pBinding->length);
+      dest += pBinding->length;
+    }
+  }
+
+  (*pszBuffer)[dest] = '\0';
+  return *pszBuffer;
 }
 
 /*------------------------------------------------------------------------*/
@@ -253,6 +380,27 @@ size_t CU_number_width(int number)
 	return (strlen(buf));
 }
 
+/*------------------------------------------------------------------------*/
+double CU_get_monotonic_time(void)
+{
+#if defined(_WIN32)
+  LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+
+  if (QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&now)) {
+    return (double)now.QuadPart / (double)freq.QuadPart;
+  }
+#elif defined(_POSIX_TIMERS) && (_POSIX_TIMERS > 0) && defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+
+  if (0 == clock_gettime(CLOCK_MONOTONIC, &ts)) {
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1.0e9;
+  }
+#endif
+  /* fall back to processor time if no monotonic clock is available */
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+}
+
 /** @} */
 
 #ifdef CUNIT_BUILD_TESTS
@@ -396,6 +544,31 @@ static void test_CU_translate_special_characters(void)
   TEST(11 == CU_translate_special_characters("<><><<>>&&&", dest, MAX_LEN));
   TEST(!strncmp(dest_buf, ref_buf, MAX_LEN));
   TEST(!strcmp(dest, "&lt;&gt;&lt;&gt;&lt;&lt;&gt;&gt;&amp;&amp;&amp;"));
+
+  /* quotes and control characters */
+  memset(dest_buf, mask_char, BUF_LEN);
+  TEST(5 == CU_translate_special_characters("'a'\t\"b\"\x01\n", dest, MAX_LEN));
+  TEST(!strncmp(dest_buf, ref_buf, MAX_LEN));
+  TEST(!strcmp(dest, "&apos;a&apos;\t&quot;b&quot;&#xFFFD;\n"));
+
+  memset(dest_buf, mask_char, BUF_LEN);
+  TEST(0 == CU_translate_special_characters("a\x01", dest, 9));
+  TEST(!strncmp(dest, "\0", 1));
+  TEST(!strncmp((dest+9), ref_buf, MAX_LEN-9));
+
+  memset(dest_buf, mask_char, BUF_LEN);
+  TEST(1 == CU_translate_special_characters("a\x01", dest, 10));
+  TEST(!strcmp(dest, "a&#xFFFD;"));
+
+  /* long plain runs, as scanned 16 characters at a time */
+  memset(dest_buf, mask_char, BUF_LEN);
+  TEST(1 == CU_translate_special_characters("0123456789abcdef0123456789abcdef0123456789&", dest, MAX_LEN));
+  TEST(!strcmp(dest, "0123456789abcdef0123456789abcdef0123456789&amp;"));
+
+  memset(dest_buf, mask_char, BUF_LEN);
+  TEST(0 == CU_translate_special_characters("0123456789abcdef0123456789abcdef", dest, 32));
+  TEST(!strncmp(dest, "\0", 1));
+  TEST(!strncmp((dest+32), ref_buf, MAX_LEN-32));
 }
 
 static void test_CU_translated_strlen(void)
@@ -419,6 +592,63 @@ static void test_CU_translated_strlen(void)
   TEST(37 == CU_translated_strlen("some <<string & another>"));
   TEST(22 == CU_translated_strlen("some string or another"));
   TEST(47 == CU_translated_strlen("<><><<>>&&&"));
+
+  /* quotes and control characters */
+  TEST(6 == CU_translated_strlen("\""));
+  TEST(6 == CU_translated_strlen("'"));
+  TEST(3 == CU_translated_strlen("\t\n\r"));
+  TEST(8 == CU_translated_strlen("\x01"));
+  TEST(18 == CU_translated_strlen("a\x1F\x1B" "b"));
+  TEST(4 == CU_translated_strlen("\x7F\xC3\xA9\xFF"));
+  TEST(36 == CU_translated_strlen("0123456789abcdef0123456789abcde&"));
+}
+
+static void test_CU_translate_to_buffer(void)
+{
+  char *szBuffer = NULL;
+  size_t szLength = 0;
+  char szLong[200];
+  char szExpected[2000];
+  char *szBufferBefore;
+  size_t i;
+  size_t j;
+  CU_BOOL bSame = CU_TRUE;
+
+  TEST(!strcmp("", CU_translate_to_buffer("", &szBuffer, &szLength)));
+  TEST(NULL != szBuffer);
+  TEST(szLength >= 1);
+
+  TEST(!strcmp("some string or another", CU_translate_to_buffer("some string or another", &szBuffer, &szLength)));
+  TEST(!strcmp("some &lt;&lt;string &amp; another&gt;", CU_translate_to_buffer("some <<string & another>", &szBuffer, &szLength)));
+  TEST(!strcmp("&quot;q&quot; &apos;a&apos;", CU_translate_to_buffer("\"q\" 'a'", &szBuffer, &szLength)));
+  TEST(!strcmp("tab\tline\n&#xFFFD;end\r", CU_translate_to_buffer("tab\tline\n\x02" "end\r", &szBuffer, &szLength)));
+  TEST(!strcmp("&#xFFFD;&#xFFFD;&#xFFFD;", CU_translate_to_buffer("\x01\x1F\x0B", &szBuffer, &szLength)));
+  TEST(!strcmp("\xC3\xA9t\xC3\xA9", CU_translate_to_buffer("\xC3\xA9t\xC3\xA9", &szBuffer, &szLength)));
+
+  /* no allocation once the buffer is large enough */
+  szBufferBefore = szBuffer;
+  TEST(!strcmp("&lt;&gt;", CU_translate_to_buffer("<>", &szBuffer, &szLength)));
+  TEST(szBuffer == szBufferBefore);
+
+  /* special characters at every position around the 16 character blocks */
+  for (i = 0 ; i < sizeof(szLong) - 1 ; ++i) {
+    for (j = 0 ; j < sizeof(szLong) - 1 ; ++j) {
+      szLong[j] = (char)('a' + (j % 26));
+    }
+    szLong[sizeof(szLong) - 1] = '\0';
+    szLong[i] = "&<>\"'\x01\t"[i % 7];
+    if ((i + 17) < sizeof(szLong) - 1) {
+      szLong[i + 17] = '<';
+    }
+    CU_translate_special_characters(szLong, szExpected, sizeof(szExpected));
+    if ((0 != strcmp(szExpected, CU_translate_to_buffer(szLong, &szBuffer, &szLength))) ||
+        (strlen(szExpected) != CU_translated_strlen(szLong))) {
+      bSame = CU_FALSE;
+    }
+  }
+  TEST(CU_FALSE != bSame);
+
+  CU_FREE(szBuffer);
 }
 
 static void test_CU_compare_strings(void)
@@ -592,6 +822,21 @@ static void test_CU_number_width(void)
   TEST(9 == CU_number_width(-45622572));
 }
 
+static void test_CU_get_monotonic_time(void)
+{
+  double t1;
+  double t2;
+  int i;
+
+  t1 = CU_get_monotonic_time();
+  TEST(t1 >= 0.0);
+  for (i=0 ; i<100 ; ++i) {
+    t2 = CU_get_monotonic_time();
+    TEST(t2 >= t1);
+    t1 = t2;
+  }
+}
+
 void test_cunit_Util(void)
 {
 
@@ -599,11 +844,13 @@ void test_cunit_Util(void)
 
   test_CU_translate_special_characters();
   test_CU_translated_strlen();
+  test_CU_translate_to_buffer();
   test_CU_compare_strings();
   test_CU_trim();
   test_CU_trim_left();
   test_CU_trim_right();
   test_CU_number_width();
+  test_CU_get_monotonic_time();
 
   test_cunit_end_tests();
 }
@@ -40,6 +40,7 @@
 
 #include "CUnit.h"
 #include "MyMem.h"
+#include "CUThread.h"
 #include "Util.h"
 #include "CUnit_intl.h"
 #include "test_cunit.h"
@@ -62,8 +63,16 @@ int main()
   fprintf(stdout, "\n%s", _("Testing CUnit internals..."));
 
 	/* individual module test functions go here */
+  test_cunit_AllocTrack();
+  test_cunit_AllocFail();
   test_cunit_CUError();
+  test_cunit_CUThread();
+  test_cunit_Isolation();
+  test_cunit_Timeout();
+  test_cunit_Shard();
+  test_cunit_LoadTest();
   test_cunit_MyMem();
+  test_cunit_SoakTest();
   test_cunit_TestDB();
   test_cunit_TestRun();
   test_cunit_Util();
@@ -25,6 +25,7 @@
 #include "Automated.h"
 #include "Report_CUnit.h"
 #include "Report_JUnit.h"
+#include "Report_Binary.h"
 #include "ExampleTests.h"
 
 int main(int argc, char* argv[])
@@ -64,30 +65,22 @@ int main(int argc, char* argv[])
   }
 
   if (CU_TRUE == Run) {
-    /* Run with CUnit report output */
+    /* Run once with CUnit, JUnit and binary report output */
     if (CU_initialize_registry()) {
       printf("\nInitialization of Test Registry failed.");
     }
     else {
       AddTests();
       CU_automated_set_report_format(CU_REPORT_FORMAT_CUNIT);
-      CU_set_output_filename("TestAutomated_CUnit");
+      CU_automated_add_report_format(CU_REPORT_FORMAT_JUNIT);
+      CU_automated_add_report_format(CU_REPORT_FORMAT_BINARY);
+      CU_REPORT_FORMAT_CUNIT->pSetOutputFilename("TestAutomated_CUnit");
+      CU_REPORT_FORMAT_JUNIT->pSetOutputFilename("TestAutomated_JUnit");
+      CU_REPORT_FORMAT_BINARY->pSetOutputFilename("TestAutomated_Binary");
       CU_list_tests_to_file();
       CU_automated_run_tests();
       CU_cleanup_registry();
     }
-
-    /* Run with JUnit report output */
-    if (CU_initialize_registry()) {
-      printf("\nInitialization of Test Registry failed.");
-    }
-    else {
-      AddTests();
-      CU_automated_set_report_format(CU_REPORT_FORMAT_JUNIT);
-      CU_set_output_filename("TestAutomated_JUnit");
-      CU_automated_run_tests();
-      CU_cleanup_registry();
-    }
   }
 
   return 0;
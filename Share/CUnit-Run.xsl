@@ -76,7 +76,7 @@
 		<tr bgcolor="#e0f0d0">
 			<td> </td>
 			<td colspan="2">
-				Running test <xsl:apply-templates/>...
+				Running test <xsl:value-of select="TEST_NAME"/>...
 			</td>
 			<td bgcolor="#50ff50"> Passed </td>
 		</tr>
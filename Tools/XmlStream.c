@@ -0,0 +1,600 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Minimal streaming (pull) reader for CUnit xml reports.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Streaming xml reader for CUnit report tools (implementation).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+
+#include "XmlStream.h"
+
+/** Reader state. */
+struct XmlStream
+{
+  FILE*         pFile;        /**< Input file. */
+  int           bOwnFile;     /**< Whether pFile is closed by xml_stream_close(). */
+  char          buf[XML_STREAM_BUFSIZE]; /**< Input buffer. */
+  size_t        pos;          /**< Read position in buf. */
+  size_t        len;          /**< Number of valid bytes in buf. */
+  long long     llOffset;     /**< Byte offset of buf[pos] in the input. */
+  long long     llTagOffset;  /**< Byte offset of the current tag. */
+  unsigned long ulLine;       /**< Current line number. */
+  int           iDepth;       /**< Current element depth. */
+  int           bPendingEnd;  /**< Empty element - XML_END is due next. */
+  int           bPendingTag;  /**< A '<' has been consumed but not yet parsed. */
+  XmlEvent      eDone;        /**< XML_EOF or XML_ERROR once finished, else 0. */
+  const char*   szError;      /**< Last error message. */
+
+  char*         szName;       /**< Current element name. */
+  size_t        nameLen;
+  size_t        nameCap;
+  char*         szText;       /**< Character data buffer. */
+  size_t        textLen;
+  size_t        textCap;
+  const char*   szTextStart;  /**< Trimmed start of character data. */
+  char*         szAttrs;      /**< Attributes as name\\0value\\0 pairs. */
+  size_t        attrLen;
+  size_t        attrCap;
+};
+
+/*------------------------------------------------------------------------*/
+/** Appends a character to a growable buffer.
+ *  @return 0 on success, -1 if memory could not be allocated.
+ */
+static int buf_append(char** ppBuf, size_t* pLen, size_t* pCap, char ch)
+{
+  char* pNew;
+
+  if ((*pLen + 1) >= *pCap) {
+    size_t newCap = (0 == *pCap) ? 256 : (*pCap * 2);
+    if (NULL == (pNew = (char*)realloc(*ppBuf, newCap))) {
+      return -1;
+    }
+    *ppBuf = pNew;
+    *pCap = newCap;
+  }
+  (*ppBuf)[(*pLen)++] = ch;
+  (*ppBuf)[*pLen] = '\0';
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+static int next_char(XmlStream* pStream)
+{
+  int ch;
+
+  if (pStream->pos >= pStream->len) {
+    pStream->len = fread(pStream->buf, 1, XML_STREAM_BUFSIZE, pStream->pFile);
+    pStream->pos = 0;
+    if (0 == pStream->len) {
+      return EOF;
+    }
+  }
+  ch = (unsigned char)pStream->buf[pStream->pos++];
+  ++pStream->llOffset;
+  if ('\n' == ch) {
+    ++pStream->ulLine;
+  }
+  return ch;
+}
+
+/*------------------------------------------------------------------------*/
+static int peek_char(XmlStream* pStream)
+{
+  if (pStream->pos >= pStream->len) {
+    pStream->len = fread(pStream->buf, 1, XML_STREAM_BUFSIZE, pStream->pFile);
+    pStream->pos = 0;
+    if (0 == pStream->len) {
+      return EOF;
+    }
+  }
+  return (unsigned char)pStream->buf[pStream->pos];
+}
+
+/*------------------------------------------------------------------------*/
+static XmlEvent fail(XmlStream* pStream, const char* szError)
+{
+  pStream->szError = szError;
+  pStream->eDone = XML_ERROR;
+  return XML_ERROR;
+}
+
+/*------------------------------------------------------------------------*/
+/** Skips input up to and including szTerm.
+ *  @return 0 on success, -1 if end of input was reached first.
+ */
+static int skip_past(XmlStream* pStream, const char* szTerm)
+{
+  size_t termLen = strlen(szTerm);
+  size_t matched = 0;
+  int ch;
+
+  while (EOF != (ch = next_char(pStream))) {
+    if (ch == szTerm[matched]) {
+      if (++matched == termLen) {
+        return 0;
+      }
+    }
+    else {
+      matched = (ch == szTerm[0]) ? 1 : 0;
+    }
+  }
+  return -1;
+}
+
+/*------------------------------------------------------------------------*/
+/** Appends the UTF-8 encoding of code point cp to a buffer. */
+static int append_utf8(char** ppBuf, size_t* pLen, size_t* pCap, unsigned long cp)
+{
+  int result = 0;
+
+  if (cp < 0x80) {
+    result |= buf_append(ppBuf, pLen, pCap, (char)cp);
+  }
+  else if (cp < 0x800) {
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0xC0 | (cp >> 6)));
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0x80 | (cp & 0x3F)));
+  }
+  else if (cp < 0x10000) {
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0xE0 | (cp >> 12)));
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0x80 | ((cp >> 6) & 0x3F)));
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0x80 | (cp & 0x3F)));
+  }
+  else {
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0xF0 | (cp >> 18)));
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0x80 | ((cp >> 12) & 0x3F)));
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0x80 | ((cp >> 6) & 0x3F)));
+    result |= buf_append(ppBuf, pLen, pCap, (char)(0x80 | (cp & 0x3F)));
+  }
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+/** Decodes an entity reference (the '&' has already been read) and
+ *  appends the result to a buffer.  Unknown entities are copied as-is.
+ */
+static int read_entity(XmlStream* pStream, char** ppBuf, size_t* pLen, size_t* pCap)
+{
+  char entity[12];
+  size_t n = 0;
+  int ch;
+  unsigned long cp;
+  char* pEnd;
+
+  while ((n < sizeof(entity) - 1) && (EOF != (ch = peek_char(pStream))) && (';' != ch)
+         && ('<' != ch) && ('&' != ch) && !isspace(ch)) {
+    entity[n++] = (char)next_char(pStream);
+  }
+  entity[n] = '\0';
+
+  if (';' == peek_char(pStream)) {
+    next_char(pStream);
+    if (0 == strcmp(entity, "amp"))  return buf_append(ppBuf, pLen, pCap, '&');
+    if (0 == strcmp(entity, "lt"))   return buf_append(ppBuf, pLen, pCap, '<');
+    if (0 == strcmp(entity, "gt"))   return buf_append(ppBuf, pLen, pCap, '>');
+    if (0 == strcmp(entity, "quot")) return buf_append(ppBuf, pLen, pCap, '"');
+    if (0 == strcmp(entity, "apos")) return buf_append(ppBuf, pLen, pCap, '\'');
+    if ('#' == entity[0]) {
+      cp = ('x' == entity[1]) ? strtoul(entity + 2, &pEnd, 16) : strtoul(entity + 1, &pEnd, 10);
+      if (('\0' == *pEnd) && (cp > 0) && (cp <= 0x10FFFF)) {
+        return append_utf8(ppBuf, pLen, pCap, cp);
+      }
+    }
+    /* unknown entity - keep the original text */
+    if (0 != buf_append(ppBuf, pLen, pCap, '&')) return -1;
+    for (n = 0 ; '\0' != entity[n] ; ++n) {
+      if (0 != buf_append(ppBuf, pLen, pCap, entity[n])) return -1;
+    }
+    return buf_append(ppBuf, pLen, pCap, ';');
+  }
+
+  /* not terminated - treat '&' as a literal */
+  if (0 != buf_append(ppBuf, pLen, pCap, '&')) return -1;
+  for (n = 0 ; '\0' != entity[n] ; ++n) {
+    if (0 != buf_append(ppBuf, pLen, pCap, entity[n])) return -1;
+  }
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+static int is_name_char(int ch)
+{
+  return (EOF != ch) && !isspace(ch) && ('>' != ch) && ('/' != ch) && ('=' != ch);
+}
+
+/*------------------------------------------------------------------------*/
+static void skip_space(XmlStream* pStream)
+{
+  int ch;
+  while ((EOF != (ch = peek_char(pStream))) && isspace(ch)) {
+    next_char(pStream);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Handles markup beginning with "<!" or "<?" (the '<' has been read).
+ *  Comments, processing instructions and declarations are skipped,
+ *  CDATA sections are appended to the character data.
+ *  @return 0 on success, -1 on error (pStream->szError set).
+ */
+static int skip_special(XmlStream* pStream)
+{
+  int ch = next_char(pStream);
+  int iNest = 0;
+
+  if ('?' == ch) {
+    if (0 != skip_past(pStream, "?>")) {
+      pStream->szError = "unterminated processing instruction";
+      return -1;
+    }
+    return 0;
+  }
+
+  /* '!' */
+  if ('-' == peek_char(pStream)) {
+    next_char(pStream);
+    if (('-' != next_char(pStream)) || (0 != skip_past(pStream, "-->"))) {
+      pStream->szError = "unterminated comment";
+      return -1;
+    }
+    return 0;
+  }
+
+  if ('[' == peek_char(pStream)) {
+    if (0 != skip_past(pStream, "CDATA[")) {
+      pStream->szError = "unterminated CDATA section";
+      return -1;
+    }
+    for (;;) {
+      if (EOF == (ch = next_char(pStream))) {
+        pStream->szError = "unterminated CDATA section";
+        return -1;
+      }
+      if (0 != buf_append(&pStream->szText, &pStream->textLen, &pStream->textCap, (char)ch)) {
+        pStream->szError = "out of memory";
+        return -1;
+      }
+      if ((pStream->textLen >= 3) && (0 == strcmp(pStream->szText + pStream->textLen - 3, "]]>"))) {
+        pStream->textLen -= 3;
+        pStream->szText[pStream->textLen] = '\0';
+        return 0;
+      }
+    }
+  }
+
+  /* <!DOCTYPE ...> with optional internal subset */
+  while (EOF != (ch = next_char(pStream))) {
+    if ('[' == ch) {
+      ++iNest;
+    }
+    else if (']' == ch) {
+      --iNest;
+    }
+    else if (('>' == ch) && (iNest <= 0)) {
+      return 0;
+    }
+  }
+  pStream->szError = "unterminated declaration";
+  return -1;
+}
+
+/*------------------------------------------------------------------------*/
+/** Parses a start or end tag (the '<' has been read). */
+static XmlEvent read_tag(XmlStream* pStream)
+{
+  int ch;
+  int bEnd = 0;
+  char quote;
+
+  pStream->nameLen = 0;
+  pStream->attrLen = 0;
+  if (NULL != pStream->szName) {
+    pStream->szName[0] = '\0';
+  }
+
+  if ('/' == peek_char(pStream)) {
+    next_char(pStream);
+    bEnd = 1;
+  }
+
+  while (is_name_char(peek_char(pStream))) {
+    if (0 != buf_append(&pStream->szName, &pStream->nameLen, &pStream->nameCap, (char)next_char(pStream))) {
+      return fail(pStream, "out of memory");
+    }
+  }
+  if (0 == pStream->nameLen) {
+    return fail(pStream, "missing element name");
+  }
+
+  if (0 != bEnd) {
+    skip_space(pStream);
+    if ('>' != next_char(pStream)) {
+      return fail(pStream, "malformed end tag");
+    }
+    --pStream->iDepth;
+    return XML_END;
+  }
+
+  ++pStream->iDepth;
+
+  for (;;) {
+    skip_space(pStream);
+    ch = next_char(pStream);
+    if ('>' == ch) {
+      return XML_START;
+    }
+    if ('/' == ch) {
+      if ('>' != next_char(pStream)) {
+        return fail(pStream, "malformed empty element tag");
+      }
+      pStream->bPendingEnd = 1;
+      return XML_START;
+    }
+    if (!is_name_char(ch)) {
+      return fail(pStream, "malformed start tag");
+    }
+
+    /* attribute name */
+    do {
+      if (0 != buf_append(&pStream->szAttrs, &pStream->attrLen, &pStream->attrCap, (char)ch)) {
+        return fail(pStream, "out of memory");
+      }
+    } while (is_name_char(peek_char(pStream)) && (ch = next_char(pStream)));
+    if (0 != buf_append(&pStream->szAttrs, &pStream->attrLen, &pStream->attrCap, '\0')) {
+      return fail(pStream, "out of memory");
+    }
+
+    skip_space(pStream);
+    if ('=' != next_char(pStream)) {
+      return fail(pStream, "attribute without value");
+    }
+    skip_space(pStream);
+    ch = next_char(pStream);
+    if (('"' != ch) && ('\'' != ch)) {
+      return fail(pStream, "unquoted attribute value");
+    }
+    quote = (char)ch;
+
+    /* attribute value */
+    while (quote != (ch = next_char(pStream))) {
+      if (EOF == ch) {
+        return fail(pStream, "unterminated attribute value");
+      }
+      if ((('&' == ch) && (0 != read_entity(pStream, &pStream->szAttrs, &pStream->attrLen, &pStream->attrCap)))
+          || (('&' != ch) && (0 != buf_append(&pStream->szAttrs, &pStream->attrLen, &pStream->attrCap, (char)ch)))) {
+        return fail(pStream, "out of memory");
+      }
+    }
+    if (0 != buf_append(&pStream->szAttrs, &pStream->attrLen, &pStream->attrCap, '\0')) {
+      return fail(pStream, "out of memory");
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Trims the character data and reports whether any is left. */
+static int have_text(XmlStream* pStream)
+{
+  char* pStart;
+  char* pEnd;
+
+  if (0 == pStream->textLen) {
+    return 0;
+  }
+  pStart = pStream->szText;
+  pEnd = pStream->szText + pStream->textLen;
+  while ((pStart < pEnd) && isspace((unsigned char)*pStart)) {
+    ++pStart;
+  }
+  while ((pEnd > pStart) && isspace((unsigned char)pEnd[-1])) {
+    --pEnd;
+  }
+  *pEnd = '\0';
+  pStream->szTextStart = pStart;
+  return (pEnd > pStart);
+}
+
+/*=================================================================
+ *  Public Interface functions
+ *=================================================================*/
+XmlStream* xml_stream_open(const char* szFilename)
+{
+  XmlStream* pStream;
+
+  assert(NULL != szFilename);
+
+  if (NULL == (pStream = (XmlStream*)calloc(1, sizeof(XmlStream)))) {
+    return NULL;
+  }
+
+  if (0 == strcmp(szFilename, "-")) {
+    pStream->pFile = stdin;
+    pStream->bOwnFile = 0;
+  }
+  else if (NULL != (pStream->pFile = fopen(szFilename, "rb"))) {
+    pStream->bOwnFile = 1;
+  }
+  else {
+    free(pStream);
+    return NULL;
+  }
+
+  pStream->ulLine = 1;
+  pStream->szError = "";
+  return pStream;
+}
+
+/*------------------------------------------------------------------------*/
+void xml_stream_close(XmlStream* pStream)
+{
+  if (NULL != pStream) {
+    if (0 != pStream->bOwnFile) {
+      fclose(pStream->pFile);
+    }
+    free(pStream->szName);
+    free(pStream->szText);
+    free(pStream->szAttrs);
+    free(pStream);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+XmlEvent xml_stream_next(XmlStream* pStream)
+{
+  int ch;
+
+  assert(NULL != pStream);
+
+  if (0 != pStream->eDone) {
+    return pStream->eDone;
+  }
+
+  if (0 != pStream->bPendingEnd) {
+    pStream->bPendingEnd = 0;
+    pStream->attrLen = 0;
+    --pStream->iDepth;
+    return XML_END;
+  }
+
+  pStream->textLen = 0;
+
+  if (0 != pStream->bPendingTag) {
+    pStream->bPendingTag = 0;
+    return read_tag(pStream);
+  }
+
+  for (;;) {
+    ch = next_char(pStream);
+
+    if (EOF == ch) {
+      if (ferror(pStream->pFile)) {
+        return fail(pStream, "read error");
+      }
+      if (0 != pStream->iDepth) {
+        return fail(pStream, "unexpected end of input");
+      }
+      pStream->eDone = XML_EOF;
+      return XML_EOF;
+    }
+
+    if ('<' == ch) {
+      ch = peek_char(pStream);
+      if (('!' == ch) || ('?' == ch)) {
+        if (0 != skip_special(pStream)) {
+          return fail(pStream, pStream->szError);
+        }
+        continue;
+      }
+      pStream->llTagOffset = pStream->llOffset - 1;
+      if (0 != have_text(pStream)) {
+        pStream->bPendingTag = 1;
+        return XML_TEXT;
+      }
+      pStream->textLen = 0;
+      return read_tag(pStream);
+    }
+
+    if ('&' == ch) {
+      if (0 != read_entity(pStream, &pStream->szText, &pStream->textLen, &pStream->textCap)) {
+        return fail(pStream, "out of memory");
+      }
+    }
+    else if (0 != buf_append(&pStream->szText, &pStream->textLen, &pStream->textCap, (char)ch)) {
+      return fail(pStream, "out of memory");
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+const char* xml_stream_name(const XmlStream* pStream)
+{
+  assert(NULL != pStream);
+  return (NULL != pStream->szName) ? pStream->szName : "";
+}
+
+/*------------------------------------------------------------------------*/
+const char* xml_stream_text(const XmlStream* pStream)
+{
+  assert(NULL != pStream);
+  return (NULL != pStream->szTextStart) ? pStream->szTextStart : "";
+}
+
+/*------------------------------------------------------------------------*/
+const char* xml_stream_attr(const XmlStream* pStream, const char* szName)
+{
+  const char* pCur;
+  const char* pEnd;
+
+  assert(NULL != pStream);
+  assert(NULL != szName);
+
+  if (NULL == pStream->szAttrs) {
+    return NULL;
+  }
+
+  pCur = pStream->szAttrs;
+  pEnd = pStream->szAttrs + pStream->attrLen;
+  while (pCur < pEnd) {
+    const char* pValue = pCur + strlen(pCur) + 1;
+    if (0 == strcmp(pCur, szName)) {
+      return pValue;
+    }
+    pCur = pValue + strlen(pValue) + 1;
+  }
+  return NULL;
+}
+
+/*------------------------------------------------------------------------*/
+int xml_stream_depth(const XmlStream* pStream)
+{
+  assert(NULL != pStream);
+  return pStream->iDepth;
+}
+
+/*------------------------------------------------------------------------*/
+unsigned long xml_stream_line(const XmlStream* pStream)
+{
+  assert(NULL != pStream);
+  return pStream->ulLine;
+}
+
+/*------------------------------------------------------------------------*/
+long long xml_stream_offset(const XmlStream* pStream)
+{
+  assert(NULL != pStream);
+  return pStream->llTagOffset;
+}
+
+/*------------------------------------------------------------------------*/
+const char* xml_stream_error(const XmlStream* pStream)
+{
+  assert(NULL != pStream);
+  return pStream->szError;
+}
@@ -0,0 +1,106 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  Minimal streaming (pull) reader for the xml reports written by the
+ *  CUnit Automated interface.  Used by the report tools to process
+ *  result files of any size in constant memory.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Streaming xml reader for CUnit report tools.
+ *  This is not a general-purpose xml parser.  It understands elements,
+ *  attributes, character data, CDATA sections and the predefined and
+ *  numeric character entities.  Processing instructions, comments and
+ *  the document type declaration are skipped.  No validation is done.
+ */
+
+#ifndef CUNIT_XMLSTREAM_H_SEEN
+#define CUNIT_XMLSTREAM_H_SEEN
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XML_STREAM_BUFSIZE 65536
+/**< Size of the input buffer used by an XmlStream. */
+
+/** Types of events returned by xml_stream_next(). */
+typedef enum {
+  XML_START = 1,  /**< Element start tag (also for empty elements). */
+  XML_END,        /**< Element end tag (synthesized for empty elements). */
+  XML_TEXT,       /**< Non-blank character data, trimmed. */
+  XML_EOF,        /**< End of input. */
+  XML_ERROR       /**< Malformed input or read error. */
+} XmlEvent;
+
+typedef struct XmlStream XmlStream;  /**< Opaque reader state. */
+
+XmlStream* xml_stream_open(const char* szFilename);
+/**<
+ *  Opens a file for streaming.  A filename of "-" reads from stdin.
+ *  @return A new reader, or NULL if the file could not be opened
+ *          or memory could not be allocated.
+ */
+
+void xml_stream_close(XmlStream* pStream);
+/**< Closes the file (unless stdin) and frees the reader. */
+
+XmlEvent xml_stream_next(XmlStream* pStream);
+/**<
+ *  Advances to the next event.  Character data consisting only of
+ *  whitespace is not reported.  Once XML_EOF or XML_ERROR has been
+ *  returned, subsequent calls return the same value.
+ */
+
+const char* xml_stream_name(const XmlStream* pStream);
+/**< Name of the element for the current XML_START or XML_END event. */
+
+const char* xml_stream_text(const XmlStream* pStream);
+/**< Decoded, trimmed character data for the current XML_TEXT event. */
+
+const char* xml_stream_attr(const XmlStream* pStream, const char* szName);
+/**<
+ *  Decoded value of the named attribute of the current XML_START event.
+ *  @return The attribute value, or NULL if the element has no such attribute.
+ */
+
+int xml_stream_depth(const XmlStream* pStream);
+/**< Element nesting depth (the root element start tag is at depth 1). */
+
+unsigned long xml_stream_line(const XmlStream* pStream);
+/**< Current line number in the input (1-based), for error messages. */
+
+long long xml_stream_offset(const XmlStream* pStream);
+/**<
+ *  Byte offset of the '<' which began the current XML_START or
+ *  XML_END event.
+ */
+
+const char* xml_stream_error(const XmlStream* pStream);
+/**< Description of the last XML_ERROR, or "" if none. */
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /*  CUNIT_XMLSTREAM_H_SEEN  */
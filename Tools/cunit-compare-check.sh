@@ -0,0 +1,119 @@
+#!/bin/sh
+#
+# cunit-compare-check.sh - round-trip checks for cunit-compare
+#
+# Copyright (C) 2026  agent
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Library General Public
+# License as published by the Free Software Foundation; either
+# version 2 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Library General Public License for more details.
+#
+# You should have received a copy of the GNU Library General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#---------------------------------------------------------------------------
+#
+# Writes result files in the CUnit-Run and JUnit formats with known
+# durations, reads them back with cunit-compare and checks its verdicts,
+# delta column and exit status.  Run by "make check"; the tool to test
+# can be given in CUNIT_COMPARE (default ./cunit-compare).
+
+COMPARE=${CUNIT_COMPARE:-./cunit-compare}
+DIR=${TMPDIR:-/tmp}/cunit-compare-check.$$
+FAILED=0
+
+trap 'rm -rf "$DIR"' 0
+mkdir "$DIR" || exit 1
+
+# write_run <file> <duration of a&b> <duration of b>
+write_run()
+{
+  cat > "$1" <<EOF
+<?xml version="1.0" ?>
+<?xml-stylesheet type="text/xsl" href="CUnit-Run.xsl" ?>
+<!DOCTYPE CUNIT_TEST_RUN_REPORT SYSTEM "CUnit-Run.dtd">
+<CUNIT_TEST_RUN_REPORT>
+  <CUNIT_HEADER/>
+  <CUNIT_RESULT_LISTING>
+    <CUNIT_RUN_SUITE>
+      <CUNIT_RUN_SUITE_SUCCESS>
+        <SUITE_NAME> suite one </SUITE_NAME>
+        <CUNIT_RUN_TEST_RECORD>
+          <CUNIT_RUN_TEST_SUCCESS>
+            <TEST_NAME> a&amp;b </TEST_NAME>
+            <TEST_DURATION> $2 </TEST_DURATION>
+          </CUNIT_RUN_TEST_SUCCESS>
+        </CUNIT_RUN_TEST_RECORD>
+        <CUNIT_RUN_TEST_RECORD>
+          <CUNIT_RUN_TEST_FAILURE>
+            <TEST_NAME> b </TEST_NAME>
+            <TEST_DURATION> $3 </TEST_DURATION>
+            <FILE_NAME> t.c </FILE_NAME>
+            <LINE_NUMBER> 3 </LINE_NUMBER>
+            <CONDITION> 0 </CONDITION>
+          </CUNIT_RUN_TEST_FAILURE>
+        </CUNIT_RUN_TEST_RECORD>
+      </CUNIT_RUN_SUITE_SUCCESS>
+    </CUNIT_RUN_SUITE>
+  </CUNIT_RESULT_LISTING>
+</CUNIT_TEST_RUN_REPORT>
+EOF
+}
+
+# write_junit <file> <duration of a&b> <duration of b>
+write_junit()
+{
+  cat > "$1" <<EOF
+<?xml version="1.0" encoding="UTF-8"?>
+<testsuites errors="0" failures="1" tests="2" name="">
+  <testsuite name="suite one" errors="0" failures="1" tests="2">
+    <testcase classname="suite one" name="a&amp;b" time="$2"/>
+    <testcase classname="suite one" name="b" time="$3">
+      <failure message="0" type="Failure">t.c:3</failure>
+    </testcase>
+  </testsuite>
+</testsuites>
+EOF
+}
+
+# check <description> <expected status> <expected output pattern> <files...>
+check()
+{
+  sDesc=$1
+  iExpect=$2
+  sPattern=$3
+  shift 3
+  "$COMPARE" "$@" > "$DIR/out" 2>&1
+  iStatus=$?
+  if [ "$iStatus" -ne "$iExpect" ] || ! grep -q -- "$sPattern" "$DIR/out"; then
+    echo "FAIL: $sDesc (exit status $iStatus, expected $iExpect)"
+    cat "$DIR/out"
+    FAILED=1
+  fi
+}
+
+write_run "$DIR/base.xml" 0.010000 0.020000
+write_run "$DIR/slower.xml" 0.020000 0.020000
+write_run "$DIR/zero.xml" 0.000000 0.020000
+write_junit "$DIR/base-junit.xml" 0.010000 0.020000
+
+check "unchanged CUnit-Run results" 0 "^suite one/a&b .* +0.0% .*~$" \
+      "$DIR/base.xml" "$DIR/base.xml"
+check "CUnit-Run against JUnit results" 0 "^suite one/b .* +0.0% .*~$" \
+      "$DIR/base.xml" "$DIR/base-junit.xml"
+check "regressed test" 1 "^suite one/a&b .* +100.0% .*REGRESSION$" \
+      "$DIR/base.xml" "$DIR/slower.xml"
+check "improved test" 0 "^suite one/a&b .* -50.0% .*IMPROVED$" \
+      "$DIR/slower.xml" "$DIR/base-junit.xml"
+check "test slower than a zero base" 1 "^suite one/a&b .* +10.000ms .*REGRESSION$" \
+      "$DIR/zero.xml" "$DIR/base.xml"
+check "missing file" 2 "cannot open" \
+      "$DIR/base.xml" "$DIR/missing.xml"
+
+exit $FAILED
@@ -0,0 +1,444 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  cunit-compare - compares test durations between two CUnit result
+ *  files (CUnit-Run xml or JUnit xml) and reports regressions.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Test duration comparison tool.
+ *
+ *  Both result files are read as streams.  Every record of a test is
+ *  taken as one duration sample, so a result file holding several
+ *  iterations of the same test (e.g. merged repeated runs) provides
+ *  a sample set per test.  Where both files have at least two samples
+ *  for a test, a two-sided Mann-Whitney U test (normal approximation,
+ *  corrected for ties) decides whether the difference is significant.
+ *  With single samples only the relative threshold is applied.  The
+ *  Delta column shows the relative change of the median duration, or
+ *  the absolute change for a test whose base median is 0.
+ *
+ *  Exit status: 0 if no regression exceeds the threshold, 1 if one
+ *  does, 2 on usage or input errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "XmlStream.h"
+
+#define HASH_SIZE 4096    /**< Number of buckets in the test table (power of 2). */
+
+/** Duration samples of one test. */
+typedef struct Samples
+{
+  double*  pValues;       /**< Durations in seconds. */
+  size_t   nValues;       /**< Number of durations. */
+  size_t   nCap;          /**< Allocated capacity of pValues. */
+} Samples;
+
+/** Table entry for a single test. */
+typedef struct TestEntry
+{
+  char*             szSuite;    /**< Suite name. */
+  char*             szTest;     /**< Test name. */
+  Samples           samples[2]; /**< Samples from base [0] and new [1] file. */
+  struct TestEntry* pHashNext;  /**< Next entry in hash bucket. */
+  struct TestEntry* pNext;      /**< Next entry in order of first appearance. */
+} TestEntry;
+
+static TestEntry*  f_buckets[HASH_SIZE];
+static TestEntry*  f_pFirst = NULL;
+static TestEntry*  f_pLast = NULL;
+
+static double      f_dThreshold = 5.0;     /**< Regression threshold in percent. */
+static double      f_dAlpha = 0.05;        /**< Significance level. */
+static double      f_dMinDelta = 0.0005;   /**< Minimum absolute delta in seconds. */
+static int         f_bChangedOnly = 0;     /**< Print only changed tests. */
+
+/*------------------------------------------------------------------------*/
+static void* xmalloc(size_t size)
+{
+  void* p = malloc(size);
+  if (NULL == p) {
+    fprintf(stderr, "cunit-compare: out of memory\n");
+    exit(2);
+  }
+  return p;
+}
+
+/*------------------------------------------------------------------------*/
+static char* xstrdup(const char* sz)
+{
+  char* p = (char*)xmalloc(strlen(sz) + 1);
+  strcpy(p, sz);
+  return p;
+}
+
+/*------------------------------------------------------------------------*/
+static unsigned long hash_key(const char* szSuite, const char* szTest)
+{
+  unsigned long h = 5381;
+
+  while ('\0' != *szSuite) {
+    h = (h * 33) ^ (unsigned char)*szSuite++;
+  }
+  h = (h * 33) ^ '/';
+  while ('\0' != *szTest) {
+    h = (h * 33) ^ (unsigned char)*szTest++;
+  }
+  return h;
+}
+
+/*------------------------------------------------------------------------*/
+/** Records a duration sample for suite/test from input iInput (0 or 1). */
+static void add_sample(int iInput, const char* szSuite, const char* szTest, double dValue)
+{
+  unsigned long h = hash_key(szSuite, szTest) & (HASH_SIZE - 1);
+  TestEntry* pEntry = f_buckets[h];
+  Samples* pSamples;
+
+  while ((NULL != pEntry) &&
+         ((0 != strcmp(pEntry->szSuite, szSuite)) || (0 != strcmp(pEntry->szTest, szTest)))) {
+    pEntry = pEntry->pHashNext;
+  }
+
+  if (NULL == pEntry) {
+    pEntry = (TestEntry*)xmalloc(sizeof(TestEntry));
+    memset(pEntry, 0, sizeof(TestEntry));
+    pEntry->szSuite = xstrdup(szSuite);
+    pEntry->szTest = xstrdup(szTest);
+    pEntry->pHashNext = f_buckets[h];
+    f_buckets[h] = pEntry;
+    if (NULL == f_pLast) {
+      f_pFirst = pEntry;
+    }
+    else {
+      f_pLast->pNext = pEntry;
+    }
+    f_pLast = pEntry;
+  }
+
+  pSamples = &pEntry->samples[iInput];
+  if (pSamples->nValues == pSamples->nCap) {
+    pSamples->nCap = (0 == pSamples->nCap) ? 4 : (pSamples->nCap * 2);
+    pSamples->pValues = (double*)realloc(pSamples->pValues, pSamples->nCap * sizeof(double));
+    if (NULL == pSamples->pValues) {
+      fprintf(stderr, "cunit-compare: out of memory\n");
+      exit(2);
+    }
+  }
+  pSamples->pValues[pSamples->nValues++] = dValue;
+}
+
+/*------------------------------------------------------------------------*/
+/** Copies src into a fixed buffer, truncating if necessary. */
+static void set_string(char* szDest, size_t size, const char* szSrc)
+{
+  strncpy(szDest, szSrc, size - 1);
+  szDest[size - 1] = '\0';
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads all duration samples from a CUnit-Run or JUnit result file.
+ *  @return 0 on success, -1 on error (message printed).
+ */
+static int read_results(int iInput, const char* szFilename)
+{
+  XmlStream* pStream;
+  XmlEvent event;
+  const char* szName;
+  const char* szValue;
+  char szSuite[1024] = "";
+  char szTest[1024] = "";
+  char szElement[64] = "";
+  double dDuration = 0.0;
+  int bHaveDuration = 0;
+  int bJUnit = -1;
+  size_t nSamples = 0;
+
+  if (NULL == (pStream = xml_stream_open(szFilename))) {
+    fprintf(stderr, "cunit-compare: cannot open '%s'\n", szFilename);
+    return -1;
+  }
+
+  while ((XML_EOF != (event = xml_stream_next(pStream))) && (XML_ERROR != event)) {
+    szName = xml_stream_name(pStream);
+
+    if (XML_START == event) {
+      if (-1 == bJUnit) {
+        bJUnit = ((0 == strcmp(szName, "testsuites")) || (0 == strcmp(szName, "testsuite"))) ? 1 : 0;
+      }
+      set_string(szElement, sizeof(szElement), szName);
+
+      if (1 == bJUnit) {
+        if (0 == strcmp(szName, "testsuite")) {
+          szValue = xml_stream_attr(pStream, "name");
+          set_string(szSuite, sizeof(szSuite), (NULL != szValue) ? szValue : "");
+        }
+        else if (0 == strcmp(szName, "testcase")) {
+          szValue = xml_stream_attr(pStream, "name");
+          set_string(szTest, sizeof(szTest), (NULL != szValue) ? szValue : "");
+          szValue = xml_stream_attr(pStream, "time");
+          bHaveDuration = (NULL != szValue);
+          dDuration = bHaveDuration ? atof(szValue) : 0.0;
+        }
+      }
+      else if ((0 == strcmp(szName, "CUNIT_RUN_TEST_SUCCESS")) ||
+               (0 == strcmp(szName, "CUNIT_RUN_TEST_FAILURE"))) {
+        szTest[0] = '\0';
+        bHaveDuration = 0;
+      }
+    }
+    else if (XML_TEXT == event) {
+      if ((0 == bJUnit) && (0 == strcmp(szElement, "SUITE_NAME"))) {
+        set_string(szSuite, sizeof(szSuite), xml_stream_text(pStream));
+      }
+      else if ((0 == bJUnit) && (0 == strcmp(szElement, "TEST_NAME"))) {
+        set_string(szTest, sizeof(szTest), xml_stream_text(pStream));
+      }
+      else if ((0 == bJUnit) && (0 == strcmp(szElement, "TEST_DURATION"))) {
+        dDuration = atof(xml_stream_text(pStream));
+        bHaveDuration = 1;
+      }
+    }
+    else if (XML_END == event) {
+      szElement[0] = '\0';
+      if ((0 != bHaveDuration) &&
+          (((1 == bJUnit) && (0 == strcmp(szName, "testcase"))) ||
+           ((0 == bJUnit) && ((0 == strcmp(szName, "CUNIT_RUN_TEST_SUCCESS")) ||
+                              (0 == strcmp(szName, "CUNIT_RUN_TEST_FAILURE")))))) {
+        add_sample(iInput, szSuite, szTest, dDuration);
+        bHaveDuration = 0;
+        ++nSamples;
+      }
+    }
+  }
+
+  if (XML_ERROR == event) {
+    fprintf(stderr, "cunit-compare: %s:%lu: %s\n",
+            szFilename, xml_stream_line(pStream), xml_stream_error(pStream));
+  }
+  else if (0 == nSamples) {
+    fprintf(stderr, "cunit-compare: warning: no test durations found in '%s'\n", szFilename);
+  }
+
+  xml_stream_close(pStream);
+  return (XML_ERROR == event) ? -1 : 0;
+}
+
+/*------------------------------------------------------------------------*/
+static int compare_doubles(const void* p1, const void* p2)
+{
+  double d1 = *(const double*)p1;
+  double d2 = *(const double*)p2;
+  return (d1 < d2) ? -1 : ((d1 > d2) ? 1 : 0);
+}
+
+/*------------------------------------------------------------------------*/
+/** Sorts the samples and returns their median. */
+static double median(Samples* pSamples)
+{
+  size_t n = pSamples->nValues;
+
+  qsort(pSamples->pValues, n, sizeof(double), compare_doubles);
+  if (0 == (n % 2)) {
+    return (pSamples->pValues[n/2 - 1] + pSamples->pValues[n/2]) / 2.0;
+  }
+  return pSamples->pValues[n/2];
+}
+
+/*------------------------------------------------------------------------*/
+/** Two-sided Mann-Whitney U test on two sorted sample sets.
+ *  Uses the normal approximation with tie and continuity correction.
+ *  @return The p-value.
+ */
+static double mann_whitney(const Samples* pA, const Samples* pB)
+{
+  size_t nA = pA->nValues;
+  size_t nB = pB->nValues;
+  double N = (double)(nA + nB);
+  double dRankSumA = 0.0;
+  double dTies = 0.0;
+  double dU, dMean, dSigma, dZ;
+  size_t iA = 0;
+  size_t iB = 0;
+  size_t rank = 1;
+
+  /* merge the sorted sets, giving tied values their average rank */
+  while ((iA < nA) || (iB < nB)) {
+    double dValue;
+    size_t tA = 0;
+    size_t tB = 0;
+    size_t t;
+
+    if ((iB >= nB) || ((iA < nA) && (pA->pValues[iA] <= pB->pValues[iB]))) {
+      dValue = pA->pValues[iA];
+    }
+    else {
+      dValue = pB->pValues[iB];
+    }
+    while ((iA < nA) && (pA->pValues[iA] == dValue)) { ++iA; ++tA; }
+    while ((iB < nB) && (pB->pValues[iB] == dValue)) { ++iB; ++tB; }
+
+    t = tA + tB;
+    dRankSumA += (double)tA * ((double)rank + (double)(t - 1) / 2.0);
+    dTies += (double)t * (double)t * (double)t - (double)t;
+    rank += t;
+  }
+
+  dU = dRankSumA - (double)nA * (double)(nA + 1) / 2.0;
+  dMean = (double)nA * (double)nB / 2.0;
+  dSigma = sqrt((double)nA * (double)nB / 12.0 * ((N + 1.0) - dTies / (N * (N - 1.0))));
+  if (dSigma <= 0.0) {
+    return 1.0;
+  }
+
+  dZ = (fabs(dU - dMean) - 0.5) / dSigma;
+  if (dZ < 0.0) {
+    dZ = 0.0;
+  }
+  return erfc(dZ / sqrt(2.0));
+}
+
+/*------------------------------------------------------------------------*/
+static void usage(void)
+{
+  fprintf(stderr,
+    "Usage: cunit-compare [options] <base-results.xml> <new-results.xml>\n"
+    "Compares per-test durations of two CUnit-Run or JUnit result files.\n"
+    "  -t <percent>  regression threshold in percent (default 5)\n"
+    "  -a <alpha>    significance level for the Mann-Whitney U test (default 0.05)\n"
+    "  -m <ms>       ignore differences smaller than this (default 0.5)\n"
+    "  -c            print only tests whose duration changed\n"
+    "Exit status is 1 if any test regressed beyond the threshold, 2 on error.\n");
+}
+
+/*------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  TestEntry* pEntry;
+  int iArg;
+  int nRegressions = 0;
+  int nImprovements = 0;
+
+  for (iArg = 1 ; (iArg < argc) && ('-' == argv[iArg][0]) && ('\0' != argv[iArg][1]) ; ++iArg) {
+    if (0 == strcmp(argv[iArg], "-c")) {
+      f_bChangedOnly = 1;
+    }
+    else if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-t"))) {
+      f_dThreshold = atof(argv[++iArg]);
+    }
+    else if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-a"))) {
+      f_dAlpha = atof(argv[++iArg]);
+    }
+    else if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-m"))) {
+      f_dMinDelta = atof(argv[++iArg]) / 1000.0;
+    }
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  if (2 != (argc - iArg)) {
+    usage();
+    return 2;
+  }
+
+  if ((0 != read_results(0, argv[iArg])) || (0 != read_results(1, argv[iArg + 1]))) {
+    return 2;
+  }
+
+  printf("%-48s %12s %12s %9s %9s %8s  %s\n",
+         "Suite/Test", "Base(ms)", "New(ms)", "Delta", "Samples", "p", "Verdict");
+
+  for (pEntry = f_pFirst ; NULL != pEntry ; pEntry = pEntry->pNext) {
+    Samples* pBase = &pEntry->samples[0];
+    Samples* pNew = &pEntry->samples[1];
+    char szKey[512];
+    char szDelta[16] = "-";
+    char szP[16] = "-";
+    const char* szVerdict = "~";
+    double dBase = 0.0;
+    double dNew = 0.0;
+    double dDelta = 0.0;
+    int bChanged = 0;
+
+    snprintf(szKey, sizeof(szKey), "%s/%s", pEntry->szSuite, pEntry->szTest);
+
+    if (0 == pNew->nValues) {
+      szVerdict = "REMOVED";
+      dBase = median(pBase);
+    }
+    else if (0 == pBase->nValues) {
+      szVerdict = "ADDED";
+      dNew = median(pNew);
+    }
+    else {
+      dBase = median(pBase);
+      dNew = median(pNew);
+      if (dBase > 0.0) {
+        dDelta = (dNew - dBase) / dBase * 100.0;
+        snprintf(szDelta, sizeof(szDelta), "%+.1f%%", dDelta);
+      }
+      else if (dNew > 0.0) {
+        dDelta = 100.0;   /* from nothing - treated as exceeding any threshold */
+        snprintf(szDelta, sizeof(szDelta), "%+.3fms", dNew * 1000.0);
+      }
+
+      bChanged = (fabs(dNew - dBase) >= f_dMinDelta) && (fabs(dDelta) > f_dThreshold);
+
+      if ((pBase->nValues >= 2) && (pNew->nValues >= 2)) {
+        double dP = mann_whitney(pBase, pNew);
+        snprintf(szP, sizeof(szP), "%.4f", dP);
+        bChanged = bChanged && (dP < f_dAlpha);
+      }
+
+      if (0 != bChanged) {
+        if (dDelta > 0.0) {
+          szVerdict = "REGRESSION";
+          ++nRegressions;
+        }
+        else {
+          szVerdict = "IMPROVED";
+          ++nImprovements;
+        }
+      }
+    }
+
+    if ((0 == f_bChangedOnly) || (0 != bChanged) || ('~' != szVerdict[0])) {
+      char szSamples[24];
+      snprintf(szSamples, sizeof(szSamples), "%lu/%lu",
+               (unsigned long)pBase->nValues, (unsigned long)pNew->nValues);
+      printf("%-48s %12.3f %12.3f %9s %9s %8s  %s\n",
+             szKey, dBase * 1000.0, dNew * 1000.0, szDelta, szSamples, szP, szVerdict);
+    }
+  }
+
+  printf("\n%d regression(s), %d improvement(s) beyond %.1f%% threshold\n",
+         nRegressions, nImprovements, f_dThreshold);
+
+  return (0 != nRegressions) ? 1 : 0;
+}
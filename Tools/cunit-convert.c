@@ -0,0 +1,818 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  cunit-convert - converts a binary result stream written by the
+ *  Binary report format into CUnit-Run xml, JUnit xml or JSON.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *
+ *  18-Oct-2026   Runs tainted by captured crashes marked in all formats. (AGT)
+ *
+ *  18-Oct-2026   Added the worker_failed failure type to json output. (AGT)
+ */
+
+/** @file
+ *  Binary result stream conversion tool.
+ *
+ *  The CUnit-Run and JUnit output is the report the corresponding
+ *  report format would have written for the same run, except for the
+ *  time in the CUnit-Run footer, which is taken from the run end record.
+ *  Output is written as the stream is read, so with -w a stream can be
+ *  converted while the run is still writing it.  A stream without a run
+ *  end record (the run aborted or is incomplete) is converted as the
+ *  abort handlers of the report formats do.
+ *
+ *  Exit status: 0 for a complete run, 1 for an aborted or truncated
+ *  run, 2 on usage or input errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CUnit.h"
+#include "CUThread.h"
+#include "MyMem.h"
+#include "Util.h"
+#include "BinaryResults.h"
+
+#define FOLLOW_INTERVAL 0.2   /**< Seconds between polls of a followed stream. */
+
+/** Output formats. */
+typedef enum Format
+{
+  FORMAT_CUNIT,
+  FORMAT_JUNIT,
+  FORMAT_JSON
+} Format;
+
+/** A failure of a test end record, kept until its suite ends. */
+typedef struct PendingFailure
+{
+  CU_BinaryFailure failure;   /**< The failure (strings owned by the reader). */
+  const char*      szTest;    /**< Name of the test. */
+} PendingFailure;
+
+/** A test end record, kept until its suite ends. */
+typedef struct PendingTest
+{
+  const char*      szTest;    /**< Name of the test. */
+  size_t           iFailure;  /**< Index of its first failure in f_pPending. */
+  size_t           nFailures; /**< Number of its failures. */
+} PendingTest;
+
+static FILE*        f_pOut = NULL;          /**< Output file. */
+static Format       f_format = FORMAT_CUNIT;
+static const char*  f_szPackage = "";       /**< Package name of the run. */
+
+static char*        f_szXml[2] = {NULL, NULL};  /**< Buffers for xml translation. */
+static size_t       f_szXmlLen[2] = {0, 0};     /**< Allocated lengths of f_szXml. */
+
+/* CUnit-Run state */
+static const char*  f_szRunningSuite = NULL;    /**< Suite of the last test started. */
+static int          f_bWritingRunSuite = 0;     /**< Flag for an open CUNIT_RUN_SUITE element. */
+
+/* JUnit and JSON state */
+static PendingFailure* f_pPending = NULL;       /**< Test failures of the running suite. */
+static size_t       f_nPending = 0;             /**< Entries used in f_pPending. */
+static size_t       f_nPendingCap = 0;          /**< Entries allocated in f_pPending. */
+static PendingTest* f_pEnded = NULL;            /**< Tests of the running suite which ended (JSON). */
+static size_t       f_nEnded = 0;               /**< Entries used in f_pEnded. */
+static size_t       f_nEndedCap = 0;            /**< Entries allocated in f_pEnded. */
+static int          f_nSuitesWritten = 0;       /**< Number of suites written (JSON). */
+
+/*------------------------------------------------------------------------*/
+/** Translates xml special characters using buffer iSlot (0 or 1).
+ *  NULL is translated to "".
+ */
+static const char* xml(const char* szText, int iSlot)
+{
+  const char* szResult;
+
+  if (NULL == szText) {
+    return "";
+  }
+  szResult = CU_translate_to_buffer(szText, &f_szXml[iSlot], &f_szXmlLen[iSlot]);
+  if (NULL == szResult) {
+    fprintf(stderr, "cunit-convert: out of memory\n");
+    exit(2);
+  }
+  return szResult;
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a JSON string literal (NULL is written as null). */
+static void json_string(const char* szText)
+{
+  const unsigned char* p;
+
+  if (NULL == szText) {
+    fputs("null", f_pOut);
+    return;
+  }
+  putc('"', f_pOut);
+  for (p = (const unsigned char*)szText ; '\0' != *p ; ++p) {
+    if (('"' == *p) || ('\\' == *p)) {
+      putc('\\', f_pOut);
+      putc(*p, f_pOut);
+    }
+    else if ('\n' == *p) {
+      fputs("\\n", f_pOut);
+    }
+    else if (*p < 0x20) {
+      fprintf(f_pOut, "\\u%04x", (unsigned int)*p);
+    }
+    else {
+      putc(*p, f_pOut);
+    }
+  }
+  putc('"', f_pOut);
+}
+
+/*------------------------------------------------------------------------*/
+/** Grows an array of nSize byte entries to hold one more than *pCap. */
+static void* grow(void* pArray, size_t* pCap, size_t nSize)
+{
+  *pCap = (0 == *pCap) ? 16 : (2 * *pCap);
+  pArray = realloc(pArray, *pCap * nSize);
+  if (NULL == pArray) {
+    fprintf(stderr, "cunit-convert: out of memory\n");
+    exit(2);
+  }
+  return pArray;
+}
+
+/*------------------------------------------------------------------------*/
+/** Keeps a test end record and its failures until its suite ends. */
+static void add_pending(const CU_BinaryRecord* pRecord)
+{
+  unsigned int i;
+
+  if (f_nEnded == f_nEndedCap) {
+    f_pEnded = (PendingTest*)grow(f_pEnded, &f_nEndedCap, sizeof(PendingTest));
+  }
+  f_pEnded[f_nEnded].szTest = pRecord->szTest;
+  f_pEnded[f_nEnded].iFailure = f_nPending;
+  f_pEnded[f_nEnded].nFailures = pRecord->nFailures;
+  ++f_nEnded;
+
+  for (i = 0 ; i < pRecord->nFailures ; ++i) {
+    if (f_nPending == f_nPendingCap) {
+      f_pPending = (PendingFailure*)grow(f_pPending, &f_nPendingCap, sizeof(PendingFailure));
+    }
+    f_pPending[f_nPending].failure = pRecord->pFailures[i];
+    f_pPending[f_nPending].szTest = pRecord->szTest;
+    ++f_nPending;
+  }
+}
+
+/*=================================================================
+ *  CUnit-Run xml
+ *=================================================================*/
+static void cunit_close_suite(void)
+{
+  if (0 != f_bWritingRunSuite) {
+    fprintf(f_pOut,
+      "      </CUNIT_RUN_SUITE_SUCCESS> \n"
+      "    </CUNIT_RUN_SUITE> \n");
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void cunit_record(const CU_BinaryRecord* pRecord)
+{
+  const CU_RunSummary* pSummary = &pRecord->summary;
+  char* szTime;
+  time_t tTime;
+  unsigned int i;
+
+  switch (pRecord->type) {
+    case CU_BINARY_RUN_START:
+      fprintf(f_pOut,
+        "<?xml version=\"1.0\" ?> \n"
+        "<?xml-stylesheet type=\"text/xsl\" href=\"CUnit-Run.xsl\" ?> \n"
+        "<!DOCTYPE CUNIT_TEST_RUN_REPORT SYSTEM \"CUnit-Run.dtd\"> \n"
+        "<CUNIT_TEST_RUN_REPORT> \n"
+        "  <CUNIT_HEADER/> \n");
+      fprintf(f_pOut, "  <CUNIT_RESULT_LISTING> \n");
+      break;
+
+    case CU_BINARY_TEST_START:
+      if ((NULL == f_szRunningSuite) || (f_szRunningSuite != pRecord->szSuite)) {
+        cunit_close_suite();
+        fprintf(f_pOut,
+          "    <CUNIT_RUN_SUITE> \n"
+          "      <CUNIT_RUN_SUITE_SUCCESS> \n"
+          "        <SUITE_NAME> %s </SUITE_NAME> \n",
+          xml(pRecord->szSuite, 0));
+        f_bWritingRunSuite = 1;
+        f_szRunningSuite = pRecord->szSuite;
+      }
+      break;
+
+    case CU_BINARY_TEST_END:
+      for (i = 0 ; i < pRecord->nFailures ; ++i) {
+        fprintf(f_pOut,
+          "        <CUNIT_RUN_TEST_RECORD> \n"
+          "          <CUNIT_RUN_TEST_FAILURE> \n"
+          "            <TEST_NAME> %s </TEST_NAME> \n",
+          xml(pRecord->szTest, 0));
+        if (0 == i) {
+          fprintf(f_pOut,
+            "            <TEST_DURATION> %.6f </TEST_DURATION> \n",
+            pRecord->dDuration);
+        }
+        fprintf(f_pOut,
+          "            <FILE_NAME> %s </FILE_NAME> \n"
+          "            <LINE_NUMBER> %u </LINE_NUMBER> \n"
+          "            <CONDITION> %s </CONDITION> \n"
+          "          </CUNIT_RUN_TEST_FAILURE> \n"
+          "        </CUNIT_RUN_TEST_RECORD> \n",
+          (NULL != pRecord->pFailures[i].szFileName) ? pRecord->pFailures[i].szFileName : "",
+          pRecord->pFailures[i].uiLineNumber,
+          xml(pRecord->pFailures[i].szCondition, 1));
+      }
+      if (0 == pRecord->nFailures) {
+        fprintf(f_pOut,
+          "        <CUNIT_RUN_TEST_RECORD> \n"
+          "          <CUNIT_RUN_TEST_SUCCESS> \n"
+          "            <TEST_NAME> %s </TEST_NAME> \n"
+          "            <TEST_DURATION> %.6f </TEST_DURATION> \n"
+          "          </CUNIT_RUN_TEST_SUCCESS> \n"
+          "        </CUNIT_RUN_TEST_RECORD> \n",
+          xml(pRecord->szTest, 0),
+          pRecord->dDuration);
+      }
+      break;
+
+    case CU_BINARY_SUITE_INIT_FAILURE:
+    case CU_BINARY_SUITE_CLEANUP_FAILURE:
+      cunit_close_suite();
+      f_bWritingRunSuite = 0;
+      fprintf(f_pOut,
+        "    <CUNIT_RUN_SUITE> \n"
+        "      <CUNIT_RUN_SUITE_FAILURE> \n"
+        "        <SUITE_NAME> %s </SUITE_NAME> \n"
+        "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
+        "      </CUNIT_RUN_SUITE_FAILURE> \n"
+        "    </CUNIT_RUN_SUITE>  \n",
+        xml(pRecord->szSuite, 0),
+        (CU_BINARY_SUITE_INIT_FAILURE == pRecord->type) ? "Suite Initialization Failed" : "Suite Cleanup Failed");
+      break;
+
+    case CU_BINARY_RUN_END:
+      if (NULL != f_szRunningSuite) {
+        cunit_close_suite();
+      }
+      fprintf(f_pOut,
+        "  </CUNIT_RESULT_LISTING>\n"
+        "  <CUNIT_RUN_SUMMARY> \n");
+      fprintf(f_pOut,
+        "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+        "      <TYPE> %s </TYPE> \n"
+        "      <TOTAL> %u </TOTAL> \n"
+        "      <RUN> %u </RUN> \n"
+        "      <SUCCEEDED> - NA - </SUCCEEDED> \n"
+        "      <FAILED> %u </FAILED> \n"
+        "      <INACTIVE> %u </INACTIVE> \n"
+        "    </CUNIT_RUN_SUMMARY_RECORD> \n",
+        "Suites",
+        pRecord->uiSuitesRegistered,
+        pSummary->nSuitesRun,
+        pSummary->nSuitesFailed,
+        pSummary->nSuitesInactive);
+      fprintf(f_pOut,
+        "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+        "      <TYPE> %s </TYPE> \n"
+        "      <TOTAL> %u </TOTAL> \n"
+        "      <RUN> %u </RUN> \n"
+        "      <SUCCEEDED> %u </SUCCEEDED> \n"
+        "      <FAILED> %u </FAILED> \n"
+        "      <INACTIVE> %u </INACTIVE> \n"
+        "    </CUNIT_RUN_SUMMARY_RECORD> \n",
+        "Test Cases",
+        pRecord->uiTestsRegistered,
+        pSummary->nTestsRun,
+        pSummary->nTestsRun - pSummary->nTestsFailed,
+        pSummary->nTestsFailed,
+        pSummary->nTestsInactive);
+      fprintf(f_pOut,
+        "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+        "      <TYPE> %s </TYPE> \n"
+        "      <TOTAL> %u </TOTAL> \n"
+        "      <RUN> %u </RUN> \n"
+        "      <SUCCEEDED> %u </SUCCEEDED> \n"
+        "      <FAILED> %u </FAILED> \n"
+        "      <INACTIVE> %s </INACTIVE> \n"
+        "    </CUNIT_RUN_SUMMARY_RECORD> \n"
+        "  </CUNIT_RUN_SUMMARY> \n",
+        "Assertions",
+        pSummary->nAsserts,
+        pSummary->nAsserts,
+        pSummary->nAsserts - pSummary->nAssertsFailed,
+        pSummary->nAssertsFailed,
+        "n/a");
+      tTime = pRecord->tTime;
+      szTime = ctime(&tTime);
+      fprintf(f_pOut,
+        "  <CUNIT_FOOTER> %s%s" CU_VERSION " - %s </CUNIT_FOOTER> \n"
+        "</CUNIT_TEST_RUN_REPORT>",
+        (0 < pSummary->nTestsCrashed) ? "Run tainted by tests crashed in process - " : "",
+        "File Generated By CUnit v",
+        (NULL != szTime) ? szTime : "");
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Completes the report of an aborted or truncated run. */
+static void cunit_abort(void)
+{
+  if ((NULL != f_szRunningSuite) && (0 != f_bWritingRunSuite)) {
+    fputs("      </CUNIT_RUN_SUITE_SUCCESS> \n"
+          "    </CUNIT_RUN_SUITE> \n", f_pOut);
+  }
+  fputs("  </CUNIT_RESULT_LISTING>\n"
+        "  <CUNIT_RUN_SUMMARY> \n"
+        "  </CUNIT_RUN_SUMMARY> \n", f_pOut);
+  fprintf(f_pOut,
+    "  <CUNIT_FOOTER> %s </CUNIT_FOOTER> \n"
+    "</CUNIT_TEST_RUN_REPORT>",
+    "Test run aborted - report truncated");
+}
+
+/*=================================================================
+ *  JUnit xml
+ *=================================================================*/
+static void junit_failure_details(const CU_BinaryFailure* pFailure)
+{
+  fprintf(f_pOut, "        Condition: %s\n", xml(pFailure->szCondition, 1));
+  fprintf(f_pOut, "        File     : %s\n", (NULL != pFailure->szFileName) ? pFailure->szFileName : "");
+  fprintf(f_pOut, "        Line     : %d\n", pFailure->uiLineNumber);
+}
+
+/*------------------------------------------------------------------------*/
+static void junit_testcase_tag(const CU_BinaryTest* pTest, int bHasSubTags, double dTime)
+{
+  fprintf(f_pOut, "    <testcase classname=\"%s\" name=\"%s\" time=\"%.6f\"%s>\n",
+    f_szPackage,
+    xml(pTest->szName, 0),
+    dTime,
+    (0 != bHasSubTags) ? "" : "/");
+}
+
+/*------------------------------------------------------------------------*/
+static void junit_dummy_test(const char* szSuite, const CU_BinaryFailure* pFailure)
+{
+  fprintf(f_pOut, "    <testcase classname=\"%s.%s\" name=\"%s - %s\" time=\"0\">\n"
+      "      <failure message=\"Suite %s failed\" type=\"Failure\">\n",
+    f_szPackage,
+    "",
+    xml(szSuite, 0),
+    (CUF_SuiteInitFailed == pFailure->type) ? "Initialization" : "Cleanup",
+    (CUF_SuiteInitFailed == pFailure->type) ? "Initialization" : "Cleanup");
+  junit_failure_details(pFailure);
+  fprintf(f_pOut, "      </failure>\n"
+    "    </testcase>\n");
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes a testsuite element from a suite end record and the failures
+ *  of its tests, rebuilding the failure list of the suite in the order
+ *  the run recorded it.
+ */
+static void junit_suite(const CU_BinaryRecord* pRecord)
+{
+  PendingFailure* pChain = NULL;
+  size_t nChain = 0;
+  size_t iCurr = 0;
+  size_t iTemp;
+  unsigned int i;
+  double dSuiteTime = 0.0;
+
+  if (0 != pRecord->uiFailureRecords) {
+    pChain = (PendingFailure*)malloc((pRecord->nFailures + f_nPending + 1) * sizeof(PendingFailure));
+    if (NULL == pChain) {
+      fprintf(stderr, "cunit-convert: out of memory\n");
+      exit(2);
+    }
+    /* suite failures before the tests, test failures, cleanup failures */
+    for (i = 0 ; i < pRecord->nFailures ; ++i) {
+      if (CUF_SuiteCleanupFailed != pRecord->pFailures[i].type) {
+        pChain[nChain].failure = pRecord->pFailures[i];
+        pChain[nChain++].szTest = NULL;
+      }
+    }
+    for (iTemp = 0 ; iTemp < f_nPending ; ++iTemp) {
+      pChain[nChain++] = f_pPending[iTemp];
+    }
+    for (i = 0 ; i < pRecord->nFailures ; ++i) {
+      if (CUF_SuiteCleanupFailed == pRecord->pFailures[i].type) {
+        pChain[nChain].failure = pRecord->pFailures[i];
+        pChain[nChain++].szTest = NULL;
+      }
+    }
+  }
+
+  if ((0 == nChain) || (CUF_SuiteInitFailed != pChain[0].failure.type)) {
+    for (i = 0 ; i < pRecord->nTests ; ++i) {
+      dSuiteTime += pRecord->pTests[i].dDuration;
+    }
+  }
+
+  fprintf(f_pOut,
+    "  <testsuite tests=\"%d\" failures=\"%d\" errors=\"0\" time=\"%.6f\" name=\"%s\" package=\"%s\" hostname=\"localhost\" timestamp=\"0\"> \n",
+    pRecord->nTests,
+    pRecord->uiTestsFailed,
+    dSuiteTime,
+    xml(pRecord->szSuite, 0),
+    f_szPackage);
+
+  if ((0 != nChain) && (CUF_SuiteInitFailed == pChain[0].failure.type)) {
+    junit_dummy_test(pRecord->szSuite, &pChain[0].failure);
+    for (i = 0 ; i < pRecord->nTests ; ++i) {
+      junit_testcase_tag(&pRecord->pTests[i], 1, 0.0);
+      fprintf(f_pOut, "      <error message=\"Suite initialization failed\"/>\n");
+      fprintf(f_pOut, "    </testcase>\n");
+    }
+  }
+  else {
+    for (i = 0 ; i < pRecord->nTests ; ++i) {
+      if ((iCurr < nChain) && (pChain[iCurr].szTest == pRecord->pTests[i].szName)) {
+        if (CUF_TestInactive == pChain[iCurr].failure.type) {
+          junit_testcase_tag(&pRecord->pTests[i], 1, 0.0);
+          fprintf(f_pOut, "      <skipped/>\n");
+          fprintf(f_pOut, "    </testcase>\n");
+          ++iCurr;
+        }
+        else {
+          junit_testcase_tag(&pRecord->pTests[i], 1, pRecord->pTests[i].dDuration);
+          fprintf(f_pOut, "      <failure message=\"%s\" type=\"Failure\">\n",
+            xml(pChain[iCurr].failure.szCondition, 1));
+          while ((iCurr < nChain) && (pChain[iCurr].szTest == pRecord->pTests[i].szName)) {
+            junit_failure_details(&pChain[iCurr].failure);
+            ++iCurr;
+          }
+          fprintf(f_pOut, "      </failure>\n");
+          fprintf(f_pOut, "    </testcase>\n");
+        }
+      }
+      else {
+        junit_testcase_tag(&pRecord->pTests[i], 0, pRecord->pTests[i].dDuration);
+      }
+    }
+    if ((iCurr < nChain) && (CUF_SuiteCleanupFailed == pChain[iCurr].failure.type)) {
+      junit_dummy_test(pRecord->szSuite, &pChain[iCurr].failure);
+    }
+  }
+
+  fprintf(f_pOut, "  </testsuite>\n");
+  free(pChain);
+}
+
+/*------------------------------------------------------------------------*/
+static void junit_record(const CU_BinaryRecord* pRecord)
+{
+  switch (pRecord->type) {
+    case CU_BINARY_RUN_START:
+      fprintf(f_pOut,
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<testsuites> \n");
+      break;
+
+    case CU_BINARY_TEST_END:
+      add_pending(pRecord);
+      break;
+
+    case CU_BINARY_SUITE_END:
+      junit_suite(pRecord);
+      f_nPending = 0;
+      f_nEnded = 0;
+      break;
+
+    case CU_BINARY_RUN_END:
+      if (0 < pRecord->summary.nTestsCrashed) {
+        fprintf(f_pOut,
+          "  <properties> \n"
+          "    <property name=\"tainted\" value=\"true\"/> \n"
+          "    <property name=\"tests_crashed\" value=\"%u\"/> \n"
+          "  </properties> \n",
+          pRecord->summary.nTestsCrashed);
+      }
+      fprintf(f_pOut, "</testsuites>");
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*=================================================================
+ *  JSON
+ *=================================================================*/
+static const char* json_failure_type(CU_FailureType type)
+{
+  switch (type) {
+    case CUF_SuiteInactive:      return "suite_inactive";
+    case CUF_SuiteInitFailed:    return "suite_init_failed";
+    case CUF_SuiteCleanupFailed: return "suite_cleanup_failed";
+    case CUF_TestInactive:       return "test_inactive";
+    case CUF_AssertFailed:       return "assert_failed";
+    case CUF_TestCrashed:        return "test_crashed";
+    case CUF_TestTimeout:        return "test_timeout";
+    case CUF_TestMemoryLimit:    return "test_memory_limit";
+    case CUF_TestCpuLimit:       return "test_cpu_limit";
+    case CUF_TestOpenFilesLimit: return "test_open_files_limit";
+    case CUF_TestThreadsLimit:   return "test_threads_limit";
+    case CUF_WorkerFailed:       return "worker_failed";
+    default:                     return "unknown";
+  }
+}
+
+/*------------------------------------------------------------------------*/
+static void json_failure(const CU_BinaryFailure* pFailure, const char* szIndent)
+{
+  fprintf(f_pOut, "%s{\"type\": \"%s\", \"file\": ", szIndent, json_failure_type(pFailure->type));
+  json_string(pFailure->szFileName);
+  fprintf(f_pOut, ", \"line\": %u, \"condition\": ", pFailure->uiLineNumber);
+  json_string(pFailure->szCondition);
+  fputs("}", f_pOut);
+}
+
+/*------------------------------------------------------------------------*/
+static void json_suite(const CU_BinaryRecord* pRecord)
+{
+  const PendingTest* pEnded;
+  const char* szStatus;
+  unsigned int i;
+  size_t j;
+
+  fprintf(f_pOut, "%s\n    {\"name\": ", (0 == f_nSuitesWritten) ? "" : ",");
+  json_string(pRecord->szSuite);
+  fprintf(f_pOut, ", \"testsFailed\": %u, \"tests\": [", pRecord->uiTestsFailed);
+
+  for (i = 0 ; i < pRecord->nTests ; ++i) {
+    /* the last run of the test in the suite */
+    pEnded = NULL;
+    for (j = f_nEnded ; j > 0 ; --j) {
+      if (f_pEnded[j - 1].szTest == pRecord->pTests[i].szName) {
+        pEnded = &f_pEnded[j - 1];
+        break;
+      }
+    }
+    if (NULL == pEnded) {
+      szStatus = "not_run";
+    }
+    else if (0 == pEnded->nFailures) {
+      szStatus = "passed";
+    }
+    else if (CUF_TestInactive == f_pPending[pEnded->iFailure].failure.type) {
+      szStatus = "skipped";
+    }
+    else {
+      szStatus = "failed";
+    }
+
+    fprintf(f_pOut, "%s\n      {\"name\": ", (0 == i) ? "" : ",");
+    json_string(pRecord->pTests[i].szName);
+    fprintf(f_pOut, ", \"status\": \"%s\", \"time\": %.6f", szStatus, pRecord->pTests[i].dDuration);
+    if ((NULL != pEnded) && (0 != pEnded->nFailures)) {
+      fputs(", \"failures\": [", f_pOut);
+      for (j = 0 ; j < pEnded->nFailures ; ++j) {
+        json_failure(&f_pPending[pEnded->iFailure + j].failure, (0 == j) ? "\n        " : ",\n        ");
+      }
+      fputs("]", f_pOut);
+    }
+    fputs("}", f_pOut);
+  }
+
+  fputs("],\n     \"failures\": [", f_pOut);
+  for (i = 0 ; i < pRecord->nFailures ; ++i) {
+    json_failure(&pRecord->pFailures[i], (0 == i) ? "\n       " : ",\n       ");
+  }
+  fputs("]}", f_pOut);
+  ++f_nSuitesWritten;
+}
+
+/*------------------------------------------------------------------------*/
+static void json_record(const CU_BinaryRecord* pRecord)
+{
+  const CU_RunSummary* pSummary = &pRecord->summary;
+
+  switch (pRecord->type) {
+    case CU_BINARY_RUN_START:
+      fprintf(f_pOut, "{\n  \"version\": \"%s\",\n  \"package\": ", CU_VERSION);
+      json_string(pRecord->szPackage);
+      fprintf(f_pOut, ",\n  \"start\": %lu,\n  \"suites\": [", (unsigned long)pRecord->tTime);
+      break;
+
+    case CU_BINARY_TEST_END:
+      add_pending(pRecord);
+      break;
+
+    case CU_BINARY_SUITE_END:
+      json_suite(pRecord);
+      f_nPending = 0;
+      f_nEnded = 0;
+      break;
+
+    case CU_BINARY_RUN_END:
+      fprintf(f_pOut, "\n  ],\n  \"end\": %lu,\n", (unsigned long)pRecord->tTime);
+      fprintf(f_pOut,
+        "  \"summary\": {\n"
+        "    \"suites\": {\"total\": %u, \"run\": %u, \"failed\": %u, \"inactive\": %u},\n"
+        "    \"tests\": {\"total\": %u, \"run\": %u, \"succeeded\": %u, \"failed\": %u, \"inactive\": %u},\n"
+        "    \"asserts\": {\"total\": %u, \"succeeded\": %u, \"failed\": %u},\n"
+        "    \"failureRecords\": %u,\n"
+        "    \"testsCrashed\": %u,\n"
+        "    \"elapsedTime\": %.6f\n"
+        "  },\n"
+        "  \"aborted\": false\n"
+        "}\n",
+        pRecord->uiSuitesRegistered, pSummary->nSuitesRun, pSummary->nSuitesFailed, pSummary->nSuitesInactive,
+        pRecord->uiTestsRegistered, pSummary->nTestsRun, pSummary->nTestsRun - pSummary->nTestsFailed,
+        pSummary->nTestsFailed, pSummary->nTestsInactive,
+        pSummary->nAsserts, pSummary->nAsserts - pSummary->nAssertsFailed, pSummary->nAssertsFailed,
+        pSummary->nFailureRecords,
+        pSummary->nTestsCrashed,
+        pSummary->ElapsedTime);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Completes the report of an aborted or truncated run. */
+static void json_abort(void)
+{
+  fputs("\n  ],\n  \"aborted\": true\n}\n", f_pOut);
+}
+
+/*------------------------------------------------------------------------*/
+static void usage(void)
+{
+  fprintf(stderr,
+    "Usage: cunit-convert [options] <results.cubr>\n"
+    "Converts a binary result stream (\"-\" reads stdin) into another format.\n"
+    "  -f <format>   cunit (CUnit-Run xml, default), junit or json\n"
+    "  -o <file>     write to file instead of stdout\n"
+    "  -w            wait for records still being written until the run ends\n"
+    "Exit status is 1 if the run aborted or the stream is truncated, 2 on error.\n");
+}
+
+/*------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  CU_pBinaryReader pReader;
+  CU_BinaryRecord record;
+  CU_BinaryStatus status;
+  const char* szOutput = NULL;
+  int bFollow = 0;
+  int bStarted = 0;
+  int bEnded = 0;
+  int iArg;
+  int iResult;
+
+  for (iArg = 1 ; (iArg < argc) && ('-' == argv[iArg][0]) && ('\0' != argv[iArg][1]) ; ++iArg) {
+    if (0 == strcmp(argv[iArg], "-w")) {
+      bFollow = 1;
+    }
+    else if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-o"))) {
+      szOutput = argv[++iArg];
+    }
+    else if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-f"))) {
+      ++iArg;
+      if (0 == strcmp(argv[iArg], "cunit")) {
+        f_format = FORMAT_CUNIT;
+      }
+      else if (0 == strcmp(argv[iArg], "junit")) {
+        f_format = FORMAT_JUNIT;
+      }
+      else if (0 == strcmp(argv[iArg], "json")) {
+        f_format = FORMAT_JSON;
+      }
+      else {
+        usage();
+        return 2;
+      }
+    }
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  if (1 != (argc - iArg)) {
+    usage();
+    return 2;
+  }
+
+  if (NULL == (pReader = CU_binary_reader_open(argv[iArg]))) {
+    fprintf(stderr, "cunit-convert: cannot open '%s'\n", argv[iArg]);
+    return 2;
+  }
+  if (NULL == szOutput) {
+    f_pOut = stdout;
+  }
+  else if (NULL == (f_pOut = fopen(szOutput, "w"))) {
+    fprintf(stderr, "cunit-convert: cannot create '%s'\n", szOutput);
+    CU_binary_reader_close(pReader);
+    return 2;
+  }
+
+  for (;;) {
+    status = CU_binary_reader_next(pReader, &record);
+    if (CU_BINARY_END == status) {
+      if ((0 == bFollow) || (0 != bEnded)) {
+        break;
+      }
+      fflush(f_pOut);
+      CU_sleep(FOLLOW_INTERVAL);
+      continue;
+    }
+    if (CU_BINARY_ERROR == status) {
+      fprintf(stderr, "cunit-convert: %s: offset %lu: %s\n",
+              argv[iArg], CU_binary_reader_offset(pReader), CU_get_error_msg());
+      break;
+    }
+
+    if (CU_BINARY_RUN_START == record.type) {
+      if (0 != bStarted) {
+        fprintf(stderr, "cunit-convert: %s: offset %lu: more than one run in stream\n",
+                argv[iArg], CU_binary_reader_offset(pReader));
+        status = CU_BINARY_ERROR;
+        break;
+      }
+      bStarted = 1;
+      f_szPackage = (NULL != record.szPackage) ? record.szPackage : "";
+    }
+    else if (0 == bStarted) {
+      continue;
+    }
+
+    if (CU_BINARY_ABORT == record.type) {
+      break;
+    }
+
+    switch (f_format) {
+      case FORMAT_JUNIT: junit_record(&record); break;
+      case FORMAT_JSON:  json_record(&record);  break;
+      default:           cunit_record(&record); break;
+    }
+
+    if (CU_BINARY_RUN_END == record.type) {
+      bEnded = 1;
+      break;
+    }
+  }
+
+  if ((0 != bStarted) && (0 == bEnded)) {
+    switch (f_format) {
+      case FORMAT_JUNIT: fputs("</testsuites>", f_pOut); break;
+      case FORMAT_JSON:  json_abort();                   break;
+      default:           cunit_abort();                  break;
+    }
+  }
+
+  iResult = ((CU_BINARY_ERROR == status) || (0 == bStarted)) ? 2 : ((0 != bEnded) ? 0 : 1);
+  if ((0 == bStarted) && (CU_BINARY_ERROR != status)) {
+    fprintf(stderr, "cunit-convert: %s: no test run found\n", argv[iArg]);
+  }
+
+  if ((stdout != f_pOut) && (0 != fclose(f_pOut))) {
+    fprintf(stderr, "cunit-convert: error writing '%s'\n", szOutput);
+    iResult = 2;
+  }
+  CU_binary_reader_close(pReader);
+  free(f_pPending);
+  free(f_pEnded);
+  for (iArg = 0 ; iArg < 2 ; ++iArg) {
+    if (NULL != f_szXml[iArg]) {
+      CU_FREE(f_szXml[iArg]);
+    }
+  }
+  return iResult;
+}
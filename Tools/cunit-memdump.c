@@ -0,0 +1,230 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  cunit-memdump - converts a binary CUnit memory dump to the xml
+ *  memory report (Share/Memory-Dump.dtd).  Replaces md2xml.pl.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ */
+
+/** @file
+ *  Binary memory dump converter.
+ *
+ *  A test program built with MEMTRACE writes a binary dump when
+ *  CU_SET_MEMORY_DUMP_FORMAT(CU_MEMORY_DUMP_BINARY) is selected.  This
+ *  tool streams the dump and writes the same xml CU_dump_memory_usage()
+ *  writes in CU_MEMORY_DUMP_XML format.  Only the file names are held
+ *  in memory.  The format is described at dump_memory_binary() in
+ *  CUnit/Sources/Framework/MyMem.c.
+ *
+ *  Exit status: 0 on success, 2 on usage or input errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MEMDUMP_MAGIC   "CUMEMDMP"  /**< Same as CU_MEMORY_DUMP_MAGIC. */
+#define MEMDUMP_VERSION 1           /**< Same as CU_MEMORY_DUMP_VERSION. */
+
+static const char* f_szInput = NULL;  /**< Name of the input, for messages. */
+
+/*------------------------------------------------------------------------*/
+static void* xmalloc(size_t size)
+{
+  void* p = malloc(size);
+  if (NULL == p) {
+    fprintf(stderr, "cunit-memdump: out of memory\n");
+    exit(2);
+  }
+  return p;
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads nBytes bytes from pFile, exiting on a truncated input. */
+static void read_bytes(FILE* pFile, void* pBuffer, size_t nBytes)
+{
+  if (nBytes != fread(pBuffer, 1, nBytes, pFile)) {
+    fprintf(stderr, "cunit-memdump: %s: truncated or unreadable dump\n", f_szInput);
+    exit(2);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads an unsigned integer of nBytes bytes, least significant first. */
+static unsigned long long read_uint(FILE* pFile, unsigned int nBytes)
+{
+  unsigned char abBytes[8];
+  unsigned long long ullValue = 0;
+
+  read_bytes(pFile, abBytes, nBytes);
+  while (nBytes > 0) {
+    ullValue = (ullValue << 8) | abBytes[--nBytes];
+  }
+  return ullValue;
+}
+
+/*------------------------------------------------------------------------*/
+/** Looks up a file name by id (0 is the empty name). */
+static const char* file_name(char** aszNames, unsigned long nNames, unsigned long ulId)
+{
+  if (ulId > nNames) {
+    fprintf(stderr, "cunit-memdump: %s: invalid file name id %lu\n", f_szInput, ulId);
+    exit(2);
+  }
+  return (0 == ulId) ? "" : aszNames[ulId - 1];
+}
+
+/*------------------------------------------------------------------------*/
+static void usage(void)
+{
+  fprintf(stderr,
+    "Usage: cunit-memdump <dump.bin> [<report.xml>]\n"
+    "Converts a binary CUnit memory dump to the xml memory report.\n"
+    "The report is written to standard output if no file is given.\n");
+}
+
+/*------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  FILE* pIn;
+  FILE* pOut = stdout;
+  char szMagic[8];
+  char** aszNames;
+  unsigned long nNames;
+  unsigned long nNodes;
+  unsigned long nEvents;
+  unsigned long ulLength;
+  unsigned long i;
+  unsigned int nValid = 0;
+  unsigned int nInvalid = 0;
+  unsigned long long ullSize;
+  unsigned long ulAllocLine;
+  unsigned long ulAllocFile;
+  unsigned long ulDeallocLine;
+  unsigned long ulDeallocFile;
+  time_t tTime;
+
+  if ((argc < 2) || (argc > 3)) {
+    usage();
+    return 2;
+  }
+
+  f_szInput = argv[1];
+  if (NULL == (pIn = fopen(f_szInput, "rb"))) {
+    fprintf(stderr, "cunit-memdump: cannot open %s\n", f_szInput);
+    return 2;
+  }
+  setvbuf(pIn, NULL, _IOFBF, 65536);
+
+  read_bytes(pIn, szMagic, sizeof(szMagic));
+  if (0 != memcmp(szMagic, MEMDUMP_MAGIC, sizeof(szMagic))) {
+    fprintf(stderr, "cunit-memdump: %s: not a CUnit memory dump\n", f_szInput);
+    return 2;
+  }
+  if (MEMDUMP_VERSION != read_uint(pIn, 4)) {
+    fprintf(stderr, "cunit-memdump: %s: unsupported dump version\n", f_szInput);
+    return 2;
+  }
+
+  nNames = (unsigned long)read_uint(pIn, 4);
+  aszNames = (char**)xmalloc((nNames + 1) * sizeof(char*));
+  for (i = 0 ; i < nNames ; ++i) {
+    ulLength = (unsigned long)read_uint(pIn, 4);
+    aszNames[i] = (char*)xmalloc(ulLength + 1);
+    read_bytes(pIn, aszNames[i], ulLength);
+    aszNames[i][ulLength] = '\0';
+  }
+
+  if ((3 == argc) && (NULL == (pOut = fopen(argv[2], "w")))) {
+    fprintf(stderr, "cunit-memdump: cannot create %s\n", argv[2]);
+    return 2;
+  }
+  setvbuf(pOut, NULL, _IOFBF, 65536);
+
+  fprintf(pOut, "<\?xml version=\"1.0\" \?>"
+                "\n<\?xml-stylesheet type=\"text/xsl\" href=\"Memory-Dump.xsl\" \?>"
+                "\n<!DOCTYPE MEMORY_DUMP_REPORT SYSTEM \"Memory-Dump.dtd\">"
+                "\n<MEMORY_DUMP_REPORT>"
+                "\n  <MD_HEADER/>"
+                "\n  <MD_RUN_LISTING>");
+
+  for (nNodes = (unsigned long)read_uint(pIn, 4) ; nNodes > 0 ; --nNodes) {
+    void* pLocation = (void*)(size_t)read_uint(pIn, 8);
+    nEvents = (unsigned long)read_uint(pIn, 4);
+
+    fprintf(pOut, "\n    <MD_RUN_RECORD>"
+                  "\n      <MD_POINTER> %p </MD_POINTER>"
+                  "\n      <MD_EVENT_COUNT> %u </MD_EVENT_COUNT>",
+            pLocation, (unsigned int)nEvents);
+
+    for ( ; nEvents > 0 ; --nEvents) {
+      ullSize = read_uint(pIn, 8);
+      ulAllocLine = (unsigned long)read_uint(pIn, 4);
+      ulAllocFile = (unsigned long)read_uint(pIn, 4);
+      ulDeallocLine = (unsigned long)read_uint(pIn, 4);
+      ulDeallocFile = (unsigned long)read_uint(pIn, 4);
+
+      fprintf(pOut, "\n      <MD_EVENT_RECORD>"
+                    "\n        <MD_SIZE> %u </MD_SIZE>"
+                    "\n        <MD_ALLOC_FILE> %s </MD_ALLOC_FILE>"
+                    "\n        <MD_ALLOC_LINE> %u </MD_ALLOC_LINE>"
+                    "\n        <MD_DEALLOC_FILE> %s </MD_DEALLOC_FILE>"
+                    "\n        <MD_DEALLOC_LINE> %u </MD_DEALLOC_LINE>"
+                    "\n      </MD_EVENT_RECORD>",
+              (unsigned int)ullSize,
+              file_name(aszNames, nNames, ulAllocFile), (unsigned int)ulAllocLine,
+              file_name(aszNames, nNames, ulDeallocFile), (unsigned int)ulDeallocLine);
+
+      if ((0 != ulAllocLine) && (0 != ulDeallocLine)) {
+        ++nValid;
+      }
+      else {
+        ++nInvalid;
+      }
+    }
+
+    fprintf(pOut, "\n    </MD_RUN_RECORD>");
+  }
+
+  tTime = (time_t)read_uint(pIn, 8);
+  fprintf(pOut, "\n  </MD_RUN_LISTING>"
+                "\n  <MD_SUMMARY>"
+                "\n    <MD_SUMMARY_VALID_RECORDS> %u </MD_SUMMARY_VALID_RECORDS>"
+                "\n    <MD_SUMMARY_INVALID_RECORDS> %u </MD_SUMMARY_INVALID_RECORDS>"
+                "\n    <MD_SUMMARY_TOTAL_RECORDS> %u </MD_SUMMARY_TOTAL_RECORDS>"
+                "\n  </MD_SUMMARY>"
+                "\n  <MD_FOOTER> Memory Trace for CUnit Run at %s </MD_FOOTER>"
+                "</MEMORY_DUMP_REPORT>",
+          nValid, nInvalid, nValid + nInvalid, ctime(&tTime));
+
+  fclose(pIn);
+  if (0 != fclose(pOut)) {
+    fprintf(stderr, "cunit-memdump: error writing report\n");
+    return 2;
+  }
+
+  for (i = 0 ; i < nNames ; ++i) {
+    free(aszNames[i]);
+  }
+  free(aszNames);
+  return 0;
+}
@@ -0,0 +1,781 @@
+/*
+ *  CUnit - A Unit testing framework library for C.
+ *  Copyright (C) 2026  agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *  cunit-merge - merges the result files of a test run split across
+ *  processes or machines (CUnit-Run xml or JUnit xml) into one report.
+ *
+ *  18-Oct-2026   Initial implementation. (AGT)
+ *
+ *  18-Oct-2026   Merged report marked tainted if an input is. (AGT)
+ */
+
+/** @file
+ *  Result file merge tool.
+ *
+ *  The inputs are read as streams and each suite element is copied to
+ *  the output byte for byte once its end has been read, so the memory
+ *  used does not depend on the size of the result files (only a table
+ *  of test names is kept for the checks).  Each input is expected to
+ *  hold its suites in registry order.  With a test listing (-l) the
+ *  suites of all inputs are merged in the registry order of the
+ *  listing; without one the inputs are concatenated.
+ *
+ *  For CUnit-Run files the run summary records are summed, except the
+ *  totals of suites and tests, which are the registry totals: those of
+ *  the listing, or else the largest total of any input.
+ *
+ *  The merged report is marked as tainted by crashes captured in
+ *  process (see CU_set_crash_capture()) if any input is; for JUnit
+ *  files the numbers of crashed tests are summed.
+ *
+ *  Tests found in more than one suite element (e.g. run by two shards)
+ *  are reported as duplicates.  With a listing, registered tests found
+ *  in no input are reported as missing, and tests not in the listing as
+ *  unknown.
+ *
+ *  Exit status: 0 if the merge found no problems, 1 if tests are
+ *  duplicated, missing or unknown or an input is incomplete, 2 on usage
+ *  or input errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "XmlStream.h"
+
+#define HASH_SIZE       4096    /**< Number of buckets in the name tables (power of 2). */
+#define MAX_NAME        1024    /**< Maximum length of suite names kept. */
+#define MAX_SUMMARY     8       /**< Maximum number of run summary records. */
+#define MAX_FIELD       64      /**< Maximum length of run summary values. */
+
+/** Result file formats. */
+typedef enum Format
+{
+  FORMAT_UNKNOWN = 0,
+  FORMAT_CUNIT,
+  FORMAT_JUNIT
+} Format;
+
+/** Table entry for a test (or, with szTest NULL, a suite of the listing). */
+typedef struct NameEntry
+{
+  char*             szSuite;    /**< Suite name. */
+  char*             szTest;     /**< Test name (NULL for suite entries). */
+  int               iRank;      /**< Registry position of a suite. */
+  int               bListed;    /**< Flag for the test being in the listing. */
+  int               iInput;     /**< Input in which the test was first found (-1 if none). */
+  unsigned long     ulElement;  /**< Suite element in which the test was first found. */
+  int               bDuplicate; /**< Flag for the test having been reported as duplicate. */
+  int               bInitFailed; /**< Flag for a suite whose initialization failed (tests not run). */
+  struct NameEntry* pHashNext;  /**< Next entry in hash bucket. */
+  struct NameEntry* pNext;      /**< Next entry in order of insertion. */
+} NameEntry;
+
+/** A run summary record (CUnit-Run), kept as text. */
+typedef struct SummaryRecord
+{
+  char szType[MAX_FIELD];       /**< TYPE value. */
+  char szField[5][MAX_FIELD];   /**< TOTAL, RUN, SUCCEEDED, FAILED, INACTIVE values. */
+} SummaryRecord;
+
+/** State of an input file. */
+typedef struct Input
+{
+  const char*   szFilename;     /**< Name of the file. */
+  XmlStream*    pStream;        /**< Parser of the file. */
+  FILE*         pRaw;           /**< Second handle used to copy suite elements. */
+  long long     llRawPos;       /**< Read position of pRaw. */
+  Format        format;         /**< Format of the file. */
+  int           bPending;       /**< Flag for a suite element waiting to be copied. */
+  long long     llStart;        /**< Offset of the pending suite element. */
+  char          szSuite[MAX_NAME]; /**< Suite name of the pending element. */
+  int           iRank;          /**< Registry position of the pending suite. */
+  int           bDone;          /**< Flag for no more suite elements. */
+  int           bSummary;       /**< Flag for a run summary having been read. */
+  int           bAborted;       /**< Flag for the run of the file having aborted. */
+  int           bFailed;        /**< Flag for a read or format error. */
+  char          szElement[64];  /**< Element of the current character data. */
+} Input;
+
+static NameEntry*   f_buckets[HASH_SIZE];
+static NameEntry*   f_pFirst = NULL;
+static NameEntry*   f_pLast = NULL;
+
+static Input*       f_pInputs = NULL;
+static int          f_nInputs = 0;
+static FILE*        f_pOut = NULL;
+static Format       f_format = FORMAT_UNKNOWN;
+
+static int          f_bListing = 0;             /**< Flag for a listing having been read. */
+static unsigned int f_nListedSuites = 0;        /**< Suites in the listing. */
+static unsigned int f_nListedTests = 0;         /**< Tests in the listing. */
+static unsigned long f_ulElements = 0;          /**< Suite elements copied. */
+
+static SummaryRecord f_summary[MAX_SUMMARY];    /**< Merged run summary. */
+static int          f_nSummary = 0;             /**< Records in f_summary. */
+static SummaryRecord f_record;                  /**< Summary record being read. */
+
+static unsigned int f_nDuplicates = 0;
+static unsigned int f_nUnknown = 0;
+static int          f_bBadInput = 0;            /**< Flag for an input in the wrong format. */
+static int          f_bTainted = 0;             /**< Flag for an input tainted by captured crashes. */
+static unsigned long f_ulCrashed = 0;           /**< Crashed tests of the inputs (JUnit). */
+
+/*------------------------------------------------------------------------*/
+static void* xmalloc(size_t size)
+{
+  void* p = malloc(size);
+  if (NULL == p) {
+    fprintf(stderr, "cunit-merge: out of memory\n");
+    exit(2);
+  }
+  return p;
+}
+
+/*------------------------------------------------------------------------*/
+static char* xstrdup(const char* sz)
+{
+  char* p = (char*)xmalloc(strlen(sz) + 1);
+  strcpy(p, sz);
+  return p;
+}
+
+/*------------------------------------------------------------------------*/
+/** Copies src into a fixed buffer, truncating if necessary. */
+static void set_string(char* szDest, size_t size, const char* szSrc)
+{
+  strncpy(szDest, szSrc, size - 1);
+  szDest[size - 1] = '\0';
+}
+
+/*------------------------------------------------------------------------*/
+static unsigned long hash_key(const char* szSuite, const char* szTest)
+{
+  unsigned long h = 5381;
+
+  while ('\0' != *szSuite) {
+    h = (h * 33) ^ (unsigned char)*szSuite++;
+  }
+  if (NULL != szTest) {
+    h = (h * 33) ^ '/';
+    while ('\0' != *szTest) {
+      h = (h * 33) ^ (unsigned char)*szTest++;
+    }
+  }
+  return h;
+}
+
+/*------------------------------------------------------------------------*/
+/** Finds the entry for a suite (szTest NULL) or test, creating it if
+ *  bCreate is set.
+ */
+static NameEntry* find_entry(const char* szSuite, const char* szTest, int bCreate)
+{
+  unsigned long h = hash_key(szSuite, szTest) & (HASH_SIZE - 1);
+  NameEntry* pEntry = f_buckets[h];
+
+  while ((NULL != pEntry) &&
+         ((0 != strcmp(pEntry->szSuite, szSuite)) ||
+          ((NULL == szTest) != (NULL == pEntry->szTest)) ||
+          ((NULL != szTest) && (0 != strcmp(pEntry->szTest, szTest))))) {
+    pEntry = pEntry->pHashNext;
+  }
+
+  if ((NULL == pEntry) && (0 != bCreate)) {
+    pEntry = (NameEntry*)xmalloc(sizeof(NameEntry));
+    memset(pEntry, 0, sizeof(NameEntry));
+    pEntry->szSuite = xstrdup(szSuite);
+    pEntry->szTest = (NULL != szTest) ? xstrdup(szTest) : NULL;
+    pEntry->iRank = INT_MAX;
+    pEntry->iInput = -1;
+    pEntry->pHashNext = f_buckets[h];
+    f_buckets[h] = pEntry;
+    if (NULL == f_pLast) {
+      f_pFirst = pEntry;
+    }
+    else {
+      f_pLast->pNext = pEntry;
+    }
+    f_pLast = pEntry;
+  }
+  return pEntry;
+}
+
+/*------------------------------------------------------------------------*/
+/** Records that a test was found in suite element ulElement of input iInput. */
+static void note_test(int iInput, const char* szSuite, const char* szTest, unsigned long ulElement)
+{
+  NameEntry* pEntry = find_entry(szSuite, szTest, 1);
+
+  if (-1 == pEntry->iInput) {
+    pEntry->iInput = iInput;
+    pEntry->ulElement = ulElement;
+    if ((0 != f_bListing) && (0 == pEntry->bListed)) {
+      fprintf(stderr, "cunit-merge: unknown: %s/%s (%s, not in listing)\n",
+              szSuite, szTest, f_pInputs[iInput].szFilename);
+      ++f_nUnknown;
+    }
+  }
+  else if ((pEntry->ulElement != ulElement) && (0 == pEntry->bDuplicate)) {
+    fprintf(stderr, "cunit-merge: duplicate: %s/%s (%s and %s)\n",
+            szSuite, szTest, f_pInputs[pEntry->iInput].szFilename, f_pInputs[iInput].szFilename);
+    pEntry->bDuplicate = 1;
+    ++f_nDuplicates;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads the suites and tests of a CUnit test listing.
+ *  @return 0 on success, -1 on error (message printed).
+ */
+static int read_listing(const char* szFilename)
+{
+  XmlStream* pStream;
+  XmlEvent event;
+  NameEntry* pEntry;
+  char szSuite[MAX_NAME] = "";
+  char szElement[64] = "";
+
+  if (NULL == (pStream = xml_stream_open(szFilename))) {
+    fprintf(stderr, "cunit-merge: cannot open '%s'\n", szFilename);
+    return -1;
+  }
+
+  while ((XML_EOF != (event = xml_stream_next(pStream))) && (XML_ERROR != event)) {
+    if (XML_START == event) {
+      set_string(szElement, sizeof(szElement), xml_stream_name(pStream));
+    }
+    else if (XML_END == event) {
+      szElement[0] = '\0';
+    }
+    else if (0 == strcmp(szElement, "SUITE_NAME")) {
+      set_string(szSuite, sizeof(szSuite), xml_stream_text(pStream));
+      pEntry = find_entry(szSuite, NULL, 1);
+      if (INT_MAX == pEntry->iRank) {
+        pEntry->iRank = (int)f_nListedSuites++;
+      }
+    }
+    else if (0 == strcmp(szElement, "TEST_CASE_NAME")) {
+      pEntry = find_entry(szSuite, xml_stream_text(pStream), 1);
+      if (0 == pEntry->bListed) {
+        pEntry->bListed = 1;
+        ++f_nListedTests;
+      }
+    }
+  }
+
+  if (XML_ERROR == event) {
+    fprintf(stderr, "cunit-merge: %s:%lu: %s\n",
+            szFilename, xml_stream_line(pStream), xml_stream_error(pStream));
+  }
+  xml_stream_close(pStream);
+  f_bListing = 1;
+  return (XML_ERROR == event) ? -1 : 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Adds a run summary record of an input to the merged summary. */
+static void add_summary(const SummaryRecord* pRecord)
+{
+  SummaryRecord* pMerged = NULL;
+  char* szEnd;
+  unsigned long ulMerged;
+  unsigned long ulValue;
+  int bRegistryTotal;
+  int i;
+
+  for (i = 0 ; i < f_nSummary ; ++i) {
+    if (0 == strcmp(f_summary[i].szType, pRecord->szType)) {
+      pMerged = &f_summary[i];
+      break;
+    }
+  }
+  if (NULL == pMerged) {
+    if (MAX_SUMMARY == f_nSummary) {
+      return;
+    }
+    f_summary[f_nSummary++] = *pRecord;
+    return;
+  }
+
+  bRegistryTotal = (0 == strcmp(pRecord->szType, "Suites")) || (0 == strcmp(pRecord->szType, "Test Cases"));
+  for (i = 0 ; i < 5 ; ++i) {
+    ulMerged = strtoul(pMerged->szField[i], &szEnd, 10);
+    if (('\0' != *szEnd) || ('\0' == pMerged->szField[i][0])) {
+      continue;   /* not a number (e.g. "n/a") - keep the text */
+    }
+    ulValue = strtoul(pRecord->szField[i], &szEnd, 10);
+    if ((0 == i) && (0 != bRegistryTotal)) {
+      ulMerged = (ulValue > ulMerged) ? ulValue : ulMerged;
+    }
+    else {
+      ulMerged += ulValue;
+    }
+    sprintf(pMerged->szField[i], "%lu", ulMerged);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Reports an input error and stops reading the input. */
+static void input_failed(Input* pInput, const char* szMessage)
+{
+  fprintf(stderr, "cunit-merge: %s:%lu: %s\n",
+          pInput->szFilename, xml_stream_line(pInput->pStream), szMessage);
+  pInput->bFailed = 1;
+  pInput->bDone = 1;
+  pInput->bPending = 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Handles character data outside suite elements (CUnit-Run summary and footer). */
+static void outer_text(Input* pInput)
+{
+  static const char* fields[5] = {"TOTAL", "RUN", "SUCCEEDED", "FAILED", "INACTIVE"};
+  const char* szText = xml_stream_text(pInput->pStream);
+  int i;
+
+  if (0 == strcmp(pInput->szElement, "TYPE")) {
+    set_string(f_record.szType, MAX_FIELD, szText);
+  }
+  else if (0 == strcmp(pInput->szElement, "CUNIT_FOOTER")) {
+    if (0 == strncmp(szText, "Test run aborted", 16)) {
+      pInput->bAborted = 1;
+    }
+    else if (0 == strncmp(szText, "Run tainted", 11)) {
+      f_bTainted = 1;
+    }
+  }
+  else {
+    for (i = 0 ; i < 5 ; ++i) {
+      if (0 == strcmp(pInput->szElement, fields[i])) {
+        set_string(f_record.szField[i], MAX_FIELD, szText);
+      }
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads an input up to its next suite element.  The element is left
+ *  pending (bPending) once its name is known; otherwise the input is
+ *  read to the end (bDone).
+ */
+static void next_suite(Input* pInput)
+{
+  XmlEvent event;
+  const char* szName;
+  const char* szValue;
+  NameEntry* pEntry;
+  int bInSuite = 0;
+
+  while (0 == pInput->bDone) {
+    event = xml_stream_next(pInput->pStream);
+    if (XML_ERROR == event) {
+      input_failed(pInput, xml_stream_error(pInput->pStream));
+      return;
+    }
+    if (XML_EOF == event) {
+      pInput->bDone = 1;
+      return;
+    }
+
+    szName = xml_stream_name(pInput->pStream);
+
+    if (XML_START == event) {
+      if (FORMAT_UNKNOWN == pInput->format) {
+        if (0 == strcmp(szName, "CUNIT_TEST_RUN_REPORT")) {
+          pInput->format = FORMAT_CUNIT;
+        }
+        else if ((0 == strcmp(szName, "testsuites")) || (0 == strcmp(szName, "testsuite"))) {
+          pInput->format = FORMAT_JUNIT;
+        }
+        else {
+          input_failed(pInput, "not a CUnit-Run or JUnit result file");
+          f_bBadInput = 1;
+          return;
+        }
+        if (FORMAT_UNKNOWN == f_format) {
+          f_format = pInput->format;
+        }
+        else if (f_format != pInput->format) {
+          input_failed(pInput, "result files are not all in the same format");
+          f_bBadInput = 1;
+          return;
+        }
+      }
+      set_string(pInput->szElement, sizeof(pInput->szElement), szName);
+
+      if ((FORMAT_CUNIT == pInput->format) && (0 == strcmp(szName, "CUNIT_RUN_SUITE"))) {
+        pInput->llStart = xml_stream_offset(pInput->pStream);
+        bInSuite = 1;
+      }
+      else if ((FORMAT_CUNIT == pInput->format) && (0 == strcmp(szName, "CUNIT_RUN_SUMMARY_RECORD"))) {
+        memset(&f_record, 0, sizeof(f_record));
+      }
+      else if ((FORMAT_JUNIT == pInput->format) && (0 == strcmp(szName, "testsuite"))) {
+        pInput->llStart = xml_stream_offset(pInput->pStream);
+        szName = xml_stream_attr(pInput->pStream, "name");
+        set_string(pInput->szSuite, sizeof(pInput->szSuite), (NULL != szName) ? szName : "");
+        pInput->bPending = 1;
+      }
+      else if ((FORMAT_JUNIT == pInput->format) && (0 == strcmp(szName, "property"))) {
+        /* properties of the testsuites element */
+        szName = xml_stream_attr(pInput->pStream, "name");
+        szValue = xml_stream_attr(pInput->pStream, "value");
+        if ((NULL != szName) && (NULL != szValue) && (0 == strcmp(szName, "tests_crashed"))) {
+          f_bTainted = 1;
+          f_ulCrashed += strtoul(szValue, NULL, 10);
+        }
+      }
+    }
+    else if (XML_END == event) {
+      pInput->szElement[0] = '\0';
+      if (0 == strcmp(szName, "CUNIT_RUN_SUMMARY_RECORD")) {
+        add_summary(&f_record);
+        pInput->bSummary = 1;
+      }
+    }
+    else if ((0 != bInSuite) && (0 == strcmp(pInput->szElement, "SUITE_NAME"))) {
+      set_string(pInput->szSuite, sizeof(pInput->szSuite), xml_stream_text(pInput->pStream));
+      pInput->bPending = 1;
+    }
+    else {
+      outer_text(pInput);
+    }
+
+    if (0 != pInput->bPending) {
+      pEntry = find_entry(pInput->szSuite, NULL, 0);
+      pInput->iRank = (NULL != pEntry) ? pEntry->iRank : INT_MAX;
+      return;
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Copies bytes of the raw handle of an input to the output (or skips
+ *  them if bCopy is 0) up to offset llEnd, or with llEnd -1 through the
+ *  next newline.
+ *  @return 0 on success, -1 if the input ended early.
+ */
+static int copy_raw(Input* pInput, long long llEnd, int bCopy)
+{
+  int ch;
+
+  while ((-1 == llEnd) || (pInput->llRawPos < llEnd)) {
+    if (EOF == (ch = getc(pInput->pRaw))) {
+      return (-1 == llEnd) ? 0 : -1;
+    }
+    ++pInput->llRawPos;
+    if (0 != bCopy) {
+      putc(ch, f_pOut);
+    }
+    if ((-1 == llEnd) && ('\n' == ch)) {
+      break;
+    }
+  }
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Reads the pending suite element of an input to its end, checking its
+ *  tests, and copies it to the output.
+ */
+static void copy_suite(int iInput)
+{
+  Input* pInput = &f_pInputs[iInput];
+  const char* szSuiteElement = (FORMAT_CUNIT == pInput->format) ? "CUNIT_RUN_SUITE" : "testsuite";
+  const char* szName;
+  const char* szClass;
+  XmlEvent event;
+  char szElement[64] = "";
+  size_t len;
+
+  ++f_ulElements;
+
+  for (;;) {
+    event = xml_stream_next(pInput->pStream);
+    if ((XML_ERROR == event) || (XML_EOF == event)) {
+      input_failed(pInput, (XML_ERROR == event) ? xml_stream_error(pInput->pStream) : "unexpected end of input");
+      return;
+    }
+    szName = xml_stream_name(pInput->pStream);
+    if (XML_START == event) {
+      set_string(szElement, sizeof(szElement), szName);
+      if ((FORMAT_JUNIT == pInput->format) && (0 == strcmp(szName, "testcase"))) {
+        szName = xml_stream_attr(pInput->pStream, "name");
+        szClass = xml_stream_attr(pInput->pStream, "classname");
+        len = (NULL != szClass) ? strlen(szClass) : 0;
+        /* skip the dummy test cases of suite init and cleanup failures */
+        if ((NULL != szName) && ((0 == len) || ('.' != szClass[len - 1]))) {
+          note_test(iInput, pInput->szSuite, szName, f_ulElements);
+        }
+      }
+    }
+    else if (XML_END == event) {
+      szElement[0] = '\0';
+      if (0 == strcmp(szName, szSuiteElement)) {
+        break;
+      }
+    }
+    else if ((FORMAT_CUNIT == pInput->format) && (0 == strcmp(szElement, "TEST_NAME"))) {
+      note_test(iInput, pInput->szSuite, xml_stream_text(pInput->pStream), f_ulElements);
+    }
+    else if ((FORMAT_CUNIT == pInput->format) && (0 == strcmp(szElement, "FAILURE_REASON")) &&
+             (0 == strncmp(xml_stream_text(pInput->pStream), "Suite Initialization", 20))) {
+      find_entry(pInput->szSuite, NULL, 1)->bInitFailed = 1;
+    }
+  }
+
+  /* copy from the start tag through the line of the end tag */
+  fputs((FORMAT_CUNIT == pInput->format) ? "    " : "  ", f_pOut);
+  if ((0 != copy_raw(pInput, pInput->llStart, 0)) ||
+      (0 != copy_raw(pInput, xml_stream_offset(pInput->pStream), 1)) ||
+      (0 != copy_raw(pInput, -1, 1))) {
+    input_failed(pInput, "file changed while reading");
+    return;
+  }
+  pInput->bPending = 0;
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes the CUnit-Run header. */
+static void write_header(void)
+{
+  if (FORMAT_CUNIT == f_format) {
+    fprintf(f_pOut,
+      "<?xml version=\"1.0\" ?> \n"
+      "<?xml-stylesheet type=\"text/xsl\" href=\"CUnit-Run.xsl\" ?> \n"
+      "<!DOCTYPE CUNIT_TEST_RUN_REPORT SYSTEM \"CUnit-Run.dtd\"> \n"
+      "<CUNIT_TEST_RUN_REPORT> \n"
+      "  <CUNIT_HEADER/> \n"
+      "  <CUNIT_RESULT_LISTING> \n");
+  }
+  else {
+    fprintf(f_pOut,
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<testsuites> \n");
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes the merged run summary and the footer. */
+static void write_footer(int bAborted)
+{
+  SummaryRecord* pRecord;
+  char* szTime;
+  time_t tTime = 0;
+  int i;
+
+  if (FORMAT_JUNIT == f_format) {
+    if (0 != f_bTainted) {
+      fprintf(f_pOut,
+        "  <properties> \n"
+        "    <property name=\"tainted\" value=\"true\"/> \n"
+        "    <property name=\"tests_crashed\" value=\"%lu\"/> \n"
+        "  </properties> \n",
+        f_ulCrashed);
+    }
+    fprintf(f_pOut, "</testsuites>");
+    return;
+  }
+
+  fprintf(f_pOut,
+    "  </CUNIT_RESULT_LISTING>\n"
+    "  <CUNIT_RUN_SUMMARY> \n");
+  for (i = 0 ; i < f_nSummary ; ++i) {
+    pRecord = &f_summary[i];
+    if (0 != f_bListing) {
+      if (0 == strcmp(pRecord->szType, "Suites")) {
+        sprintf(pRecord->szField[0], "%u", f_nListedSuites);
+      }
+      else if (0 == strcmp(pRecord->szType, "Test Cases")) {
+        sprintf(pRecord->szField[0], "%u", f_nListedTests);
+      }
+    }
+    fprintf(f_pOut,
+      "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+      "      <TYPE> %s </TYPE> \n"
+      "      <TOTAL> %s </TOTAL> \n"
+      "      <RUN> %s </RUN> \n"
+      "      <SUCCEEDED> %s </SUCCEEDED> \n"
+      "      <FAILED> %s </FAILED> \n"
+      "      <INACTIVE> %s </INACTIVE> \n"
+      "    </CUNIT_RUN_SUMMARY_RECORD> \n",
+      pRecord->szType, pRecord->szField[0], pRecord->szField[1],
+      pRecord->szField[2], pRecord->szField[3], pRecord->szField[4]);
+  }
+  fprintf(f_pOut, "  </CUNIT_RUN_SUMMARY> \n");
+
+  time(&tTime);
+  szTime = ctime(&tTime);
+  fprintf(f_pOut,
+    "  <CUNIT_FOOTER> %s%s %d result files%s - %s </CUNIT_FOOTER> \n"
+    "</CUNIT_TEST_RUN_REPORT>",
+    (0 != f_bTainted) ? "Run tainted by tests crashed in process - " : "",
+    "Merged by cunit-merge from",
+    f_nInputs,
+    (0 != bAborted) ? " (incomplete)" : "",
+    (NULL != szTime) ? szTime : "");
+}
+
+/*------------------------------------------------------------------------*/
+static void usage(void)
+{
+  fprintf(stderr,
+    "Usage: cunit-merge [options] <results.xml>...\n"
+    "Merges CUnit-Run or JUnit result files of a split test run into one report.\n"
+    "  -l <listing>  CUnit test listing (-Listing.xml): merge suites in registry\n"
+    "                order and report missing and unknown tests\n"
+    "  -o <file>     write to file instead of stdout\n"
+    "Exit status is 1 if tests are duplicated, missing or unknown or an input\n"
+    "is incomplete, 2 on error.\n");
+}
+
+/*------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  NameEntry* pEntry;
+  NameEntry* pSuite;
+  const char* szOutput = NULL;
+  const char* szListing = NULL;
+  unsigned int nMissing = 0;
+  int bIncomplete = 0;
+  int iLast = -1;
+  int iBest;
+  int iArg;
+  int i;
+
+  for (iArg = 1 ; (iArg < argc) && ('-' == argv[iArg][0]) && ('\0' != argv[iArg][1]) ; ++iArg) {
+    if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-l"))) {
+      szListing = argv[++iArg];
+    }
+    else if ((iArg + 1 < argc) && (0 == strcmp(argv[iArg], "-o"))) {
+      szOutput = argv[++iArg];
+    }
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  if (iArg >= argc) {
+    usage();
+    return 2;
+  }
+
+  if ((NULL != szListing) && (0 != read_listing(szListing))) {
+    return 2;
+  }
+
+  f_nInputs = argc - iArg;
+  f_pInputs = (Input*)xmalloc(f_nInputs * sizeof(Input));
+  memset(f_pInputs, 0, f_nInputs * sizeof(Input));
+  for (i = 0 ; i < f_nInputs ; ++i) {
+    f_pInputs[i].szFilename = argv[iArg + i];
+    /* suite elements are copied through a second handle, so stdin cannot be used */
+    if ((0 == strcmp(argv[iArg + i], "-")) ||
+        (NULL == (f_pInputs[i].pStream = xml_stream_open(argv[iArg + i]))) ||
+        (NULL == (f_pInputs[i].pRaw = fopen(argv[iArg + i], "rb")))) {
+      fprintf(stderr, "cunit-merge: cannot open '%s'\n", argv[iArg + i]);
+      return 2;
+    }
+  }
+
+  /* the format of the first input decides the format of the output */
+  for (i = 0 ; i < f_nInputs ; ++i) {
+    next_suite(&f_pInputs[i]);
+  }
+  if (FORMAT_UNKNOWN == f_format) {
+    fprintf(stderr, "cunit-merge: no result files to merge\n");
+    return 2;
+  }
+
+  if (NULL == szOutput) {
+    f_pOut = stdout;
+  }
+  else if (NULL == (f_pOut = fopen(szOutput, "w"))) {
+    fprintf(stderr, "cunit-merge: cannot create '%s'\n", szOutput);
+    return 2;
+  }
+  write_header();
+
+  /* copy the pending suite of lowest registry position, staying with the
+     last input on ties so that the elements of a suite remain together */
+  for (;;) {
+    iBest = -1;
+    for (i = 0 ; i < f_nInputs ; ++i) {
+      if ((0 != f_pInputs[i].bPending) &&
+          ((-1 == iBest) || (f_pInputs[i].iRank < f_pInputs[iBest].iRank) ||
+           ((f_pInputs[i].iRank == f_pInputs[iBest].iRank) && (i == iLast)))) {
+        iBest = i;
+      }
+    }
+    if (-1 == iBest) {
+      break;
+    }
+    copy_suite(iBest);
+    next_suite(&f_pInputs[iBest]);
+    iLast = iBest;
+  }
+
+  for (i = 0 ; i < f_nInputs ; ++i) {
+    if (0 != f_pInputs[i].bAborted) {
+      fprintf(stderr, "cunit-merge: %s: test run aborted\n", f_pInputs[i].szFilename);
+    }
+    else if ((0 == f_pInputs[i].bFailed) && (FORMAT_CUNIT == f_pInputs[i].format) && (0 == f_pInputs[i].bSummary)) {
+      fprintf(stderr, "cunit-merge: %s: no run summary\n", f_pInputs[i].szFilename);
+      f_pInputs[i].bAborted = 1;
+    }
+    if ((0 != f_pInputs[i].bAborted) || (0 != f_pInputs[i].bFailed)) {
+      bIncomplete = 1;
+    }
+  }
+
+  write_footer(bIncomplete);
+
+  /* tests of suites whose initialization failed are not in CUnit-Run files */
+  for (pEntry = f_pFirst ; NULL != pEntry ; pEntry = pEntry->pNext) {
+    if ((0 != pEntry->bListed) && (-1 == pEntry->iInput) &&
+        ((NULL == (pSuite = find_entry(pEntry->szSuite, NULL, 0))) || (0 == pSuite->bInitFailed))) {
+      fprintf(stderr, "cunit-merge: missing: %s/%s\n", pEntry->szSuite, pEntry->szTest);
+      ++nMissing;
+    }
+  }
+
+  fprintf(stderr, "cunit-merge: %d files, %lu suite elements, %u duplicate, %u missing, %u unknown tests\n",
+          f_nInputs, f_ulElements, f_nDuplicates, nMissing, f_nUnknown);
+
+  for (i = 0 ; i < f_nInputs ; ++i) {
+    xml_stream_close(f_pInputs[i].pStream);
+    fclose(f_pInputs[i].pRaw);
+  }
+  free(f_pInputs);
+
+  if ((stdout != f_pOut) && (0 != fclose(f_pOut))) {
+    fprintf(stderr, "cunit-merge: error writing '%s'\n", szOutput);
+    return 2;
+  }
+  if (0 != f_bBadInput) {
+    return 2;
+  }
+  return ((0 != f_nDuplicates) || (0 != nMissing) || (0 != f_nUnknown) || (0 != bIncomplete)) ? 1 : 0;
+}